@@ -0,0 +1,120 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/cal.h>
+#include <aws/cal/private/symmetric_cipher_priv.h>
+#include <aws/cal/symmetric_cipher.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/device_random.h>
+
+#include <inttypes.h>
+
+/* streams this much data through the cipher for every chunk size, so the runs are comparable. */
+#define PROFILE_TOTAL_SIZE (1024 * 1024 * 64)
+
+typedef int(profile_update_fn)(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out);
+typedef int(profile_finalize_fn)(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out);
+
+static void s_report(const char *operation, size_t chunk_size, uint64_t start, uint64_t end) {
+    uint64_t elapsed_ns = end - start;
+    double total_mb = (double)PROFILE_TOTAL_SIZE / (1024.0 * 1024.0);
+    double mb_per_second = elapsed_ns ? total_mb / ((double)elapsed_ns / 1e9) : 0;
+    fprintf(
+        stdout,
+        "%s in %zu byte chunks took %" PRIu64 "ns (%.1f MB/s)\n",
+        operation,
+        chunk_size,
+        elapsed_ns,
+        mb_per_second);
+}
+
+static void s_profile_gcm_at_chunk_size(
+    struct aws_symmetric_cipher *cipher,
+    const char *operation,
+    profile_update_fn *update_fn,
+    profile_finalize_fn *finalize_fn,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *output,
+    size_t chunk_size) {
+
+    AWS_FATAL_ASSERT(!aws_symmetric_cipher_reset(cipher) && "cipher reset failed");
+    aws_byte_buf_reset(output, false);
+
+    uint64_t start = 0;
+    AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&start) && "clock get ticks failed.");
+
+    while (input.len) {
+        struct aws_byte_cursor chunk = aws_byte_cursor_advance(&input, aws_min_size(chunk_size, input.len));
+        AWS_FATAL_ASSERT(!update_fn(cipher, chunk, output) && "gcm update failed");
+    }
+    AWS_FATAL_ASSERT(!finalize_fn(cipher, output) && "gcm finalize failed");
+
+    uint64_t end = 0;
+    AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&end) && "clock get ticks failed");
+    s_report(operation, chunk_size, start, end);
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_cal_library_init(allocator);
+
+    struct aws_symmetric_cipher *cipher = aws_aes_gcm_256_new(allocator, NULL, NULL, NULL, NULL);
+    AWS_FATAL_ASSERT(cipher && "failed to create cipher");
+    fprintf(stdout, "Starting AES-GCM 256 profile run using implementation %s\n\n", cipher->vtable->provider);
+
+    struct aws_byte_buf plaintext;
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&plaintext, allocator, PROFILE_TOTAL_SIZE) && "allocation failed");
+    AWS_FATAL_ASSERT(!aws_device_random_buffer(&plaintext) && "reading random data failed");
+
+    /* sized for the whole stream plus a block so no run pays for growing the output. */
+    struct aws_byte_buf ciphertext;
+    AWS_FATAL_ASSERT(
+        !aws_byte_buf_init(&ciphertext, allocator, PROFILE_TOTAL_SIZE + AWS_AES_256_CIPHER_BLOCK_SIZE) &&
+        "allocation failed");
+    struct aws_byte_buf decrypted;
+    AWS_FATAL_ASSERT(
+        !aws_byte_buf_init(&decrypted, allocator, PROFILE_TOTAL_SIZE + AWS_AES_256_CIPHER_BLOCK_SIZE) &&
+        "allocation failed");
+
+    const size_t chunk_sizes[] = {1024, 1024 * 64, 1024 * 1024 * 8};
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(chunk_sizes); ++i) {
+        fprintf(stdout, "****** %zu byte chunks ******\n\n", chunk_sizes[i]);
+
+        s_profile_gcm_at_chunk_size(
+            cipher,
+            "encrypt",
+            aws_symmetric_cipher_encrypt,
+            aws_symmetric_cipher_finalize_encryption,
+            aws_byte_cursor_from_buf(&plaintext),
+            &ciphertext,
+            chunk_sizes[i]);
+
+        /* the encrypt run left the tag on the cipher, so decryption verifies against it. */
+        s_profile_gcm_at_chunk_size(
+            cipher,
+            "decrypt",
+            aws_symmetric_cipher_decrypt,
+            aws_symmetric_cipher_finalize_decryption,
+            aws_byte_cursor_from_buf(&ciphertext),
+            &decrypted,
+            chunk_sizes[i]);
+
+        AWS_FATAL_ASSERT(aws_byte_buf_eq(&plaintext, &decrypted) && "decrypted output does not match the input");
+        fprintf(stdout, "\n");
+    }
+
+    aws_byte_buf_clean_up(&decrypted);
+    aws_byte_buf_clean_up(&ciphertext);
+    aws_byte_buf_clean_up(&plaintext);
+    aws_symmetric_cipher_destroy(cipher);
+
+    aws_cal_library_clean_up();
+    return 0;
+}
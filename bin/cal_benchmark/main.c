@@ -0,0 +1,677 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/cal.h>
+#include <aws/cal/ecc.h>
+#include <aws/cal/hash.h>
+#include <aws/cal/hmac.h>
+#include <aws/cal/private/der.h>
+#include <aws/cal/private/symmetric_cipher_priv.h>
+#include <aws/cal/runtime_info.h>
+#include <aws/cal/symmetric_cipher.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/device_random.h>
+#include <aws/common/thread.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Runs every benchmark over a sweep of message sizes, chunk sizes and thread counts and writes the results to stdout
+ * as a single JSON document, so runs against different backends or releases can be diffed by a script. Each thread
+ * works on its own instances, and every operation is timed on its own for the latency percentiles.
+ *
+ * usage: cal_benchmark [--filter <substring>] [--min-time-ms <ms>] [--max-threads <count>]
+ */
+
+#define BENCH_MAX_THREADS 8
+#define BENCH_MAX_SAMPLES_PER_THREAD (1024 * 64)
+#define BENCH_DEFAULT_MIN_TIME_MS 100
+#define BENCH_WARMUP_OPS 4
+/* enough for a pkcs7 padded CBC output or a keywrap output, plus a GCM tag. */
+#define BENCH_OUTPUT_OVERHEAD (2 * AWS_AES_256_CIPHER_BLOCK_SIZE)
+
+static const size_t s_message_sizes[] = {64, 1024, 16 * 1024, 1024 * 1024};
+/* 0 hands the whole message over in a single call. */
+static const size_t s_chunk_sizes[] = {0, 64, 4096, 64 * 1024};
+static const size_t s_thread_counts[] = {1, 2, 4, 8};
+
+/* every allocation made through the counting allocator, by the thread that made it. */
+static AWS_THREAD_LOCAL uint64_t tl_allocation_count;
+
+static void *s_counting_acquire(struct aws_allocator *allocator, size_t size) {
+    (void)allocator;
+    ++tl_allocation_count;
+    return aws_mem_acquire(aws_default_allocator(), size);
+}
+
+static void s_counting_release(struct aws_allocator *allocator, void *ptr) {
+    (void)allocator;
+    aws_mem_release(aws_default_allocator(), ptr);
+}
+
+static void *s_counting_realloc(struct aws_allocator *allocator, void *oldptr, size_t oldsize, size_t newsize) {
+    (void)allocator;
+    ++tl_allocation_count;
+    void *ptr = oldptr;
+    if (aws_mem_realloc(aws_default_allocator(), &ptr, oldsize, newsize)) {
+        return NULL;
+    }
+    return ptr;
+}
+
+static void *s_counting_calloc(struct aws_allocator *allocator, size_t num, size_t size) {
+    (void)allocator;
+    ++tl_allocation_count;
+    return aws_mem_calloc(aws_default_allocator(), num, size);
+}
+
+static struct aws_allocator s_counting_allocator = {
+    .mem_acquire = s_counting_acquire,
+    .mem_release = s_counting_release,
+    .mem_realloc = s_counting_realloc,
+    .mem_calloc = s_counting_calloc,
+};
+
+enum bench_sweep {
+    /* one run per thread count, on a fixed message. */
+    BENCH_SWEEP_NONE,
+    BENCH_SWEEP_MESSAGE,
+    BENCH_SWEEP_MESSAGE_AND_CHUNK,
+};
+
+struct bench_state;
+
+struct bench_def {
+    const char *name;
+    const char *operation;
+    enum bench_sweep sweep;
+    /* the message size for BENCH_SWEEP_NONE. */
+    size_t fixed_message_size;
+    const void *param;
+    /* optional, builds whatever a thread needs before it's timed. */
+    void (*setup)(struct bench_state *state);
+    void (*run)(struct bench_state *state);
+    /* optional */
+    void (*teardown)(struct bench_state *state);
+};
+
+struct bench_state {
+    struct aws_allocator *allocator;
+    const struct bench_def *def;
+    struct aws_byte_cursor message;
+    size_t chunk_size;
+    const char *provider;
+    struct aws_byte_buf output;
+    /* ciphertext, a signature or an encoding, prepared by setup for the run to consume. */
+    struct aws_byte_buf prepared;
+    void *impl;
+
+    uint64_t min_time_ns;
+    uint64_t ops;
+    uint64_t elapsed_ns;
+    uint64_t allocations;
+    uint64_t *samples;
+    size_t sample_count;
+};
+
+static struct aws_byte_cursor s_next_chunk(struct aws_byte_cursor *remaining, size_t chunk_size) {
+    return aws_byte_cursor_advance(remaining, chunk_size ? aws_min_size(chunk_size, remaining->len) : remaining->len);
+}
+
+/********************************** hashes and hmacs **********************************/
+
+typedef int(bench_hash_compute_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+struct bench_hash_alg {
+    aws_hash_new_fn *new_fn;
+    bench_hash_compute_fn *compute_fn;
+};
+
+static const struct bench_hash_alg s_md5 = {.new_fn = aws_md5_new, .compute_fn = aws_md5_compute};
+static const struct bench_hash_alg s_sha1 = {.new_fn = aws_sha1_new, .compute_fn = aws_sha1_compute};
+static const struct bench_hash_alg s_sha256 = {.new_fn = aws_sha256_new, .compute_fn = aws_sha256_compute};
+
+static void s_hash_setup(struct bench_state *state) {
+    const struct bench_hash_alg *alg = state->def->param;
+    struct aws_hash *hash = alg->new_fn(state->allocator);
+    AWS_FATAL_ASSERT(hash && "hash creation failed");
+    state->provider = hash->vtable->provider;
+    aws_hash_destroy(hash);
+
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&state->output, state->allocator, AWS_SHA512_LEN) && "allocation failed");
+}
+
+static void s_hash_oneshot(struct bench_state *state) {
+    const struct bench_hash_alg *alg = state->def->param;
+    state->output.len = 0;
+    AWS_FATAL_ASSERT(!alg->compute_fn(state->allocator, &state->message, &state->output, 0) && "hash failed");
+}
+
+static void s_hash_streaming(struct bench_state *state) {
+    const struct bench_hash_alg *alg = state->def->param;
+    struct aws_hash *hash = alg->new_fn(state->allocator);
+    AWS_FATAL_ASSERT(hash && "hash creation failed");
+
+    struct aws_byte_cursor remaining = state->message;
+    while (remaining.len) {
+        struct aws_byte_cursor chunk = s_next_chunk(&remaining, state->chunk_size);
+        AWS_FATAL_ASSERT(!aws_hash_update(hash, &chunk) && "hash update failed");
+    }
+
+    state->output.len = 0;
+    AWS_FATAL_ASSERT(!aws_hash_finalize(hash, &state->output, 0) && "hash finalize failed");
+    aws_hash_destroy(hash);
+}
+
+static const uint8_t s_hmac_secret[32] = {0x0b, 0x0b, 0x0b, 0x0b};
+
+static void s_hmac_setup(struct bench_state *state) {
+    struct aws_byte_cursor secret = aws_byte_cursor_from_array(s_hmac_secret, sizeof(s_hmac_secret));
+    struct aws_hmac *hmac = aws_sha256_hmac_new(state->allocator, &secret);
+    AWS_FATAL_ASSERT(hmac && "hmac creation failed");
+    state->provider = hmac->vtable->provider;
+    aws_hmac_destroy(hmac);
+
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&state->output, state->allocator, AWS_SHA256_HMAC_LEN) && "allocation failed");
+}
+
+static void s_hmac_oneshot(struct bench_state *state) {
+    struct aws_byte_cursor secret = aws_byte_cursor_from_array(s_hmac_secret, sizeof(s_hmac_secret));
+    state->output.len = 0;
+    AWS_FATAL_ASSERT(
+        !aws_sha256_hmac_compute(state->allocator, &secret, &state->message, &state->output, 0) && "hmac failed");
+}
+
+static void s_hmac_streaming(struct bench_state *state) {
+    struct aws_byte_cursor secret = aws_byte_cursor_from_array(s_hmac_secret, sizeof(s_hmac_secret));
+    struct aws_hmac *hmac = aws_sha256_hmac_new(state->allocator, &secret);
+    AWS_FATAL_ASSERT(hmac && "hmac creation failed");
+
+    struct aws_byte_cursor remaining = state->message;
+    while (remaining.len) {
+        struct aws_byte_cursor chunk = s_next_chunk(&remaining, state->chunk_size);
+        AWS_FATAL_ASSERT(!aws_hmac_update(hmac, &chunk) && "hmac update failed");
+    }
+
+    state->output.len = 0;
+    AWS_FATAL_ASSERT(!aws_hmac_finalize(hmac, &state->output, 0) && "hmac finalize failed");
+    aws_hmac_destroy(hmac);
+}
+
+/********************************** aes **********************************/
+
+typedef struct aws_symmetric_cipher *(bench_cipher_new_fn)(struct aws_allocator *allocator);
+
+static struct aws_symmetric_cipher *s_cbc_new(struct aws_allocator *allocator) {
+    return aws_aes_cbc_256_new(allocator, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_ctr_new(struct aws_allocator *allocator) {
+    return aws_aes_ctr_256_new(allocator, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_gcm_new(struct aws_allocator *allocator) {
+    return aws_aes_gcm_256_new(allocator, NULL, NULL, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_keywrap_new(struct aws_allocator *allocator) {
+    return aws_aes_keywrap_256_new(allocator, NULL);
+}
+
+struct bench_cipher_mode {
+    bench_cipher_new_fn *new_fn;
+};
+
+static const struct bench_cipher_mode s_cbc = {.new_fn = s_cbc_new};
+static const struct bench_cipher_mode s_ctr = {.new_fn = s_ctr_new};
+static const struct bench_cipher_mode s_gcm = {.new_fn = s_gcm_new};
+static const struct bench_cipher_mode s_keywrap = {.new_fn = s_keywrap_new};
+
+static void s_crypt_chunks(
+    struct aws_symmetric_cipher *cipher,
+    bool encrypt,
+    struct aws_byte_cursor input,
+    size_t chunk_size,
+    struct aws_byte_buf *output) {
+
+    AWS_FATAL_ASSERT(!aws_symmetric_cipher_reset(cipher) && "cipher reset failed");
+    output->len = 0;
+
+    while (input.len) {
+        struct aws_byte_cursor chunk = s_next_chunk(&input, chunk_size);
+        int result = encrypt ? aws_symmetric_cipher_encrypt(cipher, chunk, output)
+                             : aws_symmetric_cipher_decrypt(cipher, chunk, output);
+        AWS_FATAL_ASSERT(!result && "cipher update failed");
+    }
+
+    int result = encrypt ? aws_symmetric_cipher_finalize_encryption(cipher, output)
+                         : aws_symmetric_cipher_finalize_decryption(cipher, output);
+    AWS_FATAL_ASSERT(!result && "cipher finalize failed");
+}
+
+static void s_cipher_setup(struct bench_state *state) {
+    const struct bench_cipher_mode *mode = state->def->param;
+    struct aws_symmetric_cipher *cipher = mode->new_fn(state->allocator);
+    AWS_FATAL_ASSERT(cipher && "cipher creation failed");
+    state->impl = cipher;
+    state->provider = cipher->vtable->provider;
+
+    size_t output_len = state->message.len + BENCH_OUTPUT_OVERHEAD;
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&state->output, state->allocator, output_len) && "allocation failed");
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&state->prepared, state->allocator, output_len) && "allocation failed");
+
+    /* the decrypt runs take this back apart, and for GCM the tag it leaves on the cipher is what they verify. */
+    s_crypt_chunks(cipher, true, state->message, 0, &state->prepared);
+}
+
+static void s_cipher_encrypt(struct bench_state *state) {
+    s_crypt_chunks(state->impl, true, state->message, state->chunk_size, &state->output);
+}
+
+static void s_cipher_decrypt(struct bench_state *state) {
+    s_crypt_chunks(state->impl, false, aws_byte_cursor_from_buf(&state->prepared), state->chunk_size, &state->output);
+}
+
+static void s_cipher_teardown(struct bench_state *state) {
+    aws_symmetric_cipher_destroy(state->impl);
+}
+
+/********************************** ecdsa **********************************/
+
+static const enum aws_ecc_curve_name s_p256 = AWS_CAL_ECDSA_P256;
+static const enum aws_ecc_curve_name s_p384 = AWS_CAL_ECDSA_P384;
+
+static void s_ecdsa_setup(struct bench_state *state) {
+    const enum aws_ecc_curve_name *curve = state->def->param;
+    struct aws_ecc_key_pair *key_pair = aws_ecc_key_pair_new_generate_random(state->allocator, *curve);
+    AWS_FATAL_ASSERT(key_pair && "key generation failed");
+    state->impl = key_pair;
+
+    size_t signature_len = aws_ecc_key_pair_signature_length(key_pair);
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&state->output, state->allocator, signature_len) && "allocation failed");
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&state->prepared, state->allocator, signature_len) && "allocation failed");
+    AWS_FATAL_ASSERT(
+        !aws_ecc_key_pair_sign_message(key_pair, &state->message, &state->prepared) && "signing failed");
+}
+
+static void s_ecdsa_sign(struct bench_state *state) {
+    state->output.len = 0;
+    AWS_FATAL_ASSERT(!aws_ecc_key_pair_sign_message(state->impl, &state->message, &state->output) && "signing failed");
+}
+
+static void s_ecdsa_verify(struct bench_state *state) {
+    struct aws_byte_cursor signature = aws_byte_cursor_from_buf(&state->prepared);
+    AWS_FATAL_ASSERT(
+        !aws_ecc_key_pair_verify_signature(state->impl, &state->message, &signature) && "verification failed");
+}
+
+static void s_ecdsa_import(struct bench_state *state) {
+    const enum aws_ecc_curve_name *curve = state->def->param;
+    struct aws_byte_cursor private_d;
+    aws_ecc_key_pair_get_private_key(state->impl, &private_d);
+
+    struct aws_ecc_key_pair *key_pair = aws_ecc_key_pair_new_from_private_key(state->allocator, *curve, &private_d);
+    AWS_FATAL_ASSERT(key_pair && "key import failed");
+    aws_ecc_key_pair_release(key_pair);
+}
+
+static void s_ecdsa_teardown(struct bench_state *state) {
+    aws_ecc_key_pair_release(state->impl);
+}
+
+/********************************** der **********************************/
+
+static const uint8_t s_der_serial[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef};
+
+static void s_der_encode_into(struct bench_state *state, struct aws_byte_buf *output) {
+    struct aws_der_encoder *encoder = aws_der_encoder_new(state->allocator, state->message.len + 64);
+    AWS_FATAL_ASSERT(encoder && "encoder creation failed");
+
+    struct aws_byte_cursor contents;
+    AWS_FATAL_ASSERT(
+        !aws_der_encoder_begin_sequence(encoder) &&
+        !aws_der_encoder_write_integer(encoder, aws_byte_cursor_from_array(s_der_serial, sizeof(s_der_serial))) &&
+        !aws_der_encoder_write_boolean(encoder, true) &&
+        !aws_der_encoder_write_octet_string(encoder, state->message) && !aws_der_encoder_end_sequence(encoder) &&
+        !aws_der_encoder_get_contents(encoder, &contents) && "encoding failed");
+
+    output->len = 0;
+    AWS_FATAL_ASSERT(!aws_byte_buf_append_dynamic(output, &contents) && "copying the encoding failed");
+    aws_der_encoder_destroy(encoder);
+}
+
+static void s_der_setup(struct bench_state *state) {
+    state->provider = "aws-c-cal";
+    AWS_FATAL_ASSERT(
+        !aws_byte_buf_init(&state->output, state->allocator, state->message.len + 64) && "allocation failed");
+    AWS_FATAL_ASSERT(
+        !aws_byte_buf_init(&state->prepared, state->allocator, state->message.len + 64) && "allocation failed");
+    s_der_encode_into(state, &state->prepared);
+}
+
+static void s_der_encode(struct bench_state *state) {
+    s_der_encode_into(state, &state->output);
+}
+
+static void s_der_decode(struct bench_state *state) {
+    struct aws_der_decoder *decoder = aws_der_decoder_new(state->allocator, aws_byte_cursor_from_buf(&state->prepared));
+    AWS_FATAL_ASSERT(decoder && "decoding failed");
+
+    size_t octet_len = 0;
+    while (aws_der_decoder_next(decoder)) {
+        if (aws_der_decoder_tlv_type(decoder) == AWS_DER_OCTET_STRING) {
+            struct aws_byte_cursor octets;
+            AWS_FATAL_ASSERT(!aws_der_decoder_tlv_string(decoder, &octets) && "reading the octet string failed");
+            octet_len = octets.len;
+        }
+    }
+    AWS_FATAL_ASSERT(octet_len == state->message.len && "decoded the wrong length");
+    aws_der_decoder_destroy(decoder);
+}
+
+/********************************** harness **********************************/
+
+static const struct bench_def s_benchmarks[] = {
+    {"md5", "oneshot", BENCH_SWEEP_MESSAGE, 0, &s_md5, s_hash_setup, s_hash_oneshot, NULL},
+    {"md5", "streaming", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_md5, s_hash_setup, s_hash_streaming, NULL},
+    {"sha1", "oneshot", BENCH_SWEEP_MESSAGE, 0, &s_sha1, s_hash_setup, s_hash_oneshot, NULL},
+    {"sha1", "streaming", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_sha1, s_hash_setup, s_hash_streaming, NULL},
+    {"sha256", "oneshot", BENCH_SWEEP_MESSAGE, 0, &s_sha256, s_hash_setup, s_hash_oneshot, NULL},
+    {"sha256", "streaming", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_sha256, s_hash_setup, s_hash_streaming, NULL},
+    {"sha256_hmac", "oneshot", BENCH_SWEEP_MESSAGE, 0, NULL, s_hmac_setup, s_hmac_oneshot, NULL},
+    {"sha256_hmac", "streaming", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, NULL, s_hmac_setup, s_hmac_streaming, NULL},
+    {"aes_256_cbc", "encrypt", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_cbc, s_cipher_setup, s_cipher_encrypt,
+     s_cipher_teardown},
+    {"aes_256_cbc", "decrypt", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_cbc, s_cipher_setup, s_cipher_decrypt,
+     s_cipher_teardown},
+    {"aes_256_ctr", "encrypt", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_ctr, s_cipher_setup, s_cipher_encrypt,
+     s_cipher_teardown},
+    {"aes_256_ctr", "decrypt", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_ctr, s_cipher_setup, s_cipher_decrypt,
+     s_cipher_teardown},
+    {"aes_256_gcm", "encrypt", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_gcm, s_cipher_setup, s_cipher_encrypt,
+     s_cipher_teardown},
+    {"aes_256_gcm", "decrypt", BENCH_SWEEP_MESSAGE_AND_CHUNK, 0, &s_gcm, s_cipher_setup, s_cipher_decrypt,
+     s_cipher_teardown},
+    /* wrapping a 256 bit data key is what keywrap is for. */
+    {"aes_256_keywrap", "encrypt", BENCH_SWEEP_NONE, 32, &s_keywrap, s_cipher_setup, s_cipher_encrypt,
+     s_cipher_teardown},
+    {"aes_256_keywrap", "decrypt", BENCH_SWEEP_NONE, 32, &s_keywrap, s_cipher_setup, s_cipher_decrypt,
+     s_cipher_teardown},
+    /* the message is the digest being signed. */
+    {"ecdsa_p256", "sign", BENCH_SWEEP_NONE, 32, &s_p256, s_ecdsa_setup, s_ecdsa_sign, s_ecdsa_teardown},
+    {"ecdsa_p256", "verify", BENCH_SWEEP_NONE, 32, &s_p256, s_ecdsa_setup, s_ecdsa_verify, s_ecdsa_teardown},
+    {"ecdsa_p256", "import", BENCH_SWEEP_NONE, 32, &s_p256, s_ecdsa_setup, s_ecdsa_import, s_ecdsa_teardown},
+    {"ecdsa_p384", "sign", BENCH_SWEEP_NONE, 48, &s_p384, s_ecdsa_setup, s_ecdsa_sign, s_ecdsa_teardown},
+    {"ecdsa_p384", "verify", BENCH_SWEEP_NONE, 48, &s_p384, s_ecdsa_setup, s_ecdsa_verify, s_ecdsa_teardown},
+    {"ecdsa_p384", "import", BENCH_SWEEP_NONE, 48, &s_p384, s_ecdsa_setup, s_ecdsa_import, s_ecdsa_teardown},
+    {"der", "encode", BENCH_SWEEP_MESSAGE, 0, NULL, s_der_setup, s_der_encode, NULL},
+    {"der", "decode", BENCH_SWEEP_MESSAGE, 0, NULL, s_der_setup, s_der_decode, NULL},
+};
+
+static void s_bench_thread(void *arg) {
+    struct bench_state *state = arg;
+
+    for (size_t i = 0; i < BENCH_WARMUP_OPS; ++i) {
+        state->def->run(state);
+    }
+
+    uint64_t allocations_before = tl_allocation_count;
+    uint64_t start = 0;
+    AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&start) && "clock get ticks failed");
+
+    uint64_t op_start = start;
+    uint64_t op_end = start;
+    do {
+        state->def->run(state);
+        AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&op_end) && "clock get ticks failed");
+
+        if (state->sample_count < BENCH_MAX_SAMPLES_PER_THREAD) {
+            state->samples[state->sample_count++] = op_end - op_start;
+        }
+        ++state->ops;
+        op_start = op_end;
+    } while (op_end - start < state->min_time_ns);
+
+    state->elapsed_ns = op_end - start;
+    state->allocations = tl_allocation_count - allocations_before;
+
+    /* drops the per thread instances the one-shot functions keep, so nothing outlives the thread. */
+    aws_cal_thread_clean_up();
+}
+
+static int s_compare_samples(const void *a, const void *b) {
+    uint64_t lhs = *(const uint64_t *)a;
+    uint64_t rhs = *(const uint64_t *)b;
+    return lhs < rhs ? -1 : lhs > rhs;
+}
+
+struct bench_config {
+    const char *filter;
+    uint64_t min_time_ns;
+    size_t max_threads;
+    struct aws_byte_cursor random_input;
+    bool wrote_result;
+};
+
+static void s_run_case(
+    struct bench_config *config,
+    const struct bench_def *def,
+    size_t message_size,
+    size_t chunk_size,
+    size_t thread_count) {
+
+    struct aws_allocator *allocator = aws_default_allocator();
+    struct bench_state states[BENCH_MAX_THREADS];
+    AWS_ZERO_ARRAY(states);
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        states[i].allocator = &s_counting_allocator;
+        states[i].def = def;
+        states[i].message = aws_byte_cursor_from_array(config->random_input.ptr, message_size);
+        states[i].chunk_size = chunk_size;
+        states[i].min_time_ns = config->min_time_ns;
+        states[i].samples = aws_mem_calloc(allocator, BENCH_MAX_SAMPLES_PER_THREAD, sizeof(uint64_t));
+        if (def->setup) {
+            def->setup(&states[i]);
+        }
+    }
+
+    if (thread_count == 1) {
+        s_bench_thread(&states[0]);
+    } else {
+        struct aws_thread threads[BENCH_MAX_THREADS];
+        for (size_t i = 0; i < thread_count; ++i) {
+            AWS_FATAL_ASSERT(!aws_thread_init(&threads[i], allocator) && "thread init failed");
+            AWS_FATAL_ASSERT(
+                !aws_thread_launch(&threads[i], s_bench_thread, &states[i], NULL) && "thread launch failed");
+        }
+        for (size_t i = 0; i < thread_count; ++i) {
+            aws_thread_join(&threads[i]);
+            aws_thread_clean_up(&threads[i]);
+        }
+    }
+
+    uint64_t total_ops = 0;
+    uint64_t total_allocations = 0;
+    double ops_per_sec = 0;
+    size_t total_samples = 0;
+    for (size_t i = 0; i < thread_count; ++i) {
+        total_ops += states[i].ops;
+        total_allocations += states[i].allocations;
+        ops_per_sec += states[i].elapsed_ns ? (double)states[i].ops * 1e9 / (double)states[i].elapsed_ns : 0;
+        total_samples += states[i].sample_count;
+    }
+
+    uint64_t *samples = aws_mem_calloc(allocator, total_samples, sizeof(uint64_t));
+    size_t merged = 0;
+    for (size_t i = 0; i < thread_count; ++i) {
+        memcpy(samples + merged, states[i].samples, states[i].sample_count * sizeof(uint64_t));
+        merged += states[i].sample_count;
+    }
+    qsort(samples, total_samples, sizeof(uint64_t), s_compare_samples);
+
+    fprintf(stdout, "%s\n    {", config->wrote_result ? "," : "");
+    fprintf(stdout, "\"benchmark\": \"%s\", \"operation\": \"%s\", ", def->name, def->operation);
+    if (states[0].provider) {
+        fprintf(stdout, "\"provider\": \"%s\", ", states[0].provider);
+    } else {
+        fprintf(stdout, "\"provider\": null, ");
+    }
+    fprintf(
+        stdout,
+        "\"message_size\": %zu, \"chunk_size\": %zu, \"threads\": %zu, \"ops\": %" PRIu64 ", ",
+        message_size,
+        chunk_size,
+        thread_count,
+        total_ops);
+    fprintf(
+        stdout,
+        "\"ops_per_sec\": %.1f, \"bytes_per_sec\": %.1f, \"allocs_per_op\": %.3f, ",
+        ops_per_sec,
+        ops_per_sec * (double)message_size,
+        total_ops ? (double)total_allocations / (double)total_ops : 0);
+    fprintf(
+        stdout,
+        "\"p50_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64 "}",
+        samples[(total_samples - 1) / 2],
+        samples[(total_samples - 1) * 99 / 100]);
+    fflush(stdout);
+    config->wrote_result = true;
+
+    aws_mem_release(allocator, samples);
+    for (size_t i = 0; i < thread_count; ++i) {
+        if (def->teardown) {
+            def->teardown(&states[i]);
+        }
+        aws_byte_buf_clean_up(&states[i].prepared);
+        aws_byte_buf_clean_up(&states[i].output);
+        aws_mem_release(allocator, states[i].samples);
+    }
+}
+
+static void s_run_benchmark(struct bench_config *config, const struct bench_def *def) {
+    const size_t fixed_size[] = {def->fixed_message_size};
+    const size_t *message_sizes = def->sweep == BENCH_SWEEP_NONE ? fixed_size : s_message_sizes;
+    size_t message_size_count = def->sweep == BENCH_SWEEP_NONE ? 1 : AWS_ARRAY_SIZE(s_message_sizes);
+    size_t chunk_size_count = def->sweep == BENCH_SWEEP_MESSAGE_AND_CHUNK ? AWS_ARRAY_SIZE(s_chunk_sizes) : 1;
+
+    for (size_t m = 0; m < message_size_count; ++m) {
+        for (size_t c = 0; c < chunk_size_count; ++c) {
+            /* a chunk as big as the message is the same run as handing it over whole. */
+            if (s_chunk_sizes[c] >= message_sizes[m]) {
+                continue;
+            }
+
+            for (size_t t = 0; t < AWS_ARRAY_SIZE(s_thread_counts); ++t) {
+                if (s_thread_counts[t] <= config->max_threads) {
+                    s_run_case(config, def, message_sizes[m], s_chunk_sizes[c], s_thread_counts[t]);
+                }
+            }
+        }
+    }
+}
+
+static void s_print_json_string_or_null(const char *value) {
+    if (value) {
+        fprintf(stdout, "\"%s\"", value);
+    } else {
+        fprintf(stdout, "null");
+    }
+}
+
+/* what the results ran on, so runs on different hosts can be told apart. */
+static void s_print_runtime_info(struct aws_allocator *allocator) {
+    struct aws_cal_runtime_info info;
+    aws_cal_get_runtime_info(allocator, &info);
+
+    fprintf(stdout, "  \"runtime\": {\"libcrypto_version\": ");
+    s_print_json_string_or_null(info.libcrypto_version);
+    fprintf(stdout, ", \"libcrypto_library\": ");
+    s_print_json_string_or_null(info.libcrypto_library);
+
+    const struct aws_cal_cpu_features *features = &info.cpu_features;
+    fprintf(
+        stdout,
+        ",\n    \"cpu_features\": {\"aes_ni\": %s, \"pclmulqdq\": %s, \"avx2\": %s, \"sha_ni\": %s, "
+        "\"armv8_aes\": %s, \"armv8_sha\": %s},\n    \"providers\": {",
+        features->aes_ni ? "true" : "false",
+        features->pclmulqdq ? "true" : "false",
+        features->avx2 ? "true" : "false",
+        features->sha_ni ? "true" : "false",
+        features->armv8_aes ? "true" : "false",
+        features->armv8_sha ? "true" : "false");
+
+    for (size_t i = 0; i < info.algorithm_count; ++i) {
+        fprintf(stdout, "%s\"%s\": ", i ? ", " : "", info.algorithms[i].alg_name);
+        s_print_json_string_or_null(info.algorithms[i].provider);
+    }
+    fprintf(stdout, "}},\n");
+}
+
+static void s_print_usage(const char *program) {
+    fprintf(
+        stderr,
+        "usage: %s [--filter <substring>] [--min-time-ms <ms>] [--max-threads <count>]\n\n"
+        "Runs every benchmark whose name or operation contains the filter and prints the results as JSON.\n",
+        program);
+}
+
+int main(int argc, char **argv) {
+    struct bench_config config = {
+        .min_time_ns = (uint64_t)BENCH_DEFAULT_MIN_TIME_MS * 1000 * 1000,
+        .max_threads = BENCH_MAX_THREADS,
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && strcmp(argv[i], "--filter") == 0) {
+            config.filter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--min-time-ms") == 0) {
+            config.min_time_ns = strtoull(argv[++i], NULL, 10) * 1000 * 1000;
+        } else if (i + 1 < argc && strcmp(argv[i], "--max-threads") == 0) {
+            config.max_threads = aws_min_size(strtoul(argv[++i], NULL, 10), BENCH_MAX_THREADS);
+        } else {
+            s_print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_buf random_input;
+    size_t max_message_size = s_message_sizes[AWS_ARRAY_SIZE(s_message_sizes) - 1];
+    AWS_FATAL_ASSERT(!aws_byte_buf_init(&random_input, allocator, max_message_size) && "allocation failed");
+    AWS_FATAL_ASSERT(!aws_device_random_buffer(&random_input) && "reading random data failed");
+    config.random_input = aws_byte_cursor_from_buf(&random_input);
+
+    fprintf(stdout, "{\n");
+    s_print_runtime_info(allocator);
+    fprintf(
+        stdout,
+        "  \"min_time_ms\": %" PRIu64 ",\n  \"max_threads\": %zu,\n  \"results\": [",
+        config.min_time_ns / (1000 * 1000),
+        config.max_threads);
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(s_benchmarks); ++i) {
+        const struct bench_def *def = &s_benchmarks[i];
+        if (config.filter && !strstr(def->name, config.filter) && !strstr(def->operation, config.filter)) {
+            continue;
+        }
+        s_run_benchmark(&config, def);
+    }
+
+    fprintf(stdout, "\n  ]\n}\n");
+
+    aws_byte_buf_clean_up(&random_input);
+    aws_cal_library_clean_up();
+    return 0;
+}
@@ -8,20 +8,35 @@
 
 #include <aws/common/clock.h>
 #include <aws/common/device_random.h>
+#include <aws/common/thread.h>
 
 #include <inttypes.h>
 
+typedef int(profile_compute_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+struct profile_alg {
+    const char *name;
+    aws_hash_new_fn *new_fn;
+    profile_compute_fn *compute_fn;
+    size_t digest_len;
+};
+
 static void s_profile_streaming_hash_at_chunk_size(
     struct aws_allocator *allocator,
+    const struct profile_alg *alg,
     struct aws_byte_cursor to_hash,
     size_t chunk_size,
     size_t alignment) {
-    struct aws_hash *hash_impl = aws_sha256_new(allocator);
+    struct aws_hash *hash_impl = alg->new_fn(allocator);
     AWS_FATAL_ASSERT(hash_impl);
 
     struct aws_byte_buf output_buf;
     AWS_FATAL_ASSERT(
-        !aws_byte_buf_init(&output_buf, allocator, AWS_SHA256_LEN) && "allocation of output buffer failed!");
+        !aws_byte_buf_init(&output_buf, allocator, alg->digest_len) && "allocation of output buffer failed!");
 
     struct aws_byte_cursor to_hash_seeked = to_hash;
 
@@ -44,29 +59,103 @@ static void s_profile_streaming_hash_at_chunk_size(
     AWS_FATAL_ASSERT(!aws_hash_finalize(hash_impl, &output_buf, 0) && "hash finalize failed");
     uint64_t end = 0;
     AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&end) && "clock get ticks failed");
-    fprintf(stdout, "SHA256 streaming computation took %" PRIu64 "ns\n", end - start);
+    fprintf(stdout, "%s streaming computation took %" PRIu64 "ns\n", alg->name, end - start);
 
     aws_byte_buf_clean_up(&output_buf);
     aws_hash_destroy(hash_impl);
 }
 
-static void s_profile_oneshot_hash(struct aws_allocator *allocator, struct aws_byte_cursor to_hash) {
+static void s_profile_oneshot_hash(
+    struct aws_allocator *allocator,
+    const struct profile_alg *alg,
+    struct aws_byte_cursor to_hash) {
     struct aws_byte_buf output_buf;
 
     AWS_FATAL_ASSERT(
-        !aws_byte_buf_init(&output_buf, allocator, AWS_SHA256_LEN) && "allocation of output buffer failed!");
+        !aws_byte_buf_init(&output_buf, allocator, alg->digest_len) && "allocation of output buffer failed!");
 
     uint64_t start = 0;
     AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&start) && "clock get ticks failed.");
-    AWS_FATAL_ASSERT(!aws_sha256_compute(allocator, &to_hash, &output_buf, 0) && "Hash computation failed");
+    AWS_FATAL_ASSERT(!alg->compute_fn(allocator, &to_hash, &output_buf, 0) && "Hash computation failed");
     uint64_t end = 0;
     AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&end) && "clock get ticks failed");
-    fprintf(stdout, "SHA256 oneshot computation took %" PRIu64 "ns\n", end - start);
+    fprintf(stdout, "%s oneshot computation took %" PRIu64 "ns\n", alg->name, end - start);
     aws_byte_buf_clean_up(&output_buf);
 }
 
-static void s_run_profiles(struct aws_allocator *allocator, size_t to_hash_size, const char *profile_name) {
-    fprintf(stdout, "********************* SHA256 Profile %s ************************************\n\n", profile_name);
+#define PROFILE_MAX_THREADS 8
+
+struct profile_task {
+    void (*task_fn)(void *task_arg);
+    void *task_arg;
+};
+
+static void s_profile_task_thread(void *arg) {
+    struct profile_task *task = arg;
+    task->task_fn(task->task_arg);
+}
+
+/* a thread per task is plenty to show the scaling, a real caller would use its own pool */
+static void s_run_tasks_on_threads(void (*task_fn)(void *), void **task_args, size_t task_count, void *user_data) {
+    struct aws_allocator *allocator = user_data;
+    struct aws_thread threads[PROFILE_MAX_THREADS];
+    struct profile_task tasks[PROFILE_MAX_THREADS];
+    AWS_FATAL_ASSERT(task_count <= PROFILE_MAX_THREADS);
+
+    for (size_t i = 0; i < task_count; ++i) {
+        tasks[i].task_fn = task_fn;
+        tasks[i].task_arg = task_args[i];
+        AWS_FATAL_ASSERT(!aws_thread_init(&threads[i], allocator) && "thread init failed");
+        AWS_FATAL_ASSERT(
+            !aws_thread_launch(&threads[i], s_profile_task_thread, &tasks[i], NULL) && "thread launch failed");
+    }
+
+    for (size_t i = 0; i < task_count; ++i) {
+        aws_thread_join(&threads[i]);
+        aws_thread_clean_up(&threads[i]);
+    }
+}
+
+static void s_profile_parallel_blake3(struct aws_allocator *allocator, struct aws_byte_cursor to_hash) {
+    struct aws_blake3_parallel_options options = {
+        .run_tasks = s_run_tasks_on_threads,
+        .user_data = allocator,
+        .max_tasks = PROFILE_MAX_THREADS,
+    };
+
+    struct aws_hash *hash_impl = aws_blake3_new_parallel(allocator, &options);
+    AWS_FATAL_ASSERT(hash_impl);
+
+    struct aws_byte_buf output_buf;
+    AWS_FATAL_ASSERT(
+        !aws_byte_buf_init(&output_buf, allocator, AWS_BLAKE3_LEN) && "allocation of output buffer failed!");
+
+    uint64_t start = 0;
+    AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&start) && "clock get ticks failed.");
+    AWS_FATAL_ASSERT(!aws_hash_update(hash_impl, &to_hash) && "hash compute failed");
+    AWS_FATAL_ASSERT(!aws_hash_finalize(hash_impl, &output_buf, 0) && "hash finalize failed");
+    uint64_t end = 0;
+    AWS_FATAL_ASSERT(!aws_high_res_clock_get_ticks(&end) && "clock get ticks failed");
+    fprintf(
+        stdout,
+        "BLAKE3 oneshot computation on up to %d threads took %" PRIu64 "ns\n",
+        PROFILE_MAX_THREADS,
+        end - start);
+
+    aws_byte_buf_clean_up(&output_buf);
+    aws_hash_destroy(hash_impl);
+}
+
+static void s_run_profiles(
+    struct aws_allocator *allocator,
+    const struct profile_alg *alg,
+    size_t to_hash_size,
+    const char *profile_name) {
+    fprintf(
+        stdout,
+        "********************* %s Profile %s ************************************\n\n",
+        alg->name,
+        profile_name);
 
     struct aws_byte_buf to_hash;
     AWS_FATAL_ASSERT(!aws_byte_buf_init(&to_hash, allocator, to_hash_size) && "failed to allocate buffer for hashing");
@@ -76,35 +165,38 @@ static void s_run_profiles(struct aws_allocator *allocator, size_t to_hash_size,
     fprintf(stdout, "********************* Chunked/Alignment Runs *********************************\n\n");
     fprintf(stdout, "****** 128 byte chunks ******\n\n");
     fprintf(stdout, "8-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 128, 8);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 128, 8);
     fprintf(stdout, "16-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 128, 16);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 128, 16);
     fprintf(stdout, "64-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 128, 64);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 128, 64);
     fprintf(stdout, "128-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 128, 128);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 128, 128);
     fprintf(stdout, "\n****** 256 byte chunks ******\n\n");
     fprintf(stdout, "8-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 256, 8);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 256, 8);
     fprintf(stdout, "16-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 256, 16);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 256, 16);
     fprintf(stdout, "64-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 256, 64);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 256, 64);
     fprintf(stdout, "128-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 256, 128);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 256, 128);
 
     fprintf(stdout, "\n******* 512 byte chunks *****\n\n");
     fprintf(stdout, "8-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 512, 8);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 512, 8);
     fprintf(stdout, "16-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 512, 16);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 512, 16);
     fprintf(stdout, "64-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 512, 64);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 512, 64);
     fprintf(stdout, "128-byte alignment:\n");
-    s_profile_streaming_hash_at_chunk_size(allocator, to_hash_cur, 512, 128);
+    s_profile_streaming_hash_at_chunk_size(allocator, alg, to_hash_cur, 512, 128);
 
     fprintf(stdout, "\n********************** Oneshot Run *******************************************\n\n");
-    s_profile_oneshot_hash(allocator, to_hash_cur);
+    s_profile_oneshot_hash(allocator, alg, to_hash_cur);
+    if (alg->new_fn == aws_blake3_new) {
+        s_profile_parallel_blake3(allocator, to_hash_cur);
+    }
     fprintf(stdout, "\n\n");
     aws_byte_buf_clean_up(&to_hash);
 }
@@ -113,14 +205,27 @@ int main(void) {
     struct aws_allocator *allocator = aws_default_allocator();
     aws_cal_library_init(allocator);
 
-    struct aws_hash *hash_impl = aws_sha256_new(allocator);
-    fprintf(stdout, "Starting profile run for Sha256 using implementation %s\n\n", hash_impl->vtable->provider);
-    s_run_profiles(allocator, 1024, "1 KB");
-    s_run_profiles(allocator, 1024 * 64, "64 KB");
-    s_run_profiles(allocator, 1024 * 128, "128 KB");
-    s_run_profiles(allocator, 1024 * 512, "512 KB");
+    const struct profile_alg algs[] = {
+        {.name = "SHA256", .new_fn = aws_sha256_new, .compute_fn = aws_sha256_compute, .digest_len = AWS_SHA256_LEN},
+        {.name = "BLAKE3", .new_fn = aws_blake3_new, .compute_fn = aws_blake3_compute, .digest_len = AWS_BLAKE3_LEN},
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(algs); ++i) {
+        struct aws_hash *hash_impl = algs[i].new_fn(allocator);
+        fprintf(
+            stdout,
+            "Starting profile run for %s using implementation %s\n\n",
+            algs[i].name,
+            hash_impl->vtable->provider);
+        s_run_profiles(allocator, &algs[i], 1024, "1 KB");
+        s_run_profiles(allocator, &algs[i], 1024 * 64, "64 KB");
+        s_run_profiles(allocator, &algs[i], 1024 * 128, "128 KB");
+        s_run_profiles(allocator, &algs[i], 1024 * 512, "512 KB");
+        s_run_profiles(allocator, &algs[i], 1024 * 1024 * 64, "64 MB");
+
+        aws_hash_destroy(hash_impl);
+    }
 
-    aws_hash_destroy(hash_impl);
     aws_cal_library_clean_up();
     return 0;
 }
@@ -0,0 +1,132 @@
+#ifndef AWS_CAL_ASYNC_H
+#define AWS_CAL_ASYNC_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/exports.h>
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_hash;
+struct aws_symmetric_cipher;
+
+/*
+ * A worker pool runs hash and cipher operations off the calling thread, so an event loop thread can hand over a
+ * multi-megabyte payload and carry on serving its other connections, and be called back once it's done.
+ *
+ * Operations on the same hash or cipher run one at a time, in the order they were submitted, so a stream can be
+ * queued a chunk at a time without waiting on each. Operations on different objects run in parallel. Whatever is
+ * queued for an object when a worker gets to it is run as one batch, and consecutive hash updates in a batch go
+ * through a single aws_hash_update_vectored() call, so lots of small updates don't each pay for a hand off.
+ * If that call fails, every update in it completes with the error.
+ *
+ * Everything an operation refers to, the object, its input and its output buffer, must stay valid and untouched
+ * until its completion has been invoked. Nothing else may use the object in the meantime.
+ */
+struct aws_cal_worker_pool;
+
+/* Invoked on the thread that ran the operation, with 0 or the error it failed with. */
+typedef void(aws_cal_async_completion_fn)(int error_code, void *user_data);
+
+/* Runs run(arg) at some point, on any thread. */
+typedef void(aws_cal_async_run_fn)(void *arg);
+typedef void(aws_cal_worker_pool_submit_fn)(aws_cal_async_run_fn *run, void *arg, void *user_data);
+
+struct aws_cal_worker_pool_options {
+    /* how many threads the pool starts. 0 starts one per processor. Ignored along with submit. */
+    size_t thread_count;
+
+    /*
+     * Optional. Hands work to threads of your own, such as a task scheduler's or an existing thread pool, instead of
+     * the pool starting any. Called without any locks held, possibly from within a run().
+     */
+    aws_cal_worker_pool_submit_fn *submit;
+    void *user_data;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a worker pool. options may be NULL for the defaults. Returns NULL on failure.
+ */
+AWS_CAL_API struct aws_cal_worker_pool *aws_cal_worker_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_cal_worker_pool_options *options);
+
+/**
+ * Waits for every operation already submitted to complete, then stops the pool's threads and frees it. With a submit
+ * function, the runs already handed to it must still be run for this to return.
+ */
+AWS_CAL_API void aws_cal_worker_pool_destroy(struct aws_cal_worker_pool *pool);
+
+/**
+ * Queues aws_hash_update(hash, &input). Returns AWS_OP_ERR, without invoking on_complete, if it couldn't be queued.
+ */
+AWS_CAL_API int aws_hash_update_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_hash *hash,
+    struct aws_byte_cursor input,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data);
+
+/**
+ * Queues aws_hash_finalize(hash, output, truncate_to).
+ */
+AWS_CAL_API int aws_hash_finalize_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_hash *hash,
+    struct aws_byte_buf *output,
+    size_t truncate_to,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data);
+
+/**
+ * Queues aws_symmetric_cipher_encrypt(cipher, input, out).
+ */
+AWS_CAL_API int aws_symmetric_cipher_encrypt_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data);
+
+/**
+ * Queues aws_symmetric_cipher_decrypt(cipher, input, out).
+ */
+AWS_CAL_API int aws_symmetric_cipher_decrypt_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data);
+
+/**
+ * Queues aws_symmetric_cipher_finalize_encryption(cipher, out).
+ */
+AWS_CAL_API int aws_symmetric_cipher_finalize_encryption_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data);
+
+/**
+ * Queues aws_symmetric_cipher_finalize_decryption(cipher, out).
+ */
+AWS_CAL_API int aws_symmetric_cipher_finalize_decryption_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_CAL_ASYNC_H */
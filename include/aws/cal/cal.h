@@ -40,13 +40,62 @@ enum aws_cal_log_subject {
     AWS_LS_CAL_LAST = AWS_LOG_SUBJECT_END_RANGE(AWS_C_CAL_PACKAGE_ID)
 };
 
+struct aws_cal_library_options {
+    /*
+     * Optional. When set, libcrypto's own allocations, such as those behind EVP_MD_CTX_new(), EVP_CIPHER_CTX_new()
+     * and EC_KEY_new_by_curve_name(), go to this allocator. This sets libcrypto's process wide memory functions,
+     * which only works before anything in the process has allocated from libcrypto, and can never be undone, not even
+     * by aws_cal_library_clean_up(): the allocator must stay valid for the rest of the process, since libcrypto keeps
+     * allocating from it and frees its global state into it at exit. So it can't be a test or tracing allocator that
+     * gets destroyed, and it needn't be the one passed to aws_cal_library_init_ex(). Only OpenSSL 1.0.2 and later
+     * allow it, AWS-LC and BoringSSL builds ignore it. See aws_cal_libcrypto_allocations_routed().
+     */
+    struct aws_allocator *libcrypto_allocator;
+};
+
 AWS_EXTERN_C_BEGIN
 
 AWS_CAL_API void aws_cal_library_init(struct aws_allocator *allocator);
+
+/*
+ * aws_cal_library_init() with options, which may be NULL. As with aws_cal_library_init(), calls after the first
+ * before the library is cleaned up have no effect.
+ */
+AWS_CAL_API void aws_cal_library_init_ex(
+    struct aws_allocator *allocator,
+    const struct aws_cal_library_options *options);
+
 AWS_CAL_API void aws_cal_library_clean_up(void);
 
 /*
- * Every CRT thread that might invoke aws-lc functionality should call this as part of the thread at_exit process
+ * Returns true if libcrypto's allocations go to an aws allocator, see aws_cal_library_options.libcrypto_allocator.
+ */
+AWS_CAL_API bool aws_cal_libcrypto_allocations_routed(void);
+
+/*
+ * Returns an allocator for key material: keys, IVs and the like, charged to parent. Small allocations are carved out
+ * of pages that are locked into memory where the process is allowed to, so they are never swapped out or written to
+ * core dumps. Those pages, and larger allocations, are acquired from parent, so they show up in its accounting, and
+ * every allocation is zeroed when it is released. Pages are handed back to parent once nothing in them is in use,
+ * except that one idle chunk per size class is kept for reuse for as long as anything else is allocated for parent,
+ * and that the default allocator's are all kept for reuse until aws_cal_library_clean_up(). The ciphers
+ * keep their keys and IVs here, charged to the allocator they were created with. Always returns the same allocator
+ * for the same parent, until aws_cal_library_clean_up() frees the ones for parents other than the default allocator
+ * that nothing is allocated from anymore. Safe to use from any thread, and before aws_cal_library_init().
+ */
+AWS_CAL_API struct aws_allocator *aws_cal_secure_allocator_for(struct aws_allocator *parent);
+
+/*
+ * aws_cal_secure_allocator_for(aws_default_allocator()).
+ */
+AWS_CAL_API struct aws_allocator *aws_cal_secure_allocator(void);
+
+/*
+ * Every CRT thread that might invoke aws-lc functionality should call this as part of the thread at_exit process.
+ * This also releases the hash instances cached for the calling thread by the one-shot hash functions, such as
+ * aws_sha256_compute(). Those are only cached on threads started with aws_thread_launch(), which release them on
+ * exit by themselves, but an instance holds on to the allocator it was created with, so call this first if that
+ * allocator is going away before the thread does.
  */
 AWS_CAL_API void aws_cal_thread_clean_up(void);
 
@@ -12,12 +12,26 @@
 
 AWS_PUSH_SANE_WARNING_LEVEL
 
+/*
+ * AWS_CAL_ED25519 and AWS_CAL_X25519 keys keep their 32 byte public key in pub_x and leave pub_y empty, priv_d holds
+ * the 32 byte private key (the seed for Ed25519). They are only available on libcrypto builds that have them, other
+ * backends raise AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM when creating one. On Windows, CNG provides X25519 from
+ * Windows 10 on, and has no Ed25519.
+ */
 enum aws_ecc_curve_name {
     AWS_CAL_ECDSA_P256,
     AWS_CAL_ECDSA_P384,
+    /* signing only */
+    AWS_CAL_ED25519,
+    /* key agreement only */
+    AWS_CAL_X25519,
 };
 
 struct aws_ecc_key_pair;
+struct aws_ecc_signing_context;
+struct aws_ecc_key_pair_cache;
+struct aws_ecc_key_pair_pool;
+struct aws_array_list;
 
 typedef void aws_ecc_key_pair_destroy_fn(struct aws_ecc_key_pair *key_pair);
 typedef int aws_ecc_key_pair_sign_message_fn(
@@ -30,6 +44,61 @@ typedef int aws_ecc_key_pair_verify_signature_fn(
     const struct aws_byte_cursor *message,
     const struct aws_byte_cursor *signature);
 typedef size_t aws_ecc_key_pair_signature_length_fn(const struct aws_ecc_key_pair *signer);
+typedef int aws_ecc_key_pair_verify_signature_batch_fn(
+    const struct aws_ecc_key_pair *signer,
+    const struct aws_byte_cursor *messages,
+    const struct aws_byte_cursor *signatures,
+    size_t count,
+    uint8_t *valid_bitmap);
+typedef int aws_ecc_key_pair_prepare_for_verification_fn(struct aws_ecc_key_pair *key_pair);
+typedef int aws_ecc_key_pair_derive_shared_secret_fn(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output);
+typedef int aws_ecc_key_pair_sign_message_raw_fn(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output);
+typedef int aws_ecc_key_pair_verify_signature_raw_fn(
+    const struct aws_ecc_key_pair *signer,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature);
+typedef int aws_ecc_key_pair_load_key_data_fn(struct aws_ecc_key_pair *key_pair);
+
+struct aws_ecc_key_pair_cache_options {
+    /* most keys kept at once, least recently used ones are dropped first. 0 picks a default of 1024. */
+    size_t max_entries;
+};
+
+struct aws_ecc_key_pair_cache_stats {
+    /* lookups answered from the cache */
+    size_t hits;
+    /* lookups that had to parse the key, including ones that failed */
+    size_t misses;
+};
+
+struct aws_ecc_key_pair_pool_options {
+    /* AWS_CAL_ECDSA_P256 or AWS_CAL_ECDSA_P384 */
+    enum aws_ecc_curve_name curve_name;
+    /* key pairs kept ready at once. 0 picks a default of 16. */
+    size_t depth;
+};
+
+struct aws_ecc_key_pair_pool_stats {
+    /* acquires answered with a pregenerated key pair */
+    size_t pooled;
+    /* acquires that found the pool empty and generated on the calling thread */
+    size_t generated_inline;
+};
+
+struct aws_ecc_pem_load_options {
+    /* threads parsing a bundle's keys at once, counting the calling thread. 0 or 1 parses them all on the calling
+     * thread. */
+    size_t thread_count;
+};
+
+/* Bytes needed for the valid_bitmap of aws_ecc_key_pair_verify_signature_batch(). */
+#define AWS_ECC_VERIFY_BATCH_BITMAP_LEN(count) (((count) + 7) / 8)
 
 struct aws_ecc_key_pair_vtable {
     aws_ecc_key_pair_destroy_fn *destroy;
@@ -37,6 +106,23 @@ struct aws_ecc_key_pair_vtable {
     aws_ecc_key_pair_sign_message_fn *sign_message;
     aws_ecc_key_pair_verify_signature_fn *verify_signature;
     aws_ecc_key_pair_signature_length_fn *signature_length;
+    /* optional, verify_signature is called once per item when this is NULL. */
+    aws_ecc_key_pair_verify_signature_batch_fn *verify_signature_batch;
+    /* optional, preparing is a no-op when this is NULL. */
+    aws_ecc_key_pair_prepare_for_verification_fn *prepare_for_verification;
+    /*
+     * optional, set these when the backend handles fixed length r || s signatures natively. Otherwise the DER functions
+     * are used and the signature is converted.
+     */
+    aws_ecc_key_pair_sign_message_raw_fn *sign_message_raw;
+    aws_ecc_key_pair_verify_signature_raw_fn *verify_signature_raw;
+    /* optional, key agreement is unsupported when this is NULL. */
+    aws_ecc_key_pair_derive_shared_secret_fn *derive_shared_secret;
+    /*
+     * optional, for backends that create keys without filling in pub_x, pub_y and priv_d. It is called before the
+     * accessors hand them out, must be safe to call from several threads at once and cheap once the data is loaded.
+     */
+    aws_ecc_key_pair_load_key_data_fn *load_key_data;
 };
 
 struct aws_ecc_key_pair {
@@ -44,6 +130,7 @@ struct aws_ecc_key_pair {
     struct aws_atomic_var ref_count;
     enum aws_ecc_curve_name curve_name;
     struct aws_byte_buf key_buf;
+    /* may be empty until loaded, use aws_ecc_key_pair_get_public_key() and aws_ecc_key_pair_get_private_key() */
     struct aws_byte_buf pub_x;
     struct aws_byte_buf pub_y;
     struct aws_byte_buf priv_d;
@@ -89,7 +176,12 @@ AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_new_generate_random(
  * Creates an Elliptic Curve public key that can be used for verifying.
  * Returns a new instance of aws_ecc_key_pair if the key was successfully built.
  * Otherwise returns NULL. Note: public_key_x::len and public_key_y::len must
- * match the appropriate length for the selected curve_name.
+ * match the appropriate length for the selected curve_name. For AWS_CAL_ED25519 and AWS_CAL_X25519 public_key_x is
+ * the encoded public key and public_key_y must be NULL or empty.
+ *
+ * Everything this library allocates for the key comes from allocator, so short lived keys, like one per peer
+ * certificate, can be built from an arena that is released in one piece once the last reference is gone. The
+ * libcrypto backend makes a single allocation per key pair.
  */
 AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_public_key(
     struct aws_allocator *allocator,
@@ -107,6 +199,29 @@ AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *encoded_keys);
 
+/**
+ * Same as aws_ecc_key_pair_new_from_asn1(), but reads the first "EC PRIVATE KEY" or "PUBLIC KEY" block out of PEM
+ * text. Other blocks, such as the "EC PARAMETERS" some tools write first, are skipped. The base64 body is decoded into
+ * scratch, which grows as needed and is wiped again before returning; passing the same initialized buffer for every
+ * key saves allocating one per call. scratch may be NULL to use a temporary buffer.
+ */
+AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_pem(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *pem,
+    struct aws_byte_buf *scratch);
+
+/**
+ * Parses every "EC PRIVATE KEY" and "PUBLIC KEY" block in pem and appends the key pairs to out_key_pairs, an
+ * initialized aws_array_list of struct aws_ecc_key_pair *, in the order they appear. Large bundles can be spread over
+ * options->thread_count threads; options may be NULL to parse on the calling thread. Either every key is appended or,
+ * on failure, none are. Release each appended key pair with aws_ecc_key_pair_release().
+ */
+AWS_CAL_API int aws_ecc_key_pairs_new_from_pem_bundle(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *pem,
+    const struct aws_ecc_pem_load_options *options,
+    struct aws_array_list *out_key_pairs);
+
 /**
  * Creates an Elliptic curve public key from x and y coordinates encoded as hex strings
  * Returns a new instance of aws_ecc_key_pair if the key was successfully built.
@@ -141,7 +256,8 @@ AWS_CAL_API int aws_ecc_oid_from_curve_name(enum aws_ecc_curve_name curve_name,
  * encoded.
  *
  * It is the callers job to make sure message is the appropriate cryptographic digest for this operation. It's usually
- * something like a SHA256.
+ * something like a SHA256. Ed25519 is the exception: it hashes internally, so message is the message itself and the
+ * signature is the 64 byte value from RFC 8032 rather than DER.
  */
 AWS_CAL_API int aws_ecc_key_pair_sign_message(
     const struct aws_ecc_key_pair *key_pair,
@@ -161,19 +277,231 @@ AWS_CAL_API int aws_ecc_key_pair_verify_signature(
     const struct aws_ecc_key_pair *key_pair,
     const struct aws_byte_cursor *message,
     const struct aws_byte_cursor *signature);
+
+/**
+ * Verifies count signatures with key_pair's public key, as aws_ecc_key_pair_verify_signature() would for each
+ * messages[i] and signatures[i] pair, and records every result: bit (i % 8) of valid_bitmap[i / 8] is set if signature
+ * i is valid. valid_bitmap must be at least AWS_ECC_VERIFY_BATCH_BITMAP_LEN(count) bytes and all of it is written.
+ *
+ * Backends that can share work across the batch do so, the rest verify one signature at a time. ECDSA signatures
+ * don't carry R's y coordinate, so the scalar multiplications can't be combined. With OpenSSL the modular and field
+ * inversions are shared, which saves a few percent.
+ *
+ * returns AWS_OP_SUCCESS if every signature is valid. Otherwise AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED is raised
+ * and valid_bitmap says which ones failed.
+ */
+AWS_CAL_API int aws_ecc_key_pair_verify_signature_batch(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *messages,
+    const struct aws_byte_cursor *signatures,
+    size_t count,
+    uint8_t *valid_bitmap);
+
+/**
+ * Builds and caches whatever precomputed state the backend can keep on key_pair to make later verify calls cheaper,
+ * trading memory for speed on long-lived verification keys. The cached state belongs to key_pair and is freed when its
+ * ref count drops to zero. Calling this more than once is harmless, and backends with nothing to precompute treat it
+ * as a no-op.
+ *
+ * This mutates key_pair, so call it before the key is shared between threads: concurrent calls to this function are
+ * safe, but a verify running on another thread while it does its work is not. Keys handed out by
+ * aws_ecc_key_pair_cache are already prepared.
+ */
+AWS_CAL_API int aws_ecc_key_pair_prepare_for_verification(struct aws_ecc_key_pair *key_pair);
+
 AWS_CAL_API size_t aws_ecc_key_pair_signature_length(const struct aws_ecc_key_pair *key_pair);
 
+/**
+ * Same as aws_ecc_key_pair_sign_message(), but appends the signature in the fixed length raw format used by JWS and
+ * COSE: r followed by s, each left padded with zeros to the curve's coordinate size. Exactly
+ * aws_ecc_key_pair_raw_signature_length() bytes are written, so signature_output must have at least that much space
+ * left.
+ */
+AWS_CAL_API int aws_ecc_key_pair_sign_message_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output);
+
+/**
+ * Same as aws_ecc_key_pair_verify_signature(), but signature is in the raw r || s format produced by
+ * aws_ecc_key_pair_sign_message_raw(). A signature of the wrong length fails validation.
+ *
+ * returns AWS_OP_SUCCESS if the signature is valid.
+ */
+AWS_CAL_API int aws_ecc_key_pair_verify_signature_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature);
+
+/**
+ * Returns the length of a raw r || s signature for key_pair's curve, twice the coordinate size.
+ */
+AWS_CAL_API size_t aws_ecc_key_pair_raw_signature_length(const struct aws_ecc_key_pair *key_pair);
+
+/**
+ * Points pub_x and pub_y at the key's public coordinates. Generated keys may only export their coordinates from the
+ * backend on the first call, if that fails both cursors come back empty.
+ */
 AWS_CAL_API void aws_ecc_key_pair_get_public_key(
     const struct aws_ecc_key_pair *key_pair,
     struct aws_byte_cursor *pub_x,
     struct aws_byte_cursor *pub_y);
 
+/**
+ * Points private_d at the key's private scalar, loading it like aws_ecc_key_pair_get_public_key() does. private_d is
+ * empty on failure.
+ */
 AWS_CAL_API void aws_ecc_key_pair_get_private_key(
     const struct aws_ecc_key_pair *key_pair,
     struct aws_byte_cursor *private_d);
 
+/**
+ * Appends key_pair's public key to output as a DER encoded SubjectPublicKeyInfo, which aws_ecc_key_pair_new_from_asn1()
+ * reads back. The encoding is written straight into output, which needs room for it, without allocating. Only the
+ * NIST curves are supported.
+ */
+AWS_CAL_API int aws_ecc_key_pair_write_public_key_spki(
+    const struct aws_ecc_key_pair *key_pair,
+    struct aws_byte_buf *output);
+
 AWS_CAL_API size_t aws_ecc_key_coordinate_byte_size_from_curve_name(enum aws_ecc_curve_name curve_name);
 
+/**
+ * Computes the key agreement between key_pair's private key and peer_key's public key and appends the
+ * aws_ecc_key_coordinate_byte_size_from_curve_name() byte shared secret to shared_secret_output, which must already
+ * have room for it. Both keys must use the same curve and come from the same backend.
+ *
+ * The result is the raw shared secret, run it through a KDF such as aws_sha256_hkdf_compute() before using it as a key.
+ */
+AWS_CAL_API int aws_ecc_key_pair_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output);
+
+/**
+ * Creates a context that hashes a message incrementally and then signs or verifies the digest with key_pair, so
+ * callers don't need to manage an aws_hash and a digest buffer of their own. The digest matches the curve: SHA-256
+ * for P-256 and SHA-384 for P-384. Other curves raise AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM, Ed25519 already takes the
+ * whole message. The context holds a reference to key_pair until it is destroyed.
+ *
+ * After a sign or verify call the context starts a new message, so one context can be reused for any number of
+ * messages. It is not safe to use from multiple threads at once.
+ */
+AWS_CAL_API struct aws_ecc_signing_context *aws_ecc_signing_context_new(
+    struct aws_allocator *allocator,
+    struct aws_ecc_key_pair *key_pair);
+
+AWS_CAL_API void aws_ecc_signing_context_destroy(struct aws_ecc_signing_context *context);
+
+/**
+ * Adds to_sign to the message being signed or verified. This can be called multiple times.
+ */
+AWS_CAL_API int aws_ecc_signing_context_update(
+    struct aws_ecc_signing_context *context,
+    const struct aws_byte_cursor *to_sign);
+
+/**
+ * Finishes the digest of the message and appends a DER encoded signature to signature_output, as
+ * aws_ecc_key_pair_sign_message() would.
+ */
+AWS_CAL_API int aws_ecc_signing_context_sign(
+    struct aws_ecc_signing_context *context,
+    struct aws_byte_buf *signature_output);
+
+/**
+ * Finishes the digest of the message and verifies the DER encoded signature against it, as
+ * aws_ecc_key_pair_verify_signature() would.
+ */
+AWS_CAL_API int aws_ecc_signing_context_verify(
+    struct aws_ecc_signing_context *context,
+    const struct aws_byte_cursor *signature);
+
+/**
+ * Same as aws_ecc_signing_context_sign(), but writes a raw r || s signature as aws_ecc_key_pair_sign_message_raw()
+ * would.
+ */
+AWS_CAL_API int aws_ecc_signing_context_sign_raw(
+    struct aws_ecc_signing_context *context,
+    struct aws_byte_buf *signature_output);
+
+/**
+ * Same as aws_ecc_signing_context_verify(), but signature is a raw r || s signature.
+ */
+AWS_CAL_API int aws_ecc_signing_context_verify_raw(
+    struct aws_ecc_signing_context *context,
+    const struct aws_byte_cursor *signature);
+
+/**
+ * Creates a cache of parsed public keys, for callers that see the same few keys over and over. It is safe to share
+ * one cache between threads: entries are spread over independently locked shards, so lookups of different keys
+ * rarely wait on each other. options may be NULL for the defaults.
+ */
+AWS_CAL_API struct aws_ecc_key_pair_cache *aws_ecc_key_pair_cache_new(
+    struct aws_allocator *allocator,
+    const struct aws_ecc_key_pair_cache_options *options);
+
+/**
+ * Destroys the cache and drops its references. Key pairs callers still hold stay valid.
+ */
+AWS_CAL_API void aws_ecc_key_pair_cache_destroy(struct aws_ecc_key_pair_cache *cache);
+
+/**
+ * Same as aws_ecc_key_pair_new_from_asn1(), but returns the already parsed key when the same encoding was seen
+ * recently. Entries are keyed by a SHA-256 digest of the encoding. Every call returns a new reference, release it
+ * with aws_ecc_key_pair_release(). Encodings that carry a private key are parsed every time and never cached.
+ */
+AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_cache_acquire_from_asn1(
+    struct aws_ecc_key_pair_cache *cache,
+    const struct aws_byte_cursor *encoded_keys);
+
+/**
+ * Same as aws_ecc_key_new_from_hex_coordinates(), but goes through the cache like
+ * aws_ecc_key_pair_cache_acquire_from_asn1().
+ */
+AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_cache_acquire_from_hex_coordinates(
+    struct aws_ecc_key_pair_cache *cache,
+    enum aws_ecc_curve_name curve_name,
+    struct aws_byte_cursor pub_x_hex_cursor,
+    struct aws_byte_cursor pub_y_hex_cursor);
+
+/**
+ * Reads the cache's hit and miss counters.
+ */
+AWS_CAL_API void aws_ecc_key_pair_cache_get_stats(
+    const struct aws_ecc_key_pair_cache *cache,
+    struct aws_ecc_key_pair_cache_stats *stats);
+
+#if !defined(AWS_OS_IOS)
+/**
+ * Creates a pool that keeps up to options->depth freshly generated key pairs ready on a background thread, so that
+ * callers who need ephemeral keys on a latency sensitive path don't pay for key generation there. The background
+ * thread only runs to replace keys that were handed out.
+ */
+AWS_CAL_API struct aws_ecc_key_pair_pool *aws_ecc_key_pair_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_ecc_key_pair_pool_options *options);
+
+/**
+ * Stops the background thread and destroys the pool. Key pairs that were never handed out are released, which wipes
+ * their private keys. Key pairs callers already acquired stay valid.
+ */
+AWS_CAL_API void aws_ecc_key_pair_pool_destroy(struct aws_ecc_key_pair_pool *pool);
+
+/**
+ * Hands out a new key pair from the pool, equivalent to aws_ecc_key_pair_new_generate_random() for the pool's curve.
+ * Taking a key is lock free. If the pool has run dry the key pair is generated on the calling thread instead. Each key
+ * pair is handed out once, release it with aws_ecc_key_pair_release(). Safe to call from any thread.
+ */
+AWS_CAL_API struct aws_ecc_key_pair *aws_ecc_key_pair_pool_acquire(struct aws_ecc_key_pair_pool *pool);
+
+/**
+ * Reads how many acquires the pool answered from pregenerated keys and how many it had to generate inline.
+ */
+AWS_CAL_API void aws_ecc_key_pair_pool_get_stats(
+    const struct aws_ecc_key_pair_pool *pool,
+    struct aws_ecc_key_pair_pool_stats *stats);
+#endif /* !AWS_OS_IOS */
+
 AWS_EXTERN_C_END
 AWS_POP_SANE_WARNING_LEVEL
 
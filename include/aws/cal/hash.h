@@ -14,15 +14,45 @@ AWS_PUSH_SANE_WARNING_LEVEL
 #define AWS_SHA256_LEN 32
 #define AWS_SHA1_LEN 20
 #define AWS_MD5_LEN 16
+#define AWS_SHA384_LEN 48
+#define AWS_SHA512_LEN 64
+#define AWS_SHA512_256_LEN 32
+#define AWS_BLAKE3_LEN 32
+
+/* The most bytes aws_hash_export_state() ever writes. */
+#define AWS_HASH_STATE_MAX_SIZE 128
 
 struct aws_hash;
 
+/**
+ * The intermediate state of an MD5, SHA-1 or SHA-256 hash partway through a message, as exchanged with a hash
+ * implementation's export_state and import_state.
+ */
+struct aws_hash_md_state {
+    /* the digest_size / 4 chaining values, as numbers rather than in the algorithm's byte order */
+    uint32_t chaining_values[8];
+    /* the number of bytes hashed so far */
+    uint64_t message_len;
+    /* the last message_len % 64 bytes, which haven't been run through the compression function yet */
+    uint8_t buffered[64];
+};
+
 struct aws_hash_vtable {
     const char *alg_name;
     const char *provider;
     void (*destroy)(struct aws_hash *hash);
     int (*update)(struct aws_hash *hash, const struct aws_byte_cursor *buf);
     int (*finalize)(struct aws_hash *hash, struct aws_byte_buf *out);
+    int (*reset)(struct aws_hash *hash);
+    /* optional, feeds every segment to the digest in one call. aws_hash_update_vectored() falls back to calling
+     * update per segment when this is NULL. */
+    int (*update_vectored)(struct aws_hash *hash, const struct aws_byte_cursor *segments, size_t segment_count);
+    /* optional, copy the running state out of and back into the hash. aws_hash_export_state() and
+     * aws_hash_import_state() raise AWS_ERROR_UNSUPPORTED_OPERATION when these are NULL. */
+    int (*export_state)(const struct aws_hash *hash, struct aws_hash_md_state *state);
+    int (*import_state)(struct aws_hash *hash, const struct aws_hash_md_state *state);
+    /* optional, aws_hash_duplicate() raises AWS_ERROR_UNSUPPORTED_OPERATION when this is NULL */
+    struct aws_hash *(*duplicate)(struct aws_allocator *allocator, const struct aws_hash *hash);
 };
 
 struct aws_hash {
@@ -35,6 +65,47 @@ struct aws_hash {
 
 typedef struct aws_hash *(aws_hash_new_fn)(struct aws_allocator *allocator);
 
+typedef int(aws_hash_compute_batch_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to);
+
+/**
+ * Runs task_fn(task_args[i]) for every i in [0, task_count) and returns once all of them have completed. The
+ * tasks don't depend on each other, so they may run concurrently on as many threads as the implementation likes.
+ */
+typedef void(aws_hash_run_tasks_fn)(
+    void (*task_fn)(void *task_arg),
+    void **task_args,
+    size_t task_count,
+    void *user_data);
+
+typedef aws_hash_run_tasks_fn aws_blake3_run_tasks_fn;
+
+struct aws_blake3_parallel_options {
+    /* Required. Typically hands the tasks to a thread pool owned by the caller. */
+    aws_blake3_run_tasks_fn *run_tasks;
+    void *user_data;
+    /* The most tasks a single update is split into, rounded down to a power of 2. 0 means 8, capped at 64. */
+    size_t max_tasks;
+    /* Updates shorter than this are hashed on the calling thread. 0 means 1MB. */
+    size_t min_parallel_len;
+};
+
+struct aws_sha256_composite_options {
+    /* Required. The length of every part but the last, which holds whatever is left. */
+    size_t part_size;
+    /* Optional. Typically hands the tasks to a thread pool owned by the caller. NULL hashes every part on the
+     * calling thread. */
+    aws_hash_run_tasks_fn *run_tasks;
+    void *user_data;
+    /* The most tasks the parts are spread across, each hashing a run of neighbouring parts on one instance.
+     * 0 means 8, capped at 64. */
+    size_t max_tasks;
+};
+
 AWS_EXTERN_C_BEGIN
 /**
  * Allocates and initializes a sha256 hash instance.
@@ -48,6 +119,33 @@ AWS_CAL_API struct aws_hash *aws_sha1_new(struct aws_allocator *allocator);
  * Allocates and initializes an md5 hash instance.
  */
 AWS_CAL_API struct aws_hash *aws_md5_new(struct aws_allocator *allocator);
+/**
+ * Allocates and initializes a sha384 hash instance.
+ */
+AWS_CAL_API struct aws_hash *aws_sha384_new(struct aws_allocator *allocator);
+/**
+ * Allocates and initializes a sha512 hash instance.
+ */
+AWS_CAL_API struct aws_hash *aws_sha512_new(struct aws_allocator *allocator);
+/**
+ * Allocates and initializes a sha512/256 hash instance (FIPS 180-4 sha512 with
+ * its own initial values, truncated to 256 bits). Not every platform provides
+ * this algorithm, in which case NULL is returned and
+ * AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM is raised.
+ */
+AWS_CAL_API struct aws_hash *aws_sha512_256_new(struct aws_allocator *allocator);
+/**
+ * Allocates and initializes a BLAKE3 hash instance with the default 32 byte output. BLAKE3 is always
+ * provided by aws-c-cal itself, using SSE4.1 or NEON when the cpu has them.
+ */
+AWS_CAL_API struct aws_hash *aws_blake3_new(struct aws_allocator *allocator);
+/**
+ * Allocates and initializes a BLAKE3 hash instance that splits large updates into independent subtrees
+ * and hands them to options->run_tasks. The result is identical to aws_blake3_new(). options is copied.
+ */
+AWS_CAL_API struct aws_hash *aws_blake3_new_parallel(
+    struct aws_allocator *allocator,
+    const struct aws_blake3_parallel_options *options);
 
 /**
  * Cleans up and deallocates hash.
@@ -57,6 +155,20 @@ AWS_CAL_API void aws_hash_destroy(struct aws_hash *hash);
  * Updates the running hash with to_hash. this can be called multiple times.
  */
 AWS_CAL_API int aws_hash_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
+/**
+ * Updates the running hash with each of the segment_count cursors in segments, in order. The result is the same as
+ * calling aws_hash_update() once per segment, but backends that can will take the whole chain in a single call.
+ */
+AWS_CAL_API int aws_hash_update_vectored(
+    struct aws_hash *hash,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count);
+/**
+ * Updates the running hash with the contents of the file at path. Where mmap is available the file is mapped in
+ * large windows that are hashed in place, otherwise it's read through a single buffer. The file must not be
+ * truncated while it's being hashed.
+ */
+AWS_CAL_API int aws_hash_update_file(struct aws_hash *hash, const char *path);
 /**
  * Completes the hash computation and writes the final digest to output.
  * Allocation of output is the caller's responsibility. If you specify
@@ -67,10 +179,45 @@ AWS_CAL_API int aws_hash_update(struct aws_hash *hash, const struct aws_byte_cur
  */
 AWS_CAL_API int aws_hash_finalize(struct aws_hash *hash, struct aws_byte_buf *output, size_t truncate_to);
 
+/**
+ * Restores hash to its freshly initialized state so it can compute another digest
+ * without being destroyed and reallocated. This can be called after aws_hash_finalize()
+ * or to discard a partially updated digest. Raises AWS_ERROR_UNSUPPORTED_OPERATION if
+ * the hash implementation does not support being reset.
+ */
+AWS_CAL_API int aws_hash_reset(struct aws_hash *hash);
+
+/**
+ * Allocates a new hash instance holding a copy of hash's running state, so a prefix hashed once can be
+ * finished with several different suffixes. The two instances are independent from then on and each is
+ * destroyed with aws_hash_destroy(). Raises AWS_ERROR_INVALID_STATE if hash has been finalized, and
+ * AWS_ERROR_UNSUPPORTED_OPERATION if the implementation can't be copied.
+ */
+AWS_CAL_API struct aws_hash *aws_hash_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
+
+/**
+ * Appends the state of a partially updated md5, sha1 or sha256 hash to output, as at most
+ * AWS_HASH_STATE_MAX_SIZE bytes that can be persisted and later handed to aws_hash_import_state()
+ * to carry on from the same point, in this process or another, and with any provider. The state
+ * is derived from the input, so treat it as carefully as the input itself. Raises
+ * AWS_ERROR_UNSUPPORTED_OPERATION if the implementation can't expose its state. AWS-LC exposes
+ * sha1 and sha256 only after a multiple of 64 bytes, other libcrypto builds not at all.
+ */
+AWS_CAL_API int aws_hash_export_state(const struct aws_hash *hash, struct aws_byte_buf *output);
+
+/**
+ * Replaces the state of hash with one written by aws_hash_export_state() for the same algorithm,
+ * so the next update continues the exported message. Raises AWS_ERROR_INVALID_ARGUMENT if state is
+ * malformed or from another algorithm, and AWS_ERROR_UNSUPPORTED_OPERATION if the implementation
+ * can't take a state.
+ */
+AWS_CAL_API int aws_hash_import_state(struct aws_hash *hash, struct aws_byte_cursor state);
+
 /**
  * Computes the md5 hash over input and writes the digest output to 'output'.
  * Use this if you don't need to stream the data you're hashing and you can load
- * the entire input to hash into memory.
+ * the entire input to hash into memory. The underlying hash instance is cached
+ * per thread, call aws_cal_thread_clean_up() before the thread exits to release it.
  */
 AWS_CAL_API int aws_md5_compute(
     struct aws_allocator *allocator,
@@ -84,7 +231,9 @@ AWS_CAL_API int aws_md5_compute(
  * the entire input to hash into memory. If you specify truncate_to to something
  * other than 0, the output will be truncated to that number of bytes. For
  * example, if you want a SHA256 digest as the first 16 bytes, set truncate_to
- * to 16. If you want the full digest size, just set this to 0.
+ * to 16. If you want the full digest size, just set this to 0. The underlying
+ * hash instance is cached per thread, call aws_cal_thread_clean_up() before the
+ * thread exits to release it.
  */
 AWS_CAL_API int aws_sha256_compute(
     struct aws_allocator *allocator,
@@ -92,13 +241,60 @@ AWS_CAL_API int aws_sha256_compute(
     struct aws_byte_buf *output,
     size_t truncate_to);
 
+/**
+ * Computes the sha256 hash of each of the count independent messages in inputs and appends
+ * each digest to the output buffer at the same index. truncate_to behaves as it does for
+ * aws_sha256_compute() and applies to every digest. Every output buffer is checked for
+ * sufficient space before anything is hashed, if any is too small AWS_ERROR_SHORT_BUFFER
+ * is raised and no output is written.
+ */
+AWS_CAL_API int aws_sha256_compute_batch(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to);
+
+/**
+ * Computes the sha256 hash of the contents of the file at path and writes the digest to output. truncate_to
+ * behaves as it does for aws_sha256_compute(). See aws_hash_update_file() for how the file is read.
+ */
+AWS_CAL_API int aws_sha256_compute_file(
+    struct aws_allocator *allocator,
+    const char *path,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+/**
+ * Returns the number of parts aws_sha256_composite_compute() splits input_len bytes into, which is at least 1
+ * since empty input is a single empty part. Returns 0 if part_size is 0.
+ */
+AWS_CAL_API size_t aws_sha256_composite_part_count(size_t input_len, size_t part_size);
+
+/**
+ * Computes an S3 style composite checksum over input: input is split into options->part_size long parts, the
+ * sha256 of each part is computed on the tasks handed to options->run_tasks, and the sha256 of the part digests
+ * concatenated in order is appended to output. If part_digests is not NULL, the AWS_SHA256_LEN byte digest of
+ * every part is appended to it too, in order. Both buffers are checked for space before anything is hashed; if
+ * either is too small AWS_ERROR_SHORT_BUFFER is raised and nothing is written. To checksum a file, map it and pass
+ * the mapping as input.
+ */
+AWS_CAL_API int aws_sha256_composite_compute(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor input,
+    const struct aws_sha256_composite_options *options,
+    struct aws_byte_buf *part_digests,
+    struct aws_byte_buf *output);
+
 /**
  * Computes the sha1 hash over input and writes the digest output to 'output'.
  * Use this if you don't need to stream the data you're hashing and you can load
  * the entire input to hash into memory. If you specify truncate_to to something
  * other than 0, the output will be truncated to that number of bytes. For
  * example, if you want a SHA1 digest as the first 16 bytes, set truncate_to
- * to 16. If you want the full digest size, just set this to 0.
+ * to 16. If you want the full digest size, just set this to 0. The underlying
+ * hash instance is cached per thread, call aws_cal_thread_clean_up() before the
+ * thread exits to release it.
  */
 AWS_CAL_API int aws_sha1_compute(
     struct aws_allocator *allocator,
@@ -106,6 +302,50 @@ AWS_CAL_API int aws_sha1_compute(
     struct aws_byte_buf *output,
     size_t truncate_to);
 
+/**
+ * Computes the sha384 hash over input and writes the digest output to 'output'.
+ * Behaves like aws_sha256_compute(), including the truncate_to semantics and
+ * the per thread caching of the underlying hash instance.
+ */
+AWS_CAL_API int aws_sha384_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+/**
+ * Computes the sha512 hash over input and writes the digest output to 'output'.
+ * Behaves like aws_sha256_compute(), including the truncate_to semantics and
+ * the per thread caching of the underlying hash instance.
+ */
+AWS_CAL_API int aws_sha512_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+/**
+ * Computes the sha512/256 hash over input and writes the digest output to 'output'.
+ * Behaves like aws_sha256_compute(), including the truncate_to semantics and
+ * the per thread caching of the underlying hash instance.
+ */
+AWS_CAL_API int aws_sha512_256_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+/**
+ * Computes the BLAKE3 hash over input and writes the digest output to 'output'.
+ * Behaves like aws_sha256_compute(), including the truncate_to semantics and
+ * the per thread caching of the underlying hash instance.
+ */
+AWS_CAL_API int aws_blake3_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
 /**
  * Set the implementation of md5 to use. If you compiled without BYO_CRYPTO,
  * you do not need to call this. However, if use this, we will honor it,
@@ -124,6 +364,17 @@ AWS_CAL_API void aws_set_md5_new_fn(aws_hash_new_fn *fn);
  */
 AWS_CAL_API void aws_set_sha256_new_fn(aws_hash_new_fn *fn);
 
+/**
+ * Set the implementation of aws_sha256_compute_batch() to use, for example a
+ * multi-buffer kernel that hashes several messages at once. By default, every
+ * message is hashed in turn on a single instance created by the sha256
+ * implementation set via aws_set_sha256_new_fn(), except that BUILTIN_SHA builds
+ * hash pairs of messages on one interleaved kernel while the builtin sha256 is
+ * installed. The function is only invoked after every output buffer has been
+ * verified to have enough space.
+ */
+AWS_CAL_API void aws_set_sha256_compute_batch_fn(aws_hash_compute_batch_fn *fn);
+
 /**
  * Set the implementation of sha1 to use. If you compiled without
  * BYO_CRYPTO, you do not need to call this. However, if use this, we will
@@ -133,6 +384,40 @@ AWS_CAL_API void aws_set_sha256_new_fn(aws_hash_new_fn *fn);
  */
 AWS_CAL_API void aws_set_sha1_new_fn(aws_hash_new_fn *fn);
 
+/**
+ * Set the implementation of sha384 to use. If you compiled without
+ * BYO_CRYPTO, you do not need to call this. However, if use this, we will
+ * honor it, regardless of compile options. This may be useful for testing
+ * purposes. If you did set BYO_CRYPTO, and you do not call this function
+ * you will segfault.
+ */
+AWS_CAL_API void aws_set_sha384_new_fn(aws_hash_new_fn *fn);
+
+/**
+ * Set the implementation of sha512 to use. If you compiled without
+ * BYO_CRYPTO, you do not need to call this. However, if use this, we will
+ * honor it, regardless of compile options. This may be useful for testing
+ * purposes. If you did set BYO_CRYPTO, and you do not call this function
+ * you will segfault.
+ */
+AWS_CAL_API void aws_set_sha512_new_fn(aws_hash_new_fn *fn);
+
+/**
+ * Set the implementation of sha512/256 to use. If you compiled without
+ * BYO_CRYPTO, you do not need to call this. However, if use this, we will
+ * honor it, regardless of compile options. This may be useful for testing
+ * purposes. If you did set BYO_CRYPTO, and you do not call this function
+ * you will segfault.
+ */
+AWS_CAL_API void aws_set_sha512_256_new_fn(aws_hash_new_fn *fn);
+
+/**
+ * Set the implementation of BLAKE3 to use. aws-c-cal always provides one, even
+ * with BYO_CRYPTO, so this is only needed to substitute a different
+ * implementation (for testing, or one backed by the caller's own crypto).
+ */
+AWS_CAL_API void aws_set_blake3_new_fn(aws_hash_new_fn *fn);
+
 AWS_EXTERN_C_END
 AWS_POP_SANE_WARNING_LEVEL
 
@@ -12,6 +12,8 @@
 AWS_PUSH_SANE_WARNING_LEVEL
 
 #define AWS_SHA256_HMAC_LEN 32
+#define AWS_SHA384_HMAC_LEN 48
+#define AWS_SHA512_HMAC_LEN 64
 
 struct aws_hmac;
 
@@ -21,6 +23,10 @@ struct aws_hmac_vtable {
     void (*destroy)(struct aws_hmac *hmac);
     int (*update)(struct aws_hmac *hmac, const struct aws_byte_cursor *buf);
     int (*finalize)(struct aws_hmac *hmac, struct aws_byte_buf *out);
+    int (*reset)(struct aws_hmac *hmac);
+    struct aws_hmac *(*duplicate)(struct aws_allocator *allocator, const struct aws_hmac *hmac);
+    /* optional, replaces the key and discards any pending digest without reallocating the hmac */
+    int (*rekey)(struct aws_hmac *hmac, const struct aws_byte_cursor *secret);
 };
 
 struct aws_hmac {
@@ -31,6 +37,13 @@ struct aws_hmac {
     void *impl;
 };
 
+/**
+ * An hmac key whose padded inner and outer states have been computed once, so that any number of
+ * ready to update hmac instances can be stamped out of it without hashing the key again.
+ * Read-only after creation, so it can be shared between threads.
+ */
+struct aws_hmac_key_template;
+
 typedef struct aws_hmac *(aws_hmac_new_fn)(struct aws_allocator *allocator, const struct aws_byte_cursor *secret);
 
 AWS_EXTERN_C_BEGIN
@@ -40,6 +53,18 @@ AWS_EXTERN_C_BEGIN
  */
 AWS_CAL_API struct aws_hmac *aws_sha256_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret);
 
+/**
+ * Allocates and initializes a sha384 hmac instance. Secret is the key to be
+ * used for the hmac process.
+ */
+AWS_CAL_API struct aws_hmac *aws_sha384_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret);
+
+/**
+ * Allocates and initializes a sha512 hmac instance. Secret is the key to be
+ * used for the hmac process.
+ */
+AWS_CAL_API struct aws_hmac *aws_sha512_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret);
+
 /**
  * Cleans up and deallocates hmac.
  */
@@ -58,6 +83,58 @@ AWS_CAL_API int aws_hmac_update(struct aws_hmac *hmac, const struct aws_byte_cur
  * to 0.
  */
 AWS_CAL_API int aws_hmac_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output, size_t truncate_to);
+
+/**
+ * Restores hmac to the state it had right after the key was applied, so it can compute another
+ * digest with the same key without being destroyed and rekeyed. This can be called after
+ * aws_hmac_finalize() or to discard a partially updated digest. Raises
+ * AWS_ERROR_UNSUPPORTED_OPERATION if the hmac implementation does not support being reset.
+ */
+AWS_CAL_API int aws_hmac_reset(struct aws_hmac *hmac);
+
+/**
+ * Allocates a new hmac instance holding a copy of hmac's key and running state, so a prefix hashed once
+ * can be finished with several different suffixes. The two instances are independent from then on and
+ * each is destroyed with aws_hmac_destroy(). Raises AWS_ERROR_INVALID_STATE if hmac has been finalized,
+ * and AWS_ERROR_UNSUPPORTED_OPERATION if the implementation can't be copied.
+ */
+AWS_CAL_API struct aws_hmac *aws_hmac_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac);
+
+/**
+ * Precomputes the sha256 hmac state for secret. Use aws_hmac_new_from_key_template() to create
+ * hmac instances from it. Returns NULL and raises AWS_ERROR_UNSUPPORTED_OPERATION if the hmac
+ * implementation can not be copied.
+ */
+AWS_CAL_API struct aws_hmac_key_template *aws_sha256_hmac_key_template_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret);
+
+/**
+ * Precomputes the sha384 hmac state for secret. Behaves like aws_sha256_hmac_key_template_new().
+ */
+AWS_CAL_API struct aws_hmac_key_template *aws_sha384_hmac_key_template_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret);
+
+/**
+ * Precomputes the sha512 hmac state for secret. Behaves like aws_sha256_hmac_key_template_new().
+ */
+AWS_CAL_API struct aws_hmac_key_template *aws_sha512_hmac_key_template_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret);
+
+/**
+ * Cleans up and deallocates key_template. Hmac instances created from it are unaffected.
+ */
+AWS_CAL_API void aws_hmac_key_template_destroy(struct aws_hmac_key_template *key_template);
+
+/**
+ * Allocates an hmac instance keyed from key_template, ready for aws_hmac_update(). This copies the
+ * precomputed state instead of hashing the key again. Destroy it with aws_hmac_destroy().
+ */
+AWS_CAL_API struct aws_hmac *aws_hmac_new_from_key_template(
+    struct aws_allocator *allocator,
+    const struct aws_hmac_key_template *key_template);
 /**
  * Computes the sha256 hmac over input and writes the digest output to 'output'.
  * Use this if you don't need to stream the data you're hashing and you can load
@@ -72,6 +149,71 @@ AWS_CAL_API int aws_sha256_hmac_compute(
     const struct aws_byte_cursor *to_hmac,
     struct aws_byte_buf *output,
     size_t truncate_to);
+
+/**
+ * Computes a chain of sha256 hmacs, as used to derive SigV4 signing keys. The first message is
+ * hmac'd with seed_secret, and the digest of every step is the key for the next one. Only the
+ * digest of the last message is written to output, the intermediate keys never leave the stack.
+ * A single hmac instance is rekeyed between steps when the implementation supports it.
+ * message_count must be at least 1. truncate_to applies to the final digest and behaves as it
+ * does for aws_sha256_hmac_compute().
+ */
+AWS_CAL_API int aws_sha256_hmac_chain_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *seed_secret,
+    const struct aws_byte_cursor *messages,
+    size_t message_count,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+/**
+ * Computes the sha384 hmac over input and writes the digest output to 'output'.
+ * Behaves like aws_sha256_hmac_compute(), including the truncate_to semantics.
+ */
+AWS_CAL_API int aws_sha384_hmac_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *to_hmac,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+
+/**
+ * Computes the sha512 hmac over input and writes the digest output to 'output'.
+ * Behaves like aws_sha256_hmac_compute(), including the truncate_to semantics.
+ */
+AWS_CAL_API int aws_sha512_hmac_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *to_hmac,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
+/**
+ * Derives length bytes of keying material from secret with HKDF (RFC 5869) over hmac-sha256 and
+ * appends them to output. salt and info may be NULL or empty. length can be at most
+ * 255 * AWS_SHA256_HMAC_LEN, and output must already have room for it: nothing is allocated and
+ * the intermediate pseudorandom key only ever lives on the stack. On failure output is left as it
+ * was, and any bytes that had already been derived into it are zeroed.
+ */
+AWS_CAL_API int aws_sha256_hkdf_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *salt,
+    const struct aws_byte_cursor *info,
+    struct aws_byte_buf *output,
+    size_t length);
+
+/**
+ * Derives keying material like aws_sha256_hkdf_compute(), but over hmac-sha384. length can be at
+ * most 255 * AWS_SHA384_HMAC_LEN.
+ */
+AWS_CAL_API int aws_sha384_hkdf_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *salt,
+    const struct aws_byte_cursor *info,
+    struct aws_byte_buf *output,
+    size_t length);
+
 /**
  * Set the implementation of sha256 hmac to use. If you compiled without
  * BYO_CRYPTO, you do not need to call this. However, if use this, we will
@@ -81,6 +223,24 @@ AWS_CAL_API int aws_sha256_hmac_compute(
  */
 AWS_CAL_API void aws_set_sha256_hmac_new_fn(aws_hmac_new_fn *fn);
 
+/**
+ * Set the implementation of sha384 hmac to use. If you compiled without
+ * BYO_CRYPTO, you do not need to call this. However, if use this, we will
+ * honor it, regardless of compile options. This may be useful for testing
+ * purposes. If you did set BYO_CRYPTO, and you do not call this function
+ * you will segfault.
+ */
+AWS_CAL_API void aws_set_sha384_hmac_new_fn(aws_hmac_new_fn *fn);
+
+/**
+ * Set the implementation of sha512 hmac to use. If you compiled without
+ * BYO_CRYPTO, you do not need to call this. However, if use this, we will
+ * honor it, regardless of compile options. This may be useful for testing
+ * purposes. If you did set BYO_CRYPTO, and you do not call this function
+ * you will segfault.
+ */
+AWS_CAL_API void aws_set_sha512_hmac_new_fn(aws_hmac_new_fn *fn);
+
 AWS_EXTERN_C_END
 AWS_POP_SANE_WARNING_LEVEL
 
@@ -0,0 +1,76 @@
+#ifndef AWS_C_CAL_BLAKE3_H
+#define AWS_C_CAL_BLAKE3_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/exports.h>
+
+#include <aws/common/common.h>
+
+#define AWS_BLAKE3_BLOCK_LEN 64
+#define AWS_BLAKE3_CHUNK_LEN 1024
+#define AWS_BLAKE3_OUT_LEN 32
+/* 2^54 chunks is the most a 64 bit byte count can describe, so the tree is never deeper than this */
+#define AWS_BLAKE3_MAX_DEPTH 54
+
+enum aws_blake3_flags {
+    AWS_BLAKE3_CHUNK_START = 1 << 0,
+    AWS_BLAKE3_CHUNK_END = 1 << 1,
+    AWS_BLAKE3_PARENT = 1 << 2,
+    AWS_BLAKE3_ROOT = 1 << 3,
+};
+
+/*
+ * Compresses 4 independent inputs of block_count consecutive 64 byte blocks each, writing 4 chaining values
+ * to out (32 bytes apiece, in input order). Input i uses counter + i when increment_counter is set, otherwise
+ * they all use counter. flags_start and flags_end are or'd into the first and last block's flags respectively.
+ */
+typedef void(aws_blake3_hash4_fn)(
+    const uint8_t *const *inputs,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    bool increment_counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t *out);
+
+extern const uint32_t g_aws_blake3_iv[8];
+extern const uint8_t g_aws_blake3_msg_schedule[7][16];
+
+AWS_EXTERN_C_BEGIN
+
+#if defined(AWS_CAL_BLAKE3_X86)
+/* Requires SSE4.1. See source/builtin/blake3_x86.c */
+void aws_blake3_hash4_x86(
+    const uint8_t *const *inputs,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    bool increment_counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t *out);
+#endif /* AWS_CAL_BLAKE3_X86 */
+
+#if defined(AWS_CAL_BLAKE3_ARM)
+/* NEON is part of the aarch64 baseline, so this needs no runtime check. See source/builtin/blake3_arm.c */
+void aws_blake3_hash4_arm(
+    const uint8_t *const *inputs,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    bool increment_counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t *out);
+#endif /* AWS_CAL_BLAKE3_ARM */
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_C_CAL_BLAKE3_H */
@@ -0,0 +1,64 @@
+#ifndef AWS_C_CAL_BUILTIN_SHA_H
+#define AWS_C_CAL_BUILTIN_SHA_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/exports.h>
+
+#include <aws/common/common.h>
+
+#define AWS_SHA_BLOCK_LEN 64
+
+/* Runs the compression function over block_count consecutive 64 byte blocks, updating state in place. */
+typedef void(aws_sha_compress_fn)(uint32_t *state, const uint8_t *blocks, size_t block_count);
+
+/* Runs block_count blocks of two independent messages through the sha256 compression function. */
+typedef void(aws_sha256_compress_x2_fn)(
+    uint32_t *state_a,
+    const uint8_t *blocks_a,
+    uint32_t *state_b,
+    const uint8_t *blocks_b,
+    size_t block_count);
+
+extern const uint32_t g_aws_sha256_k[64];
+
+/* Which compression functions the builtin sha1 and sha256 use. */
+enum aws_sha_builtin_impl {
+    /* the accelerated one when the cpu has the instructions for it, the portable one otherwise */
+    AWS_SHA_BUILTIN_IMPL_DETECT,
+    AWS_SHA_BUILTIN_IMPL_PORTABLE,
+    AWS_SHA_BUILTIN_IMPL_ACCELERATED,
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Selects the compression functions hashes created from now on use, so tests can cover each of them whatever the cpu
+ * would pick. Not thread safe. Raises AWS_ERROR_UNSUPPORTED_OPERATION for AWS_SHA_BUILTIN_IMPL_ACCELERATED when
+ * no accelerated implementation was built or the cpu lacks its instructions.
+ */
+AWS_CAL_API int aws_sha_builtin_force_impl(enum aws_sha_builtin_impl impl);
+
+#if defined(AWS_CAL_BUILTIN_SHA_X86)
+/* Requires SHA-NI, SSSE3 and SSE4.1. See source/builtin/builtin_sha_x86.c */
+void aws_sha1_compress_x86(uint32_t *state, const uint8_t *blocks, size_t block_count);
+void aws_sha256_compress_x86(uint32_t *state, const uint8_t *blocks, size_t block_count);
+void aws_sha256_compress_x2_x86(
+    uint32_t *state_a,
+    const uint8_t *blocks_a,
+    uint32_t *state_b,
+    const uint8_t *blocks_b,
+    size_t block_count);
+#endif /* AWS_CAL_BUILTIN_SHA_X86 */
+
+#if defined(AWS_CAL_BUILTIN_SHA_ARM)
+/* Requires the ARMv8 SHA1 and SHA2 crypto extensions. See source/builtin/builtin_sha_arm.c */
+void aws_sha1_compress_arm(uint32_t *state, const uint8_t *blocks, size_t block_count);
+void aws_sha256_compress_arm(uint32_t *state, const uint8_t *blocks, size_t block_count);
+#endif /* AWS_CAL_BUILTIN_SHA_ARM */
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_C_CAL_BUILTIN_SHA_H */
@@ -0,0 +1,20 @@
+#ifndef AWS_C_CAL_CPU_FEATURES_H
+#define AWS_C_CAL_CPU_FEATURES_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/runtime_info.h>
+
+AWS_EXTERN_C_BEGIN
+
+/*
+ * The crypto instructions available on this CPU, probed the first time it's called. Accelerated implementations pick
+ * themselves from this, so that aws_cal_get_runtime_info() reports what they actually dispatched on.
+ */
+const struct aws_cal_cpu_features *aws_cal_get_cpu_features(void);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_C_CAL_CPU_FEATURES_H */
@@ -45,6 +45,40 @@ enum aws_der_type {
     AWS_DER_FORM_PRIMITIVE = 0x00,
 };
 
+/* containers nested deeper than this are rejected as malformed, by both decoders */
+#define AWS_DER_DECODER_MAX_DEPTH 16
+/* most containers an aws_der_inplace_encoder can have open at once */
+#define AWS_DER_ENCODER_MAX_DEPTH 8
+
+/**
+ * Encoder that writes straight into a caller owned buffer in one pass, for small structures like signatures and
+ * public keys. Containers get a one byte length when they begin, which is patched when they end; only containers
+ * that outgrow 127 bytes have their contents moved over to make room for a longer length. It never allocates, so
+ * it's meant to live on the stack.
+ */
+struct aws_der_inplace_encoder {
+    struct aws_byte_buf *output;
+    /* offsets in output of the length byte of each open container */
+    size_t container_lengths[AWS_DER_ENCODER_MAX_DEPTH];
+    uint32_t depth;
+};
+
+/**
+ * Pull style decoder that reads one TLV at a time straight out of the input, only looking inside a container when
+ * asked to. It never allocates, so it's meant to live on the stack; the input must outlive it.
+ */
+struct aws_der_pull_decoder {
+    /* unread bytes of each open container, levels[0] is the whole input */
+    struct aws_byte_cursor levels[AWS_DER_DECODER_MAX_DEPTH];
+    uint32_t depth;
+    /* the TLV read by the last successful next() */
+    bool has_tlv;
+    uint8_t tag;
+    struct aws_byte_cursor value;
+    /* set when malformed input was found, every later next() fails */
+    int error_code;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /**
@@ -213,6 +247,190 @@ AWS_CAL_API int aws_der_decoder_tlv_boolean(struct aws_der_decoder *decoder, boo
  */
 AWS_CAL_API int aws_der_decoder_tlv_blob(struct aws_der_decoder *decoder, struct aws_byte_cursor *blob);
 
+/**
+ * Initializes an in place encoder that appends to output. Nothing is written until the first write or begin call.
+ * @param encoder The encoder to initialize
+ * @param output The buffer to append to, its capacity bounds what can be encoded
+ */
+AWS_CAL_API void aws_der_inplace_encoder_init(struct aws_der_inplace_encoder *encoder, struct aws_byte_buf *output);
+
+/**
+ * Writes an arbitrarily sized integer to the output
+ * @param encoder The encoder to use
+ * @param integer A cursor pointing to the integer's memory
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_write_integer(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor integer);
+
+/**
+ * Writes a boolean to the output
+ * @param encoder The encoder to use
+ * @param boolean The boolean to write
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_write_boolean(struct aws_der_inplace_encoder *encoder, bool boolean);
+
+/**
+ * Writes a NULL token to the output
+ * @param encoder The encoder to write to
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_write_null(struct aws_der_inplace_encoder *encoder);
+
+/**
+ * Writes a BIT_STRING to the output
+ * @param encoder The encoder to use
+ * @param bit_string The bit string to encode
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_write_bit_string(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor bit_string);
+
+/**
+ * Writes an OCTET_STRING to the output
+ * @param encoder The encoder to use
+ * @param octet_string The string to encode
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_write_octet_string(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor octet_string);
+
+/**
+ * Writes an OBJECT_IDENTIFIER to the output
+ * @param encoder The encoder to use
+ * @param oid The already encoded OID, without tag or length
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_write_object_identifier(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor oid);
+
+/**
+ * Begins a SEQUENCE of objects in the output
+ * @param encoder The encoder to use
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_begin_sequence(struct aws_der_inplace_encoder *encoder);
+
+/**
+ * Finishes a SEQUENCE, filling in its length
+ * @param encoder The encoder to update
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_end_sequence(struct aws_der_inplace_encoder *encoder);
+
+/**
+ * Begins a SET of objects in the output
+ * @param encoder The encoder to use
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_begin_set(struct aws_der_inplace_encoder *encoder);
+
+/**
+ * Finishes a SET, filling in its length
+ * @param encoder The encoder to update
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_end_set(struct aws_der_inplace_encoder *encoder);
+
+/**
+ * Checks that every container was ended, after which the output holds the complete encoding
+ * @param encoder The encoder to check
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_inplace_encoder_finish(struct aws_der_inplace_encoder *encoder);
+
+/**
+ * Initializes a pull decoder positioned before the first top level TLV of input
+ * @param decoder The decoder to initialize
+ * @param input The DER formatted buffer to parse
+ */
+AWS_CAL_API void aws_der_pull_decoder_init(struct aws_der_pull_decoder *decoder, struct aws_byte_cursor input);
+
+/**
+ * Reads the next TLV of the current container, skipping over the contents of the previous one
+ * @param decoder The decoder to advance
+ * @return true if there is a tlv to read after advancing, false at the end of the current container or if the input
+ * is malformed, in which case decoder->error_code is set and raised
+ */
+AWS_CAL_API bool aws_der_pull_decoder_next(struct aws_der_pull_decoder *decoder);
+
+/**
+ * Walks the whole input depth first, descending into every container and leaving them when they run out, which
+ * visits TLVs in the same order as aws_der_decoder_next()
+ * @param decoder The decoder to advance
+ * @return Same as aws_der_pull_decoder_next(), false once the input is exhausted
+ */
+AWS_CAL_API bool aws_der_pull_decoder_next_in_order(struct aws_der_pull_decoder *decoder);
+
+/**
+ * Makes the current TLV's elements the ones next() iterates over
+ * @param decoder The decoder, which must be on a SEQUENCE, SET or other constructed TLV
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_pull_decoder_enter(struct aws_der_pull_decoder *decoder);
+
+/**
+ * Skips whatever is left of the current container and goes back to iterating the one that holds it
+ * @param decoder The decoder, which must have entered a container
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_pull_decoder_exit(struct aws_der_pull_decoder *decoder);
+
+/**
+ * The type of the current TLV
+ * @param decoder The decoder to inspect
+ * @return The tag of the current TLV
+ */
+AWS_CAL_API enum aws_der_type aws_der_pull_decoder_tlv_type(const struct aws_der_pull_decoder *decoder);
+
+/**
+ * The size of the current TLV, after the same adjustments as aws_der_decoder_tlv_length()
+ * @param decoder The decoder to inspect
+ * @return The length of the current TLV's value
+ */
+AWS_CAL_API size_t aws_der_pull_decoder_tlv_length(const struct aws_der_pull_decoder *decoder);
+
+/**
+ * Extracts the current TLV string value (BIT_STRING, OCTET_STRING)
+ * @param decoder The decoder to extract from
+ * @param string The cursor to point at the string
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_pull_decoder_tlv_string(
+    const struct aws_der_pull_decoder *decoder,
+    struct aws_byte_cursor *string);
+
+/**
+ * Extracts the current TLV INTEGER value (INTEGER)
+ * @param decoder The decoder to extract from
+ * @param integer The cursor to point at the integer
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_pull_decoder_tlv_integer(
+    const struct aws_der_pull_decoder *decoder,
+    struct aws_byte_cursor *integer);
+
+/**
+ * Extracts the current TLV BOOLEAN value (BOOLEAN)
+ * @param decoder The decoder to extract from
+ * @param boolean The boolean to store the value into
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_pull_decoder_tlv_boolean(const struct aws_der_pull_decoder *decoder, bool *boolean);
+
+/**
+ * Extracts the current TLV value as a blob
+ * @param decoder The decoder to extract from
+ * @param blob The cursor to point at the value
+ * @return AWS_OP_ERR if an error occurs, otherwise AWS_OP_SUCCESS
+ */
+AWS_CAL_API int aws_der_pull_decoder_tlv_blob(const struct aws_der_pull_decoder *decoder, struct aws_byte_cursor *blob);
+
 AWS_EXTERN_C_END
 
 #endif
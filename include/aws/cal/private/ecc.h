@@ -20,6 +20,17 @@ AWS_CAL_API int aws_der_decoder_load_ecc_key_pair(
     struct aws_byte_cursor *out_private_d,
     enum aws_ecc_curve_name *out_curve_name);
 
+/*
+ * Same as aws_der_decoder_load_ecc_key_pair(), but reads encoded_keys in place without allocating a decoder. The
+ * cursors point into encoded_keys.
+ */
+AWS_CAL_API int aws_der_load_ecc_key_pair(
+    struct aws_byte_cursor encoded_keys,
+    struct aws_byte_cursor *out_public_x_coor,
+    struct aws_byte_cursor *out_public_y_coor,
+    struct aws_byte_cursor *out_private_d,
+    enum aws_ecc_curve_name *out_curve_name);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_C_CAL_PRIVATE_ECC_H */
@@ -0,0 +1,30 @@
+#ifndef AWS_C_CAL_FILE_WINDOW_H
+#define AWS_C_CAL_FILE_WINDOW_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/exports.h>
+
+#include <aws/common/byte_buf.h>
+
+/* Called with each consecutive window of a file. Returning AWS_OP_ERR stops the walk with that error raised. */
+typedef int(aws_cal_file_window_fn)(struct aws_byte_cursor window, void *user_data);
+
+AWS_EXTERN_C_BEGIN
+
+/*
+ * Hands the contents of the file at path to on_window, front to back, in windows that are mapped straight from the
+ * page cache where mmap is available and read into a single reused buffer where it isn't (or the file can't be
+ * mapped, e.g. a pipe). Windows are only valid for the duration of the callback. See source/file_window.c
+ */
+int aws_cal_file_for_each_window(
+    struct aws_allocator *allocator,
+    const char *path,
+    aws_cal_file_window_fn *on_window,
+    void *user_data);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_C_CAL_FILE_WINDOW_H */
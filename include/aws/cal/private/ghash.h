@@ -0,0 +1,51 @@
+#ifndef AWS_C_CAL_GHASH_H
+#define AWS_C_CAL_GHASH_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/exports.h>
+
+#include <aws/common/common.h>
+
+#define AWS_GHASH_BLOCK_LEN 16
+/* powers of H kept per key, the x86 kernel reduces once per this many blocks */
+#define AWS_GHASH_KEY_POWERS 4
+
+/*
+ * GHASH (NIST SP 800-38D) keyed with H = E(K, 0^128), for code that has to combine GCM pieces itself and so can't
+ * rely on a backend's tag. Blocks are big-endian, exactly as they appear in GCM.
+ */
+struct aws_ghash_key {
+    /* h_powers[i] is H^(i + 1) */
+    uint8_t h_powers[AWS_GHASH_KEY_POWERS][AWS_GHASH_BLOCK_LEN];
+};
+
+AWS_EXTERN_C_BEGIN
+
+void aws_ghash_key_init(struct aws_ghash_key *key, const uint8_t h[AWS_GHASH_BLOCK_LEN]);
+
+/*
+ * Folds data into the accumulator y: y = (y ^ X) * H for each block X of data in turn, a trailing partial block
+ * being zero padded. Starting from y = 0 this gives X_1 * H^n ^ ... ^ X_n * H. Runs in constant time with respect to
+ * H and y.
+ */
+void aws_ghash_update(
+    const struct aws_ghash_key *key,
+    uint8_t y[AWS_GHASH_BLOCK_LEN],
+    const uint8_t *data,
+    size_t len);
+
+#if defined(AWS_CAL_GHASH_X86)
+/* Requires PCLMULQDQ and SSE4.1. Whole blocks only. See source/builtin/ghash_x86.c */
+void aws_ghash_update_x86(
+    const struct aws_ghash_key *key,
+    uint8_t y[AWS_GHASH_BLOCK_LEN],
+    const uint8_t *blocks,
+    size_t block_count);
+#endif /* AWS_CAL_GHASH_X86 */
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_C_CAL_GHASH_H */
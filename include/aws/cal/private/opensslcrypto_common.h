@@ -1,6 +1,8 @@
 #ifndef AWS_C_CAL_OPENSSLCRYPTO_COMMON_H
 #define AWS_C_CAL_OPENSSLCRYPTO_COMMON_H
 
+#include <limits.h>
+
 #include <openssl/crypto.h>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
@@ -12,6 +14,7 @@ typedef void (*hmac_ctx_clean_up)(HMAC_CTX *);
 typedef int (*hmac_init_ex)(HMAC_CTX *, const void *, size_t, const EVP_MD *, ENGINE *);
 typedef int (*hmac_update)(HMAC_CTX *, const unsigned char *, size_t);
 typedef int (*hmac_final)(HMAC_CTX *, unsigned char *, unsigned int *);
+typedef int (*hmac_ctx_copy)(HMAC_CTX *, HMAC_CTX *);
 
 /* C standard does not have concept of generic function pointer, but it does
 guarantee that function pointer casts will roundtrip when casting to any type and
@@ -26,6 +29,7 @@ struct openssl_hmac_ctx_table {
     hmac_init_ex init_ex_fn;
     hmac_update update_fn;
     hmac_final final_fn;
+    hmac_ctx_copy copy_fn;
 
     /* There is slight variance between the crypto interfaces.
         Note that function pointer casting is undefined behavior.
@@ -34,6 +38,7 @@ struct openssl_hmac_ctx_table {
         Do not use following fields manually. */
     struct {
         crypto_generic_fn_ptr init_ex_fn;
+        crypto_generic_fn_ptr copy_fn;
     } impl;
 };
 
@@ -44,6 +49,8 @@ typedef void (*evp_md_ctx_free)(EVP_MD_CTX *);
 typedef int (*evp_md_ctx_digest_init_ex)(EVP_MD_CTX *, const EVP_MD *, ENGINE *);
 typedef int (*evp_md_ctx_digest_update)(EVP_MD_CTX *, const void *, size_t);
 typedef int (*evp_md_ctx_digest_final_ex)(EVP_MD_CTX *, unsigned char *, unsigned int *);
+typedef void *(*evp_md_ctx_md_data)(const EVP_MD_CTX *);
+typedef int (*evp_md_ctx_copy_ex)(EVP_MD_CTX *, const EVP_MD_CTX *);
 
 struct openssl_evp_md_ctx_table {
     evp_md_ctx_new new_fn;
@@ -51,8 +58,173 @@ struct openssl_evp_md_ctx_table {
     evp_md_ctx_digest_init_ex init_ex_fn;
     evp_md_ctx_digest_update update_fn;
     evp_md_ctx_digest_final_ex final_ex_fn;
+    evp_md_ctx_copy_ex copy_ex_fn;
+    /* optional, NULL for 1.0.2 where the context's digest state can't be reached through the 1.1.x headers */
+    evp_md_ctx_md_data md_data_fn;
 };
 
 extern struct openssl_evp_md_ctx_table *g_aws_openssl_evp_md_ctx_table;
 
+#if defined(AWS_CAL_DIRECT_LIBCRYPTO)
+/*
+ * Built with -DDIRECT_LIBCRYPTO=ON against the libcrypto that gets linked in, so call it directly instead of through
+ * the tables resolved at runtime. That leaves no indirect calls on the hash and HMAC paths for the compiler or LTO
+ * to trip over. Needs the HMAC_CTX_new() era API.
+ */
+#    if !defined(OPENSSL_IS_AWSLC) && !defined(OPENSSL_IS_BORINGSSL) && OPENSSL_VERSION_NUMBER < 0x10100000L
+#        error "DIRECT_LIBCRYPTO requires aws-lc, boringssl or libcrypto 1.1.0 or later"
+#    endif
+
+static inline void aws_openssl_ensure_libcrypto_resolved(void) {}
+
+static inline EVP_MD_CTX *aws_openssl_evp_md_ctx_new(void) {
+    return EVP_MD_CTX_new();
+}
+
+static inline void aws_openssl_evp_md_ctx_free(EVP_MD_CTX *ctx) {
+    EVP_MD_CTX_free(ctx);
+}
+
+static inline int aws_openssl_evp_digest_init_ex(EVP_MD_CTX *ctx, const EVP_MD *md, ENGINE *impl) {
+    return EVP_DigestInit_ex(ctx, md, impl);
+}
+
+static inline int aws_openssl_evp_digest_update(EVP_MD_CTX *ctx, const void *data, size_t len) {
+    return EVP_DigestUpdate(ctx, data, len);
+}
+
+static inline int aws_openssl_evp_digest_final_ex(EVP_MD_CTX *ctx, unsigned char *md, unsigned int *len) {
+    return EVP_DigestFinal_ex(ctx, md, len);
+}
+
+static inline int aws_openssl_evp_md_ctx_copy_ex(EVP_MD_CTX *out, const EVP_MD_CTX *in) {
+    return EVP_MD_CTX_copy_ex(out, in);
+}
+
+/* The digest's own context, e.g. a SHA256_CTX, or NULL if it lives in an OpenSSL 3.0 provider instead. */
+static inline void *aws_openssl_evp_md_ctx_md_data(const EVP_MD_CTX *ctx) {
+#    if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL)
+    return ctx->md_data;
+#    else
+    return EVP_MD_CTX_md_data(ctx);
+#    endif
+}
+
+static inline HMAC_CTX *aws_openssl_hmac_ctx_new(void) {
+    return HMAC_CTX_new();
+}
+
+static inline void aws_openssl_hmac_ctx_free(HMAC_CTX *ctx) {
+    HMAC_CTX_free(ctx);
+}
+
+static inline void aws_openssl_hmac_ctx_init(HMAC_CTX *ctx) {
+#    if defined(OPENSSL_IS_AWSLC)
+    HMAC_CTX_init(ctx);
+#    else
+    (void)ctx;
+#    endif
+}
+
+static inline int aws_openssl_hmac_init_ex(
+    HMAC_CTX *ctx,
+    const void *key,
+    size_t key_len,
+    const EVP_MD *md,
+    ENGINE *impl) {
+#    if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL)
+    return HMAC_Init_ex(ctx, key, key_len, md, impl);
+#    else
+    /* openssl takes the key length as an int */
+    if (key_len > INT_MAX) {
+        return 0;
+    }
+    return HMAC_Init_ex(ctx, key, (int)key_len, md, impl);
+#    endif
+}
+
+static inline int aws_openssl_hmac_update(HMAC_CTX *ctx, const unsigned char *data, size_t len) {
+    return HMAC_Update(ctx, data, len);
+}
+
+static inline int aws_openssl_hmac_final(HMAC_CTX *ctx, unsigned char *md, unsigned int *len) {
+    return HMAC_Final(ctx, md, len);
+}
+
+static inline int aws_openssl_hmac_ctx_copy(HMAC_CTX *dest, HMAC_CTX *src) {
+    return HMAC_CTX_copy(dest, src);
+}
+
+#else
+
+/* Resolves the tables above if aws_cal_library_init() was told to defer it. Call before using either table. */
+void aws_openssl_ensure_libcrypto_resolved(void);
+
+static inline EVP_MD_CTX *aws_openssl_evp_md_ctx_new(void) {
+    return g_aws_openssl_evp_md_ctx_table->new_fn();
+}
+
+static inline void aws_openssl_evp_md_ctx_free(EVP_MD_CTX *ctx) {
+    g_aws_openssl_evp_md_ctx_table->free_fn(ctx);
+}
+
+static inline int aws_openssl_evp_digest_init_ex(EVP_MD_CTX *ctx, const EVP_MD *md, ENGINE *impl) {
+    return g_aws_openssl_evp_md_ctx_table->init_ex_fn(ctx, md, impl);
+}
+
+static inline int aws_openssl_evp_digest_update(EVP_MD_CTX *ctx, const void *data, size_t len) {
+    return g_aws_openssl_evp_md_ctx_table->update_fn(ctx, data, len);
+}
+
+static inline int aws_openssl_evp_digest_final_ex(EVP_MD_CTX *ctx, unsigned char *md, unsigned int *len) {
+    return g_aws_openssl_evp_md_ctx_table->final_ex_fn(ctx, md, len);
+}
+
+static inline int aws_openssl_evp_md_ctx_copy_ex(EVP_MD_CTX *out, const EVP_MD_CTX *in) {
+    return g_aws_openssl_evp_md_ctx_table->copy_ex_fn(out, in);
+}
+
+/* The digest's own context, e.g. a SHA256_CTX, or NULL if it lives in an OpenSSL 3.0 provider instead. */
+static inline void *aws_openssl_evp_md_ctx_md_data(const EVP_MD_CTX *ctx) {
+    if (g_aws_openssl_evp_md_ctx_table->md_data_fn == NULL) {
+        return NULL;
+    }
+    return g_aws_openssl_evp_md_ctx_table->md_data_fn(ctx);
+}
+
+static inline HMAC_CTX *aws_openssl_hmac_ctx_new(void) {
+    return g_aws_openssl_hmac_ctx_table->new_fn();
+}
+
+static inline void aws_openssl_hmac_ctx_free(HMAC_CTX *ctx) {
+    g_aws_openssl_hmac_ctx_table->free_fn(ctx);
+}
+
+static inline void aws_openssl_hmac_ctx_init(HMAC_CTX *ctx) {
+    g_aws_openssl_hmac_ctx_table->init_fn(ctx);
+}
+
+static inline int aws_openssl_hmac_init_ex(
+    HMAC_CTX *ctx,
+    const void *key,
+    size_t key_len,
+    const EVP_MD *md,
+    ENGINE *impl) {
+    return g_aws_openssl_hmac_ctx_table->init_ex_fn(ctx, key, key_len, md, impl);
+}
+
+static inline int aws_openssl_hmac_update(HMAC_CTX *ctx, const unsigned char *data, size_t len) {
+    return g_aws_openssl_hmac_ctx_table->update_fn(ctx, data, len);
+}
+
+static inline int aws_openssl_hmac_final(HMAC_CTX *ctx, unsigned char *md, unsigned int *len) {
+    return g_aws_openssl_hmac_ctx_table->final_fn(ctx, md, len);
+}
+
+static inline int aws_openssl_hmac_ctx_copy(HMAC_CTX *dest, HMAC_CTX *src) {
+    return g_aws_openssl_hmac_ctx_table->copy_fn(dest, src);
+}
+
+#endif /* AWS_CAL_DIRECT_LIBCRYPTO */
+
 #endif /* AWS_C_CAL_OPENSSLCRYPTO_COMMON_H */
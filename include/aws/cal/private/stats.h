@@ -0,0 +1,88 @@
+#ifndef AWS_C_CAL_PRIVATE_STATS_H
+#define AWS_C_CAL_PRIVATE_STATS_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/cal/stats.h>
+
+/*
+ * The hooks the hash, hmac and cipher entry points call. Without AWS_CAL_STATS they expand to nothing, so the
+ * entry points compile to the plain vtable call.
+ *
+ *     AWS_CAL_STATS_BEGIN(stats);
+ *     int result = hash->vtable->update(hash, to_hash);
+ *     AWS_CAL_STATS_END(stats, hash->vtable, AWS_CAL_STATS_OP_UPDATE, to_hash->len, result);
+ */
+#ifdef AWS_CAL_STATS
+
+#    include <aws/common/atomics.h>
+#    include <aws/common/clock.h>
+
+struct aws_cal_stats_timer {
+    bool active;
+    uint64_t start_ns;
+};
+
+extern struct aws_atomic_var g_aws_cal_stats_enabled;
+
+static inline bool aws_cal_stats_active(void) {
+    return aws_atomic_load_int_explicit(&g_aws_cal_stats_enabled, aws_memory_order_relaxed) != 0;
+}
+
+static inline struct aws_cal_stats_timer aws_cal_stats_begin(void) {
+    struct aws_cal_stats_timer timer = {.active = aws_cal_stats_active()};
+    if (timer.active) {
+        aws_high_res_clock_get_ticks(&timer.start_ns);
+    }
+    return timer;
+}
+
+/* the bytes a vectored call is counted for */
+static inline size_t aws_cal_stats_segments_len(const struct aws_byte_cursor *segments, size_t segment_count) {
+    size_t len = 0;
+    for (size_t i = 0; i < segment_count; ++i) {
+        len += segments[i].len;
+    }
+    return len;
+}
+
+AWS_EXTERN_C_BEGIN
+
+/* timer is NULL for AWS_CAL_STATS_OP_NEW. result is the operation's AWS_OP_SUCCESS or AWS_OP_ERR. */
+void aws_cal_stats_record(
+    const struct aws_cal_stats_timer *timer,
+    const char *alg_name,
+    const char *provider,
+    enum aws_cal_stats_operation operation,
+    size_t bytes,
+    int result);
+
+AWS_EXTERN_C_END
+
+#    define AWS_CAL_STATS_BEGIN(timer) struct aws_cal_stats_timer timer = aws_cal_stats_begin()
+#    define AWS_CAL_STATS_END(timer, vtable, operation, bytes, result)                                                \
+        do {                                                                                                           \
+            if ((timer).active) {                                                                                      \
+                aws_cal_stats_record(                                                                                  \
+                    &(timer), (vtable)->alg_name, (vtable)->provider, (operation), (bytes), (result));                 \
+            }                                                                                                          \
+        } while (0)
+#    define AWS_CAL_STATS_NEW(instance)                                                                                \
+        do {                                                                                                           \
+            if ((instance) && aws_cal_stats_active()) {                                                                \
+                aws_cal_stats_record(                                                                                  \
+                    NULL, (instance)->vtable->alg_name, (instance)->vtable->provider, AWS_CAL_STATS_OP_NEW, 0, 0);     \
+            }                                                                                                          \
+        } while (0)
+
+#else
+
+#    define AWS_CAL_STATS_BEGIN(timer)
+#    define AWS_CAL_STATS_END(timer, vtable, operation, bytes, result)
+#    define AWS_CAL_STATS_NEW(instance)
+
+#endif /* AWS_CAL_STATS */
+
+#endif /* AWS_C_CAL_PRIVATE_STATS_H */
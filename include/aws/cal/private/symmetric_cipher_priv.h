@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/cal/symmetric_cipher.h>
+#include <aws/common/atomics.h>
 
 struct aws_symmetric_cipher;
 
@@ -20,6 +21,28 @@ struct aws_symmetric_cipher_vtable {
 
     int (*finalize_encryption)(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out);
     int (*finalize_decryption)(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out);
+
+    /* optional, process a chain of input segments in one call. The dispatch falls back to calling encrypt/decrypt
+       per segment when these are NULL. Segments have already been checked against the per call input limit. */
+    int (*encrypt_vectored)(
+        struct aws_symmetric_cipher *cipher,
+        const struct aws_byte_cursor *segments,
+        size_t segment_count,
+        struct aws_byte_buf *out);
+    int (*decrypt_vectored)(
+        struct aws_symmetric_cipher *cipher,
+        const struct aws_byte_cursor *segments,
+        size_t segment_count,
+        struct aws_byte_buf *out);
+
+    /* optional, CTR only. Restart the keystream at counter_block (AWS_AES_256_CIPHER_BLOCK_SIZE bytes) as if it had
+       been the IV, then throw away the first skip bytes of it (skip < AWS_AES_256_CIPHER_BLOCK_SIZE) so the next byte
+       processed in either direction is at the requested offset. Whatever state the cipher was in is discarded. */
+    int (*seek)(struct aws_symmetric_cipher *cipher, const uint8_t *counter_block, size_t skip);
+
+    /* optional, XTS only. Reset for another data unit with tweak (AWS_AES_256_CIPHER_BLOCK_SIZE bytes) as the iv,
+       without running the key schedule again. */
+    int (*reset_with_tweak)(struct aws_symmetric_cipher *cipher, const uint8_t *tweak);
 };
 
 struct aws_symmetric_cipher {
@@ -53,7 +76,113 @@ AWS_CAL_API void aws_symmetric_cipher_generate_key(size_t len_bytes, struct aws_
 
 AWS_EXTERN_C_END
 
-/* Don't let this one get exported as it should never be used outside of this library (including tests). */
+/* Shared by every cipher made from it. Everything but ref_count is immutable once aws_aes_256_prepared_key_new()
+ * returns, backends that build state lazily in impl must publish it atomically. */
+struct aws_aes_256_prepared_key {
+    struct aws_allocator *allocator;
+    struct aws_atomic_var ref_count;
+    struct aws_byte_buf key;
+    void *impl;
+};
+
+/* Backend hooks for aws_aes_256_prepared_key. init is called once key has been copied in and may set impl,
+ * clean_up is called right before the key is destroyed. */
+int aws_aes_256_prepared_key_init_impl(struct aws_aes_256_prepared_key *prepared_key);
+void aws_aes_256_prepared_key_clean_up_impl(struct aws_aes_256_prepared_key *prepared_key);
+
+/* Backend constructors behind the aws_aes_*_256_new_from_prepared_key() functions. Arguments have already been
+ * validated. The caller may release prepared_key right after, so a cipher that keeps using it must hold a reference. */
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv);
+
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv);
+
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key);
+
+/* The one-shot GCM paths behind aws_aes_256_gcm_seal() and aws_aes_256_gcm_open(). symmetric_cipher.c has already
+ * validated the key, nonce and sizes, aad is NULL when there is none, and out is an empty fixed span with exactly
+ * enough room: plaintext.len + AWS_AES_256_GCM_TAG_LEN for seal, ciphertext.len for open. A tag mismatch fails with
+ * AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED. */
+typedef int(aws_aes_256_gcm_seal_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out);
+
+typedef int(aws_aes_256_gcm_open_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out);
+
+/* Generic versions built on an aws_symmetric_cipher from the current aws_aes_gcm_256_new_fn. Used whenever that has
+ * been overridden, and by backends with no cheaper one-shot primitive. */
+int aws_aes_256_gcm_seal_with_cipher(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out);
+
+int aws_aes_256_gcm_open_with_cipher(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out);
+
+/* The batch paths behind aws_aes_256_wrap_keys() and aws_aes_256_unwrap_keys(). symmetric_cipher.c has already
+ * validated every input length and made room in every output, so outputs[i] has inputs[i].len + 8 (wrap) or
+ * inputs[i].len - 8 (unwrap) bytes of unused capacity. Results are written there, and every output's len is only
+ * advanced once the whole batch has succeeded. A failed integrity check fails with
+ * AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED. */
+typedef int(aws_aes_256_keywrap_batch_fn)(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap);
+
+/* Generic version that runs each key through one keywrap cipher, reset in between. Used whenever
+ * aws_set_aes_keywrap_256_new_fn() has been used, and by backends with no cheaper batch primitive. */
+int aws_aes_256_keywrap_batch_with_cipher(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap);
+
+/* Adds blocks to an AES-CTR counter block. The whole block is the counter, one big-endian number that wraps modulo
+ * 2^128, which is how the libcrypto and CommonCrypto CTR ciphers advance it and so how every backend does. */
+void aws_aes_ctr_counter_block_add(uint8_t counter_block[AWS_AES_256_CIPHER_BLOCK_SIZE], uint64_t blocks);
+
+/* Don't let this one get exported as it should never be used outside of this library (including tests).
+ * Grows buf by at least size bytes if there isn't already enough room. Buffers without an allocator
+ * (fixed spans, see aws_symmetric_cipher_encrypt_into()) are never grown and fail with AWS_ERROR_SHORT_BUFFER. */
 int aws_symmetric_cipher_try_ensure_sufficient_buffer_space(struct aws_byte_buf *buf, size_t size);
 
 #endif /* AWS_CAL_SYMMETRIC_CIPHER_PRIV_H */
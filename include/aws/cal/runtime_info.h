@@ -0,0 +1,73 @@
+#ifndef AWS_CAL_RUNTIME_INFO_H
+#define AWS_CAL_RUNTIME_INFO_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/exports.h>
+
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+/* room for every algorithm the library offers. */
+#define AWS_CAL_RUNTIME_INFO_MAX_ALGORITHMS 32
+
+/* The crypto instructions the running CPU, and operating system, make available. */
+struct aws_cal_cpu_features {
+    /* x86 */
+    bool aes_ni;
+    bool pclmulqdq;
+    bool avx2;
+    /* along with the SSSE3 and SSE4.1 that go with it */
+    bool sha_ni;
+
+    /* arm64 crypto extensions: the AES instructions along with PMULL, and the SHA1 and SHA256 instructions */
+    bool armv8_aes;
+    bool armv8_sha;
+};
+
+struct aws_cal_algorithm_info {
+    const char *alg_name;
+    /* the provider an instance created now would use, NULL if the algorithm isn't available. */
+    const char *provider;
+};
+
+struct aws_cal_runtime_info {
+    /*
+     * The libcrypto API in use: "1.0.2", "1.1.1", "aws-lc" or "boringssl". This is the API family, not a release, so
+     * OpenSSL 3.x, which keeps the 1.1.1 API, shows up as "1.1.1". NULL on platforms that don't use libcrypto.
+     */
+    const char *libcrypto_version;
+    /* the running libcrypto's own version string, e.g. "OpenSSL 3.0.13 30 Jan 2024". NULL if it has none. */
+    const char *libcrypto_version_string;
+    /* the shared library libcrypto was loaded from, NULL when it's linked into the process. */
+    const char *libcrypto_library;
+    /* see aws_cal_library_options.libcrypto_allocator */
+    bool libcrypto_allocations_routed;
+
+    struct aws_cal_cpu_features cpu_features;
+
+    size_t algorithm_count;
+    struct aws_cal_algorithm_info algorithms[AWS_CAL_RUNTIME_INFO_MAX_ALGORITHMS];
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Reports which libcrypto was resolved, which provider serves each hash, HMAC and cipher, and which crypto
+ * instructions the CPU has, so you can confirm a host is on the fast path. Call it after aws_cal_library_init(). It
+ * creates and destroys an instance of every algorithm to find its provider, so it belongs at start up or in a
+ * diagnostic, not on a hot path, and those instances show up in aws_cal_stats. Every string is static.
+ */
+AWS_CAL_API void aws_cal_get_runtime_info(struct aws_allocator *allocator, struct aws_cal_runtime_info *info);
+
+/**
+ * Logs the same report at INFO level.
+ */
+AWS_CAL_API void aws_cal_log_runtime_info(struct aws_allocator *allocator);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_CAL_RUNTIME_INFO_H */
@@ -0,0 +1,91 @@
+#ifndef AWS_CAL_STATS_H
+#define AWS_CAL_STATS_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/exports.h>
+
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+/* the most distinct algorithm and provider pairs that are counted, and so the most a snapshot returns. */
+#define AWS_CAL_STATS_MAX_ENTRIES 64
+
+enum aws_cal_stats_operation {
+    /* a hash, hmac or cipher instance was created */
+    AWS_CAL_STATS_OP_NEW,
+    AWS_CAL_STATS_OP_UPDATE,
+    AWS_CAL_STATS_OP_FINALIZE,
+    AWS_CAL_STATS_OP_ENCRYPT,
+    AWS_CAL_STATS_OP_DECRYPT,
+};
+
+/* Describes a single operation. alg_name and provider come from the instance's vtable and are static strings. */
+struct aws_cal_stats_event {
+    enum aws_cal_stats_operation operation;
+    const char *alg_name;
+    const char *provider;
+    size_t bytes;
+    /* 0 for AWS_CAL_STATS_OP_NEW, which isn't timed. */
+    uint64_t duration_ns;
+    /* 0 if the operation succeeded. */
+    int error_code;
+};
+
+/* Called on the thread that performed the operation, right after it returns. */
+typedef void(aws_cal_stats_event_fn)(const struct aws_cal_stats_event *event, void *user_data);
+
+struct aws_cal_stats_options {
+    /* Optional. Invoked for every operation, for tracing. Keep it cheap, it runs on the hot path. */
+    aws_cal_stats_event_fn *on_event;
+    void *user_data;
+};
+
+/* Totals for one algorithm and provider pair, summed over every thread. */
+struct aws_cal_stats_entry {
+    const char *alg_name;
+    const char *provider;
+    /* every update, finalize, encrypt and decrypt call */
+    uint64_t operations;
+    /* input bytes passed to update, encrypt and decrypt */
+    uint64_t bytes;
+    /* instances created */
+    uint64_t allocations;
+    uint64_t duration_ns;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Starts counting hash, hmac and cipher operations. Each thread counts into its own atomic counters, so threads never
+ * contend, and aws_cal_stats_snapshot() sums them. While counting, the one-shot hash functions go through a hash
+ * instance rather than a single platform call, so that they're attributed to a provider. options may be NULL, and
+ * replaces any previous callback. Counting is only compiled in when the library is configured with -DCAL_STATS=ON,
+ * which otherwise leaves nothing on the hot path; without it this raises AWS_ERROR_UNSUPPORTED_OPERATION.
+ */
+AWS_CAL_API int aws_cal_stats_enable(const struct aws_cal_stats_options *options);
+
+/**
+ * Stops counting. The totals so far are kept. Operations already in flight on other threads may still invoke the
+ * callback, so keep its user_data alive until they're done.
+ */
+AWS_CAL_API void aws_cal_stats_disable(void);
+
+/**
+ * Writes the totals for up to capacity algorithm and provider pairs to entries and returns how many were written.
+ * A capacity of AWS_CAL_STATS_MAX_ENTRIES is always enough. Counters still being updated by other threads are read
+ * as they are at that moment.
+ */
+AWS_CAL_API size_t aws_cal_stats_snapshot(struct aws_cal_stats_entry *entries, size_t capacity);
+
+/**
+ * Zeroes every counter.
+ */
+AWS_CAL_API void aws_cal_stats_reset(void);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_CAL_STATS_H */
@@ -12,8 +12,16 @@ AWS_PUSH_SANE_WARNING_LEVEL
 #define AWS_AES_256_CIPHER_BLOCK_SIZE 16
 #define AWS_AES_256_KEY_BIT_LEN 256
 #define AWS_AES_256_KEY_BYTE_LEN (AWS_AES_256_KEY_BIT_LEN / 8)
+#define AWS_AES_256_GCM_NONCE_LEN 12
+#define AWS_AES_256_GCM_TAG_LEN 16
+/* XTS takes two AES-256 keys, the data key followed by the tweak key. */
+#define AWS_AES_256_XTS_KEY_BYTE_LEN (2 * AWS_AES_256_KEY_BYTE_LEN)
+#define AWS_CHACHA20_POLY1305_KEY_BYTE_LEN 32
+#define AWS_CHACHA20_POLY1305_NONCE_LEN 12
+#define AWS_CHACHA20_POLY1305_TAG_LEN 16
 
 struct aws_symmetric_cipher;
+struct aws_aes_256_prepared_key;
 
 typedef struct aws_symmetric_cipher *(aws_aes_cbc_256_new_fn)(
     struct aws_allocator *allocator,
@@ -35,6 +43,45 @@ typedef struct aws_symmetric_cipher *(aws_aes_gcm_256_new_fn)(
 typedef struct aws_symmetric_cipher *(
     aws_aes_keywrap_256_new_fn)(struct aws_allocator *allocator, const struct aws_byte_cursor *key);
 
+typedef struct aws_symmetric_cipher *(aws_aes_xts_256_new_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak);
+
+typedef struct aws_symmetric_cipher *(aws_aes_gcm_siv_256_new_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+typedef struct aws_symmetric_cipher *(aws_chacha20_poly1305_new_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+/**
+ * Runs task_fn(task_args[i]) for every i in [0, task_count) and returns once all of them have completed. The
+ * tasks don't depend on each other, so they may run concurrently on as many threads as the implementation likes.
+ */
+typedef void(aws_symmetric_cipher_run_tasks_fn)(
+    void (*task_fn)(void *task_arg),
+    void **task_args,
+    size_t task_count,
+    void *user_data);
+
+struct aws_aes_256_parallel_options {
+    /* Required. Typically hands the tasks to a thread pool owned by the caller. */
+    aws_symmetric_cipher_run_tasks_fn *run_tasks;
+    void *user_data;
+    /* How much input each task gets, rounded down to a multiple of the block size. 0 means 1MB. */
+    size_t task_len;
+    /* Inputs shorter than this are processed on the calling thread. 0 means 4MB. */
+    size_t min_parallel_len;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /**
@@ -119,6 +166,264 @@ AWS_CAL_API struct aws_symmetric_cipher *aws_aes_keywrap_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key);
 
+/**
+ * Creates an instance of AES XTS with two 256-bit keys (AWS_AES_256_XTS_KEY_BYTE_LEN bytes, the data key followed by
+ * the tweak key, which must differ) and a 16 byte tweak, usually the little-endian sector number.
+ * If key and tweak are NULL, they will be generated internally. You can get them back by calling:
+ *
+ * aws_symmetric_cipher_get_key() and
+ * aws_symmetric_cipher_get_initialization_vector()
+ *
+ * respectively.
+ *
+ * Each cipher encrypts or decrypts one data unit (e.g. a sector) of at least AWS_AES_256_CIPHER_BLOCK_SIZE bytes.
+ * Like keywrap, input is held until finalize, which writes the whole data unit. Move on to the next data unit with
+ * aws_symmetric_cipher_reset_with_tweak(), which keeps the key schedule.
+ *
+ * Returns NULL on failure. You can check aws_last_error() to get the error code indicating the failure cause.
+ * AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM is raised where the platform has no XTS, which is currently everywhere but
+ * libcrypto.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_aes_xts_256_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak);
+
+/**
+ * Creates an instance of AES GCM-SIV (RFC 8452) with 256-bit key. Materials are the same as for aws_aes_gcm_256_new():
+ * a 12 byte iv, an optional aad and, for decryption, the tag. Reusing an iv only reveals whether two messages were
+ * identical.
+ *
+ * The tag is computed over the whole plaintext before any of it is encrypted, so input is held until finalize, which
+ * writes all of the output. The tag for an encryption is then available from aws_symmetric_cipher_get_tag(). A
+ * decryption only writes plaintext once the tag has been verified.
+ *
+ * Returns NULL on failure. You can check aws_last_error() to get the error code indicating the failure cause.
+ * AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM is raised where the platform has no GCM-SIV, which is currently everywhere but
+ * AWS-LC and BoringSSL.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+/**
+ * Creates an instance of ChaCha20-Poly1305 (RFC 8439) with an AWS_CHACHA20_POLY1305_KEY_BYTE_LEN byte key and an
+ * AWS_CHACHA20_POLY1305_NONCE_LEN byte iv. It is used exactly like aws_aes_gcm_256_new(): key and iv are generated
+ * if NULL, aad is applied before any data and decryption_tag, if set, must be AWS_CHACHA20_POLY1305_TAG_LEN bytes.
+ * Input is processed as it arrives and the tag for an encryption is available from aws_symmetric_cipher_get_tag()
+ * after finalize.
+ *
+ * Without hardware AES (see aws_symmetric_cipher_has_hardware_aes()) this is typically several times faster than
+ * AES-GCM, and unlike table based AES it is constant time in software.
+ *
+ * Returns NULL on failure. You can check aws_last_error() to get the error code indicating the failure cause.
+ * AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM is raised where the platform has no ChaCha20-Poly1305, which is currently
+ * everywhere but OpenSSL 1.1.0+ and AWS-LC.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_chacha20_poly1305_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+/**
+ * Returns true if this cpu has AES instructions, along with the carry-less multiply GCM needs (AES-NI and PCLMULQDQ
+ * on x86, the ARMv8 crypto extensions on arm). When it returns false, AES and especially AES-GCM fall back to much
+ * slower software and aws_chacha20_poly1305_new() is usually the better AEAD for this host.
+ */
+AWS_CAL_API bool aws_symmetric_cipher_has_hardware_aes(void);
+
+/**
+ * Set the implementation used by the matching aws_aes_*_256_new() or aws_chacha20_poly1305_new() function. If you
+ * compiled without BYO_CRYPTO, you do not need to call these. However, if you use them, we will honor it, regardless
+ * of compile options. This may be useful for testing purposes, or to plug in a mode your platform doesn't provide. If
+ * you did set BYO_CRYPTO, and you do not call the one for a mode you use, you will abort.
+ */
+AWS_CAL_API void aws_set_aes_cbc_256_new_fn(aws_aes_cbc_256_new_fn *fn);
+AWS_CAL_API void aws_set_aes_ctr_256_new_fn(aws_aes_ctr_256_new_fn *fn);
+AWS_CAL_API void aws_set_aes_gcm_256_new_fn(aws_aes_gcm_256_new_fn *fn);
+AWS_CAL_API void aws_set_aes_keywrap_256_new_fn(aws_aes_keywrap_256_new_fn *fn);
+AWS_CAL_API void aws_set_aes_xts_256_new_fn(aws_aes_xts_256_new_fn *fn);
+AWS_CAL_API void aws_set_aes_gcm_siv_256_new_fn(aws_aes_gcm_siv_256_new_fn *fn);
+AWS_CAL_API void aws_set_chacha20_poly1305_new_fn(aws_chacha20_poly1305_new_fn *fn);
+
+/**
+ * Creates an immutable, reference counted AES-256 key that any number of CBC, CTR, GCM and keywrap ciphers can be
+ * created from, see aws_aes_cbc_256_new_from_prepared_key() and friends. key must be AWS_AES_256_KEY_BYTE_LEN bytes
+ * and is copied. The expensive per key setup (the key schedule, or an imported key handle on Windows) is done at most
+ * once per mode and direction for the life of the prepared key, instead of once per cipher.
+ *
+ * A prepared key may be shared across threads; each cipher made from it is still only usable from one thread at a
+ * time. The returned key has a ref count of one. Returns NULL on failure.
+ */
+AWS_CAL_API struct aws_aes_256_prepared_key *aws_aes_256_prepared_key_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key);
+
+/**
+ * Adds one to a prepared key's ref count.
+ */
+AWS_CAL_API void aws_aes_256_prepared_key_acquire(struct aws_aes_256_prepared_key *prepared_key);
+
+/**
+ * Subtracts one from a prepared key's ref count. If ref count reaches zero, the key is destroyed.
+ * Ciphers made from the key hold their own reference, so it's fine to release it while they're still in use.
+ */
+AWS_CAL_API void aws_aes_256_prepared_key_release(struct aws_aes_256_prepared_key *prepared_key);
+
+/**
+ * Same as aws_aes_cbc_256_new(), but keyed from prepared_key rather than a raw key. iv follows the same rules and
+ * aws_symmetric_cipher_get_key() returns the prepared key's bytes.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv);
+
+/**
+ * Same as aws_aes_ctr_256_new(), but keyed from prepared_key rather than a raw key.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv);
+
+/**
+ * Same as aws_aes_gcm_256_new(), but keyed from prepared_key rather than a raw key. iv, aad and decryption_tag
+ * belong to the cipher, not the key.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+/**
+ * Same as aws_aes_keywrap_256_new(), but with prepared_key as the key encryption key.
+ */
+AWS_CAL_API struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key);
+
+/**
+ * Encrypts or decrypts (they're the same operation) input with AES-256-CTR in a single call, splitting it into
+ * options->task_len pieces that are each started at their own counter offset and handed to options->run_tasks.
+ * The output is identical to a CTR cipher created with prepared_key and iv.
+ *
+ * iv is the AWS_AES_256_CIPHER_BLOCK_SIZE byte initial counter block, advanced as one 128 bit big-endian number the
+ * way the CTR cipher advances it (see aws_symmetric_cipher_seek()). input.len bytes are written into the unused
+ * capacity of out, which follows the same fixed span and in place rules as aws_aes_256_gcm_seal().
+ */
+AWS_CAL_API int aws_aes_256_ctr_crypt_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options);
+
+/**
+ * Same output as aws_aes_256_gcm_seal(), but the counter mode encryption and the GHASH of each piece run in
+ * options->run_tasks, and the partial GHASH values are combined on the calling thread. Unlike
+ * aws_aes_256_gcm_seal(), plaintext is only limited by what GCM itself allows (2^32 - 2 blocks) since each piece
+ * is processed separately.
+ */
+AWS_CAL_API int aws_aes_256_gcm_seal_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options);
+
+/**
+ * The inverse of aws_aes_256_gcm_seal_parallel(), with the same results and failure behavior as
+ * aws_aes_256_gcm_open(). Pieces are decrypted before the tag can be checked, so on any failure whatever was written
+ * to out's unused capacity is zeroed.
+ */
+AWS_CAL_API int aws_aes_256_gcm_open_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext_and_tag,
+    struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options);
+
+/**
+ * Encrypts plaintext with AES-256-GCM in a single call and writes ciphertext||tag (plaintext.len +
+ * AWS_AES_256_GCM_TAG_LEN bytes) into the unused capacity of out, then advances out->len.
+ *
+ * key must be AWS_AES_256_KEY_BYTE_LEN bytes and nonce AWS_AES_256_GCM_NONCE_LEN bytes. aad may be NULL.
+ * out is treated as a fixed span and is never grown; if it doesn't have room, this fails with AWS_ERROR_SHORT_BUFFER
+ * and writes nothing. plaintext may sit exactly at out->buffer + out->len to encrypt in place; any other overlap is
+ * rejected.
+ *
+ * No cipher object is created unless aws_set_aes_gcm_256_new_fn() has been used to override the default. With
+ * libcrypto a cipher context is cached per thread, call aws_cal_thread_clean_up() before the thread exits to release
+ * it. allocator is only used on the paths that do need a cipher object.
+ */
+AWS_CAL_API int aws_aes_256_gcm_seal(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out);
+
+/**
+ * The inverse of aws_aes_256_gcm_seal(). ciphertext_and_tag is ciphertext with the AWS_AES_256_GCM_TAG_LEN byte tag
+ * on the end. On success, ciphertext_and_tag.len - AWS_AES_256_GCM_TAG_LEN bytes of plaintext are written into the
+ * unused capacity of out and out->len is advanced.
+ *
+ * If the tag doesn't match, this fails with AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED and whatever was written to
+ * out's unused capacity is zeroed, so unauthenticated plaintext is never released. The sizing, in place and caching
+ * rules are the same as aws_aes_256_gcm_seal().
+ */
+AWS_CAL_API int aws_aes_256_gcm_open(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext_and_tag,
+    struct aws_byte_buf *out);
+
+/**
+ * Wraps each of the key_count keys with AES Keywrap (RFC 3394) under prepared_key, the key encryption key, and
+ * appends the result, keys[i].len + 8 bytes, to outputs[i]. Each result is the same as from a keywrap cipher made with
+ * aws_aes_keywrap_256_new_from_prepared_key(). Keys must be a multiple of 8 bytes and at least 16, but may otherwise
+ * differ in length; runs of equal length keys are processed together, so the per block work of many keys is handed
+ * to libcrypto in one call.
+ *
+ * outputs follow the usual growth rules: buffers with an allocator grow as needed, fixed spans fail with
+ * AWS_ERROR_SHORT_BUFFER. keys must not overlap outputs. On failure no output's len changes.
+ */
+AWS_CAL_API int aws_aes_256_wrap_keys(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *keys,
+    struct aws_byte_buf *outputs,
+    size_t key_count);
+
+/**
+ * The inverse of aws_aes_256_wrap_keys(): unwraps each of wrapped_keys (at least 24 bytes, a multiple of 8) and
+ * appends the key, wrapped_keys[i].len - 8 bytes, to outputs[i]. If any of them fails the integrity check the whole
+ * call fails with AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED, and whatever was written to the outputs' unused capacity
+ * is zeroed.
+ */
+AWS_CAL_API int aws_aes_256_unwrap_keys(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *wrapped_keys,
+    struct aws_byte_buf *outputs,
+    size_t key_count);
+
 /**
  * Cleans up internal resources and state for cipher and then deallocates it.
  */
@@ -154,6 +459,59 @@ AWS_CAL_API int aws_symmetric_cipher_decrypt(
     struct aws_byte_cursor to_decrypt,
     struct aws_byte_buf *out);
 
+/**
+ * Encrypts each of the segment_count cursors in segments, in order, as if they were one contiguous input, and writes
+ * the encrypted data into out. The output is identical to calling aws_symmetric_cipher_encrypt() once per segment,
+ * but backends that can will take the whole chain in a single call, growing out at most once. Buffer sizing is the
+ * same as for aws_symmetric_cipher_encrypt() using the sum of the segment lengths.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_encrypt_vectored(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out);
+
+/**
+ * Decrypts each of the segment_count cursors in segments, in order, as if they were one contiguous input, and writes
+ * the decrypted data into out. See aws_symmetric_cipher_encrypt_vectored().
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_decrypt_vectored(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out);
+
+/**
+ * Encrypts the contents of the file at path as if it had been passed to aws_symmetric_cipher_encrypt() in one piece,
+ * and writes the encrypted data into out, which is sized the same way. Where mmap is available the file is mapped in
+ * large windows that go straight to the cipher, otherwise it's read through a single buffer. The file must not be
+ * truncated while it's being read. Finalization is left to the caller, so more data may follow.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_encrypt_file(
+    struct aws_symmetric_cipher *cipher,
+    const char *path,
+    struct aws_byte_buf *out);
+
+/**
+ * Decrypts the contents of the file at path into out. See aws_symmetric_cipher_encrypt_file().
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_decrypt_file(
+    struct aws_symmetric_cipher *cipher,
+    const char *path,
+    struct aws_byte_buf *out);
+
 /**
  * Encrypts any remaining data that was reserved for final padding, loads GMACs etc... and if there is any
  * writes any remaining encrypted data to out. If out is dynamic it will be expanded. If it is not, and
@@ -184,6 +542,63 @@ AWS_CAL_API int aws_symmetric_cipher_finalize_encryption(struct aws_symmetric_ci
  */
 AWS_CAL_API int aws_symmetric_cipher_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out);
 
+/**
+ * Same as aws_symmetric_cipher_encrypt(), except out is treated as a fixed span: the output is written to
+ * out->buffer + out->len and out is never grown, even if it is dynamic. If the unused capacity of out is too small
+ * the call fails with AWS_ERROR_SHORT_BUFFER and nothing is consumed.
+ *
+ * to_encrypt may be exactly the unused region of out (to_encrypt.ptr == out->buffer + out->len) to encrypt in place.
+ * Any other overlap between the two fails with AWS_ERROR_INVALID_ARGUMENT. In place is only meaningful for the
+ * stream modes (CTR and GCM) where every byte consumed produces exactly one byte of output; CBC and keywrap hold back
+ * data internally, so use a separate output for those.
+ *
+ * For CTR, to_encrypt.len bytes of space are always enough. The same goes for GCM with the libcrypto and CommonCrypto
+ * backends; with CNG, GCM carries a partial block between calls, so leave up to one extra BLOCK of room unless every
+ * call is a multiple of the block size. CBC always needs to_encrypt.len + one BLOCK.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_encrypt_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor to_encrypt,
+    struct aws_byte_buf *out);
+
+/**
+ * Same as aws_symmetric_cipher_decrypt(), except out is treated as a fixed span and never grown. See
+ * aws_symmetric_cipher_encrypt_into() for the sizing and in place rules, they are the same for decryption.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_decrypt_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor to_decrypt,
+    struct aws_byte_buf *out);
+
+/**
+ * Same as aws_symmetric_cipher_finalize_encryption(), except out is treated as a fixed span and never grown.
+ * For CTR, and for GCM on libcrypto and CommonCrypto, this writes nothing, so an empty span is fine. CBC, and GCM on
+ * CNG, may write up to one BLOCK.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_finalize_encryption_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out);
+
+/**
+ * Same as aws_symmetric_cipher_finalize_decryption(), except out is treated as a fixed span and never grown.
+ * Sizing is the same as for aws_symmetric_cipher_finalize_encryption_into().
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_finalize_decryption_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out);
+
 /**
  * Resets the cipher state for starting a new encrypt or decrypt operation. Note encrypt/decrypt cannot be mixed on the
  * same cipher without a call to reset in between them. However, this leaves the key, iv etc... materials setup for
@@ -194,6 +609,35 @@ AWS_CAL_API int aws_symmetric_cipher_finalize_decryption(struct aws_symmetric_ci
  */
 AWS_CAL_API int aws_symmetric_cipher_reset(struct aws_symmetric_cipher *cipher);
 
+/**
+ * AES-CTR only. Resets the cipher and moves it to offset bytes into the keystream that starts at its IV, so the next
+ * encrypt or decrypt call processes the data at that offset of the stream, e.g. the start of a range read. The
+ * counter block is computed directly so this costs the same at any offset, and offset need not be block aligned.
+ *
+ * The whole IV is the counter, one 128 bit big-endian number, the same as the CTR cipher advances it on every
+ * backend, so a counter in the last bytes carries into the bytes before it. Ciphers other than AES-CTR fail with
+ * AWS_ERROR_UNSUPPORTED_OPERATION.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_seek(struct aws_symmetric_cipher *cipher, uint64_t offset);
+
+/**
+ * AES-XTS only. Resets the cipher and sets tweak, AWS_AES_256_CIPHER_BLOCK_SIZE bytes, for the next data unit, so one
+ * cipher can work through sector after sector without allocating or re-keying. The new tweak is what
+ * aws_symmetric_cipher_get_initialization_vector() returns from then on.
+ *
+ * A tweak of the wrong size raises AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM. Ciphers other than
+ * AES-XTS fail with AWS_ERROR_UNSUPPORTED_OPERATION.
+ *
+ * returns AWS_OP_SUCCESS on success. Call aws_last_error() to determine the failure cause if it returns
+ * AWS_OP_ERR;
+ */
+AWS_CAL_API int aws_symmetric_cipher_reset_with_tweak(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor tweak);
+
 /**
  * Gets the current GMAC tag. If not AES GCM, this function will just return an empty cursor.
  * The memory in this cursor is unsafe as it refers to the internal buffer.
@@ -0,0 +1,466 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/async.h>
+
+#include <aws/cal/cal.h>
+#include <aws/cal/hash.h>
+#include <aws/cal/symmetric_cipher.h>
+
+#include <aws/common/condition_variable.h>
+#include <aws/common/hash_table.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/mutex.h>
+#include <aws/common/system_info.h>
+#include <aws/common/thread.h>
+
+/*
+ * Every object with operations queued or running has a queue, found through a table keyed by the object. A queue is
+ * only ever scheduled once: it's created scheduled, sits on the ready list (or with the submit function) until a
+ * worker takes it, and the worker runs everything queued on it so far, then either frees it or schedules it again if
+ * more came in meanwhile. That's what keeps each object's operations in order and one at a time.
+ */
+
+/* the most hash updates passed to a single aws_hash_update_vectored() call */
+#define S_MAX_VECTORED_UPDATES 32
+
+enum cal_async_op {
+    S_OP_HASH_UPDATE,
+    S_OP_HASH_FINALIZE,
+    S_OP_ENCRYPT,
+    S_OP_DECRYPT,
+    S_OP_FINALIZE_ENCRYPTION,
+    S_OP_FINALIZE_DECRYPTION,
+};
+
+struct cal_async_job {
+    struct aws_linked_list_node node;
+    enum cal_async_op op;
+    struct aws_byte_cursor input;
+    struct aws_byte_buf *output;
+    size_t truncate_to;
+    aws_cal_async_completion_fn *on_complete;
+    void *user_data;
+};
+
+struct cal_async_queue {
+    struct aws_cal_worker_pool *pool;
+    struct aws_linked_list_node ready_node;
+    void *object;
+    struct aws_linked_list jobs;
+};
+
+struct aws_cal_worker_pool {
+    struct aws_allocator *allocator;
+    struct aws_mutex lock;
+    /* workers wait on this for a ready queue, or to be stopped */
+    struct aws_condition_variable work_signal;
+    /* destroy waits on this for the last job to complete */
+    struct aws_condition_variable idle_signal;
+    struct aws_hash_table queues;
+    struct aws_linked_list ready;
+    size_t pending_jobs;
+    bool stopping;
+    aws_cal_worker_pool_submit_fn *submit;
+    void *user_data;
+    struct aws_thread *threads;
+    size_t thread_count;
+};
+
+static void s_run_queue(void *arg);
+
+/* call with the lock held. Returns true if the queue has to be handed to the submit function once it's released. */
+static bool s_schedule_queue(struct aws_cal_worker_pool *pool, struct cal_async_queue *queue) {
+    if (pool->submit) {
+        return true;
+    }
+
+    aws_linked_list_push_back(&pool->ready, &queue->ready_node);
+    aws_condition_variable_notify_one(&pool->work_signal);
+    return false;
+}
+
+static void s_complete_job(struct aws_cal_worker_pool *pool, struct cal_async_job *job, int result) {
+    if (job->on_complete) {
+        job->on_complete(result == AWS_OP_SUCCESS ? 0 : aws_last_error(), job->user_data);
+    }
+    aws_mem_release(pool->allocator, job);
+}
+
+/* Runs the hash updates at the front of jobs as one vectored update, and returns how many there were. */
+static size_t s_run_hash_updates(
+    struct aws_cal_worker_pool *pool,
+    struct aws_hash *hash,
+    struct aws_linked_list *jobs) {
+    struct cal_async_job *batch[S_MAX_VECTORED_UPDATES];
+    struct aws_byte_cursor segments[S_MAX_VECTORED_UPDATES];
+    size_t count = 0;
+
+    while (count < S_MAX_VECTORED_UPDATES && !aws_linked_list_empty(jobs)) {
+        struct cal_async_job *job = AWS_CONTAINER_OF(aws_linked_list_front(jobs), struct cal_async_job, node);
+        if (job->op != S_OP_HASH_UPDATE) {
+            break;
+        }
+        aws_linked_list_pop_front(jobs);
+        batch[count] = job;
+        segments[count] = job->input;
+        ++count;
+    }
+
+    int result = aws_hash_update_vectored(hash, segments, count);
+    int error_code = result == AWS_OP_SUCCESS ? 0 : aws_last_error();
+    for (size_t i = 0; i < count; ++i) {
+        /* the callbacks may raise errors of their own */
+        if (error_code) {
+            aws_raise_error(error_code);
+        }
+        s_complete_job(pool, batch[i], result);
+    }
+
+    return count;
+}
+
+static int s_run_job(void *object, struct cal_async_job *job) {
+    switch (job->op) {
+        case S_OP_HASH_FINALIZE:
+            return aws_hash_finalize(object, job->output, job->truncate_to);
+        case S_OP_ENCRYPT:
+            return aws_symmetric_cipher_encrypt(object, job->input, job->output);
+        case S_OP_DECRYPT:
+            return aws_symmetric_cipher_decrypt(object, job->input, job->output);
+        case S_OP_FINALIZE_ENCRYPTION:
+            return aws_symmetric_cipher_finalize_encryption(object, job->output);
+        case S_OP_FINALIZE_DECRYPTION:
+            return aws_symmetric_cipher_finalize_decryption(object, job->output);
+        case S_OP_HASH_UPDATE:
+            break;
+    }
+
+    return aws_hash_update(object, &job->input);
+}
+
+static void s_run_queue(void *arg) {
+    struct cal_async_queue *queue = arg;
+    struct aws_cal_worker_pool *pool = queue->pool;
+
+    struct aws_linked_list batch;
+    aws_linked_list_init(&batch);
+
+    aws_mutex_lock(&pool->lock);
+    aws_linked_list_swap_contents(&batch, &queue->jobs);
+    aws_mutex_unlock(&pool->lock);
+
+    size_t completed = 0;
+    while (!aws_linked_list_empty(&batch)) {
+        struct cal_async_job *job = AWS_CONTAINER_OF(aws_linked_list_front(&batch), struct cal_async_job, node);
+        if (job->op == S_OP_HASH_UPDATE) {
+            completed += s_run_hash_updates(pool, queue->object, &batch);
+            continue;
+        }
+
+        aws_linked_list_pop_front(&batch);
+        int result = s_run_job(queue->object, job);
+        s_complete_job(pool, job, result);
+        ++completed;
+    }
+
+    bool resubmit = false;
+    aws_cal_worker_pool_submit_fn *submit = pool->submit;
+    void *user_data = pool->user_data;
+
+    aws_mutex_lock(&pool->lock);
+    pool->pending_jobs -= completed;
+    if (aws_linked_list_empty(&queue->jobs)) {
+        aws_hash_table_remove(&pool->queues, queue->object, NULL, NULL);
+        aws_mem_release(pool->allocator, queue);
+    } else {
+        resubmit = s_schedule_queue(pool, queue);
+    }
+    if (pool->pending_jobs == 0) {
+        aws_condition_variable_notify_all(&pool->idle_signal);
+    }
+    aws_mutex_unlock(&pool->lock);
+
+    /* the pool can be gone by now unless there's more to do, so only what was read above is used */
+    if (resubmit) {
+        submit(s_run_queue, queue, user_data);
+    }
+}
+
+static bool s_worker_has_work(void *arg) {
+    struct aws_cal_worker_pool *pool = arg;
+    return pool->stopping || !aws_linked_list_empty(&pool->ready);
+}
+
+static void s_worker(void *arg) {
+    struct aws_cal_worker_pool *pool = arg;
+
+    aws_mutex_lock(&pool->lock);
+    for (;;) {
+        aws_condition_variable_wait_pred(&pool->work_signal, &pool->lock, s_worker_has_work, pool);
+        if (aws_linked_list_empty(&pool->ready)) {
+            break;
+        }
+
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&pool->ready);
+        aws_mutex_unlock(&pool->lock);
+        s_run_queue(AWS_CONTAINER_OF(node, struct cal_async_queue, ready_node));
+        aws_mutex_lock(&pool->lock);
+    }
+    aws_mutex_unlock(&pool->lock);
+
+    aws_cal_thread_clean_up();
+}
+
+static void s_stop_threads(struct aws_cal_worker_pool *pool, size_t launched) {
+    aws_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    aws_condition_variable_notify_all(&pool->work_signal);
+    aws_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < launched; ++i) {
+        aws_thread_join(&pool->threads[i]);
+        aws_thread_clean_up(&pool->threads[i]);
+    }
+}
+
+static void s_pool_clean_up(struct aws_cal_worker_pool *pool) {
+    if (pool->threads) {
+        aws_mem_release(pool->allocator, pool->threads);
+    }
+    aws_hash_table_clean_up(&pool->queues);
+    aws_condition_variable_clean_up(&pool->idle_signal);
+    aws_condition_variable_clean_up(&pool->work_signal);
+    aws_mutex_clean_up(&pool->lock);
+    aws_mem_release(pool->allocator, pool);
+}
+
+struct aws_cal_worker_pool *aws_cal_worker_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_cal_worker_pool_options *options) {
+
+    struct aws_cal_worker_pool *pool = aws_mem_calloc(allocator, 1, sizeof(struct aws_cal_worker_pool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->allocator = allocator;
+    aws_linked_list_init(&pool->ready);
+    if (options) {
+        pool->submit = options->submit;
+        pool->user_data = options->user_data;
+    }
+
+    if (aws_mutex_init(&pool->lock)) {
+        aws_mem_release(allocator, pool);
+        return NULL;
+    }
+    aws_condition_variable_init(&pool->work_signal);
+    aws_condition_variable_init(&pool->idle_signal);
+
+    if (aws_hash_table_init(&pool->queues, allocator, 16, aws_hash_ptr, aws_ptr_eq, NULL, NULL)) {
+        goto on_error;
+    }
+
+    if (pool->submit) {
+        return pool;
+    }
+
+    pool->thread_count = options && options->thread_count ? options->thread_count : aws_system_info_processor_count();
+    if (pool->thread_count == 0) {
+        pool->thread_count = 1;
+    }
+
+    pool->threads = aws_mem_calloc(allocator, pool->thread_count, sizeof(struct aws_thread));
+    if (!pool->threads) {
+        goto on_error;
+    }
+
+    for (size_t i = 0; i < pool->thread_count; ++i) {
+        if (aws_thread_init(&pool->threads[i], allocator) ||
+            aws_thread_launch(&pool->threads[i], s_worker, pool, aws_default_thread_options())) {
+            aws_thread_clean_up(&pool->threads[i]);
+            s_stop_threads(pool, i);
+            goto on_error;
+        }
+    }
+
+    return pool;
+
+on_error:
+    s_pool_clean_up(pool);
+    return NULL;
+}
+
+static bool s_pool_is_idle(void *arg) {
+    struct aws_cal_worker_pool *pool = arg;
+    return pool->pending_jobs == 0;
+}
+
+void aws_cal_worker_pool_destroy(struct aws_cal_worker_pool *pool) {
+    if (!pool) {
+        return;
+    }
+
+    aws_mutex_lock(&pool->lock);
+    aws_condition_variable_wait_pred(&pool->idle_signal, &pool->lock, s_pool_is_idle, pool);
+    aws_mutex_unlock(&pool->lock);
+
+    s_stop_threads(pool, pool->thread_count);
+    s_pool_clean_up(pool);
+}
+
+static int s_submit(struct aws_cal_worker_pool *pool, void *object, const struct cal_async_job *job_template) {
+    AWS_PRECONDITION(pool);
+    AWS_PRECONDITION(object);
+
+    struct cal_async_job *job = aws_mem_calloc(pool->allocator, 1, sizeof(struct cal_async_job));
+    if (!job) {
+        return AWS_OP_ERR;
+    }
+    *job = *job_template;
+
+    bool submit = false;
+    struct cal_async_queue *queue = NULL;
+
+    aws_mutex_lock(&pool->lock);
+    if (pool->stopping) {
+        aws_mutex_unlock(&pool->lock);
+        aws_mem_release(pool->allocator, job);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_hash_element *element = NULL;
+    aws_hash_table_find(&pool->queues, object, &element);
+    if (element) {
+        queue = element->value;
+        aws_linked_list_push_back(&queue->jobs, &job->node);
+    } else {
+        queue = aws_mem_calloc(pool->allocator, 1, sizeof(struct cal_async_queue));
+        if (!queue || aws_hash_table_put(&pool->queues, object, queue, NULL)) {
+            aws_mutex_unlock(&pool->lock);
+            if (queue) {
+                aws_mem_release(pool->allocator, queue);
+            }
+            aws_mem_release(pool->allocator, job);
+            return AWS_OP_ERR;
+        }
+
+        queue->pool = pool;
+        queue->object = object;
+        aws_linked_list_init(&queue->jobs);
+        aws_linked_list_push_back(&queue->jobs, &job->node);
+        submit = s_schedule_queue(pool, queue);
+    }
+    ++pool->pending_jobs;
+    aws_mutex_unlock(&pool->lock);
+
+    if (submit) {
+        pool->submit(s_run_queue, queue, pool->user_data);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_hash_update_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_hash *hash,
+    struct aws_byte_cursor input,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data) {
+
+    struct cal_async_job job = {
+        .op = S_OP_HASH_UPDATE,
+        .input = input,
+        .on_complete = on_complete,
+        .user_data = user_data,
+    };
+    return s_submit(pool, hash, &job);
+}
+
+int aws_hash_finalize_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_hash *hash,
+    struct aws_byte_buf *output,
+    size_t truncate_to,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data) {
+
+    struct cal_async_job job = {
+        .op = S_OP_HASH_FINALIZE,
+        .output = output,
+        .truncate_to = truncate_to,
+        .on_complete = on_complete,
+        .user_data = user_data,
+    };
+    return s_submit(pool, hash, &job);
+}
+
+int aws_symmetric_cipher_encrypt_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data) {
+
+    struct cal_async_job job = {
+        .op = S_OP_ENCRYPT,
+        .input = input,
+        .output = out,
+        .on_complete = on_complete,
+        .user_data = user_data,
+    };
+    return s_submit(pool, cipher, &job);
+}
+
+int aws_symmetric_cipher_decrypt_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data) {
+
+    struct cal_async_job job = {
+        .op = S_OP_DECRYPT,
+        .input = input,
+        .output = out,
+        .on_complete = on_complete,
+        .user_data = user_data,
+    };
+    return s_submit(pool, cipher, &job);
+}
+
+int aws_symmetric_cipher_finalize_encryption_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data) {
+
+    struct cal_async_job job = {
+        .op = S_OP_FINALIZE_ENCRYPTION,
+        .output = out,
+        .on_complete = on_complete,
+        .user_data = user_data,
+    };
+    return s_submit(pool, cipher, &job);
+}
+
+int aws_symmetric_cipher_finalize_decryption_async(
+    struct aws_cal_worker_pool *pool,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out,
+    aws_cal_async_completion_fn *on_complete,
+    void *user_data) {
+
+    struct cal_async_job job = {
+        .op = S_OP_FINALIZE_DECRYPTION,
+        .output = out,
+        .on_complete = on_complete,
+        .user_data = user_data,
+    };
+    return s_submit(pool, cipher, &job);
+}
@@ -0,0 +1,787 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/hash.h>
+#include <aws/cal/private/blake3.h>
+
+#include <aws/common/cpuid.h>
+#include <aws/common/thread.h>
+
+/*
+ * BLAKE3 (https://github.com/BLAKE3-team/BLAKE3-specs) hashes its input as 1KB chunks at the leaves of a binary
+ * tree. Chunks, and parent nodes on the same level, are independent of each other, so whole subtrees of the
+ * input are compressed 4 at a time by the SIMD kernel, and optionally split across the caller's threads.
+ * Only the plain (unkeyed) hash mode with a 32 byte output is implemented.
+ */
+
+const uint32_t g_aws_blake3_iv[8] = {
+    0x6a09e667,
+    0xbb67ae85,
+    0x3c6ef372,
+    0xa54ff53a,
+    0x510e527f,
+    0x9b05688c,
+    0x1f83d9ab,
+    0x5be0cd19,
+};
+
+const uint8_t g_aws_blake3_msg_schedule[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13},
+};
+
+/* widest kernel we have, and never less than 2 so a parent node always fits */
+#define S_MAX_SIMD_DEGREE 4
+#define S_MAX_PARALLEL_TASKS 64
+#define S_DEFAULT_PARALLEL_TASKS 8
+#define S_DEFAULT_MIN_PARALLEL_LEN (1024 * 1024)
+
+static inline uint32_t s_load_u32_le(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static inline void s_store_cv_le(uint8_t *dest, const uint32_t cv[8]) {
+    for (size_t i = 0; i < 8; ++i) {
+        dest[i * 4] = (uint8_t)cv[i];
+        dest[i * 4 + 1] = (uint8_t)(cv[i] >> 8);
+        dest[i * 4 + 2] = (uint8_t)(cv[i] >> 16);
+        dest[i * 4 + 3] = (uint8_t)(cv[i] >> 24);
+    }
+}
+
+static inline uint32_t s_rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static inline void s_g(uint32_t *v, size_t a, size_t b, size_t c, size_t d, uint32_t x, uint32_t y) {
+    v[a] = v[a] + v[b] + x;
+    v[d] = s_rotr(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = s_rotr(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + y;
+    v[d] = s_rotr(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = s_rotr(v[b] ^ v[c], 7);
+}
+
+static void s_compress_in_place(
+    uint32_t cv[8],
+    const uint8_t block[AWS_BLAKE3_BLOCK_LEN],
+    uint8_t block_len,
+    uint64_t counter,
+    uint8_t flags) {
+
+    uint32_t m[16];
+    for (size_t i = 0; i < 16; ++i) {
+        m[i] = s_load_u32_le(block + i * 4);
+    }
+
+    uint32_t v[16] = {
+        cv[0],
+        cv[1],
+        cv[2],
+        cv[3],
+        cv[4],
+        cv[5],
+        cv[6],
+        cv[7],
+        g_aws_blake3_iv[0],
+        g_aws_blake3_iv[1],
+        g_aws_blake3_iv[2],
+        g_aws_blake3_iv[3],
+        (uint32_t)counter,
+        (uint32_t)(counter >> 32),
+        (uint32_t)block_len,
+        (uint32_t)flags,
+    };
+
+    for (size_t r = 0; r < 7; ++r) {
+        const uint8_t *s = g_aws_blake3_msg_schedule[r];
+        s_g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        s_g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        s_g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        s_g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        s_g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        s_g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        s_g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        s_g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        cv[i] = v[i] ^ v[i + 8];
+    }
+}
+
+static void s_hash_one(
+    const uint8_t *input,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t out[AWS_BLAKE3_OUT_LEN]) {
+
+    uint32_t cv[8];
+    memcpy(cv, key, sizeof(cv));
+
+    uint8_t block_flags = flags | flags_start;
+    for (size_t block = 0; block < block_count; ++block, input += AWS_BLAKE3_BLOCK_LEN) {
+        if (block + 1 == block_count) {
+            block_flags |= flags_end;
+        }
+        s_compress_in_place(cv, input, AWS_BLAKE3_BLOCK_LEN, counter, block_flags);
+        block_flags = flags;
+    }
+
+    s_store_cv_le(out, cv);
+}
+
+static aws_blake3_hash4_fn *s_hash4_fn = NULL;
+static aws_thread_once s_hash4_fn_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static void s_select_hash4_fn(void *user_data) {
+    (void)user_data;
+#if defined(AWS_CAL_BLAKE3_X86)
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_SSE_4_1)) {
+        s_hash4_fn = aws_blake3_hash4_x86;
+    }
+#elif defined(AWS_CAL_BLAKE3_ARM)
+    s_hash4_fn = aws_blake3_hash4_arm;
+#endif
+}
+
+static size_t s_simd_degree(void) {
+    return s_hash4_fn ? 4 : 1;
+}
+
+static void s_hash_many(
+    const uint8_t *const *inputs,
+    size_t input_count,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    bool increment_counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t *out) {
+
+    if (s_hash4_fn) {
+        while (input_count >= 4) {
+            s_hash4_fn(inputs, block_count, key, counter, increment_counter, flags, flags_start, flags_end, out);
+            if (increment_counter) {
+                counter += 4;
+            }
+            inputs += 4;
+            input_count -= 4;
+            out += 4 * AWS_BLAKE3_OUT_LEN;
+        }
+    }
+
+    while (input_count > 0) {
+        s_hash_one(inputs[0], block_count, key, counter, flags, flags_start, flags_end, out);
+        if (increment_counter) {
+            counter += 1;
+        }
+        inputs += 1;
+        input_count -= 1;
+        out += AWS_BLAKE3_OUT_LEN;
+    }
+}
+
+/* The last block of a node is only compressed once we know whether it's the root, so it's carried around here. */
+struct blake3_output {
+    uint32_t input_cv[8];
+    uint8_t block[AWS_BLAKE3_BLOCK_LEN];
+    uint8_t block_len;
+    uint64_t counter;
+    uint8_t flags;
+};
+
+static void s_output_chaining_value(const struct blake3_output *output, uint8_t cv_out[AWS_BLAKE3_OUT_LEN]) {
+    uint32_t cv[8];
+    memcpy(cv, output->input_cv, sizeof(cv));
+    s_compress_in_place(cv, output->block, output->block_len, output->counter, output->flags);
+    s_store_cv_le(cv_out, cv);
+}
+
+static void s_output_root_bytes(const struct blake3_output *output, uint8_t out[AWS_BLAKE3_OUT_LEN]) {
+    uint32_t cv[8];
+    memcpy(cv, output->input_cv, sizeof(cv));
+    /* the counter of a root node counts output blocks rather than chunks */
+    s_compress_in_place(cv, output->block, output->block_len, 0, output->flags | AWS_BLAKE3_ROOT);
+    s_store_cv_le(out, cv);
+}
+
+static struct blake3_output s_parent_output(const uint8_t block[AWS_BLAKE3_BLOCK_LEN], const uint32_t key[8]) {
+    struct blake3_output output;
+    memcpy(output.input_cv, key, sizeof(output.input_cv));
+    memcpy(output.block, block, AWS_BLAKE3_BLOCK_LEN);
+    output.block_len = AWS_BLAKE3_BLOCK_LEN;
+    output.counter = 0;
+    output.flags = AWS_BLAKE3_PARENT;
+    return output;
+}
+
+struct blake3_chunk_state {
+    uint32_t cv[8];
+    uint64_t chunk_counter;
+    uint8_t buf[AWS_BLAKE3_BLOCK_LEN];
+    uint8_t buf_len;
+    uint8_t blocks_compressed;
+};
+
+static void s_chunk_state_reset(struct blake3_chunk_state *chunk, const uint32_t key[8], uint64_t chunk_counter) {
+    memcpy(chunk->cv, key, sizeof(chunk->cv));
+    chunk->chunk_counter = chunk_counter;
+    AWS_ZERO_ARRAY(chunk->buf);
+    chunk->buf_len = 0;
+    chunk->blocks_compressed = 0;
+}
+
+static size_t s_chunk_state_len(const struct blake3_chunk_state *chunk) {
+    return (size_t)chunk->blocks_compressed * AWS_BLAKE3_BLOCK_LEN + chunk->buf_len;
+}
+
+static uint8_t s_chunk_state_start_flag(const struct blake3_chunk_state *chunk) {
+    return chunk->blocks_compressed == 0 ? AWS_BLAKE3_CHUNK_START : 0;
+}
+
+static void s_chunk_state_update(struct blake3_chunk_state *chunk, const uint8_t *input, size_t input_len) {
+    if (chunk->buf_len > 0) {
+        size_t take = aws_min_size(AWS_BLAKE3_BLOCK_LEN - chunk->buf_len, input_len);
+        memcpy(chunk->buf + chunk->buf_len, input, take);
+        chunk->buf_len += (uint8_t)take;
+        input += take;
+        input_len -= take;
+
+        if (input_len > 0) {
+            s_compress_in_place(
+                chunk->cv, chunk->buf, AWS_BLAKE3_BLOCK_LEN, chunk->chunk_counter, s_chunk_state_start_flag(chunk));
+            chunk->blocks_compressed += 1;
+            chunk->buf_len = 0;
+            AWS_ZERO_ARRAY(chunk->buf);
+        }
+    }
+
+    /* a full block is only compressed once more input shows up, the last one needs CHUNK_END */
+    while (input_len > AWS_BLAKE3_BLOCK_LEN) {
+        s_compress_in_place(
+            chunk->cv, input, AWS_BLAKE3_BLOCK_LEN, chunk->chunk_counter, s_chunk_state_start_flag(chunk));
+        chunk->blocks_compressed += 1;
+        input += AWS_BLAKE3_BLOCK_LEN;
+        input_len -= AWS_BLAKE3_BLOCK_LEN;
+    }
+
+    if (input_len > 0) {
+        memcpy(chunk->buf + chunk->buf_len, input, input_len);
+        chunk->buf_len += (uint8_t)input_len;
+    }
+}
+
+static struct blake3_output s_chunk_state_output(const struct blake3_chunk_state *chunk) {
+    struct blake3_output output;
+    memcpy(output.input_cv, chunk->cv, sizeof(output.input_cv));
+    memcpy(output.block, chunk->buf, AWS_BLAKE3_BLOCK_LEN);
+    output.block_len = chunk->buf_len;
+    output.counter = chunk->chunk_counter;
+    output.flags = s_chunk_state_start_flag(chunk) | AWS_BLAKE3_CHUNK_END;
+    return output;
+}
+
+static void s_chunk_cv(
+    const uint8_t *input,
+    size_t input_len,
+    const uint32_t key[8],
+    uint64_t chunk_counter,
+    uint8_t cv_out[AWS_BLAKE3_OUT_LEN]) {
+
+    struct blake3_chunk_state chunk;
+    s_chunk_state_reset(&chunk, key, chunk_counter);
+    s_chunk_state_update(&chunk, input, input_len);
+    struct blake3_output output = s_chunk_state_output(&chunk);
+    s_output_chaining_value(&output, cv_out);
+}
+
+/* Hashes up to s_simd_degree() chunks, the last of which may be partial, and returns how many CVs it wrote. */
+static size_t s_compress_chunks_parallel(
+    const uint8_t *input,
+    size_t input_len,
+    const uint32_t key[8],
+    uint64_t chunk_counter,
+    uint8_t *out) {
+
+    const uint8_t *chunks[S_MAX_SIMD_DEGREE];
+    size_t chunk_count = 0;
+    size_t position = 0;
+
+    while (input_len - position >= AWS_BLAKE3_CHUNK_LEN) {
+        chunks[chunk_count++] = input + position;
+        position += AWS_BLAKE3_CHUNK_LEN;
+    }
+
+    s_hash_many(
+        chunks,
+        chunk_count,
+        AWS_BLAKE3_CHUNK_LEN / AWS_BLAKE3_BLOCK_LEN,
+        key,
+        chunk_counter,
+        true,
+        0,
+        AWS_BLAKE3_CHUNK_START,
+        AWS_BLAKE3_CHUNK_END,
+        out);
+
+    if (input_len > position) {
+        s_chunk_cv(
+            input + position,
+            input_len - position,
+            key,
+            chunk_counter + chunk_count,
+            out + chunk_count * AWS_BLAKE3_OUT_LEN);
+        return chunk_count + 1;
+    }
+
+    return chunk_count;
+}
+
+/* Combines pairs of child CVs into parent CVs, carrying an odd one out over unchanged. Returns the new count. */
+static size_t s_compress_parents_parallel(
+    const uint8_t *child_cvs,
+    size_t cv_count,
+    const uint32_t key[8],
+    uint8_t *out) {
+
+    const uint8_t *parents[S_MAX_SIMD_DEGREE];
+    size_t parent_count = 0;
+
+    while (cv_count - 2 * parent_count >= 2) {
+        parents[parent_count] = child_cvs + 2 * parent_count * AWS_BLAKE3_OUT_LEN;
+        parent_count += 1;
+    }
+
+    s_hash_many(parents, parent_count, 1, key, 0, false, AWS_BLAKE3_PARENT, 0, 0, out);
+
+    if (cv_count > 2 * parent_count) {
+        memcpy(
+            out + parent_count * AWS_BLAKE3_OUT_LEN, child_cvs + 2 * parent_count * AWS_BLAKE3_OUT_LEN, AWS_BLAKE3_OUT_LEN);
+        return parent_count + 1;
+    }
+
+    return parent_count;
+}
+
+static uint64_t s_round_down_to_power_of_2(uint64_t x) {
+    uint64_t result = 1;
+    while (result <= x / 2) {
+        result *= 2;
+    }
+    return result;
+}
+
+/* The left subtree is the largest power of 2 number of chunks that leaves at least 1 byte for the right. */
+static size_t s_left_len(size_t content_len) {
+    size_t full_chunks = (content_len - 1) / AWS_BLAKE3_CHUNK_LEN;
+    return (size_t)s_round_down_to_power_of_2(full_chunks) * AWS_BLAKE3_CHUNK_LEN;
+}
+
+/*
+ * Recursively hashes a subtree down to at most S_MAX_SIMD_DEGREE CVs (at least 2 when the input is longer than
+ * a chunk) rather than a single one, so each level of parent nodes still has enough of them to fill the kernel.
+ */
+static size_t s_compress_subtree_wide(
+    const uint8_t *input,
+    size_t input_len,
+    const uint32_t key[8],
+    uint64_t chunk_counter,
+    uint8_t *out) {
+
+    size_t degree = s_simd_degree();
+    if (input_len <= degree * AWS_BLAKE3_CHUNK_LEN) {
+        return s_compress_chunks_parallel(input, input_len, key, chunk_counter, out);
+    }
+
+    size_t left_input_len = s_left_len(input_len);
+    size_t right_input_len = input_len - left_input_len;
+    uint64_t right_chunk_counter = chunk_counter + left_input_len / AWS_BLAKE3_CHUNK_LEN;
+
+    uint8_t cv_array[2 * S_MAX_SIMD_DEGREE * AWS_BLAKE3_OUT_LEN];
+    if (left_input_len > AWS_BLAKE3_CHUNK_LEN && degree == 1) {
+        degree = 2;
+    }
+    uint8_t *right_cvs = cv_array + degree * AWS_BLAKE3_OUT_LEN;
+
+    size_t left_count = s_compress_subtree_wide(input, left_input_len, key, chunk_counter, cv_array);
+    size_t right_count =
+        s_compress_subtree_wide(input + left_input_len, right_input_len, key, right_chunk_counter, right_cvs);
+
+    /* only happens without a kernel, the two CVs are already what the caller needs */
+    if (left_count == 1) {
+        memcpy(out, cv_array, 2 * AWS_BLAKE3_OUT_LEN);
+        return 2;
+    }
+
+    return s_compress_parents_parallel(cv_array, left_count + right_count, key, out);
+}
+
+/* Hashes a subtree of more than one chunk down to the two children of its top node, which is left uncompressed. */
+static void s_compress_subtree_to_parent_node(
+    const uint8_t *input,
+    size_t input_len,
+    const uint32_t key[8],
+    uint64_t chunk_counter,
+    uint8_t out[2 * AWS_BLAKE3_OUT_LEN]) {
+
+    uint8_t cv_array[S_MAX_SIMD_DEGREE * AWS_BLAKE3_OUT_LEN];
+    size_t cv_count = s_compress_subtree_wide(input, input_len, key, chunk_counter, cv_array);
+
+    uint8_t out_array[S_MAX_SIMD_DEGREE * AWS_BLAKE3_OUT_LEN / 2];
+    while (cv_count > 2) {
+        cv_count = s_compress_parents_parallel(cv_array, cv_count, key, out_array);
+        memcpy(cv_array, out_array, cv_count * AWS_BLAKE3_OUT_LEN);
+    }
+
+    memcpy(out, cv_array, 2 * AWS_BLAKE3_OUT_LEN);
+}
+
+/* Hashes a whole, power of 2 sized, non-root subtree down to its CV. */
+static void s_compress_subtree_to_cv(
+    const uint8_t *input,
+    size_t input_len,
+    const uint32_t key[8],
+    uint64_t chunk_counter,
+    uint8_t cv_out[AWS_BLAKE3_OUT_LEN]) {
+
+    if (input_len <= AWS_BLAKE3_CHUNK_LEN) {
+        s_chunk_cv(input, input_len, key, chunk_counter, cv_out);
+        return;
+    }
+
+    uint8_t parent_block[AWS_BLAKE3_BLOCK_LEN];
+    s_compress_subtree_to_parent_node(input, input_len, key, chunk_counter, parent_block);
+    struct blake3_output output = s_parent_output(parent_block, key);
+    s_output_chaining_value(&output, cv_out);
+}
+
+struct blake3_subtree_task {
+    const uint8_t *input;
+    size_t input_len;
+    uint64_t chunk_counter;
+    uint8_t cv[AWS_BLAKE3_OUT_LEN];
+};
+
+static void s_run_subtree_task(void *task_arg) {
+    struct blake3_subtree_task *task = task_arg;
+    s_compress_subtree_to_cv(task->input, task->input_len, g_aws_blake3_iv, task->chunk_counter, task->cv);
+}
+
+static void s_destroy(struct aws_hash *hash);
+static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
+static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_reset(struct aws_hash *hash);
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
+
+static struct aws_hash_vtable s_blake3_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "BLAKE3",
+    .provider = "aws-c-cal builtin",
+};
+
+struct blake3_hash {
+    struct aws_hash hash;
+    struct blake3_chunk_state chunk;
+    /* Completed subtree CVs, one per set bit of the chunk count. The newest one is merged lazily, since it
+     * might still turn out to be a child of the root. */
+    uint8_t cv_stack[(AWS_BLAKE3_MAX_DEPTH + 1) * AWS_BLAKE3_OUT_LEN];
+    size_t cv_stack_len;
+    struct aws_blake3_parallel_options parallel;
+};
+
+static struct aws_hash *s_blake3_new(
+    struct aws_allocator *allocator,
+    const struct aws_blake3_parallel_options *parallel) {
+
+    aws_thread_call_once(&s_hash4_fn_once, s_select_hash4_fn, NULL);
+
+    struct blake3_hash *blake3_hash = aws_mem_calloc(allocator, 1, sizeof(struct blake3_hash));
+
+    if (!blake3_hash) {
+        return NULL;
+    }
+
+    blake3_hash->hash.allocator = allocator;
+    blake3_hash->hash.vtable = &s_blake3_vtable;
+    blake3_hash->hash.impl = blake3_hash;
+    blake3_hash->hash.digest_size = AWS_BLAKE3_LEN;
+
+    if (parallel) {
+        blake3_hash->parallel = *parallel;
+
+        size_t max_tasks = parallel->max_tasks ? parallel->max_tasks : S_DEFAULT_PARALLEL_TASKS;
+        max_tasks = aws_min_size(max_tasks, S_MAX_PARALLEL_TASKS);
+        blake3_hash->parallel.max_tasks = (size_t)s_round_down_to_power_of_2(max_tasks);
+
+        if (blake3_hash->parallel.min_parallel_len == 0) {
+            blake3_hash->parallel.min_parallel_len = S_DEFAULT_MIN_PARALLEL_LEN;
+        }
+    }
+
+    s_reset(&blake3_hash->hash);
+    return &blake3_hash->hash;
+}
+
+struct aws_hash *aws_blake3_default_new(struct aws_allocator *allocator) {
+    return s_blake3_new(allocator, NULL);
+}
+
+struct aws_hash *aws_blake3_new_parallel(
+    struct aws_allocator *allocator,
+    const struct aws_blake3_parallel_options *options) {
+
+    if (options == NULL || options->run_tasks == NULL) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    return s_blake3_new(allocator, options);
+}
+
+static void s_destroy(struct aws_hash *hash) {
+    struct blake3_hash *ctx = hash->impl;
+    aws_mem_release(hash->allocator, ctx);
+}
+
+static int s_reset(struct aws_hash *hash) {
+    struct blake3_hash *ctx = hash->impl;
+
+    s_chunk_state_reset(&ctx->chunk, g_aws_blake3_iv, 0);
+    ctx->cv_stack_len = 0;
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static size_t s_popcount(uint64_t x) {
+    size_t count = 0;
+    while (x) {
+        count += 1;
+        x &= x - 1;
+    }
+    return count;
+}
+
+/* Merges completed subtrees until the stack holds one CV per set bit of total_chunks. */
+static void s_merge_cv_stack(struct blake3_hash *ctx, uint64_t total_chunks) {
+    size_t post_merge_stack_len = s_popcount(total_chunks);
+    while (ctx->cv_stack_len > post_merge_stack_len) {
+        uint8_t *parent_node = ctx->cv_stack + (ctx->cv_stack_len - 2) * AWS_BLAKE3_OUT_LEN;
+        struct blake3_output output = s_parent_output(parent_node, g_aws_blake3_iv);
+        s_output_chaining_value(&output, parent_node);
+        ctx->cv_stack_len -= 1;
+    }
+}
+
+static void s_push_cv(struct blake3_hash *ctx, const uint8_t new_cv[AWS_BLAKE3_OUT_LEN], uint64_t chunk_counter) {
+    s_merge_cv_stack(ctx, chunk_counter);
+    memcpy(ctx->cv_stack + ctx->cv_stack_len * AWS_BLAKE3_OUT_LEN, new_cv, AWS_BLAKE3_OUT_LEN);
+    ctx->cv_stack_len += 1;
+}
+
+/*
+ * Splits a subtree into task_count equal, power of 2 sized pieces, has the caller's run_tasks hash them, then
+ * joins the resulting CVs back up to the subtree's two children.
+ */
+static void s_compress_subtree_to_parent_node_parallel(
+    struct blake3_hash *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    uint64_t chunk_counter,
+    size_t task_count,
+    uint8_t out[2 * AWS_BLAKE3_OUT_LEN]) {
+
+    struct blake3_subtree_task tasks[S_MAX_PARALLEL_TASKS];
+    void *task_args[S_MAX_PARALLEL_TASKS];
+    size_t piece_len = input_len / task_count;
+
+    for (size_t i = 0; i < task_count; ++i) {
+        tasks[i].input = input + i * piece_len;
+        tasks[i].input_len = piece_len;
+        tasks[i].chunk_counter = chunk_counter + i * (piece_len / AWS_BLAKE3_CHUNK_LEN);
+        task_args[i] = &tasks[i];
+    }
+
+    ctx->parallel.run_tasks(s_run_subtree_task, task_args, task_count, ctx->parallel.user_data);
+
+    /* every level of the join is a full row of sibling pairs, since task_count is a power of 2 */
+    uint8_t cvs[S_MAX_PARALLEL_TASKS * AWS_BLAKE3_OUT_LEN];
+    for (size_t i = 0; i < task_count; ++i) {
+        memcpy(cvs + i * AWS_BLAKE3_OUT_LEN, tasks[i].cv, AWS_BLAKE3_OUT_LEN);
+    }
+
+    size_t cv_count = task_count;
+    while (cv_count > 2) {
+        const uint8_t *parents[S_MAX_PARALLEL_TASKS / 2];
+        uint8_t parent_cvs[S_MAX_PARALLEL_TASKS / 2 * AWS_BLAKE3_OUT_LEN];
+        for (size_t i = 0; i < cv_count / 2; ++i) {
+            parents[i] = cvs + 2 * i * AWS_BLAKE3_OUT_LEN;
+        }
+        s_hash_many(parents, cv_count / 2, 1, g_aws_blake3_iv, 0, false, AWS_BLAKE3_PARENT, 0, 0, parent_cvs);
+        cv_count /= 2;
+        memcpy(cvs, parent_cvs, cv_count * AWS_BLAKE3_OUT_LEN);
+    }
+
+    memcpy(out, cvs, 2 * AWS_BLAKE3_OUT_LEN);
+}
+
+static size_t s_parallel_task_count(const struct blake3_hash *ctx, size_t subtree_len) {
+    if (ctx->parallel.run_tasks == NULL || subtree_len < ctx->parallel.min_parallel_len) {
+        return 1;
+    }
+
+    size_t subtree_chunks = subtree_len / AWS_BLAKE3_CHUNK_LEN;
+    return aws_min_size(ctx->parallel.max_tasks, subtree_chunks);
+}
+
+static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct blake3_hash *ctx = hash->impl;
+    const uint8_t *input = to_hash->ptr;
+    size_t input_len = to_hash->len;
+
+    if (input_len == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* finish a partially filled chunk first */
+    if (s_chunk_state_len(&ctx->chunk) > 0) {
+        size_t take = aws_min_size(AWS_BLAKE3_CHUNK_LEN - s_chunk_state_len(&ctx->chunk), input_len);
+        s_chunk_state_update(&ctx->chunk, input, take);
+        input += take;
+        input_len -= take;
+
+        if (input_len == 0) {
+            return AWS_OP_SUCCESS;
+        }
+
+        struct blake3_output output = s_chunk_state_output(&ctx->chunk);
+        uint8_t chunk_cv[AWS_BLAKE3_OUT_LEN];
+        s_output_chaining_value(&output, chunk_cv);
+        s_push_cv(ctx, chunk_cv, ctx->chunk.chunk_counter);
+        s_chunk_state_reset(&ctx->chunk, g_aws_blake3_iv, ctx->chunk.chunk_counter + 1);
+    }
+
+    /*
+     * then hash the largest subtrees the input and the current position in the tree allow straight out of the
+     * caller's memory. Anything that might be the last chunk is left to the chunk state, since it could be the
+     * root.
+     */
+    while (input_len > AWS_BLAKE3_CHUNK_LEN) {
+        uint64_t subtree_len = s_round_down_to_power_of_2(input_len);
+        uint64_t count_so_far = ctx->chunk.chunk_counter * AWS_BLAKE3_CHUNK_LEN;
+        while (((subtree_len - 1) & count_so_far) != 0) {
+            subtree_len /= 2;
+        }
+        uint64_t subtree_chunks = subtree_len / AWS_BLAKE3_CHUNK_LEN;
+
+        if (subtree_len <= AWS_BLAKE3_CHUNK_LEN) {
+            uint8_t chunk_cv[AWS_BLAKE3_OUT_LEN];
+            s_chunk_cv(input, (size_t)subtree_len, g_aws_blake3_iv, ctx->chunk.chunk_counter, chunk_cv);
+            s_push_cv(ctx, chunk_cv, ctx->chunk.chunk_counter);
+        } else {
+            /* push both children, rather than the subtree's CV, so that finalize can still make it the root */
+            uint8_t cv_pair[2 * AWS_BLAKE3_OUT_LEN];
+            size_t task_count = s_parallel_task_count(ctx, (size_t)subtree_len);
+
+            if (task_count > 1) {
+                s_compress_subtree_to_parent_node_parallel(
+                    ctx, input, (size_t)subtree_len, ctx->chunk.chunk_counter, task_count, cv_pair);
+            } else {
+                s_compress_subtree_to_parent_node(
+                    input, (size_t)subtree_len, g_aws_blake3_iv, ctx->chunk.chunk_counter, cv_pair);
+            }
+
+            s_push_cv(ctx, cv_pair, ctx->chunk.chunk_counter);
+            s_push_cv(ctx, cv_pair + AWS_BLAKE3_OUT_LEN, ctx->chunk.chunk_counter + subtree_chunks / 2);
+        }
+
+        ctx->chunk.chunk_counter += subtree_chunks;
+        input += subtree_len;
+        input_len -= (size_t)subtree_len;
+    }
+
+    if (input_len > 0) {
+        s_chunk_state_update(&ctx->chunk, input, input_len);
+        s_merge_cv_stack(ctx, ctx->chunk.chunk_counter);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct blake3_hash *ctx = hash->impl;
+
+    size_t buffer_len = output->capacity - output->len;
+
+    if (buffer_len < hash->digest_size) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    struct blake3_output root;
+    size_t cvs_remaining = 0;
+
+    if (ctx->cv_stack_len == 0) {
+        root = s_chunk_state_output(&ctx->chunk);
+    } else if (s_chunk_state_len(&ctx->chunk) > 0) {
+        cvs_remaining = ctx->cv_stack_len;
+        root = s_chunk_state_output(&ctx->chunk);
+    } else {
+        /* the input ended on a subtree boundary, so the top two CVs on the stack are the root's children */
+        cvs_remaining = ctx->cv_stack_len - 2;
+        root = s_parent_output(ctx->cv_stack + cvs_remaining * AWS_BLAKE3_OUT_LEN, g_aws_blake3_iv);
+    }
+
+    while (cvs_remaining > 0) {
+        cvs_remaining -= 1;
+        uint8_t parent_block[AWS_BLAKE3_BLOCK_LEN];
+        memcpy(parent_block, ctx->cv_stack + cvs_remaining * AWS_BLAKE3_OUT_LEN, AWS_BLAKE3_OUT_LEN);
+        s_output_chaining_value(&root, parent_block + AWS_BLAKE3_OUT_LEN);
+        root = s_parent_output(parent_block, g_aws_blake3_iv);
+    }
+
+    s_output_root_bytes(&root, output->buffer + output->len);
+    output->len += hash->digest_size;
+    hash->good = false;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    struct blake3_hash *copy = aws_mem_acquire(allocator, sizeof(struct blake3_hash));
+
+    if (!copy) {
+        return NULL;
+    }
+
+    /* everything is held by value, the parallel options included */
+    *copy = *(const struct blake3_hash *)hash->impl;
+    copy->hash.allocator = allocator;
+    copy->hash.impl = copy;
+
+    return &copy->hash;
+}
@@ -0,0 +1,145 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/blake3.h>
+
+#if defined(_MSC_VER)
+#    include <arm64_neon.h>
+#else
+#    include <arm_neon.h>
+#endif
+
+/*
+ * NEON implementation of the BLAKE3 4-way compression kernel. Each vector holds the same state word of 4
+ * independent inputs, so the rounds are the scalar ones with every operation applied lane-wise. NEON is
+ * mandatory on aarch64, so this is always used there.
+ */
+
+static inline uint32x4_t s_rot16(uint32x4_t x) {
+    return vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(x)));
+}
+
+static inline uint32x4_t s_rot12(uint32x4_t x) {
+    return vorrq_u32(vshrq_n_u32(x, 12), vshlq_n_u32(x, 32 - 12));
+}
+
+static inline uint32x4_t s_rot8(uint32x4_t x) {
+    return vorrq_u32(vshrq_n_u32(x, 8), vshlq_n_u32(x, 32 - 8));
+}
+
+static inline uint32x4_t s_rot7(uint32x4_t x) {
+    return vorrq_u32(vshrq_n_u32(x, 7), vshlq_n_u32(x, 32 - 7));
+}
+
+static inline void s_g(uint32x4_t *v, size_t a, size_t b, size_t c, size_t d, uint32x4_t x, uint32x4_t y) {
+    v[a] = vaddq_u32(vaddq_u32(v[a], v[b]), x);
+    v[d] = s_rot16(veorq_u32(v[d], v[a]));
+    v[c] = vaddq_u32(v[c], v[d]);
+    v[b] = s_rot12(veorq_u32(v[b], v[c]));
+    v[a] = vaddq_u32(vaddq_u32(v[a], v[b]), y);
+    v[d] = s_rot8(veorq_u32(v[d], v[a]));
+    v[c] = vaddq_u32(v[c], v[d]);
+    v[b] = s_rot7(veorq_u32(v[b], v[c]));
+}
+
+/* rows[i] holds words 0-3 of row i on the way in, and word i of rows 0-3 on the way out. */
+static inline void s_transpose4(uint32x4_t rows[4]) {
+    uint32x4x2_t rows_01 = vtrnq_u32(rows[0], rows[1]);
+    uint32x4x2_t rows_23 = vtrnq_u32(rows[2], rows[3]);
+
+    rows[0] = vcombine_u32(vget_low_u32(rows_01.val[0]), vget_low_u32(rows_23.val[0]));
+    rows[1] = vcombine_u32(vget_low_u32(rows_01.val[1]), vget_low_u32(rows_23.val[1]));
+    rows[2] = vcombine_u32(vget_high_u32(rows_01.val[0]), vget_high_u32(rows_23.val[0]));
+    rows[3] = vcombine_u32(vget_high_u32(rows_01.val[1]), vget_high_u32(rows_23.val[1]));
+}
+
+void aws_blake3_hash4_arm(
+    const uint8_t *const *inputs,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    bool increment_counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t *out) {
+
+    uint32x4_t h[8];
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = vdupq_n_u32(key[i]);
+    }
+
+    uint32_t counter_low_words[4];
+    uint32_t counter_high_words[4];
+    for (size_t i = 0; i < 4; ++i) {
+        uint64_t lane_counter = counter + (increment_counter ? i : 0);
+        counter_low_words[i] = (uint32_t)lane_counter;
+        counter_high_words[i] = (uint32_t)(lane_counter >> 32);
+    }
+    const uint32x4_t counter_low = vld1q_u32(counter_low_words);
+    const uint32x4_t counter_high = vld1q_u32(counter_high_words);
+
+    uint8_t block_flags = flags | flags_start;
+
+    for (size_t block = 0; block < block_count; ++block) {
+        if (block + 1 == block_count) {
+            block_flags |= flags_end;
+        }
+
+        /* m[j] is message word j of all 4 inputs. BLAKE3 words are little endian, as is aarch64. */
+        uint32x4_t m[16];
+        size_t block_offset = block * AWS_BLAKE3_BLOCK_LEN;
+        for (size_t group = 0; group < 4; ++group) {
+            for (size_t i = 0; i < 4; ++i) {
+                m[group * 4 + i] = vreinterpretq_u32_u8(vld1q_u8(inputs[i] + block_offset + group * 16));
+            }
+            s_transpose4(&m[group * 4]);
+        }
+
+        uint32x4_t v[16] = {
+            h[0],
+            h[1],
+            h[2],
+            h[3],
+            h[4],
+            h[5],
+            h[6],
+            h[7],
+            vdupq_n_u32(g_aws_blake3_iv[0]),
+            vdupq_n_u32(g_aws_blake3_iv[1]),
+            vdupq_n_u32(g_aws_blake3_iv[2]),
+            vdupq_n_u32(g_aws_blake3_iv[3]),
+            counter_low,
+            counter_high,
+            vdupq_n_u32(AWS_BLAKE3_BLOCK_LEN),
+            vdupq_n_u32(block_flags),
+        };
+
+        for (size_t r = 0; r < 7; ++r) {
+            const uint8_t *s = g_aws_blake3_msg_schedule[r];
+            s_g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            s_g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            s_g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            s_g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            s_g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            s_g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            s_g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            s_g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            h[i] = veorq_u32(v[i], v[i + 8]);
+        }
+
+        block_flags = flags;
+    }
+
+    /* transposing back gives each lane's CV as two consecutive vectors */
+    s_transpose4(&h[0]);
+    s_transpose4(&h[4]);
+    for (size_t i = 0; i < 4; ++i) {
+        vst1q_u8(out + i * AWS_BLAKE3_OUT_LEN, vreinterpretq_u8_u32(h[i]));
+        vst1q_u8(out + i * AWS_BLAKE3_OUT_LEN + 16, vreinterpretq_u8_u32(h[4 + i]));
+    }
+}
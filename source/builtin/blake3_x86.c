@@ -0,0 +1,146 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/blake3.h>
+
+#include <immintrin.h>
+
+/*
+ * SSE4.1 implementation of the BLAKE3 4-way compression kernel. Each vector holds the same state word of 4
+ * independent inputs, so the rounds are the scalar ones with every operation applied lane-wise. This file is
+ * built with -msse4.1 (see CMakeLists.txt) and is only ever called after blake3.c has confirmed the cpu
+ * supports it.
+ */
+
+static inline __m128i s_rot16(__m128i x) {
+    return _mm_shuffle_epi8(x, _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+
+static inline __m128i s_rot12(__m128i x) {
+    return _mm_or_si128(_mm_srli_epi32(x, 12), _mm_slli_epi32(x, 32 - 12));
+}
+
+static inline __m128i s_rot8(__m128i x) {
+    return _mm_shuffle_epi8(x, _mm_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1));
+}
+
+static inline __m128i s_rot7(__m128i x) {
+    return _mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 32 - 7));
+}
+
+static inline void s_g(__m128i *v, size_t a, size_t b, size_t c, size_t d, __m128i x, __m128i y) {
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), x);
+    v[d] = s_rot16(_mm_xor_si128(v[d], v[a]));
+    v[c] = _mm_add_epi32(v[c], v[d]);
+    v[b] = s_rot12(_mm_xor_si128(v[b], v[c]));
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), y);
+    v[d] = s_rot8(_mm_xor_si128(v[d], v[a]));
+    v[c] = _mm_add_epi32(v[c], v[d]);
+    v[b] = s_rot7(_mm_xor_si128(v[b], v[c]));
+}
+
+/* rows[i] holds words 0-3 of row i on the way in, and word i of rows 0-3 on the way out. */
+static inline void s_transpose4(__m128i rows[4]) {
+    __m128i ab_01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+    __m128i ab_23 = _mm_unpackhi_epi32(rows[0], rows[1]);
+    __m128i cd_01 = _mm_unpacklo_epi32(rows[2], rows[3]);
+    __m128i cd_23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+
+    rows[0] = _mm_unpacklo_epi64(ab_01, cd_01);
+    rows[1] = _mm_unpackhi_epi64(ab_01, cd_01);
+    rows[2] = _mm_unpacklo_epi64(ab_23, cd_23);
+    rows[3] = _mm_unpackhi_epi64(ab_23, cd_23);
+}
+
+void aws_blake3_hash4_x86(
+    const uint8_t *const *inputs,
+    size_t block_count,
+    const uint32_t key[8],
+    uint64_t counter,
+    bool increment_counter,
+    uint8_t flags,
+    uint8_t flags_start,
+    uint8_t flags_end,
+    uint8_t *out) {
+
+    __m128i h[8];
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm_set1_epi32((int)key[i]);
+    }
+
+    uint64_t counters[4];
+    for (size_t i = 0; i < 4; ++i) {
+        counters[i] = counter + (increment_counter ? i : 0);
+    }
+    const __m128i counter_low = _mm_setr_epi32(
+        (int)(uint32_t)counters[0], (int)(uint32_t)counters[1], (int)(uint32_t)counters[2], (int)(uint32_t)counters[3]);
+    const __m128i counter_high = _mm_setr_epi32(
+        (int)(uint32_t)(counters[0] >> 32),
+        (int)(uint32_t)(counters[1] >> 32),
+        (int)(uint32_t)(counters[2] >> 32),
+        (int)(uint32_t)(counters[3] >> 32));
+
+    uint8_t block_flags = flags | flags_start;
+
+    for (size_t block = 0; block < block_count; ++block) {
+        if (block + 1 == block_count) {
+            block_flags |= flags_end;
+        }
+
+        /* m[j] is message word j of all 4 inputs */
+        __m128i m[16];
+        size_t block_offset = block * AWS_BLAKE3_BLOCK_LEN;
+        for (size_t group = 0; group < 4; ++group) {
+            for (size_t i = 0; i < 4; ++i) {
+                m[group * 4 + i] = _mm_loadu_si128((const __m128i *)(inputs[i] + block_offset + group * 16));
+            }
+            s_transpose4(&m[group * 4]);
+        }
+
+        __m128i v[16] = {
+            h[0],
+            h[1],
+            h[2],
+            h[3],
+            h[4],
+            h[5],
+            h[6],
+            h[7],
+            _mm_set1_epi32((int)g_aws_blake3_iv[0]),
+            _mm_set1_epi32((int)g_aws_blake3_iv[1]),
+            _mm_set1_epi32((int)g_aws_blake3_iv[2]),
+            _mm_set1_epi32((int)g_aws_blake3_iv[3]),
+            counter_low,
+            counter_high,
+            _mm_set1_epi32(AWS_BLAKE3_BLOCK_LEN),
+            _mm_set1_epi32((int)block_flags),
+        };
+
+        for (size_t r = 0; r < 7; ++r) {
+            const uint8_t *s = g_aws_blake3_msg_schedule[r];
+            s_g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            s_g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            s_g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            s_g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            s_g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            s_g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            s_g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            s_g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            h[i] = _mm_xor_si128(v[i], v[i + 8]);
+        }
+
+        block_flags = flags;
+    }
+
+    /* transposing back gives each lane's CV as two consecutive vectors */
+    s_transpose4(&h[0]);
+    s_transpose4(&h[4]);
+    for (size_t i = 0; i < 4; ++i) {
+        _mm_storeu_si128((__m128i *)(out + i * AWS_BLAKE3_OUT_LEN), h[i]);
+        _mm_storeu_si128((__m128i *)(out + i * AWS_BLAKE3_OUT_LEN + 16), h[4 + i]);
+    }
+}
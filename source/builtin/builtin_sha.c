@@ -0,0 +1,526 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/hash.h>
+#include <aws/cal/private/builtin_sha.h>
+#include <aws/cal/private/cpu_features.h>
+
+#include <aws/common/encoding.h>
+#include <aws/common/thread.h>
+
+const uint32_t g_aws_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t s_sha256_initial_state[8] = {
+    0x6a09e667,
+    0xbb67ae85,
+    0x3c6ef372,
+    0xa54ff53a,
+    0x510e527f,
+    0x9b05688c,
+    0x1f83d9ab,
+    0x5be0cd19,
+};
+
+static const uint32_t s_sha1_initial_state[5] = {
+    0x67452301,
+    0xefcdab89,
+    0x98badcfe,
+    0x10325476,
+    0xc3d2e1f0,
+};
+
+static inline uint32_t s_rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t s_rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+static void s_sha256_compress_generic(uint32_t *state, const uint8_t *blocks, size_t block_count) {
+    uint32_t w[64];
+
+    for (size_t block = 0; block < block_count; ++block, blocks += AWS_SHA_BLOCK_LEN) {
+        for (size_t i = 0; i < 16; ++i) {
+            w[i] = aws_read_u32(blocks + i * 4);
+        }
+
+        for (size_t i = 16; i < 64; ++i) {
+            uint32_t s0 = s_rotr(w[i - 15], 7) ^ s_rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = s_rotr(w[i - 2], 17) ^ s_rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        uint32_t f = state[5];
+        uint32_t g = state[6];
+        uint32_t h = state[7];
+
+        for (size_t i = 0; i < 64; ++i) {
+            uint32_t s1 = s_rotr(e, 6) ^ s_rotr(e, 11) ^ s_rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + ch + g_aws_sha256_k[i] + w[i];
+            uint32_t s0 = s_rotr(a, 2) ^ s_rotr(a, 13) ^ s_rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+static void s_sha1_compress_generic(uint32_t *state, const uint8_t *blocks, size_t block_count) {
+    uint32_t w[80];
+
+    for (size_t block = 0; block < block_count; ++block, blocks += AWS_SHA_BLOCK_LEN) {
+        for (size_t i = 0; i < 16; ++i) {
+            w[i] = aws_read_u32(blocks + i * 4);
+        }
+
+        for (size_t i = 16; i < 80; ++i) {
+            w[i] = s_rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+
+        for (size_t i = 0; i < 80; ++i) {
+            uint32_t f = 0;
+            uint32_t k = 0;
+
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5a827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8f1bbcdc;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+
+            uint32_t temp = s_rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = s_rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+static aws_sha_compress_fn *s_sha256_compress_fn = s_sha256_compress_generic;
+static aws_sha_compress_fn *s_sha1_compress_fn = s_sha1_compress_generic;
+static aws_thread_once s_compress_fn_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+/* the portable rounds already keep the cpu busy, there's nothing for a second message to fill in */
+static void s_sha256_compress_x2_serial(
+    uint32_t *state_a,
+    const uint8_t *blocks_a,
+    uint32_t *state_b,
+    const uint8_t *blocks_b,
+    size_t block_count) {
+    s_sha256_compress_fn(state_a, blocks_a, block_count);
+    s_sha256_compress_fn(state_b, blocks_b, block_count);
+}
+
+static aws_sha256_compress_x2_fn *s_sha256_compress_x2_fn = s_sha256_compress_x2_serial;
+
+/* false when this build has no accelerated compression functions, or the cpu can't run them */
+static bool s_select_accelerated_fns(void) {
+#if defined(AWS_CAL_BUILTIN_SHA_X86)
+    if (aws_cal_get_cpu_features()->sha_ni) {
+        s_sha256_compress_fn = aws_sha256_compress_x86;
+        s_sha256_compress_x2_fn = aws_sha256_compress_x2_x86;
+        s_sha1_compress_fn = aws_sha1_compress_x86;
+        return true;
+    }
+#elif defined(AWS_CAL_BUILTIN_SHA_ARM)
+    if (aws_cal_get_cpu_features()->armv8_sha) {
+        s_sha256_compress_fn = aws_sha256_compress_arm;
+        s_sha1_compress_fn = aws_sha1_compress_arm;
+        return true;
+    }
+#endif
+    return false;
+}
+
+static void s_select_compress_fns(void *user_data) {
+    (void)user_data;
+    s_select_accelerated_fns();
+}
+
+int aws_sha_builtin_force_impl(enum aws_sha_builtin_impl impl) {
+    /* so the once can't overwrite the choice later */
+    aws_thread_call_once(&s_compress_fn_once, s_select_compress_fns, NULL);
+
+    s_sha256_compress_fn = s_sha256_compress_generic;
+    s_sha256_compress_x2_fn = s_sha256_compress_x2_serial;
+    s_sha1_compress_fn = s_sha1_compress_generic;
+
+    switch (impl) {
+        case AWS_SHA_BUILTIN_IMPL_DETECT:
+            s_select_accelerated_fns();
+            return AWS_OP_SUCCESS;
+        case AWS_SHA_BUILTIN_IMPL_PORTABLE:
+            return AWS_OP_SUCCESS;
+        case AWS_SHA_BUILTIN_IMPL_ACCELERATED:
+            if (s_select_accelerated_fns()) {
+                return AWS_OP_SUCCESS;
+            }
+            return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+}
+
+static void s_destroy(struct aws_hash *hash);
+static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
+static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_reset(struct aws_hash *hash);
+static int s_export_state(const struct aws_hash *hash, struct aws_hash_md_state *state);
+static int s_import_state(struct aws_hash *hash, const struct aws_hash_md_state *state);
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
+
+static struct aws_hash_vtable s_sha256_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .export_state = s_export_state,
+    .import_state = s_import_state,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA256",
+    .provider = "aws-c-cal builtin",
+};
+
+static struct aws_hash_vtable s_sha1_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .export_state = s_export_state,
+    .import_state = s_import_state,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA1",
+    .provider = "aws-c-cal builtin",
+};
+
+struct builtin_sha_hash {
+    struct aws_hash hash;
+    aws_sha_compress_fn *compress_fn;
+    const uint32_t *initial_state;
+    size_t state_words;
+    uint32_t state[8];
+    uint64_t message_len;
+    uint8_t block[AWS_SHA_BLOCK_LEN];
+    size_t block_len;
+};
+
+static struct aws_hash *s_builtin_sha_new(
+    struct aws_allocator *allocator,
+    struct aws_hash_vtable *vtable,
+    size_t digest_size,
+    aws_sha_compress_fn *compress_fn,
+    const uint32_t *initial_state) {
+
+    struct builtin_sha_hash *sha_hash = aws_mem_calloc(allocator, 1, sizeof(struct builtin_sha_hash));
+
+    if (!sha_hash) {
+        return NULL;
+    }
+
+    sha_hash->hash.allocator = allocator;
+    sha_hash->hash.vtable = vtable;
+    sha_hash->hash.impl = sha_hash;
+    sha_hash->hash.digest_size = digest_size;
+    sha_hash->compress_fn = compress_fn;
+    sha_hash->initial_state = initial_state;
+    sha_hash->state_words = digest_size / sizeof(uint32_t);
+
+    s_reset(&sha_hash->hash);
+    return &sha_hash->hash;
+}
+
+struct aws_hash *aws_sha256_builtin_new(struct aws_allocator *allocator) {
+    aws_thread_call_once(&s_compress_fn_once, s_select_compress_fns, NULL);
+    return s_builtin_sha_new(allocator, &s_sha256_vtable, AWS_SHA256_LEN, s_sha256_compress_fn, s_sha256_initial_state);
+}
+
+struct aws_hash *aws_sha1_builtin_new(struct aws_allocator *allocator) {
+    aws_thread_call_once(&s_compress_fn_once, s_select_compress_fns, NULL);
+    return s_builtin_sha_new(allocator, &s_sha1_vtable, AWS_SHA1_LEN, s_sha1_compress_fn, s_sha1_initial_state);
+}
+
+static void s_destroy(struct aws_hash *hash) {
+    struct builtin_sha_hash *ctx = hash->impl;
+    aws_mem_release(hash->allocator, ctx);
+}
+
+static int s_reset(struct aws_hash *hash) {
+    struct builtin_sha_hash *ctx = hash->impl;
+
+    memcpy(ctx->state, ctx->initial_state, ctx->state_words * sizeof(uint32_t));
+    ctx->message_len = 0;
+    ctx->block_len = 0;
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct builtin_sha_hash *ctx = hash->impl;
+    struct aws_byte_cursor input = *to_hash;
+
+    if (input.len == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    ctx->message_len += input.len;
+
+    /* top off a partially filled block first */
+    if (ctx->block_len > 0) {
+        size_t to_copy = aws_min_size(AWS_SHA_BLOCK_LEN - ctx->block_len, input.len);
+        memcpy(ctx->block + ctx->block_len, input.ptr, to_copy);
+        ctx->block_len += to_copy;
+        aws_byte_cursor_advance(&input, to_copy);
+
+        if (ctx->block_len < AWS_SHA_BLOCK_LEN) {
+            return AWS_OP_SUCCESS;
+        }
+
+        ctx->compress_fn(ctx->state, ctx->block, 1);
+        ctx->block_len = 0;
+    }
+
+    /* then hash every whole block straight out of the caller's memory */
+    size_t block_count = input.len / AWS_SHA_BLOCK_LEN;
+    if (block_count > 0) {
+        ctx->compress_fn(ctx->state, input.ptr, block_count);
+        aws_byte_cursor_advance(&input, block_count * AWS_SHA_BLOCK_LEN);
+    }
+
+    if (input.len > 0) {
+        memcpy(ctx->block, input.ptr, input.len);
+        ctx->block_len = input.len;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct builtin_sha_hash *ctx = hash->impl;
+
+    size_t buffer_len = output->capacity - output->len;
+
+    if (buffer_len < hash->digest_size) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    /* both algorithms pad with a single 1 bit, then zeroes up to the big-endian 64 bit message length in bits */
+    uint64_t bit_len = ctx->message_len * 8;
+    ctx->block[ctx->block_len++] = 0x80;
+
+    if (ctx->block_len > AWS_SHA_BLOCK_LEN - sizeof(uint64_t)) {
+        memset(ctx->block + ctx->block_len, 0, AWS_SHA_BLOCK_LEN - ctx->block_len);
+        ctx->compress_fn(ctx->state, ctx->block, 1);
+        ctx->block_len = 0;
+    }
+
+    memset(ctx->block + ctx->block_len, 0, AWS_SHA_BLOCK_LEN - sizeof(uint64_t) - ctx->block_len);
+    aws_write_u64(bit_len, ctx->block + AWS_SHA_BLOCK_LEN - sizeof(uint64_t));
+    ctx->compress_fn(ctx->state, ctx->block, 1);
+
+    for (size_t i = 0; i < ctx->state_words; ++i) {
+        aws_write_u32(ctx->state[i], output->buffer + output->len + i * sizeof(uint32_t));
+    }
+
+    output->len += hash->digest_size;
+    hash->good = false;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_export_state(const struct aws_hash *hash, struct aws_hash_md_state *state) {
+    const struct builtin_sha_hash *ctx = hash->impl;
+
+    memcpy(state->chaining_values, ctx->state, ctx->state_words * sizeof(uint32_t));
+    state->message_len = ctx->message_len;
+    memcpy(state->buffered, ctx->block, ctx->block_len);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_import_state(struct aws_hash *hash, const struct aws_hash_md_state *state) {
+    struct builtin_sha_hash *ctx = hash->impl;
+
+    memcpy(ctx->state, state->chaining_values, ctx->state_words * sizeof(uint32_t));
+    ctx->message_len = state->message_len;
+    ctx->block_len = (size_t)(state->message_len % AWS_SHA_BLOCK_LEN);
+    memcpy(ctx->block, state->buffered, ctx->block_len);
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    struct builtin_sha_hash *copy = aws_mem_acquire(allocator, sizeof(struct builtin_sha_hash));
+
+    if (!copy) {
+        return NULL;
+    }
+
+    /* the compress function and initial state are shared, everything else is held by value */
+    *copy = *(const struct builtin_sha_hash *)hash->impl;
+    copy->hash.allocator = allocator;
+    copy->hash.impl = copy;
+
+    return &copy->hash;
+}
+
+/*
+ * One message of a batch. Its whole blocks are hashed straight from the input, then the one or two blocks holding its
+ * padded tail, so blocks and block_count always describe whichever run is up next.
+ */
+struct sha256_batch_lane {
+    uint32_t state[8];
+    const uint8_t *blocks;
+    size_t block_count;
+    uint8_t tail[2 * AWS_SHA_BLOCK_LEN];
+    size_t tail_block_count;
+};
+
+static void s_batch_lane_consume(struct sha256_batch_lane *lane, size_t block_count) {
+    if (block_count) {
+        lane->blocks += block_count * AWS_SHA_BLOCK_LEN;
+        lane->block_count -= block_count;
+    }
+
+    if (!lane->block_count && lane->tail_block_count) {
+        lane->blocks = lane->tail;
+        lane->block_count = lane->tail_block_count;
+        lane->tail_block_count = 0;
+    }
+}
+
+static void s_batch_lane_init(struct sha256_batch_lane *lane, const struct aws_byte_cursor *input) {
+    memcpy(lane->state, s_sha256_initial_state, sizeof(lane->state));
+    lane->blocks = input->ptr;
+    lane->block_count = input->len / AWS_SHA_BLOCK_LEN;
+
+    /* the same padding s_finalize() writes */
+    size_t tail_len = input->len % AWS_SHA_BLOCK_LEN;
+    lane->tail_block_count = tail_len < AWS_SHA_BLOCK_LEN - sizeof(uint64_t) ? 1 : 2;
+    size_t tail_size = lane->tail_block_count * AWS_SHA_BLOCK_LEN;
+
+    memset(lane->tail, 0, tail_size);
+    if (tail_len) {
+        memcpy(lane->tail, input->ptr + input->len - tail_len, tail_len);
+    }
+    lane->tail[tail_len] = 0x80;
+    aws_write_u64((uint64_t)input->len * 8, lane->tail + tail_size - sizeof(uint64_t));
+
+    s_batch_lane_consume(lane, 0);
+}
+
+/*
+ * Hashes the messages two at a time, padding blocks included, for as long as both have blocks left. Whichever runs
+ * longer finishes alone. Output space has already been checked by aws_sha256_compute_batch().
+ */
+int aws_sha256_builtin_compute_batch(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to) {
+    (void)allocator;
+
+    aws_thread_call_once(&s_compress_fn_once, s_select_compress_fns, NULL);
+
+    size_t digest_len = truncate_to && truncate_to < AWS_SHA256_LEN ? truncate_to : AWS_SHA256_LEN;
+    struct sha256_batch_lane lanes[2];
+
+    for (size_t first = 0; first < count; first += AWS_ARRAY_SIZE(lanes)) {
+        size_t lane_count = count - first < AWS_ARRAY_SIZE(lanes) ? count - first : AWS_ARRAY_SIZE(lanes);
+
+        for (size_t i = 0; i < lane_count; ++i) {
+            s_batch_lane_init(&lanes[i], &inputs[first + i]);
+        }
+
+        if (lane_count == 2) {
+            while (lanes[0].block_count && lanes[1].block_count) {
+                size_t block_count = aws_min_size(lanes[0].block_count, lanes[1].block_count);
+                s_sha256_compress_x2_fn(lanes[0].state, lanes[0].blocks, lanes[1].state, lanes[1].blocks, block_count);
+                s_batch_lane_consume(&lanes[0], block_count);
+                s_batch_lane_consume(&lanes[1], block_count);
+            }
+        }
+
+        for (size_t i = 0; i < lane_count; ++i) {
+            struct sha256_batch_lane *lane = &lanes[i];
+            while (lane->block_count) {
+                size_t block_count = lane->block_count;
+                s_sha256_compress_fn(lane->state, lane->blocks, block_count);
+                s_batch_lane_consume(lane, block_count);
+            }
+
+            /* a truncated digest goes through a copy, so nothing is written past it */
+            uint8_t digest[AWS_SHA256_LEN];
+            for (size_t word = 0; word < AWS_ARRAY_SIZE(lane->state); ++word) {
+                aws_write_u32(lane->state[word], digest + word * sizeof(uint32_t));
+            }
+
+            struct aws_byte_buf *output = &outputs[first + i];
+            memcpy(output->buffer + output->len, digest, digest_len);
+            output->len += digest_len;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/builtin_sha.h>
+
+#if defined(_MSC_VER)
+#    include <arm64_neon.h>
+#else
+#    include <arm_neon.h>
+#endif
+
+/*
+ * ARMv8 crypto extension implementations of the sha1 and sha256 compression functions. This file is
+ * built with -march=armv8-a+crypto (see CMakeLists.txt) and is only ever called after builtin_sha.c
+ * has confirmed the cpu supports those extensions.
+ */
+
+static inline uint32x4_t s_load_be_words(const uint8_t *src) {
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(src)));
+}
+
+void aws_sha256_compress_arm(uint32_t *state, const uint8_t *blocks, size_t block_count) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+
+    for (size_t block = 0; block < block_count; ++block, blocks += AWS_SHA_BLOCK_LEN) {
+        const uint32x4_t abcd_save = state0;
+        const uint32x4_t efgh_save = state1;
+
+        /* message schedule ring, msg[i & 3] holds words 4i..4i+3 until they are overwritten 4 groups later */
+        uint32x4_t msg[4];
+
+        for (size_t i = 0; i < 16; ++i) {
+            if (i < 4) {
+                msg[i] = s_load_be_words(blocks + i * 16);
+            } else {
+                msg[i & 3] = vsha256su1q_u32(
+                    vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]), msg[(i + 2) & 3], msg[(i + 3) & 3]);
+            }
+
+            uint32x4_t wk = vaddq_u32(msg[i & 3], vld1q_u32(&g_aws_sha256_k[i * 4]));
+            uint32x4_t abcd = state0;
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, abcd, wk);
+        }
+
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+void aws_sha1_compress_arm(uint32_t *state, const uint8_t *blocks, size_t block_count) {
+    static const uint32_t s_round_constants[4] = {0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6};
+
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e0 = state[4];
+
+    for (size_t block = 0; block < block_count; ++block, blocks += AWS_SHA_BLOCK_LEN) {
+        const uint32x4_t abcd_save = abcd;
+        const uint32_t e0_save = e0;
+
+        uint32x4_t msg[4];
+        uint32_t e = e0;
+
+        for (size_t i = 0; i < 20; ++i) {
+            if (i < 4) {
+                msg[i] = s_load_be_words(blocks + i * 16);
+            } else {
+                msg[i & 3] =
+                    vsha1su1q_u32(vsha1su0q_u32(msg[i & 3], msg[(i + 1) & 3], msg[(i + 2) & 3]), msg[(i + 3) & 3]);
+            }
+
+            uint32x4_t wk = vaddq_u32(msg[i & 3], vdupq_n_u32(s_round_constants[i / 5]));
+            uint32_t e_next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+            if (i < 5) {
+                abcd = vsha1cq_u32(abcd, e, wk);
+            } else if (i >= 10 && i < 15) {
+                abcd = vsha1mq_u32(abcd, e, wk);
+            } else {
+                abcd = vsha1pq_u32(abcd, e, wk);
+            }
+
+            e = e_next;
+        }
+
+        e0 = e + e0_save;
+        abcd = vaddq_u32(abcd, abcd_save);
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e0;
+}
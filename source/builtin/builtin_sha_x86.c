@@ -0,0 +1,171 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/builtin_sha.h>
+
+#include <immintrin.h>
+
+/*
+ * SHA-NI implementations of the sha1 and sha256 compression functions. This file is built with
+ * -msha -msse4.1 (see CMakeLists.txt) and is only ever called after builtin_sha.c has confirmed
+ * the cpu supports those extensions.
+ */
+
+/* the sha256rnds2 instruction wants the state split as ABEF and CDGH */
+static inline void s_sha256_load_state(const uint32_t *state, __m128i *abef, __m128i *cdgh) {
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+    *abef = _mm_alignr_epi8(tmp, state1, 8);
+    *cdgh = _mm_blend_epi16(state1, tmp, 0xF0);
+}
+
+static inline void s_sha256_store_state(uint32_t *state, __m128i abef, __m128i cdgh) {
+    __m128i tmp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xF0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+void aws_sha256_compress_x86(uint32_t *state, const uint8_t *blocks, size_t block_count) {
+    const __m128i byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i state0;
+    __m128i state1;
+    s_sha256_load_state(state, &state0, &state1);
+
+    for (size_t block = 0; block < block_count; ++block, blocks += AWS_SHA_BLOCK_LEN) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+
+        /* message schedule ring, msg[i & 3] holds words 4i..4i+3 until they are overwritten 4 groups later */
+        __m128i msg[4];
+
+        for (size_t i = 0; i < 16; ++i) {
+            if (i < 4) {
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks + i * 16)), byte_swap_mask);
+            } else {
+                __m128i next = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+                msg[i & 3] = _mm_sha256msg2_epu32(next, msg[(i + 3) & 3]);
+            }
+
+            __m128i wk = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *)&g_aws_sha256_k[i * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            wk = _mm_shuffle_epi32(wk, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    s_sha256_store_state(state, state0, state1);
+}
+
+/*
+ * Same rounds as aws_sha256_compress_x86(), for two independent messages at once. Each sha256rnds2 depends on the one
+ * before it, so a single message leaves the unit waiting on that latency. Interleaving a second message's rounds
+ * fills those gaps.
+ */
+void aws_sha256_compress_x2_x86(
+    uint32_t *state_a,
+    const uint8_t *blocks_a,
+    uint32_t *state_b,
+    const uint8_t *blocks_b,
+    size_t block_count) {
+    const __m128i byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i state0_a;
+    __m128i state1_a;
+    __m128i state0_b;
+    __m128i state1_b;
+    s_sha256_load_state(state_a, &state0_a, &state1_a);
+    s_sha256_load_state(state_b, &state0_b, &state1_b);
+
+    for (size_t block = 0; block < block_count; ++block, blocks_a += AWS_SHA_BLOCK_LEN, blocks_b += AWS_SHA_BLOCK_LEN) {
+        const __m128i abef_save_a = state0_a;
+        const __m128i cdgh_save_a = state1_a;
+        const __m128i abef_save_b = state0_b;
+        const __m128i cdgh_save_b = state1_b;
+
+        __m128i msg_a[4];
+        __m128i msg_b[4];
+
+        for (size_t i = 0; i < 16; ++i) {
+            if (i < 4) {
+                msg_a[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks_a + i * 16)), byte_swap_mask);
+                msg_b[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks_b + i * 16)), byte_swap_mask);
+            } else {
+                __m128i next_a = _mm_sha256msg1_epu32(msg_a[i & 3], msg_a[(i + 1) & 3]);
+                __m128i next_b = _mm_sha256msg1_epu32(msg_b[i & 3], msg_b[(i + 1) & 3]);
+                next_a = _mm_add_epi32(next_a, _mm_alignr_epi8(msg_a[(i + 3) & 3], msg_a[(i + 2) & 3], 4));
+                next_b = _mm_add_epi32(next_b, _mm_alignr_epi8(msg_b[(i + 3) & 3], msg_b[(i + 2) & 3], 4));
+                msg_a[i & 3] = _mm_sha256msg2_epu32(next_a, msg_a[(i + 3) & 3]);
+                msg_b[i & 3] = _mm_sha256msg2_epu32(next_b, msg_b[(i + 3) & 3]);
+            }
+
+            const __m128i k = _mm_loadu_si128((const __m128i *)&g_aws_sha256_k[i * 4]);
+            __m128i wk_a = _mm_add_epi32(msg_a[i & 3], k);
+            __m128i wk_b = _mm_add_epi32(msg_b[i & 3], k);
+            state1_a = _mm_sha256rnds2_epu32(state1_a, state0_a, wk_a);
+            state1_b = _mm_sha256rnds2_epu32(state1_b, state0_b, wk_b);
+            wk_a = _mm_shuffle_epi32(wk_a, 0x0E);
+            wk_b = _mm_shuffle_epi32(wk_b, 0x0E);
+            state0_a = _mm_sha256rnds2_epu32(state0_a, state1_a, wk_a);
+            state0_b = _mm_sha256rnds2_epu32(state0_b, state1_b, wk_b);
+        }
+
+        state0_a = _mm_add_epi32(state0_a, abef_save_a);
+        state1_a = _mm_add_epi32(state1_a, cdgh_save_a);
+        state0_b = _mm_add_epi32(state0_b, abef_save_b);
+        state1_b = _mm_add_epi32(state1_b, cdgh_save_b);
+    }
+
+    s_sha256_store_state(state_a, state0_a, state1_a);
+    s_sha256_store_state(state_b, state0_b, state1_b);
+}
+
+/* sha1rnds4 takes the round function as an immediate, so each group of 20 rounds is stamped out separately. */
+#define S_SHA1_ROUNDS_20(first_group, round_fn)                                                                        \
+    for (size_t i = (first_group); i < (first_group) + 5; ++i) {                                                       \
+        if (i >= 4) {                                                                                                  \
+            __m128i next = _mm_sha1msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);                                           \
+            next = _mm_xor_si128(next, msg[(i + 2) & 3]);                                                              \
+            msg[i & 3] = _mm_sha1msg2_epu32(next, msg[(i + 3) & 3]);                                                   \
+        }                                                                                                              \
+        e = i == 0 ? _mm_add_epi32(e, msg[0]) : _mm_sha1nexte_epu32(e, msg[i & 3]);                                    \
+        __m128i abcd_in = abcd;                                                                                        \
+        abcd = _mm_sha1rnds4_epu32(abcd, e, round_fn);                                                                 \
+        e = abcd_in;                                                                                                   \
+    }
+
+void aws_sha1_compress_x86(uint32_t *state, const uint8_t *blocks, size_t block_count) {
+    const __m128i byte_swap_mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1B);
+    __m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    for (size_t block = 0; block < block_count; ++block, blocks += AWS_SHA_BLOCK_LEN) {
+        const __m128i abcd_save = abcd;
+        const __m128i e0_save = e0;
+
+        __m128i msg[4];
+        for (size_t i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks + i * 16)), byte_swap_mask);
+        }
+
+        __m128i e = e0;
+        S_SHA1_ROUNDS_20(0, 0)
+        S_SHA1_ROUNDS_20(5, 1)
+        S_SHA1_ROUNDS_20(10, 2)
+        S_SHA1_ROUNDS_20(15, 3)
+
+        e0 = _mm_sha1nexte_epu32(e, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+    _mm_storeu_si128((__m128i *)state, abcd);
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
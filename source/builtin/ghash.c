@@ -0,0 +1,181 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/ghash.h>
+
+#include <aws/common/cpuid.h>
+#include <aws/common/encoding.h>
+#include <aws/common/thread.h>
+
+/*
+ * Portable GHASH after BearSSL's ctmul64. A carry-less 64x64 multiply is done with ordinary integer multiplies on
+ * operands that have every 4th bit kept, which leaves 3 bit holes for the carries to land in, so it takes no branches
+ * and no lookups on secret data. GHASH's bit order is reflected, so each 128x128 product is Karatsuba over the
+ * bit-reversed halves as well, and the 256 bit result is then reduced modulo x^128 + x^7 + x^2 + x + 1.
+ */
+
+static uint64_t s_bmul64(uint64_t x, uint64_t y) {
+    uint64_t x0 = x & UINT64_C(0x1111111111111111);
+    uint64_t x1 = x & UINT64_C(0x2222222222222222);
+    uint64_t x2 = x & UINT64_C(0x4444444444444444);
+    uint64_t x3 = x & UINT64_C(0x8888888888888888);
+    uint64_t y0 = y & UINT64_C(0x1111111111111111);
+    uint64_t y1 = y & UINT64_C(0x2222222222222222);
+    uint64_t y2 = y & UINT64_C(0x4444444444444444);
+    uint64_t y3 = y & UINT64_C(0x8888888888888888);
+
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+    z0 &= UINT64_C(0x1111111111111111);
+    z1 &= UINT64_C(0x2222222222222222);
+    z2 &= UINT64_C(0x4444444444444444);
+    z3 &= UINT64_C(0x8888888888888888);
+    return z0 | z1 | z2 | z3;
+}
+
+static uint64_t s_rev64(uint64_t x) {
+    x = ((x & UINT64_C(0x5555555555555555)) << 1) | ((x >> 1) & UINT64_C(0x5555555555555555));
+    x = ((x & UINT64_C(0x3333333333333333)) << 2) | ((x >> 2) & UINT64_C(0x3333333333333333));
+    x = ((x & UINT64_C(0x0F0F0F0F0F0F0F0F)) << 4) | ((x >> 4) & UINT64_C(0x0F0F0F0F0F0F0F0F));
+    x = ((x & UINT64_C(0x00FF00FF00FF00FF)) << 8) | ((x >> 8) & UINT64_C(0x00FF00FF00FF00FF));
+    x = ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16) | ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF));
+    return (x << 32) | (x >> 32);
+}
+
+/* H split into the halves, and their bit reversals, that every multiply by it uses. */
+struct ghash_operand {
+    uint64_t h0;
+    uint64_t h1;
+    uint64_t h2;
+    uint64_t h0r;
+    uint64_t h1r;
+    uint64_t h2r;
+};
+
+static void s_operand_init(struct ghash_operand *operand, const uint8_t h[AWS_GHASH_BLOCK_LEN]) {
+    operand->h1 = aws_read_u64(h);
+    operand->h0 = aws_read_u64(h + 8);
+    operand->h0r = s_rev64(operand->h0);
+    operand->h1r = s_rev64(operand->h1);
+    operand->h2 = operand->h0 ^ operand->h1;
+    operand->h2r = operand->h0r ^ operand->h1r;
+}
+
+/* (y1 || y0) = (y1 || y0) * H */
+static void s_mul(uint64_t *y1, uint64_t *y0, const struct ghash_operand *h) {
+    uint64_t y2 = *y0 ^ *y1;
+    uint64_t y0r = s_rev64(*y0);
+    uint64_t y1r = s_rev64(*y1);
+    uint64_t y2r = y0r ^ y1r;
+
+    uint64_t z0 = s_bmul64(*y0, h->h0);
+    uint64_t z1 = s_bmul64(*y1, h->h1);
+    uint64_t z2 = s_bmul64(y2, h->h2);
+    uint64_t z0h = s_bmul64(y0r, h->h0r);
+    uint64_t z1h = s_bmul64(y1r, h->h1r);
+    uint64_t z2h = s_bmul64(y2r, h->h2r);
+    z2 ^= z0 ^ z1;
+    z2h ^= z0h ^ z1h;
+    z0h = s_rev64(z0h) >> 1;
+    z1h = s_rev64(z1h) >> 1;
+    z2h = s_rev64(z2h) >> 1;
+
+    uint64_t v0 = z0;
+    uint64_t v1 = z0h ^ z2;
+    uint64_t v2 = z1 ^ z2h;
+    uint64_t v3 = z1h;
+
+    v3 = (v3 << 1) | (v2 >> 63);
+    v2 = (v2 << 1) | (v1 >> 63);
+    v1 = (v1 << 1) | (v0 >> 63);
+    v0 = (v0 << 1);
+
+    v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+    v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+    v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+    v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+    *y0 = v2;
+    *y1 = v3;
+}
+
+static void s_ghash_portable(
+    const struct aws_ghash_key *key,
+    uint8_t y[AWS_GHASH_BLOCK_LEN],
+    const uint8_t *blocks,
+    size_t block_count) {
+
+    struct ghash_operand h;
+    s_operand_init(&h, key->h_powers[0]);
+
+    uint64_t y1 = aws_read_u64(y);
+    uint64_t y0 = aws_read_u64(y + 8);
+    for (size_t i = 0; i < block_count; ++i, blocks += AWS_GHASH_BLOCK_LEN) {
+        y1 ^= aws_read_u64(blocks);
+        y0 ^= aws_read_u64(blocks + 8);
+        s_mul(&y1, &y0, &h);
+    }
+
+    aws_write_u64(y1, y);
+    aws_write_u64(y0, y + 8);
+    aws_secure_zero(&h, sizeof(h));
+}
+
+typedef void(ghash_blocks_fn)(
+    const struct aws_ghash_key *key,
+    uint8_t y[AWS_GHASH_BLOCK_LEN],
+    const uint8_t *blocks,
+    size_t block_count);
+
+static ghash_blocks_fn *s_ghash_blocks_fn = s_ghash_portable;
+static aws_thread_once s_ghash_blocks_fn_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static void s_select_ghash_blocks_fn(void *user_data) {
+    (void)user_data;
+#if defined(AWS_CAL_GHASH_X86)
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_CLMUL) && aws_cpu_has_feature(AWS_CPU_FEATURE_SSE_4_1)) {
+        s_ghash_blocks_fn = aws_ghash_update_x86;
+    }
+#endif
+}
+
+void aws_ghash_key_init(struct aws_ghash_key *key, const uint8_t h[AWS_GHASH_BLOCK_LEN]) {
+    struct ghash_operand operand;
+    s_operand_init(&operand, h);
+
+    memcpy(key->h_powers[0], h, AWS_GHASH_BLOCK_LEN);
+    uint64_t y1 = aws_read_u64(h);
+    uint64_t y0 = aws_read_u64(h + 8);
+    for (size_t i = 1; i < AWS_GHASH_KEY_POWERS; ++i) {
+        s_mul(&y1, &y0, &operand);
+        aws_write_u64(y1, key->h_powers[i]);
+        aws_write_u64(y0, key->h_powers[i] + 8);
+    }
+
+    aws_secure_zero(&operand, sizeof(operand));
+}
+
+void aws_ghash_update(
+    const struct aws_ghash_key *key,
+    uint8_t y[AWS_GHASH_BLOCK_LEN],
+    const uint8_t *data,
+    size_t len) {
+
+    aws_thread_call_once(&s_ghash_blocks_fn_once, s_select_ghash_blocks_fn, NULL);
+
+    size_t block_count = len / AWS_GHASH_BLOCK_LEN;
+    if (block_count) {
+        s_ghash_blocks_fn(key, y, data, block_count);
+    }
+
+    size_t tail_len = len % AWS_GHASH_BLOCK_LEN;
+    if (tail_len) {
+        uint8_t tail[AWS_GHASH_BLOCK_LEN] = {0};
+        memcpy(tail, data + block_count * AWS_GHASH_BLOCK_LEN, tail_len);
+        s_ghash_blocks_fn(key, y, tail, 1);
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/ghash.h>
+
+#include <immintrin.h>
+
+/*
+ * PCLMULQDQ implementation of GHASH, after Intel's carry-less multiplication white paper. Blocks are byte reversed
+ * on load, the 256 bit product is shifted left by one to undo the reflected bit order, and reduced. Four blocks are
+ * multiplied by H^4..H^1 and summed before a single reduction, since both the shift and the reduction are linear.
+ * This file is built with -mpclmul -msse4.1 (see CMakeLists.txt) and is only ever called after ghash.c has confirmed
+ * the cpu supports them.
+ */
+
+static inline __m128i s_load(const uint8_t *block) {
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)block), reverse);
+}
+
+static inline void s_store(uint8_t *block, __m128i x) {
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    _mm_storeu_si128((__m128i *)block, _mm_shuffle_epi8(x, reverse));
+}
+
+/* (hi || lo) ^= a * b, unreduced */
+static inline void s_clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+    __m128i z0 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i z1 = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    __m128i z2 = _mm_clmulepi64_si128(a, b, 0x11);
+
+    *lo = _mm_xor_si128(*lo, _mm_xor_si128(z0, _mm_slli_si128(z1, 8)));
+    *hi = _mm_xor_si128(*hi, _mm_xor_si128(z2, _mm_srli_si128(z1, 8)));
+}
+
+static inline __m128i s_reduce(__m128i lo, __m128i hi) {
+    /* shift the 256 bit value left by one */
+    __m128i lo_carry = _mm_srli_epi32(lo, 31);
+    __m128i hi_carry = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i cross = _mm_srli_si128(lo_carry, 12);
+    hi_carry = _mm_slli_si128(hi_carry, 4);
+    lo_carry = _mm_slli_si128(lo_carry, 4);
+    lo = _mm_or_si128(lo, lo_carry);
+    hi = _mm_or_si128(_mm_or_si128(hi, hi_carry), cross);
+
+    /* reduce modulo x^128 + x^7 + x^2 + x + 1 */
+    __m128i a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    __m128i b = _mm_srli_si128(a, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(a, 12));
+
+    __m128i c = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    c = _mm_xor_si128(c, b);
+    lo = _mm_xor_si128(lo, c);
+    return _mm_xor_si128(hi, lo);
+}
+
+void aws_ghash_update_x86(
+    const struct aws_ghash_key *key,
+    uint8_t y[AWS_GHASH_BLOCK_LEN],
+    const uint8_t *blocks,
+    size_t block_count) {
+
+    __m128i h1 = s_load(key->h_powers[0]);
+    __m128i h2 = s_load(key->h_powers[1]);
+    __m128i h3 = s_load(key->h_powers[2]);
+    __m128i h4 = s_load(key->h_powers[3]);
+    __m128i acc = s_load(y);
+
+    for (; block_count >= 4; block_count -= 4, blocks += 4 * AWS_GHASH_BLOCK_LEN) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        s_clmul_acc(_mm_xor_si128(acc, s_load(blocks)), h4, &lo, &hi);
+        s_clmul_acc(s_load(blocks + AWS_GHASH_BLOCK_LEN), h3, &lo, &hi);
+        s_clmul_acc(s_load(blocks + 2 * AWS_GHASH_BLOCK_LEN), h2, &lo, &hi);
+        s_clmul_acc(s_load(blocks + 3 * AWS_GHASH_BLOCK_LEN), h1, &lo, &hi);
+        acc = s_reduce(lo, hi);
+    }
+
+    for (; block_count; --block_count, blocks += AWS_GHASH_BLOCK_LEN) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        s_clmul_acc(_mm_xor_si128(acc, s_load(blocks)), h1, &lo, &hi);
+        acc = s_reduce(lo, hi);
+    }
+
+    s_store(y, acc);
+}
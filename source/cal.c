@@ -71,17 +71,38 @@ static struct aws_log_subject_info_list s_cal_log_subject_list = {
 extern void aws_cal_platform_init(struct aws_allocator *allocator);
 extern void aws_cal_platform_clean_up(void);
 extern void aws_cal_platform_thread_clean_up(void);
+extern bool aws_cal_platform_route_libcrypto_allocations(struct aws_allocator *allocator);
 #endif /* BYO_CRYPTO */
 
+extern void aws_hash_thread_clean_up(void);
+extern void aws_cal_stats_init(struct aws_allocator *allocator);
+extern void aws_cal_stats_clean_up(void);
+extern void aws_cal_stats_thread_clean_up(void);
+extern void aws_cal_secure_arena_clean_up(void);
+
 static bool s_cal_library_initialized = false;
 
+/* libcrypto can't be told to stop using the allocator, so this stays set across clean up */
+static bool s_libcrypto_allocations_routed = false;
+
 void aws_cal_library_init(struct aws_allocator *allocator) {
+    aws_cal_library_init_ex(allocator, NULL);
+}
+
+void aws_cal_library_init_ex(struct aws_allocator *allocator, const struct aws_cal_library_options *options) {
     if (!s_cal_library_initialized) {
         aws_common_library_init(allocator);
         aws_register_error_info(&s_list);
         aws_register_log_subject_info_list(&s_cal_log_subject_list);
+        aws_cal_stats_init(allocator);
 #ifndef BYO_CRYPTO
+        /* before libcrypto is resolved, let alone called */
+        if (options && options->libcrypto_allocator && !s_libcrypto_allocations_routed) {
+            s_libcrypto_allocations_routed = aws_cal_platform_route_libcrypto_allocations(options->libcrypto_allocator);
+        }
         aws_cal_platform_init(allocator);
+#else
+        (void)options;
 #endif /* BYO_CRYPTO */
         s_cal_library_initialized = true;
     }
@@ -89,16 +110,25 @@ void aws_cal_library_init(struct aws_allocator *allocator) {
 void aws_cal_library_clean_up(void) {
     if (s_cal_library_initialized) {
         s_cal_library_initialized = false;
+        aws_hash_thread_clean_up();
 #ifndef BYO_CRYPTO
         aws_cal_platform_clean_up();
 #endif /* BYO_CRYPTO */
+        aws_cal_stats_clean_up();
+        aws_cal_secure_arena_clean_up();
         aws_unregister_log_subject_info_list(&s_cal_log_subject_list);
         aws_unregister_error_info(&s_list);
         aws_common_library_clean_up();
     }
 }
 
+bool aws_cal_libcrypto_allocations_routed(void) {
+    return s_libcrypto_allocations_routed;
+}
+
 void aws_cal_thread_clean_up(void) {
+    aws_hash_thread_clean_up();
+    aws_cal_stats_thread_clean_up();
 #ifndef BYO_CRYPTO
     aws_cal_platform_thread_clean_up();
 #endif /* BYO_CRYPTO */
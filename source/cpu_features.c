@@ -0,0 +1,99 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/cpu_features.h>
+
+#include <aws/common/cpuid.h>
+#include <aws/common/thread.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define AWS_CAL_CPU_PROBE_X86
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#    endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define AWS_CAL_CPU_PROBE_ARM
+#    if defined(_WIN32)
+#        include <windows.h>
+#    elif defined(__linux__)
+#        include <asm/hwcap.h>
+#        include <sys/auxv.h>
+#    endif
+#endif
+
+static struct aws_cal_cpu_features s_cpu_features;
+static aws_thread_once s_cpu_features_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+#if defined(AWS_CAL_CPU_PROBE_X86)
+/* leaves the registers zeroed if the leaf is beyond what the cpu reports */
+static void s_cpuid(uint32_t leaf, uint32_t regs[4]) {
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#    if defined(_MSC_VER)
+    int max_leaf[4] = {0};
+    __cpuid(max_leaf, 0);
+    if ((uint32_t)max_leaf[0] < leaf) {
+        return;
+    }
+    int out[4] = {0};
+    __cpuidex(out, (int)leaf, 0);
+    for (size_t i = 0; i < 4; ++i) {
+        regs[i] = (uint32_t)out[i];
+    }
+#    else
+    if (__get_cpuid_max(0, NULL) < leaf) {
+        return;
+    }
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    __cpuid_count(leaf, 0, eax, ebx, ecx, edx);
+    regs[0] = eax;
+    regs[1] = ebx;
+    regs[2] = ecx;
+    regs[3] = edx;
+#    endif
+}
+#endif
+
+static void s_probe_cpu_features(void *user_data) {
+    (void)user_data;
+
+#if defined(AWS_CAL_CPU_PROBE_X86)
+    /*
+     * AES-NI is reported in CPUID.1:ECX[25], PCLMULQDQ in ECX[1], SSSE3 and SSE4.1 in ECX[9] and ECX[19], and SHA-NI
+     * in CPUID.(EAX=7,ECX=0):EBX[29]. These only use the xmm registers, so they need no check for OS support.
+     */
+    uint32_t leaf1[4];
+    uint32_t leaf7[4];
+    s_cpuid(1, leaf1);
+    s_cpuid(7, leaf7);
+    s_cpu_features.aes_ni = (leaf1[2] & (1u << 25)) != 0;
+    s_cpu_features.pclmulqdq = (leaf1[2] & (1u << 1)) != 0;
+    s_cpu_features.sha_ni = (leaf1[2] & (1u << 9)) && (leaf1[2] & (1u << 19)) && (leaf7[1] & (1u << 29));
+    /* AVX2 also needs the OS to save the ymm registers, which aws-c-common already checks */
+    s_cpu_features.avx2 = aws_cpu_has_feature(AWS_CPU_FEATURE_AVX2);
+#elif defined(AWS_CAL_CPU_PROBE_ARM)
+#    if defined(__APPLE__)
+    /* every arm64 apple device has the crypto extensions */
+    s_cpu_features.armv8_aes = true;
+    s_cpu_features.armv8_sha = true;
+#    elif defined(_WIN32)
+    bool has_crypto = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+    s_cpu_features.armv8_aes = has_crypto;
+    s_cpu_features.armv8_sha = has_crypto;
+#    elif defined(__linux__)
+    unsigned long hwcaps = getauxval(AT_HWCAP);
+    s_cpu_features.armv8_aes = (hwcaps & HWCAP_AES) && (hwcaps & HWCAP_PMULL);
+    s_cpu_features.armv8_sha = (hwcaps & HWCAP_SHA1) && (hwcaps & HWCAP_SHA2);
+#    endif
+#endif
+}
+
+const struct aws_cal_cpu_features *aws_cal_get_cpu_features(void) {
+    aws_thread_call_once(&s_cpu_features_once, s_probe_cpu_features, NULL);
+    return &s_cpu_features;
+}
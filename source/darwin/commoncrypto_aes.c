@@ -16,27 +16,64 @@
 #    define USE_LATEST_CRYPTO_API 1
 #endif
 
+/* Creates a cryptor for one direction (kCCEncrypt or kCCDecrypt) from the cipher's key, iv and aad. */
+typedef CCCryptorStatus(cc_aes_create_fn)(struct aws_symmetric_cipher *cipher, CCOperation op, CCCryptorRef *handle);
+
 struct cc_aes_cipher {
     struct aws_symmetric_cipher cipher_base;
+    /* Nearly every cipher only ever goes one way, so each cryptor is created on first use, see s_get_handle(). A
+     * reset releases them. */
     struct _CCCryptor *encryptor_handle;
     struct _CCCryptor *decryptor_handle;
+    cc_aes_create_fn *create_handle;
     struct aws_byte_buf working_buffer;
+    /* CTR only. After a seek, cryptors start at ctr_seek_block and skip ctr_seek_skip bytes of keystream instead of
+     * starting at the IV. A reset clears it. */
+    uint8_t ctr_seek_block[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    size_t ctr_seek_skip;
+    bool ctr_seeked;
 };
 
+/* Returns the cryptor for op, creating it if this is its first use since the cipher was created or reset. On failure,
+ * the cipher is no longer good. */
+static struct _CCCryptor *s_get_handle(struct aws_symmetric_cipher *cipher, CCOperation op) {
+    struct cc_aes_cipher *cc_cipher = cipher->impl;
+
+    struct _CCCryptor **handle = op == kCCEncrypt ? &cc_cipher->encryptor_handle : &cc_cipher->decryptor_handle;
+
+    if (*handle == NULL && cc_cipher->create_handle(cipher, op, handle) != kCCSuccess) {
+        if (*handle) {
+            CCCryptorRelease(*handle);
+            *handle = NULL;
+        }
+
+        cipher->good = false;
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    return *handle;
+}
+
 static int s_encrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor input, struct aws_byte_buf *out) {
-    /* allow for a padded block by making sure we have at least a block of padding reserved. */
-    size_t required_buffer_space = input.len + cipher->block_size - 1;
+    struct _CCCryptor *handle = s_get_handle(cipher, kCCEncrypt);
+    if (handle == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    /* CBC can flush a buffered partial block along with this input, CTR writes exactly input.len. Let the cryptor tell
+     * us which, so fixed spans sized for a stream mode aren't rejected. */
+    size_t required_buffer_space = CCCryptorGetOutputLength(handle, input.len, false);
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
     size_t available_write_space = out->capacity - out->len;
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
 
     size_t len_written = 0;
-    CCStatus status = CCCryptorUpdate(
-        cc_cipher->encryptor_handle, input.ptr, input.len, out->buffer + out->len, available_write_space, &len_written);
+    CCStatus status =
+        CCCryptorUpdate(handle, input.ptr, input.len, out->buffer + out->len, available_write_space, &len_written);
 
     if (status != kCCSuccess) {
         cipher->good = false;
@@ -48,19 +85,24 @@ static int s_encrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor
 }
 
 static int s_decrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor input, struct aws_byte_buf *out) {
-    /* allow for a padded block by making sure we have at least a block of padding reserved. */
-    size_t required_buffer_space = input.len + cipher->block_size - 1;
+    struct _CCCryptor *handle = s_get_handle(cipher, kCCDecrypt);
+    if (handle == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    /* CBC can flush a buffered partial block along with this input, CTR writes exactly input.len. Let the cryptor tell
+     * us which, so fixed spans sized for a stream mode aren't rejected. */
+    size_t required_buffer_space = CCCryptorGetOutputLength(handle, input.len, false);
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
     size_t available_write_space = out->capacity - out->len;
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
 
     size_t len_written = 0;
-    CCStatus status = CCCryptorUpdate(
-        cc_cipher->decryptor_handle, input.ptr, input.len, out->buffer + out->len, available_write_space, &len_written);
+    CCStatus status =
+        CCCryptorUpdate(handle, input.ptr, input.len, out->buffer + out->len, available_write_space, &len_written);
 
     if (status != kCCSuccess) {
         cipher->good = false;
@@ -72,9 +114,14 @@ static int s_decrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor
 }
 
 static int s_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    struct _CCCryptor *handle = s_get_handle(cipher, kCCEncrypt);
+    if (handle == NULL) {
+        return AWS_OP_ERR;
+    }
+
     /* in CBC mode, this will pad the final block from the previous encrypt call, or do nothing
      * if we were already on a block boundary. In CTR mode this will do nothing. */
-    size_t required_buffer_space = cipher->block_size;
+    size_t required_buffer_space = CCCryptorGetOutputLength(handle, 0, true);
     size_t len_written = 0;
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
@@ -82,10 +129,8 @@ static int s_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws
     }
 
     size_t available_write_space = out->capacity - out->len;
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
 
-    CCStatus status =
-        CCCryptorFinal(cc_cipher->encryptor_handle, out->buffer + out->len, available_write_space, &len_written);
+    CCStatus status = CCCryptorFinal(handle, out->buffer + out->len, available_write_space, &len_written);
 
     if (status != kCCSuccess) {
         cipher->good = false;
@@ -97,9 +142,14 @@ static int s_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws
 }
 
 static int s_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    struct _CCCryptor *handle = s_get_handle(cipher, kCCDecrypt);
+    if (handle == NULL) {
+        return AWS_OP_ERR;
+    }
+
     /* in CBC mode, this will pad the final block from the previous encrypt call, or do nothing
      * if we were already on a block boundary. In CTR mode this will do nothing. */
-    size_t required_buffer_space = cipher->block_size;
+    size_t required_buffer_space = CCCryptorGetOutputLength(handle, 0, true);
     size_t len_written = 0;
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
@@ -107,10 +157,8 @@ static int s_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws
     }
 
     size_t available_write_space = out->capacity - out->len;
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
 
-    CCStatus status =
-        CCCryptorFinal(cc_cipher->decryptor_handle, out->buffer + out->len, available_write_space, &len_written);
+    CCStatus status = CCCryptorFinal(handle, out->buffer + out->len, available_write_space, &len_written);
 
     if (status != kCCSuccess) {
         cipher->good = false;
@@ -121,59 +169,45 @@ static int s_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws
     return AWS_OP_SUCCESS;
 }
 
-static int s_initialize_cbc_cipher_materials(
+static void s_initialize_cbc_cipher_materials(
     struct cc_aes_cipher *cc_cipher,
     const struct aws_byte_cursor *key,
     const struct aws_byte_cursor *iv) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(cc_cipher->cipher_base.allocator);
     if (!cc_cipher->cipher_base.key.len) {
         if (key) {
-            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, *key);
+            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, secure_allocator, *key);
         } else {
-            aws_byte_buf_init(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, AWS_AES_256_KEY_BYTE_LEN);
+            aws_byte_buf_init(&cc_cipher->cipher_base.key, secure_allocator, AWS_AES_256_KEY_BYTE_LEN);
             aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cc_cipher->cipher_base.key);
         }
     }
 
     if (!cc_cipher->cipher_base.iv.len) {
         if (iv) {
-            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.iv, cc_cipher->cipher_base.allocator, *iv);
+            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.iv, secure_allocator, *iv);
         } else {
-            aws_byte_buf_init(
-                &cc_cipher->cipher_base.iv, cc_cipher->cipher_base.allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+            aws_byte_buf_init(&cc_cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
             aws_symmetric_cipher_generate_initialization_vector(
                 AWS_AES_256_CIPHER_BLOCK_SIZE, false, &cc_cipher->cipher_base.iv);
         }
     }
+}
 
-    CCCryptorStatus status = CCCryptorCreateWithMode(
-        kCCEncrypt,
-        kCCModeCBC,
-        kCCAlgorithmAES,
-        ccPKCS7Padding,
-        cc_cipher->cipher_base.iv.buffer,
-        cc_cipher->cipher_base.key.buffer,
-        cc_cipher->cipher_base.key.len,
-        NULL,
-        0,
-        0,
-        0,
-        &cc_cipher->encryptor_handle);
-
-    status |= CCCryptorCreateWithMode(
-        kCCDecrypt,
+static CCCryptorStatus s_create_cbc_handle(struct aws_symmetric_cipher *cipher, CCOperation op, CCCryptorRef *handle) {
+    return CCCryptorCreateWithMode(
+        op,
         kCCModeCBC,
         kCCAlgorithmAES,
         ccPKCS7Padding,
-        cc_cipher->cipher_base.iv.buffer,
-        cc_cipher->cipher_base.key.buffer,
-        cc_cipher->cipher_base.key.len,
+        cipher->iv.buffer,
+        cipher->key.buffer,
+        cipher->key.len,
         NULL,
         0,
         0,
         0,
-        &cc_cipher->decryptor_handle);
-
-    return status == kCCSuccess ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        handle);
 }
 
 static int s_reset(struct aws_symmetric_cipher *cipher) {
@@ -190,6 +224,7 @@ static int s_reset(struct aws_symmetric_cipher *cipher) {
     }
 
     aws_byte_buf_secure_zero(&cc_cipher->working_buffer);
+    cc_cipher->ctr_seeked = false;
 
     return AWS_OP_SUCCESS;
 }
@@ -208,18 +243,6 @@ static void s_destroy(struct aws_symmetric_cipher *cipher) {
     aws_mem_release(cipher->allocator, cc_cipher);
 }
 
-static int s_cbc_reset(struct aws_symmetric_cipher *cipher) {
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
-
-    int ret_val = s_reset(cipher);
-
-    if (ret_val == AWS_OP_SUCCESS) {
-        ret_val = s_initialize_cbc_cipher_materials(cc_cipher, NULL, NULL);
-    }
-
-    return ret_val;
-}
-
 static struct aws_symmetric_cipher_vtable s_aes_cbc_vtable = {
     .finalize_decryption = s_finalize_decryption,
     .finalize_encryption = s_finalize_encryption,
@@ -228,7 +251,7 @@ static struct aws_symmetric_cipher_vtable s_aes_cbc_vtable = {
     .provider = "CommonCrypto",
     .alg_name = "AES-CBC 256",
     .destroy = s_destroy,
-    .reset = s_cbc_reset,
+    .reset = s_reset,
 };
 
 struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
@@ -241,11 +264,9 @@ struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
     cc_cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cc_cipher->cipher_base.impl = cc_cipher;
     cc_cipher->cipher_base.vtable = &s_aes_cbc_vtable;
+    cc_cipher->create_handle = s_create_cbc_handle;
 
-    if (s_initialize_cbc_cipher_materials(cc_cipher, key, iv) != AWS_OP_SUCCESS) {
-        s_destroy(&cc_cipher->cipher_base);
-        return NULL;
-    }
+    s_initialize_cbc_cipher_materials(cc_cipher, key, iv);
 
     cc_cipher->cipher_base.good = true;
     cc_cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
@@ -253,71 +274,71 @@ struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
     return &cc_cipher->cipher_base;
 }
 
-static int s_initialize_ctr_cipher_materials(
+static void s_initialize_ctr_cipher_materials(
     struct cc_aes_cipher *cc_cipher,
     const struct aws_byte_cursor *key,
     const struct aws_byte_cursor *iv) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(cc_cipher->cipher_base.allocator);
     if (!cc_cipher->cipher_base.key.len) {
         if (key) {
-            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, *key);
+            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, secure_allocator, *key);
         } else {
-            aws_byte_buf_init(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, AWS_AES_256_KEY_BYTE_LEN);
+            aws_byte_buf_init(&cc_cipher->cipher_base.key, secure_allocator, AWS_AES_256_KEY_BYTE_LEN);
             aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cc_cipher->cipher_base.key);
         }
     }
 
     if (!cc_cipher->cipher_base.iv.len) {
         if (iv) {
-            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.iv, cc_cipher->cipher_base.allocator, *iv);
+            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.iv, secure_allocator, *iv);
         } else {
-            aws_byte_buf_init(
-                &cc_cipher->cipher_base.iv, cc_cipher->cipher_base.allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+            aws_byte_buf_init(&cc_cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
             aws_symmetric_cipher_generate_initialization_vector(
                 AWS_AES_256_CIPHER_BLOCK_SIZE, true, &cc_cipher->cipher_base.iv);
         }
     }
+}
+
+static CCCryptorStatus s_create_ctr_handle(struct aws_symmetric_cipher *cipher, CCOperation op, CCCryptorRef *handle) {
+    struct cc_aes_cipher *cc_cipher = cipher->impl;
 
     CCCryptorStatus status = CCCryptorCreateWithMode(
-        kCCEncrypt,
+        op,
         kCCModeCTR,
         kCCAlgorithmAES,
         ccNoPadding,
-        cc_cipher->cipher_base.iv.buffer,
-        cc_cipher->cipher_base.key.buffer,
-        cc_cipher->cipher_base.key.len,
+        cc_cipher->ctr_seeked ? cc_cipher->ctr_seek_block : cipher->iv.buffer,
+        cipher->key.buffer,
+        cipher->key.len,
         NULL,
         0,
         0,
         kCCModeOptionCTR_BE,
-        &cc_cipher->encryptor_handle);
+        handle);
 
-    status |= CCCryptorCreateWithMode(
-        kCCDecrypt,
-        kCCModeCTR,
-        kCCAlgorithmAES,
-        ccNoPadding,
-        cc_cipher->cipher_base.iv.buffer,
-        cc_cipher->cipher_base.key.buffer,
-        cc_cipher->cipher_base.key.len,
-        NULL,
-        0,
-        0,
-        kCCModeOptionCTR_BE,
-        &cc_cipher->decryptor_handle);
+    if (status != kCCSuccess || !cc_cipher->ctr_seeked || cc_cipher->ctr_seek_skip == 0) {
+        return status;
+    }
 
-    return status == kCCSuccess ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    /* running zeros through uses up the skipped part of the block. */
+    uint8_t zeros[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    uint8_t discard[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    size_t len_written = 0;
+    status = CCCryptorUpdate(*handle, zeros, cc_cipher->ctr_seek_skip, discard, sizeof(discard), &len_written);
+    aws_secure_zero(discard, sizeof(discard));
+
+    return status;
 }
 
-static int s_ctr_reset(struct aws_symmetric_cipher *cipher) {
+/* Cryptors are created lazily, so this only has to record where they should start. */
+static int s_ctr_seek(struct aws_symmetric_cipher *cipher, const uint8_t *counter_block, size_t skip) {
     struct cc_aes_cipher *cc_cipher = cipher->impl;
 
-    int ret_val = s_reset(cipher);
-
-    if (ret_val == AWS_OP_SUCCESS) {
-        ret_val = s_initialize_ctr_cipher_materials(cc_cipher, NULL, NULL);
-    }
-
-    return ret_val;
+    s_reset(cipher);
+    memcpy(cc_cipher->ctr_seek_block, counter_block, sizeof(cc_cipher->ctr_seek_block));
+    cc_cipher->ctr_seek_skip = skip;
+    cc_cipher->ctr_seeked = true;
+    return AWS_OP_SUCCESS;
 }
 
 static struct aws_symmetric_cipher_vtable s_aes_ctr_vtable = {
@@ -328,7 +349,8 @@ static struct aws_symmetric_cipher_vtable s_aes_ctr_vtable = {
     .provider = "CommonCrypto",
     .alg_name = "AES-CTR 256",
     .destroy = s_destroy,
-    .reset = s_ctr_reset,
+    .reset = s_reset,
+    .seek = s_ctr_seek,
 };
 
 struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
@@ -340,12 +362,9 @@ struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
     cc_cipher->cipher_base.block_size = AWS_AES_256_CIPHER_BLOCK_SIZE;
     cc_cipher->cipher_base.impl = cc_cipher;
     cc_cipher->cipher_base.vtable = &s_aes_ctr_vtable;
+    cc_cipher->create_handle = s_create_ctr_handle;
 
-    if (s_initialize_ctr_cipher_materials(cc_cipher, key, iv) != AWS_OP_SUCCESS) {
-        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-        s_destroy(&cc_cipher->cipher_base);
-        return NULL;
-    }
+    s_initialize_ctr_cipher_materials(cc_cipher, key, iv);
 
     cc_cipher->cipher_base.good = true;
     cc_cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
@@ -400,10 +419,13 @@ static int s_finalize_gcm_encryption(struct aws_symmetric_cipher *cipher, struct
         aws_byte_buf_init(&cipher->tag, cipher->allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
     }
 
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
+    struct _CCCryptor *handle = s_get_handle(cipher, kCCEncrypt);
+    if (handle == NULL) {
+        return AWS_OP_ERR;
+    }
 
     size_t tag_length = AWS_AES_256_CIPHER_BLOCK_SIZE;
-    CCStatus status = s_cc_crypto_gcm_finalize(cc_cipher->encryptor_handle, cipher->tag.buffer, tag_length);
+    CCStatus status = s_cc_crypto_gcm_finalize(handle, cipher->tag.buffer, tag_length);
     if (status != kCCSuccess) {
         cipher->good = false;
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
@@ -416,10 +438,20 @@ static int s_finalize_gcm_encryption(struct aws_symmetric_cipher *cipher, struct
 static int s_finalize_gcm_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
     (void)out;
 
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
+    /* there's nothing to check the message against. */
+    if (!cipher->tag.len) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* this has to be the decryptor, the one that saw the ciphertext. The encryptor may never have been created. */
+    struct _CCCryptor *handle = s_get_handle(cipher, kCCDecrypt);
+    if (handle == NULL) {
+        return AWS_OP_ERR;
+    }
 
     size_t tag_length = AWS_AES_256_CIPHER_BLOCK_SIZE;
-    CCStatus status = s_cc_crypto_gcm_finalize(cc_cipher->encryptor_handle, cipher->tag.buffer, tag_length);
+    CCStatus status = s_cc_crypto_gcm_finalize(handle, cipher->tag.buffer, tag_length);
     if (status != kCCSuccess) {
         cipher->good = false;
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
@@ -428,31 +460,31 @@ static int s_finalize_gcm_decryption(struct aws_symmetric_cipher *cipher, struct
     return AWS_OP_SUCCESS;
 }
 
-static int s_initialize_gcm_cipher_materials(
+static void s_initialize_gcm_cipher_materials(
     struct cc_aes_cipher *cc_cipher,
     const struct aws_byte_cursor *key,
     const struct aws_byte_cursor *iv,
     const struct aws_byte_cursor *aad,
     const struct aws_byte_cursor *tag) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(cc_cipher->cipher_base.allocator);
     if (!cc_cipher->cipher_base.key.len) {
         if (key) {
-            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, *key);
+            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, secure_allocator, *key);
         } else {
-            aws_byte_buf_init(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, AWS_AES_256_KEY_BYTE_LEN);
+            aws_byte_buf_init(&cc_cipher->cipher_base.key, secure_allocator, AWS_AES_256_KEY_BYTE_LEN);
             aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cc_cipher->cipher_base.key);
         }
     }
 
     if (!cc_cipher->cipher_base.iv.len) {
         if (iv) {
-            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.iv, cc_cipher->cipher_base.allocator, *iv);
+            aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.iv, secure_allocator, *iv);
         } else {
             /* GCM IVs are kind of a hidden implementation detail. 4 are reserved by the system for long running stream
              * blocks. */
             /* This is because there's a GMAC attached to the cipher (that's what tag is for). For that to work, it has
              * to control the actual counter */
-            aws_byte_buf_init(
-                &cc_cipher->cipher_base.iv, cc_cipher->cipher_base.allocator, AWS_AES_256_CIPHER_BLOCK_SIZE - 4);
+            aws_byte_buf_init(&cc_cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE - 4);
             aws_symmetric_cipher_generate_initialization_vector(
                 AWS_AES_256_CIPHER_BLOCK_SIZE - 4, false, &cc_cipher->cipher_base.iv);
         }
@@ -465,86 +497,34 @@ static int s_initialize_gcm_cipher_materials(
     if (tag && tag->len) {
         aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.tag, cc_cipher->cipher_base.allocator, *tag);
     }
+}
 
+static CCCryptorStatus s_create_gcm_handle(struct aws_symmetric_cipher *cipher, CCOperation op, CCCryptorRef *handle) {
     CCCryptorStatus status = CCCryptorCreateWithMode(
-        kCCEncrypt,
-        kCCModeGCM,
-        kCCAlgorithmAES,
-        ccNoPadding,
-        NULL,
-        cc_cipher->cipher_base.key.buffer,
-        cc_cipher->cipher_base.key.len,
-        NULL,
-        0,
-        0,
-        kCCModeOptionCTR_BE,
-        &cc_cipher->encryptor_handle);
-
-    if (status != kCCSuccess) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-    }
-    status = s_cc_cryptor_gcm_set_iv(
-        cc_cipher->encryptor_handle, cc_cipher->cipher_base.iv.buffer, cc_cipher->cipher_base.iv.len);
-
-    if (status != kCCSuccess) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-    }
-
-    if (cc_cipher->cipher_base.aad.len) {
-        status = CCCryptorGCMAddAAD(
-            cc_cipher->encryptor_handle, cc_cipher->cipher_base.aad.buffer, cc_cipher->cipher_base.aad.len);
-
-        if (status != kCCSuccess) {
-            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-        }
-    }
-
-    status = CCCryptorCreateWithMode(
-        kCCDecrypt,
+        op,
         kCCModeGCM,
         kCCAlgorithmAES,
         ccNoPadding,
         NULL,
-        cc_cipher->cipher_base.key.buffer,
-        cc_cipher->cipher_base.key.len,
+        cipher->key.buffer,
+        cipher->key.len,
         NULL,
         0,
         0,
         kCCModeOptionCTR_BE,
-        &cc_cipher->decryptor_handle);
+        handle);
 
     if (status != kCCSuccess) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return status;
     }
-    status = s_cc_cryptor_gcm_set_iv(
-        cc_cipher->decryptor_handle, cc_cipher->cipher_base.iv.buffer, cc_cipher->cipher_base.iv.len);
 
-    if (status != kCCSuccess) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-    }
+    status = s_cc_cryptor_gcm_set_iv(*handle, cipher->iv.buffer, cipher->iv.len);
 
-    if (cc_cipher->cipher_base.aad.len) {
-        status = CCCryptorGCMAddAAD(
-            cc_cipher->decryptor_handle, cc_cipher->cipher_base.aad.buffer, cc_cipher->cipher_base.aad.len);
+    if (status == kCCSuccess && cipher->aad.len) {
+        status = CCCryptorGCMAddAAD(*handle, cipher->aad.buffer, cipher->aad.len);
     }
 
-    if (status != kCCSuccess) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-    }
-
-    return AWS_OP_SUCCESS;
-}
-
-static int s_gcm_reset(struct aws_symmetric_cipher *cipher) {
-    struct cc_aes_cipher *cc_cipher = cipher->impl;
-
-    int ret_val = s_reset(cipher);
-
-    if (ret_val == AWS_OP_SUCCESS) {
-        ret_val = s_initialize_gcm_cipher_materials(cc_cipher, NULL, NULL, NULL, NULL);
-    }
-
-    return ret_val;
+    return status;
 }
 
 static struct aws_symmetric_cipher_vtable s_aes_gcm_vtable = {
@@ -555,7 +535,7 @@ static struct aws_symmetric_cipher_vtable s_aes_gcm_vtable = {
     .provider = "CommonCrypto",
     .alg_name = "AES-GCM 256",
     .destroy = s_destroy,
-    .reset = s_gcm_reset,
+    .reset = s_reset,
 };
 
 struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
@@ -569,11 +549,9 @@ struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
     cc_cipher->cipher_base.block_size = AWS_AES_256_CIPHER_BLOCK_SIZE;
     cc_cipher->cipher_base.impl = cc_cipher;
     cc_cipher->cipher_base.vtable = &s_aes_gcm_vtable;
+    cc_cipher->create_handle = s_create_gcm_handle;
 
-    if (s_initialize_gcm_cipher_materials(cc_cipher, key, iv, aad, tag) != AWS_OP_SUCCESS) {
-        s_destroy(&cc_cipher->cipher_base);
-        return NULL;
-    }
+    s_initialize_gcm_cipher_materials(cc_cipher, key, iv, aad, tag);
 
     cc_cipher->cipher_base.good = true;
     cc_cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
@@ -673,6 +651,7 @@ static struct aws_symmetric_cipher_vtable s_aes_keywrap_vtable = {
 struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
     struct cc_aes_cipher *cc_cipher = aws_mem_calloc(allocator, 1, sizeof(struct cc_aes_cipher));
     cc_cipher->cipher_base.allocator = allocator;
     cc_cipher->cipher_base.block_size = AWS_AES_256_CIPHER_BLOCK_SIZE / 2;
@@ -680,9 +659,9 @@ struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
     cc_cipher->cipher_base.vtable = &s_aes_keywrap_vtable;
 
     if (key) {
-        aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, *key);
+        aws_byte_buf_init_copy_from_cursor(&cc_cipher->cipher_base.key, secure_allocator, *key);
     } else {
-        aws_byte_buf_init(&cc_cipher->cipher_base.key, cc_cipher->cipher_base.allocator, AWS_AES_256_KEY_BYTE_LEN);
+        aws_byte_buf_init(&cc_cipher->cipher_base.key, secure_allocator, AWS_AES_256_KEY_BYTE_LEN);
         aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cc_cipher->cipher_base.key);
     }
 
@@ -692,3 +671,123 @@ struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
 
     return &cc_cipher->cipher_base;
 }
+
+/* CommonCrypto's public GCM interface is stateful only, so the one-shot paths go through a regular cipher object. */
+int aws_aes_256_gcm_seal_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+    return aws_aes_256_gcm_seal_with_cipher(allocator, key, nonce, aad, plaintext, out);
+}
+
+int aws_aes_256_gcm_open_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out) {
+    return aws_aes_256_gcm_open_with_cipher(allocator, key, nonce, aad, ciphertext, tag, out);
+}
+
+/* No batch primitive here, one keywrap cipher made from the prepared key is reset between keys instead. */
+int aws_aes_256_keywrap_batch_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap) {
+    return aws_aes_256_keywrap_batch_with_cipher(allocator, prepared_key, inputs, outputs, count, wrap);
+}
+
+/* A CCCryptorRef owns its key schedule and can't be cloned through the public API, so a prepared key is just the raw
+ * key here and each cipher made from it is keyed the usual way. */
+int aws_aes_256_prepared_key_init_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    (void)prepared_key;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_aes_256_prepared_key_clean_up_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    (void)prepared_key;
+}
+
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    struct aws_byte_cursor key = aws_byte_cursor_from_buf(&prepared_key->key);
+    return aws_aes_cbc_256_new_impl(allocator, &key, iv);
+}
+
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    struct aws_byte_cursor key = aws_byte_cursor_from_buf(&prepared_key->key);
+    return aws_aes_ctr_256_new_impl(allocator, &key, iv);
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    struct aws_byte_cursor key = aws_byte_cursor_from_buf(&prepared_key->key);
+    return aws_aes_gcm_256_new_impl(allocator, &key, iv, aad, decryption_tag);
+}
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    struct aws_byte_cursor key = aws_byte_cursor_from_buf(&prepared_key->key);
+    return aws_aes_keywrap_256_new_impl(allocator, &key);
+}
+
+/* XTS, GCM-SIV and ChaCha20-Poly1305 aren't available here, aws_set_aes_xts_256_new_fn(),
+ * aws_set_aes_gcm_siv_256_new_fn() and aws_set_chacha20_poly1305_new_fn() can plug in an implementation. */
+struct aws_symmetric_cipher *aws_aes_xts_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak) {
+    (void)allocator;
+    (void)key;
+    (void)tweak;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct aws_symmetric_cipher *aws_chacha20_poly1305_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
@@ -9,21 +9,57 @@
 static void s_destroy(struct aws_hmac *hmac);
 static int s_update(struct aws_hmac *hmac, const struct aws_byte_cursor *to_hmac);
 static int s_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output);
+static int s_reset(struct aws_hmac *hmac);
+static struct aws_hmac *s_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac);
+static int s_rekey(struct aws_hmac *hmac, const struct aws_byte_cursor *secret);
 
 static struct aws_hmac_vtable s_sha256_hmac_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
     .alg_name = "SHA256 HMAC",
     .provider = "CommonCrypto",
 };
 
+static struct aws_hmac_vtable s_sha384_hmac_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
+    .alg_name = "SHA384 HMAC",
+    .provider = "CommonCrypto",
+};
+
+static struct aws_hmac_vtable s_sha512_hmac_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
+    .alg_name = "SHA512 HMAC",
+    .provider = "CommonCrypto",
+};
+
 struct cc_hmac {
     struct aws_hmac hmac;
     CCHmacContext cc_hmac_ctx;
+    /* cc_hmac_ctx as it was right after CCHmacInit(), restored by reset */
+    CCHmacContext keyed_ctx;
+    CCHmacAlgorithm alg;
 };
 
-struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+static struct aws_hmac *s_hmac_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    struct aws_hmac_vtable *vtable,
+    size_t digest_size,
+    CCHmacAlgorithm alg) {
     AWS_ASSERT(secret->ptr);
 
     struct cc_hmac *cc_hmac = aws_mem_acquire(allocator, sizeof(struct cc_hmac));
@@ -33,16 +69,30 @@ struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, co
     }
 
     cc_hmac->hmac.allocator = allocator;
-    cc_hmac->hmac.vtable = &s_sha256_hmac_vtable;
+    cc_hmac->hmac.vtable = vtable;
     cc_hmac->hmac.impl = cc_hmac;
-    cc_hmac->hmac.digest_size = AWS_SHA256_HMAC_LEN;
+    cc_hmac->hmac.digest_size = digest_size;
     cc_hmac->hmac.good = true;
+    cc_hmac->alg = alg;
 
-    CCHmacInit(&cc_hmac->cc_hmac_ctx, kCCHmacAlgSHA256, secret->ptr, (CC_LONG)secret->len);
+    CCHmacInit(&cc_hmac->cc_hmac_ctx, alg, secret->ptr, (CC_LONG)secret->len);
+    cc_hmac->keyed_ctx = cc_hmac->cc_hmac_ctx;
 
     return &cc_hmac->hmac;
 }
 
+struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_new(allocator, secret, &s_sha256_hmac_vtable, AWS_SHA256_HMAC_LEN, kCCHmacAlgSHA256);
+}
+
+struct aws_hmac *aws_sha384_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_new(allocator, secret, &s_sha384_hmac_vtable, AWS_SHA384_HMAC_LEN, kCCHmacAlgSHA384);
+}
+
+struct aws_hmac *aws_sha512_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_new(allocator, secret, &s_sha512_hmac_vtable, AWS_SHA512_HMAC_LEN, kCCHmacAlgSHA512);
+}
+
 static void s_destroy(struct aws_hmac *hmac) {
     struct cc_hmac *ctx = hmac->impl;
     aws_mem_release(hmac->allocator, ctx);
@@ -77,3 +127,42 @@ static int s_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output) {
     output->len += hmac->digest_size;
     return AWS_OP_SUCCESS;
 }
+
+static int s_reset(struct aws_hmac *hmac) {
+    struct cc_hmac *ctx = hmac->impl;
+
+    ctx->cc_hmac_ctx = ctx->keyed_ctx;
+    hmac->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_hmac *s_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac) {
+    if (!hmac->good) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    struct cc_hmac *cc_hmac = aws_mem_acquire(allocator, sizeof(struct cc_hmac));
+
+    if (!cc_hmac) {
+        return NULL;
+    }
+
+    /* CCHmacContext is a plain struct with no external references, so copying it copies the hmac */
+    *cc_hmac = *(const struct cc_hmac *)hmac->impl;
+    cc_hmac->hmac.allocator = allocator;
+    cc_hmac->hmac.impl = cc_hmac;
+
+    return &cc_hmac->hmac;
+}
+
+static int s_rekey(struct aws_hmac *hmac, const struct aws_byte_cursor *secret) {
+    AWS_ASSERT(secret->ptr);
+
+    struct cc_hmac *ctx = hmac->impl;
+
+    CCHmacInit(&ctx->cc_hmac_ctx, ctx->alg, secret->ptr, (CC_LONG)secret->len);
+    ctx->keyed_ctx = ctx->cc_hmac_ctx;
+    hmac->good = true;
+    return AWS_OP_SUCCESS;
+}
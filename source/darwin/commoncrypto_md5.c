@@ -12,11 +12,15 @@
 static void s_destroy(struct aws_hash *hash);
 static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
 static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_reset(struct aws_hash *hash);
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
 
 static struct aws_hash_vtable s_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
     .alg_name = "MD5",
     .provider = "CommonCrypto",
 };
@@ -77,4 +81,37 @@ static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
     return AWS_OP_SUCCESS;
 }
 
+static int s_reset(struct aws_hash *hash) {
+    struct cc_md5_hash *ctx = hash->impl;
+
+    CC_MD5_Init(&ctx->cc_hash);
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+bool aws_md5_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    /* CC_MD5() takes a 32 bit length, larger inputs go through a hash instance */
+    if (input->len > UINT32_MAX) {
+        return false;
+    }
+
+    CC_MD5(input->ptr, (CC_LONG)input->len, out);
+    return true;
+}
+
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    struct cc_md5_hash *copy = aws_mem_acquire(allocator, sizeof(struct cc_md5_hash));
+
+    if (!copy) {
+        return NULL;
+    }
+
+    /* CC_MD5_CTX is a plain struct with no external references, so copying it copies the hash */
+    *copy = *(const struct cc_md5_hash *)hash->impl;
+    copy->hash.allocator = allocator;
+    copy->hash.impl = copy;
+
+    return &copy->hash;
+}
+
 #pragma clang diagnostic pop
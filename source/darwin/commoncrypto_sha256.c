@@ -9,11 +9,15 @@
 static void s_destroy(struct aws_hash *hash);
 static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
 static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_reset(struct aws_hash *hash);
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
 
 static struct aws_hash_vtable s_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
     .alg_name = "SHA256",
     .provider = "CommonCrypto",
 };
@@ -74,3 +78,35 @@ static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
     output->len += hash->digest_size;
     return AWS_OP_SUCCESS;
 }
+
+static int s_reset(struct aws_hash *hash) {
+    struct cc_sha256_hash *ctx = hash->impl;
+
+    CC_SHA256_Init(&ctx->cc_hash);
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+bool aws_sha256_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    /* CC_SHA256() takes a 32 bit length, larger inputs go through a hash instance */
+    if (input->len > UINT32_MAX) {
+        return false;
+    }
+
+    CC_SHA256(input->ptr, (CC_LONG)input->len, out);
+    return true;
+}
+
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    struct cc_sha256_hash *copy = aws_mem_acquire(allocator, sizeof(struct cc_sha256_hash));
+
+    if (!copy) {
+        return NULL;
+    }
+
+    *copy = *(const struct cc_sha256_hash *)hash->impl;
+    copy->hash.allocator = allocator;
+    copy->hash.impl = copy;
+
+    return &copy->hash;
+}
@@ -0,0 +1,200 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/cal.h>
+#include <aws/cal/hash.h>
+
+#include <CommonCrypto/CommonDigest.h>
+
+/* SHA-384 is SHA-512 with a different IV and a truncated output, so CommonCrypto uses the same context for both. */
+
+static void s_destroy(struct aws_hash *hash);
+static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
+static int s_sha384_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_sha512_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_sha384_reset(struct aws_hash *hash);
+static int s_sha512_reset(struct aws_hash *hash);
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
+
+static struct aws_hash_vtable s_sha384_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_sha384_finalize,
+    .reset = s_sha384_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA384",
+    .provider = "CommonCrypto",
+};
+
+static struct aws_hash_vtable s_sha512_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_sha512_finalize,
+    .reset = s_sha512_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA512",
+    .provider = "CommonCrypto",
+};
+
+struct cc_sha512_hash {
+    struct aws_hash hash;
+    CC_SHA512_CTX cc_hash;
+};
+
+static struct cc_sha512_hash *s_hash_new(
+    struct aws_allocator *allocator,
+    struct aws_hash_vtable *vtable,
+    size_t digest_size) {
+    struct cc_sha512_hash *sha512_hash = aws_mem_acquire(allocator, sizeof(struct cc_sha512_hash));
+
+    if (!sha512_hash) {
+        return NULL;
+    }
+
+    sha512_hash->hash.allocator = allocator;
+    sha512_hash->hash.vtable = vtable;
+    sha512_hash->hash.impl = sha512_hash;
+    sha512_hash->hash.digest_size = digest_size;
+    sha512_hash->hash.good = true;
+
+    return sha512_hash;
+}
+
+struct aws_hash *aws_sha384_default_new(struct aws_allocator *allocator) {
+    struct cc_sha512_hash *sha384_hash = s_hash_new(allocator, &s_sha384_vtable, AWS_SHA384_LEN);
+
+    if (!sha384_hash) {
+        return NULL;
+    }
+
+    CC_SHA384_Init(&sha384_hash->cc_hash);
+    return &sha384_hash->hash;
+}
+
+struct aws_hash *aws_sha512_default_new(struct aws_allocator *allocator) {
+    struct cc_sha512_hash *sha512_hash = s_hash_new(allocator, &s_sha512_vtable, AWS_SHA512_LEN);
+
+    if (!sha512_hash) {
+        return NULL;
+    }
+
+    CC_SHA512_Init(&sha512_hash->cc_hash);
+    return &sha512_hash->hash;
+}
+
+struct aws_hash *aws_sha512_256_default_new(struct aws_allocator *allocator) {
+    /* CommonCrypto doesn't expose SHA-512/256, nor a way to seed a SHA-512 context with its IV. */
+    (void)allocator;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+static void s_destroy(struct aws_hash *hash) {
+    struct cc_sha512_hash *ctx = hash->impl;
+    aws_mem_release(hash->allocator, ctx);
+}
+
+static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct cc_sha512_hash *ctx = hash->impl;
+
+    CC_SHA512_Update(&ctx->cc_hash, to_hash->ptr, (CC_LONG)to_hash->len);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha384_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct cc_sha512_hash *ctx = hash->impl;
+
+    size_t buffer_len = output->capacity - output->len;
+
+    if (buffer_len < hash->digest_size) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    CC_SHA384_Final(output->buffer + output->len, &ctx->cc_hash);
+    hash->good = false;
+    output->len += hash->digest_size;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha512_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct cc_sha512_hash *ctx = hash->impl;
+
+    size_t buffer_len = output->capacity - output->len;
+
+    if (buffer_len < hash->digest_size) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    CC_SHA512_Final(output->buffer + output->len, &ctx->cc_hash);
+    hash->good = false;
+    output->len += hash->digest_size;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha384_reset(struct aws_hash *hash) {
+    struct cc_sha512_hash *ctx = hash->impl;
+
+    CC_SHA384_Init(&ctx->cc_hash);
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha512_reset(struct aws_hash *hash) {
+    struct cc_sha512_hash *ctx = hash->impl;
+
+    CC_SHA512_Init(&ctx->cc_hash);
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+bool aws_sha384_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    /* CC_SHA384() and CC_SHA512() take a 32 bit length, larger inputs go through a hash instance */
+    if (input->len > UINT32_MAX) {
+        return false;
+    }
+
+    CC_SHA384(input->ptr, (CC_LONG)input->len, out);
+    return true;
+}
+
+bool aws_sha512_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    if (input->len > UINT32_MAX) {
+        return false;
+    }
+
+    CC_SHA512(input->ptr, (CC_LONG)input->len, out);
+    return true;
+}
+
+bool aws_sha512_256_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    (void)input;
+    (void)out;
+    return false;
+}
+
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    struct cc_sha512_hash *copy = aws_mem_acquire(allocator, sizeof(struct cc_sha512_hash));
+
+    if (!copy) {
+        return NULL;
+    }
+
+    *copy = *(const struct cc_sha512_hash *)hash->impl;
+    copy->hash.allocator = allocator;
+    copy->hash.impl = copy;
+
+    return &copy->hash;
+}
@@ -7,6 +7,8 @@
 #include <aws/cal/cal.h>
 #include <aws/cal/private/der.h>
 
+#include <aws/common/thread.h>
+
 #include <Security/SecKey.h>
 #include <Security/Security.h>
 
@@ -19,16 +21,21 @@ struct commoncrypto_ecc_key_pair {
     SecKeyRef priv_key_ref;
     SecKeyRef pub_key_ref;
     CFAllocatorRef cf_allocator;
+    /* generated keys are only exported out of Security.framework the first time someone asks for the coordinates */
+    bool key_data_pending;
+    aws_thread_once key_data_once;
+    int key_data_error;
 };
 
 static uint8_t s_preamble = 0x04;
 
 static size_t s_der_overhead = 8;
 
-static int s_sign_message(
+static int s_sign_message_with_algorithm(
     const struct aws_ecc_key_pair *key_pair,
     const struct aws_byte_cursor *message,
-    struct aws_byte_buf *signature_output) {
+    struct aws_byte_buf *signature_output,
+    SecKeyAlgorithm algorithm) {
     struct commoncrypto_ecc_key_pair *cc_key = key_pair->impl;
 
     if (!cc_key->priv_key_ref) {
@@ -39,8 +46,7 @@ static int s_sign_message(
     AWS_FATAL_ASSERT(hash_ref && "No allocations should have happened here, this function shouldn't be able to fail.");
 
     CFErrorRef error = NULL;
-    CFDataRef signature =
-        SecKeyCreateSignature(cc_key->priv_key_ref, kSecKeyAlgorithmECDSASignatureDigestX962, hash_ref, &error);
+    CFDataRef signature = SecKeyCreateSignature(cc_key->priv_key_ref, algorithm, hash_ref, &error);
 
     if (error) {
         CFRelease(hash_ref);
@@ -62,14 +68,31 @@ static int s_sign_message(
     return AWS_OP_SUCCESS;
 }
 
+static int s_sign_message(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    return s_sign_message_with_algorithm(key_pair, message, signature_output, kSecKeyAlgorithmECDSASignatureDigestX962);
+}
+
+/* RFC 4754 is the fixed length r || s format, so Security framework does the conversion for us. */
+static int s_sign_message_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    return s_sign_message_with_algorithm(
+        key_pair, message, signature_output, kSecKeyAlgorithmECDSASignatureDigestRFC4754);
+}
+
 static size_t s_signature_length(const struct aws_ecc_key_pair *key_pair) {
     return aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name) * 2 + s_der_overhead;
 }
 
-static int s_verify_signature(
+static int s_verify_signature_with_algorithm(
     const struct aws_ecc_key_pair *key_pair,
     const struct aws_byte_cursor *message,
-    const struct aws_byte_cursor *signature) {
+    const struct aws_byte_cursor *signature,
+    SecKeyAlgorithm algorithm) {
     struct commoncrypto_ecc_key_pair *cc_key = key_pair->impl;
 
     if (!cc_key->pub_key_ref) {
@@ -85,8 +108,7 @@ static int s_verify_signature(
 
     CFErrorRef error = NULL;
 
-    bool verified = SecKeyVerifySignature(
-        cc_key->pub_key_ref, kSecKeyAlgorithmECDSASignatureDigestX962, hash_ref, signature_ref, &error);
+    bool verified = SecKeyVerifySignature(cc_key->pub_key_ref, algorithm, hash_ref, signature_ref, &error);
 
     CFRelease(signature_ref);
     CFRelease(hash_ref);
@@ -94,7 +116,27 @@ static int s_verify_signature(
     return verified ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
 }
 
+static int s_verify_signature(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    return s_verify_signature_with_algorithm(key_pair, message, signature, kSecKeyAlgorithmECDSASignatureDigestX962);
+}
+
+static int s_verify_signature_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    return s_verify_signature_with_algorithm(key_pair, message, signature, kSecKeyAlgorithmECDSASignatureDigestRFC4754);
+}
+
+static int s_load_key_data(struct aws_ecc_key_pair *key_pair);
+
 static int s_derive_public_key(struct aws_ecc_key_pair *key_pair) {
+    if (s_load_key_data(key_pair)) {
+        return AWS_OP_ERR;
+    }
+
     /* we already have a public key, just lie and tell them we succeeded */
     if (key_pair->pub_x.buffer && key_pair->pub_x.len) {
         return AWS_OP_SUCCESS;
@@ -124,20 +166,168 @@ static void s_destroy_key(struct aws_ecc_key_pair *key_pair) {
     }
 }
 
+static int s_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output) {
+    struct commoncrypto_ecc_key_pair *cc_key = key_pair->impl;
+    struct commoncrypto_ecc_key_pair *cc_peer_key = peer_key->impl;
+
+    if (!cc_key->priv_key_ref || !cc_peer_key->pub_key_ref) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    /* the standard algorithm takes no parameters, but the call still wants a dictionary. */
+    CFDictionaryRef parameters = CFDictionaryCreate(
+        cc_key->cf_allocator, NULL, NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+
+    if (!parameters) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    CFErrorRef error = NULL;
+    CFDataRef shared_secret = SecKeyCopyKeyExchangeResult(
+        cc_key->priv_key_ref, kSecKeyAlgorithmECDHKeyExchangeStandard, cc_peer_key->pub_key_ref, parameters, &error);
+    CFRelease(parameters);
+
+    if (!shared_secret) {
+        if (error) {
+            CFRelease(error);
+        }
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct aws_byte_cursor to_write =
+        aws_byte_cursor_from_array(CFDataGetBytePtr(shared_secret), CFDataGetLength(shared_secret));
+
+    int result = AWS_OP_SUCCESS;
+    if (aws_byte_buf_append(shared_secret_output, &to_write)) {
+        result = aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    CFRelease(shared_secret);
+    return result;
+}
+
+#if !defined(AWS_OS_IOS)
+static int s_export_generated_key_data(struct commoncrypto_ecc_key_pair *cc_key_pair) {
+    struct aws_allocator *allocator = cc_key_pair->key_pair.allocator;
+    size_t key_coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(cc_key_pair->key_pair.curve_name);
+    enum aws_ecc_curve_name curve_name = cc_key_pair->key_pair.curve_name;
+    CFDataRef sec_key_export_data = NULL;
+    int result = AWS_OP_ERR;
+
+    /* Apple assumed we'd never need the raw key data. Apple was wrong. So we have to export the key into the OpenSSL
+     * format (just fancy words for DER), then use our handy dandy DER decoder and grab the raw key data out. */
+    OSStatus ret_code = SecItemExport(cc_key_pair->priv_key_ref, kSecFormatOpenSSL, 0, NULL, &sec_key_export_data);
+
+    if (ret_code != errSecSuccess) {
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        goto done;
+    }
+
+    struct aws_byte_cursor key_cur =
+        aws_byte_cursor_from_array(CFDataGetBytePtr(sec_key_export_data), CFDataGetLength(sec_key_export_data));
+
+    struct aws_byte_cursor pub_x;
+    AWS_ZERO_STRUCT(pub_x);
+    struct aws_byte_cursor pub_y;
+    AWS_ZERO_STRUCT(pub_y);
+    struct aws_byte_cursor priv_d;
+    AWS_ZERO_STRUCT(priv_d);
+
+    if (aws_der_load_ecc_key_pair(key_cur, &pub_x, &pub_y, &priv_d, &curve_name)) {
+        goto done;
+    }
+
+    AWS_ASSERT(
+        priv_d.len == key_coordinate_size && pub_x.len == key_coordinate_size && pub_y.len == key_coordinate_size &&
+        "Apple Security Framework had better have exported the full pair.");
+
+    size_t total_buffer_size = key_coordinate_size * 3 + 1;
+
+    if (aws_byte_buf_init(&cc_key_pair->key_pair.key_buf, allocator, total_buffer_size)) {
+        goto done;
+    }
+
+    aws_byte_buf_write_u8(&cc_key_pair->key_pair.key_buf, s_preamble);
+    aws_byte_buf_append(&cc_key_pair->key_pair.key_buf, &pub_x);
+    aws_byte_buf_append(&cc_key_pair->key_pair.key_buf, &pub_y);
+    aws_byte_buf_append(&cc_key_pair->key_pair.key_buf, &priv_d);
+
+    /* cc_key_pair->key_pair.key_buf is contiguous memory, so just load up the offsets. */
+    cc_key_pair->key_pair.pub_x =
+        aws_byte_buf_from_array(cc_key_pair->key_pair.key_buf.buffer + 1, key_coordinate_size);
+    cc_key_pair->key_pair.pub_y =
+        aws_byte_buf_from_array(cc_key_pair->key_pair.pub_x.buffer + key_coordinate_size, key_coordinate_size);
+    cc_key_pair->key_pair.priv_d =
+        aws_byte_buf_from_array(cc_key_pair->key_pair.pub_y.buffer + key_coordinate_size, key_coordinate_size);
+
+    result = AWS_OP_SUCCESS;
+
+done:
+    if (sec_key_export_data) {
+        CFRelease(sec_key_export_data);
+    }
+
+    return result;
+}
+
+static void s_export_key_data_once(void *user_data) {
+    struct commoncrypto_ecc_key_pair *cc_key_pair = user_data;
+
+    if (s_export_generated_key_data(cc_key_pair)) {
+        cc_key_pair->key_data_error = aws_last_error();
+    }
+}
+#endif /* AWS_OS_IOS */
+
+static int s_load_key_data(struct aws_ecc_key_pair *key_pair) {
+    struct commoncrypto_ecc_key_pair *cc_key_pair = key_pair->impl;
+
+    if (!cc_key_pair->key_data_pending) {
+        return AWS_OP_SUCCESS;
+    }
+
+#if !defined(AWS_OS_IOS)
+    aws_thread_call_once(&cc_key_pair->key_data_once, s_export_key_data_once, cc_key_pair);
+#endif /* AWS_OS_IOS */
+
+    return cc_key_pair->key_data_error ? aws_raise_error(cc_key_pair->key_data_error) : AWS_OP_SUCCESS;
+}
+
 static struct aws_ecc_key_pair_vtable s_key_pair_vtable = {
     .sign_message = s_sign_message,
     .signature_length = s_signature_length,
     .verify_signature = s_verify_signature,
     .derive_pub_key = s_derive_public_key,
+    .sign_message_raw = s_sign_message_raw,
+    .verify_signature_raw = s_verify_signature_raw,
+    .derive_shared_secret = s_derive_shared_secret,
+    .load_key_data = s_load_key_data,
     .destroy = s_destroy_key,
 };
 
+/* Security framework only exposes the NIST curves, 25519 lives in CryptoKit which has no C API. */
+static bool s_is_supported_curve(enum aws_ecc_curve_name curve_name) {
+    if (curve_name == AWS_CAL_ECDSA_P256 || curve_name == AWS_CAL_ECDSA_P384) {
+        return true;
+    }
+
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return false;
+}
+
 static struct commoncrypto_ecc_key_pair *s_alloc_pair_and_init_buffers(
     struct aws_allocator *allocator,
     enum aws_ecc_curve_name curve_name,
     struct aws_byte_cursor pub_x,
     struct aws_byte_cursor pub_y,
     struct aws_byte_cursor priv_key) {
+    if (!s_is_supported_curve(curve_name)) {
+        return NULL;
+    }
+
     struct commoncrypto_ecc_key_pair *cc_key_pair =
         aws_mem_calloc(allocator, 1, sizeof(struct commoncrypto_ecc_key_pair));
 
@@ -338,6 +528,10 @@ error:
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_generate_random(
     struct aws_allocator *allocator,
     enum aws_ecc_curve_name curve_name) {
+    if (!s_is_supported_curve(curve_name)) {
+        return NULL;
+    }
+
     struct commoncrypto_ecc_key_pair *cc_key_pair =
         aws_mem_calloc(allocator, 1, sizeof(struct commoncrypto_ecc_key_pair));
 
@@ -345,10 +539,8 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_generate_random(
         return NULL;
     }
 
-    CFDataRef sec_key_export_data = NULL;
     CFStringRef key_size_cf_str = NULL;
     CFMutableDictionaryRef key_attributes = NULL;
-    struct aws_der_decoder *decoder = NULL;
 
     aws_atomic_init_int(&cc_key_pair->key_pair.ref_count, 1);
     cc_key_pair->key_pair.impl = cc_key_pair;
@@ -397,86 +589,25 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_generate_random(
 
     cc_key_pair->pub_key_ref = SecKeyCopyPublicKey(cc_key_pair->priv_key_ref);
 
-    /* OKAY up to here was incredibly reasonable, after this we get attacked by the bad API design
-     * dragons.
-     *
-     * Summary: Apple assumed we'd never need the raw key data. Apple was wrong. So we have to export each component
-     * into the OpenSSL format (just fancy words for DER), but the public key and private key are exported separately
-     * for some reason. Anyways, we export the keys, use our handy dandy DER decoder and grab the raw key data out. */
-    OSStatus ret_code = SecItemExport(cc_key_pair->priv_key_ref, kSecFormatOpenSSL, 0, NULL, &sec_key_export_data);
-
-    if (ret_code != errSecSuccess) {
-        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
-        goto error;
-    }
-
-    /* now we need to DER decode data */
-    struct aws_byte_cursor key_cur =
-        aws_byte_cursor_from_array(CFDataGetBytePtr(sec_key_export_data), CFDataGetLength(sec_key_export_data));
-
-    decoder = aws_der_decoder_new(allocator, key_cur);
-
-    if (!decoder) {
-        goto error;
-    }
-
-    struct aws_byte_cursor pub_x;
-    AWS_ZERO_STRUCT(pub_x);
-    struct aws_byte_cursor pub_y;
-    AWS_ZERO_STRUCT(pub_y);
-    struct aws_byte_cursor priv_d;
-    AWS_ZERO_STRUCT(priv_d);
-
-    if (aws_der_decoder_load_ecc_key_pair(decoder, &pub_x, &pub_y, &priv_d, &curve_name)) {
-        goto error;
-    }
-
-    AWS_ASSERT(
-        priv_d.len == key_coordinate_size && pub_x.len == key_coordinate_size && pub_y.len == key_coordinate_size &&
-        "Apple Security Framework had better have exported the full pair.");
-
-    size_t total_buffer_size = key_coordinate_size * 3 + 1;
-
-    if (aws_byte_buf_init(&cc_key_pair->key_pair.key_buf, allocator, total_buffer_size)) {
-        goto error;
-    }
-
-    aws_byte_buf_write_u8(&cc_key_pair->key_pair.key_buf, s_preamble);
-    aws_byte_buf_append(&cc_key_pair->key_pair.key_buf, &pub_x);
-    aws_byte_buf_append(&cc_key_pair->key_pair.key_buf, &pub_y);
-    aws_byte_buf_append(&cc_key_pair->key_pair.key_buf, &priv_d);
-
-    /* cc_key_pair->key_pair.key_buf is contiguous memory, so just load up the offsets. */
-    cc_key_pair->key_pair.pub_x =
-        aws_byte_buf_from_array(cc_key_pair->key_pair.key_buf.buffer + 1, key_coordinate_size);
-    cc_key_pair->key_pair.pub_y =
-        aws_byte_buf_from_array(cc_key_pair->key_pair.pub_x.buffer + key_coordinate_size, key_coordinate_size);
-    cc_key_pair->key_pair.priv_d =
-        aws_byte_buf_from_array(cc_key_pair->key_pair.pub_y.buffer + key_coordinate_size, key_coordinate_size);
+    /* Getting the raw coordinates back out costs an export and a DER decode, which keys that only sign or agree never
+     * need, so that's deferred to s_load_key_data(). */
+    aws_thread_once once_init = AWS_THREAD_ONCE_STATIC_INIT;
+    cc_key_pair->key_data_once = once_init;
+    cc_key_pair->key_data_pending = true;
 
     cc_key_pair->key_pair.curve_name = curve_name;
     cc_key_pair->key_pair.vtable = &s_key_pair_vtable;
 
-    CFRelease(sec_key_export_data);
     CFRelease(key_size_cf_str);
     CFRelease(key_attributes);
-    aws_der_decoder_destroy(decoder);
 
     return &cc_key_pair->key_pair;
 
 error:
-    if (decoder) {
-        aws_der_decoder_destroy(decoder);
-    }
-
     if (key_attributes) {
         CFRelease(key_attributes);
     }
 
-    if (sec_key_export_data) {
-        CFRelease(sec_key_export_data);
-    }
-
     if (key_size_cf_str) {
         CFRelease(key_size_cf_str);
     }
@@ -491,14 +622,9 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
     const struct aws_byte_cursor *encoded_keys) {
 
     struct aws_ecc_key_pair *key_pair = NULL;
-    struct aws_der_decoder *decoder = aws_der_decoder_new(allocator, *encoded_keys);
     CFMutableDictionaryRef key_attributes = NULL;
     CFDataRef key_data = NULL;
 
-    if (!decoder) {
-        return NULL;
-    }
-
     /* we could have private key or a public key, or a full pair. */
     struct aws_byte_cursor pub_x;
     AWS_ZERO_STRUCT(pub_x);
@@ -508,7 +634,7 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
     AWS_ZERO_STRUCT(priv_d);
     enum aws_ecc_curve_name curve_name;
 
-    if (aws_der_decoder_load_ecc_key_pair(decoder, &pub_x, &pub_y, &priv_d, &curve_name)) {
+    if (aws_der_load_ecc_key_pair(*encoded_keys, &pub_x, &pub_y, &priv_d, &curve_name)) {
         goto error;
     }
 
@@ -570,15 +696,10 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
 
     CFRelease(key_attributes);
     CFRelease(key_data);
-    aws_der_decoder_destroy(decoder);
 
     return key_pair;
 
 error:
-    if (decoder) {
-        aws_der_decoder_destroy(decoder);
-    }
-
     if (key_attributes) {
         CFRelease(key_attributes);
     }
@@ -37,14 +37,14 @@ struct der_tlv {
 };
 
 static void s_decode_tlv(struct der_tlv *tlv) {
-    if (tlv->tag == AWS_DER_INTEGER) {
+    if (tlv->tag == AWS_DER_INTEGER && tlv->length) {
         uint8_t first_byte = tlv->value[0];
         /* if the first byte is 0, it just denotes unsigned and should be removed */
         if (first_byte == 0x00) {
             tlv->length -= 1;
             tlv->value += 1;
         }
-    } else if (tlv->tag == AWS_DER_BIT_STRING) {
+    } else if (tlv->tag == AWS_DER_BIT_STRING && tlv->length) {
         /* skip over the trailing skipped bit count */
         tlv->length -= 1;
         tlv->value += 1;
@@ -88,6 +88,10 @@ static int s_der_read_tlv(struct aws_byte_cursor *cur, struct der_tlv *tlv) {
         len = len_bytes;
     }
 
+    if (len > cur->len) {
+        return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
+    }
+
     tlv->tag = tag;
     tlv->length = len;
     tlv->value = (tag == AWS_DER_NULL) ? NULL : cur->ptr;
@@ -344,6 +348,185 @@ int aws_der_encoder_get_contents(struct aws_der_encoder *encoder, struct aws_byt
     return AWS_OP_SUCCESS;
 }
 
+/*
+ * IN PLACE ENCODER
+ */
+void aws_der_inplace_encoder_init(struct aws_der_inplace_encoder *encoder, struct aws_byte_buf *output) {
+    AWS_ZERO_STRUCT(*encoder);
+    encoder->output = output;
+}
+
+/* writes a whole TLV or nothing, so a failed write leaves output as it was */
+static int s_inplace_write_tlv(struct aws_der_inplace_encoder *encoder, struct der_tlv *tlv) {
+    size_t starting_len = encoder->output->len;
+    if (s_der_write_tlv(tlv, encoder->output)) {
+        encoder->output->len = starting_len;
+        return AWS_OP_ERR;
+    }
+    return AWS_OP_SUCCESS;
+}
+
+int aws_der_inplace_encoder_write_integer(struct aws_der_inplace_encoder *encoder, struct aws_byte_cursor integer) {
+    AWS_FATAL_ASSERT(integer.len <= UINT32_MAX);
+    struct der_tlv tlv = {
+        .tag = AWS_DER_INTEGER,
+        .length = (uint32_t)integer.len,
+        .value = integer.ptr,
+    };
+
+    return s_inplace_write_tlv(encoder, &tlv);
+}
+
+int aws_der_inplace_encoder_write_boolean(struct aws_der_inplace_encoder *encoder, bool boolean) {
+    struct der_tlv tlv = {.tag = AWS_DER_BOOLEAN, .length = 1, .value = (uint8_t *)&boolean};
+
+    return s_inplace_write_tlv(encoder, &tlv);
+}
+
+int aws_der_inplace_encoder_write_null(struct aws_der_inplace_encoder *encoder) {
+    struct der_tlv tlv = {
+        .tag = AWS_DER_NULL,
+        .length = 0,
+        .value = NULL,
+    };
+
+    return s_inplace_write_tlv(encoder, &tlv);
+}
+
+int aws_der_inplace_encoder_write_bit_string(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor bit_string) {
+    AWS_FATAL_ASSERT(bit_string.len <= UINT32_MAX);
+    struct der_tlv tlv = {
+        .tag = AWS_DER_BIT_STRING,
+        .length = (uint32_t)bit_string.len,
+        .value = bit_string.ptr,
+    };
+
+    return s_inplace_write_tlv(encoder, &tlv);
+}
+
+int aws_der_inplace_encoder_write_octet_string(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor octet_string) {
+    AWS_FATAL_ASSERT(octet_string.len <= UINT32_MAX);
+    struct der_tlv tlv = {
+        .tag = AWS_DER_OCTET_STRING,
+        .length = (uint32_t)octet_string.len,
+        .value = octet_string.ptr,
+    };
+
+    return s_inplace_write_tlv(encoder, &tlv);
+}
+
+int aws_der_inplace_encoder_write_object_identifier(
+    struct aws_der_inplace_encoder *encoder,
+    struct aws_byte_cursor oid) {
+    AWS_FATAL_ASSERT(oid.len <= UINT32_MAX);
+    struct der_tlv tlv = {
+        .tag = AWS_DER_OBJECT_IDENTIFIER,
+        .length = (uint32_t)oid.len,
+        .value = oid.ptr,
+    };
+
+    return s_inplace_write_tlv(encoder, &tlv);
+}
+
+static int s_inplace_begin_container(struct aws_der_inplace_encoder *encoder, enum aws_der_type type) {
+    if (encoder->depth >= AWS_DER_ENCODER_MAX_DEPTH) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_byte_buf *output = encoder->output;
+    if (output->capacity - output->len < 2) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    aws_byte_buf_write_u8(output, (uint8_t)type);
+    /* short form placeholder, most containers never need more */
+    encoder->container_lengths[encoder->depth++] = output->len;
+    aws_byte_buf_write_u8(output, 0);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_inplace_end_container(struct aws_der_inplace_encoder *encoder) {
+    if (encoder->depth == 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_byte_buf *output = encoder->output;
+    size_t length_offset = encoder->container_lengths[encoder->depth - 1];
+    size_t contents_len = output->len - length_offset - 1;
+    if (contents_len > UINT32_MAX) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    /* same length forms as s_der_write_tlv() */
+    uint8_t length_bytes = 0;
+    if (contents_len > UINT16_MAX) {
+        length_bytes = 4;
+    } else if (contents_len > UINT8_MAX) {
+        length_bytes = 2;
+    } else if (contents_len > INT8_MAX) {
+        length_bytes = 1;
+    }
+
+    if (length_bytes == 0) {
+        output->buffer[length_offset] = (uint8_t)contents_len;
+        --encoder->depth;
+        return AWS_OP_SUCCESS;
+    }
+
+    if (output->capacity - output->len < length_bytes) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    uint8_t *contents = output->buffer + length_offset + 1;
+    memmove(contents + length_bytes, contents, contents_len);
+    output->len += length_bytes;
+
+    struct aws_byte_buf length_buf = aws_byte_buf_from_empty_array(output->buffer + length_offset, 1 + length_bytes);
+    aws_byte_buf_write_u8(&length_buf, 0x80 | length_bytes);
+    switch (length_bytes) {
+        case 4:
+            aws_byte_buf_write_be32(&length_buf, (uint32_t)contents_len);
+            break;
+        case 2:
+            aws_byte_buf_write_be16(&length_buf, (uint16_t)contents_len);
+            break;
+        default:
+            aws_byte_buf_write_u8(&length_buf, (uint8_t)contents_len);
+            break;
+    }
+
+    --encoder->depth;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_der_inplace_encoder_begin_sequence(struct aws_der_inplace_encoder *encoder) {
+    return s_inplace_begin_container(encoder, AWS_DER_SEQUENCE);
+}
+
+int aws_der_inplace_encoder_end_sequence(struct aws_der_inplace_encoder *encoder) {
+    return s_inplace_end_container(encoder);
+}
+
+int aws_der_inplace_encoder_begin_set(struct aws_der_inplace_encoder *encoder) {
+    return s_inplace_begin_container(encoder, AWS_DER_SET);
+}
+
+int aws_der_inplace_encoder_end_set(struct aws_der_inplace_encoder *encoder) {
+    return s_inplace_end_container(encoder);
+}
+
+int aws_der_inplace_encoder_finish(struct aws_der_inplace_encoder *encoder) {
+    if (encoder->depth != 0) {
+        /* someone forgot to end a sequence or set */
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+    return AWS_OP_SUCCESS;
+}
+
 /*
  * DECODER
  */
@@ -383,7 +566,7 @@ void aws_der_decoder_destroy(struct aws_der_decoder *decoder) {
 }
 
 int s_parse_cursor(struct aws_der_decoder *decoder, struct aws_byte_cursor cur) {
-    if (++decoder->depth > 16) {
+    if (++decoder->depth > AWS_DER_DECODER_MAX_DEPTH) {
         /* stream contains too many nested containers, probably malformed/attack */
         return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
     }
@@ -496,6 +679,133 @@ int aws_der_decoder_tlv_blob(struct aws_der_decoder *decoder, struct aws_byte_cu
     return AWS_OP_SUCCESS;
 }
 
+/*
+ * PULL DECODER
+ */
+void aws_der_pull_decoder_init(struct aws_der_pull_decoder *decoder, struct aws_byte_cursor input) {
+    AWS_ZERO_STRUCT(*decoder);
+    decoder->levels[0] = input;
+}
+
+bool aws_der_pull_decoder_next(struct aws_der_pull_decoder *decoder) {
+    decoder->has_tlv = false;
+    if (decoder->error_code) {
+        return false;
+    }
+
+    struct aws_byte_cursor *cur = &decoder->levels[decoder->depth];
+    if (cur->len == 0) {
+        return false;
+    }
+
+    struct der_tlv tlv = {0};
+    if (s_der_read_tlv(cur, &tlv)) {
+        decoder->error_code = AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED;
+        aws_raise_error(decoder->error_code);
+        return false;
+    }
+    /* skip trailing newlines in the stream after any TLV */
+    while (cur->len && *cur->ptr == '\n') {
+        aws_byte_cursor_advance(cur, 1);
+    }
+
+    decoder->has_tlv = true;
+    decoder->tag = tlv.tag;
+    decoder->value = aws_byte_cursor_from_array(tlv.value, tlv.length);
+    return true;
+}
+
+int aws_der_pull_decoder_enter(struct aws_der_pull_decoder *decoder) {
+    if (!decoder->has_tlv) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+    if (!(decoder->tag & AWS_DER_FORM_CONSTRUCTED)) {
+        return aws_raise_error(AWS_ERROR_CAL_MISMATCHED_DER_TYPE);
+    }
+    if (decoder->depth + 1 >= AWS_DER_DECODER_MAX_DEPTH) {
+        /* stream contains too many nested containers, probably malformed/attack */
+        decoder->error_code = AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED;
+        return aws_raise_error(decoder->error_code);
+    }
+
+    /* the enclosing level was already advanced past the whole container when it was read */
+    decoder->levels[++decoder->depth] = decoder->value;
+    decoder->has_tlv = false;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_der_pull_decoder_exit(struct aws_der_pull_decoder *decoder) {
+    if (decoder->depth == 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    --decoder->depth;
+    decoder->has_tlv = false;
+    return AWS_OP_SUCCESS;
+}
+
+bool aws_der_pull_decoder_next_in_order(struct aws_der_pull_decoder *decoder) {
+    if (decoder->has_tlv && (decoder->tag & AWS_DER_FORM_CONSTRUCTED) && aws_der_pull_decoder_enter(decoder)) {
+        return false;
+    }
+
+    while (!aws_der_pull_decoder_next(decoder)) {
+        if (decoder->error_code || decoder->depth == 0) {
+            return false;
+        }
+        aws_der_pull_decoder_exit(decoder);
+    }
+
+    return true;
+}
+
+enum aws_der_type aws_der_pull_decoder_tlv_type(const struct aws_der_pull_decoder *decoder) {
+    AWS_FATAL_ASSERT(decoder->has_tlv);
+    return decoder->tag;
+}
+
+size_t aws_der_pull_decoder_tlv_length(const struct aws_der_pull_decoder *decoder) {
+    AWS_FATAL_ASSERT(decoder->has_tlv);
+    return decoder->value.len;
+}
+
+int aws_der_pull_decoder_tlv_string(const struct aws_der_pull_decoder *decoder, struct aws_byte_cursor *string) {
+    AWS_FATAL_ASSERT(decoder->has_tlv);
+    if (decoder->tag != AWS_DER_OCTET_STRING && decoder->tag != AWS_DER_BIT_STRING) {
+        return aws_raise_error(AWS_ERROR_CAL_MISMATCHED_DER_TYPE);
+    }
+    *string = decoder->value;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_der_pull_decoder_tlv_integer(const struct aws_der_pull_decoder *decoder, struct aws_byte_cursor *integer) {
+    AWS_FATAL_ASSERT(decoder->has_tlv);
+    if (decoder->tag != AWS_DER_INTEGER) {
+        return aws_raise_error(AWS_ERROR_CAL_MISMATCHED_DER_TYPE);
+    }
+    *integer = decoder->value;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_der_pull_decoder_tlv_boolean(const struct aws_der_pull_decoder *decoder, bool *boolean) {
+    AWS_FATAL_ASSERT(decoder->has_tlv);
+    if (decoder->tag != AWS_DER_BOOLEAN) {
+        return aws_raise_error(AWS_ERROR_CAL_MISMATCHED_DER_TYPE);
+    }
+    if (decoder->value.len == 0) {
+        return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
+    }
+    *boolean = *decoder->value.ptr != 0;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_der_pull_decoder_tlv_blob(const struct aws_der_pull_decoder *decoder, struct aws_byte_cursor *blob) {
+    AWS_FATAL_ASSERT(decoder->has_tlv);
+    AWS_FATAL_ASSERT(decoder->tag != AWS_DER_NULL);
+    *blob = decoder->value;
+    return AWS_OP_SUCCESS;
+}
+
 #ifdef _MSC_VER
 #    pragma warning(pop)
 #endif
@@ -5,6 +5,7 @@
 #include <aws/cal/private/ecc.h>
 
 #include <aws/cal/cal.h>
+#include <aws/cal/hash.h>
 #include <aws/cal/private/der.h>
 #include <aws/common/encoding.h>
 
@@ -35,6 +36,18 @@ static uint8_t s_p384_oid[] = {
 };
 STATIC_INIT_BYTE_CURSOR(s_p384_oid, ecc_p384_oid)
 
+/* id-ecPublicKey, 1.2.840.10045.2.1 */
+static uint8_t s_ec_public_key_oid[] = {
+    0x2A,
+    0x86,
+    0x48,
+    0xCE,
+    0x3D,
+    0x02,
+    0x01,
+};
+STATIC_INIT_BYTE_CURSOR(s_ec_public_key_oid, ecc_ec_public_key_oid)
+
 static struct aws_byte_cursor *s_ecc_curve_oids[] = {
     [AWS_CAL_ECDSA_P256] = &s_ecc_p256_oid,
     [AWS_CAL_ECDSA_P384] = &s_ecc_p384_oid,
@@ -123,6 +136,13 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_public_key(
     enum aws_ecc_curve_name curve_name,
     const struct aws_byte_cursor *public_key_x,
     const struct aws_byte_cursor *public_key_y) {
+    /* 25519 keys have no y coordinate, let backends always dereference it */
+    struct aws_byte_cursor empty_y;
+    AWS_ZERO_STRUCT(empty_y);
+    if (public_key_y == NULL) {
+        public_key_y = &empty_y;
+    }
+
     return s_ecc_key_pair_new_from_public_key_fn(allocator, curve_name, public_key_x, public_key_y);
 }
 
@@ -162,35 +182,335 @@ int aws_ecc_key_pair_verify_signature(
     return key_pair->vtable->verify_signature(key_pair, message, signature);
 }
 
+int aws_ecc_key_pair_verify_signature_batch(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *messages,
+    const struct aws_byte_cursor *signatures,
+    size_t count,
+    uint8_t *valid_bitmap) {
+    AWS_PRECONDITION(count == 0 || (messages != NULL && signatures != NULL && valid_bitmap != NULL));
+
+    if (key_pair->vtable->verify_signature_batch) {
+        return key_pair->vtable->verify_signature_batch(key_pair, messages, signatures, count, valid_bitmap);
+    }
+
+    AWS_FATAL_ASSERT(
+        key_pair->vtable->verify_signature && "ECC KEY PAIR verify signature must be included on the vtable");
+
+    memset(valid_bitmap, 0, AWS_ECC_VERIFY_BATCH_BITMAP_LEN(count));
+    bool all_valid = true;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (key_pair->vtable->verify_signature(key_pair, &messages[i], &signatures[i]) == AWS_OP_SUCCESS) {
+            valid_bitmap[i / 8] |= (uint8_t)(1u << (i % 8));
+        } else {
+            all_valid = false;
+        }
+    }
+
+    return all_valid ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+}
+
+int aws_ecc_key_pair_prepare_for_verification(struct aws_ecc_key_pair *key_pair) {
+    if (!key_pair->vtable->prepare_for_verification) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return key_pair->vtable->prepare_for_verification(key_pair);
+}
+
 size_t aws_ecc_key_pair_signature_length(const struct aws_ecc_key_pair *key_pair) {
     AWS_FATAL_ASSERT(
         key_pair->vtable->signature_length && "ECC KEY PAIR signature length must be included on the vtable");
     return key_pair->vtable->signature_length(key_pair);
 }
 
+size_t aws_ecc_key_pair_raw_signature_length(const struct aws_ecc_key_pair *key_pair) {
+    return aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name) * 2;
+}
+
+static bool s_trim_zeros_predicate(uint8_t value) {
+    return value == 0;
+}
+
+/* largest coordinate the DER signature helpers deal with, P-384's */
+#define S_MAX_COORDINATE_SIZE 48
+/* SEQUENCE header plus two INTEGERs, each with its own header and a possible leading zero */
+#define S_MAX_DER_SIGNATURE_SIZE (2 + 2 * (2 + 1 + S_MAX_COORDINATE_SIZE))
+
+/* reads the next DER INTEGER of an ECDSA-Sig-Value and writes it zero padded to coordinate_size bytes. */
+static int s_append_raw_signature_integer(
+    struct aws_der_pull_decoder *decoder,
+    size_t coordinate_size,
+    struct aws_byte_buf *raw_output) {
+    struct aws_byte_cursor integer;
+    AWS_ZERO_STRUCT(integer);
+
+    if (!aws_der_pull_decoder_next(decoder) || aws_der_pull_decoder_tlv_integer(decoder, &integer)) {
+        return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
+    }
+
+    /* DER adds a leading zero to keep the value positive, drop it along with any other padding */
+    integer = aws_byte_cursor_left_trim_pred(&integer, s_trim_zeros_predicate);
+    if (integer.len > coordinate_size) {
+        return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
+    }
+
+    aws_byte_buf_write_u8_n(raw_output, 0x0, coordinate_size - integer.len);
+    aws_byte_buf_write_from_whole_cursor(raw_output, integer);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sign_message_raw_from_der(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    size_t coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name);
+
+    struct aws_byte_buf der_signature;
+    if (aws_byte_buf_init(&der_signature, key_pair->allocator, aws_ecc_key_pair_signature_length(key_pair))) {
+        return AWS_OP_ERR;
+    }
+
+    int ret_val = AWS_OP_ERR;
+
+    if (aws_ecc_key_pair_sign_message(key_pair, message, &der_signature)) {
+        goto clean_up;
+    }
+
+    struct aws_der_pull_decoder decoder;
+    aws_der_pull_decoder_init(&decoder, aws_byte_cursor_from_buf(&der_signature));
+
+    if (!aws_der_pull_decoder_next(&decoder) || aws_der_pull_decoder_tlv_type(&decoder) != AWS_DER_SEQUENCE ||
+        aws_der_pull_decoder_enter(&decoder)) {
+        aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
+        goto clean_up;
+    }
+
+    size_t starting_len = signature_output->len;
+    if (s_append_raw_signature_integer(&decoder, coordinate_size, signature_output) ||
+        s_append_raw_signature_integer(&decoder, coordinate_size, signature_output)) {
+        signature_output->len = starting_len;
+        goto clean_up;
+    }
+
+    ret_val = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_byte_buf_clean_up(&der_signature);
+    return ret_val;
+}
+
+static int s_verify_signature_raw_from_der(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    size_t coordinate_size = signature->len / 2;
+    if (coordinate_size > S_MAX_COORDINATE_SIZE) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    uint8_t der_signature_storage[S_MAX_DER_SIGNATURE_SIZE];
+    struct aws_byte_buf der_signature_buf =
+        aws_byte_buf_from_empty_array(der_signature_storage, sizeof(der_signature_storage));
+    struct aws_der_inplace_encoder encoder;
+    aws_der_inplace_encoder_init(&encoder, &der_signature_buf);
+
+    struct aws_byte_cursor r = aws_byte_cursor_from_array(signature->ptr, coordinate_size);
+    struct aws_byte_cursor s = aws_byte_cursor_from_array(signature->ptr + coordinate_size, coordinate_size);
+    r = aws_byte_cursor_left_trim_pred(&r, s_trim_zeros_predicate);
+    s = aws_byte_cursor_left_trim_pred(&s, s_trim_zeros_predicate);
+
+    /* zero is never a valid r or s, and DER has no way to write it without a content byte */
+    if (r.len == 0 || s.len == 0) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    if (aws_der_inplace_encoder_begin_sequence(&encoder) || aws_der_inplace_encoder_write_integer(&encoder, r) ||
+        aws_der_inplace_encoder_write_integer(&encoder, s) || aws_der_inplace_encoder_end_sequence(&encoder) ||
+        aws_der_inplace_encoder_finish(&encoder)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor der_signature = aws_byte_cursor_from_buf(&der_signature_buf);
+    return aws_ecc_key_pair_verify_signature(key_pair, message, &der_signature);
+}
+
+int aws_ecc_key_pair_sign_message_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    AWS_PRECONDITION(aws_byte_buf_is_valid(signature_output));
+
+    if (signature_output->capacity - signature_output->len < aws_ecc_key_pair_raw_signature_length(key_pair)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    if (key_pair->vtable->sign_message_raw) {
+        return key_pair->vtable->sign_message_raw(key_pair, message, signature_output);
+    }
+
+    return s_sign_message_raw_from_der(key_pair, message, signature_output);
+}
+
+int aws_ecc_key_pair_verify_signature_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+
+    if (signature->len != aws_ecc_key_pair_raw_signature_length(key_pair)) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    if (key_pair->vtable->verify_signature_raw) {
+        return key_pair->vtable->verify_signature_raw(key_pair, message, signature);
+    }
+
+    return s_verify_signature_raw_from_der(key_pair, message, signature);
+}
+
+static int s_load_key_data(const struct aws_ecc_key_pair *key_pair) {
+    if (key_pair->vtable->load_key_data == NULL) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* loading only fills in what the key already is, so it stays logically const */
+    return key_pair->vtable->load_key_data((struct aws_ecc_key_pair *)key_pair);
+}
+
 void aws_ecc_key_pair_get_public_key(
     const struct aws_ecc_key_pair *key_pair,
     struct aws_byte_cursor *pub_x,
     struct aws_byte_cursor *pub_y) {
+    if (s_load_key_data(key_pair)) {
+        AWS_ZERO_STRUCT(*pub_x);
+        AWS_ZERO_STRUCT(*pub_y);
+        return;
+    }
+
     *pub_x = aws_byte_cursor_from_buf(&key_pair->pub_x);
     *pub_y = aws_byte_cursor_from_buf(&key_pair->pub_y);
 }
 
 void aws_ecc_key_pair_get_private_key(const struct aws_ecc_key_pair *key_pair, struct aws_byte_cursor *private_d) {
+    if (s_load_key_data(key_pair)) {
+        AWS_ZERO_STRUCT(*private_d);
+        return;
+    }
+
     *private_d = aws_byte_cursor_from_buf(&key_pair->priv_d);
 }
 
+int aws_ecc_key_pair_write_public_key_spki(const struct aws_ecc_key_pair *key_pair, struct aws_byte_buf *output) {
+    AWS_PRECONDITION(key_pair);
+    AWS_PRECONDITION(aws_byte_buf_is_valid(output));
+
+    struct aws_byte_cursor curve_oid;
+    if (aws_ecc_oid_from_curve_name(key_pair->curve_name, &curve_oid)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor pub_x;
+    struct aws_byte_cursor pub_y;
+    aws_ecc_key_pair_get_public_key(key_pair, &pub_x, &pub_y);
+    if (!pub_x.len || pub_x.len > S_MAX_COORDINATE_SIZE || pub_y.len != pub_x.len) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    /* uncompressed point: 0x04 || x || y */
+    uint8_t point_storage[1 + 2 * S_MAX_COORDINATE_SIZE];
+    struct aws_byte_buf point = aws_byte_buf_from_empty_array(point_storage, sizeof(point_storage));
+    aws_byte_buf_write_u8(&point, 0x04);
+    aws_byte_buf_write_from_whole_cursor(&point, pub_x);
+    aws_byte_buf_write_from_whole_cursor(&point, pub_y);
+
+    size_t starting_len = output->len;
+    struct aws_der_inplace_encoder encoder;
+    aws_der_inplace_encoder_init(&encoder, output);
+
+    /* SEQUENCE { SEQUENCE { id-ecPublicKey, curve }, BIT STRING point } */
+    if (aws_der_inplace_encoder_begin_sequence(&encoder) || aws_der_inplace_encoder_begin_sequence(&encoder) ||
+        aws_der_inplace_encoder_write_object_identifier(&encoder, s_ecc_ec_public_key_oid) ||
+        aws_der_inplace_encoder_write_object_identifier(&encoder, curve_oid) ||
+        aws_der_inplace_encoder_end_sequence(&encoder) ||
+        aws_der_inplace_encoder_write_bit_string(&encoder, aws_byte_cursor_from_buf(&point)) ||
+        aws_der_inplace_encoder_end_sequence(&encoder) || aws_der_inplace_encoder_finish(&encoder)) {
+        output->len = starting_len;
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 size_t aws_ecc_key_coordinate_byte_size_from_curve_name(enum aws_ecc_curve_name curve_name) {
     switch (curve_name) {
         case AWS_CAL_ECDSA_P256:
             return 32;
         case AWS_CAL_ECDSA_P384:
             return 48;
+        case AWS_CAL_ED25519:
+        case AWS_CAL_X25519:
+            return 32;
         default:
             return 0;
     }
 }
 
+/*
+ * Sorts out which of the (up to) two key strings found in an encoding is the private key and which the public key.
+ * you'd think we'd get some type hints on which key this is, but it's not consistent as far as I can tell, so it goes
+ * by length once the curve is known.
+ */
+static int s_assign_ecc_key_parts(
+    struct aws_byte_cursor pair_part_1,
+    struct aws_byte_cursor pair_part_2,
+    enum aws_ecc_curve_name curve_name,
+    struct aws_byte_cursor *out_public_x_coor,
+    struct aws_byte_cursor *out_public_y_coor,
+    struct aws_byte_cursor *out_private_d) {
+
+    size_t key_coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(curve_name);
+
+    struct aws_byte_cursor *private_key = NULL;
+    struct aws_byte_cursor *public_key = NULL;
+
+    size_t public_key_blob_size = key_coordinate_size * 2 + 1;
+
+    if (pair_part_1.ptr && pair_part_1.len) {
+        if (pair_part_1.len == key_coordinate_size) {
+            private_key = &pair_part_1;
+        } else if (pair_part_1.len == public_key_blob_size) {
+            public_key = &pair_part_1;
+        }
+    }
+
+    if (pair_part_2.ptr && pair_part_2.len) {
+        if (pair_part_2.len == key_coordinate_size) {
+            private_key = &pair_part_2;
+        } else if (pair_part_2.len == public_key_blob_size) {
+            public_key = &pair_part_2;
+        }
+    }
+
+    if (!private_key && !public_key) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    if (private_key) {
+        *out_private_d = *private_key;
+    }
+
+    if (public_key) {
+        aws_byte_cursor_advance(public_key, 1);
+        *out_public_x_coor = *public_key;
+        out_public_x_coor->len = key_coordinate_size;
+        out_public_y_coor->ptr = public_key->ptr + key_coordinate_size;
+        out_public_y_coor->len = key_coordinate_size;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 int aws_der_decoder_load_ecc_key_pair(
     struct aws_der_decoder *decoder,
     struct aws_byte_cursor *out_public_x_coor,
@@ -228,8 +548,6 @@ int aws_der_decoder_load_ecc_key_pair(
             continue;
         }
 
-        /* you'd think we'd get some type hints on which key this is, but it's not consistent
-         * as far as I can tell. */
         if (type == AWS_DER_BIT_STRING || type == AWS_DER_OCTET_STRING) {
             aws_der_decoder_tlv_string(decoder, current_part);
             current_part = &pair_part_2;
@@ -240,46 +558,62 @@ int aws_der_decoder_load_ecc_key_pair(
         return aws_raise_error(AWS_ERROR_CAL_UNKNOWN_OBJECT_IDENTIFIER);
     }
 
-    size_t key_coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(*out_curve_name);
+    return s_assign_ecc_key_parts(
+        pair_part_1, pair_part_2, *out_curve_name, out_public_x_coor, out_public_y_coor, out_private_d);
+}
 
-    struct aws_byte_cursor *private_key = NULL;
-    struct aws_byte_cursor *public_key = NULL;
+int aws_der_load_ecc_key_pair(
+    struct aws_byte_cursor encoded_keys,
+    struct aws_byte_cursor *out_public_x_coor,
+    struct aws_byte_cursor *out_public_y_coor,
+    struct aws_byte_cursor *out_private_d,
+    enum aws_ecc_curve_name *out_curve_name) {
 
-    size_t public_key_blob_size = key_coordinate_size * 2 + 1;
+    AWS_ZERO_STRUCT(*out_public_x_coor);
+    AWS_ZERO_STRUCT(*out_public_y_coor);
+    AWS_ZERO_STRUCT(*out_private_d);
 
-    if (pair_part_1.ptr && pair_part_1.len) {
-        if (pair_part_1.len == key_coordinate_size) {
-            private_key = &pair_part_1;
-        } else if (pair_part_1.len == public_key_blob_size) {
-            public_key = &pair_part_1;
-        }
-    }
+    struct aws_der_pull_decoder decoder;
+    aws_der_pull_decoder_init(&decoder, encoded_keys);
 
-    if (pair_part_2.ptr && pair_part_2.len) {
-        if (pair_part_2.len == key_coordinate_size) {
-            private_key = &pair_part_2;
-        } else if (pair_part_2.len == public_key_blob_size) {
-            public_key = &pair_part_2;
+    struct aws_byte_cursor pair_part_1;
+    AWS_ZERO_STRUCT(pair_part_1);
+    struct aws_byte_cursor pair_part_2;
+    AWS_ZERO_STRUCT(pair_part_2);
+
+    bool curve_name_recognized = false;
+    struct aws_byte_cursor *current_part = &pair_part_1;
+
+    /* same walk as aws_der_decoder_load_ecc_key_pair(), minus expanding the whole document up front */
+    while (aws_der_pull_decoder_next_in_order(&decoder)) {
+        enum aws_der_type type = aws_der_pull_decoder_tlv_type(&decoder);
+
+        if (type == AWS_DER_OBJECT_IDENTIFIER) {
+            struct aws_byte_cursor oid;
+            AWS_ZERO_STRUCT(oid);
+            aws_der_pull_decoder_tlv_blob(&decoder, &oid);
+            if (!aws_ecc_curve_name_from_oid(&oid, out_curve_name)) {
+                curve_name_recognized = true;
+            }
+            continue;
         }
-    }
 
-    if (!private_key && !public_key) {
-        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+        if (type == AWS_DER_BIT_STRING || type == AWS_DER_OCTET_STRING) {
+            aws_der_pull_decoder_tlv_string(&decoder, current_part);
+            current_part = &pair_part_2;
+        }
     }
 
-    if (private_key) {
-        *out_private_d = *private_key;
+    if (decoder.error_code) {
+        return aws_raise_error(decoder.error_code);
     }
 
-    if (public_key) {
-        aws_byte_cursor_advance(public_key, 1);
-        *out_public_x_coor = *public_key;
-        out_public_x_coor->len = key_coordinate_size;
-        out_public_y_coor->ptr = public_key->ptr + key_coordinate_size;
-        out_public_y_coor->len = key_coordinate_size;
+    if (!curve_name_recognized) {
+        return aws_raise_error(AWS_ERROR_CAL_UNKNOWN_OBJECT_IDENTIFIER);
     }
 
-    return AWS_OP_SUCCESS;
+    return s_assign_ecc_key_parts(
+        pair_part_1, pair_part_2, *out_curve_name, out_public_x_coor, out_public_y_coor, out_private_d);
 }
 
 void aws_ecc_key_pair_acquire(struct aws_ecc_key_pair *key_pair) {
@@ -338,3 +672,169 @@ done:
 
     return key;
 }
+
+int aws_ecc_key_pair_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output) {
+    AWS_PRECONDITION(aws_byte_buf_is_valid(shared_secret_output));
+
+    if (!key_pair->vtable->derive_shared_secret) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    if (peer_key->curve_name != key_pair->curve_name || peer_key->vtable != key_pair->vtable) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    size_t secret_length = aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name);
+    if (shared_secret_output->capacity - shared_secret_output->len < secret_length) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    return key_pair->vtable->derive_shared_secret(key_pair, peer_key, shared_secret_output);
+}
+
+struct aws_ecc_signing_context {
+    struct aws_allocator *allocator;
+    struct aws_ecc_key_pair *key_pair;
+    struct aws_hash *hash;
+};
+
+static struct aws_hash *s_new_signing_hash(struct aws_allocator *allocator, enum aws_ecc_curve_name curve_name) {
+    switch (curve_name) {
+        case AWS_CAL_ECDSA_P256:
+            return aws_sha256_new(allocator);
+        case AWS_CAL_ECDSA_P384:
+            return aws_sha384_new(allocator);
+        default:
+            aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+            return NULL;
+    }
+}
+
+struct aws_ecc_signing_context *aws_ecc_signing_context_new(
+    struct aws_allocator *allocator,
+    struct aws_ecc_key_pair *key_pair) {
+    AWS_PRECONDITION(key_pair);
+
+    struct aws_hash *hash = s_new_signing_hash(allocator, key_pair->curve_name);
+    if (!hash) {
+        return NULL;
+    }
+
+    struct aws_ecc_signing_context *context = aws_mem_calloc(allocator, 1, sizeof(struct aws_ecc_signing_context));
+    if (!context) {
+        aws_hash_destroy(hash);
+        return NULL;
+    }
+
+    context->allocator = allocator;
+    context->hash = hash;
+    context->key_pair = key_pair;
+    aws_ecc_key_pair_acquire(key_pair);
+
+    return context;
+}
+
+void aws_ecc_signing_context_destroy(struct aws_ecc_signing_context *context) {
+    if (context == NULL) {
+        return;
+    }
+
+    if (context->hash) {
+        aws_hash_destroy(context->hash);
+    }
+    aws_ecc_key_pair_release(context->key_pair);
+    aws_mem_release(context->allocator, context);
+}
+
+/*
+ * Gets the hash ready for the next message. Hashes that can't be reset are replaced, if that fails too the context is
+ * left without one and the next call reports the error.
+ */
+static void s_signing_context_restart(struct aws_ecc_signing_context *context) {
+    if (context->hash && aws_hash_reset(context->hash) == AWS_OP_SUCCESS) {
+        return;
+    }
+
+    if (context->hash) {
+        aws_hash_destroy(context->hash);
+    }
+    context->hash = s_new_signing_hash(context->allocator, context->key_pair->curve_name);
+}
+
+int aws_ecc_signing_context_update(struct aws_ecc_signing_context *context, const struct aws_byte_cursor *to_sign) {
+    if (!context->hash) {
+        s_signing_context_restart(context);
+        if (!context->hash) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return aws_hash_update(context->hash, to_sign);
+}
+
+/* finalizes the running digest into digest_output and restarts the context, whether or not that worked. */
+static int s_signing_context_finalize(struct aws_ecc_signing_context *context, struct aws_byte_buf *digest_output) {
+    if (!context->hash) {
+        s_signing_context_restart(context);
+        if (!context->hash) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    int ret_val = aws_hash_finalize(context->hash, digest_output, 0);
+    s_signing_context_restart(context);
+    return ret_val;
+}
+
+int aws_ecc_signing_context_sign(struct aws_ecc_signing_context *context, struct aws_byte_buf *signature_output) {
+    uint8_t digest[AWS_SHA384_LEN];
+    struct aws_byte_buf digest_buf = aws_byte_buf_from_empty_array(digest, sizeof(digest));
+
+    if (s_signing_context_finalize(context, &digest_buf)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor digest_cur = aws_byte_cursor_from_buf(&digest_buf);
+    return aws_ecc_key_pair_sign_message(context->key_pair, &digest_cur, signature_output);
+}
+
+int aws_ecc_signing_context_verify(struct aws_ecc_signing_context *context, const struct aws_byte_cursor *signature) {
+    uint8_t digest[AWS_SHA384_LEN];
+    struct aws_byte_buf digest_buf = aws_byte_buf_from_empty_array(digest, sizeof(digest));
+
+    if (s_signing_context_finalize(context, &digest_buf)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor digest_cur = aws_byte_cursor_from_buf(&digest_buf);
+    return aws_ecc_key_pair_verify_signature(context->key_pair, &digest_cur, signature);
+}
+
+int aws_ecc_signing_context_sign_raw(struct aws_ecc_signing_context *context, struct aws_byte_buf *signature_output) {
+    uint8_t digest[AWS_SHA384_LEN];
+    struct aws_byte_buf digest_buf = aws_byte_buf_from_empty_array(digest, sizeof(digest));
+
+    if (s_signing_context_finalize(context, &digest_buf)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor digest_cur = aws_byte_cursor_from_buf(&digest_buf);
+    return aws_ecc_key_pair_sign_message_raw(context->key_pair, &digest_cur, signature_output);
+}
+
+int aws_ecc_signing_context_verify_raw(
+    struct aws_ecc_signing_context *context,
+    const struct aws_byte_cursor *signature) {
+    uint8_t digest[AWS_SHA384_LEN];
+    struct aws_byte_buf digest_buf = aws_byte_buf_from_empty_array(digest, sizeof(digest));
+
+    if (s_signing_context_finalize(context, &digest_buf)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor digest_cur = aws_byte_cursor_from_buf(&digest_buf);
+    return aws_ecc_key_pair_verify_signature_raw(context->key_pair, &digest_cur, signature);
+}
@@ -0,0 +1,342 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/ecc.h>
+
+#include <aws/cal/hash.h>
+#include <aws/cal/private/ecc.h>
+
+#include <aws/common/lru_cache.h>
+#include <aws/common/mutex.h>
+
+/*
+ * Entries are keyed by SHA-256 over a tag and the encoding, so keys are a fixed size no matter how long the encoding
+ * is, and the first digest byte picks the shard. Each shard is a regular LRU cache behind its own mutex: a lookup
+ * reorders the LRU list, so even hits need exclusive access and a read/write lock would only ever be write locked.
+ * Sharding is what keeps threads apart instead.
+ */
+#define S_SHARD_COUNT 16
+#define S_DEFAULT_MAX_ENTRIES 1024
+/* enough for the tag and any P-384 encoding or pair of hex coordinates, so lookups hash from the stack */
+#define S_CACHE_KEY_SCRATCH_LEN 512
+
+struct ecc_key_cache_key {
+    struct aws_allocator *allocator;
+    uint8_t digest[AWS_SHA256_LEN];
+};
+
+struct ecc_key_cache_shard {
+    struct aws_mutex lock;
+    struct aws_cache *lru;
+};
+
+struct aws_ecc_key_pair_cache {
+    struct aws_allocator *allocator;
+    struct ecc_key_cache_shard shards[S_SHARD_COUNT];
+    struct aws_atomic_var hits;
+    struct aws_atomic_var misses;
+};
+
+static uint64_t s_cache_key_hash(const void *key) {
+    const struct ecc_key_cache_key *cache_key = key;
+    /* the digest is already uniformly distributed, skip the byte used for the shard */
+    uint64_t hash = 0;
+    memcpy(&hash, cache_key->digest + 1, sizeof(hash));
+    return hash;
+}
+
+static bool s_cache_key_eq(const void *a, const void *b) {
+    const struct ecc_key_cache_key *key_a = a;
+    const struct ecc_key_cache_key *key_b = b;
+    return memcmp(key_a->digest, key_b->digest, sizeof(key_a->digest)) == 0;
+}
+
+static void s_cache_key_destroy(void *key) {
+    struct ecc_key_cache_key *cache_key = key;
+    aws_mem_release(cache_key->allocator, cache_key);
+}
+
+static void s_cache_value_destroy(void *value) {
+    aws_ecc_key_pair_release(value);
+}
+
+struct aws_ecc_key_pair_cache *aws_ecc_key_pair_cache_new(
+    struct aws_allocator *allocator,
+    const struct aws_ecc_key_pair_cache_options *options) {
+    size_t max_entries = S_DEFAULT_MAX_ENTRIES;
+    if (options && options->max_entries) {
+        max_entries = options->max_entries;
+    }
+
+    struct aws_ecc_key_pair_cache *cache = aws_mem_calloc(allocator, 1, sizeof(struct aws_ecc_key_pair_cache));
+    if (!cache) {
+        return NULL;
+    }
+
+    cache->allocator = allocator;
+    aws_atomic_init_int(&cache->hits, 0);
+    aws_atomic_init_int(&cache->misses, 0);
+
+    /* spread the bound over the shards, rounding up so small caches still hold something in every shard */
+    size_t max_entries_per_shard = (max_entries + S_SHARD_COUNT - 1) / S_SHARD_COUNT;
+
+    for (size_t i = 0; i < S_SHARD_COUNT; ++i) {
+        struct ecc_key_cache_shard *shard = &cache->shards[i];
+        if (aws_mutex_init(&shard->lock)) {
+            goto error;
+        }
+
+        shard->lru = aws_cache_new_lru(
+            allocator,
+            s_cache_key_hash,
+            s_cache_key_eq,
+            s_cache_key_destroy,
+            s_cache_value_destroy,
+            max_entries_per_shard);
+        if (!shard->lru) {
+            aws_mutex_clean_up(&shard->lock);
+            goto error;
+        }
+    }
+
+    return cache;
+
+error:
+    aws_ecc_key_pair_cache_destroy(cache);
+    return NULL;
+}
+
+void aws_ecc_key_pair_cache_destroy(struct aws_ecc_key_pair_cache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < S_SHARD_COUNT; ++i) {
+        struct ecc_key_cache_shard *shard = &cache->shards[i];
+        if (shard->lru) {
+            aws_cache_destroy(shard->lru);
+            aws_mutex_clean_up(&shard->lock);
+        }
+    }
+
+    aws_mem_release(cache->allocator, cache);
+}
+
+static int s_compute_cache_key(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *parts,
+    size_t part_count,
+    struct ecc_key_cache_key *cache_key) {
+    struct aws_byte_buf digest_buf = aws_byte_buf_from_empty_array(cache_key->digest, sizeof(cache_key->digest));
+
+    size_t total_len = 0;
+    for (size_t i = 0; i < part_count; ++i) {
+        total_len += parts[i].len;
+    }
+
+    /* the one-shot hash reuses this thread's instance, so the common case allocates nothing */
+    if (total_len <= S_CACHE_KEY_SCRATCH_LEN) {
+        uint8_t scratch[S_CACHE_KEY_SCRATCH_LEN];
+        struct aws_byte_buf scratch_buf = aws_byte_buf_from_empty_array(scratch, sizeof(scratch));
+        for (size_t i = 0; i < part_count; ++i) {
+            aws_byte_buf_write_from_whole_cursor(&scratch_buf, parts[i]);
+        }
+
+        struct aws_byte_cursor input = aws_byte_cursor_from_buf(&scratch_buf);
+        int result = aws_sha256_compute(allocator, &input, &digest_buf, 0);
+        /* encodings can hold private keys */
+        aws_secure_zero(scratch, sizeof(scratch));
+        return result;
+    }
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    if (!hash) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_SUCCESS;
+    for (size_t i = 0; i < part_count && result == AWS_OP_SUCCESS; ++i) {
+        result = aws_hash_update(hash, &parts[i]);
+    }
+
+    if (result == AWS_OP_SUCCESS) {
+        result = aws_hash_finalize(hash, &digest_buf, 0);
+    }
+
+    aws_hash_destroy(hash);
+    return result;
+}
+
+static struct ecc_key_cache_shard *s_shard_for_key(
+    struct aws_ecc_key_pair_cache *cache,
+    const struct ecc_key_cache_key *cache_key) {
+    return &cache->shards[cache_key->digest[0] % S_SHARD_COUNT];
+}
+
+static struct aws_ecc_key_pair *s_cache_find(
+    struct aws_ecc_key_pair_cache *cache,
+    const struct ecc_key_cache_key *cache_key) {
+    struct ecc_key_cache_shard *shard = s_shard_for_key(cache, cache_key);
+    void *value = NULL;
+
+    aws_mutex_lock(&shard->lock);
+    if (aws_cache_find(shard->lru, cache_key, &value) == AWS_OP_SUCCESS && value) {
+        aws_ecc_key_pair_acquire(value);
+    }
+    aws_mutex_unlock(&shard->lock);
+
+    return value;
+}
+
+/*
+ * Adds key_pair under cache_key and hands it back. If another thread cached the same key in the meantime, key_pair
+ * is released and the cached one is returned instead. Failing to cache isn't an error, key_pair is just not kept.
+ */
+static struct aws_ecc_key_pair *s_cache_insert(
+    struct aws_ecc_key_pair_cache *cache,
+    const struct ecc_key_cache_key *cache_key,
+    struct aws_ecc_key_pair *key_pair) {
+    struct ecc_key_cache_key *owned_key = aws_mem_acquire(cache->allocator, sizeof(struct ecc_key_cache_key));
+    if (!owned_key) {
+        return key_pair;
+    }
+    *owned_key = *cache_key;
+    owned_key->allocator = cache->allocator;
+
+    struct ecc_key_cache_shard *shard = s_shard_for_key(cache, cache_key);
+    struct aws_ecc_key_pair *result = key_pair;
+    void *existing = NULL;
+
+    aws_mutex_lock(&shard->lock);
+    if (aws_cache_find(shard->lru, owned_key, &existing) == AWS_OP_SUCCESS && existing) {
+        aws_ecc_key_pair_acquire(existing);
+        result = existing;
+    } else {
+        aws_ecc_key_pair_acquire(key_pair);
+        if (aws_cache_put(shard->lru, owned_key, key_pair) == AWS_OP_SUCCESS) {
+            owned_key = NULL;
+        } else {
+            aws_ecc_key_pair_release(key_pair);
+        }
+    }
+    aws_mutex_unlock(&shard->lock);
+
+    if (owned_key) {
+        aws_mem_release(cache->allocator, owned_key);
+    }
+
+    if (result != key_pair) {
+        aws_ecc_key_pair_release(key_pair);
+    }
+
+    return result;
+}
+
+/*
+ * Cached keys are shared between threads the moment they are inserted, and preparing a key mutates it, so it happens
+ * here while key_pair is still private to this thread. A key that couldn't be prepared still verifies, just slower.
+ */
+static struct aws_ecc_key_pair *s_prepare_for_publishing(struct aws_ecc_key_pair *key_pair) {
+    (void)aws_ecc_key_pair_prepare_for_verification(key_pair);
+    return key_pair;
+}
+
+/*
+ * Backends differ in what they leave in priv_d for public keys, so look at the encoding itself. It already parsed
+ * once, anything that fails to decode now is treated as private to stay on the safe side.
+ */
+static bool s_encoding_has_private_key(const struct aws_byte_cursor *encoded_keys) {
+    struct aws_byte_cursor pub_x;
+    struct aws_byte_cursor pub_y;
+    struct aws_byte_cursor priv_d;
+    AWS_ZERO_STRUCT(priv_d);
+    enum aws_ecc_curve_name curve_name;
+
+    return aws_der_load_ecc_key_pair(*encoded_keys, &pub_x, &pub_y, &priv_d, &curve_name) || priv_d.ptr != NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_cache_acquire_from_asn1(
+    struct aws_ecc_key_pair_cache *cache,
+    const struct aws_byte_cursor *encoded_keys) {
+    AWS_PRECONDITION(cache);
+    AWS_PRECONDITION(encoded_keys);
+
+    struct aws_byte_cursor parts[] = {
+        aws_byte_cursor_from_c_str("asn1"),
+        *encoded_keys,
+    };
+
+    struct ecc_key_cache_key cache_key;
+    AWS_ZERO_STRUCT(cache_key);
+    if (s_compute_cache_key(cache->allocator, parts, AWS_ARRAY_SIZE(parts), &cache_key)) {
+        return NULL;
+    }
+
+    struct aws_ecc_key_pair *key_pair = s_cache_find(cache, &cache_key);
+    if (key_pair) {
+        aws_atomic_fetch_add(&cache->hits, 1);
+        return key_pair;
+    }
+
+    aws_atomic_fetch_add(&cache->misses, 1);
+    key_pair = aws_ecc_key_pair_new_from_asn1(cache->allocator, encoded_keys);
+    if (!key_pair) {
+        return NULL;
+    }
+
+    /* private keys shouldn't outlive the caller's copy of them */
+    if (s_encoding_has_private_key(encoded_keys)) {
+        return key_pair;
+    }
+
+    return s_cache_insert(cache, &cache_key, s_prepare_for_publishing(key_pair));
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_cache_acquire_from_hex_coordinates(
+    struct aws_ecc_key_pair_cache *cache,
+    enum aws_ecc_curve_name curve_name,
+    struct aws_byte_cursor pub_x_hex_cursor,
+    struct aws_byte_cursor pub_y_hex_cursor) {
+    AWS_PRECONDITION(cache);
+
+    /* ':' never shows up in hex, so it keeps the two coordinates apart */
+    uint8_t curve_byte = (uint8_t)curve_name;
+    struct aws_byte_cursor parts[] = {
+        aws_byte_cursor_from_c_str("hex"),
+        aws_byte_cursor_from_array(&curve_byte, 1),
+        pub_x_hex_cursor,
+        aws_byte_cursor_from_c_str(":"),
+        pub_y_hex_cursor,
+    };
+
+    struct ecc_key_cache_key cache_key;
+    AWS_ZERO_STRUCT(cache_key);
+    if (s_compute_cache_key(cache->allocator, parts, AWS_ARRAY_SIZE(parts), &cache_key)) {
+        return NULL;
+    }
+
+    struct aws_ecc_key_pair *key_pair = s_cache_find(cache, &cache_key);
+    if (key_pair) {
+        aws_atomic_fetch_add(&cache->hits, 1);
+        return key_pair;
+    }
+
+    aws_atomic_fetch_add(&cache->misses, 1);
+    key_pair = aws_ecc_key_new_from_hex_coordinates(cache->allocator, curve_name, pub_x_hex_cursor, pub_y_hex_cursor);
+    if (!key_pair) {
+        return NULL;
+    }
+
+    return s_cache_insert(cache, &cache_key, s_prepare_for_publishing(key_pair));
+}
+
+void aws_ecc_key_pair_cache_get_stats(
+    const struct aws_ecc_key_pair_cache *cache,
+    struct aws_ecc_key_pair_cache_stats *stats) {
+    AWS_PRECONDITION(cache);
+    AWS_PRECONDITION(stats);
+
+    stats->hits = aws_atomic_load_int(&cache->hits);
+    stats->misses = aws_atomic_load_int(&cache->misses);
+}
@@ -0,0 +1,230 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/ecc.h>
+
+#include <aws/cal/cal.h>
+
+#include <aws/common/condition_variable.h>
+#include <aws/common/mutex.h>
+#include <aws/common/thread.h>
+
+#if !defined(AWS_OS_IOS)
+
+/*
+ * Ready key pairs sit in a fixed array of atomic slots. Acquiring swaps a slot to NULL, so handing a key out never
+ * takes a lock; refilling compare-exchanges new keys into empty slots. The mutex and condition variable only exist to
+ * put the refill thread to sleep while the pool is full, and are only touched by the first acquire after a refill.
+ */
+#define S_DEFAULT_DEPTH 16
+
+struct aws_ecc_key_pair_pool {
+    struct aws_allocator *allocator;
+    enum aws_ecc_curve_name curve_name;
+    size_t depth;
+    struct aws_atomic_var *slots;
+    struct aws_atomic_var next_slot;
+
+    struct aws_thread refill_thread;
+    struct aws_mutex lock;
+    struct aws_condition_variable signal;
+    struct aws_atomic_var refill_requested;
+    struct aws_atomic_var shutting_down;
+
+    struct aws_atomic_var pooled;
+    struct aws_atomic_var generated_inline;
+};
+
+static struct aws_ecc_key_pair *s_generate_key_pair(struct aws_ecc_key_pair_pool *pool) {
+    struct aws_ecc_key_pair *key_pair = aws_ecc_key_pair_new_generate_random(pool->allocator, pool->curve_name);
+    if (!key_pair) {
+        return NULL;
+    }
+
+    /* backends may defer copying the coordinates out, get that over with here rather than on the caller's thread */
+    struct aws_byte_cursor pub_x;
+    struct aws_byte_cursor pub_y;
+    aws_ecc_key_pair_get_public_key(key_pair, &pub_x, &pub_y);
+
+    return key_pair;
+}
+
+static void s_fill_slots(struct aws_ecc_key_pair_pool *pool) {
+    for (size_t i = 0; i < pool->depth; ++i) {
+        if (aws_atomic_load_int(&pool->shutting_down)) {
+            return;
+        }
+
+        if (aws_atomic_load_ptr(&pool->slots[i]) != NULL) {
+            continue;
+        }
+
+        struct aws_ecc_key_pair *key_pair = s_generate_key_pair(pool);
+        if (!key_pair) {
+            /* acquire still works with empty slots, try again on the next wake up */
+            return;
+        }
+
+        void *expected = NULL;
+        if (!aws_atomic_compare_exchange_ptr(&pool->slots[i], &expected, key_pair)) {
+            aws_ecc_key_pair_release(key_pair);
+        }
+    }
+}
+
+static bool s_refill_thread_should_wake(void *user_data) {
+    struct aws_ecc_key_pair_pool *pool = user_data;
+    return aws_atomic_load_int(&pool->refill_requested) || aws_atomic_load_int(&pool->shutting_down);
+}
+
+static void s_refill_thread(void *user_data) {
+    struct aws_ecc_key_pair_pool *pool = user_data;
+
+    while (!aws_atomic_load_int(&pool->shutting_down)) {
+        s_fill_slots(pool);
+
+        aws_mutex_lock(&pool->lock);
+        aws_condition_variable_wait_pred(&pool->signal, &pool->lock, s_refill_thread_should_wake, pool);
+        aws_mutex_unlock(&pool->lock);
+
+        /* cleared before refilling, so a key taken while we refill asks for another round */
+        aws_atomic_store_int(&pool->refill_requested, 0);
+    }
+
+    /* generating keys leaves libcrypto state behind on this thread */
+    aws_cal_thread_clean_up();
+}
+
+static void s_wake_refill_thread(struct aws_ecc_key_pair_pool *pool) {
+    aws_mutex_lock(&pool->lock);
+    aws_condition_variable_notify_one(&pool->signal);
+    aws_mutex_unlock(&pool->lock);
+}
+
+static void s_release_pooled_keys(struct aws_ecc_key_pair_pool *pool) {
+    for (size_t i = 0; i < pool->depth; ++i) {
+        aws_ecc_key_pair_release(aws_atomic_exchange_ptr(&pool->slots[i], NULL));
+    }
+}
+
+struct aws_ecc_key_pair_pool *aws_ecc_key_pair_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_ecc_key_pair_pool_options *options) {
+    AWS_PRECONDITION(options);
+
+    if (options->curve_name != AWS_CAL_ECDSA_P256 && options->curve_name != AWS_CAL_ECDSA_P384) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct aws_ecc_key_pair_pool *pool = aws_mem_calloc(allocator, 1, sizeof(struct aws_ecc_key_pair_pool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->allocator = allocator;
+    pool->curve_name = options->curve_name;
+    pool->depth = options->depth ? options->depth : S_DEFAULT_DEPTH;
+
+    pool->slots = aws_mem_calloc(allocator, pool->depth, sizeof(struct aws_atomic_var));
+    if (!pool->slots) {
+        goto on_slots_error;
+    }
+
+    for (size_t i = 0; i < pool->depth; ++i) {
+        aws_atomic_init_ptr(&pool->slots[i], NULL);
+    }
+
+    aws_atomic_init_int(&pool->next_slot, 0);
+    aws_atomic_init_int(&pool->refill_requested, 0);
+    aws_atomic_init_int(&pool->shutting_down, 0);
+    aws_atomic_init_int(&pool->pooled, 0);
+    aws_atomic_init_int(&pool->generated_inline, 0);
+
+    if (aws_mutex_init(&pool->lock)) {
+        goto on_mutex_error;
+    }
+
+    if (aws_condition_variable_init(&pool->signal)) {
+        goto on_signal_error;
+    }
+
+    if (aws_thread_init(&pool->refill_thread, allocator)) {
+        goto on_thread_error;
+    }
+
+    struct aws_thread_options thread_options = *aws_default_thread_options();
+    thread_options.name = aws_byte_cursor_from_c_str("AwsEccKeyPool");
+
+    if (aws_thread_launch(&pool->refill_thread, s_refill_thread, pool, &thread_options)) {
+        aws_thread_clean_up(&pool->refill_thread);
+        goto on_thread_error;
+    }
+
+    return pool;
+
+on_thread_error:
+    aws_condition_variable_clean_up(&pool->signal);
+on_signal_error:
+    aws_mutex_clean_up(&pool->lock);
+on_mutex_error:
+    aws_mem_release(allocator, pool->slots);
+on_slots_error:
+    aws_mem_release(allocator, pool);
+    return NULL;
+}
+
+void aws_ecc_key_pair_pool_destroy(struct aws_ecc_key_pair_pool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    aws_atomic_store_int(&pool->shutting_down, 1);
+    s_wake_refill_thread(pool);
+    aws_thread_join(&pool->refill_thread);
+    aws_thread_clean_up(&pool->refill_thread);
+
+    s_release_pooled_keys(pool);
+
+    aws_condition_variable_clean_up(&pool->signal);
+    aws_mutex_clean_up(&pool->lock);
+    aws_mem_release(pool->allocator, pool->slots);
+    aws_mem_release(pool->allocator, pool);
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_pool_acquire(struct aws_ecc_key_pair_pool *pool) {
+    AWS_PRECONDITION(pool);
+
+    /* start every acquire somewhere else, so concurrent callers don't all fight over the first slot */
+    size_t start = aws_atomic_fetch_add(&pool->next_slot, 1);
+    struct aws_ecc_key_pair *key_pair = NULL;
+
+    for (size_t i = 0; i < pool->depth && !key_pair; ++i) {
+        key_pair = aws_atomic_exchange_ptr(&pool->slots[(start + i) % pool->depth], NULL);
+    }
+
+    if (aws_atomic_exchange_int(&pool->refill_requested, 1) == 0) {
+        s_wake_refill_thread(pool);
+    }
+
+    if (key_pair) {
+        aws_atomic_fetch_add(&pool->pooled, 1);
+        return key_pair;
+    }
+
+    aws_atomic_fetch_add(&pool->generated_inline, 1);
+    return aws_ecc_key_pair_new_generate_random(pool->allocator, pool->curve_name);
+}
+
+void aws_ecc_key_pair_pool_get_stats(
+    const struct aws_ecc_key_pair_pool *pool,
+    struct aws_ecc_key_pair_pool_stats *stats) {
+    AWS_PRECONDITION(pool);
+    AWS_PRECONDITION(stats);
+
+    stats->pooled = aws_atomic_load_int(&pool->pooled);
+    stats->generated_inline = aws_atomic_load_int(&pool->generated_inline);
+}
+
+#endif /* !AWS_OS_IOS */
@@ -0,0 +1,359 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/ecc.h>
+
+#include <aws/cal/cal.h>
+
+#include <aws/common/array_list.h>
+#include <aws/common/encoding.h>
+#include <aws/common/thread.h>
+
+/*
+ * A block's body is first compacted into the front of the scratch buffer with the line breaks dropped, then decoded
+ * into the space right behind it, and the DER decoder reads the key straight out of there. The scratch buffer only
+ * ever grows, so loading many keys through the same one stops allocating once it has seen the largest block.
+ */
+static const struct aws_byte_cursor s_pem_begin = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("-----BEGIN ");
+static const struct aws_byte_cursor s_pem_end = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("-----END ");
+static const struct aws_byte_cursor s_pem_dashes = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("-----");
+static const struct aws_byte_cursor s_ec_private_key_label = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("EC PRIVATE KEY");
+static const struct aws_byte_cursor s_public_key_label = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("PUBLIC KEY");
+
+struct pem_block {
+    struct aws_byte_cursor label;
+    struct aws_byte_cursor body;
+};
+
+/*
+ * Finds the next BEGIN/END pair in input and advances input past it. Returns false once there are no blocks left, or
+ * sets malformed and returns false if a block is missing its END line.
+ */
+static bool s_next_pem_block(struct aws_byte_cursor *input, struct pem_block *block, bool *malformed) {
+    struct aws_byte_cursor remaining;
+    if (aws_byte_cursor_find_exact(input, &s_pem_begin, &remaining)) {
+        return false;
+    }
+
+    aws_byte_cursor_advance(&remaining, s_pem_begin.len);
+
+    struct aws_byte_cursor label_end;
+    if (aws_byte_cursor_find_exact(&remaining, &s_pem_dashes, &label_end)) {
+        goto on_malformed;
+    }
+
+    block->label = aws_byte_cursor_advance(&remaining, (size_t)(label_end.ptr - remaining.ptr));
+    aws_byte_cursor_advance(&remaining, s_pem_dashes.len);
+
+    struct aws_byte_cursor end;
+    if (aws_byte_cursor_find_exact(&remaining, &s_pem_end, &end)) {
+        goto on_malformed;
+    }
+
+    block->body = aws_byte_cursor_advance(&remaining, (size_t)(end.ptr - remaining.ptr));
+    aws_byte_cursor_advance(&end, s_pem_end.len);
+
+    if (!aws_byte_cursor_starts_with(&end, &block->label)) {
+        goto on_malformed;
+    }
+
+    aws_byte_cursor_advance(&end, block->label.len);
+
+    if (!aws_byte_cursor_starts_with(&end, &s_pem_dashes)) {
+        goto on_malformed;
+    }
+
+    aws_byte_cursor_advance(&end, s_pem_dashes.len);
+    *input = end;
+    return true;
+
+on_malformed:
+    *malformed = true;
+    return false;
+}
+
+static bool s_is_key_block(const struct pem_block *block) {
+    return aws_byte_cursor_eq(&block->label, &s_ec_private_key_label) ||
+           aws_byte_cursor_eq(&block->label, &s_public_key_label);
+}
+
+static bool s_is_pem_whitespace(uint8_t value) {
+    return value == ' ' || value == '\t' || value == '\r' || value == '\n';
+}
+
+static int s_decode_pem_body(struct aws_byte_cursor body, struct aws_byte_buf *scratch, struct aws_byte_cursor *der) {
+    /* the decoded key is never longer than its base64 text, so twice the body always fits both */
+    size_t needed = 0;
+    if (aws_add_size_checked(body.len, body.len, &needed) || aws_byte_buf_reserve(scratch, needed)) {
+        return AWS_OP_ERR;
+    }
+
+    scratch->len = 0;
+    for (size_t i = 0; i < body.len; ++i) {
+        if (!s_is_pem_whitespace(body.ptr[i])) {
+            scratch->buffer[scratch->len++] = body.ptr[i];
+        }
+    }
+
+    struct aws_byte_cursor text = aws_byte_cursor_from_buf(scratch);
+    struct aws_byte_buf decoded =
+        aws_byte_buf_from_empty_array(scratch->buffer + scratch->len, scratch->capacity - scratch->len);
+
+    if (aws_base64_decode(&text, &decoded)) {
+        return AWS_OP_ERR;
+    }
+
+    scratch->len += decoded.len;
+    *der = aws_byte_cursor_from_buf(&decoded);
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_ecc_key_pair *s_key_pair_new_from_pem_block(
+    struct aws_allocator *allocator,
+    const struct pem_block *block,
+    struct aws_byte_buf *scratch) {
+
+    struct aws_ecc_key_pair *key_pair = NULL;
+    struct aws_byte_cursor der;
+    if (s_decode_pem_body(block->body, scratch, &der) == AWS_OP_SUCCESS) {
+        key_pair = aws_ecc_key_pair_new_from_asn1(allocator, &der);
+    }
+
+    /* only wipe what this block used, the rest of the buffer was wiped after the blocks before it */
+    aws_secure_zero(scratch->buffer, scratch->len);
+    scratch->len = 0;
+
+    return key_pair;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_pem(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *pem,
+    struct aws_byte_buf *scratch) {
+    AWS_PRECONDITION(pem);
+
+    struct aws_byte_buf local_scratch;
+    AWS_ZERO_STRUCT(local_scratch);
+    if (scratch == NULL) {
+        if (aws_byte_buf_init(&local_scratch, allocator, pem->len * 2)) {
+            return NULL;
+        }
+        scratch = &local_scratch;
+    }
+
+    struct aws_ecc_key_pair *key_pair = NULL;
+    struct aws_byte_cursor input = *pem;
+    struct pem_block block;
+    bool malformed = false;
+    bool found = false;
+
+    while (!found && s_next_pem_block(&input, &block, &malformed)) {
+        found = s_is_key_block(&block);
+    }
+
+    if (found) {
+        key_pair = s_key_pair_new_from_pem_block(allocator, &block, scratch);
+    } else {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    aws_byte_buf_clean_up_secure(&local_scratch);
+    return key_pair;
+}
+
+struct pem_bundle_load {
+    struct aws_allocator *allocator;
+    struct aws_array_list blocks;
+    struct aws_ecc_key_pair **key_pairs;
+    size_t worker_count;
+    struct aws_atomic_var failed;
+};
+
+struct pem_bundle_worker {
+    struct pem_bundle_load *load;
+    size_t index;
+    int error_code;
+    struct aws_thread thread;
+    bool launched;
+};
+
+/* workers take every worker_count-th block, so a few large keys next to each other still get spread out */
+static void s_pem_bundle_worker_run(void *user_data) {
+    struct pem_bundle_worker *worker = user_data;
+    struct pem_bundle_load *load = worker->load;
+
+    struct aws_byte_buf scratch;
+    if (aws_byte_buf_init(&scratch, load->allocator, 0)) {
+        worker->error_code = aws_last_error();
+        aws_atomic_store_int(&load->failed, 1);
+        return;
+    }
+
+    size_t block_count = aws_array_list_length(&load->blocks);
+    for (size_t i = worker->index; i < block_count; i += load->worker_count) {
+        if (aws_atomic_load_int(&load->failed)) {
+            break;
+        }
+
+        struct pem_block *block = NULL;
+        aws_array_list_get_at_ptr(&load->blocks, (void **)&block, i);
+
+        load->key_pairs[i] = s_key_pair_new_from_pem_block(load->allocator, block, &scratch);
+        if (load->key_pairs[i] == NULL) {
+            worker->error_code = aws_last_error();
+            aws_atomic_store_int(&load->failed, 1);
+            break;
+        }
+    }
+
+    aws_byte_buf_clean_up_secure(&scratch);
+}
+
+/* entry point of the threads we launch. Workers run inline on the caller's thread must not clean up its state. */
+static void s_pem_bundle_worker_thread_run(void *user_data) {
+    s_pem_bundle_worker_run(user_data);
+
+    /* parsing keys leaves libcrypto state behind on this thread */
+    aws_cal_thread_clean_up();
+}
+
+static void s_release_key_pairs(struct aws_ecc_key_pair **key_pairs, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        aws_ecc_key_pair_release(key_pairs[i]);
+    }
+}
+
+static int s_collect_key_blocks(struct aws_byte_cursor input, struct aws_array_list *blocks) {
+    struct pem_block block;
+    bool malformed = false;
+
+    while (s_next_pem_block(&input, &block, &malformed)) {
+        if (s_is_key_block(&block) && aws_array_list_push_back(blocks, &block)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (malformed) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_run_pem_bundle_workers(struct pem_bundle_load *load) {
+    struct pem_bundle_worker *workers =
+        aws_mem_calloc(load->allocator, load->worker_count, sizeof(struct pem_bundle_worker));
+    if (!workers) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_thread_options thread_options = *aws_default_thread_options();
+    thread_options.name = aws_byte_cursor_from_c_str("AwsEccPemLoad");
+
+    /* worker 0 is the calling thread, so a single worker never starts a thread at all */
+    for (size_t i = 0; i < load->worker_count; ++i) {
+        workers[i].load = load;
+        workers[i].index = i;
+
+        if (i > 0 && aws_thread_init(&workers[i].thread, load->allocator) == AWS_OP_SUCCESS) {
+            if (aws_thread_launch(&workers[i].thread, s_pem_bundle_worker_thread_run, &workers[i], &thread_options)) {
+                aws_thread_clean_up(&workers[i].thread);
+            } else {
+                workers[i].launched = true;
+            }
+        }
+    }
+
+    /* blocks of any worker that couldn't get its own thread are parsed here instead */
+    for (size_t i = 0; i < load->worker_count; ++i) {
+        if (!workers[i].launched) {
+            s_pem_bundle_worker_run(&workers[i]);
+        }
+    }
+
+    int error_code = AWS_ERROR_SUCCESS;
+    for (size_t i = 0; i < load->worker_count; ++i) {
+        if (workers[i].launched) {
+            aws_thread_join(&workers[i].thread);
+            aws_thread_clean_up(&workers[i].thread);
+        }
+
+        if (error_code == AWS_ERROR_SUCCESS) {
+            error_code = workers[i].error_code;
+        }
+    }
+
+    aws_mem_release(load->allocator, workers);
+
+    if (error_code != AWS_ERROR_SUCCESS) {
+        return aws_raise_error(error_code);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_ecc_key_pairs_new_from_pem_bundle(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *pem,
+    const struct aws_ecc_pem_load_options *options,
+    struct aws_array_list *out_key_pairs) {
+    AWS_PRECONDITION(pem);
+    AWS_PRECONDITION(out_key_pairs);
+    AWS_PRECONDITION(out_key_pairs->item_size == sizeof(struct aws_ecc_key_pair *));
+
+    int result = AWS_OP_ERR;
+
+    struct pem_bundle_load load;
+    AWS_ZERO_STRUCT(load);
+    load.allocator = allocator;
+    aws_atomic_init_int(&load.failed, 0);
+
+    if (aws_array_list_init_dynamic(&load.blocks, allocator, 8, sizeof(struct pem_block))) {
+        return AWS_OP_ERR;
+    }
+
+    if (s_collect_key_blocks(*pem, &load.blocks)) {
+        goto done;
+    }
+
+    size_t block_count = aws_array_list_length(&load.blocks);
+    if (block_count == 0) {
+        result = AWS_OP_SUCCESS;
+        goto done;
+    }
+
+    load.key_pairs = aws_mem_calloc(allocator, block_count, sizeof(struct aws_ecc_key_pair *));
+    if (!load.key_pairs) {
+        goto done;
+    }
+
+    size_t thread_count = options ? options->thread_count : 0;
+    load.worker_count = thread_count == 0 ? 1 : aws_min_size(thread_count, block_count);
+
+    if (s_run_pem_bundle_workers(&load)) {
+        s_release_key_pairs(load.key_pairs, block_count);
+        goto done;
+    }
+
+    size_t original_length = aws_array_list_length(out_key_pairs);
+    for (size_t i = 0; i < block_count; ++i) {
+        if (aws_array_list_push_back(out_key_pairs, &load.key_pairs[i])) {
+            /* leave out_key_pairs the way the caller passed it in */
+            while (aws_array_list_length(out_key_pairs) > original_length) {
+                aws_array_list_pop_back(out_key_pairs);
+            }
+            s_release_key_pairs(load.key_pairs, block_count);
+            goto done;
+        }
+    }
+
+    result = AWS_OP_SUCCESS;
+
+done:
+    if (load.key_pairs) {
+        aws_mem_release(allocator, load.key_pairs);
+    }
+    aws_array_list_clean_up(&load.blocks);
+    return result;
+}
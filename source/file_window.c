@@ -0,0 +1,152 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/file_window.h>
+
+#include <aws/common/file.h>
+
+#include <stdio.h>
+
+#if !defined(_WIN32)
+#    include <errno.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define S_HAVE_MMAP
+#endif
+
+/* a multiple of every page size in use, so every window's offset is page aligned. */
+#define S_MAP_WINDOW_LEN ((size_t)64 * 1024 * 1024)
+#define S_READ_BUFFER_LEN ((size_t)1024 * 1024)
+
+#ifdef S_HAVE_MMAP
+/*
+ * Maps the file one window at a time. The kernel is told each window is read sequentially, so it reads ahead
+ * aggressively and drops pages behind, and the next window is queued for reading while the current one is being
+ * consumed. Returns false, with *mapped_len set to how much was done, if a window can't be mapped so the caller can
+ * read the rest instead.
+ */
+static bool s_map_windows(
+    int fd,
+    uint64_t file_len,
+    aws_cal_file_window_fn *on_window,
+    void *user_data,
+    uint64_t *mapped_len,
+    int *result) {
+
+    for (uint64_t offset = 0; offset < file_len;) {
+        size_t window_len = (size_t)aws_min_u64(S_MAP_WINDOW_LEN, file_len - offset);
+        void *window = mmap(NULL, window_len, PROT_READ, MAP_PRIVATE, fd, (off_t)offset);
+        if (window == MAP_FAILED) {
+            *mapped_len = offset;
+            return false;
+        }
+
+#    ifdef MADV_SEQUENTIAL
+        madvise(window, window_len, MADV_SEQUENTIAL);
+#    endif
+#    ifdef POSIX_FADV_WILLNEED
+        uint64_t next_offset = offset + window_len;
+        if (next_offset < file_len) {
+            posix_fadvise(
+                fd,
+                (off_t)next_offset,
+                (off_t)aws_min_u64(S_MAP_WINDOW_LEN, file_len - next_offset),
+                POSIX_FADV_WILLNEED);
+        }
+#    endif
+
+        *result = on_window(aws_byte_cursor_from_array(window, window_len), user_data);
+        munmap(window, window_len);
+        if (*result != AWS_OP_SUCCESS) {
+            return true;
+        }
+
+        offset += window_len;
+    }
+
+    *result = AWS_OP_SUCCESS;
+    return true;
+}
+#endif /* S_HAVE_MMAP */
+
+/* Reads the file from offset to the end into one buffer, handing over each chunk as it's read. Pipes and the like
+ * can't be read at an offset, they are only ever read from the start. */
+static int s_read_windows(
+    struct aws_allocator *allocator,
+    FILE *file,
+    bool positional,
+    uint64_t offset,
+    aws_cal_file_window_fn *on_window,
+    void *user_data) {
+
+    uint8_t *buffer = aws_mem_acquire(allocator, S_READ_BUFFER_LEN);
+    int result = AWS_OP_SUCCESS;
+
+    for (;;) {
+#ifdef S_HAVE_MMAP
+        ssize_t read_len = positional ? pread(fileno(file), buffer, S_READ_BUFFER_LEN, (off_t)offset)
+                                      : read(fileno(file), buffer, S_READ_BUFFER_LEN);
+        if (read_len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = aws_translate_and_raise_io_error(errno);
+            break;
+        }
+#else
+        /* nothing has been mapped, so the file is still positioned at offset, which is 0. */
+        (void)positional;
+        (void)offset;
+        size_t read_len = fread(buffer, 1, S_READ_BUFFER_LEN, file);
+        if (read_len == 0 && ferror(file)) {
+            result = aws_raise_error(AWS_ERROR_FILE_READ_FAILURE);
+            break;
+        }
+#endif
+        if (read_len == 0) {
+            break;
+        }
+
+        if (on_window(aws_byte_cursor_from_array(buffer, (size_t)read_len), user_data)) {
+            result = AWS_OP_ERR;
+            break;
+        }
+        offset += (uint64_t)read_len;
+    }
+
+    aws_secure_zero(buffer, S_READ_BUFFER_LEN);
+    aws_mem_release(allocator, buffer);
+    return result;
+}
+
+int aws_cal_file_for_each_window(
+    struct aws_allocator *allocator,
+    const char *path,
+    aws_cal_file_window_fn *on_window,
+    void *user_data) {
+
+    FILE *file = aws_fopen(path, "rb");
+    if (!file) {
+        return AWS_OP_ERR;
+    }
+
+    bool positional = false;
+    uint64_t offset = 0;
+    int result = AWS_OP_SUCCESS;
+
+#ifdef S_HAVE_MMAP
+    struct stat file_stat;
+    positional = fstat(fileno(file), &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+    if (positional && file_stat.st_size > 0 &&
+        s_map_windows(fileno(file), (uint64_t)file_stat.st_size, on_window, user_data, &offset, &result)) {
+        fclose(file);
+        return result;
+    }
+#endif
+
+    result = s_read_windows(allocator, file, positional, offset, on_window, user_data);
+    fclose(file);
+    return result;
+}
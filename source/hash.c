@@ -3,36 +3,110 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/cal/hash.h>
+#include <aws/cal/private/file_window.h>
+#include <aws/cal/private/stats.h>
+
+#include <aws/common/thread.h>
+
+/* BLAKE3 is implemented in source/builtin/blake3.c on every platform, so it's available under BYO_CRYPTO too. */
+extern struct aws_hash *aws_blake3_default_new(struct aws_allocator *allocator);
+
+static aws_hash_new_fn *s_blake3_new_fn = aws_blake3_default_new;
 
 #ifndef BYO_CRYPTO
 extern struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator);
 extern struct aws_hash *aws_sha1_default_new(struct aws_allocator *allocator);
 extern struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator);
+extern struct aws_hash *aws_sha384_default_new(struct aws_allocator *allocator);
+extern struct aws_hash *aws_sha512_default_new(struct aws_allocator *allocator);
+extern struct aws_hash *aws_sha512_256_default_new(struct aws_allocator *allocator);
 
 static aws_hash_new_fn *s_sha256_new_fn = aws_sha256_default_new;
 static aws_hash_new_fn *s_sha1_new_fn = aws_sha1_default_new;
 static aws_hash_new_fn *s_md5_new_fn = aws_md5_default_new;
+static aws_hash_new_fn *s_sha384_new_fn = aws_sha384_default_new;
+static aws_hash_new_fn *s_sha512_new_fn = aws_sha512_default_new;
+static aws_hash_new_fn *s_sha512_256_new_fn = aws_sha512_256_default_new;
+
+/*
+ * Single call digests from the platform, which the one-shot functions use while the default implementation is
+ * installed. Each writes the whole digest to out, or returns false if the platform has no such primitive for the
+ * algorithm, in which case the one-shot goes through a hash instance instead.
+ */
+extern bool aws_sha256_default_digest(const struct aws_byte_cursor *input, uint8_t *out);
+extern bool aws_sha1_default_digest(const struct aws_byte_cursor *input, uint8_t *out);
+extern bool aws_md5_default_digest(const struct aws_byte_cursor *input, uint8_t *out);
+extern bool aws_sha384_default_digest(const struct aws_byte_cursor *input, uint8_t *out);
+extern bool aws_sha512_default_digest(const struct aws_byte_cursor *input, uint8_t *out);
+extern bool aws_sha512_256_default_digest(const struct aws_byte_cursor *input, uint8_t *out);
 #else
 static struct aws_hash *aws_hash_new_abort(struct aws_allocator *allocator) {
     (void)allocator;
     abort();
 }
 
+#    ifdef AWS_CAL_BUILTIN_SHA
+extern struct aws_hash *aws_sha256_builtin_new(struct aws_allocator *allocator);
+extern struct aws_hash *aws_sha1_builtin_new(struct aws_allocator *allocator);
+extern int aws_sha256_builtin_compute_batch(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to);
+
+static aws_hash_new_fn *s_sha256_new_fn = aws_sha256_builtin_new;
+static aws_hash_new_fn *s_sha1_new_fn = aws_sha1_builtin_new;
+#    else
 static aws_hash_new_fn *s_sha256_new_fn = aws_hash_new_abort;
 static aws_hash_new_fn *s_sha1_new_fn = aws_hash_new_abort;
+#    endif /* AWS_CAL_BUILTIN_SHA */
 static aws_hash_new_fn *s_md5_new_fn = aws_hash_new_abort;
+static aws_hash_new_fn *s_sha384_new_fn = aws_hash_new_abort;
+static aws_hash_new_fn *s_sha512_new_fn = aws_hash_new_abort;
+static aws_hash_new_fn *s_sha512_256_new_fn = aws_hash_new_abort;
 #endif
 
+static int s_sha256_compute_batch_default(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to);
+
+static aws_hash_compute_batch_fn *s_sha256_compute_batch_fn = s_sha256_compute_batch_default;
+
+static struct aws_hash *s_hash_created(struct aws_hash *hash) {
+    AWS_CAL_STATS_NEW(hash);
+    return hash;
+}
+
 struct aws_hash *aws_sha1_new(struct aws_allocator *allocator) {
-    return s_sha1_new_fn(allocator);
+    return s_hash_created(s_sha1_new_fn(allocator));
 }
 
 struct aws_hash *aws_sha256_new(struct aws_allocator *allocator) {
-    return s_sha256_new_fn(allocator);
+    return s_hash_created(s_sha256_new_fn(allocator));
 }
 
 struct aws_hash *aws_md5_new(struct aws_allocator *allocator) {
-    return s_md5_new_fn(allocator);
+    return s_hash_created(s_md5_new_fn(allocator));
+}
+
+struct aws_hash *aws_sha384_new(struct aws_allocator *allocator) {
+    return s_hash_created(s_sha384_new_fn(allocator));
+}
+
+struct aws_hash *aws_sha512_new(struct aws_allocator *allocator) {
+    return s_hash_created(s_sha512_new_fn(allocator));
+}
+
+struct aws_hash *aws_sha512_256_new(struct aws_allocator *allocator) {
+    return s_hash_created(s_sha512_256_new_fn(allocator));
+}
+
+struct aws_hash *aws_blake3_new(struct aws_allocator *allocator) {
+    return s_hash_created(s_blake3_new_fn(allocator));
 }
 
 void aws_set_md5_new_fn(aws_hash_new_fn *fn) {
@@ -47,15 +121,75 @@ void aws_set_sha1_new_fn(aws_hash_new_fn *fn) {
     s_sha1_new_fn = fn;
 }
 
+void aws_set_sha384_new_fn(aws_hash_new_fn *fn) {
+    s_sha384_new_fn = fn;
+}
+
+void aws_set_sha512_new_fn(aws_hash_new_fn *fn) {
+    s_sha512_new_fn = fn;
+}
+
+void aws_set_sha512_256_new_fn(aws_hash_new_fn *fn) {
+    s_sha512_256_new_fn = fn;
+}
+
+void aws_set_blake3_new_fn(aws_hash_new_fn *fn) {
+    s_blake3_new_fn = fn;
+}
+
+void aws_set_sha256_compute_batch_fn(aws_hash_compute_batch_fn *fn) {
+    s_sha256_compute_batch_fn = fn;
+}
+
 void aws_hash_destroy(struct aws_hash *hash) {
     hash->vtable->destroy(hash);
 }
 
 int aws_hash_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash) {
-    return hash->vtable->update(hash, to_hash);
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = hash->vtable->update(hash, to_hash);
+    AWS_CAL_STATS_END(stats, hash->vtable, AWS_CAL_STATS_OP_UPDATE, to_hash->len, result);
+    return result;
 }
 
-int aws_hash_finalize(struct aws_hash *hash, struct aws_byte_buf *output, size_t truncate_to) {
+static int s_hash_update_vectored(
+    struct aws_hash *hash,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count) {
+
+    if (hash->vtable->update_vectored) {
+        return hash->vtable->update_vectored(hash, segments, segment_count);
+    }
+
+    for (size_t i = 0; i < segment_count; ++i) {
+        if (hash->vtable->update(hash, &segments[i])) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* counted as a single update of every segment's bytes, whichever way the backend does it */
+int aws_hash_update_vectored(struct aws_hash *hash, const struct aws_byte_cursor *segments, size_t segment_count) {
+    AWS_PRECONDITION(segment_count == 0 || segments != NULL);
+
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_hash_update_vectored(hash, segments, segment_count);
+    AWS_CAL_STATS_END(
+        stats, hash->vtable, AWS_CAL_STATS_OP_UPDATE, aws_cal_stats_segments_len(segments, segment_count), result);
+    return result;
+}
+
+static int s_hash_file_window(struct aws_byte_cursor window, void *user_data) {
+    return aws_hash_update(user_data, &window);
+}
+
+int aws_hash_update_file(struct aws_hash *hash, const char *path) {
+    return aws_cal_file_for_each_window(hash->allocator, path, s_hash_file_window, hash);
+}
+
+static int s_hash_finalize(struct aws_hash *hash, struct aws_byte_buf *output, size_t truncate_to) {
 
     if (truncate_to && truncate_to < hash->digest_size) {
         size_t available_buffer = output->capacity - output->len;
@@ -63,6 +197,7 @@ int aws_hash_finalize(struct aws_hash *hash, struct aws_byte_buf *output, size_t
             return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
         }
 
+        /* even with room for the whole digest, nothing past truncate_to bytes may be written to output */
         uint8_t tmp_output[128] = {0};
         AWS_ASSERT(sizeof(tmp_output) >= hash->digest_size);
 
@@ -81,6 +216,148 @@ int aws_hash_finalize(struct aws_hash *hash, struct aws_byte_buf *output, size_t
     return hash->vtable->finalize(hash, output);
 }
 
+int aws_hash_finalize(struct aws_hash *hash, struct aws_byte_buf *output, size_t truncate_to) {
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_hash_finalize(hash, output, truncate_to);
+    AWS_CAL_STATS_END(stats, hash->vtable, AWS_CAL_STATS_OP_FINALIZE, 0, result);
+    return result;
+}
+
+int aws_hash_reset(struct aws_hash *hash) {
+    if (hash->vtable->reset == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    return hash->vtable->reset(hash);
+}
+
+struct aws_hash *aws_hash_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    if (hash->vtable->duplicate == NULL) {
+        aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+        return NULL;
+    }
+
+    if (!hash->good) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    return hash->vtable->duplicate(allocator, hash);
+}
+
+/*
+ * An exported state is laid out as
+ *   version (1 byte) | algorithm name length (1 byte) | algorithm name | bytes hashed (8 bytes, big endian) |
+ *   digest_size / 4 chaining values (4 bytes each, big endian) | the bytes hashed % 64 buffered bytes
+ * so it only depends on the algorithm, not on the provider that wrote it.
+ */
+#define HASH_STATE_VERSION 1
+#define HASH_STATE_BLOCK_LEN 64
+/* keeps the largest state, 2 + 16 + 8 + 8 * 4 + 63 bytes, within AWS_HASH_STATE_MAX_SIZE */
+#define HASH_STATE_MAX_ALG_NAME_LEN 16
+
+static size_t s_hash_state_word_count(const struct aws_hash *hash) {
+    return hash->digest_size / sizeof(uint32_t);
+}
+
+int aws_hash_export_state(const struct aws_hash *hash, struct aws_byte_buf *output) {
+    if (hash->vtable->export_state == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_hash_md_state state;
+    AWS_ZERO_STRUCT(state);
+
+    size_t alg_name_len = strlen(hash->vtable->alg_name);
+    size_t word_count = s_hash_state_word_count(hash);
+    if (alg_name_len > HASH_STATE_MAX_ALG_NAME_LEN || word_count > AWS_ARRAY_SIZE(state.chaining_values)) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    if (hash->vtable->export_state(hash, &state)) {
+        return AWS_OP_ERR;
+    }
+
+    size_t buffered_len = (size_t)(state.message_len % HASH_STATE_BLOCK_LEN);
+    size_t state_len = 2 + alg_name_len + 8 + word_count * sizeof(uint32_t) + buffered_len;
+    int result = AWS_OP_SUCCESS;
+
+    if (output->capacity - output->len < state_len) {
+        result = aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+        goto done;
+    }
+
+    aws_byte_buf_write_u8(output, HASH_STATE_VERSION);
+    aws_byte_buf_write_u8(output, (uint8_t)alg_name_len);
+    aws_byte_buf_write(output, (const uint8_t *)hash->vtable->alg_name, alg_name_len);
+    aws_byte_buf_write_be64(output, state.message_len);
+    for (size_t i = 0; i < word_count; ++i) {
+        aws_byte_buf_write_be32(output, state.chaining_values[i]);
+    }
+    aws_byte_buf_write(output, state.buffered, buffered_len);
+
+done:
+    aws_secure_zero(&state, sizeof(state));
+    return result;
+}
+
+int aws_hash_import_state(struct aws_hash *hash, struct aws_byte_cursor state) {
+    if (hash->vtable->import_state == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    struct aws_hash_md_state md_state;
+    AWS_ZERO_STRUCT(md_state);
+    int result = AWS_OP_SUCCESS;
+
+    uint8_t version = 0;
+    uint8_t alg_name_len = 0;
+    struct aws_byte_cursor alg_name;
+    AWS_ZERO_STRUCT(alg_name);
+    struct aws_byte_cursor expected_alg_name = aws_byte_cursor_from_c_str(hash->vtable->alg_name);
+
+    if (!aws_byte_cursor_read_u8(&state, &version) || version != HASH_STATE_VERSION ||
+        !aws_byte_cursor_read_u8(&state, &alg_name_len)) {
+        goto malformed;
+    }
+
+    alg_name = aws_byte_cursor_advance(&state, alg_name_len);
+    if (alg_name.len != alg_name_len || !aws_byte_cursor_eq(&alg_name, &expected_alg_name) ||
+        !aws_byte_cursor_read_be64(&state, &md_state.message_len)) {
+        goto malformed;
+    }
+
+    size_t word_count = s_hash_state_word_count(hash);
+    if (word_count > AWS_ARRAY_SIZE(md_state.chaining_values)) {
+        goto malformed;
+    }
+
+    for (size_t i = 0; i < word_count; ++i) {
+        if (!aws_byte_cursor_read_be32(&state, &md_state.chaining_values[i])) {
+            goto malformed;
+        }
+    }
+
+    size_t buffered_len = (size_t)(md_state.message_len % HASH_STATE_BLOCK_LEN);
+    if (!aws_byte_cursor_read(&state, md_state.buffered, buffered_len) || state.len != 0) {
+        goto malformed;
+    }
+
+    result = hash->vtable->import_state(hash, &md_state);
+    goto done;
+
+malformed:
+    result = aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+
+done:
+    aws_secure_zero(&md_state, sizeof(md_state));
+    return result;
+}
+
 static inline int compute_hash(
     struct aws_hash *hash,
     const struct aws_byte_cursor *input,
@@ -104,12 +381,251 @@ static inline int compute_hash(
     return AWS_OP_SUCCESS;
 }
 
+/*
+ * The one-shot compute functions keep one hash instance per algorithm per thread and reset it
+ * between calls rather than paying for a fresh allocation (and provider context) every time.
+ * An entry is only reused if it came from the same allocator and the same new_fn that the
+ * current call would have used, so aws_set_*_new_fn() overrides take effect immediately.
+ *
+ * Entries are only kept on threads that release them when they exit, which are the ones started
+ * with aws_thread_launch(). Anywhere else nothing would ever free them, so those calls create and
+ * destroy an instance each time. aws_cal_thread_clean_up() releases them sooner, which is needed
+ * before an allocator that was passed in goes away.
+ */
+struct hash_thread_cache_entry {
+    aws_hash_new_fn *new_fn;
+    struct aws_hash *hash;
+};
+
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_sha256_cache;
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_sha1_cache;
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_md5_cache;
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_sha384_cache;
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_sha512_cache;
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_sha512_256_cache;
+static AWS_THREAD_LOCAL struct hash_thread_cache_entry tl_blake3_cache;
+
+enum hash_thread_cache_state {
+    HASH_THREAD_CACHE_UNKNOWN,
+    HASH_THREAD_CACHE_AVAILABLE,
+    HASH_THREAD_CACHE_UNAVAILABLE,
+};
+
+static AWS_THREAD_LOCAL enum hash_thread_cache_state tl_cache_state = HASH_THREAD_CACHE_UNKNOWN;
+
+static void s_thread_cache_entry_clean_up(struct hash_thread_cache_entry *entry) {
+    if (entry->hash != NULL) {
+        aws_hash_destroy(entry->hash);
+    }
+
+    AWS_ZERO_STRUCT(*entry);
+}
+
+/* Invoked from aws_cal_thread_clean_up() and aws_cal_library_clean_up(). */
+void aws_hash_thread_clean_up(void) {
+    s_thread_cache_entry_clean_up(&tl_sha256_cache);
+    s_thread_cache_entry_clean_up(&tl_sha1_cache);
+    s_thread_cache_entry_clean_up(&tl_md5_cache);
+    s_thread_cache_entry_clean_up(&tl_sha384_cache);
+    s_thread_cache_entry_clean_up(&tl_sha512_cache);
+    s_thread_cache_entry_clean_up(&tl_sha512_256_cache);
+    s_thread_cache_entry_clean_up(&tl_blake3_cache);
+}
+
+static void s_hash_thread_cache_at_exit(void *user_data) {
+    (void)user_data;
+    aws_hash_thread_clean_up();
+}
+
+/* Registers the release of this thread's entries at thread exit the first time it's asked. */
+static bool s_thread_cache_available(void) {
+    if (tl_cache_state == HASH_THREAD_CACHE_UNKNOWN) {
+        /* failing only means this isn't a thread we launched, which isn't the caller's error */
+        int last_error = aws_last_error();
+        if (aws_thread_current_at_exit(s_hash_thread_cache_at_exit, NULL) == AWS_OP_SUCCESS) {
+            tl_cache_state = HASH_THREAD_CACHE_AVAILABLE;
+        } else {
+            tl_cache_state = HASH_THREAD_CACHE_UNAVAILABLE;
+            aws_restore_error(last_error);
+        }
+    }
+
+    return tl_cache_state == HASH_THREAD_CACHE_AVAILABLE;
+}
+
+struct hash_default_digest {
+    aws_hash_new_fn *new_fn;
+    bool (*digest)(const struct aws_byte_cursor *input, uint8_t *out);
+    size_t digest_size;
+};
+
+#ifndef BYO_CRYPTO
+static const struct hash_default_digest s_sha256_default_digest = {
+    .new_fn = aws_sha256_default_new,
+    .digest = aws_sha256_default_digest,
+    .digest_size = AWS_SHA256_LEN,
+};
+
+static const struct hash_default_digest s_sha1_default_digest = {
+    .new_fn = aws_sha1_default_new,
+    .digest = aws_sha1_default_digest,
+    .digest_size = AWS_SHA1_LEN,
+};
+
+static const struct hash_default_digest s_md5_default_digest = {
+    .new_fn = aws_md5_default_new,
+    .digest = aws_md5_default_digest,
+    .digest_size = AWS_MD5_LEN,
+};
+
+static const struct hash_default_digest s_sha384_default_digest = {
+    .new_fn = aws_sha384_default_new,
+    .digest = aws_sha384_default_digest,
+    .digest_size = AWS_SHA384_LEN,
+};
+
+static const struct hash_default_digest s_sha512_default_digest = {
+    .new_fn = aws_sha512_default_new,
+    .digest = aws_sha512_default_digest,
+    .digest_size = AWS_SHA512_LEN,
+};
+
+static const struct hash_default_digest s_sha512_256_default_digest = {
+    .new_fn = aws_sha512_256_default_new,
+    .digest = aws_sha512_256_default_digest,
+    .digest_size = AWS_SHA512_256_LEN,
+};
+#else
+static const struct hash_default_digest s_sha256_default_digest = {.digest_size = AWS_SHA256_LEN};
+
+static const struct hash_default_digest s_sha1_default_digest = {.digest_size = AWS_SHA1_LEN};
+
+static const struct hash_default_digest s_md5_default_digest = {.digest_size = AWS_MD5_LEN};
+
+static const struct hash_default_digest s_sha384_default_digest = {.digest_size = AWS_SHA384_LEN};
+
+static const struct hash_default_digest s_sha512_default_digest = {.digest_size = AWS_SHA512_LEN};
+
+static const struct hash_default_digest s_sha512_256_default_digest = {.digest_size = AWS_SHA512_256_LEN};
+#endif
+
+/* Returns true if the platform computed the digest in a single call, with its outcome in result. */
+static bool s_compute_default_digest(
+    const struct hash_default_digest *default_digest,
+    aws_hash_new_fn *new_fn,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to,
+    int *result) {
+
+    if (default_digest->digest == NULL || new_fn != default_digest->new_fn) {
+        return false;
+    }
+
+#ifdef AWS_CAL_STATS
+    /* a single platform call has no instance to attribute it to, so while counting go through one. */
+    if (aws_cal_stats_active()) {
+        return false;
+    }
+#endif
+
+    size_t digest_size = default_digest->digest_size;
+    size_t output_len = truncate_to && truncate_to < digest_size ? truncate_to : digest_size;
+    size_t available_buffer = output->capacity - output->len;
+
+    if (available_buffer < output_len) {
+        *result = aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+        return true;
+    }
+
+    /* like aws_hash_finalize(), a truncated digest goes through a copy so nothing past it is written to output */
+    if (output_len == digest_size) {
+        if (!default_digest->digest(input, output->buffer + output->len)) {
+            return false;
+        }
+    } else {
+        uint8_t digest[AWS_SHA512_LEN];
+        AWS_ASSERT(sizeof(digest) >= digest_size);
+
+        if (!default_digest->digest(input, digest)) {
+            return false;
+        }
+        memcpy(output->buffer + output->len, digest, output_len);
+    }
+
+    output->len += output_len;
+    *result = AWS_OP_SUCCESS;
+    return true;
+}
+
+static int s_compute_hash_cached(
+    struct hash_thread_cache_entry *entry,
+    aws_hash_new_fn *new_fn,
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+
+    if (!s_thread_cache_available()) {
+        struct aws_hash *hash = s_hash_created(new_fn(allocator));
+        if (!hash) {
+            return AWS_OP_ERR;
+        }
+
+        return compute_hash(hash, input, output, truncate_to);
+    }
+
+    /* take ownership of the cached hash while it's in use, in case new_fn ends up back in here. */
+    struct aws_hash *hash = entry->hash;
+    entry->hash = NULL;
+
+    if (hash != NULL && (entry->new_fn != new_fn || hash->allocator != allocator)) {
+        aws_hash_destroy(hash);
+        hash = NULL;
+    }
+
+    if (hash == NULL) {
+        hash = s_hash_created(new_fn(allocator));
+
+        if (!hash) {
+            return AWS_OP_ERR;
+        }
+
+        /* implementations that can't be reset get the original create/destroy behavior */
+        if (hash->vtable->reset == NULL) {
+            return compute_hash(hash, input, output, truncate_to);
+        }
+    }
+
+    if (aws_hash_update(hash, input) || aws_hash_finalize(hash, output, truncate_to)) {
+        aws_hash_destroy(hash);
+        return AWS_OP_ERR;
+    }
+
+    if (aws_hash_reset(hash)) {
+        aws_hash_destroy(hash);
+        return AWS_OP_SUCCESS;
+    }
+
+    /* a nested call may have refilled the entry in the meantime, only one instance is kept */
+    s_thread_cache_entry_clean_up(entry);
+    entry->new_fn = new_fn;
+    entry->hash = hash;
+
+    return AWS_OP_SUCCESS;
+}
+
 int aws_md5_compute(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *input,
     struct aws_byte_buf *output,
     size_t truncate_to) {
-    return compute_hash(aws_md5_new(allocator), input, output, truncate_to);
+    int result = AWS_OP_SUCCESS;
+    if (s_compute_default_digest(&s_md5_default_digest, s_md5_new_fn, input, output, truncate_to, &result)) {
+        return result;
+    }
+
+    return s_compute_hash_cached(&tl_md5_cache, s_md5_new_fn, allocator, input, output, truncate_to);
 }
 
 int aws_sha256_compute(
@@ -117,7 +633,102 @@ int aws_sha256_compute(
     const struct aws_byte_cursor *input,
     struct aws_byte_buf *output,
     size_t truncate_to) {
-    return compute_hash(aws_sha256_new(allocator), input, output, truncate_to);
+    int result = AWS_OP_SUCCESS;
+    if (s_compute_default_digest(&s_sha256_default_digest, s_sha256_new_fn, input, output, truncate_to, &result)) {
+        return result;
+    }
+
+    return s_compute_hash_cached(&tl_sha256_cache, s_sha256_new_fn, allocator, input, output, truncate_to);
+}
+
+int aws_sha256_compute_file(
+    struct aws_allocator *allocator,
+    const char *path,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    if (!hash) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_ERR;
+    if (aws_hash_update_file(hash, path) == AWS_OP_SUCCESS) {
+        result = aws_hash_finalize(hash, output, truncate_to);
+    }
+
+    aws_hash_destroy(hash);
+    return result;
+}
+
+/*
+ * libcrypto, CommonCrypto and CNG have no multi-buffer sha256, so with them every message is hashed in turn on one
+ * instance. The builtin sha256 hashes messages in pairs on an interleaved kernel instead.
+ */
+static int s_sha256_compute_batch_default(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to) {
+
+#ifdef AWS_CAL_BUILTIN_SHA
+    bool builtin_batch = s_sha256_new_fn == aws_sha256_builtin_new;
+#    ifdef AWS_CAL_STATS
+    /* the pairs have no instance to attribute them to, so while counting go through one. */
+    builtin_batch = builtin_batch && !aws_cal_stats_active();
+#    endif
+    if (builtin_batch) {
+        return aws_sha256_builtin_compute_batch(allocator, inputs, outputs, count, truncate_to);
+    }
+#endif /* AWS_CAL_BUILTIN_SHA */
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    if (!hash) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_SUCCESS;
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0 && aws_hash_reset(hash)) {
+            /* not resettable, fall back to a fresh instance per message */
+            aws_hash_destroy(hash);
+            hash = aws_sha256_new(allocator);
+            if (!hash) {
+                return AWS_OP_ERR;
+            }
+        }
+
+        if (aws_hash_update(hash, &inputs[i]) || aws_hash_finalize(hash, &outputs[i], truncate_to)) {
+            result = AWS_OP_ERR;
+            break;
+        }
+    }
+
+    aws_hash_destroy(hash);
+    return result;
+}
+
+int aws_sha256_compute_batch(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    size_t truncate_to) {
+
+    size_t digest_len = truncate_to && truncate_to < AWS_SHA256_LEN ? truncate_to : AWS_SHA256_LEN;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (outputs[i].capacity - outputs[i].len < digest_len) {
+            return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+        }
+    }
+
+    if (count == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return s_sha256_compute_batch_fn(allocator, inputs, outputs, count, truncate_to);
 }
 
 int aws_sha1_compute(
@@ -125,5 +736,58 @@ int aws_sha1_compute(
     const struct aws_byte_cursor *input,
     struct aws_byte_buf *output,
     size_t truncate_to) {
-    return compute_hash(aws_sha1_new(allocator), input, output, truncate_to);
+    int result = AWS_OP_SUCCESS;
+    if (s_compute_default_digest(&s_sha1_default_digest, s_sha1_new_fn, input, output, truncate_to, &result)) {
+        return result;
+    }
+
+    return s_compute_hash_cached(&tl_sha1_cache, s_sha1_new_fn, allocator, input, output, truncate_to);
+}
+
+int aws_sha384_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    int result = AWS_OP_SUCCESS;
+    if (s_compute_default_digest(&s_sha384_default_digest, s_sha384_new_fn, input, output, truncate_to, &result)) {
+        return result;
+    }
+
+    return s_compute_hash_cached(&tl_sha384_cache, s_sha384_new_fn, allocator, input, output, truncate_to);
+}
+
+int aws_sha512_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    int result = AWS_OP_SUCCESS;
+    if (s_compute_default_digest(&s_sha512_default_digest, s_sha512_new_fn, input, output, truncate_to, &result)) {
+        return result;
+    }
+
+    return s_compute_hash_cached(&tl_sha512_cache, s_sha512_new_fn, allocator, input, output, truncate_to);
+}
+
+int aws_sha512_256_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    int result = AWS_OP_SUCCESS;
+    if (s_compute_default_digest(
+            &s_sha512_256_default_digest, s_sha512_256_new_fn, input, output, truncate_to, &result)) {
+        return result;
+    }
+
+    return s_compute_hash_cached(&tl_sha512_256_cache, s_sha512_256_new_fn, allocator, input, output, truncate_to);
+}
+
+int aws_blake3_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    return s_compute_hash_cached(&tl_blake3_cache, s_blake3_new_fn, allocator, input, output, truncate_to);
 }
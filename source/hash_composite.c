@@ -0,0 +1,127 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/hash.h>
+
+/*
+ * Composite sha256, as S3 uses for multipart uploads: the digest of the concatenated part digests. The parts are
+ * dealt out to the tasks in neighbouring runs, and each task hashes its run with aws_sha256_compute_batch(), so
+ * it works through the parts on a single instance that's reset in between, and picks up a multi-buffer
+ * implementation if one has been installed.
+ */
+
+#define S_DEFAULT_MAX_TASKS 8
+#define S_MAX_TASKS 64
+
+struct sha256_composite_task {
+    struct aws_allocator *allocator;
+    const struct aws_byte_cursor *inputs;
+    struct aws_byte_buf *outputs;
+    size_t count;
+    int error_code;
+};
+
+static void s_run_task(void *arg) {
+    struct sha256_composite_task *task = arg;
+    if (aws_sha256_compute_batch(task->allocator, task->inputs, task->outputs, task->count, 0)) {
+        task->error_code = aws_last_error();
+    }
+}
+
+size_t aws_sha256_composite_part_count(size_t input_len, size_t part_size) {
+    if (part_size == 0) {
+        return 0;
+    }
+
+    return input_len ? input_len / part_size + (input_len % part_size != 0) : 1;
+}
+
+int aws_sha256_composite_compute(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor input,
+    const struct aws_sha256_composite_options *options,
+    struct aws_byte_buf *part_digests,
+    struct aws_byte_buf *output) {
+
+    if (!options || options->part_size == 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    size_t part_count = aws_sha256_composite_part_count(input.len, options->part_size);
+    size_t digests_len = 0;
+    if (aws_mul_size_checked(part_count, AWS_SHA256_LEN, &digests_len)) {
+        return AWS_OP_ERR;
+    }
+
+    if (output->capacity - output->len < AWS_SHA256_LEN ||
+        (part_digests && part_digests->capacity - part_digests->len < digests_len)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    size_t max_tasks = options->max_tasks ? aws_min_size(options->max_tasks, S_MAX_TASKS) : S_DEFAULT_MAX_TASKS;
+    if (!options->run_tasks) {
+        max_tasks = 1;
+    }
+
+    size_t parts_per_task = (part_count + max_tasks - 1) / max_tasks;
+    size_t task_count = (part_count + parts_per_task - 1) / parts_per_task;
+
+    /* the part digests go straight into part_digests when there is one, so only the bookkeeping is allocated. */
+    uint8_t *digests =
+        part_digests ? part_digests->buffer + part_digests->len : aws_mem_acquire(allocator, digests_len);
+    struct aws_byte_cursor *inputs = aws_mem_calloc(allocator, part_count, sizeof(struct aws_byte_cursor));
+    struct aws_byte_buf *outputs = aws_mem_calloc(allocator, part_count, sizeof(struct aws_byte_buf));
+    struct sha256_composite_task *tasks = aws_mem_calloc(allocator, task_count, sizeof(struct sha256_composite_task));
+    void **task_args = aws_mem_calloc(allocator, task_count, sizeof(void *));
+
+    struct aws_byte_cursor remaining = input;
+    for (size_t i = 0; i < part_count; ++i) {
+        inputs[i] = aws_byte_cursor_advance(&remaining, aws_min_size(options->part_size, remaining.len));
+        outputs[i] = aws_byte_buf_from_empty_array(digests + i * AWS_SHA256_LEN, AWS_SHA256_LEN);
+    }
+
+    for (size_t i = 0; i < task_count; ++i) {
+        size_t first_part = i * parts_per_task;
+        tasks[i].allocator = allocator;
+        tasks[i].inputs = inputs + first_part;
+        tasks[i].outputs = outputs + first_part;
+        tasks[i].count = aws_min_size(parts_per_task, part_count - first_part);
+        task_args[i] = &tasks[i];
+    }
+
+    if (task_count == 1) {
+        s_run_task(task_args[0]);
+    } else {
+        options->run_tasks(s_run_task, task_args, task_count, options->user_data);
+    }
+
+    int result = AWS_OP_SUCCESS;
+    for (size_t i = 0; i < task_count; ++i) {
+        if (tasks[i].error_code) {
+            result = aws_raise_error(tasks[i].error_code);
+            break;
+        }
+    }
+
+    if (result == AWS_OP_SUCCESS) {
+        struct aws_byte_cursor all_digests = aws_byte_cursor_from_array(digests, digests_len);
+        result = aws_sha256_compute(allocator, &all_digests, output, 0);
+    }
+
+    if (part_digests) {
+        if (result == AWS_OP_SUCCESS) {
+            part_digests->len += digests_len;
+        } else {
+            aws_secure_zero(digests, digests_len);
+        }
+    } else {
+        aws_mem_release(allocator, digests);
+    }
+
+    aws_mem_release(allocator, task_args);
+    aws_mem_release(allocator, tasks);
+    aws_mem_release(allocator, outputs);
+    aws_mem_release(allocator, inputs);
+    return result;
+}
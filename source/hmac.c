@@ -4,11 +4,22 @@
  */
 #include <aws/cal/hmac.h>
 
+#include <aws/cal/private/stats.h>
+
 #ifndef BYO_CRYPTO
 extern struct aws_hmac *aws_sha256_hmac_default_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *secret);
+extern struct aws_hmac *aws_sha384_hmac_default_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret);
+extern struct aws_hmac *aws_sha512_hmac_default_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret);
+
 static aws_hmac_new_fn *s_sha256_hmac_new_fn = aws_sha256_hmac_default_new;
+static aws_hmac_new_fn *s_sha384_hmac_new_fn = aws_sha384_hmac_default_new;
+static aws_hmac_new_fn *s_sha512_hmac_new_fn = aws_sha512_hmac_default_new;
 #else
 static struct aws_hmac *aws_hmac_new_abort(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
     (void)allocator;
@@ -17,25 +28,51 @@ static struct aws_hmac *aws_hmac_new_abort(struct aws_allocator *allocator, cons
 }
 
 static aws_hmac_new_fn *s_sha256_hmac_new_fn = aws_hmac_new_abort;
+static aws_hmac_new_fn *s_sha384_hmac_new_fn = aws_hmac_new_abort;
+static aws_hmac_new_fn *s_sha512_hmac_new_fn = aws_hmac_new_abort;
 #endif
 
+static struct aws_hmac *s_hmac_created(struct aws_hmac *hmac) {
+    AWS_CAL_STATS_NEW(hmac);
+    return hmac;
+}
+
 struct aws_hmac *aws_sha256_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
-    return s_sha256_hmac_new_fn(allocator, secret);
+    return s_hmac_created(s_sha256_hmac_new_fn(allocator, secret));
+}
+
+struct aws_hmac *aws_sha384_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_created(s_sha384_hmac_new_fn(allocator, secret));
+}
+
+struct aws_hmac *aws_sha512_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_created(s_sha512_hmac_new_fn(allocator, secret));
 }
 
 void aws_set_sha256_hmac_new_fn(aws_hmac_new_fn *fn) {
     s_sha256_hmac_new_fn = fn;
 }
 
+void aws_set_sha384_hmac_new_fn(aws_hmac_new_fn *fn) {
+    s_sha384_hmac_new_fn = fn;
+}
+
+void aws_set_sha512_hmac_new_fn(aws_hmac_new_fn *fn) {
+    s_sha512_hmac_new_fn = fn;
+}
+
 void aws_hmac_destroy(struct aws_hmac *hmac) {
     hmac->vtable->destroy(hmac);
 }
 
 int aws_hmac_update(struct aws_hmac *hmac, const struct aws_byte_cursor *to_hmac) {
-    return hmac->vtable->update(hmac, to_hmac);
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = hmac->vtable->update(hmac, to_hmac);
+    AWS_CAL_STATS_END(stats, hmac->vtable, AWS_CAL_STATS_OP_UPDATE, to_hmac->len, result);
+    return result;
 }
 
-int aws_hmac_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output, size_t truncate_to) {
+static int s_hmac_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output, size_t truncate_to) {
     if (truncate_to && truncate_to < hmac->digest_size) {
         size_t available_buffer = output->capacity - output->len;
         if (available_buffer < truncate_to) {
@@ -60,14 +97,97 @@ int aws_hmac_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output, size_t
     return hmac->vtable->finalize(hmac, output);
 }
 
-int aws_sha256_hmac_compute(
+int aws_hmac_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output, size_t truncate_to) {
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_hmac_finalize(hmac, output, truncate_to);
+    AWS_CAL_STATS_END(stats, hmac->vtable, AWS_CAL_STATS_OP_FINALIZE, 0, result);
+    return result;
+}
+
+int aws_hmac_reset(struct aws_hmac *hmac) {
+    if (hmac->vtable->reset == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    return hmac->vtable->reset(hmac);
+}
+
+struct aws_hmac *aws_hmac_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac) {
+    if (hmac->vtable->duplicate == NULL) {
+        aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+        return NULL;
+    }
+
+    return hmac->vtable->duplicate(allocator, hmac);
+}
+
+struct aws_hmac_key_template {
+    struct aws_allocator *allocator;
+    /* keyed but never updated, it is only ever duplicated */
+    struct aws_hmac *keyed_hmac;
+};
+
+static struct aws_hmac_key_template *s_hmac_key_template_new(struct aws_allocator *allocator, struct aws_hmac *hmac) {
+    if (!hmac) {
+        return NULL;
+    }
+
+    if (hmac->vtable->duplicate == NULL) {
+        aws_hmac_destroy(hmac);
+        aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+        return NULL;
+    }
+
+    struct aws_hmac_key_template *key_template = aws_mem_calloc(allocator, 1, sizeof(struct aws_hmac_key_template));
+    if (!key_template) {
+        aws_hmac_destroy(hmac);
+        return NULL;
+    }
+
+    key_template->allocator = allocator;
+    key_template->keyed_hmac = hmac;
+    return key_template;
+}
+
+struct aws_hmac_key_template *aws_sha256_hmac_key_template_new(
     struct aws_allocator *allocator,
-    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *secret) {
+    return s_hmac_key_template_new(allocator, aws_sha256_hmac_new(allocator, secret));
+}
+
+struct aws_hmac_key_template *aws_sha384_hmac_key_template_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret) {
+    return s_hmac_key_template_new(allocator, aws_sha384_hmac_new(allocator, secret));
+}
+
+struct aws_hmac_key_template *aws_sha512_hmac_key_template_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret) {
+    return s_hmac_key_template_new(allocator, aws_sha512_hmac_new(allocator, secret));
+}
+
+void aws_hmac_key_template_destroy(struct aws_hmac_key_template *key_template) {
+    if (key_template == NULL) {
+        return;
+    }
+
+    aws_hmac_destroy(key_template->keyed_hmac);
+    aws_mem_release(key_template->allocator, key_template);
+}
+
+struct aws_hmac *aws_hmac_new_from_key_template(
+    struct aws_allocator *allocator,
+    const struct aws_hmac_key_template *key_template) {
+    const struct aws_hmac *keyed_hmac = key_template->keyed_hmac;
+    return s_hmac_created(keyed_hmac->vtable->duplicate(allocator, keyed_hmac));
+}
+
+static inline int compute_hmac(
+    struct aws_hmac *hmac,
     const struct aws_byte_cursor *to_hmac,
     struct aws_byte_buf *output,
     size_t truncate_to) {
-    struct aws_hmac *hmac = aws_sha256_hmac_new(allocator, secret);
-
     if (!hmac) {
         return AWS_OP_ERR;
     }
@@ -85,3 +205,207 @@ int aws_sha256_hmac_compute(
     aws_hmac_destroy(hmac);
     return AWS_OP_SUCCESS;
 }
+
+int aws_sha256_hmac_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *to_hmac,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    return compute_hmac(aws_sha256_hmac_new(allocator, secret), to_hmac, output, truncate_to);
+}
+
+static int s_hmac_rekey(struct aws_hmac **hmac, const struct aws_byte_cursor *secret) {
+    if ((*hmac)->vtable->rekey != NULL) {
+        return (*hmac)->vtable->rekey(*hmac, secret);
+    }
+
+    struct aws_allocator *allocator = (*hmac)->allocator;
+    aws_hmac_destroy(*hmac);
+    *hmac = aws_sha256_hmac_new(allocator, secret);
+    return *hmac ? AWS_OP_SUCCESS : AWS_OP_ERR;
+}
+
+int aws_sha256_hmac_chain_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *seed_secret,
+    const struct aws_byte_cursor *messages,
+    size_t message_count,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    AWS_PRECONDITION(messages || message_count == 0);
+
+    if (message_count == 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct aws_hmac *hmac = aws_sha256_hmac_new(allocator, seed_secret);
+    if (!hmac) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_SUCCESS;
+    uint8_t key[AWS_SHA256_HMAC_LEN] = {0};
+
+    for (size_t i = 0; i + 1 < message_count; ++i) {
+        struct aws_byte_buf key_buf = aws_byte_buf_from_empty_array(key, sizeof(key));
+
+        if (aws_hmac_update(hmac, &messages[i]) || aws_hmac_finalize(hmac, &key_buf, 0)) {
+            result = AWS_OP_ERR;
+            goto clean_up;
+        }
+
+        struct aws_byte_cursor next_secret = aws_byte_cursor_from_buf(&key_buf);
+        if (s_hmac_rekey(&hmac, &next_secret)) {
+            result = AWS_OP_ERR;
+            goto clean_up;
+        }
+    }
+
+    if (aws_hmac_update(hmac, &messages[message_count - 1]) || aws_hmac_finalize(hmac, output, truncate_to)) {
+        result = AWS_OP_ERR;
+    }
+
+clean_up:
+    aws_secure_zero(key, sizeof(key));
+    if (hmac) {
+        aws_hmac_destroy(hmac);
+    }
+
+    return result;
+}
+
+int aws_sha384_hmac_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *to_hmac,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    return compute_hmac(aws_sha384_hmac_new(allocator, secret), to_hmac, output, truncate_to);
+}
+
+int aws_sha512_hmac_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *to_hmac,
+    struct aws_byte_buf *output,
+    size_t truncate_to) {
+    return compute_hmac(aws_sha512_hmac_new(allocator, secret), to_hmac, output, truncate_to);
+}
+
+static int s_hkdf_compute(
+    struct aws_allocator *allocator,
+    aws_hmac_new_fn *hmac_new_fn,
+    size_t digest_size,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *salt,
+    const struct aws_byte_cursor *info,
+    struct aws_byte_buf *output,
+    size_t length) {
+    AWS_PRECONDITION(secret);
+    AWS_PRECONDITION(aws_byte_buf_is_valid(output));
+
+    if (length == 0 || length > 255 * digest_size) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (output->capacity - output->len < length) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    /* RFC 5869 2.2: a missing salt is a string of digest_size zeros */
+    uint8_t zero_salt[AWS_SHA512_HMAC_LEN] = {0};
+    struct aws_byte_cursor extract_salt = aws_byte_cursor_from_array(zero_salt, digest_size);
+    if (salt && salt->len > 0) {
+        extract_salt = *salt;
+    }
+
+    struct aws_byte_cursor expand_info = {0};
+    if (info) {
+        expand_info = *info;
+    }
+
+    /* the output is written one block at a time, so a failure part way through has to take back what was written */
+    const size_t start_len = output->len;
+    int result = AWS_OP_ERR;
+    uint8_t prk[AWS_SHA512_HMAC_LEN] = {0};
+    uint8_t block[AWS_SHA512_HMAC_LEN] = {0};
+    struct aws_byte_buf prk_buf = aws_byte_buf_from_empty_array(prk, sizeof(prk));
+    struct aws_hmac *hmac = NULL;
+
+    /* extract */
+    if (compute_hmac(hmac_new_fn(allocator, &extract_salt), secret, &prk_buf, 0)) {
+        goto clean_up;
+    }
+
+    /* expand: T(i) = HMAC(prk, T(i - 1) | info | i) */
+    struct aws_byte_cursor prk_cur = aws_byte_cursor_from_buf(&prk_buf);
+    hmac = hmac_new_fn(allocator, &prk_cur);
+    if (!hmac) {
+        goto clean_up;
+    }
+
+    struct aws_byte_cursor previous_block = {0};
+    size_t remaining = length;
+    for (uint8_t counter = 1; remaining > 0; ++counter) {
+        struct aws_byte_cursor counter_cur = aws_byte_cursor_from_array(&counter, 1);
+        struct aws_byte_buf block_buf = aws_byte_buf_from_empty_array(block, sizeof(block));
+
+        if (aws_hmac_update(hmac, &previous_block) || aws_hmac_update(hmac, &expand_info) ||
+            aws_hmac_update(hmac, &counter_cur) || aws_hmac_finalize(hmac, &block_buf, 0)) {
+            goto clean_up;
+        }
+
+        size_t to_copy = aws_min_size(remaining, digest_size);
+        memcpy(output->buffer + output->len, block, to_copy);
+        output->len += to_copy;
+        remaining -= to_copy;
+
+        if (remaining > 0 && aws_hmac_reset(hmac)) {
+            /* implementations without reset get a fresh instance keyed the same way */
+            aws_hmac_destroy(hmac);
+            hmac = hmac_new_fn(allocator, &prk_cur);
+            if (!hmac) {
+                goto clean_up;
+            }
+        }
+
+        previous_block = aws_byte_cursor_from_buf(&block_buf);
+    }
+
+    result = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_secure_zero(prk, sizeof(prk));
+    aws_secure_zero(block, sizeof(block));
+    if (hmac) {
+        aws_hmac_destroy(hmac);
+    }
+
+    if (result != AWS_OP_SUCCESS) {
+        aws_secure_zero(output->buffer + start_len, output->len - start_len);
+        output->len = start_len;
+    }
+
+    return result;
+}
+
+int aws_sha256_hkdf_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *salt,
+    const struct aws_byte_cursor *info,
+    struct aws_byte_buf *output,
+    size_t length) {
+    return s_hkdf_compute(allocator, aws_sha256_hmac_new, AWS_SHA256_HMAC_LEN, secret, salt, info, output, length);
+}
+
+int aws_sha384_hkdf_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    const struct aws_byte_cursor *salt,
+    const struct aws_byte_cursor *info,
+    struct aws_byte_buf *output,
+    size_t length) {
+    return s_hkdf_compute(allocator, aws_sha384_hmac_new, AWS_SHA384_HMAC_LEN, secret, salt, info, output, length);
+}
@@ -0,0 +1,157 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/runtime_info.h>
+
+#include <aws/cal/cal.h>
+#include <aws/cal/hash.h>
+#include <aws/cal/hmac.h>
+#include <aws/cal/private/cpu_features.h>
+#include <aws/cal/private/symmetric_cipher_priv.h>
+#include <aws/cal/symmetric_cipher.h>
+
+#include <aws/common/logging.h>
+
+#ifndef BYO_CRYPTO
+extern void aws_cal_platform_libcrypto_info(const char **version, const char **version_string, const char **library);
+#endif /* BYO_CRYPTO */
+
+static struct aws_symmetric_cipher *s_aes_cbc_new(struct aws_allocator *allocator) {
+    return aws_aes_cbc_256_new(allocator, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_aes_ctr_new(struct aws_allocator *allocator) {
+    return aws_aes_ctr_256_new(allocator, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_aes_gcm_new(struct aws_allocator *allocator) {
+    return aws_aes_gcm_256_new(allocator, NULL, NULL, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_aes_keywrap_new(struct aws_allocator *allocator) {
+    return aws_aes_keywrap_256_new(allocator, NULL);
+}
+
+static struct aws_symmetric_cipher *s_aes_xts_new(struct aws_allocator *allocator) {
+    return aws_aes_xts_256_new(allocator, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_aes_gcm_siv_new(struct aws_allocator *allocator) {
+    return aws_aes_gcm_siv_256_new(allocator, NULL, NULL, NULL, NULL);
+}
+
+static struct aws_symmetric_cipher *s_chacha20_poly1305_new(struct aws_allocator *allocator) {
+    return aws_chacha20_poly1305_new(allocator, NULL, NULL, NULL, NULL);
+}
+
+/* exactly one of the constructors is set. The names match the ones the implementations' vtables use. */
+struct algorithm_probe {
+    const char *alg_name;
+    aws_hash_new_fn *hash_new;
+    aws_hmac_new_fn *hmac_new;
+    struct aws_symmetric_cipher *(*cipher_new)(struct aws_allocator *allocator);
+};
+
+static const struct algorithm_probe s_algorithm_probes[] = {
+    {.alg_name = "MD5", .hash_new = aws_md5_new},
+    {.alg_name = "SHA1", .hash_new = aws_sha1_new},
+    {.alg_name = "SHA256", .hash_new = aws_sha256_new},
+    {.alg_name = "SHA384", .hash_new = aws_sha384_new},
+    {.alg_name = "SHA512", .hash_new = aws_sha512_new},
+    {.alg_name = "SHA512/256", .hash_new = aws_sha512_256_new},
+    {.alg_name = "BLAKE3", .hash_new = aws_blake3_new},
+    {.alg_name = "SHA256 HMAC", .hmac_new = aws_sha256_hmac_new},
+    {.alg_name = "SHA384 HMAC", .hmac_new = aws_sha384_hmac_new},
+    {.alg_name = "SHA512 HMAC", .hmac_new = aws_sha512_hmac_new},
+    {.alg_name = "AES-CBC 256", .cipher_new = s_aes_cbc_new},
+    {.alg_name = "AES-CTR 256", .cipher_new = s_aes_ctr_new},
+    {.alg_name = "AES-GCM 256", .cipher_new = s_aes_gcm_new},
+    {.alg_name = "AES-KEYWRAP 256", .cipher_new = s_aes_keywrap_new},
+    {.alg_name = "AES-XTS 256", .cipher_new = s_aes_xts_new},
+    {.alg_name = "AES-GCM-SIV 256", .cipher_new = s_aes_gcm_siv_new},
+    {.alg_name = "ChaCha20-Poly1305", .cipher_new = s_chacha20_poly1305_new},
+};
+
+static const char *s_probe_provider(struct aws_allocator *allocator, const struct algorithm_probe *probe) {
+    const char *provider = NULL;
+
+    if (probe->hash_new) {
+        struct aws_hash *hash = probe->hash_new(allocator);
+        if (hash) {
+            provider = hash->vtable->provider;
+            aws_hash_destroy(hash);
+        }
+    } else if (probe->hmac_new) {
+        uint8_t secret[32] = {0};
+        struct aws_byte_cursor secret_cur = aws_byte_cursor_from_array(secret, sizeof(secret));
+        struct aws_hmac *hmac = probe->hmac_new(allocator, &secret_cur);
+        if (hmac) {
+            provider = hmac->vtable->provider;
+            aws_hmac_destroy(hmac);
+        }
+    } else {
+        struct aws_symmetric_cipher *cipher = probe->cipher_new(allocator);
+        if (cipher) {
+            provider = cipher->vtable->provider;
+            aws_symmetric_cipher_destroy(cipher);
+        }
+    }
+
+    return provider;
+}
+
+void aws_cal_get_runtime_info(struct aws_allocator *allocator, struct aws_cal_runtime_info *info) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(info);
+
+    AWS_ZERO_STRUCT(*info);
+
+#ifndef BYO_CRYPTO
+    aws_cal_platform_libcrypto_info(
+        &info->libcrypto_version, &info->libcrypto_version_string, &info->libcrypto_library);
+#endif /* BYO_CRYPTO */
+    info->libcrypto_allocations_routed = aws_cal_libcrypto_allocations_routed();
+    info->cpu_features = *aws_cal_get_cpu_features();
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(s_algorithm_probes); ++i) {
+        info->algorithms[i].alg_name = s_algorithm_probes[i].alg_name;
+        info->algorithms[i].provider = s_probe_provider(allocator, &s_algorithm_probes[i]);
+    }
+    info->algorithm_count = AWS_ARRAY_SIZE(s_algorithm_probes);
+}
+
+void aws_cal_log_runtime_info(struct aws_allocator *allocator) {
+    struct aws_cal_runtime_info info;
+    aws_cal_get_runtime_info(allocator, &info);
+
+    AWS_LOGF_INFO(
+        AWS_LS_CAL_GENERAL,
+        "libcrypto %s%s%s%s%s%s, allocations %srouted",
+        info.libcrypto_version ? info.libcrypto_version : "not used",
+        info.libcrypto_version_string ? " (" : "",
+        info.libcrypto_version_string ? info.libcrypto_version_string : "",
+        info.libcrypto_version_string ? ")" : "",
+        info.libcrypto_library ? " from " : "",
+        info.libcrypto_library ? info.libcrypto_library : "",
+        info.libcrypto_allocations_routed ? "" : "not ");
+
+    const struct aws_cal_cpu_features *features = &info.cpu_features;
+    AWS_LOGF_INFO(
+        AWS_LS_CAL_GENERAL,
+        "cpu features: AES-NI %d, PCLMULQDQ %d, AVX2 %d, SHA-NI %d, ARMv8 AES %d, ARMv8 SHA %d",
+        features->aes_ni,
+        features->pclmulqdq,
+        features->avx2,
+        features->sha_ni,
+        features->armv8_aes,
+        features->armv8_sha);
+
+    for (size_t i = 0; i < info.algorithm_count; ++i) {
+        AWS_LOGF_INFO(
+            AWS_LS_CAL_GENERAL,
+            "%s provided by %s",
+            info.algorithms[i].alg_name,
+            info.algorithms[i].provider ? info.algorithms[i].provider : "nothing, it is unavailable");
+    }
+}
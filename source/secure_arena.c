@@ -0,0 +1,414 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/cal.h>
+
+#include <aws/common/mutex.h>
+
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <sys/mman.h>
+#endif
+
+/*
+ * Key material is small and short lived, and allocating it from the heap scatters it across pages that may be
+ * swapped out, dumped or handed to someone else once freed. Instead it's carved out of chunks of locked pages, each
+ * chunk serving a single size class, and released slots are zeroed and kept on a free list for the class.
+ *
+ * Every allocator handed out charges a parent allocator: its chunks, and the allocations too big for any class, are
+ * acquired from the parent, so they show up in the parent's accounting and a leaked key keeps its chunk outstanding.
+ * A pool for the default allocator keeps its empty chunks for reuse until the library is cleaned up. Any other
+ * parent may not outlive its allocations by much, so its pool keeps only one empty chunk per size class, which saves
+ * creating and destroying a chunk every time a key comes and goes, and hands every chunk back as soon as nothing at all
+ * is allocated from it. Pools for other parents are freed by the library clean up, once nothing is allocated from them.
+ *
+ * Every allocation is preceded by a header with its size class, its length, and the chunk (or, for large
+ * allocations, the pool) it came from, so a release knows where it goes. Free slots are always zero apart from the
+ * free list link, so acquire zeroes just that and calloc is free.
+ */
+
+#define S_PAGE_LEN ((size_t)4096)
+#define S_CHUNK_LEN ((size_t)16 * 1024)
+/* room for a struct secure_chunk at the start of each chunk */
+#define S_CHUNK_HEADER_LEN 64
+/* room for a struct secure_header, and keeps the slots 16 byte aligned */
+#define S_HEADER_LEN 32
+#define S_LARGE_CLASS SIZE_MAX
+
+struct secure_header {
+    size_t size_class;
+    size_t len;
+    /* the struct secure_chunk for a slot, the struct secure_pool for a large allocation */
+    void *owner;
+};
+
+/* usable sizes, enough for the IVs, tags and 256 and 512 bit keys the ciphers keep. */
+static const size_t s_class_sizes[] = {16, 32, 64, 128, 256};
+#define S_CLASS_COUNT AWS_ARRAY_SIZE(s_class_sizes)
+
+struct secure_free_slot {
+    struct secure_free_slot *next;
+};
+
+struct secure_pool;
+
+/* sits at the start of the page aligned chunk, the slots follow it */
+struct secure_chunk {
+    struct secure_chunk *next;
+    struct secure_pool *pool;
+    /* what the parent handed out, which the chunk was aligned within */
+    void *block;
+    size_t size_class;
+    size_t live_slots;
+};
+
+struct secure_pool {
+    struct aws_allocator allocator;
+    struct aws_allocator *parent;
+    bool keeps_empty_chunks;
+    /* slots and large allocations both */
+    size_t live_allocations;
+    /* chunks with no live slots, per size class */
+    size_t empty_chunks[S_CLASS_COUNT];
+    struct secure_pool *next;
+    struct secure_chunk *chunks;
+    struct secure_free_slot *free_slots[S_CLASS_COUNT];
+};
+
+static void *s_secure_acquire(struct aws_allocator *allocator, size_t size);
+static void s_secure_release(struct aws_allocator *allocator, void *ptr);
+static void *s_secure_realloc(struct aws_allocator *allocator, void *ptr, size_t oldsize, size_t newsize);
+static void *s_secure_calloc(struct aws_allocator *allocator, size_t num, size_t size);
+
+static struct aws_mutex s_arena_lock = AWS_MUTEX_INIT;
+/* the pool for the default allocator, which needs no allocation of its own */
+static struct secure_pool s_default_pool = {
+    .allocator =
+        {
+            .mem_acquire = s_secure_acquire,
+            .mem_release = s_secure_release,
+            .mem_realloc = s_secure_realloc,
+            .mem_calloc = s_secure_calloc,
+            .impl = &s_default_pool,
+        },
+    .keeps_empty_chunks = true,
+};
+/* the pools for every other parent, freed by aws_cal_secure_arena_clean_up() unless something is still allocated. */
+static struct secure_pool *s_pools = NULL;
+
+/* the default pool's parent can't be set statically */
+static struct aws_allocator *s_pool_parent(const struct secure_pool *pool) {
+    return pool->parent ? pool->parent : aws_default_allocator();
+}
+
+/* locks and hides the chunk's pages, all best effort */
+static void s_protect_chunk(void *chunk) {
+#if defined(_WIN32)
+    VirtualLock(chunk, S_CHUNK_LEN);
+#else
+    /* RLIMIT_MEMLOCK may not allow it */
+    mlock(chunk, S_CHUNK_LEN);
+#    ifdef MADV_DONTDUMP
+    madvise(chunk, S_CHUNK_LEN, MADV_DONTDUMP);
+#    endif
+#endif
+}
+
+/* hands the pages back as ordinary heap memory */
+static void s_unprotect_chunk(void *chunk) {
+#if defined(_WIN32)
+    VirtualUnlock(chunk, S_CHUNK_LEN);
+#else
+    munlock(chunk, S_CHUNK_LEN);
+#    ifdef MADV_DODUMP
+    madvise(chunk, S_CHUNK_LEN, MADV_DODUMP);
+#    endif
+#endif
+}
+
+/* call with s_arena_lock held. Splits a new chunk from the pool's parent into free slots of the class. */
+static bool s_add_chunk(struct secure_pool *pool, size_t size_class) {
+    /* whole pages, so locking it doesn't pin whatever the parent put next to it */
+    uint8_t *block = aws_mem_acquire(s_pool_parent(pool), S_CHUNK_LEN + S_PAGE_LEN);
+    if (!block) {
+        return false;
+    }
+
+    uint8_t *chunk = (uint8_t *)(((uintptr_t)block + S_PAGE_LEN - 1) & ~(uintptr_t)(S_PAGE_LEN - 1));
+    memset(chunk, 0, S_CHUNK_LEN);
+    s_protect_chunk(chunk);
+
+    struct secure_chunk *chunk_header = (struct secure_chunk *)chunk;
+    chunk_header->next = pool->chunks;
+    chunk_header->pool = pool;
+    chunk_header->block = block;
+    chunk_header->size_class = size_class;
+    chunk_header->live_slots = 0;
+    pool->chunks = chunk_header;
+    ++pool->empty_chunks[size_class];
+
+    size_t slot_len = S_HEADER_LEN + s_class_sizes[size_class];
+    for (size_t offset = S_CHUNK_HEADER_LEN; offset + slot_len <= S_CHUNK_LEN; offset += slot_len) {
+        struct secure_header *header = (struct secure_header *)(chunk + offset);
+        header->size_class = size_class;
+        header->owner = chunk_header;
+
+        struct secure_free_slot *slot = (struct secure_free_slot *)(chunk + offset + S_HEADER_LEN);
+        slot->next = pool->free_slots[size_class];
+        pool->free_slots[size_class] = slot;
+    }
+
+    return true;
+}
+
+/* call with s_arena_lock held, on a chunk that's already off its pool's lists */
+static void s_release_chunk(struct secure_chunk *chunk) {
+    AWS_ASSERT(chunk->live_slots == 0);
+    struct aws_allocator *parent = s_pool_parent(chunk->pool);
+    void *block = chunk->block;
+    aws_secure_zero(chunk, S_CHUNK_LEN);
+    s_unprotect_chunk(chunk);
+    aws_mem_release(parent, block);
+}
+
+/* call with s_arena_lock held, on a chunk with no live slots. Returns it to the pool's parent. */
+static void s_remove_chunk(struct secure_chunk *chunk) {
+    struct secure_pool *pool = chunk->pool;
+    uint8_t *begin = (uint8_t *)chunk;
+    uint8_t *end = begin + S_CHUNK_LEN;
+
+    struct secure_free_slot **link = &pool->free_slots[chunk->size_class];
+    while (*link) {
+        uint8_t *slot = (uint8_t *)*link;
+        if (slot >= begin && slot < end) {
+            *link = (*link)->next;
+        } else {
+            link = &(*link)->next;
+        }
+    }
+
+    struct secure_chunk **chunk_link = &pool->chunks;
+    while (*chunk_link != chunk) {
+        chunk_link = &(*chunk_link)->next;
+    }
+    *chunk_link = chunk->next;
+
+    --pool->empty_chunks[chunk->size_class];
+    s_release_chunk(chunk);
+}
+
+/* call with s_arena_lock held, on a pool with nothing allocated from it. Returns all its chunks to its parent. */
+static void s_remove_all_chunks(struct secure_pool *pool) {
+    while (pool->chunks) {
+        struct secure_chunk *chunk = pool->chunks;
+        pool->chunks = chunk->next;
+        s_release_chunk(chunk);
+    }
+
+    AWS_ZERO_ARRAY(pool->free_slots);
+    AWS_ZERO_ARRAY(pool->empty_chunks);
+}
+
+static void *s_large_acquire(struct secure_pool *pool, size_t size) {
+    if (size > SIZE_MAX - S_HEADER_LEN) {
+        return NULL;
+    }
+
+    uint8_t *block = aws_mem_calloc(s_pool_parent(pool), 1, S_HEADER_LEN + size);
+    if (!block) {
+        return NULL;
+    }
+
+    aws_mutex_lock(&s_arena_lock);
+    ++pool->live_allocations;
+    aws_mutex_unlock(&s_arena_lock);
+
+    struct secure_header *header = (struct secure_header *)block;
+    header->size_class = S_LARGE_CLASS;
+    header->len = size;
+    header->owner = pool;
+    return block + S_HEADER_LEN;
+}
+
+static void *s_secure_acquire(struct aws_allocator *allocator, size_t size) {
+    struct secure_pool *pool = allocator->impl;
+
+    size_t size_class = 0;
+    while (size_class < S_CLASS_COUNT && s_class_sizes[size_class] < size) {
+        ++size_class;
+    }
+
+    if (size_class == S_CLASS_COUNT) {
+        return s_large_acquire(pool, size);
+    }
+
+    aws_mutex_lock(&s_arena_lock);
+    if (!pool->free_slots[size_class] && !s_add_chunk(pool, size_class)) {
+        aws_mutex_unlock(&s_arena_lock);
+        /* the parent may still manage an allocation that doesn't need a whole chunk */
+        return s_large_acquire(pool, size);
+    }
+
+    struct secure_free_slot *slot = pool->free_slots[size_class];
+    pool->free_slots[size_class] = slot->next;
+    struct secure_header *header = (struct secure_header *)((uint8_t *)slot - S_HEADER_LEN);
+    struct secure_chunk *chunk = header->owner;
+    if (chunk->live_slots++ == 0) {
+        --pool->empty_chunks[size_class];
+    }
+    ++pool->live_allocations;
+    aws_mutex_unlock(&s_arena_lock);
+
+    slot->next = NULL;
+    header->len = size;
+    return slot;
+}
+
+static void s_secure_release(struct aws_allocator *allocator, void *ptr) {
+    (void)allocator;
+
+    struct secure_header *header = (struct secure_header *)((uint8_t *)ptr - S_HEADER_LEN);
+    size_t size_class = header->size_class;
+
+    if (size_class == S_LARGE_CLASS) {
+        struct secure_pool *pool = header->owner;
+        aws_secure_zero(header, S_HEADER_LEN + header->len);
+        aws_mem_release(s_pool_parent(pool), header);
+
+        aws_mutex_lock(&s_arena_lock);
+        if (--pool->live_allocations == 0 && !pool->keeps_empty_chunks) {
+            s_remove_all_chunks(pool);
+        }
+        aws_mutex_unlock(&s_arena_lock);
+        return;
+    }
+
+    /* the whole slot, whatever was asked for, in case the caller wrote past their length */
+    aws_secure_zero(ptr, s_class_sizes[size_class]);
+    header->len = 0;
+
+    struct secure_chunk *chunk = header->owner;
+    struct secure_pool *pool = chunk->pool;
+    struct secure_free_slot *slot = ptr;
+    aws_mutex_lock(&s_arena_lock);
+    slot->next = pool->free_slots[size_class];
+    pool->free_slots[size_class] = slot;
+    --pool->live_allocations;
+    if (--chunk->live_slots == 0) {
+        ++pool->empty_chunks[size_class];
+        if (!pool->keeps_empty_chunks) {
+            if (pool->live_allocations == 0) {
+                s_remove_all_chunks(pool);
+            } else if (pool->empty_chunks[size_class] > 1) {
+                s_remove_chunk(chunk);
+            }
+        }
+    }
+    aws_mutex_unlock(&s_arena_lock);
+}
+
+static void *s_secure_realloc(struct aws_allocator *allocator, void *ptr, size_t oldsize, size_t newsize) {
+    if (!ptr) {
+        return s_secure_acquire(allocator, newsize);
+    }
+
+    struct secure_header *header = (struct secure_header *)((uint8_t *)ptr - S_HEADER_LEN);
+    if (header->size_class != S_LARGE_CLASS && newsize <= s_class_sizes[header->size_class]) {
+        if (newsize < header->len) {
+            aws_secure_zero((uint8_t *)ptr + newsize, header->len - newsize);
+        }
+        header->len = newsize;
+        return ptr;
+    }
+
+    void *new_ptr = s_secure_acquire(allocator, newsize);
+    if (!new_ptr) {
+        return NULL;
+    }
+
+    memcpy(new_ptr, ptr, aws_min_size(oldsize, newsize));
+    s_secure_release(allocator, ptr);
+    return new_ptr;
+}
+
+static void *s_secure_calloc(struct aws_allocator *allocator, size_t num, size_t size) {
+    size_t total = 0;
+    if (aws_mul_size_checked(num, size, &total)) {
+        return NULL;
+    }
+
+    return s_secure_acquire(allocator, total);
+}
+
+struct aws_allocator *aws_cal_secure_allocator_for(struct aws_allocator *parent) {
+    AWS_PRECONDITION(parent);
+
+    if (parent == aws_default_allocator()) {
+        return &s_default_pool.allocator;
+    }
+
+    aws_mutex_lock(&s_arena_lock);
+    struct secure_pool *pool = s_pools;
+    while (pool && pool->parent != parent) {
+        pool = pool->next;
+    }
+
+    if (!pool) {
+        /* not from parent, which may be gone by the time anyone else asks for its pool */
+        pool = aws_mem_calloc(aws_default_allocator(), 1, sizeof(struct secure_pool));
+        if (pool) {
+            pool->allocator.mem_acquire = s_secure_acquire;
+            pool->allocator.mem_release = s_secure_release;
+            pool->allocator.mem_realloc = s_secure_realloc;
+            pool->allocator.mem_calloc = s_secure_calloc;
+            pool->allocator.impl = pool;
+            pool->parent = parent;
+            pool->next = s_pools;
+            s_pools = pool;
+        }
+    }
+    aws_mutex_unlock(&s_arena_lock);
+
+    /* without a pool of its own, key material still gets locked pages, it just isn't charged to parent */
+    return pool ? &pool->allocator : &s_default_pool.allocator;
+}
+
+struct aws_allocator *aws_cal_secure_allocator(void) {
+    return aws_cal_secure_allocator_for(aws_default_allocator());
+}
+
+/* call with s_arena_lock held */
+static void s_remove_empty_chunks(struct secure_pool *pool) {
+    struct secure_chunk *chunk = pool->chunks;
+    while (chunk) {
+        struct secure_chunk *next = chunk->next;
+        if (chunk->live_slots == 0) {
+            s_remove_chunk(chunk);
+        }
+        chunk = next;
+    }
+}
+
+void aws_cal_secure_arena_clean_up(void) {
+    aws_mutex_lock(&s_arena_lock);
+    /* anything still out was leaked by its owner, keep the chunk and pool it's in rather than have it dangle */
+    s_remove_empty_chunks(&s_default_pool);
+
+    struct secure_pool **link = &s_pools;
+    while (*link) {
+        struct secure_pool *pool = *link;
+        s_remove_empty_chunks(pool);
+        if (pool->live_allocations == 0) {
+            AWS_ASSERT(pool->chunks == NULL);
+            *link = pool->next;
+            aws_mem_release(aws_default_allocator(), pool);
+        } else {
+            link = &pool->next;
+        }
+    }
+    aws_mutex_unlock(&s_arena_lock);
+}
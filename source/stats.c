@@ -0,0 +1,320 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/stats.h>
+
+#ifdef AWS_CAL_STATS
+
+#    include <aws/common/mutex.h>
+#    include <aws/common/thread.h>
+
+#    include <string.h>
+
+/*
+ * Every thread counts into its own block of slots, one slot per algorithm and provider pair it has used, so the hot
+ * path is a pointer compare and a few relaxed atomic adds that never contend. Only the owning thread fills in a
+ * slot's names, and it publishes them by bumping slot_count, which is all a snapshot reads slots up to.
+ *
+ * Blocks are never freed while the library is initialized: a thread that cleans up hands its block back, counts and
+ * all, for the next new thread to carry on counting into, so totals survive threads exiting. Library clean up frees
+ * every block and bumps the generation, which tells threads that their block is gone.
+ */
+
+struct stats_slot {
+    const char *alg_name;
+    const char *provider;
+    struct aws_atomic_var operations;
+    struct aws_atomic_var bytes;
+    struct aws_atomic_var allocations;
+    struct aws_atomic_var duration_ns;
+};
+
+struct stats_block {
+    struct stats_block *next;
+    struct stats_block *next_free;
+    struct aws_atomic_var slot_count;
+    struct stats_slot slots[AWS_CAL_STATS_MAX_ENTRIES];
+};
+
+/* Replaced callbacks are kept until clean up, since operations in flight may still be reading them. */
+struct stats_callback {
+    struct stats_callback *next;
+    aws_cal_stats_event_fn *on_event;
+    void *user_data;
+};
+
+struct aws_atomic_var g_aws_cal_stats_enabled = AWS_ATOMIC_INIT_INT(0);
+
+static struct aws_atomic_var s_callback = AWS_ATOMIC_INIT_PTR(NULL);
+
+static struct aws_mutex s_blocks_lock = AWS_MUTEX_INIT;
+static struct aws_allocator *s_allocator = NULL;
+static struct stats_block *s_blocks = NULL;
+static struct stats_block *s_free_blocks = NULL;
+static struct stats_callback *s_callbacks = NULL;
+static size_t s_generation = 1;
+
+static AWS_THREAD_LOCAL struct stats_block *tl_block = NULL;
+static AWS_THREAD_LOCAL size_t tl_generation = 0;
+
+void aws_cal_stats_init(struct aws_allocator *allocator) {
+    aws_mutex_lock(&s_blocks_lock);
+    /* counting enabled before init already allocated from the default allocator, and clean up frees through one */
+    if (!s_blocks && !s_callbacks) {
+        s_allocator = allocator;
+    }
+    aws_mutex_unlock(&s_blocks_lock);
+}
+
+void aws_cal_stats_clean_up(void) {
+    aws_atomic_store_int(&g_aws_cal_stats_enabled, 0);
+    aws_atomic_store_ptr(&s_callback, NULL);
+
+    aws_mutex_lock(&s_blocks_lock);
+    while (s_blocks) {
+        struct stats_block *block = s_blocks;
+        s_blocks = block->next;
+        aws_mem_release(s_allocator, block);
+    }
+    while (s_callbacks) {
+        struct stats_callback *callback = s_callbacks;
+        s_callbacks = callback->next;
+        aws_mem_release(s_allocator, callback);
+    }
+    s_free_blocks = NULL;
+    s_allocator = NULL;
+    ++s_generation;
+    aws_mutex_unlock(&s_blocks_lock);
+
+    tl_block = NULL;
+}
+
+void aws_cal_stats_thread_clean_up(void) {
+    if (!tl_block) {
+        return;
+    }
+
+    aws_mutex_lock(&s_blocks_lock);
+    if (tl_generation == s_generation) {
+        tl_block->next_free = s_free_blocks;
+        s_free_blocks = tl_block;
+    }
+    aws_mutex_unlock(&s_blocks_lock);
+
+    tl_block = NULL;
+}
+
+/* call with s_blocks_lock held. Counting can be enabled before the library is initialized. */
+static struct aws_allocator *s_get_allocator(void) {
+    if (!s_allocator) {
+        s_allocator = aws_default_allocator();
+    }
+    return s_allocator;
+}
+
+static struct stats_block *s_acquire_block(void) {
+    struct stats_block *block = NULL;
+
+    aws_mutex_lock(&s_blocks_lock);
+    if (s_free_blocks) {
+        block = s_free_blocks;
+        s_free_blocks = block->next_free;
+    } else {
+        block = aws_mem_calloc(s_get_allocator(), 1, sizeof(struct stats_block));
+        if (block) {
+            block->next = s_blocks;
+            s_blocks = block;
+        }
+    }
+    tl_generation = s_generation;
+    aws_mutex_unlock(&s_blocks_lock);
+
+    return block;
+}
+
+static struct stats_slot *s_find_slot(const char *alg_name, const char *provider) {
+    /* reading s_generation unlocked is fine, it only changes when the library is cleaned up, which no operation may
+     * race with. */
+    if (!tl_block || tl_generation != s_generation) {
+        tl_block = s_acquire_block();
+        if (!tl_block) {
+            return NULL;
+        }
+    }
+
+    struct stats_block *block = tl_block;
+    size_t slot_count = aws_atomic_load_int_explicit(&block->slot_count, aws_memory_order_relaxed);
+    for (size_t i = 0; i < slot_count; ++i) {
+        struct stats_slot *slot = &block->slots[i];
+        if (slot->alg_name == alg_name && slot->provider == provider) {
+            return slot;
+        }
+    }
+
+    if (slot_count == AWS_CAL_STATS_MAX_ENTRIES) {
+        return NULL;
+    }
+
+    struct stats_slot *slot = &block->slots[slot_count];
+    slot->alg_name = alg_name;
+    slot->provider = provider;
+    aws_atomic_store_int_explicit(&block->slot_count, slot_count + 1, aws_memory_order_release);
+    return slot;
+}
+
+void aws_cal_stats_record(
+    const struct aws_cal_stats_timer *timer,
+    const char *alg_name,
+    const char *provider,
+    enum aws_cal_stats_operation operation,
+    size_t bytes,
+    int result) {
+
+    uint64_t duration_ns = 0;
+    if (timer) {
+        uint64_t now_ns = 0;
+        aws_high_res_clock_get_ticks(&now_ns);
+        duration_ns = now_ns - timer->start_ns;
+    }
+
+    int error_code = result == AWS_OP_SUCCESS ? 0 : aws_last_error();
+
+    struct stats_slot *slot = s_find_slot(alg_name, provider);
+    if (slot) {
+        if (operation == AWS_CAL_STATS_OP_NEW) {
+            aws_atomic_fetch_add_explicit(&slot->allocations, 1, aws_memory_order_relaxed);
+        } else {
+            aws_atomic_fetch_add_explicit(&slot->operations, 1, aws_memory_order_relaxed);
+            aws_atomic_fetch_add_explicit(&slot->bytes, bytes, aws_memory_order_relaxed);
+            aws_atomic_fetch_add_explicit(&slot->duration_ns, (size_t)duration_ns, aws_memory_order_relaxed);
+        }
+    }
+
+    const struct stats_callback *callback = aws_atomic_load_ptr_explicit(&s_callback, aws_memory_order_acquire);
+    if (callback) {
+        struct aws_cal_stats_event event = {
+            .operation = operation,
+            .alg_name = alg_name,
+            .provider = provider,
+            .bytes = bytes,
+            .duration_ns = duration_ns,
+            .error_code = error_code,
+        };
+        callback->on_event(&event, callback->user_data);
+    }
+
+    /* the callback may have run into errors of its own, the caller still expects to see the operation's. */
+    if (error_code) {
+        aws_raise_error(error_code);
+    }
+}
+
+int aws_cal_stats_enable(const struct aws_cal_stats_options *options) {
+    struct stats_callback *callback = NULL;
+    if (options && options->on_event) {
+        aws_mutex_lock(&s_blocks_lock);
+        callback = aws_mem_calloc(s_get_allocator(), 1, sizeof(struct stats_callback));
+        if (callback) {
+            callback->on_event = options->on_event;
+            callback->user_data = options->user_data;
+            callback->next = s_callbacks;
+            s_callbacks = callback;
+        }
+        aws_mutex_unlock(&s_blocks_lock);
+
+        if (!callback) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    aws_atomic_store_ptr_explicit(&s_callback, callback, aws_memory_order_release);
+    aws_atomic_store_int(&g_aws_cal_stats_enabled, 1);
+    return AWS_OP_SUCCESS;
+}
+
+void aws_cal_stats_disable(void) {
+    aws_atomic_store_int(&g_aws_cal_stats_enabled, 0);
+    aws_atomic_store_ptr(&s_callback, NULL);
+}
+
+size_t aws_cal_stats_snapshot(struct aws_cal_stats_entry *entries, size_t capacity) {
+    size_t entry_count = 0;
+
+    aws_mutex_lock(&s_blocks_lock);
+    for (struct stats_block *block = s_blocks; block; block = block->next) {
+        size_t slot_count = aws_atomic_load_int_explicit(&block->slot_count, aws_memory_order_acquire);
+        for (size_t i = 0; i < slot_count; ++i) {
+            struct stats_slot *slot = &block->slots[i];
+
+            struct aws_cal_stats_entry *entry = NULL;
+            for (size_t j = 0; j < entry_count; ++j) {
+                if (strcmp(entries[j].alg_name, slot->alg_name) == 0 &&
+                    strcmp(entries[j].provider, slot->provider) == 0) {
+                    entry = &entries[j];
+                    break;
+                }
+            }
+
+            if (!entry) {
+                if (entry_count == capacity) {
+                    continue;
+                }
+                entry = &entries[entry_count++];
+                AWS_ZERO_STRUCT(*entry);
+                entry->alg_name = slot->alg_name;
+                entry->provider = slot->provider;
+            }
+
+            entry->operations += aws_atomic_load_int_explicit(&slot->operations, aws_memory_order_relaxed);
+            entry->bytes += aws_atomic_load_int_explicit(&slot->bytes, aws_memory_order_relaxed);
+            entry->allocations += aws_atomic_load_int_explicit(&slot->allocations, aws_memory_order_relaxed);
+            entry->duration_ns += aws_atomic_load_int_explicit(&slot->duration_ns, aws_memory_order_relaxed);
+        }
+    }
+    aws_mutex_unlock(&s_blocks_lock);
+
+    return entry_count;
+}
+
+void aws_cal_stats_reset(void) {
+    aws_mutex_lock(&s_blocks_lock);
+    for (struct stats_block *block = s_blocks; block; block = block->next) {
+        size_t slot_count = aws_atomic_load_int_explicit(&block->slot_count, aws_memory_order_acquire);
+        for (size_t i = 0; i < slot_count; ++i) {
+            struct stats_slot *slot = &block->slots[i];
+            aws_atomic_store_int_explicit(&slot->operations, 0, aws_memory_order_relaxed);
+            aws_atomic_store_int_explicit(&slot->bytes, 0, aws_memory_order_relaxed);
+            aws_atomic_store_int_explicit(&slot->allocations, 0, aws_memory_order_relaxed);
+            aws_atomic_store_int_explicit(&slot->duration_ns, 0, aws_memory_order_relaxed);
+        }
+    }
+    aws_mutex_unlock(&s_blocks_lock);
+}
+
+#else
+
+void aws_cal_stats_init(struct aws_allocator *allocator) {
+    (void)allocator;
+}
+
+void aws_cal_stats_clean_up(void) {}
+
+void aws_cal_stats_thread_clean_up(void) {}
+
+int aws_cal_stats_enable(const struct aws_cal_stats_options *options) {
+    (void)options;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+void aws_cal_stats_disable(void) {}
+
+size_t aws_cal_stats_snapshot(struct aws_cal_stats_entry *entries, size_t capacity) {
+    (void)entries;
+    (void)capacity;
+    return 0;
+}
+
+void aws_cal_stats_reset(void) {}
+
+#endif /* AWS_CAL_STATS */
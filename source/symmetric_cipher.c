@@ -2,6 +2,9 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/cal/private/cpu_features.h>
+#include <aws/cal/private/file_window.h>
+#include <aws/cal/private/stats.h>
 #include <aws/cal/private/symmetric_cipher_priv.h>
 #include <aws/cal/symmetric_cipher.h>
 #include <aws/common/device_random.h>
@@ -29,6 +32,50 @@ extern struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key);
 
+extern struct aws_symmetric_cipher *aws_aes_xts_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak);
+
+extern struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+extern struct aws_symmetric_cipher *aws_chacha20_poly1305_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag);
+
+extern int aws_aes_256_gcm_seal_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out);
+
+extern int aws_aes_256_gcm_open_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out);
+
+extern int aws_aes_256_keywrap_batch_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap);
+
 #else /* BYO_CRYPTO */
 struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
     struct aws_allocator *allocator,
@@ -72,12 +119,154 @@ struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
     abort();
 }
 
+struct aws_symmetric_cipher *aws_aes_xts_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak) {
+    (void)allocator;
+    (void)key;
+    (void)tweak;
+    abort();
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    abort();
+}
+
+struct aws_symmetric_cipher *aws_chacha20_poly1305_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    abort();
+}
+
+int aws_aes_256_gcm_seal_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+    (void)allocator;
+    (void)key;
+    (void)nonce;
+    (void)aad;
+    (void)plaintext;
+    (void)out;
+    abort();
+}
+
+int aws_aes_256_gcm_open_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out) {
+    (void)allocator;
+    (void)key;
+    (void)nonce;
+    (void)aad;
+    (void)ciphertext;
+    (void)tag;
+    (void)out;
+    abort();
+}
+
+int aws_aes_256_keywrap_batch_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap) {
+    (void)allocator;
+    (void)prepared_key;
+    (void)inputs;
+    (void)outputs;
+    (void)count;
+    (void)wrap;
+    abort();
+}
+
+int aws_aes_256_prepared_key_init_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    (void)prepared_key;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_aes_256_prepared_key_clean_up_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    (void)prepared_key;
+}
+
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    (void)allocator;
+    (void)prepared_key;
+    (void)iv;
+    abort();
+}
+
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    (void)allocator;
+    (void)prepared_key;
+    (void)iv;
+    abort();
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)prepared_key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    abort();
+}
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    (void)allocator;
+    (void)prepared_key;
+    abort();
+}
+
 #endif /* BYO_CRYPTO */
 
 static aws_aes_cbc_256_new_fn *s_aes_cbc_new_fn = aws_aes_cbc_256_new_impl;
 static aws_aes_ctr_256_new_fn *s_aes_ctr_new_fn = aws_aes_ctr_256_new_impl;
 static aws_aes_gcm_256_new_fn *s_aes_gcm_new_fn = aws_aes_gcm_256_new_impl;
 static aws_aes_keywrap_256_new_fn *s_aes_keywrap_new_fn = aws_aes_keywrap_256_new_impl;
+static aws_aes_xts_256_new_fn *s_aes_xts_new_fn = aws_aes_xts_256_new_impl;
+static aws_aes_gcm_siv_256_new_fn *s_aes_gcm_siv_new_fn = aws_aes_gcm_siv_256_new_impl;
+static aws_chacha20_poly1305_new_fn *s_chacha20_poly1305_new_fn = aws_chacha20_poly1305_new_impl;
 
 static int s_check_input_size_limits(const struct aws_symmetric_cipher *cipher, const struct aws_byte_cursor *input) {
     /* libcrypto uses int, not size_t, so this is the limit.
@@ -102,6 +291,11 @@ static int s_validate_key_materials(
     return AWS_OP_SUCCESS;
 }
 
+static struct aws_symmetric_cipher *s_cipher_created(struct aws_symmetric_cipher *cipher) {
+    AWS_CAL_STATS_NEW(cipher);
+    return cipher;
+}
+
 struct aws_symmetric_cipher *aws_aes_cbc_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
@@ -110,7 +304,7 @@ struct aws_symmetric_cipher *aws_aes_cbc_256_new(
     if (s_validate_key_materials(key, AWS_AES_256_KEY_BYTE_LEN, iv, AWS_AES_256_CIPHER_BLOCK_SIZE) != AWS_OP_SUCCESS) {
         return NULL;
     }
-    return s_aes_cbc_new_fn(allocator, key, iv);
+    return s_cipher_created(s_aes_cbc_new_fn(allocator, key, iv));
 }
 
 struct aws_symmetric_cipher *aws_aes_ctr_256_new(
@@ -120,7 +314,7 @@ struct aws_symmetric_cipher *aws_aes_ctr_256_new(
     if (s_validate_key_materials(key, AWS_AES_256_KEY_BYTE_LEN, iv, AWS_AES_256_CIPHER_BLOCK_SIZE) != AWS_OP_SUCCESS) {
         return NULL;
     }
-    return s_aes_ctr_new_fn(allocator, key, iv);
+    return s_cipher_created(s_aes_ctr_new_fn(allocator, key, iv));
 }
 
 struct aws_symmetric_cipher *aws_aes_gcm_256_new(
@@ -133,7 +327,7 @@ struct aws_symmetric_cipher *aws_aes_gcm_256_new(
         AWS_OP_SUCCESS) {
         return NULL;
     }
-    return s_aes_gcm_new_fn(allocator, key, iv, aad, decryption_tag);
+    return s_cipher_created(s_aes_gcm_new_fn(allocator, key, iv, aad, decryption_tag));
 }
 
 struct aws_symmetric_cipher *aws_aes_keywrap_256_new(
@@ -142,7 +336,195 @@ struct aws_symmetric_cipher *aws_aes_keywrap_256_new(
     if (s_validate_key_materials(key, AWS_AES_256_KEY_BYTE_LEN, NULL, 0) != AWS_OP_SUCCESS) {
         return NULL;
     }
-    return s_aes_keywrap_new_fn(allocator, key);
+    return s_cipher_created(s_aes_keywrap_new_fn(allocator, key));
+}
+
+struct aws_symmetric_cipher *aws_aes_xts_256_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak) {
+    if (s_validate_key_materials(key, AWS_AES_256_XTS_KEY_BYTE_LEN, tweak, AWS_AES_256_CIPHER_BLOCK_SIZE) !=
+        AWS_OP_SUCCESS) {
+        return NULL;
+    }
+
+    /* identical halves turn XTS into plain XEX with a known tweak key, libcrypto refuses them too. */
+    if (key) {
+        uint8_t difference = 0;
+        for (size_t i = 0; i < AWS_AES_256_KEY_BYTE_LEN; ++i) {
+            difference |= key->ptr[i] ^ key->ptr[AWS_AES_256_KEY_BYTE_LEN + i];
+        }
+
+        if (difference == 0) {
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+    }
+
+    return s_cipher_created(s_aes_xts_new_fn(allocator, key, tweak));
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    if (s_validate_key_materials(key, AWS_AES_256_KEY_BYTE_LEN, iv, AWS_AES_256_GCM_NONCE_LEN) != AWS_OP_SUCCESS) {
+        return NULL;
+    }
+
+    if (decryption_tag && decryption_tag->len != AWS_AES_256_GCM_TAG_LEN) {
+        aws_raise_error(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM);
+        return NULL;
+    }
+
+    return s_cipher_created(s_aes_gcm_siv_new_fn(allocator, key, iv, aad, decryption_tag));
+}
+
+struct aws_symmetric_cipher *aws_chacha20_poly1305_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    if (s_validate_key_materials(key, AWS_CHACHA20_POLY1305_KEY_BYTE_LEN, iv, AWS_CHACHA20_POLY1305_NONCE_LEN) !=
+        AWS_OP_SUCCESS) {
+        return NULL;
+    }
+
+    if (decryption_tag && decryption_tag->len != AWS_CHACHA20_POLY1305_TAG_LEN) {
+        aws_raise_error(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM);
+        return NULL;
+    }
+
+    return s_cipher_created(s_chacha20_poly1305_new_fn(allocator, key, iv, aad, decryption_tag));
+}
+
+bool aws_symmetric_cipher_has_hardware_aes(void) {
+    const struct aws_cal_cpu_features *features = aws_cal_get_cpu_features();
+    return (features->aes_ni && features->pclmulqdq) || features->armv8_aes;
+}
+
+void aws_set_aes_cbc_256_new_fn(aws_aes_cbc_256_new_fn *fn) {
+    s_aes_cbc_new_fn = fn;
+}
+
+void aws_set_aes_ctr_256_new_fn(aws_aes_ctr_256_new_fn *fn) {
+    s_aes_ctr_new_fn = fn;
+}
+
+void aws_set_aes_gcm_256_new_fn(aws_aes_gcm_256_new_fn *fn) {
+    s_aes_gcm_new_fn = fn;
+}
+
+void aws_set_aes_keywrap_256_new_fn(aws_aes_keywrap_256_new_fn *fn) {
+    s_aes_keywrap_new_fn = fn;
+}
+
+void aws_set_aes_xts_256_new_fn(aws_aes_xts_256_new_fn *fn) {
+    s_aes_xts_new_fn = fn;
+}
+
+void aws_set_aes_gcm_siv_256_new_fn(aws_aes_gcm_siv_256_new_fn *fn) {
+    s_aes_gcm_siv_new_fn = fn;
+}
+
+void aws_set_chacha20_poly1305_new_fn(aws_chacha20_poly1305_new_fn *fn) {
+    s_chacha20_poly1305_new_fn = fn;
+}
+
+struct aws_aes_256_prepared_key *aws_aes_256_prepared_key_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
+    if (key == NULL) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    if (s_validate_key_materials(key, AWS_AES_256_KEY_BYTE_LEN, NULL, 0) != AWS_OP_SUCCESS) {
+        return NULL;
+    }
+
+    struct aws_aes_256_prepared_key *prepared_key =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_aes_256_prepared_key));
+    prepared_key->allocator = allocator;
+    aws_atomic_init_int(&prepared_key->ref_count, 1);
+    aws_byte_buf_init_copy_from_cursor(&prepared_key->key, secure_allocator, *key);
+
+    if (aws_aes_256_prepared_key_init_impl(prepared_key)) {
+        aws_byte_buf_clean_up_secure(&prepared_key->key);
+        aws_mem_release(allocator, prepared_key);
+        return NULL;
+    }
+
+    return prepared_key;
+}
+
+void aws_aes_256_prepared_key_acquire(struct aws_aes_256_prepared_key *prepared_key) {
+    aws_atomic_fetch_add(&prepared_key->ref_count, 1);
+}
+
+void aws_aes_256_prepared_key_release(struct aws_aes_256_prepared_key *prepared_key) {
+    if (prepared_key == NULL) {
+        return;
+    }
+
+    size_t old_value = aws_atomic_fetch_sub(&prepared_key->ref_count, 1);
+
+    if (old_value == 1) {
+        aws_aes_256_prepared_key_clean_up_impl(prepared_key);
+        aws_byte_buf_clean_up_secure(&prepared_key->key);
+        aws_mem_release(prepared_key->allocator, prepared_key);
+    }
+}
+
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    AWS_PRECONDITION(prepared_key);
+
+    if (s_validate_key_materials(NULL, 0, iv, AWS_AES_256_CIPHER_BLOCK_SIZE) != AWS_OP_SUCCESS) {
+        return NULL;
+    }
+    return s_cipher_created(aws_aes_cbc_256_new_from_prepared_key_impl(allocator, prepared_key, iv));
+}
+
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    AWS_PRECONDITION(prepared_key);
+
+    if (s_validate_key_materials(NULL, 0, iv, AWS_AES_256_CIPHER_BLOCK_SIZE) != AWS_OP_SUCCESS) {
+        return NULL;
+    }
+    return s_cipher_created(aws_aes_ctr_256_new_from_prepared_key_impl(allocator, prepared_key, iv));
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    AWS_PRECONDITION(prepared_key);
+
+    if (s_validate_key_materials(NULL, 0, iv, AWS_AES_256_CIPHER_BLOCK_SIZE - sizeof(uint32_t)) != AWS_OP_SUCCESS) {
+        return NULL;
+    }
+    return s_cipher_created(
+        aws_aes_gcm_256_new_from_prepared_key_impl(allocator, prepared_key, iv, aad, decryption_tag));
+}
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    AWS_PRECONDITION(prepared_key);
+
+    return s_cipher_created(aws_aes_keywrap_256_new_from_prepared_key_impl(allocator, prepared_key));
 }
 
 void aws_symmetric_cipher_destroy(struct aws_symmetric_cipher *cipher) {
@@ -161,7 +543,10 @@ int aws_symmetric_cipher_encrypt(
     }
 
     if (cipher->good) {
-        return cipher->vtable->encrypt(cipher, to_encrypt, out);
+        AWS_CAL_STATS_BEGIN(stats);
+        int result = cipher->vtable->encrypt(cipher, to_encrypt, out);
+        AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_ENCRYPT, to_encrypt.len, result);
+        return result;
     }
 
     return aws_raise_error(AWS_ERROR_INVALID_STATE);
@@ -177,15 +562,149 @@ int aws_symmetric_cipher_decrypt(
     }
 
     if (cipher->good) {
-        return cipher->vtable->decrypt(cipher, to_decrypt, out);
+        AWS_CAL_STATS_BEGIN(stats);
+        int result = cipher->vtable->decrypt(cipher, to_decrypt, out);
+        AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_DECRYPT, to_decrypt.len, result);
+        return result;
     }
 
     return aws_raise_error(AWS_ERROR_INVALID_STATE);
 }
 
+struct cipher_file_job {
+    struct aws_symmetric_cipher *cipher;
+    struct aws_byte_buf *out;
+};
+
+static int s_encrypt_file_window(struct aws_byte_cursor window, void *user_data) {
+    struct cipher_file_job *job = user_data;
+    return aws_symmetric_cipher_encrypt(job->cipher, window, job->out);
+}
+
+static int s_decrypt_file_window(struct aws_byte_cursor window, void *user_data) {
+    struct cipher_file_job *job = user_data;
+    return aws_symmetric_cipher_decrypt(job->cipher, window, job->out);
+}
+
+int aws_symmetric_cipher_encrypt_file(
+    struct aws_symmetric_cipher *cipher,
+    const char *path,
+    struct aws_byte_buf *out) {
+
+    struct cipher_file_job job = {.cipher = cipher, .out = out};
+    return aws_cal_file_for_each_window(cipher->allocator, path, s_encrypt_file_window, &job);
+}
+
+int aws_symmetric_cipher_decrypt_file(
+    struct aws_symmetric_cipher *cipher,
+    const char *path,
+    struct aws_byte_buf *out) {
+
+    struct cipher_file_job job = {.cipher = cipher, .out = out};
+    return aws_cal_file_for_each_window(cipher->allocator, path, s_decrypt_file_window, &job);
+}
+
+static int s_check_segments(
+    const struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count) {
+    AWS_PRECONDITION(segment_count == 0 || segments != NULL);
+
+    for (size_t i = 0; i < segment_count; ++i) {
+        if (AWS_UNLIKELY(s_check_input_size_limits(cipher, &segments[i]) != AWS_OP_SUCCESS)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* like the single buffer calls, a vectored call is counted as one operation over all of its bytes */
+static int s_encrypt_segments(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+
+    if (cipher->vtable->encrypt_vectored) {
+        return cipher->vtable->encrypt_vectored(cipher, segments, segment_count, out);
+    }
+
+    for (size_t i = 0; i < segment_count; ++i) {
+        if (cipher->vtable->encrypt(cipher, segments[i], out)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_symmetric_cipher_encrypt_vectored(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+
+    if (s_check_segments(cipher, segments, segment_count)) {
+        return AWS_OP_ERR;
+    }
+
+    if (!cipher->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_encrypt_segments(cipher, segments, segment_count, out);
+    AWS_CAL_STATS_END(
+        stats, cipher->vtable, AWS_CAL_STATS_OP_ENCRYPT, aws_cal_stats_segments_len(segments, segment_count), result);
+    return result;
+}
+
+static int s_decrypt_segments(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+
+    if (cipher->vtable->decrypt_vectored) {
+        return cipher->vtable->decrypt_vectored(cipher, segments, segment_count, out);
+    }
+
+    for (size_t i = 0; i < segment_count; ++i) {
+        if (cipher->vtable->decrypt(cipher, segments[i], out)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_symmetric_cipher_decrypt_vectored(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+
+    if (s_check_segments(cipher, segments, segment_count)) {
+        return AWS_OP_ERR;
+    }
+
+    if (!cipher->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_decrypt_segments(cipher, segments, segment_count, out);
+    AWS_CAL_STATS_END(
+        stats, cipher->vtable, AWS_CAL_STATS_OP_DECRYPT, aws_cal_stats_segments_len(segments, segment_count), result);
+    return result;
+}
+
 int aws_symmetric_cipher_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
     if (cipher->good) {
+        AWS_CAL_STATS_BEGIN(stats);
         int ret_val = cipher->vtable->finalize_encryption(cipher, out);
+        AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_FINALIZE, 0, ret_val);
         cipher->good = false;
         return ret_val;
     }
@@ -195,13 +714,409 @@ int aws_symmetric_cipher_finalize_encryption(struct aws_symmetric_cipher *cipher
 
 int aws_symmetric_cipher_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
     if (cipher->good) {
+        AWS_CAL_STATS_BEGIN(stats);
         int ret_val = cipher->vtable->finalize_decryption(cipher, out);
+        AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_FINALIZE, 0, ret_val);
         cipher->good = false;
         return ret_val;
     }
     return aws_raise_error(AWS_ERROR_INVALID_STATE);
 }
 
+typedef int(s_cipher_update_fn)(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out);
+typedef int(s_cipher_finalize_fn)(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out);
+
+/* wraps the unused capacity of out in a buffer without an allocator, so the backends can never grow it. */
+static struct aws_byte_buf s_fixed_span_from_buf(const struct aws_byte_buf *out) {
+    return aws_byte_buf_from_empty_array(out->buffer + out->len, out->capacity - out->len);
+}
+
+static int s_cipher_update_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    s_cipher_update_fn *update_fn) {
+
+    if (AWS_UNLIKELY(s_check_input_size_limits(cipher, &input) != AWS_OP_SUCCESS)) {
+        return AWS_OP_ERR;
+    }
+
+    if (!cipher->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_byte_buf span = s_fixed_span_from_buf(out);
+
+    /* exactly in place is fine, the libcryptos all handle it. Anything else overlapping would have us read back our
+     * own output. */
+    if (input.len && input.ptr != span.buffer && input.ptr < span.buffer + span.capacity &&
+        span.buffer < input.ptr + input.len) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (update_fn(cipher, input, &span)) {
+        return AWS_OP_ERR;
+    }
+
+    out->len += span.len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_cipher_finalize_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_buf *out,
+    s_cipher_finalize_fn *finalize_fn) {
+
+    if (!cipher->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_byte_buf span = s_fixed_span_from_buf(out);
+    int ret_val = finalize_fn(cipher, &span);
+    cipher->good = false;
+
+    if (ret_val == AWS_OP_SUCCESS) {
+        out->len += span.len;
+    }
+
+    return ret_val;
+}
+
+int aws_symmetric_cipher_encrypt_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor to_encrypt,
+    struct aws_byte_buf *out) {
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_cipher_update_into(cipher, to_encrypt, out, cipher->vtable->encrypt);
+    AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_ENCRYPT, to_encrypt.len, result);
+    return result;
+}
+
+int aws_symmetric_cipher_decrypt_into(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor to_decrypt,
+    struct aws_byte_buf *out) {
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_cipher_update_into(cipher, to_decrypt, out, cipher->vtable->decrypt);
+    AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_DECRYPT, to_decrypt.len, result);
+    return result;
+}
+
+int aws_symmetric_cipher_finalize_encryption_into(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_cipher_finalize_into(cipher, out, cipher->vtable->finalize_encryption);
+    AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_FINALIZE, 0, result);
+    return result;
+}
+
+int aws_symmetric_cipher_finalize_decryption_into(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    AWS_CAL_STATS_BEGIN(stats);
+    int result = s_cipher_finalize_into(cipher, out, cipher->vtable->finalize_decryption);
+    AWS_CAL_STATS_END(stats, cipher->vtable, AWS_CAL_STATS_OP_FINALIZE, 0, result);
+    return result;
+}
+
+static int s_check_gcm_oneshot_args(
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor input,
+    size_t output_len,
+    const struct aws_byte_buf *out) {
+
+    if (key == NULL || nonce == NULL) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (s_validate_key_materials(key, AWS_AES_256_KEY_BYTE_LEN, nonce, AWS_AES_256_GCM_NONCE_LEN)) {
+        return AWS_OP_ERR;
+    }
+
+    /* same int limit as s_check_input_size_limits(), on each of the inputs */
+    if (input.len > INT_MAX - AWS_AES_256_CIPHER_BLOCK_SIZE || (aad && aad->len > INT_MAX)) {
+        return aws_raise_error(AWS_ERROR_CAL_BUFFER_TOO_LARGE_FOR_ALGORITHM);
+    }
+
+    if (out->capacity - out->len < output_len) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    const uint8_t *span_start = out->buffer + out->len;
+    if (input.len && input.ptr != span_start && input.ptr < span_start + output_len &&
+        span_start < input.ptr + input.len) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_gcm_seal(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+
+    size_t output_len = plaintext.len + AWS_AES_256_GCM_TAG_LEN;
+    if (s_check_gcm_oneshot_args(key, nonce, aad, plaintext, output_len, out)) {
+        return AWS_OP_ERR;
+    }
+
+    /* an override has to see every GCM operation, so only take the backend's shortcut when there isn't one. */
+    aws_aes_256_gcm_seal_fn *seal_fn =
+        s_aes_gcm_new_fn == aws_aes_gcm_256_new_impl ? aws_aes_256_gcm_seal_impl : aws_aes_256_gcm_seal_with_cipher;
+
+    struct aws_byte_buf span = aws_byte_buf_from_empty_array(out->buffer + out->len, output_len);
+    if (seal_fn(allocator, key, nonce, aad && aad->len ? aad : NULL, plaintext, &span)) {
+        return AWS_OP_ERR;
+    }
+
+    AWS_ASSERT(span.len == output_len);
+    out->len += span.len;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_gcm_open(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext_and_tag,
+    struct aws_byte_buf *out) {
+
+    if (ciphertext_and_tag.len < AWS_AES_256_GCM_TAG_LEN) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    struct aws_byte_cursor ciphertext =
+        aws_byte_cursor_advance(&ciphertext_and_tag, ciphertext_and_tag.len - AWS_AES_256_GCM_TAG_LEN);
+    struct aws_byte_cursor tag = ciphertext_and_tag;
+
+    if (s_check_gcm_oneshot_args(key, nonce, aad, ciphertext, ciphertext.len, out)) {
+        return AWS_OP_ERR;
+    }
+
+    aws_aes_256_gcm_open_fn *open_fn =
+        s_aes_gcm_new_fn == aws_aes_gcm_256_new_impl ? aws_aes_256_gcm_open_impl : aws_aes_256_gcm_open_with_cipher;
+
+    struct aws_byte_buf span = aws_byte_buf_from_empty_array(out->buffer + out->len, ciphertext.len);
+    if (open_fn(allocator, key, nonce, aad && aad->len ? aad : NULL, ciphertext, tag, &span)) {
+        /* the backends may have already written unauthenticated plaintext. */
+        aws_secure_zero(span.buffer, span.capacity);
+        return AWS_OP_ERR;
+    }
+
+    AWS_ASSERT(span.len == ciphertext.len);
+    out->len += span.len;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_gcm_seal_with_cipher(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+
+    struct aws_symmetric_cipher *cipher = s_aes_gcm_new_fn(allocator, key, nonce, aad, NULL);
+    if (cipher == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    int ret_val = AWS_OP_ERR;
+
+    if (aws_symmetric_cipher_encrypt_into(cipher, plaintext, out) ||
+        aws_symmetric_cipher_finalize_encryption_into(cipher, out)) {
+        goto clean_up;
+    }
+
+    struct aws_byte_cursor tag = aws_symmetric_cipher_get_tag(cipher);
+    if (tag.len != AWS_AES_256_GCM_TAG_LEN || !aws_byte_buf_write_from_whole_cursor(out, tag)) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        goto clean_up;
+    }
+
+    ret_val = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_symmetric_cipher_destroy(cipher);
+    return ret_val;
+}
+
+int aws_aes_256_gcm_open_with_cipher(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out) {
+
+    struct aws_symmetric_cipher *cipher = s_aes_gcm_new_fn(allocator, key, nonce, aad, &tag);
+    if (cipher == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    int ret_val = AWS_OP_ERR;
+
+    if (aws_symmetric_cipher_decrypt_into(cipher, ciphertext, out)) {
+        goto clean_up;
+    }
+
+    /* the backends don't agree on what a tag mismatch raises, so report it the same way everywhere. */
+    if (aws_symmetric_cipher_finalize_decryption_into(cipher, out)) {
+        aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+        goto clean_up;
+    }
+
+    ret_val = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_symmetric_cipher_destroy(cipher);
+    return ret_val;
+}
+
+/* RFC 3394 adds one 8 byte integrity block, and needs at least two blocks of key. */
+#define KEYWRAP_BLOCK_SIZE 8u
+#define KEYWRAP_MIN_KEY_LEN 16u
+
+static size_t s_keywrap_output_len(size_t input_len, bool wrap) {
+    return wrap ? input_len + KEYWRAP_BLOCK_SIZE : input_len - KEYWRAP_BLOCK_SIZE;
+}
+
+static int s_keywrap_batch(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap) {
+    AWS_PRECONDITION(prepared_key);
+    AWS_PRECONDITION(count == 0 || (inputs != NULL && outputs != NULL));
+
+    size_t min_len = wrap ? KEYWRAP_MIN_KEY_LEN : KEYWRAP_MIN_KEY_LEN + KEYWRAP_BLOCK_SIZE;
+    for (size_t i = 0; i < count; ++i) {
+        size_t len = inputs[i].len;
+        if (len < min_len || len % KEYWRAP_BLOCK_SIZE) {
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        }
+
+        if (len > INT_MAX - KEYWRAP_BLOCK_SIZE) {
+            return aws_raise_error(AWS_ERROR_CAL_BUFFER_TOO_LARGE_FOR_ALGORITHM);
+        }
+
+        if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(&outputs[i], s_keywrap_output_len(len, wrap))) {
+            return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+        }
+    }
+
+    if (count == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* same as the one-shot GCM paths, an override has to see every keywrap operation. */
+    aws_aes_256_keywrap_batch_fn *batch_fn = s_aes_keywrap_new_fn == aws_aes_keywrap_256_new_impl
+                                                 ? aws_aes_256_keywrap_batch_impl
+                                                 : aws_aes_256_keywrap_batch_with_cipher;
+
+    if (batch_fn(allocator, prepared_key, inputs, outputs, count, wrap)) {
+        /* partial results, including unverified key material, may have been written. */
+        for (size_t i = 0; i < count; ++i) {
+            aws_secure_zero(outputs[i].buffer + outputs[i].len, s_keywrap_output_len(inputs[i].len, wrap));
+        }
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_wrap_keys(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *keys,
+    struct aws_byte_buf *outputs,
+    size_t key_count) {
+    return s_keywrap_batch(allocator, prepared_key, keys, outputs, key_count, true);
+}
+
+int aws_aes_256_unwrap_keys(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *wrapped_keys,
+    struct aws_byte_buf *outputs,
+    size_t key_count) {
+    return s_keywrap_batch(allocator, prepared_key, wrapped_keys, outputs, key_count, false);
+}
+
+int aws_aes_256_keywrap_batch_with_cipher(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap) {
+
+    struct aws_symmetric_cipher *cipher = NULL;
+    if (s_aes_keywrap_new_fn == aws_aes_keywrap_256_new_impl) {
+        cipher = aws_aes_keywrap_256_new_from_prepared_key_impl(allocator, prepared_key);
+    } else {
+        struct aws_byte_cursor key = aws_byte_cursor_from_buf(&prepared_key->key);
+        cipher = s_aes_keywrap_new_fn(allocator, &key);
+    }
+
+    if (cipher == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    int ret_val = AWS_OP_ERR;
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t output_len = s_keywrap_output_len(inputs[i].len, wrap);
+        struct aws_byte_buf span = aws_byte_buf_from_empty_array(outputs[i].buffer + outputs[i].len, output_len);
+
+        if (i > 0 && aws_symmetric_cipher_reset(cipher)) {
+            goto clean_up;
+        }
+
+        if (wrap) {
+            if (aws_symmetric_cipher_encrypt_into(cipher, inputs[i], &span) ||
+                aws_symmetric_cipher_finalize_encryption_into(cipher, &span)) {
+                goto clean_up;
+            }
+        } else {
+            if (aws_symmetric_cipher_decrypt_into(cipher, inputs[i], &span)) {
+                goto clean_up;
+            }
+
+            /* the backends don't agree on what a failed integrity check raises, so report it the same way. */
+            if (aws_symmetric_cipher_finalize_decryption_into(cipher, &span)) {
+                aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+                goto clean_up;
+            }
+        }
+
+        if (span.len != span.capacity) {
+            aws_raise_error(AWS_ERROR_INVALID_STATE);
+            goto clean_up;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        outputs[i].len += s_keywrap_output_len(inputs[i].len, wrap);
+    }
+
+    ret_val = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_symmetric_cipher_destroy(cipher);
+    return ret_val;
+}
+
 int aws_symmetric_cipher_reset(struct aws_symmetric_cipher *cipher) {
     int ret_val = cipher->vtable->reset(cipher);
     if (ret_val == AWS_OP_SUCCESS) {
@@ -211,6 +1126,42 @@ int aws_symmetric_cipher_reset(struct aws_symmetric_cipher *cipher) {
     return ret_val;
 }
 
+int aws_symmetric_cipher_seek(struct aws_symmetric_cipher *cipher, uint64_t offset) {
+    if (cipher->vtable->seek == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    if (cipher->iv.len != AWS_AES_256_CIPHER_BLOCK_SIZE) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    uint8_t counter_block[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    memcpy(counter_block, cipher->iv.buffer, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    aws_aes_ctr_counter_block_add(counter_block, offset / AWS_AES_256_CIPHER_BLOCK_SIZE);
+
+    int ret_val = cipher->vtable->seek(cipher, counter_block, (size_t)(offset % AWS_AES_256_CIPHER_BLOCK_SIZE));
+    cipher->good = ret_val == AWS_OP_SUCCESS;
+    return ret_val;
+}
+
+int aws_symmetric_cipher_reset_with_tweak(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor tweak) {
+    if (cipher->vtable->reset_with_tweak == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    if (tweak.len != AWS_AES_256_CIPHER_BLOCK_SIZE) {
+        return aws_raise_error(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM);
+    }
+
+    if (cipher->iv.len != AWS_AES_256_CIPHER_BLOCK_SIZE) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    int ret_val = cipher->vtable->reset_with_tweak(cipher, tweak.ptr);
+    cipher->good = ret_val == AWS_OP_SUCCESS;
+    return ret_val;
+}
+
 struct aws_byte_cursor aws_symmetric_cipher_get_tag(const struct aws_symmetric_cipher *cipher) {
     return aws_byte_cursor_from_buf(&cipher->tag);
 }
@@ -247,8 +1198,23 @@ void aws_symmetric_cipher_generate_key(size_t key_len_bytes, struct aws_byte_buf
     AWS_FATAL_ASSERT(aws_device_random_buffer_append(out, key_len_bytes) == AWS_OP_SUCCESS);
 }
 
+void aws_aes_ctr_counter_block_add(uint8_t counter_block[AWS_AES_256_CIPHER_BLOCK_SIZE], uint64_t blocks) {
+    uint64_t low = aws_read_u64(counter_block + 8);
+    uint64_t sum = low + blocks;
+    aws_write_u64(sum, counter_block + 8);
+
+    /* carry into the upper half */
+    if (sum < low) {
+        aws_write_u64(aws_read_u64(counter_block) + 1, counter_block);
+    }
+}
+
 int aws_symmetric_cipher_try_ensure_sufficient_buffer_space(struct aws_byte_buf *buf, size_t size) {
     if (buf->capacity - buf->len < size) {
+        if (buf->allocator == NULL) {
+            return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+        }
+
         return aws_byte_buf_reserve_relative(buf, size);
     }
 
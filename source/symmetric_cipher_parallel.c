@@ -0,0 +1,509 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/ghash.h>
+#include <aws/cal/private/symmetric_cipher_priv.h>
+#include <aws/cal/symmetric_cipher.h>
+
+/*
+ * Parallel CTR and GCM on top of the regular ciphers. CTR is split into pieces that each get a CTR cipher started at
+ * the piece's counter offset. GCM adds GHASH, which is a polynomial in H = E(K, 0^128) over the ciphertext blocks:
+ *
+ *     Y = X_1 * H^n ^ X_2 * H^(n-1) ^ ... ^ X_n * H
+ *
+ * so a piece's partial value only has to be multiplied by H to the number of blocks that follow it. The backends
+ * don't expose GHASH, and their tags can't stand in for it (CNG won't produce one over aad alone), so each piece's
+ * partial value comes from the builtin GHASH in source/builtin/ghash.c. Only E(K, 0^128) and E(K, J0) are taken from
+ * the backend.
+ */
+
+#define S_DEFAULT_TASK_LEN (1024 * 1024)
+#define S_DEFAULT_MIN_PARALLEL_LEN (4 * 1024 * 1024)
+/* each piece goes through a single cipher call, which is limited to an int. */
+#define S_MAX_TASK_LEN ((size_t)(INT_MAX / 2) & ~(size_t)(AWS_AES_256_CIPHER_BLOCK_SIZE - 1))
+
+/* the GCM counter for a 96 bit nonce starts at 1, which is used for the tag, and may not wrap. */
+#define S_GCM_FIRST_DATA_COUNTER 2
+#define S_GCM_MAX_DATA_BLOCKS ((uint64_t)UINT32_MAX - 1)
+
+#define S_COUNTER_OFFSET (AWS_AES_256_CIPHER_BLOCK_SIZE - sizeof(uint32_t))
+
+/* An element of GF(2^128) in GCM's bit order: bit 0 is the most significant bit of hi. */
+struct gf128 {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+static struct gf128 s_gf128_load(const uint8_t block[AWS_AES_256_CIPHER_BLOCK_SIZE]) {
+    struct gf128 x = {.hi = aws_read_u64(block), .lo = aws_read_u64(block + 8)};
+    return x;
+}
+
+static void s_gf128_store(struct gf128 x, uint8_t block[AWS_AES_256_CIPHER_BLOCK_SIZE]) {
+    aws_write_u64(x.hi, block);
+    aws_write_u64(x.lo, block + 8);
+}
+
+static struct gf128 s_gf128_xor(struct gf128 x, struct gf128 y) {
+    struct gf128 z = {.hi = x.hi ^ y.hi, .lo = x.lo ^ y.lo};
+    return z;
+}
+
+/* Algorithm 1 of NIST SP 800-38D. H is secret, so this runs in constant time: no branches or lookups on x or y. */
+static struct gf128 s_gf128_mul(struct gf128 x, struct gf128 y) {
+    struct gf128 z = {0, 0};
+    struct gf128 v = y;
+
+    for (size_t i = 0; i < 128; ++i) {
+        uint64_t x_bit = i < 64 ? (x.hi >> (63 - i)) & 1 : (x.lo >> (127 - i)) & 1;
+        uint64_t x_mask = (uint64_t)0 - x_bit;
+        z.hi ^= v.hi & x_mask;
+        z.lo ^= v.lo & x_mask;
+
+        uint64_t reduce_mask = (uint64_t)0 - (v.lo & 1);
+        v.lo = (v.lo >> 1) | (v.hi << 63);
+        v.hi = (v.hi >> 1) ^ (UINT64_C(0xE100000000000000) & reduce_mask);
+    }
+
+    return z;
+}
+
+static struct gf128 s_gf128_pow(struct gf128 x, uint64_t exponent) {
+    struct gf128 result = {.hi = UINT64_C(0x8000000000000000), .lo = 0};
+
+    while (exponent) {
+        if (exponent & 1) {
+            result = s_gf128_mul(result, x);
+        }
+        x = s_gf128_mul(x, x);
+        exponent >>= 1;
+    }
+
+    return result;
+}
+
+/* The GCM lengths block, both lengths in bits. */
+static struct gf128 s_gcm_lengths_block(uint64_t aad_len, uint64_t ciphertext_len) {
+    struct gf128 x = {.hi = aad_len * 8, .lo = ciphertext_len * 8};
+    return x;
+}
+
+static size_t s_block_count(size_t len) {
+    return (len + AWS_AES_256_CIPHER_BLOCK_SIZE - 1) / AWS_AES_256_CIPHER_BLOCK_SIZE;
+}
+
+/* CTR encrypts input into output starting at counter_block. output may be input. */
+static int s_ctr_crypt(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const uint8_t counter_block[AWS_AES_256_CIPHER_BLOCK_SIZE],
+    struct aws_byte_cursor input,
+    uint8_t *output) {
+
+    struct aws_byte_cursor iv = aws_byte_cursor_from_array(counter_block, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    struct aws_symmetric_cipher *cipher = aws_aes_ctr_256_new_from_prepared_key(allocator, prepared_key, &iv);
+    if (cipher == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_buf span = aws_byte_buf_from_empty_array(output, input.len);
+    int result = AWS_OP_ERR;
+    if (aws_symmetric_cipher_encrypt_into(cipher, input, &span) == AWS_OP_SUCCESS &&
+        aws_symmetric_cipher_finalize_encryption_into(cipher, &span) == AWS_OP_SUCCESS) {
+        AWS_ASSERT(span.len == input.len);
+        result = AWS_OP_SUCCESS;
+    }
+
+    aws_symmetric_cipher_destroy(cipher);
+    return result;
+}
+
+/* E(K, block) */
+static int s_encrypt_block(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const uint8_t block[AWS_AES_256_CIPHER_BLOCK_SIZE],
+    struct gf128 *out) {
+
+    uint8_t keystream[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    if (s_ctr_crypt(
+            allocator, prepared_key, block, aws_byte_cursor_from_array(keystream, sizeof(keystream)), keystream)) {
+        return AWS_OP_ERR;
+    }
+
+    *out = s_gf128_load(keystream);
+    aws_secure_zero(keystream, sizeof(keystream));
+    return AWS_OP_SUCCESS;
+}
+
+/* Precomputed per key and nonce. */
+struct gcm_parallel_keys {
+    struct gf128 h;
+    struct aws_ghash_key ghash_key;
+    /* E(K, J0), which masks the tag. */
+    struct gf128 tag_mask;
+};
+
+static int s_gcm_init_keys(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    struct gcm_parallel_keys *keys) {
+
+    uint8_t block[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    if (s_encrypt_block(allocator, prepared_key, block, &keys->h)) {
+        return AWS_OP_ERR;
+    }
+    s_gf128_store(keys->h, block);
+    aws_ghash_key_init(&keys->ghash_key, block);
+    aws_secure_zero(block, sizeof(block));
+
+    memcpy(block, nonce->ptr, AWS_AES_256_GCM_NONCE_LEN);
+    aws_write_u32(1, block + S_COUNTER_OFFSET);
+    return s_encrypt_block(allocator, prepared_key, block, &keys->tag_mask);
+}
+
+/* GHASH over data's blocks without the lengths block, which is what pieces are combined with. */
+static struct gf128 s_gcm_partial_ghash(const struct gcm_parallel_keys *keys, struct aws_byte_cursor data) {
+    uint8_t y[AWS_GHASH_BLOCK_LEN] = {0};
+    aws_ghash_update(&keys->ghash_key, y, data.ptr, data.len);
+
+    struct gf128 partial = s_gf128_load(y);
+    aws_secure_zero(y, sizeof(y));
+    return partial;
+}
+
+struct aes_parallel_task {
+    struct aws_allocator *allocator;
+    struct aws_aes_256_prepared_key *prepared_key;
+    uint8_t counter_block[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    struct aws_byte_cursor input;
+    uint8_t *output;
+
+    /* GCM only. The GHASH input is the ciphertext, which is the input on open and the output on seal. */
+    const struct gcm_parallel_keys *gcm_keys;
+    bool ghash_output;
+    struct gf128 partial_ghash;
+
+    int error_code;
+};
+
+static int s_process_task(struct aes_parallel_task *task) {
+    if (task->gcm_keys && !task->ghash_output) {
+        task->partial_ghash = s_gcm_partial_ghash(task->gcm_keys, task->input);
+    }
+
+    if (s_ctr_crypt(task->allocator, task->prepared_key, task->counter_block, task->input, task->output)) {
+        return AWS_OP_ERR;
+    }
+
+    if (task->gcm_keys && task->ghash_output) {
+        struct aws_byte_cursor ciphertext = aws_byte_cursor_from_array(task->output, task->input.len);
+        task->partial_ghash = s_gcm_partial_ghash(task->gcm_keys, ciphertext);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static void s_run_task(void *task_arg) {
+    struct aes_parallel_task *task = task_arg;
+
+    if (s_process_task(task)) {
+        int error_code = aws_last_error();
+        task->error_code = error_code ? error_code : AWS_ERROR_UNKNOWN;
+    }
+}
+
+struct aes_parallel_job {
+    struct aws_allocator *allocator;
+    struct aws_aes_256_prepared_key *prepared_key;
+    const struct aws_aes_256_parallel_options *options;
+    /* the counter block the first piece starts at. */
+    uint8_t counter_block[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    struct aws_byte_cursor input;
+    uint8_t *output;
+    /* GCM only, see aes_parallel_task. */
+    const struct gcm_parallel_keys *gcm_keys;
+    bool ghash_output;
+};
+
+/* Splits the job into pieces and runs them. For GCM, acc comes in as the partial GHASH of everything before the
+ * input (the aad) and goes out with the input's pieces folded in. */
+static int s_run_job(const struct aes_parallel_job *job, struct gf128 *acc) {
+    size_t min_parallel_len =
+        job->options->min_parallel_len ? job->options->min_parallel_len : S_DEFAULT_MIN_PARALLEL_LEN;
+    size_t task_len = job->options->task_len ? job->options->task_len : S_DEFAULT_TASK_LEN;
+    task_len = aws_min_size(task_len, S_MAX_TASK_LEN) & ~(size_t)(AWS_AES_256_CIPHER_BLOCK_SIZE - 1);
+    task_len = aws_max_size(task_len, AWS_AES_256_CIPHER_BLOCK_SIZE);
+
+    if (job->input.len < min_parallel_len) {
+        task_len = aws_max_size(job->input.len, 1);
+    }
+
+    size_t task_count = job->input.len ? (job->input.len + task_len - 1) / task_len : 0;
+    if (task_count == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aes_parallel_task *tasks = aws_mem_calloc(job->allocator, task_count, sizeof(struct aes_parallel_task));
+    void **task_args = aws_mem_calloc(job->allocator, task_count, sizeof(void *));
+
+    struct aws_byte_cursor remaining = job->input;
+
+    for (size_t i = 0; i < task_count; ++i) {
+        struct aes_parallel_task *task = &tasks[i];
+        size_t offset = i * task_len;
+
+        task->allocator = job->allocator;
+        task->prepared_key = job->prepared_key;
+        /* GCM's 32 bit counter has been checked not to wrap, so carrying into the nonce never comes up for it. */
+        memcpy(task->counter_block, job->counter_block, AWS_AES_256_CIPHER_BLOCK_SIZE);
+        aws_aes_ctr_counter_block_add(task->counter_block, offset / AWS_AES_256_CIPHER_BLOCK_SIZE);
+        task->input = aws_byte_cursor_advance(&remaining, aws_min_size(task_len, remaining.len));
+        task->output = job->output + offset;
+        task->gcm_keys = job->gcm_keys;
+        task->ghash_output = job->ghash_output;
+        task_args[i] = task;
+    }
+
+    if (task_count == 1) {
+        s_run_task(task_args[0]);
+    } else {
+        job->options->run_tasks(s_run_task, task_args, task_count, job->options->user_data);
+    }
+
+    int result = AWS_OP_SUCCESS;
+    for (size_t i = 0; i < task_count; ++i) {
+        if (tasks[i].error_code) {
+            result = aws_raise_error(tasks[i].error_code);
+            break;
+        }
+    }
+
+    if (result == AWS_OP_SUCCESS && job->gcm_keys) {
+        /* every piece but the last is task_len long, so they all share one power of H. */
+        struct gf128 h_full_piece = s_gf128_pow(job->gcm_keys->h, task_len / AWS_AES_256_CIPHER_BLOCK_SIZE);
+        for (size_t i = 0; i < task_count; ++i) {
+            struct gf128 h_piece = i + 1 < task_count
+                                       ? h_full_piece
+                                       : s_gf128_pow(job->gcm_keys->h, s_block_count(tasks[i].input.len));
+            *acc = s_gf128_xor(s_gf128_mul(*acc, h_piece), tasks[i].partial_ghash);
+        }
+    }
+
+    aws_secure_zero(tasks, task_count * sizeof(struct aes_parallel_task));
+    aws_mem_release(job->allocator, task_args);
+    aws_mem_release(job->allocator, tasks);
+    return result;
+}
+
+/* Same rules as the one-shot GCM functions: a fixed span with room for output_len, and exact in place only. */
+static int s_check_output(struct aws_byte_cursor input, size_t output_len, const struct aws_byte_buf *out) {
+    if (out->capacity - out->len < output_len) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    const uint8_t *span_start = out->buffer + out->len;
+    if (input.len && input.ptr != span_start && input.ptr < span_start + output_len &&
+        span_start < input.ptr + input.len) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_check_options(
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_aes_256_parallel_options *options) {
+    if (prepared_key == NULL || options == NULL || options->run_tasks == NULL) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_ctr_crypt_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options) {
+
+    if (s_check_options(prepared_key, options)) {
+        return AWS_OP_ERR;
+    }
+
+    if (iv == NULL || iv->len != AWS_AES_256_CIPHER_BLOCK_SIZE) {
+        return aws_raise_error(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM);
+    }
+
+    if (s_check_output(input, input.len, out)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aes_parallel_job job = {
+        .allocator = allocator,
+        .prepared_key = prepared_key,
+        .options = options,
+        .input = input,
+        .output = out->buffer + out->len,
+    };
+    memcpy(job.counter_block, iv->ptr, AWS_AES_256_CIPHER_BLOCK_SIZE);
+
+    if (s_run_job(&job, NULL)) {
+        return AWS_OP_ERR;
+    }
+
+    out->len += input.len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_check_gcm_parallel_args(
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    struct aws_byte_cursor input,
+    size_t output_len,
+    const struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options) {
+
+    if (s_check_options(prepared_key, options)) {
+        return AWS_OP_ERR;
+    }
+
+    if (nonce == NULL) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (nonce->len != AWS_AES_256_GCM_NONCE_LEN) {
+        return aws_raise_error(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM);
+    }
+
+    if (s_block_count(input.len) > S_GCM_MAX_DATA_BLOCKS) {
+        return aws_raise_error(AWS_ERROR_CAL_BUFFER_TOO_LARGE_FOR_ALGORITHM);
+    }
+
+    return s_check_output(input, output_len, out);
+}
+
+/* Runs the CTR part of GCM over input and computes the tag over aad and the ciphertext. */
+static int s_gcm_crypt_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor input,
+    uint8_t *output,
+    bool encrypt,
+    const struct aws_aes_256_parallel_options *options,
+    uint8_t tag[AWS_AES_256_GCM_TAG_LEN]) {
+
+    struct gcm_parallel_keys keys;
+    if (s_gcm_init_keys(allocator, prepared_key, nonce, &keys)) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_ERR;
+    struct gf128 acc = {0, 0};
+    size_t aad_len = aad ? aad->len : 0;
+    if (aad_len) {
+        acc = s_gcm_partial_ghash(&keys, *aad);
+    }
+
+    struct aes_parallel_job job = {
+        .allocator = allocator,
+        .prepared_key = prepared_key,
+        .options = options,
+        .input = input,
+        .output = output,
+        .gcm_keys = &keys,
+        .ghash_output = encrypt,
+    };
+    memcpy(job.counter_block, nonce->ptr, AWS_AES_256_GCM_NONCE_LEN);
+    aws_write_u32(S_GCM_FIRST_DATA_COUNTER, job.counter_block + S_COUNTER_OFFSET);
+
+    if (s_run_job(&job, &acc)) {
+        goto done;
+    }
+
+    struct gf128 ghash = s_gf128_mul(s_gf128_xor(acc, s_gcm_lengths_block(aad_len, input.len)), keys.h);
+    s_gf128_store(s_gf128_xor(ghash, keys.tag_mask), tag);
+    aws_secure_zero(&ghash, sizeof(ghash));
+    result = AWS_OP_SUCCESS;
+
+done:
+    aws_secure_zero(&keys, sizeof(keys));
+    aws_secure_zero(&acc, sizeof(acc));
+    return result;
+}
+
+int aws_aes_256_gcm_seal_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options) {
+
+    if (s_check_gcm_parallel_args(
+            prepared_key, nonce, plaintext, plaintext.len + AWS_AES_256_GCM_TAG_LEN, out, options)) {
+        return AWS_OP_ERR;
+    }
+
+    uint8_t *ciphertext = out->buffer + out->len;
+    if (s_gcm_crypt_parallel(
+            allocator, prepared_key, nonce, aad, plaintext, ciphertext, true, options, ciphertext + plaintext.len)) {
+        return AWS_OP_ERR;
+    }
+
+    out->len += plaintext.len + AWS_AES_256_GCM_TAG_LEN;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_gcm_open_parallel(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext_and_tag,
+    struct aws_byte_buf *out,
+    const struct aws_aes_256_parallel_options *options) {
+
+    if (ciphertext_and_tag.len < AWS_AES_256_GCM_TAG_LEN) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    struct aws_byte_cursor ciphertext =
+        aws_byte_cursor_advance(&ciphertext_and_tag, ciphertext_and_tag.len - AWS_AES_256_GCM_TAG_LEN);
+    struct aws_byte_cursor expected_tag = ciphertext_and_tag;
+
+    if (s_check_gcm_parallel_args(prepared_key, nonce, ciphertext, ciphertext.len, out, options)) {
+        return AWS_OP_ERR;
+    }
+
+    /* the expected tag may sit inside out's unused capacity, where the plaintext is about to go. */
+    uint8_t expected[AWS_AES_256_GCM_TAG_LEN];
+    memcpy(expected, expected_tag.ptr, sizeof(expected));
+
+    uint8_t *plaintext = out->buffer + out->len;
+    uint8_t tag[AWS_AES_256_GCM_TAG_LEN];
+    if (s_gcm_crypt_parallel(allocator, prepared_key, nonce, aad, ciphertext, plaintext, false, options, tag)) {
+        aws_secure_zero(plaintext, ciphertext.len);
+        return AWS_OP_ERR;
+    }
+
+    uint8_t difference = 0;
+    for (size_t i = 0; i < sizeof(tag); ++i) {
+        difference |= tag[i] ^ expected[i];
+    }
+
+    if (difference) {
+        aws_secure_zero(plaintext, ciphertext.len);
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    out->len += ciphertext.len;
+    return AWS_OP_SUCCESS;
+}
@@ -3,30 +3,241 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/cal/private/symmetric_cipher_priv.h>
+#include <aws/common/thread.h>
 
 #include <openssl/evp.h>
 
+/* BoringSSL only has XTS in libdecrepit. GCM-SIV is only exposed, as an EVP_AEAD, by AWS-LC and BoringSSL. */
+#if !defined(OPENSSL_IS_BORINGSSL)
+#    define AWS_OPENSSL_HAS_AES_XTS
+#endif
+
+#if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL)
+#    include <openssl/aead.h>
+#    define AWS_OPENSSL_HAS_AES_GCM_SIV
+#endif
+
+/* AWS-LC has an EVP_CIPHER for ChaCha20-Poly1305, BoringSSL only the EVP_AEAD. OpenSSL added it in 1.1.0. */
+#if defined(OPENSSL_IS_AWSLC) ||                                                                                       \
+    (!defined(OPENSSL_IS_BORINGSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(OPENSSL_NO_CHACHA) &&         \
+     !defined(OPENSSL_NO_POLY1305))
+#    define AWS_OPENSSL_HAS_CHACHA20_POLY1305
+#endif
+
+/* Initializes ctx for one direction (enc is 1 for encrypt, 0 for decrypt) from the cipher's key, iv, aad and tag. */
+typedef int(openssl_aes_init_ctx_fn)(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc);
+
 struct openssl_aes_cipher {
     struct aws_symmetric_cipher cipher_base;
+    /* Nearly every cipher only ever goes one way, so each context is created and keyed on first use, see
+     * s_get_ctx(). A reset keeps the contexts around but un-keyed. */
     EVP_CIPHER_CTX *encryptor_ctx;
     EVP_CIPHER_CTX *decryptor_ctx;
+    bool encryptor_keyed;
+    bool decryptor_keyed;
+    openssl_aes_init_ctx_fn *init_ctx;
+    /* Set when the cipher was made from a prepared key. cipher_base.key then borrows the prepared key's bytes. */
+    struct aws_aes_256_prepared_key *prepared_key;
     struct aws_byte_buf working_buffer;
+    /* CTR only. After a seek, contexts start at ctr_seek_block and skip ctr_seek_skip bytes of keystream instead of
+       starting at the IV. A reset clears it. */
+    uint8_t ctr_seek_block[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    size_t ctr_seek_skip;
+    bool ctr_seeked;
+};
+
+enum openssl_aes_mode {
+    OPENSSL_AES_MODE_CBC,
+    OPENSSL_AES_MODE_CTR,
+    OPENSSL_AES_MODE_GCM,
+    OPENSSL_AES_MODE_KEYWRAP,
+    OPENSSL_AES_MODE_COUNT,
+};
+
+struct openssl_aes_prepared_key {
+    /* Keyed contexts with no IV, indexed by mode and enc. Each is created the first time a cipher needs it and is
+     * never modified once published, ciphers copy it rather than run the key schedule again. */
+    struct aws_atomic_var templates[OPENSSL_AES_MODE_COUNT][2];
 };
 
+static const EVP_CIPHER *s_evp_cipher_for_mode(enum openssl_aes_mode mode) {
+    switch (mode) {
+        case OPENSSL_AES_MODE_CBC:
+            return EVP_aes_256_cbc();
+        case OPENSSL_AES_MODE_CTR:
+            return EVP_aes_256_ctr();
+        case OPENSSL_AES_MODE_GCM:
+            return EVP_aes_256_gcm();
+        default:
+            /* keywrap is built on single block ECB encryptions, see s_key_wrap_finalize_encryption(). */
+            return EVP_aes_256_ecb();
+    }
+}
+
+/* iv may be NULL to key ctx without one. Only CBC uses padding. */
+static int s_init_ctx_for_mode(
+    EVP_CIPHER_CTX *ctx,
+    enum openssl_aes_mode mode,
+    const uint8_t *key,
+    const uint8_t *iv,
+    int enc) {
+    if (!(EVP_CipherInit_ex(ctx, s_evp_cipher_for_mode(mode), NULL, key, iv, enc) &&
+          (mode == OPENSSL_AES_MODE_CBC || EVP_CIPHER_CTX_set_padding(ctx, 0)))) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static EVP_CIPHER_CTX *s_get_template(
+    struct aws_aes_256_prepared_key *prepared_key,
+    enum openssl_aes_mode mode,
+    int enc) {
+    struct openssl_aes_prepared_key *prepared_impl = prepared_key->impl;
+    struct aws_atomic_var *slot = &prepared_impl->templates[mode][enc ? 1 : 0];
+
+    EVP_CIPHER_CTX *template_ctx = aws_atomic_load_ptr(slot);
+    if (template_ctx) {
+        return template_ctx;
+    }
+
+    template_ctx = EVP_CIPHER_CTX_new();
+    AWS_FATAL_ASSERT(template_ctx && "Cipher initialization failed!");
+
+    if (s_init_ctx_for_mode(template_ctx, mode, prepared_key->key.buffer, NULL, enc)) {
+        EVP_CIPHER_CTX_free(template_ctx);
+        return NULL;
+    }
+
+    void *published = NULL;
+    if (!aws_atomic_compare_exchange_ptr(slot, &published, template_ctx)) {
+        /* another thread built the same template first, use theirs. */
+        EVP_CIPHER_CTX_free(template_ctx);
+        template_ctx = published;
+    }
+
+    return template_ctx;
+}
+
+/* Keys ctx for mode from the cipher's key and iv. Ciphers made from a prepared key copy its template and only
+ * set the iv, which skips the key schedule. */
+static int s_key_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, enum openssl_aes_mode mode, int enc) {
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    const uint8_t *iv = cipher->iv.len ? cipher->iv.buffer : NULL;
+
+    if (openssl_cipher->prepared_key == NULL) {
+        return s_init_ctx_for_mode(ctx, mode, cipher->key.buffer, iv, enc);
+    }
+
+    EVP_CIPHER_CTX *template_ctx = s_get_template(openssl_cipher->prepared_key, mode, enc);
+    if (template_ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    if (!EVP_CIPHER_CTX_copy(ctx, template_ctx) || (iv && !EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, enc))) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_prepared_key_init_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    struct openssl_aes_prepared_key *prepared_impl =
+        aws_mem_calloc(prepared_key->allocator, 1, sizeof(struct openssl_aes_prepared_key));
+
+    for (size_t mode = 0; mode < OPENSSL_AES_MODE_COUNT; ++mode) {
+        aws_atomic_init_ptr(&prepared_impl->templates[mode][0], NULL);
+        aws_atomic_init_ptr(&prepared_impl->templates[mode][1], NULL);
+    }
+
+    prepared_key->impl = prepared_impl;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_aes_256_prepared_key_clean_up_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    struct openssl_aes_prepared_key *prepared_impl = prepared_key->impl;
+
+    for (size_t mode = 0; mode < OPENSSL_AES_MODE_COUNT; ++mode) {
+        for (size_t enc = 0; enc < 2; ++enc) {
+            EVP_CIPHER_CTX *template_ctx = aws_atomic_load_ptr(&prepared_impl->templates[mode][enc]);
+            if (template_ctx) {
+                EVP_CIPHER_CTX_free(template_ctx);
+            }
+        }
+    }
+
+    aws_mem_release(prepared_key->allocator, prepared_impl);
+}
+
+/* Either copies key (generating one if it's NULL), or borrows prepared_key's bytes and takes a reference on it. */
+static void s_init_key(
+    struct openssl_aes_cipher *cipher,
+    const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(cipher->cipher_base.allocator);
+
+    if (prepared_key) {
+        aws_aes_256_prepared_key_acquire(prepared_key);
+        cipher->prepared_key = prepared_key;
+        cipher->cipher_base.key = aws_byte_buf_from_array(prepared_key->key.buffer, prepared_key->key.len);
+    } else if (key) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, secure_allocator, *key);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.key, secure_allocator, AWS_AES_256_KEY_BYTE_LEN);
+        aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cipher->cipher_base.key);
+    }
+}
+
+/* Returns the context for the requested direction, creating and keying it if this is its first use since the
+ * cipher was created or reset. On failure, the cipher is no longer good. */
+static EVP_CIPHER_CTX *s_get_ctx(struct aws_symmetric_cipher *cipher, int enc) {
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+
+    EVP_CIPHER_CTX **ctx = enc ? &openssl_cipher->encryptor_ctx : &openssl_cipher->decryptor_ctx;
+    bool *keyed = enc ? &openssl_cipher->encryptor_keyed : &openssl_cipher->decryptor_keyed;
+
+    if (*keyed) {
+        return *ctx;
+    }
+
+    if (*ctx == NULL) {
+        /* EVP_CIPHER_CTX_init() will be called inside EVP_CIPHER_CTX_new(). */
+        *ctx = EVP_CIPHER_CTX_new();
+        AWS_FATAL_ASSERT(*ctx && "Cipher initialization failed!");
+    }
+
+    if (openssl_cipher->init_ctx(cipher, *ctx, enc)) {
+        cipher->good = false;
+        return NULL;
+    }
+
+    *keyed = true;
+    return *ctx;
+}
+
+/* EVP reports a block size of 1 for the stream modes (CTR, GCM), which never write more than they are given.
+ * The block modes can write up to an extra block on update (buffered input) and on final (padding). */
+static size_t s_required_slack(EVP_CIPHER_CTX *ctx) {
+    int block_size = EVP_CIPHER_CTX_block_size(ctx);
+    return block_size > 1 ? (size_t)block_size : 0;
+}
+
 static int s_encrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor input, struct aws_byte_buf *out) {
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 1);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
 
-    size_t required_buffer_space = input.len + cipher->block_size;
+    size_t required_buffer_space = input.len + s_required_slack(ctx);
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
     size_t available_write_space = out->capacity - out->len;
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
 
     int len_written = (int)(available_write_space);
-    if (!EVP_EncryptUpdate(
-            openssl_cipher->encryptor_ctx, out->buffer + out->len, &len_written, input.ptr, (int)input.len)) {
+    if (!EVP_EncryptUpdate(ctx, out->buffer + out->len, &len_written, input.ptr, (int)input.len)) {
         cipher->good = false;
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
@@ -36,16 +247,19 @@ static int s_encrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor
 }
 
 static int s_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 1);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
 
-    size_t required_buffer_space = cipher->block_size;
+    size_t required_buffer_space = s_required_slack(ctx);
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
     int len_written = (int)(out->capacity - out->len);
-    if (!EVP_EncryptFinal_ex(openssl_cipher->encryptor_ctx, out->buffer + out->len, &len_written)) {
+    if (!EVP_EncryptFinal_ex(ctx, out->buffer + out->len, &len_written)) {
         cipher->good = false;
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
@@ -55,9 +269,12 @@ static int s_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws
 }
 
 static int s_decrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor input, struct aws_byte_buf *out) {
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 0);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
 
-    size_t required_buffer_space = input.len + cipher->block_size;
+    size_t required_buffer_space = input.len + s_required_slack(ctx);
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
@@ -66,8 +283,7 @@ static int s_decrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor
     size_t available_write_space = out->capacity - out->len;
 
     int len_written = (int)available_write_space;
-    if (!EVP_DecryptUpdate(
-            openssl_cipher->decryptor_ctx, out->buffer + out->len, &len_written, input.ptr, (int)input.len)) {
+    if (!EVP_DecryptUpdate(ctx, out->buffer + out->len, &len_written, input.ptr, (int)input.len)) {
         cipher->good = false;
 
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
@@ -78,16 +294,19 @@ static int s_decrypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor
 }
 
 static int s_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 0);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
 
-    size_t required_buffer_space = cipher->block_size;
+    size_t required_buffer_space = s_required_slack(ctx);
 
     if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
     int len_written = (int)out->capacity - out->len;
-    if (!EVP_DecryptFinal_ex(openssl_cipher->decryptor_ctx, out->buffer + out->len, &len_written)) {
+    if (!EVP_DecryptFinal_ex(ctx, out->buffer + out->len, &len_written)) {
         cipher->good = false;
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
@@ -96,6 +315,68 @@ static int s_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws
     return AWS_OP_SUCCESS;
 }
 
+typedef int(evp_cipher_update_fn)(EVP_CIPHER_CTX *ctx, unsigned char *out, int *outl, const unsigned char *in, int inl);
+
+/* EVP carries partial blocks between updates itself, so a chain of segments is just an update per segment into a
+ * buffer that was sized once for the whole chain. */
+static int s_update_vectored(
+    struct aws_symmetric_cipher *cipher,
+    EVP_CIPHER_CTX *ctx,
+    evp_cipher_update_fn *update_fn,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+
+    size_t required_buffer_space = s_required_slack(ctx);
+    for (size_t i = 0; i < segment_count; ++i) {
+        if (aws_add_size_checked(required_buffer_space, segments[i].len, &required_buffer_space)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    for (size_t i = 0; i < segment_count; ++i) {
+        int len_written = (int)aws_min_size(out->capacity - out->len, INT_MAX);
+        if (!update_fn(ctx, out->buffer + out->len, &len_written, segments[i].ptr, (int)segments[i].len)) {
+            cipher->good = false;
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        }
+
+        out->len += len_written;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_encrypt_vectored(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 1);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    return s_update_vectored(cipher, ctx, EVP_EncryptUpdate, segments, segment_count, out);
+}
+
+static int s_decrypt_vectored(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *segments,
+    size_t segment_count,
+    struct aws_byte_buf *out) {
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 0);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    return s_update_vectored(cipher, ctx, EVP_DecryptUpdate, segments, segment_count, out);
+}
+
 static void s_destroy(struct aws_symmetric_cipher *cipher) {
     struct openssl_aes_cipher *openssl_cipher = cipher->impl;
 
@@ -107,7 +388,11 @@ static void s_destroy(struct aws_symmetric_cipher *cipher) {
         EVP_CIPHER_CTX_free(openssl_cipher->decryptor_ctx);
     }
 
-    aws_byte_buf_clean_up_secure(&cipher->key);
+    if (openssl_cipher->prepared_key) {
+        aws_aes_256_prepared_key_release(openssl_cipher->prepared_key);
+    } else {
+        aws_byte_buf_clean_up_secure(&cipher->key);
+    }
     aws_byte_buf_clean_up_secure(&cipher->iv);
 
     if (cipher->tag.buffer) {
@@ -123,62 +408,49 @@ static void s_destroy(struct aws_symmetric_cipher *cipher) {
     aws_mem_release(cipher->allocator, openssl_cipher);
 }
 
-static int s_clear_reusable_state(struct aws_symmetric_cipher *cipher) {
+/* Wipes whichever contexts exist and marks them un-keyed, s_get_ctx() re-keys a direction when it's next used. */
+static int s_reset(struct aws_symmetric_cipher *cipher) {
     struct openssl_aes_cipher *openssl_cipher = cipher->impl;
 
-    EVP_CIPHER_CTX_cleanup(openssl_cipher->encryptor_ctx);
-    EVP_CIPHER_CTX_cleanup(openssl_cipher->decryptor_ctx);
-    aws_byte_buf_secure_zero(&openssl_cipher->working_buffer);
-    cipher->good = true;
-    return AWS_OP_SUCCESS;
-}
-
-static int s_init_cbc_cipher_materials(struct aws_symmetric_cipher *cipher) {
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    if (openssl_cipher->encryptor_ctx) {
+        EVP_CIPHER_CTX_cleanup(openssl_cipher->encryptor_ctx);
+    }
 
-    if (!EVP_EncryptInit_ex(
-            openssl_cipher->encryptor_ctx,
-            EVP_aes_256_cbc(),
-            NULL,
-            openssl_cipher->cipher_base.key.buffer,
-            openssl_cipher->cipher_base.iv.buffer) ||
-        !EVP_DecryptInit_ex(
-            openssl_cipher->decryptor_ctx,
-            EVP_aes_256_cbc(),
-            NULL,
-            openssl_cipher->cipher_base.key.buffer,
-            openssl_cipher->cipher_base.iv.buffer)) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    if (openssl_cipher->decryptor_ctx) {
+        EVP_CIPHER_CTX_cleanup(openssl_cipher->decryptor_ctx);
     }
 
+    openssl_cipher->encryptor_keyed = false;
+    openssl_cipher->decryptor_keyed = false;
+    openssl_cipher->ctr_seeked = false;
+    aws_byte_buf_secure_zero(&openssl_cipher->working_buffer);
+    cipher->good = true;
     return AWS_OP_SUCCESS;
 }
 
-static int s_reset_cbc_cipher_materials(struct aws_symmetric_cipher *cipher) {
-    int ret_val = s_clear_reusable_state(cipher);
-
-    if (ret_val == AWS_OP_SUCCESS) {
-        return s_init_cbc_cipher_materials(cipher);
-    }
-
-    return ret_val;
+static int s_init_cbc_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc) {
+    return s_key_ctx(cipher, ctx, OPENSSL_AES_MODE_CBC, enc);
 }
 
 static struct aws_symmetric_cipher_vtable s_cbc_vtable = {
     .alg_name = "AES-CBC 256",
     .provider = "OpenSSL Compatible LibCrypto",
     .destroy = s_destroy,
-    .reset = s_reset_cbc_cipher_materials,
+    .reset = s_reset,
     .decrypt = s_decrypt,
     .encrypt = s_encrypt,
+    .decrypt_vectored = s_decrypt_vectored,
+    .encrypt_vectored = s_encrypt_vectored,
     .finalize_decryption = s_finalize_decryption,
     .finalize_encryption = s_finalize_encryption,
 };
 
-struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_cbc_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key,
     const struct aws_byte_cursor *iv) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
     struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
 
     cipher->cipher_base.allocator = allocator;
@@ -186,90 +458,95 @@ struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
     cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->cipher_base.vtable = &s_cbc_vtable;
     cipher->cipher_base.impl = cipher;
+    cipher->init_ctx = s_init_cbc_ctx;
 
-    if (key) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, allocator, *key);
-    } else {
-        aws_byte_buf_init(&cipher->cipher_base.key, allocator, AWS_AES_256_KEY_BYTE_LEN);
-        aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cipher->cipher_base.key);
-    }
+    s_init_key(cipher, key, prepared_key);
 
     if (iv) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, allocator, *iv);
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, secure_allocator, *iv);
     } else {
-        aws_byte_buf_init(&cipher->cipher_base.iv, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+        aws_byte_buf_init(&cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
         aws_symmetric_cipher_generate_initialization_vector(
             AWS_AES_256_CIPHER_BLOCK_SIZE, false, &cipher->cipher_base.iv);
     }
 
-    /* EVP_CIPHER_CTX_init() will be called inside EVP_CIPHER_CTX_new(). */
-    cipher->encryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->encryptor_ctx && "Cipher initialization failed!");
-
-    /* EVP_CIPHER_CTX_init() will be called inside EVP_CIPHER_CTX_new(). */
-    cipher->decryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->decryptor_ctx && "Cipher initialization failed!");
-
-    if (s_init_cbc_cipher_materials(&cipher->cipher_base) != AWS_OP_SUCCESS) {
-        goto error;
-    }
-
     cipher->cipher_base.good = true;
     return &cipher->cipher_base;
+}
 
-error:
-    s_destroy(&cipher->cipher_base);
-    return NULL;
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_cbc_256_new(allocator, key, NULL, iv);
+}
+
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_cbc_256_new(allocator, NULL, prepared_key, iv);
 }
 
-static int s_init_ctr_cipher_materials(struct aws_symmetric_cipher *cipher) {
+static int s_init_ctr_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc) {
     struct openssl_aes_cipher *openssl_cipher = cipher->impl;
 
-    if (!(EVP_EncryptInit_ex(
-              openssl_cipher->encryptor_ctx,
-              EVP_aes_256_ctr(),
-              NULL,
-              openssl_cipher->cipher_base.key.buffer,
-              openssl_cipher->cipher_base.iv.buffer) &&
-          EVP_CIPHER_CTX_set_padding(openssl_cipher->encryptor_ctx, 0)) ||
-        !(EVP_DecryptInit_ex(
-              openssl_cipher->decryptor_ctx,
-              EVP_aes_256_ctr(),
-              NULL,
-              openssl_cipher->cipher_base.key.buffer,
-              openssl_cipher->cipher_base.iv.buffer) &&
-          EVP_CIPHER_CTX_set_padding(openssl_cipher->decryptor_ctx, 0))) {
+    if (s_key_ctx(cipher, ctx, OPENSSL_AES_MODE_CTR, enc)) {
+        return AWS_OP_ERR;
+    }
+
+    if (!openssl_cipher->ctr_seeked) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* setting only the iv restarts the keystream there, then running zeros through uses up the skipped part of the
+       block. */
+    uint8_t zeros[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    uint8_t discard[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    int len_written = (int)sizeof(discard);
+    int success = EVP_CipherInit_ex(ctx, NULL, NULL, NULL, openssl_cipher->ctr_seek_block, enc) &&
+                  (openssl_cipher->ctr_seek_skip == 0 ||
+                   EVP_CipherUpdate(ctx, discard, &len_written, zeros, (int)openssl_cipher->ctr_seek_skip));
+    aws_secure_zero(discard, sizeof(discard));
+
+    if (!success) {
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
     return AWS_OP_SUCCESS;
 }
 
-static int s_reset_ctr_cipher_materials(struct aws_symmetric_cipher *cipher) {
-    int ret_val = s_clear_reusable_state(cipher);
-
-    if (ret_val == AWS_OP_SUCCESS) {
-        return s_init_ctr_cipher_materials(cipher);
-    }
+/* Contexts are re-keyed lazily, so this only has to record where they should start. */
+static int s_ctr_seek(struct aws_symmetric_cipher *cipher, const uint8_t *counter_block, size_t skip) {
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
 
-    return ret_val;
+    s_reset(cipher);
+    memcpy(openssl_cipher->ctr_seek_block, counter_block, sizeof(openssl_cipher->ctr_seek_block));
+    openssl_cipher->ctr_seek_skip = skip;
+    openssl_cipher->ctr_seeked = true;
+    return AWS_OP_SUCCESS;
 }
 
 static struct aws_symmetric_cipher_vtable s_ctr_vtable = {
     .alg_name = "AES-CTR 256",
     .provider = "OpenSSL Compatible LibCrypto",
     .destroy = s_destroy,
-    .reset = s_reset_ctr_cipher_materials,
+    .reset = s_reset,
     .decrypt = s_decrypt,
     .encrypt = s_encrypt,
+    .decrypt_vectored = s_decrypt_vectored,
+    .encrypt_vectored = s_encrypt_vectored,
     .finalize_decryption = s_finalize_decryption,
     .finalize_encryption = s_finalize_encryption,
+    .seek = s_ctr_seek,
 };
 
-struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_ctr_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key,
     const struct aws_byte_cursor *iv) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
     struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
 
     cipher->cipher_base.allocator = allocator;
@@ -277,40 +554,34 @@ struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
     cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->cipher_base.vtable = &s_ctr_vtable;
     cipher->cipher_base.impl = cipher;
+    cipher->init_ctx = s_init_ctr_ctx;
 
-    if (key) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, allocator, *key);
-    } else {
-        aws_byte_buf_init(&cipher->cipher_base.key, allocator, AWS_AES_256_KEY_BYTE_LEN);
-        aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cipher->cipher_base.key);
-    }
+    s_init_key(cipher, key, prepared_key);
 
     if (iv) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, allocator, *iv);
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, secure_allocator, *iv);
     } else {
-        aws_byte_buf_init(&cipher->cipher_base.iv, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+        aws_byte_buf_init(&cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
         aws_symmetric_cipher_generate_initialization_vector(
             AWS_AES_256_CIPHER_BLOCK_SIZE, true, &cipher->cipher_base.iv);
     }
 
-    /* EVP_CIPHER_CTX_init() will be called inside EVP_CIPHER_CTX_new(). */
-    cipher->encryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->encryptor_ctx && "Cipher initialization failed!");
-
-    /* EVP_CIPHER_CTX_init() will be called inside EVP_CIPHER_CTX_new(). */
-    cipher->decryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->decryptor_ctx && "Cipher initialization failed!");
-
-    if (s_init_ctr_cipher_materials(&cipher->cipher_base) != AWS_OP_SUCCESS) {
-        goto error;
-    }
-
     cipher->cipher_base.good = true;
     return &cipher->cipher_base;
+}
 
-error:
-    s_destroy(&cipher->cipher_base);
-    return NULL;
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_ctr_256_new(allocator, key, NULL, iv);
+}
+
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_ctr_256_new(allocator, NULL, prepared_key, iv);
 }
 
 static int s_finalize_gcm_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
@@ -335,52 +606,20 @@ static int s_finalize_gcm_encryption(struct aws_symmetric_cipher *cipher, struct
     return ret_val;
 }
 
-static int s_init_gcm_cipher_materials(struct aws_symmetric_cipher *cipher) {
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
-
-    if (!(EVP_EncryptInit_ex(openssl_cipher->encryptor_ctx, EVP_aes_256_gcm(), NULL, NULL, NULL) &&
-          EVP_EncryptInit_ex(
-              openssl_cipher->encryptor_ctx,
-              NULL,
-              NULL,
-              openssl_cipher->cipher_base.key.buffer,
-              openssl_cipher->cipher_base.iv.buffer) &&
-          EVP_CIPHER_CTX_set_padding(openssl_cipher->encryptor_ctx, 0)) ||
-        !(EVP_DecryptInit_ex(openssl_cipher->decryptor_ctx, EVP_aes_256_gcm(), NULL, NULL, NULL) &&
-          EVP_DecryptInit_ex(
-              openssl_cipher->decryptor_ctx,
-              NULL,
-              NULL,
-              openssl_cipher->cipher_base.key.buffer,
-              openssl_cipher->cipher_base.iv.buffer) &&
-          EVP_CIPHER_CTX_set_padding(openssl_cipher->decryptor_ctx, 0))) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+static int s_init_gcm_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc) {
+    if (s_key_ctx(cipher, ctx, OPENSSL_AES_MODE_GCM, enc)) {
+        return AWS_OP_ERR;
     }
 
-    if (openssl_cipher->cipher_base.aad.len) {
+    if (cipher->aad.len) {
         int outLen = 0;
-        if (!EVP_EncryptUpdate(
-                openssl_cipher->encryptor_ctx,
-                NULL,
-                &outLen,
-                openssl_cipher->cipher_base.aad.buffer,
-                (int)openssl_cipher->cipher_base.aad.len) ||
-            !EVP_DecryptUpdate(
-                openssl_cipher->decryptor_ctx,
-                NULL,
-                &outLen,
-                openssl_cipher->cipher_base.aad.buffer,
-                (int)openssl_cipher->cipher_base.aad.len)) {
+        if (!EVP_CipherUpdate(ctx, NULL, &outLen, cipher->aad.buffer, (int)cipher->aad.len)) {
             return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
         }
     }
 
-    if (openssl_cipher->cipher_base.tag.len) {
-        if (!EVP_CIPHER_CTX_ctrl(
-                openssl_cipher->decryptor_ctx,
-                EVP_CTRL_GCM_SET_TAG,
-                (int)openssl_cipher->cipher_base.tag.len,
-                openssl_cipher->cipher_base.tag.buffer)) {
+    if (!enc && cipher->tag.len) {
+        if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, (int)cipher->tag.len, cipher->tag.buffer)) {
             return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
         }
     }
@@ -388,33 +627,27 @@ static int s_init_gcm_cipher_materials(struct aws_symmetric_cipher *cipher) {
     return AWS_OP_SUCCESS;
 }
 
-static int s_reset_gcm_cipher_materials(struct aws_symmetric_cipher *cipher) {
-    int ret_val = s_clear_reusable_state(cipher);
-
-    if (ret_val == AWS_OP_SUCCESS) {
-        return s_init_gcm_cipher_materials(cipher);
-    }
-
-    return ret_val;
-}
-
 static struct aws_symmetric_cipher_vtable s_gcm_vtable = {
     .alg_name = "AES-GCM 256",
     .provider = "OpenSSL Compatible LibCrypto",
     .destroy = s_destroy,
-    .reset = s_reset_gcm_cipher_materials,
+    .reset = s_reset,
     .decrypt = s_decrypt,
     .encrypt = s_encrypt,
+    .decrypt_vectored = s_decrypt_vectored,
+    .encrypt_vectored = s_encrypt_vectored,
     .finalize_decryption = s_finalize_decryption,
     .finalize_encryption = s_finalize_gcm_encryption,
 };
 
-struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_gcm_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key,
     const struct aws_byte_cursor *iv,
     const struct aws_byte_cursor *aad,
     const struct aws_byte_cursor *decryption_tag) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
 
     struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
     cipher->cipher_base.allocator = allocator;
@@ -422,31 +655,20 @@ struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
     cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->cipher_base.vtable = &s_gcm_vtable;
     cipher->cipher_base.impl = cipher;
+    cipher->init_ctx = s_init_gcm_ctx;
 
     /* Copy key into the cipher context. */
-    if (key) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, allocator, *key);
-    } else {
-        aws_byte_buf_init(&cipher->cipher_base.key, allocator, AWS_AES_256_KEY_BYTE_LEN);
-        aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cipher->cipher_base.key);
-    }
+    s_init_key(cipher, key, prepared_key);
 
     /* Copy initialization vector into the cipher context. */
     if (iv) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, allocator, *iv);
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, secure_allocator, *iv);
     } else {
-        aws_byte_buf_init(&cipher->cipher_base.iv, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE - 4);
+        aws_byte_buf_init(&cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE - 4);
         aws_symmetric_cipher_generate_initialization_vector(
             AWS_AES_256_CIPHER_BLOCK_SIZE - 4, false, &cipher->cipher_base.iv);
     }
 
-    /* Initialize the cipher contexts. */
-    cipher->encryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->encryptor_ctx && "Encryptor cipher initialization failed!");
-
-    cipher->decryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->decryptor_ctx && "Decryptor cipher initialization failed!");
-
     /* Set AAD if provided */
     if (aad) {
         aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.aad, allocator, *aad);
@@ -460,63 +682,254 @@ struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
         aws_byte_buf_init(&cipher->cipher_base.tag, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
     }
 
-    /* Initialize the cipher contexts with the specified key and IV. */
-    if (s_init_gcm_cipher_materials(&cipher->cipher_base)) {
-        goto error;
-    }
-
     cipher->cipher_base.good = true;
     return &cipher->cipher_base;
-
-error:
-    s_destroy(&cipher->cipher_base);
-    return NULL;
 }
 
-static int s_key_wrap_encrypt_decrypt(
-    struct aws_symmetric_cipher *cipher,
-    struct aws_byte_cursor input,
-    struct aws_byte_buf *out) {
-    (void)out;
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
-
-    return aws_byte_buf_append_dynamic(&openssl_cipher->working_buffer, &input);
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    return s_aes_gcm_256_new(allocator, key, NULL, iv, aad, decryption_tag);
 }
 
-static const size_t MIN_CEK_LENGTH_BYTES = 128 / 8;
-static const unsigned char INTEGRITY_VALUE = 0xA6;
-#define KEYWRAP_BLOCK_SIZE 8u
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    return s_aes_gcm_256_new(allocator, NULL, prepared_key, iv, aad, decryption_tag);
+}
 
-static int s_key_wrap_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
-    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+/*
+ * The one-shot seal/open paths keep a single EVP_CIPHER_CTX per thread rather than allocating one for every call. It
+ * is reset after each call, which wipes and frees the key schedule, so no key material is left behind between calls.
+ * The context is released when the thread exits, or sooner by aws_openssl_aes_thread_clean_up(), which runs from
+ * aws_cal_thread_clean_up() and aws_cal_library_clean_up(). Only threads started with aws_thread_launch() can have
+ * anything run at exit, so on any other thread each call gets a context of its own.
+ */
+static AWS_THREAD_LOCAL EVP_CIPHER_CTX *tl_gcm_oneshot_ctx = NULL;
+static AWS_THREAD_LOCAL bool tl_gcm_oneshot_at_exit_registered = false;
 
-    if (openssl_cipher->working_buffer.len < MIN_CEK_LENGTH_BYTES) {
-        cipher->good = false;
-        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+void aws_openssl_aes_thread_clean_up(void) {
+    if (tl_gcm_oneshot_ctx) {
+        EVP_CIPHER_CTX_free(tl_gcm_oneshot_ctx);
+        tl_gcm_oneshot_ctx = NULL;
     }
+}
 
-    /* the following is an in place implementation of
-       RFC 3394 using the alternate in-place implementation.
-       we use one in-place buffer instead of the copy at the end.
-       the one letter variable names are meant to directly reflect the variables in the RFC */
-    size_t required_buffer_space = openssl_cipher->working_buffer.len + cipher->block_size;
-    size_t starting_len_offset = out->len;
+static void s_gcm_oneshot_at_exit(void *user_data) {
+    (void)user_data;
+    aws_openssl_aes_thread_clean_up();
+}
 
-    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
-        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+static EVP_CIPHER_CTX *s_acquire_gcm_oneshot_ctx(void) {
+    if (tl_gcm_oneshot_ctx) {
+        return tl_gcm_oneshot_ctx;
     }
 
-    /* put the integrity check register in the first 8 bytes of the final buffer. */
-    aws_byte_buf_write_u8_n(out, INTEGRITY_VALUE, KEYWRAP_BLOCK_SIZE);
-    uint8_t *a = out->buffer + starting_len_offset;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    AWS_FATAL_ASSERT(ctx && "GCM cipher initialization failed!");
+
+    if (!tl_gcm_oneshot_at_exit_registered) {
+        /* failing only means this isn't a thread we launched, which isn't the caller's error */
+        int last_error = aws_last_error();
+        if (aws_thread_current_at_exit(s_gcm_oneshot_at_exit, NULL) == AWS_OP_SUCCESS) {
+            tl_gcm_oneshot_at_exit_registered = true;
+        } else {
+            aws_restore_error(last_error);
+            return ctx;
+        }
+    }
 
-    struct aws_byte_cursor working_buf_cur = aws_byte_cursor_from_buf(&openssl_cipher->working_buffer);
-    aws_byte_buf_write_from_whole_cursor(out, working_buf_cur);
+    tl_gcm_oneshot_ctx = ctx;
+    return ctx;
+}
 
-    /* put the register buffer after the integrity check register */
-    uint8_t *r = out->buffer + starting_len_offset + KEYWRAP_BLOCK_SIZE;
+static void s_release_gcm_oneshot_ctx(EVP_CIPHER_CTX *ctx) {
+    if (ctx == tl_gcm_oneshot_ctx) {
+        EVP_CIPHER_CTX_cleanup(ctx);
+    } else {
+        EVP_CIPHER_CTX_free(ctx);
+    }
+}
 
-    int n = (int)(openssl_cipher->working_buffer.len / KEYWRAP_BLOCK_SIZE);
+static int s_begin_gcm_oneshot(
+    EVP_CIPHER_CTX *ctx,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    int enc) {
+
+    if (!EVP_CipherInit_ex(ctx, EVP_aes_256_gcm(), NULL, key->ptr, nonce->ptr, enc)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    int len_written = 0;
+    if (aad && !EVP_CipherUpdate(ctx, NULL, &len_written, aad->ptr, (int)aad->len)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_gcm_seal_oneshot(
+    EVP_CIPHER_CTX *ctx,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+
+    if (s_begin_gcm_oneshot(ctx, key, nonce, aad, 1)) {
+        return AWS_OP_ERR;
+    }
+
+    int len_written = 0;
+    if (plaintext.len &&
+        !EVP_EncryptUpdate(ctx, out->buffer + out->len, &len_written, plaintext.ptr, (int)plaintext.len)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+    out->len += len_written;
+
+    len_written = 0;
+    if (!EVP_EncryptFinal_ex(ctx, out->buffer + out->len, &len_written)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+    out->len += len_written;
+
+    if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, AWS_AES_256_GCM_TAG_LEN, out->buffer + out->len)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+    out->len += AWS_AES_256_GCM_TAG_LEN;
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_gcm_seal_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+    (void)allocator;
+
+    EVP_CIPHER_CTX *ctx = s_acquire_gcm_oneshot_ctx();
+    int result = s_gcm_seal_oneshot(ctx, key, nonce, aad, plaintext, out);
+    s_release_gcm_oneshot_ctx(ctx);
+    return result;
+}
+
+static int s_gcm_open_oneshot(
+    EVP_CIPHER_CTX *ctx,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out) {
+
+    if (s_begin_gcm_oneshot(ctx, key, nonce, aad, 0)) {
+        return AWS_OP_ERR;
+    }
+
+    int len_written = 0;
+    if (ciphertext.len &&
+        !EVP_DecryptUpdate(ctx, out->buffer + out->len, &len_written, ciphertext.ptr, (int)ciphertext.len)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+    out->len += len_written;
+
+    /* EVP wants a non-const pointer here, but only reads from it. */
+    if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, (int)tag.len, (void *)tag.ptr)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    len_written = 0;
+    if (EVP_DecryptFinal_ex(ctx, out->buffer + out->len, &len_written) <= 0) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+    out->len += len_written;
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_aes_256_gcm_open_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out) {
+    (void)allocator;
+
+    EVP_CIPHER_CTX *ctx = s_acquire_gcm_oneshot_ctx();
+    int result = s_gcm_open_oneshot(ctx, key, nonce, aad, ciphertext, tag, out);
+    s_release_gcm_oneshot_ctx(ctx);
+    return result;
+}
+
+static int s_key_wrap_encrypt_decrypt(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out) {
+    (void)out;
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+
+    return aws_byte_buf_append_dynamic(&openssl_cipher->working_buffer, &input);
+}
+
+static const size_t MIN_CEK_LENGTH_BYTES = 128 / 8;
+static const unsigned char INTEGRITY_VALUE = 0xA6;
+#define KEYWRAP_BLOCK_SIZE 8u
+
+/* A ^= t, with t as a 64-bit big-endian integer as RFC 3394 specifies. */
+static void s_key_wrap_xor_t(uint8_t *a, uint64_t t) {
+    for (size_t k = 0; k < KEYWRAP_BLOCK_SIZE; ++k) {
+        a[KEYWRAP_BLOCK_SIZE - 1 - k] ^= (uint8_t)(t >> (8 * k));
+    }
+}
+
+static int s_key_wrap_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+
+    if (openssl_cipher->working_buffer.len < MIN_CEK_LENGTH_BYTES) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 1);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    /* the following is an in place implementation of
+       RFC 3394 using the alternate in-place implementation.
+       we use one in-place buffer instead of the copy at the end.
+       the one letter variable names are meant to directly reflect the variables in the RFC */
+    size_t required_buffer_space = openssl_cipher->working_buffer.len + cipher->block_size;
+    size_t starting_len_offset = out->len;
+
+    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, required_buffer_space)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    /* put the integrity check register in the first 8 bytes of the final buffer. */
+    aws_byte_buf_write_u8_n(out, INTEGRITY_VALUE, KEYWRAP_BLOCK_SIZE);
+    uint8_t *a = out->buffer + starting_len_offset;
+
+    struct aws_byte_cursor working_buf_cur = aws_byte_cursor_from_buf(&openssl_cipher->working_buffer);
+    aws_byte_buf_write_from_whole_cursor(out, working_buf_cur);
+
+    /* put the register buffer after the integrity check register */
+    uint8_t *r = out->buffer + starting_len_offset + KEYWRAP_BLOCK_SIZE;
+
+    int n = (int)(openssl_cipher->working_buffer.len / KEYWRAP_BLOCK_SIZE);
 
     uint8_t b_buf[KEYWRAP_BLOCK_SIZE * 2] = {0};
     struct aws_byte_buf b = aws_byte_buf_from_empty_array(b_buf, sizeof(b_buf));
@@ -532,16 +945,14 @@ static int s_key_wrap_finalize_encryption(struct aws_symmetric_cipher *cipher, s
             memcpy(temp_input.buffer + KEYWRAP_BLOCK_SIZE, r, KEYWRAP_BLOCK_SIZE);
 
             /* encrypt the concatenated A and R[I] and store it in B */
-            if (!EVP_EncryptUpdate(
-                    openssl_cipher->encryptor_ctx, b.buffer, &b_out_len, temp_input.buffer, (int)temp_input.capacity)) {
+            if (!EVP_EncryptUpdate(ctx, b.buffer, &b_out_len, temp_input.buffer, (int)temp_input.capacity)) {
                 cipher->good = false;
                 return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
             }
 
-            unsigned char t = (unsigned char)((n * j) + i);
             /* put the 64 MSB ^ T into A */
             memcpy(a, b.buffer, KEYWRAP_BLOCK_SIZE);
-            a[7] ^= t;
+            s_key_wrap_xor_t(a, (uint64_t)n * j + i);
 
             /* put the 64 LSB into R[i] */
             memcpy(r, b.buffer + KEYWRAP_BLOCK_SIZE, KEYWRAP_BLOCK_SIZE);
@@ -563,6 +974,11 @@ static int s_key_wrap_finalize_decryption(struct aws_symmetric_cipher *cipher, s
         return aws_raise_error(AWS_ERROR_INVALID_STATE);
     }
 
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, 0);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
     /* the following is an in place implementation of
        RFC 3394 using the alternate in-place implementation.
        we use one in-place buffer instead of the copy at the end.
@@ -598,14 +1014,12 @@ static int s_key_wrap_finalize_decryption(struct aws_symmetric_cipher *cipher, s
         for (int i = n; i >= 1; --i) {
             /* concat A and T */
             memcpy(temp_input.buffer, a, KEYWRAP_BLOCK_SIZE);
-            unsigned char t = (unsigned char)((n * j) + i);
-            temp_input.buffer[7] ^= t;
+            s_key_wrap_xor_t(temp_input.buffer, (uint64_t)n * j + i);
             /* R[i] */
             memcpy(temp_input.buffer + KEYWRAP_BLOCK_SIZE, r, KEYWRAP_BLOCK_SIZE);
 
             /* Decrypt the concatenated buffer */
-            if (!EVP_DecryptUpdate(
-                    openssl_cipher->decryptor_ctx, b.buffer, &b_out_len, temp_input.buffer, (int)temp_input.capacity)) {
+            if (!EVP_DecryptUpdate(ctx, b.buffer, &b_out_len, temp_input.buffer, (int)temp_input.capacity)) {
                 cipher->good = false;
                 return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
             }
@@ -633,77 +1047,587 @@ static int s_key_wrap_finalize_decryption(struct aws_symmetric_cipher *cipher, s
     return AWS_OP_SUCCESS;
 }
 
-static int s_init_keywrap_cipher_materials(struct aws_symmetric_cipher *cipher) {
+static int s_init_keywrap_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc) {
+    return s_key_ctx(cipher, ctx, OPENSSL_AES_MODE_KEYWRAP, enc);
+}
+
+static struct aws_symmetric_cipher_vtable s_keywrap_vtable = {
+    .alg_name = "AES-KEYWRAP 256",
+    .provider = "OpenSSL Compatible LibCrypto",
+    .destroy = s_destroy,
+    .reset = s_reset,
+    .decrypt = s_key_wrap_encrypt_decrypt,
+    .encrypt = s_key_wrap_encrypt_decrypt,
+    .finalize_decryption = s_key_wrap_finalize_decryption,
+    .finalize_encryption = s_key_wrap_finalize_encryption,
+};
+
+static struct aws_symmetric_cipher *s_aes_keywrap_256_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
+    cipher->cipher_base.allocator = allocator;
+    cipher->cipher_base.block_size = KEYWRAP_BLOCK_SIZE;
+    cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
+    cipher->cipher_base.vtable = &s_keywrap_vtable;
+    cipher->cipher_base.impl = cipher;
+    cipher->init_ctx = s_init_keywrap_ctx;
+
+    /* Copy key into the cipher context. */
+    s_init_key(cipher, key, prepared_key);
+
+    aws_byte_buf_init(&cipher->working_buffer, allocator, KEYWRAP_BLOCK_SIZE);
+
+    cipher->cipher_base.good = true;
+    return &cipher->cipher_base;
+}
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key) {
+    return s_aes_keywrap_256_new(allocator, key, NULL);
+}
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    return s_aes_keywrap_256_new(allocator, NULL, prepared_key);
+}
+
+/* Keys processed together by aws_aes_256_keywrap_batch_impl(). Enough to keep the AES pipeline of any current cpu
+ * busy, while the block buffer still fits comfortably on the stack. */
+#define KEYWRAP_BATCH_LANES 32u
+
+/* RFC 3394 for lane_count keys of len bytes at once. Step (j, i) of every key is independent of the others, so each
+ * step is a single ECB call over one block per key. Output goes straight into each key's span, as in
+ * s_key_wrap_finalize_encryption(); a holds each key's integrity register. */
+static int s_key_wrap_lanes(
+    EVP_CIPHER_CTX *ctx,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t lane_count,
+    bool wrap) {
+
+    size_t len = inputs[0].len;
+    size_t n = wrap ? len / KEYWRAP_BLOCK_SIZE : len / KEYWRAP_BLOCK_SIZE - 1;
+    uint8_t a[KEYWRAP_BATCH_LANES][KEYWRAP_BLOCK_SIZE];
+    uint8_t blocks[KEYWRAP_BATCH_LANES * AWS_AES_256_CIPHER_BLOCK_SIZE];
+    uint8_t *r[KEYWRAP_BATCH_LANES];
+    int ret_val = AWS_OP_ERR;
+
+    for (size_t lane = 0; lane < lane_count; ++lane) {
+        r[lane] = outputs[lane].buffer + outputs[lane].len;
+        if (wrap) {
+            memset(a[lane], INTEGRITY_VALUE, KEYWRAP_BLOCK_SIZE);
+            memcpy(r[lane] + KEYWRAP_BLOCK_SIZE, inputs[lane].ptr, len);
+            /* the integrity register ends up in front of the wrapped key. */
+            r[lane] += KEYWRAP_BLOCK_SIZE;
+        } else {
+            memcpy(a[lane], inputs[lane].ptr, KEYWRAP_BLOCK_SIZE);
+            memcpy(r[lane], inputs[lane].ptr + KEYWRAP_BLOCK_SIZE, len - KEYWRAP_BLOCK_SIZE);
+        }
+    }
+
+    int blocks_len = (int)(lane_count * AWS_AES_256_CIPHER_BLOCK_SIZE);
+    for (size_t step = 0; step < 6 * n; ++step) {
+        /* wrapping runs t = 1 .. 6n forwards, unwrapping runs it backwards. */
+        uint64_t t = wrap ? step + 1 : 6 * n - step;
+        size_t i = (size_t)((t - 1) % n);
+
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+            uint8_t *block = blocks + lane * AWS_AES_256_CIPHER_BLOCK_SIZE;
+            memcpy(block, a[lane], KEYWRAP_BLOCK_SIZE);
+            if (!wrap) {
+                s_key_wrap_xor_t(block, t);
+            }
+            memcpy(block + KEYWRAP_BLOCK_SIZE, r[lane] + i * KEYWRAP_BLOCK_SIZE, KEYWRAP_BLOCK_SIZE);
+        }
+
+        int out_len = blocks_len;
+        if (!EVP_CipherUpdate(ctx, blocks, &out_len, blocks, blocks_len) || out_len != blocks_len) {
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            goto clean_up;
+        }
+
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+            const uint8_t *block = blocks + lane * AWS_AES_256_CIPHER_BLOCK_SIZE;
+            memcpy(a[lane], block, KEYWRAP_BLOCK_SIZE);
+            if (wrap) {
+                s_key_wrap_xor_t(a[lane], t);
+            }
+            memcpy(r[lane] + i * KEYWRAP_BLOCK_SIZE, block + KEYWRAP_BLOCK_SIZE, KEYWRAP_BLOCK_SIZE);
+        }
+    }
+
+    if (wrap) {
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+            memcpy(r[lane] - KEYWRAP_BLOCK_SIZE, a[lane], KEYWRAP_BLOCK_SIZE);
+        }
+    } else {
+        uint8_t difference = 0;
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+            for (size_t k = 0; k < KEYWRAP_BLOCK_SIZE; ++k) {
+                difference |= a[lane][k] ^ INTEGRITY_VALUE;
+            }
+        }
+
+        if (difference) {
+            aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+            goto clean_up;
+        }
+    }
+
+    ret_val = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_secure_zero(a, sizeof(a));
+    aws_secure_zero(blocks, sizeof(blocks));
+    return ret_val;
+}
+
+int aws_aes_256_keywrap_batch_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap) {
+    (void)allocator;
+
+    EVP_CIPHER_CTX *template_ctx = s_get_template(prepared_key, OPENSSL_AES_MODE_KEYWRAP, wrap ? 1 : 0);
+    if (template_ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    /* the template is shared, so the whole batch runs on one private copy of it. */
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    AWS_FATAL_ASSERT(ctx && "Cipher initialization failed!");
+
+    int ret_val = AWS_OP_ERR;
+    if (!EVP_CIPHER_CTX_copy(ctx, template_ctx)) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        goto clean_up;
+    }
+
+    for (size_t start = 0; start < count;) {
+        /* keys of the same length share their step schedule, so each run of them is processed together. */
+        size_t lane_count = 1;
+        while (start + lane_count < count && lane_count < KEYWRAP_BATCH_LANES &&
+               inputs[start + lane_count].len == inputs[start].len) {
+            ++lane_count;
+        }
+
+        if (s_key_wrap_lanes(ctx, inputs + start, outputs + start, lane_count, wrap)) {
+            goto clean_up;
+        }
+
+        start += lane_count;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        outputs[i].len += wrap ? inputs[i].len + KEYWRAP_BLOCK_SIZE : inputs[i].len - KEYWRAP_BLOCK_SIZE;
+    }
+
+    ret_val = AWS_OP_SUCCESS;
+
+clean_up:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret_val;
+}
+
+/* XTS and GCM-SIV both need the whole message at once, so like keywrap, input is buffered until finalize. */
+static int s_buffer_until_finalize(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out) {
+    (void)out;
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+
+    return aws_byte_buf_append_dynamic(&openssl_cipher->working_buffer, &input);
+}
+
+#if defined(AWS_OPENSSL_HAS_AES_XTS)
+
+static int s_init_xts_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc) {
+    if (!EVP_CipherInit_ex(ctx, EVP_aes_256_xts(), NULL, cipher->key.buffer, cipher->iv.buffer, enc)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* EVP treats every update on an XTS context as one complete data unit, which is why the input was held back. */
+static int s_xts_finalize(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out, int enc) {
     struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    struct aws_byte_buf *data_unit = &openssl_cipher->working_buffer;
+
+    /* ciphertext stealing covers a trailing partial block, but there has to be at least one whole block. */
+    if (data_unit->len < AWS_AES_256_CIPHER_BLOCK_SIZE) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    if (data_unit->len > INT_MAX) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_CAL_BUFFER_TOO_LARGE_FOR_ALGORITHM);
+    }
+
+    EVP_CIPHER_CTX *ctx = s_get_ctx(cipher, enc);
+    if (ctx == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    /* a context stays keyed across s_xts_reset_with_tweak(), so the tweak is set for every data unit */
+    if (!EVP_CipherInit_ex(ctx, NULL, NULL, NULL, cipher->iv.buffer, enc)) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
 
-    if (!(EVP_EncryptInit_ex(openssl_cipher->encryptor_ctx, EVP_aes_256_ecb(), NULL, cipher->key.buffer, NULL) &&
-          EVP_CIPHER_CTX_set_padding(openssl_cipher->encryptor_ctx, 0)) ||
-        !(EVP_DecryptInit_ex(openssl_cipher->decryptor_ctx, EVP_aes_256_ecb(), NULL, cipher->key.buffer, NULL) &&
-          EVP_CIPHER_CTX_set_padding(openssl_cipher->decryptor_ctx, 0))) {
+    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, data_unit->len)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    int len_written = (int)data_unit->len;
+    if (!EVP_CipherUpdate(ctx, out->buffer + out->len, &len_written, data_unit->buffer, (int)data_unit->len)) {
         cipher->good = false;
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
+    out->len += len_written;
     return AWS_OP_SUCCESS;
 }
 
-static int s_reset_keywrap_cipher_materials(struct aws_symmetric_cipher *cipher) {
-    int ret_val = s_clear_reusable_state(cipher);
+static int s_xts_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    return s_xts_finalize(cipher, out, 1);
+}
 
-    if (ret_val == AWS_OP_SUCCESS) {
-        return s_init_keywrap_cipher_materials(cipher);
+static int s_xts_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    return s_xts_finalize(cipher, out, 0);
+}
+
+/* Unlike s_reset(), the contexts keep their key schedules, only the tweak and the buffered input change. */
+static int s_xts_reset_with_tweak(struct aws_symmetric_cipher *cipher, const uint8_t *tweak) {
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+
+    memcpy(cipher->iv.buffer, tweak, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    aws_byte_buf_secure_zero(&openssl_cipher->working_buffer);
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_symmetric_cipher_vtable s_xts_vtable = {
+    .alg_name = "AES-XTS 256",
+    .provider = "OpenSSL Compatible LibCrypto",
+    .destroy = s_destroy,
+    .reset = s_reset,
+    .decrypt = s_buffer_until_finalize,
+    .encrypt = s_buffer_until_finalize,
+    .finalize_decryption = s_xts_finalize_decryption,
+    .finalize_encryption = s_xts_finalize_encryption,
+    .reset_with_tweak = s_xts_reset_with_tweak,
+};
+
+struct aws_symmetric_cipher *aws_aes_xts_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
+    struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
+    cipher->cipher_base.allocator = allocator;
+    cipher->cipher_base.block_size = AWS_AES_256_CIPHER_BLOCK_SIZE;
+    cipher->cipher_base.key_length_bits = AWS_AES_256_XTS_KEY_BYTE_LEN * 8;
+    cipher->cipher_base.vtable = &s_xts_vtable;
+    cipher->cipher_base.impl = cipher;
+    cipher->init_ctx = s_init_xts_ctx;
+
+    if (key) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, secure_allocator, *key);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.key, secure_allocator, AWS_AES_256_XTS_KEY_BYTE_LEN);
+        aws_symmetric_cipher_generate_key(AWS_AES_256_XTS_KEY_BYTE_LEN, &cipher->cipher_base.key);
     }
 
-    return ret_val;
+    if (tweak) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, secure_allocator, *tweak);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.iv, secure_allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+        aws_symmetric_cipher_generate_initialization_vector(
+            AWS_AES_256_CIPHER_BLOCK_SIZE, false, &cipher->cipher_base.iv);
+    }
+
+    aws_byte_buf_init(&cipher->working_buffer, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+
+    cipher->cipher_base.good = true;
+    return &cipher->cipher_base;
 }
 
-static struct aws_symmetric_cipher_vtable s_keywrap_vtable = {
-    .alg_name = "AES-KEYWRAP 256",
+#else
+
+struct aws_symmetric_cipher *aws_aes_xts_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak) {
+    (void)allocator;
+    (void)key;
+    (void)tweak;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+#endif /* AWS_OPENSSL_HAS_AES_XTS */
+
+#if defined(AWS_OPENSSL_HAS_AES_GCM_SIV)
+
+/* One-shot EVP_AEAD calls, keyed per message. GCM-SIV derives fresh keys from every nonce anyway. */
+static int s_gcm_siv_finalize(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out, bool enc) {
+    struct openssl_aes_cipher *openssl_cipher = cipher->impl;
+    struct aws_byte_buf *input = &openssl_cipher->working_buffer;
+
+    if (!enc && cipher->tag.len != AWS_AES_256_GCM_TAG_LEN) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, input->len)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    EVP_AEAD_CTX aead_ctx;
+    EVP_AEAD_CTX_zero(&aead_ctx);
+    if (!EVP_AEAD_CTX_init(
+            &aead_ctx,
+            EVP_aead_aes_256_gcm_siv(),
+            cipher->key.buffer,
+            cipher->key.len,
+            AWS_AES_256_GCM_TAG_LEN,
+            NULL)) {
+        cipher->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint8_t *dest = out->buffer + out->len;
+    int success = 0;
+    if (enc) {
+        size_t tag_len = 0;
+        success = EVP_AEAD_CTX_seal_scatter(
+            &aead_ctx,
+            dest,
+            cipher->tag.buffer,
+            &tag_len,
+            cipher->tag.capacity,
+            cipher->iv.buffer,
+            cipher->iv.len,
+            input->buffer,
+            input->len,
+            NULL,
+            0,
+            cipher->aad.buffer,
+            cipher->aad.len);
+        cipher->tag.len = success ? tag_len : 0;
+    } else {
+        success = EVP_AEAD_CTX_open_gather(
+            &aead_ctx,
+            dest,
+            cipher->iv.buffer,
+            cipher->iv.len,
+            input->buffer,
+            input->len,
+            cipher->tag.buffer,
+            cipher->tag.len,
+            cipher->aad.buffer,
+            cipher->aad.len);
+    }
+
+    EVP_AEAD_CTX_cleanup(&aead_ctx);
+
+    if (!success) {
+        /* never hand back plaintext that failed verification. */
+        aws_secure_zero(dest, input->len);
+        cipher->good = false;
+        return aws_raise_error(enc ? AWS_ERROR_INVALID_ARGUMENT : AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    out->len += input->len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_gcm_siv_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    return s_gcm_siv_finalize(cipher, out, true);
+}
+
+static int s_gcm_siv_finalize_decryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
+    return s_gcm_siv_finalize(cipher, out, false);
+}
+
+static struct aws_symmetric_cipher_vtable s_gcm_siv_vtable = {
+    .alg_name = "AES-GCM-SIV 256",
     .provider = "OpenSSL Compatible LibCrypto",
     .destroy = s_destroy,
-    .reset = s_reset_keywrap_cipher_materials,
-    .decrypt = s_key_wrap_encrypt_decrypt,
-    .encrypt = s_key_wrap_encrypt_decrypt,
-    .finalize_decryption = s_key_wrap_finalize_decryption,
-    .finalize_encryption = s_key_wrap_finalize_encryption,
+    .reset = s_reset,
+    .decrypt = s_buffer_until_finalize,
+    .encrypt = s_buffer_until_finalize,
+    .finalize_decryption = s_gcm_siv_finalize_decryption,
+    .finalize_encryption = s_gcm_siv_finalize_encryption,
 };
 
-struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
+struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new_impl(
     struct aws_allocator *allocator,
-    const struct aws_byte_cursor *key) {
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
     struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
     cipher->cipher_base.allocator = allocator;
-    cipher->cipher_base.block_size = KEYWRAP_BLOCK_SIZE;
+    cipher->cipher_base.block_size = AWS_AES_256_CIPHER_BLOCK_SIZE;
     cipher->cipher_base.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
-    cipher->cipher_base.vtable = &s_keywrap_vtable;
+    cipher->cipher_base.vtable = &s_gcm_siv_vtable;
     cipher->cipher_base.impl = cipher;
 
-    /* Copy key into the cipher context. */
-    if (key) {
-        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, allocator, *key);
+    s_init_key(cipher, key, NULL);
+
+    if (iv) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, secure_allocator, *iv);
     } else {
-        aws_byte_buf_init(&cipher->cipher_base.key, allocator, AWS_AES_256_KEY_BYTE_LEN);
-        aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cipher->cipher_base.key);
+        aws_byte_buf_init(&cipher->cipher_base.iv, secure_allocator, AWS_AES_256_GCM_NONCE_LEN);
+        aws_symmetric_cipher_generate_initialization_vector(
+            AWS_AES_256_GCM_NONCE_LEN, false, &cipher->cipher_base.iv);
     }
 
-    aws_byte_buf_init(&cipher->working_buffer, allocator, KEYWRAP_BLOCK_SIZE);
+    if (aad) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.aad, allocator, *aad);
+    }
+
+    if (decryption_tag) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.tag, allocator, *decryption_tag);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.tag, allocator, AWS_AES_256_GCM_TAG_LEN);
+    }
+
+    aws_byte_buf_init(&cipher->working_buffer, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+
+    cipher->cipher_base.good = true;
+    return &cipher->cipher_base;
+}
+
+#else
+
+struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+#endif /* AWS_OPENSSL_HAS_AES_GCM_SIV */
+
+#if defined(AWS_OPENSSL_HAS_CHACHA20_POLY1305)
+
+/* The ChaCha20 block size, only used for the input size limit. EVP reports 1, like the other stream modes. */
+#    define CHACHA20_BLOCK_SIZE 64u
+
+static int s_init_chacha20_poly1305_ctx(struct aws_symmetric_cipher *cipher, EVP_CIPHER_CTX *ctx, int enc) {
+    if (!EVP_CipherInit_ex(ctx, EVP_chacha20_poly1305(), NULL, cipher->key.buffer, cipher->iv.buffer, enc)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (cipher->aad.len) {
+        int outLen = 0;
+        if (!EVP_CipherUpdate(ctx, NULL, &outLen, cipher->aad.buffer, (int)cipher->aad.len)) {
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        }
+    }
 
-    /* Initialize the cipher contexts. */
-    cipher->encryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->encryptor_ctx && "Encryptor cipher initialization failed!");
+    if (!enc && cipher->tag.len) {
+        if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, (int)cipher->tag.len, cipher->tag.buffer)) {
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        }
+    }
 
-    cipher->decryptor_ctx = EVP_CIPHER_CTX_new();
-    AWS_FATAL_ASSERT(cipher->decryptor_ctx && "Decryptor cipher initialization failed!");
+    return AWS_OP_SUCCESS;
+}
+
+/* EVP_CTRL_GCM_GET_TAG is the same control as EVP_CTRL_AEAD_GET_TAG, so GCM's finalize fetches this tag as well. */
+static struct aws_symmetric_cipher_vtable s_chacha20_poly1305_vtable = {
+    .alg_name = "ChaCha20-Poly1305",
+    .provider = "OpenSSL Compatible LibCrypto",
+    .destroy = s_destroy,
+    .reset = s_reset,
+    .decrypt = s_decrypt,
+    .encrypt = s_encrypt,
+    .decrypt_vectored = s_decrypt_vectored,
+    .encrypt_vectored = s_encrypt_vectored,
+    .finalize_decryption = s_finalize_decryption,
+    .finalize_encryption = s_finalize_gcm_encryption,
+};
+
+struct aws_symmetric_cipher *aws_chacha20_poly1305_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(allocator);
+    struct openssl_aes_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct openssl_aes_cipher));
+    cipher->cipher_base.allocator = allocator;
+    cipher->cipher_base.block_size = CHACHA20_BLOCK_SIZE;
+    cipher->cipher_base.key_length_bits = AWS_CHACHA20_POLY1305_KEY_BYTE_LEN * 8;
+    cipher->cipher_base.vtable = &s_chacha20_poly1305_vtable;
+    cipher->cipher_base.impl = cipher;
+    cipher->init_ctx = s_init_chacha20_poly1305_ctx;
 
-    /* Initialize the cipher contexts with the specified key and IV. */
-    if (s_init_keywrap_cipher_materials(&cipher->cipher_base)) {
-        goto error;
+    if (key) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.key, secure_allocator, *key);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.key, secure_allocator, AWS_CHACHA20_POLY1305_KEY_BYTE_LEN);
+        aws_symmetric_cipher_generate_key(AWS_CHACHA20_POLY1305_KEY_BYTE_LEN, &cipher->cipher_base.key);
+    }
+
+    if (iv) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.iv, secure_allocator, *iv);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.iv, secure_allocator, AWS_CHACHA20_POLY1305_NONCE_LEN);
+        aws_symmetric_cipher_generate_initialization_vector(
+            AWS_CHACHA20_POLY1305_NONCE_LEN, false, &cipher->cipher_base.iv);
+    }
+
+    if (aad) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.aad, allocator, *aad);
+    }
+
+    if (decryption_tag) {
+        aws_byte_buf_init_copy_from_cursor(&cipher->cipher_base.tag, allocator, *decryption_tag);
+    } else {
+        aws_byte_buf_init(&cipher->cipher_base.tag, allocator, AWS_CHACHA20_POLY1305_TAG_LEN);
     }
 
     cipher->cipher_base.good = true;
     return &cipher->cipher_base;
+}
+
+#else
 
-error:
-    s_destroy(&cipher->cipher_base);
+struct aws_symmetric_cipher *aws_chacha20_poly1305_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
     return NULL;
 }
+
+#endif /* AWS_OPENSSL_HAS_CHACHA20_POLY1305 */
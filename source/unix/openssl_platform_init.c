@@ -10,23 +10,32 @@
 #include <aws/common/thread.h>
 
 #include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <aws/cal/private/opensslcrypto_common.h>
 
 #include <openssl/crypto.h>
 
-static struct openssl_hmac_ctx_table hmac_ctx_table;
-static struct openssl_evp_md_ctx_table evp_md_ctx_table;
-
 struct openssl_hmac_ctx_table *g_aws_openssl_hmac_ctx_table = NULL;
 struct openssl_evp_md_ctx_table *g_aws_openssl_evp_md_ctx_table = NULL;
 
 static struct aws_allocator *s_libcrypto_allocator = NULL;
 
+/* see openssl_aes.c */
+extern void aws_openssl_aes_thread_clean_up(void);
+
 #if !defined(OPENSSL_IS_AWSLC) && !defined(OPENSSL_IS_BORINGSSL)
 #    define OPENSSL_IS_OPENSSL
 #endif
 
+/* DIRECT_LIBCRYPTO builds call libcrypto straight from the hash and HMAC code, there is nothing to resolve */
+#if !defined(AWS_CAL_DIRECT_LIBCRYPTO)
+
+static struct openssl_hmac_ctx_table hmac_ctx_table;
+static struct openssl_evp_md_ctx_table evp_md_ctx_table;
+
 /* weak refs to libcrypto functions to force them to at least try to link
  * and avoid dead-stripping
  */
@@ -38,6 +47,7 @@ extern void HMAC_CTX_cleanup(HMAC_CTX *) __attribute__((weak, used));
 extern int HMAC_Update(HMAC_CTX *, const unsigned char *, size_t) __attribute__((weak, used));
 extern int HMAC_Final(HMAC_CTX *, unsigned char *, unsigned int *) __attribute__((weak, used));
 extern int HMAC_Init_ex(HMAC_CTX *, const void *, size_t, const EVP_MD *, ENGINE *) __attribute__((weak, used));
+extern int HMAC_CTX_copy(HMAC_CTX *, const HMAC_CTX *) __attribute__((weak, used));
 
 static int s_hmac_init_ex_bssl(HMAC_CTX *ctx, const void *key, size_t key_len, const EVP_MD *md, ENGINE *impl) {
     AWS_PRECONDITION(ctx);
@@ -48,6 +58,17 @@ static int s_hmac_init_ex_bssl(HMAC_CTX *ctx, const void *key, size_t key_len, c
     return init_ex_pt(ctx, key, key_len, md, impl);
 }
 
+static int s_hmac_ctx_copy_bssl(HMAC_CTX *dest, HMAC_CTX *src) {
+    AWS_PRECONDITION(dest);
+    AWS_PRECONDITION(src);
+
+    /* aws-lc and boringssl take the source as const */
+    int (*copy_ptr)(HMAC_CTX *, const HMAC_CTX *) =
+        (int (*)(HMAC_CTX *, const HMAC_CTX *))g_aws_openssl_hmac_ctx_table->impl.copy_fn;
+
+    return copy_ptr(dest, src);
+}
+
 #else
 /* 1.1 */
 extern HMAC_CTX *HMAC_CTX_new(void) __attribute__((weak, used));
@@ -61,6 +82,7 @@ extern void HMAC_CTX_cleanup(HMAC_CTX *) __attribute__((weak, used));
 extern int HMAC_Update(HMAC_CTX *, const unsigned char *, size_t) __attribute__((weak, used));
 extern int HMAC_Final(HMAC_CTX *, unsigned char *, unsigned int *) __attribute__((weak, used));
 extern int HMAC_Init_ex(HMAC_CTX *, const void *, int, const EVP_MD *, ENGINE *) __attribute__((weak, used));
+extern int HMAC_CTX_copy(HMAC_CTX *, HMAC_CTX *) __attribute__((weak, used));
 
 static int s_hmac_init_ex_openssl(HMAC_CTX *ctx, const void *key, size_t key_len, const EVP_MD *md, ENGINE *impl) {
     AWS_PRECONDITION(ctx);
@@ -129,6 +151,7 @@ bool s_resolve_hmac_102(void *module) {
     hmac_update update_fn = (hmac_update)HMAC_Update;
     hmac_final final_fn = (hmac_final)HMAC_Final;
     hmac_init_ex init_ex_fn = (hmac_init_ex)HMAC_Init_ex;
+    hmac_ctx_copy copy_fn = (hmac_ctx_copy)HMAC_CTX_copy;
 
     /* were symbols bound by static linking? */
     bool has_102_symbols = init_fn && clean_up_fn && update_fn && final_fn && init_ex_fn;
@@ -141,6 +164,7 @@ bool s_resolve_hmac_102(void *module) {
         *(void **)(&update_fn) = dlsym(module, "HMAC_Update");
         *(void **)(&final_fn) = dlsym(module, "HMAC_Final");
         *(void **)(&init_ex_fn) = dlsym(module, "HMAC_Init_ex");
+        *(void **)(&copy_fn) = dlsym(module, "HMAC_CTX_copy");
         if (init_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic libcrypto 1.0.2 HMAC symbols");
         }
@@ -153,6 +177,7 @@ bool s_resolve_hmac_102(void *module) {
         hmac_ctx_table.clean_up_fn = clean_up_fn;
         hmac_ctx_table.update_fn = update_fn;
         hmac_ctx_table.final_fn = final_fn;
+        hmac_ctx_table.copy_fn = copy_fn;
         hmac_ctx_table.init_ex_fn = init_ex_fn;
         g_aws_openssl_hmac_ctx_table = &hmac_ctx_table;
         return true;
@@ -168,6 +193,7 @@ bool s_resolve_hmac_111(void *module) {
     hmac_update update_fn = (hmac_update)HMAC_Update;
     hmac_final final_fn = (hmac_final)HMAC_Final;
     hmac_init_ex init_ex_fn = (hmac_init_ex)HMAC_Init_ex;
+    hmac_ctx_copy copy_fn = (hmac_ctx_copy)HMAC_CTX_copy;
 
     /* were symbols bound by static linking? */
     bool has_111_symbols = new_fn && free_fn && update_fn && final_fn && init_ex_fn;
@@ -180,6 +206,7 @@ bool s_resolve_hmac_111(void *module) {
         *(void **)(&update_fn) = dlsym(module, "HMAC_Update");
         *(void **)(&final_fn) = dlsym(module, "HMAC_Final");
         *(void **)(&init_ex_fn) = dlsym(module, "HMAC_Init_ex");
+        *(void **)(&copy_fn) = dlsym(module, "HMAC_CTX_copy");
         if (new_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic libcrypto 1.1.1 HMAC symbols");
         }
@@ -192,6 +219,7 @@ bool s_resolve_hmac_111(void *module) {
         hmac_ctx_table.clean_up_fn = s_hmac_ctx_clean_up_noop;
         hmac_ctx_table.update_fn = update_fn;
         hmac_ctx_table.final_fn = final_fn;
+        hmac_ctx_table.copy_fn = copy_fn;
         hmac_ctx_table.init_ex_fn = s_hmac_init_ex_openssl;
         hmac_ctx_table.impl.init_ex_fn = (crypto_generic_fn_ptr)init_ex_fn;
         g_aws_openssl_hmac_ctx_table = &hmac_ctx_table;
@@ -210,6 +238,7 @@ bool s_resolve_hmac_lc(void *module) {
     hmac_update update_fn = (hmac_update)HMAC_Update;
     hmac_final final_fn = (hmac_final)HMAC_Final;
     hmac_init_ex init_ex_fn = (hmac_init_ex)HMAC_Init_ex;
+    crypto_generic_fn_ptr copy_fn = (crypto_generic_fn_ptr)HMAC_CTX_copy;
 
     /* were symbols bound by static linking? */
     bool has_awslc_symbols = new_fn && free_fn && update_fn && final_fn && init_fn && init_ex_fn;
@@ -225,6 +254,7 @@ bool s_resolve_hmac_lc(void *module) {
         *(void **)(&update_fn) = dlsym(module, "HMAC_Update");
         *(void **)(&final_fn) = dlsym(module, "HMAC_Final");
         *(void **)(&init_ex_fn) = dlsym(module, "HMAC_Init_ex");
+        *(void **)(&copy_fn) = dlsym(module, "HMAC_CTX_copy");
         if (new_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic aws-lc HMAC symbols");
         }
@@ -238,8 +268,10 @@ bool s_resolve_hmac_lc(void *module) {
         hmac_ctx_table.clean_up_fn = clean_up_fn;
         hmac_ctx_table.update_fn = update_fn;
         hmac_ctx_table.final_fn = final_fn;
+        hmac_ctx_table.copy_fn = s_hmac_ctx_copy_bssl;
         hmac_ctx_table.init_ex_fn = s_hmac_init_ex_bssl;
         hmac_ctx_table.impl.init_ex_fn = (crypto_generic_fn_ptr)init_ex_fn;
+        hmac_ctx_table.impl.copy_fn = copy_fn;
         g_aws_openssl_hmac_ctx_table = &hmac_ctx_table;
         return true;
     }
@@ -254,6 +286,7 @@ bool s_resolve_hmac_boringssl(void *module) {
     hmac_update update_fn = (hmac_update)HMAC_Update;
     hmac_final final_fn = (hmac_final)HMAC_Final;
     hmac_init_ex init_ex_fn = (hmac_init_ex)HMAC_Init_ex;
+    crypto_generic_fn_ptr copy_fn = (crypto_generic_fn_ptr)HMAC_CTX_copy;
 
     /* were symbols bound by static linking? */
     bool has_bssl_symbols = new_fn && free_fn && update_fn && final_fn && init_ex_fn;
@@ -266,6 +299,7 @@ bool s_resolve_hmac_boringssl(void *module) {
         *(void **)(&update_fn) = dlsym(module, "HMAC_Update");
         *(void **)(&final_fn) = dlsym(module, "HMAC_Final");
         *(void **)(&init_ex_fn) = dlsym(module, "HMAC_Init_ex");
+        *(void **)(&copy_fn) = dlsym(module, "HMAC_CTX_copy");
         if (new_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic boringssl HMAC symbols");
         }
@@ -278,8 +312,10 @@ bool s_resolve_hmac_boringssl(void *module) {
         hmac_ctx_table.clean_up_fn = s_hmac_ctx_clean_up_noop;
         hmac_ctx_table.update_fn = update_fn;
         hmac_ctx_table.final_fn = final_fn;
+        hmac_ctx_table.copy_fn = s_hmac_ctx_copy_bssl;
         hmac_ctx_table.init_ex_fn = s_hmac_init_ex_bssl;
         hmac_ctx_table.impl.init_ex_fn = (crypto_generic_fn_ptr)init_ex_fn;
+        hmac_ctx_table.impl.copy_fn = copy_fn;
         g_aws_openssl_hmac_ctx_table = &hmac_ctx_table;
         return true;
     }
@@ -333,6 +369,26 @@ extern void EVP_MD_CTX_free(EVP_MD_CTX *) __attribute__((weak, used));
 extern int EVP_DigestInit_ex(EVP_MD_CTX *, const EVP_MD *, ENGINE *) __attribute__((weak, used));
 extern int EVP_DigestUpdate(EVP_MD_CTX *, const void *, size_t) __attribute__((weak, used));
 extern int EVP_DigestFinal_ex(EVP_MD_CTX *, unsigned char *, unsigned int *) __attribute__((weak, used));
+extern int EVP_MD_CTX_copy_ex(EVP_MD_CTX *, const EVP_MD_CTX *) __attribute__((weak, used));
+
+#if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL)
+/* EVP_MD_CTX is a public struct here */
+static void *s_md_ctx_md_data(const EVP_MD_CTX *ctx) {
+    return ctx->md_data;
+}
+#else
+/* 3.0 renamed this to EVP_MD_CTX_get0_md_data(), keeping the old name as a macro */
+#    if defined(EVP_MD_CTX_md_data)
+#        pragma push_macro("EVP_MD_CTX_md_data")
+#        undef EVP_MD_CTX_md_data
+#    endif
+extern void *EVP_MD_CTX_md_data(const EVP_MD_CTX *) __attribute__((weak, used));
+static evp_md_ctx_md_data s_EVP_MD_CTX_md_data = EVP_MD_CTX_md_data;
+#    if defined(EVP_MD_CTX_md_data)
+#        pragma pop_macro("EVP_MD_CTX_md_data")
+#    endif
+extern void *EVP_MD_CTX_get0_md_data(const EVP_MD_CTX *) __attribute__((weak, used));
+#endif
 
 bool s_resolve_md_102(void *module) {
 #if !defined(OPENSSL_IS_AWSLC)
@@ -341,8 +397,10 @@ bool s_resolve_md_102(void *module) {
     evp_md_ctx_digest_init_ex md_init_ex_fn = EVP_DigestInit_ex;
     evp_md_ctx_digest_update md_update_fn = EVP_DigestUpdate;
     evp_md_ctx_digest_final_ex md_final_ex_fn = EVP_DigestFinal_ex;
+    evp_md_ctx_copy_ex md_copy_ex_fn = EVP_MD_CTX_copy_ex;
 
-    bool has_102_symbols = md_create_fn && md_destroy_fn && md_init_ex_fn && md_update_fn && md_final_ex_fn;
+    bool has_102_symbols =
+        md_create_fn && md_destroy_fn && md_init_ex_fn && md_update_fn && md_final_ex_fn && md_copy_ex_fn;
 
     if (has_102_symbols) {
         AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found static libcrypto 1.0.2 EVP_MD symbols");
@@ -352,6 +410,7 @@ bool s_resolve_md_102(void *module) {
         *(void **)(&md_init_ex_fn) = dlsym(module, "EVP_DigestInit_ex");
         *(void **)(&md_update_fn) = dlsym(module, "EVP_DigestUpdate");
         *(void **)(&md_final_ex_fn) = dlsym(module, "EVP_DigestFinal_ex");
+        *(void **)(&md_copy_ex_fn) = dlsym(module, "EVP_MD_CTX_copy_ex");
         if (md_create_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic libcrypto 1.0.2 EVP_MD symbols");
         }
@@ -363,6 +422,8 @@ bool s_resolve_md_102(void *module) {
         evp_md_ctx_table.init_ex_fn = md_init_ex_fn;
         evp_md_ctx_table.update_fn = md_update_fn;
         evp_md_ctx_table.final_ex_fn = md_final_ex_fn;
+        evp_md_ctx_table.copy_ex_fn = md_copy_ex_fn;
+        evp_md_ctx_table.md_data_fn = NULL;
         g_aws_openssl_evp_md_ctx_table = &evp_md_ctx_table;
         return true;
     }
@@ -377,8 +438,15 @@ bool s_resolve_md_111(void *module) {
     evp_md_ctx_digest_init_ex md_init_ex_fn = EVP_DigestInit_ex;
     evp_md_ctx_digest_update md_update_fn = EVP_DigestUpdate;
     evp_md_ctx_digest_final_ex md_final_ex_fn = EVP_DigestFinal_ex;
+    evp_md_ctx_copy_ex md_copy_ex_fn = EVP_MD_CTX_copy_ex;
+#    if defined(OPENSSL_IS_BORINGSSL)
+    evp_md_ctx_md_data md_data_fn = s_md_ctx_md_data;
+#    else
+    evp_md_ctx_md_data md_data_fn = s_EVP_MD_CTX_md_data ? s_EVP_MD_CTX_md_data : EVP_MD_CTX_get0_md_data;
+#    endif
 
-    bool has_111_symbols = md_new_fn && md_free_fn && md_init_ex_fn && md_update_fn && md_final_ex_fn;
+    bool has_111_symbols =
+        md_new_fn && md_free_fn && md_init_ex_fn && md_update_fn && md_final_ex_fn && md_copy_ex_fn;
     if (has_111_symbols) {
         AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found static libcrypto 1.1.1 EVP_MD symbols");
     } else {
@@ -387,6 +455,13 @@ bool s_resolve_md_111(void *module) {
         *(void **)(&md_init_ex_fn) = dlsym(module, "EVP_DigestInit_ex");
         *(void **)(&md_update_fn) = dlsym(module, "EVP_DigestUpdate");
         *(void **)(&md_final_ex_fn) = dlsym(module, "EVP_DigestFinal_ex");
+        *(void **)(&md_copy_ex_fn) = dlsym(module, "EVP_MD_CTX_copy_ex");
+#    if !defined(OPENSSL_IS_BORINGSSL)
+        *(void **)(&md_data_fn) = dlsym(module, "EVP_MD_CTX_md_data");
+        if (!md_data_fn) {
+            *(void **)(&md_data_fn) = dlsym(module, "EVP_MD_CTX_get0_md_data");
+        }
+#    endif
         if (md_new_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic libcrypto 1.1.1 EVP_MD symbols");
         }
@@ -398,6 +473,8 @@ bool s_resolve_md_111(void *module) {
         evp_md_ctx_table.init_ex_fn = md_init_ex_fn;
         evp_md_ctx_table.update_fn = md_update_fn;
         evp_md_ctx_table.final_ex_fn = md_final_ex_fn;
+        evp_md_ctx_table.copy_ex_fn = md_copy_ex_fn;
+        evp_md_ctx_table.md_data_fn = md_data_fn;
         g_aws_openssl_evp_md_ctx_table = &evp_md_ctx_table;
         return true;
     }
@@ -414,9 +491,10 @@ bool s_resolve_md_lc(void *module) {
     evp_md_ctx_digest_init_ex md_init_ex_fn = EVP_DigestInit_ex;
     evp_md_ctx_digest_update md_update_fn = EVP_DigestUpdate;
     evp_md_ctx_digest_final_ex md_final_ex_fn = EVP_DigestFinal_ex;
+    evp_md_ctx_copy_ex md_copy_ex_fn = EVP_MD_CTX_copy_ex;
 
-    bool has_awslc_symbols =
-        md_new_fn && md_create_fn && md_free_fn && md_destroy_fn && md_init_ex_fn && md_update_fn && md_final_ex_fn;
+    bool has_awslc_symbols = md_new_fn && md_create_fn && md_free_fn && md_destroy_fn && md_init_ex_fn &&
+                             md_update_fn && md_final_ex_fn && md_copy_ex_fn;
 
     if (has_awslc_symbols) {
         AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found static aws-lc libcrypto 1.1.1 EVP_MD symbols");
@@ -426,6 +504,7 @@ bool s_resolve_md_lc(void *module) {
         *(void **)(&md_init_ex_fn) = dlsym(module, "EVP_DigestInit_ex");
         *(void **)(&md_update_fn) = dlsym(module, "EVP_DigestUpdate");
         *(void **)(&md_final_ex_fn) = dlsym(module, "EVP_DigestFinal_ex");
+        *(void **)(&md_copy_ex_fn) = dlsym(module, "EVP_MD_CTX_copy_ex");
         if (md_new_fn) {
             AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "found dynamic aws-lc libcrypto 1.1.1 EVP_MD symbols");
         }
@@ -438,6 +517,8 @@ bool s_resolve_md_lc(void *module) {
         evp_md_ctx_table.init_ex_fn = md_init_ex_fn;
         evp_md_ctx_table.update_fn = md_update_fn;
         evp_md_ctx_table.final_ex_fn = md_final_ex_fn;
+        evp_md_ctx_table.copy_ex_fn = md_copy_ex_fn;
+        evp_md_ctx_table.md_data_fn = s_md_ctx_md_data;
         g_aws_openssl_evp_md_ctx_table = &evp_md_ctx_table;
         return true;
     }
@@ -482,16 +563,21 @@ static enum aws_libcrypto_version s_resolve_libcrypto_symbols(enum aws_libcrypto
     return found_version;
 }
 
-static enum aws_libcrypto_version s_resolve_libcrypto_lib(void) {
-    const char *libcrypto_102 = "libcrypto.so.1.0.0";
-    const char *libcrypto_111 = "libcrypto.so.1.1";
+static const char *s_libcrypto_102 = "libcrypto.so.1.0.0";
+static const char *s_libcrypto_111 = "libcrypto.so.1.1";
+static const char *s_libcrypto_unversioned = "libcrypto.so";
+
+/* the shared library the symbols were resolved from, NULL when they came from the process itself */
+static const char *s_resolved_library = NULL;
 
+static enum aws_libcrypto_version s_resolve_libcrypto_lib(void) {
     AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "loading libcrypto 1.0.2");
-    void *module = dlopen(libcrypto_102, RTLD_NOW);
+    void *module = dlopen(s_libcrypto_102, RTLD_NOW);
     if (module) {
         AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "resolving against libcrypto 1.0.2");
         enum aws_libcrypto_version result = s_resolve_libcrypto_symbols(AWS_LIBCRYPTO_1_0_2, module);
         if (result == AWS_LIBCRYPTO_1_0_2) {
+            s_resolved_library = s_libcrypto_102;
             return result;
         }
         dlclose(module);
@@ -500,11 +586,12 @@ static enum aws_libcrypto_version s_resolve_libcrypto_lib(void) {
     }
 
     AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "loading libcrypto 1.1.1");
-    module = dlopen(libcrypto_111, RTLD_NOW);
+    module = dlopen(s_libcrypto_111, RTLD_NOW);
     if (module) {
         AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "resolving against libcrypto 1.1.1");
         enum aws_libcrypto_version result = s_resolve_libcrypto_symbols(AWS_LIBCRYPTO_1_1_1, module);
         if (result == AWS_LIBCRYPTO_1_1_1) {
+            s_resolved_library = s_libcrypto_111;
             return result;
         }
         dlclose(module);
@@ -513,7 +600,7 @@ static enum aws_libcrypto_version s_resolve_libcrypto_lib(void) {
     }
 
     AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "loading libcrypto.so");
-    module = dlopen("libcrypto.so", RTLD_NOW);
+    module = dlopen(s_libcrypto_unversioned, RTLD_NOW);
     if (module) {
         unsigned long (*openssl_version_num)(void) = NULL;
         *(void **)(&openssl_version_num) = dlsym(module, "OpenSSL_version_num");
@@ -535,6 +622,7 @@ static enum aws_libcrypto_version s_resolve_libcrypto_lib(void) {
                 AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "libcrypto.so reported version is unsupported");
             }
             if (result != AWS_LIBCRYPTO_NONE) {
+                s_resolved_library = s_libcrypto_unversioned;
                 return result;
             }
         } else {
@@ -548,9 +636,84 @@ static enum aws_libcrypto_version s_resolve_libcrypto_lib(void) {
     return AWS_LIBCRYPTO_NONE;
 }
 
-static void *s_libcrypto_module = NULL;
+/*
+ * AWS_CAL_LIBCRYPTO_HINT names the libcrypto to resolve against as "<version>" for symbols linked into the process,
+ * or "<version>:<library>" for one of the shared libraries probed below. When it works, none of the other candidates
+ * are tried. The library only ever reads it: a tool that wants its child processes to skip probing exports it
+ * itself before starting them.
+ */
+static const char *s_libcrypto_hint_env = "AWS_CAL_LIBCRYPTO_HINT";
+
+/* AWS_CAL_LIBCRYPTO_RESOLVE=lazy defers resolving from aws_cal_library_init() to the first hash or HMAC created */
+static const char *s_libcrypto_resolve_env = "AWS_CAL_LIBCRYPTO_RESOLVE";
+
+static const char *s_libcrypto_version_names[] = {
+    [AWS_LIBCRYPTO_1_0_2] = "1.0.2",
+    [AWS_LIBCRYPTO_1_1_1] = "1.1.1",
+    [AWS_LIBCRYPTO_LC] = "aws-lc",
+    [AWS_LIBCRYPTO_BORINGSSL] = "boringssl",
+};
+
+static enum aws_libcrypto_version s_resolve_libcrypto_from_hint(const char *hint) {
+    const char *separator = strchr(hint, ':');
+    size_t version_len = separator ? (size_t)(separator - hint) : strlen(hint);
+    const char *library = separator ? separator + 1 : NULL;
+
+    enum aws_libcrypto_version version = AWS_LIBCRYPTO_NONE;
+    for (size_t i = AWS_LIBCRYPTO_1_0_2; i < AWS_ARRAY_SIZE(s_libcrypto_version_names); ++i) {
+        if (strlen(s_libcrypto_version_names[i]) == version_len &&
+            strncmp(s_libcrypto_version_names[i], hint, version_len) == 0) {
+            version = (enum aws_libcrypto_version)i;
+        }
+    }
+
+    if (version == AWS_LIBCRYPTO_NONE) {
+        AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "ignoring libcrypto hint with unknown version \"%s\"", hint);
+        return AWS_LIBCRYPTO_NONE;
+    }
+
+    /* only libraries we would have probed anyway, the hint is a shortcut and not a way to load arbitrary code */
+    const char *known_libraries[] = {s_libcrypto_102, s_libcrypto_111, s_libcrypto_unversioned};
+    const char *hinted_library = NULL;
+    for (size_t i = 0; library && i < AWS_ARRAY_SIZE(known_libraries); ++i) {
+        if (strcmp(known_libraries[i], library) == 0) {
+            hinted_library = known_libraries[i];
+        }
+    }
+
+    if (library && !hinted_library) {
+        AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "ignoring libcrypto hint with unknown library \"%s\"", hint);
+        return AWS_LIBCRYPTO_NONE;
+    }
+
+    AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "resolving libcrypto from hint \"%s\"", hint);
+    void *module = dlopen(hinted_library, RTLD_NOW);
+    if (!module) {
+        return AWS_LIBCRYPTO_NONE;
+    }
+
+    enum aws_libcrypto_version result = s_resolve_libcrypto_symbols(version, module);
+    if (result == AWS_LIBCRYPTO_NONE || !hinted_library) {
+        dlclose(module);
+    }
+
+    s_resolved_library = hinted_library;
+    return result;
+}
 
 static enum aws_libcrypto_version s_resolve_libcrypto(void) {
+    s_resolved_library = NULL;
+
+    const char *hint = getenv(s_libcrypto_hint_env);
+    if (hint) {
+        enum aws_libcrypto_version result = s_resolve_libcrypto_from_hint(hint);
+        if (result != AWS_LIBCRYPTO_NONE) {
+            return result;
+        }
+        AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "libcrypto hint did not resolve, falling back to probing");
+        s_resolved_library = NULL;
+    }
+
     /* Try to auto-resolve against what's linked in/process space */
     AWS_LOGF_DEBUG(AWS_LS_CAL_LIBCRYPTO_RESOLVE, "searching process and loaded modules");
     void *process = dlopen(NULL, RTLD_NOW);
@@ -581,6 +744,56 @@ static enum aws_libcrypto_version s_resolve_libcrypto(void) {
     return result;
 }
 
+/*
+ * libcrypto is resolved once per process and the function tables stay valid from then on, so clean up and a later
+ * init keep using what was resolved first, and the once is never reset.
+ */
+static aws_thread_once s_libcrypto_resolve_once = AWS_THREAD_ONCE_STATIC_INIT;
+static enum aws_libcrypto_version s_resolved_version = AWS_LIBCRYPTO_NONE;
+/* what the resolved libcrypto says it is, as OpenSSL_version(OPENSSL_VERSION) would */
+static const char *s_resolved_version_string = NULL;
+
+typedef const char *(libcrypto_version_fn)(int type);
+
+/*
+ * Asks the module the symbols were resolved from, which stays loaded for the life of the process. The function is
+ * SSLeay_version() before 1.1.0, and type 0 is OPENSSL_VERSION, or SSLEAY_VERSION, in every version.
+ */
+static const char *s_resolve_version_string(void) {
+    void *module = dlopen(s_resolved_library, RTLD_NOW);
+    if (!module) {
+        return NULL;
+    }
+
+    libcrypto_version_fn *version_fn = NULL;
+    *(void **)(&version_fn) = dlsym(module, "OpenSSL_version");
+    if (!version_fn) {
+        *(void **)(&version_fn) = dlsym(module, "SSLeay_version");
+    }
+    const char *version_string = version_fn ? version_fn(0) : NULL;
+
+    /* only the extra reference just taken is dropped, the library itself is still in use */
+    dlclose(module);
+    return version_string;
+}
+
+static void s_resolve_libcrypto_or_die(void *user_data) {
+    (void)user_data;
+
+    enum aws_libcrypto_version version = s_resolve_libcrypto();
+    AWS_FATAL_ASSERT(version != AWS_LIBCRYPTO_NONE && "libcrypto could not be resolved");
+    s_resolved_version = version;
+    s_resolved_version_string = s_resolve_version_string();
+    AWS_FATAL_ASSERT(g_aws_openssl_evp_md_ctx_table);
+    AWS_FATAL_ASSERT(g_aws_openssl_hmac_ctx_table);
+}
+
+void aws_openssl_ensure_libcrypto_resolved(void) {
+    aws_thread_call_once(&s_libcrypto_resolve_once, s_resolve_libcrypto_or_die, NULL);
+}
+
+#endif /* !AWS_CAL_DIRECT_LIBCRYPTO */
+
 /* Ignore warnings about how CRYPTO_get_locking_callback() always returns NULL on 1.1.1 */
 #if !defined(__GNUC__) || (__GNUC__ * 100 + __GNUC_MINOR__ * 10 > 410)
 #    pragma GCC diagnostic push
@@ -607,11 +820,137 @@ static unsigned long s_id_fn(void) {
 }
 #endif
 
+/*
+ * libcrypto's memory functions only get a pointer back on free and realloc, so every block carries its length in
+ * front of it for the aws allocator. The allocator is never cleared: libcrypto keeps allocating from it, and frees
+ * into it, for as long as the process lives.
+ */
+#if defined(OPENSSL_IS_OPENSSL)
+#    define S_ROUTED_HEADER_LEN 16
+static struct aws_allocator *s_routed_allocator = NULL;
+
+static void *s_routed_malloc(size_t len) {
+    if (len > SIZE_MAX - S_ROUTED_HEADER_LEN) {
+        return NULL;
+    }
+
+    uint8_t *block = aws_mem_acquire(s_routed_allocator, len + S_ROUTED_HEADER_LEN);
+    if (!block) {
+        return NULL;
+    }
+
+    memcpy(block, &len, sizeof(len));
+    return block + S_ROUTED_HEADER_LEN;
+}
+
+static void s_routed_free(void *ptr) {
+    if (ptr) {
+        aws_mem_release(s_routed_allocator, (uint8_t *)ptr - S_ROUTED_HEADER_LEN);
+    }
+}
+
+static void *s_routed_realloc(void *ptr, size_t len) {
+    if (!ptr) {
+        return s_routed_malloc(len);
+    }
+
+    if (len > SIZE_MAX - S_ROUTED_HEADER_LEN) {
+        return NULL;
+    }
+
+    void *block = (uint8_t *)ptr - S_ROUTED_HEADER_LEN;
+    size_t old_len = 0;
+    memcpy(&old_len, block, sizeof(old_len));
+    if (aws_mem_realloc(s_routed_allocator, &block, old_len + S_ROUTED_HEADER_LEN, len + S_ROUTED_HEADER_LEN)) {
+        return NULL;
+    }
+
+    memcpy(block, &len, sizeof(len));
+    return (uint8_t *)block + S_ROUTED_HEADER_LEN;
+}
+
+#    if OPENSSL_VERSION_NUMBER >= 0x10100000L
+static void *s_routed_malloc_ex(size_t len, const char *file, int line) {
+    (void)file;
+    (void)line;
+    return s_routed_malloc(len);
+}
+
+static void *s_routed_realloc_ex(void *ptr, size_t len, const char *file, int line) {
+    (void)file;
+    (void)line;
+    return s_routed_realloc(ptr, len);
+}
+
+static void s_routed_free_ex(void *ptr, const char *file, int line) {
+    (void)file;
+    (void)line;
+    s_routed_free(ptr);
+}
+#    endif
+#endif /* OPENSSL_IS_OPENSSL */
+
+bool aws_cal_platform_route_libcrypto_allocations(struct aws_allocator *allocator) {
+#if defined(OPENSSL_IS_OPENSSL)
+    if (s_routed_allocator) {
+        return s_routed_allocator == allocator;
+    }
+
+    s_routed_allocator = allocator;
+#    if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    int routed = CRYPTO_set_mem_functions(s_routed_malloc_ex, s_routed_realloc_ex, s_routed_free_ex);
+#    else
+    int routed = CRYPTO_set_mem_functions(s_routed_malloc, s_routed_realloc, s_routed_free);
+#    endif
+    if (!routed) {
+        /* libcrypto has already handed out memory from its own functions */
+        s_routed_allocator = NULL;
+        AWS_LOGF_WARN(
+            AWS_LS_CAL_GENERAL, "libcrypto has already allocated memory, its allocations can no longer be routed");
+        return false;
+    }
+
+    return true;
+#else
+    (void)allocator;
+    AWS_LOGF_WARN(AWS_LS_CAL_GENERAL, "this libcrypto does not support routing its allocations");
+    return false;
+#endif
+}
+
+void aws_cal_platform_libcrypto_info(const char **version, const char **version_string, const char **library) {
+#if !defined(AWS_CAL_DIRECT_LIBCRYPTO)
+    /* a lazy resolve may not have happened yet */
+    aws_openssl_ensure_libcrypto_resolved();
+    *version = s_libcrypto_version_names[s_resolved_version];
+    *version_string = s_resolved_version_string;
+    *library = s_resolved_library;
+#else
+#    if defined(OPENSSL_IS_AWSLC)
+    *version = "aws-lc";
+#    elif defined(OPENSSL_IS_BORINGSSL)
+    *version = "boringssl";
+#    elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    *version = "1.1.1";
+#    else
+    *version = "1.0.2";
+#    endif
+#    if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL) || OPENSSL_VERSION_NUMBER >= 0x10100000L
+    *version_string = OpenSSL_version(OPENSSL_VERSION);
+#    else
+    *version_string = SSLeay_version(SSLEAY_VERSION);
+#    endif
+    *library = NULL;
+#endif
+}
+
 void aws_cal_platform_init(struct aws_allocator *allocator) {
-    int version = s_resolve_libcrypto();
-    AWS_FATAL_ASSERT(version != AWS_LIBCRYPTO_NONE && "libcrypto could not be resolved");
-    AWS_FATAL_ASSERT(g_aws_openssl_evp_md_ctx_table);
-    AWS_FATAL_ASSERT(g_aws_openssl_hmac_ctx_table);
+#if !defined(AWS_CAL_DIRECT_LIBCRYPTO)
+    const char *resolve_mode = getenv(s_libcrypto_resolve_env);
+    if (resolve_mode == NULL || strcmp(resolve_mode, "lazy") != 0) {
+        aws_openssl_ensure_libcrypto_resolved();
+    }
+#endif
 
     s_libcrypto_allocator = allocator;
 
@@ -638,6 +977,8 @@ void aws_cal_platform_init(struct aws_allocator *allocator) {
 }
 
 void aws_cal_platform_clean_up(void) {
+    aws_openssl_aes_thread_clean_up();
+
 #if !defined(OPENSSL_IS_AWSLC) && !defined(OPENSSL_IS_BORINGSSL)
     if (CRYPTO_get_locking_callback() == s_locking_fn) {
         CRYPTO_set_locking_callback(NULL);
@@ -658,14 +999,12 @@ void aws_cal_platform_clean_up(void) {
     AWSLC_thread_local_shutdown();
 #endif
 
-    if (s_libcrypto_module) {
-        dlclose(s_libcrypto_module);
-    }
-
     s_libcrypto_allocator = NULL;
 }
 
 void aws_cal_platform_thread_clean_up(void) {
+    aws_openssl_aes_thread_clean_up();
+
 #if defined(OPENSSL_IS_AWSLC)
     AWSLC_thread_local_clear();
 #endif
@@ -0,0 +1,391 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/ecc.h>
+
+#include <aws/cal/cal.h>
+
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
+
+/*
+ * Ed25519 and X25519 go through EVP_PKEY rather than EC_KEY, which is why they live apart from opensslcrypto_ecc.c.
+ * OpenSSL gained raw key import/export and one shot EdDSA in 1.1.1, AWS-LC and BoringSSL have always had them.
+ */
+#if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL) || OPENSSL_VERSION_NUMBER >= 0x10101000L
+#    define AWS_OPENSSL_HAS_25519
+#endif
+
+#define KEY_25519_BYTE_LEN 32
+#define ED25519_SIGNATURE_BYTE_LEN 64
+
+#ifdef AWS_OPENSSL_HAS_25519
+
+struct libcrypto_25519_key {
+    struct aws_ecc_key_pair key_pair;
+    EVP_PKEY *pkey;
+};
+
+static int s_curve_name_to_pkey_type(enum aws_ecc_curve_name curve_name) {
+    switch (curve_name) {
+        case AWS_CAL_ED25519:
+            return EVP_PKEY_ED25519;
+        case AWS_CAL_X25519:
+            return EVP_PKEY_X25519;
+        default:
+            break;
+    }
+
+    AWS_FATAL_ASSERT(!"Unsupported 25519 curve name");
+    return -1;
+}
+
+static void s_key_pair_destroy(struct aws_ecc_key_pair *key_pair) {
+    if (key_pair) {
+        aws_byte_buf_clean_up(&key_pair->pub_x);
+        aws_byte_buf_clean_up(&key_pair->pub_y);
+        aws_byte_buf_clean_up_secure(&key_pair->priv_d);
+
+        struct libcrypto_25519_key *key_impl = key_pair->impl;
+
+        if (key_impl->pkey) {
+            EVP_PKEY_free(key_impl->pkey);
+        }
+        aws_mem_release(key_pair->allocator, key_impl);
+    }
+}
+
+static int s_fill_in_public_key(struct libcrypto_25519_key *key_impl) {
+    struct aws_byte_buf *pub_x = &key_impl->key_pair.pub_x;
+    if (aws_byte_buf_init(pub_x, key_impl->key_pair.allocator, KEY_25519_BYTE_LEN)) {
+        return AWS_OP_ERR;
+    }
+
+    size_t key_len = pub_x->capacity;
+    if (EVP_PKEY_get_raw_public_key(key_impl->pkey, pub_x->buffer, &key_len) != 1 || key_len != KEY_25519_BYTE_LEN) {
+        aws_byte_buf_clean_up(pub_x);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    pub_x->len = key_len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_fill_in_private_key(struct libcrypto_25519_key *key_impl) {
+    struct aws_byte_buf *priv_d = &key_impl->key_pair.priv_d;
+    if (aws_byte_buf_init(priv_d, key_impl->key_pair.allocator, KEY_25519_BYTE_LEN)) {
+        return AWS_OP_ERR;
+    }
+
+    size_t key_len = priv_d->capacity;
+    if (EVP_PKEY_get_raw_private_key(key_impl->pkey, priv_d->buffer, &key_len) != 1 ||
+        key_len != KEY_25519_BYTE_LEN) {
+        aws_byte_buf_clean_up_secure(priv_d);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    priv_d->len = key_len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_derive_public_key(struct aws_ecc_key_pair *key_pair) {
+    struct libcrypto_25519_key *key_impl = key_pair->impl;
+
+    if (!key_pair->priv_d.buffer) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    /* we already have a public key. */
+    if (key_pair->pub_x.len) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return s_fill_in_public_key(key_impl);
+}
+
+static int s_ed25519_sign(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    struct libcrypto_25519_key *key_impl = key_pair->impl;
+
+    if (!key_pair->priv_d.len) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    if (signature_output->capacity - signature_output->len < ED25519_SIGNATURE_BYTE_LEN) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    EVP_MD_CTX *md_ctx = EVP_MD_CTX_new();
+    if (!md_ctx) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    /* EdDSA hashes internally, so there is no digest to pick and the whole message goes in one call. */
+    size_t signature_len = ED25519_SIGNATURE_BYTE_LEN;
+    int success = EVP_DigestSignInit(md_ctx, NULL, NULL, NULL, key_impl->pkey) == 1 &&
+                  EVP_DigestSign(
+                      md_ctx,
+                      signature_output->buffer + signature_output->len,
+                      &signature_len,
+                      message->ptr,
+                      message->len) == 1;
+    EVP_MD_CTX_free(md_ctx);
+
+    if (!success) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    signature_output->len += signature_len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_ed25519_verify(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    struct libcrypto_25519_key *key_impl = key_pair->impl;
+
+    if (signature->len != ED25519_SIGNATURE_BYTE_LEN) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    EVP_MD_CTX *md_ctx = EVP_MD_CTX_new();
+    if (!md_ctx) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    int verified = EVP_DigestVerifyInit(md_ctx, NULL, NULL, NULL, key_impl->pkey) == 1 &&
+                   EVP_DigestVerify(md_ctx, signature->ptr, signature->len, message->ptr, message->len) == 1;
+    EVP_MD_CTX_free(md_ctx);
+
+    return verified ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+}
+
+static size_t s_ed25519_signature_length(const struct aws_ecc_key_pair *key_pair) {
+    (void)key_pair;
+    return ED25519_SIGNATURE_BYTE_LEN;
+}
+
+static int s_x25519_sign(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    (void)key_pair;
+    (void)message;
+    (void)signature_output;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+static int s_x25519_verify(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    (void)key_pair;
+    (void)message;
+    (void)signature;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+static size_t s_x25519_signature_length(const struct aws_ecc_key_pair *key_pair) {
+    (void)key_pair;
+    return 0;
+}
+
+static int s_x25519_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output) {
+    struct libcrypto_25519_key *key_impl = key_pair->impl;
+    struct libcrypto_25519_key *peer_impl = peer_key->impl;
+
+    if (!key_pair->priv_d.len) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    EVP_PKEY_CTX *pkey_ctx = EVP_PKEY_CTX_new(key_impl->pkey, NULL);
+    if (!pkey_ctx) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    /* libcrypto rejects peers of small order, whose shared secret would be all zeros. */
+    uint8_t *secret = shared_secret_output->buffer + shared_secret_output->len;
+    size_t secret_len = KEY_25519_BYTE_LEN;
+    int success = EVP_PKEY_derive_init(pkey_ctx) == 1 && EVP_PKEY_derive_set_peer(pkey_ctx, peer_impl->pkey) == 1 &&
+                  EVP_PKEY_derive(pkey_ctx, secret, &secret_len) == 1;
+    EVP_PKEY_CTX_free(pkey_ctx);
+
+    if (!success) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    shared_secret_output->len += secret_len;
+    return AWS_OP_SUCCESS;
+}
+
+/* Ed25519 signatures are already fixed length, so the raw functions are the same ones. */
+static struct aws_ecc_key_pair_vtable s_ed25519_vtable = {
+    .destroy = s_key_pair_destroy,
+    .derive_pub_key = s_derive_public_key,
+    .sign_message = s_ed25519_sign,
+    .verify_signature = s_ed25519_verify,
+    .signature_length = s_ed25519_signature_length,
+    .sign_message_raw = s_ed25519_sign,
+    .verify_signature_raw = s_ed25519_verify,
+};
+
+static struct aws_ecc_key_pair_vtable s_x25519_vtable = {
+    .destroy = s_key_pair_destroy,
+    .derive_pub_key = s_derive_public_key,
+    .sign_message = s_x25519_sign,
+    .verify_signature = s_x25519_verify,
+    .signature_length = s_x25519_signature_length,
+    .derive_shared_secret = s_x25519_derive_shared_secret,
+};
+
+static struct libcrypto_25519_key *s_key_new(struct aws_allocator *allocator, enum aws_ecc_curve_name curve_name) {
+    struct libcrypto_25519_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct libcrypto_25519_key));
+    if (!key_impl) {
+        return NULL;
+    }
+
+    key_impl->key_pair.curve_name = curve_name;
+    key_impl->key_pair.allocator = allocator;
+    key_impl->key_pair.vtable = curve_name == AWS_CAL_ED25519 ? &s_ed25519_vtable : &s_x25519_vtable;
+    key_impl->key_pair.impl = key_impl;
+    aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
+
+    return key_impl;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_private_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *priv_key) {
+
+    if (priv_key->len != KEY_25519_BYTE_LEN) {
+        aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
+        return NULL;
+    }
+
+    struct libcrypto_25519_key *key_impl = s_key_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
+
+    key_impl->pkey =
+        EVP_PKEY_new_raw_private_key(s_curve_name_to_pkey_type(curve_name), NULL, priv_key->ptr, priv_key->len);
+    if (!key_impl->pkey) {
+        aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+        goto error;
+    }
+
+    if (aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.priv_d, allocator, *priv_key)) {
+        goto error;
+    }
+
+    return &key_impl->key_pair;
+
+error:
+    s_key_pair_destroy(&key_impl->key_pair);
+    return NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_public_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *public_key) {
+
+    if (public_key->len != KEY_25519_BYTE_LEN) {
+        aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
+        return NULL;
+    }
+
+    struct libcrypto_25519_key *key_impl = s_key_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
+
+    key_impl->pkey =
+        EVP_PKEY_new_raw_public_key(s_curve_name_to_pkey_type(curve_name), NULL, public_key->ptr, public_key->len);
+    if (!key_impl->pkey) {
+        aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+        goto error;
+    }
+
+    if (aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.pub_x, allocator, *public_key)) {
+        goto error;
+    }
+
+    return &key_impl->key_pair;
+
+error:
+    s_key_pair_destroy(&key_impl->key_pair);
+    return NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_generate_random_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name) {
+
+    struct libcrypto_25519_key *key_impl = s_key_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
+
+    EVP_PKEY_CTX *pkey_ctx = EVP_PKEY_CTX_new_id(s_curve_name_to_pkey_type(curve_name), NULL);
+    int generated = pkey_ctx && EVP_PKEY_keygen_init(pkey_ctx) == 1 && EVP_PKEY_keygen(pkey_ctx, &key_impl->pkey) == 1;
+    EVP_PKEY_CTX_free(pkey_ctx);
+
+    if (!generated) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        goto error;
+    }
+
+    if (s_fill_in_private_key(key_impl) || s_fill_in_public_key(key_impl)) {
+        goto error;
+    }
+
+    return &key_impl->key_pair;
+
+error:
+    s_key_pair_destroy(&key_impl->key_pair);
+    return NULL;
+}
+
+#else /* !AWS_OPENSSL_HAS_25519 */
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_private_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *priv_key) {
+    (void)allocator;
+    (void)curve_name;
+    (void)priv_key;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_public_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *public_key) {
+    (void)allocator;
+    (void)curve_name;
+    (void)public_key;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_generate_random_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name) {
+    (void)allocator;
+    (void)curve_name;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+#endif /* AWS_OPENSSL_HAS_25519 */
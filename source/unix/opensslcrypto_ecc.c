@@ -7,22 +7,56 @@
 #include <aws/cal/cal.h>
 #include <aws/cal/private/der.h>
 
+#include <aws/common/thread.h>
+
 #include <openssl/bn.h>
 #include <openssl/ec.h>
+#include <openssl/ecdh.h>
 #include <openssl/ecdsa.h>
 #include <openssl/obj_mac.h>
 
+/* P384 has the largest coordinates of the curves this file handles */
+#define MAX_COORDINATE_SIZE 48
+
 struct libcrypto_ecc_key {
     struct aws_ecc_key_pair key_pair;
     EC_KEY *ec_key;
+    /* EC_KEY_precompute_mult() rewrites the group, so it runs once however many threads ask for it */
+    aws_thread_once verification_once;
+    int verification_error;
+    /* pub_x, pub_y and priv_d are views into this, so the whole key pair is a single allocation. */
+    uint8_t key_data[MAX_COORDINATE_SIZE * 3];
+    /* generated keys only copy their coordinates out of ec_key the first time someone asks for them */
+    bool key_data_pending;
+    aws_thread_once key_data_once;
+    int key_data_error;
 };
 
+/* see opensslcrypto_25519.c */
+extern struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_private_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *priv_key);
+extern struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_public_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *public_key);
+extern struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_generate_random_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name);
+
+static bool s_is_25519_curve(enum aws_ecc_curve_name curve_name) {
+    return curve_name == AWS_CAL_ED25519 || curve_name == AWS_CAL_X25519;
+}
+
 static int s_curve_name_to_nid(enum aws_ecc_curve_name curve_name) {
     switch (curve_name) {
         case AWS_CAL_ECDSA_P256:
             return NID_X9_62_prime256v1;
         case AWS_CAL_ECDSA_P384:
             return NID_secp384r1;
+        default:
+            break;
     }
 
     AWS_FATAL_ASSERT(!"Unsupported elliptic curve name");
@@ -32,15 +66,13 @@ static int s_curve_name_to_nid(enum aws_ecc_curve_name curve_name) {
 static void s_key_pair_destroy(struct aws_ecc_key_pair *key_pair) {
 
     if (key_pair) {
-        aws_byte_buf_clean_up(&key_pair->pub_x);
-        aws_byte_buf_clean_up(&key_pair->pub_y);
-        aws_byte_buf_clean_up_secure(&key_pair->priv_d);
-
         struct libcrypto_ecc_key *key_impl = key_pair->impl;
 
         if (key_impl->ec_key) {
             EC_KEY_free(key_impl->ec_key);
         }
+
+        aws_secure_zero(key_impl->key_data, sizeof(key_impl->key_data));
         aws_mem_release(key_pair->allocator, key_pair);
     }
 }
@@ -75,56 +107,431 @@ static int s_verify_payload(
                : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
 }
 
+#if !defined(OPENSSL_IS_AWSLC) && !defined(OPENSSL_IS_BORINGSSL) && OPENSSL_VERSION_NUMBER < 0x10100000L
+/* 1.0.x has no accessors for ECDSA_SIG, its fields are public */
+static void s_ecdsa_sig_get0(const ECDSA_SIG *sig, const BIGNUM **r, const BIGNUM **s) {
+    *r = sig->r;
+    *s = sig->s;
+}
+
+static int s_ecdsa_sig_set0(ECDSA_SIG *sig, BIGNUM *r, BIGNUM *s) {
+    BN_free(sig->r);
+    BN_free(sig->s);
+    sig->r = r;
+    sig->s = s;
+    return 1;
+}
+
+/* 1.0.x can't set a public key from its encoding directly either */
+static int s_ec_key_oct2key(EC_KEY *key, const unsigned char *buf, size_t len, BN_CTX *ctx) {
+    const EC_GROUP *group = EC_KEY_get0_group(key);
+    EC_POINT *point = EC_POINT_new(group);
+    int ret_val = point && EC_POINT_oct2point(group, point, buf, len, ctx) == 1 && EC_KEY_set_public_key(key, point);
+    EC_POINT_free(point);
+    return ret_val;
+}
+#else
+#    define s_ecdsa_sig_get0 ECDSA_SIG_get0
+#    define s_ecdsa_sig_set0 ECDSA_SIG_set0
+#    define s_ec_key_oct2key EC_KEY_oct2key
+#endif
+
+/* writes num as a big endian integer left padded with zeros to exactly width bytes. */
+static bool s_write_padded_bignum(struct aws_byte_buf *output, const BIGNUM *num, size_t width) {
+    size_t num_len = BN_num_bytes(num);
+    if (num_len > width || output->capacity - output->len < width) {
+        return false;
+    }
+
+    aws_byte_buf_write_u8_n(output, 0x0, width - num_len);
+    BN_bn2bin(num, output->buffer + output->len);
+    output->len += num_len;
+    return true;
+}
+
+static int s_sign_payload_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *hash,
+    struct aws_byte_buf *signature_output) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
+
+    ECDSA_SIG *sig = ECDSA_do_sign(hash->ptr, (int)hash->len, libcrypto_key_pair->ec_key);
+    if (!sig) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    const BIGNUM *r = NULL;
+    const BIGNUM *s = NULL;
+    s_ecdsa_sig_get0(sig, &r, &s);
+
+    size_t coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name);
+    size_t starting_len = signature_output->len;
+    int ret_val = AWS_OP_SUCCESS;
+
+    if (!s_write_padded_bignum(signature_output, r, coordinate_size) ||
+        !s_write_padded_bignum(signature_output, s, coordinate_size)) {
+        signature_output->len = starting_len;
+        ret_val = aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    ECDSA_SIG_free(sig);
+    return ret_val;
+}
+
+static int s_verify_payload_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *hash,
+    const struct aws_byte_cursor *signature) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
+
+    size_t coordinate_size = signature->len / 2;
+    ECDSA_SIG *sig = ECDSA_SIG_new();
+    BIGNUM *r = BN_bin2bn(signature->ptr, (int)coordinate_size, NULL);
+    BIGNUM *s = BN_bin2bn(signature->ptr + coordinate_size, (int)coordinate_size, NULL);
+
+    if (!sig || !r || !s || s_ecdsa_sig_set0(sig, r, s) != 1) {
+        BN_free(r);
+        BN_free(s);
+        ECDSA_SIG_free(sig);
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    /* sig owns r and s now */
+    int verified = ECDSA_do_verify(hash->ptr, (int)hash->len, sig, libcrypto_key_pair->ec_key);
+    ECDSA_SIG_free(sig);
+
+    return verified == 1 ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+}
+
+#if !defined(OPENSSL_IS_AWSLC) && !defined(OPENSSL_IS_BORINGSSL)
+/*
+ * An ECDSA signature only carries the x coordinate of R, so a batch can't be folded into one multi-scalar check the
+ * way EC_POINTs_mul() would need. What the batch can share are the inversions: every s^-1 mod n comes out of a single
+ * BN_mod_inverse() (Montgomery's trick), and every u1 * G + u2 * Q is made affine with a single field inversion. The
+ * scalar multiplications are the same ones ECDSA_verify() does, so the gain is modest, a few percent to about a
+ * tenth. Signatures are taken VERIFY_BATCH_CHUNK at a time so the bookkeeping fits on the stack. AWS-LC and BoringSSL
+ * don't have EC_POINTs_make_affine(), so they verify one signature at a time.
+ */
+#    define VERIFY_BATCH_CHUNK 64
+
+struct verify_batch_entry {
+    size_t index;
+    ECDSA_SIG *sig;
+    /* the product of s over this entry and the ones before it in the chunk, mod n */
+    BIGNUM *prefix;
+    EC_POINT *point;
+};
+
+/* NULL unless signature is the canonical DER encoding of r and s in [1, n - 1], all that ECDSA_verify() accepts */
+static ECDSA_SIG *s_decode_batch_signature(const struct aws_byte_cursor *signature, const BIGNUM *order) {
+    if (signature->len == 0 || signature->len > INT_MAX) {
+        return NULL;
+    }
+
+    const unsigned char *der = signature->ptr;
+    ECDSA_SIG *sig = d2i_ECDSA_SIG(NULL, &der, (long)signature->len);
+    if (!sig) {
+        return NULL;
+    }
+
+    unsigned char *encoded = NULL;
+    int encoded_len = i2d_ECDSA_SIG(sig, &encoded);
+    bool canonical = encoded_len == (int)signature->len && memcmp(encoded, signature->ptr, signature->len) == 0;
+    OPENSSL_free(encoded);
+
+    const BIGNUM *r = NULL;
+    const BIGNUM *s = NULL;
+    s_ecdsa_sig_get0(sig, &r, &s);
+    if (!canonical || BN_is_zero(r) || BN_is_negative(r) || BN_ucmp(r, order) >= 0 || BN_is_zero(s) ||
+        BN_is_negative(s) || BN_ucmp(s, order) >= 0) {
+        ECDSA_SIG_free(sig);
+        return NULL;
+    }
+
+    return sig;
+}
+
+/* the digest's leftmost bits, as many as the order has, read the way ECDSA_verify() reads them */
+static bool s_digest_to_bignum(const struct aws_byte_cursor *digest, const BIGNUM *order, BIGNUM *out) {
+    size_t order_bits = (size_t)BN_num_bits(order);
+    size_t digest_len = digest->len;
+    if (8 * digest_len > order_bits) {
+        digest_len = (order_bits + 7) / 8;
+    }
+
+    if (!BN_bin2bn(digest->ptr, (int)digest_len, out)) {
+        return false;
+    }
+
+    return 8 * digest_len <= order_bits || BN_rshift(out, out, (int)(8 - (order_bits & 0x7)));
+}
+
+/* verifies signatures [first, first + count). false means libcrypto failed, not that a signature did. */
+static bool s_verify_batch_chunk(
+    const EC_KEY *ec_key,
+    const BIGNUM *order,
+    const struct aws_byte_cursor *messages,
+    const struct aws_byte_cursor *signatures,
+    size_t first,
+    size_t count,
+    uint8_t *valid_bitmap,
+    BN_CTX *ctx) {
+
+    const EC_GROUP *group = EC_KEY_get0_group(ec_key);
+    const EC_POINT *pub_key = EC_KEY_get0_public_key(ec_key);
+
+    struct verify_batch_entry entries[VERIFY_BATCH_CHUNK];
+    EC_POINT *points[VERIFY_BATCH_CHUNK];
+    size_t entry_count = 0;
+    bool succeeded = false;
+
+    BN_CTX_start(ctx);
+    BIGNUM *inverse = BN_CTX_get(ctx);
+    BIGNUM *w = BN_CTX_get(ctx);
+    BIGNUM *u1 = BN_CTX_get(ctx);
+    BIGNUM *u2 = BN_CTX_get(ctx);
+    BIGNUM *x = BN_CTX_get(ctx);
+    if (!x) {
+        goto done;
+    }
+
+    /* malformed signatures just stay invalid, the rest go into the shared inversion */
+    for (size_t i = first; i < first + count; ++i) {
+        ECDSA_SIG *sig = s_decode_batch_signature(&signatures[i], order);
+        if (!sig) {
+            continue;
+        }
+
+        struct verify_batch_entry *entry = &entries[entry_count++];
+        AWS_ZERO_STRUCT(*entry);
+        entry->index = i;
+        entry->sig = sig;
+
+        const BIGNUM *r = NULL;
+        const BIGNUM *s = NULL;
+        s_ecdsa_sig_get0(sig, &r, &s);
+        entry->prefix = BN_CTX_get(ctx);
+        if (!entry->prefix) {
+            goto done;
+        }
+        if (entry_count == 1 ? !BN_copy(entry->prefix, s)
+                             : !BN_mod_mul(entry->prefix, entries[entry_count - 2].prefix, s, order, ctx)) {
+            goto done;
+        }
+    }
+
+    if (entry_count == 0) {
+        succeeded = true;
+        goto done;
+    }
+
+    /* the s are all in [1, n - 1] and n is prime, so the product has an inverse */
+    if (!BN_mod_inverse(inverse, entries[entry_count - 1].prefix, order, ctx)) {
+        goto done;
+    }
+
+    for (size_t j = entry_count; j-- > 0;) {
+        struct verify_batch_entry *entry = &entries[j];
+        const BIGNUM *r = NULL;
+        const BIGNUM *s = NULL;
+        s_ecdsa_sig_get0(entry->sig, &r, &s);
+
+        /* inverse is 1 / (s_0 * ... * s_j) here, so multiplying out the earlier ones leaves 1 / s_j */
+        if (j > 0 ? !BN_mod_mul(w, inverse, entries[j - 1].prefix, order, ctx) : !BN_copy(w, inverse)) {
+            goto done;
+        }
+        if (!BN_mod_mul(inverse, inverse, s, order, ctx)) {
+            goto done;
+        }
+
+        entry->point = EC_POINT_new(group);
+        if (!entry->point || !s_digest_to_bignum(&messages[entry->index], order, u1) ||
+            !BN_mod_mul(u1, u1, w, order, ctx) || !BN_mod_mul(u2, r, w, order, ctx) ||
+            !EC_POINT_mul(group, entry->point, u1, pub_key, u2, ctx)) {
+            goto done;
+        }
+    }
+
+    /* a point at infinity fails its signature, and has no affine form to share in */
+    size_t point_count = 0;
+    for (size_t j = 0; j < entry_count; ++j) {
+        if (!EC_POINT_is_at_infinity(group, entries[j].point)) {
+            points[point_count++] = entries[j].point;
+        }
+    }
+    if (point_count > 0 && !EC_POINTs_make_affine(group, point_count, points, ctx)) {
+        goto done;
+    }
+
+    for (size_t j = 0; j < entry_count; ++j) {
+        if (EC_POINT_is_at_infinity(group, entries[j].point)) {
+            continue;
+        }
+
+        const BIGNUM *r = NULL;
+        const BIGNUM *s = NULL;
+        s_ecdsa_sig_get0(entries[j].sig, &r, &s);
+        if (!EC_POINT_get_affine_coordinates_GFp(group, entries[j].point, x, NULL, ctx) ||
+            !BN_nnmod(x, x, order, ctx)) {
+            goto done;
+        }
+        if (BN_cmp(x, r) == 0) {
+            valid_bitmap[entries[j].index / 8] |= (uint8_t)(1u << (entries[j].index % 8));
+        }
+    }
+
+    succeeded = true;
+
+done:
+    for (size_t j = 0; j < entry_count; ++j) {
+        ECDSA_SIG_free(entries[j].sig);
+        EC_POINT_free(entries[j].point);
+    }
+    BN_CTX_end(ctx);
+
+    return succeeded;
+}
+
+static int s_verify_payload_batch(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *messages,
+    const struct aws_byte_cursor *signatures,
+    size_t count,
+    uint8_t *valid_bitmap) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
+
+    if (count == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    memset(valid_bitmap, 0, AWS_ECC_VERIFY_BATCH_BITMAP_LEN(count));
+
+    BN_CTX *ctx = BN_CTX_new();
+    BIGNUM *order = BN_new();
+    bool batchable = ctx && order && EC_GROUP_get_order(EC_KEY_get0_group(libcrypto_key_pair->ec_key), order, ctx) &&
+                     EC_KEY_get0_public_key(libcrypto_key_pair->ec_key);
+
+    for (size_t first = 0; first < count; first += VERIFY_BATCH_CHUNK) {
+        size_t chunk_len = aws_min_size(VERIFY_BATCH_CHUNK, count - first);
+        if (batchable &&
+            s_verify_batch_chunk(
+                libcrypto_key_pair->ec_key, order, messages, signatures, first, chunk_len, valid_bitmap, ctx)) {
+            continue;
+        }
+
+        /* libcrypto ran out of something partway, so this chunk's answers come from ECDSA_verify() instead */
+        for (size_t i = first; i < first + chunk_len; ++i) {
+            valid_bitmap[i / 8] &= (uint8_t) ~(1u << (i % 8));
+            if (s_verify_payload(key_pair, &messages[i], &signatures[i]) == AWS_OP_SUCCESS) {
+                valid_bitmap[i / 8] |= (uint8_t)(1u << (i % 8));
+            }
+        }
+    }
+
+    BN_free(order);
+    BN_CTX_free(ctx);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!(valid_bitmap[i / 8] & (1u << (i % 8)))) {
+            return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+#endif /* !OPENSSL_IS_AWSLC && !OPENSSL_IS_BORINGSSL */
+
 static size_t s_signature_length(const struct aws_ecc_key_pair *key_pair) {
     struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
 
     return ECDSA_size(libcrypto_key_pair->ec_key);
 }
 
-static int s_fill_in_public_key_info(
-    struct libcrypto_ecc_key *libcrypto_key_pair,
-    const EC_GROUP *group,
-    const EC_POINT *pub_key_point) {
-    BIGNUM *big_num_x = BN_new();
-    BIGNUM *big_num_y = BN_new();
+/* copies the key's public point into pub_x and pub_y, without going through BIGNUMs. */
+static int s_fill_in_public_key_info(struct libcrypto_ecc_key *libcrypto_key_pair) {
+    const EC_GROUP *group = EC_KEY_get0_group(libcrypto_key_pair->ec_key);
+    const EC_POINT *pub_key_point = EC_KEY_get0_public_key(libcrypto_key_pair->ec_key);
+    size_t coordinate_size = libcrypto_key_pair->key_pair.pub_x.capacity;
+
+    /* an uncompressed point is 0x04 || x || y */
+    uint8_t point_data[1 + MAX_COORDINATE_SIZE * 2];
+    size_t point_len = 1 + coordinate_size * 2;
+    if (!pub_key_point ||
+        EC_POINT_point2oct(group, pub_key_point, POINT_CONVERSION_UNCOMPRESSED, point_data, point_len, NULL) !=
+            point_len) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
 
-    int ret_val = AWS_OP_ERR;
+    libcrypto_key_pair->key_pair.pub_x.len = 0;
+    libcrypto_key_pair->key_pair.pub_y.len = 0;
+    aws_byte_buf_write(&libcrypto_key_pair->key_pair.pub_x, point_data + 1, coordinate_size);
+    aws_byte_buf_write(&libcrypto_key_pair->key_pair.pub_y, point_data + 1 + coordinate_size, coordinate_size);
 
-    if (EC_POINT_get_affine_coordinates_GFp(group, pub_key_point, big_num_x, big_num_y, NULL) != 1) {
-        aws_raise_error(AWS_ERROR_INVALID_STATE);
-        goto clean_up;
-    }
+    return AWS_OP_SUCCESS;
+}
 
-    size_t x_coor_size = BN_num_bytes(big_num_x);
-    size_t y_coor_size = BN_num_bytes(big_num_y);
+/* sets the key's public point from pub_x and pub_y. */
+static int s_set_public_key_from_coordinates(struct libcrypto_ecc_key *libcrypto_key_pair) {
+    size_t coordinate_size = libcrypto_key_pair->key_pair.pub_x.capacity;
 
-    if (aws_byte_buf_init(&libcrypto_key_pair->key_pair.pub_x, libcrypto_key_pair->key_pair.allocator, x_coor_size)) {
-        goto clean_up;
+    uint8_t point_data[1 + MAX_COORDINATE_SIZE * 2];
+    point_data[0] = POINT_CONVERSION_UNCOMPRESSED;
+    memcpy(point_data + 1, libcrypto_key_pair->key_pair.pub_x.buffer, coordinate_size);
+    memcpy(point_data + 1 + coordinate_size, libcrypto_key_pair->key_pair.pub_y.buffer, coordinate_size);
+
+    if (s_ec_key_oct2key(libcrypto_key_pair->ec_key, point_data, 1 + coordinate_size * 2, NULL) != 1) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
-    if (aws_byte_buf_init(&libcrypto_key_pair->key_pair.pub_y, libcrypto_key_pair->key_pair.allocator, y_coor_size)) {
-        goto clean_up;
+    return AWS_OP_SUCCESS;
+}
+
+/* copies cursor into one of the fixed width coordinate buffers, left padding it with zeros. */
+static int s_write_coordinate(struct aws_byte_buf *coordinate, const struct aws_byte_cursor *cursor) {
+    if (cursor->len > coordinate->capacity) {
+        return aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
     }
 
-    BN_bn2bin(big_num_x, libcrypto_key_pair->key_pair.pub_x.buffer);
-    BN_bn2bin(big_num_y, libcrypto_key_pair->key_pair.pub_y.buffer);
+    coordinate->len = 0;
+    aws_byte_buf_write_u8_n(coordinate, 0x0, coordinate->capacity - cursor->len);
+    aws_byte_buf_write_from_whole_cursor(coordinate, *cursor);
+    return AWS_OP_SUCCESS;
+}
 
-    libcrypto_key_pair->key_pair.pub_x.len = x_coor_size;
-    libcrypto_key_pair->key_pair.pub_y.len = y_coor_size;
+static void s_export_key_data(void *user_data) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = user_data;
+    struct aws_byte_buf *priv_d = &libcrypto_key_pair->key_pair.priv_d;
 
-    ret_val = AWS_OP_SUCCESS;
+    if (!s_write_padded_bignum(priv_d, EC_KEY_get0_private_key(libcrypto_key_pair->ec_key), priv_d->capacity)) {
+        libcrypto_key_pair->key_data_error = AWS_ERROR_INVALID_STATE;
+        return;
+    }
 
-clean_up:
-    BN_free(big_num_x);
-    BN_free(big_num_y);
+    if (s_fill_in_public_key_info(libcrypto_key_pair)) {
+        priv_d->len = 0;
+        libcrypto_key_pair->key_data_error = aws_last_error();
+    }
+}
 
-    return ret_val;
+static int s_load_key_data(struct aws_ecc_key_pair *key_pair) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
+
+    if (!libcrypto_key_pair->key_data_pending) {
+        return AWS_OP_SUCCESS;
+    }
+
+    aws_thread_call_once(&libcrypto_key_pair->key_data_once, s_export_key_data, libcrypto_key_pair);
+    return libcrypto_key_pair->key_data_error ? aws_raise_error(libcrypto_key_pair->key_data_error) : AWS_OP_SUCCESS;
 }
 
 static int s_derive_public_key(struct aws_ecc_key_pair *key_pair) {
     struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
 
-    if (!libcrypto_key_pair->key_pair.priv_d.buffer) {
+    if (s_load_key_data(key_pair)) {
+        return AWS_OP_ERR;
+    }
+
+    if (!libcrypto_key_pair->key_pair.priv_d.len) {
         return aws_raise_error(AWS_ERROR_INVALID_STATE);
     }
 
@@ -133,34 +540,144 @@ static int s_derive_public_key(struct aws_ecc_key_pair *key_pair) {
         return AWS_OP_SUCCESS;
     }
 
-    BIGNUM *priv_key_num =
-        BN_bin2bn(libcrypto_key_pair->key_pair.priv_d.buffer, libcrypto_key_pair->key_pair.priv_d.len, NULL);
-
     const EC_GROUP *group = EC_KEY_get0_group(libcrypto_key_pair->ec_key);
     EC_POINT *point = EC_POINT_new(group);
+    if (!point) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
 
-    EC_POINT_mul(group, point, priv_key_num, NULL, NULL, NULL);
-    BN_free(priv_key_num);
+    int ret_val = AWS_OP_ERR;
+    if (EC_POINT_mul(group, point, EC_KEY_get0_private_key(libcrypto_key_pair->ec_key), NULL, NULL, NULL) != 1 ||
+        EC_KEY_set_public_key(libcrypto_key_pair->ec_key, point) != 1) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+    } else {
+        ret_val = s_fill_in_public_key_info(libcrypto_key_pair);
+    }
 
-    EC_KEY_set_public_key(libcrypto_key_pair->ec_key, point);
-    int ret_val = s_fill_in_public_key_info(libcrypto_key_pair, group, point);
     EC_POINT_free(point);
     return ret_val;
 }
 
+/*
+ * EC_KEY_new_by_curve_name() gives every key its own EC_GROUP, so the multiples table EC_KEY_precompute_mult() hangs
+ * off that group lives and dies with this key. ECDSA_verify() then uses it for the u1 * G half of its double scalar
+ * multiplication. libcrypto has no public API for keeping a table for the public point itself, and curves that
+ * already ship a static generator table (P-256 on most builds, everything on AWS-LC) gain nothing from it.
+ *
+ * The once only keeps concurrent prepares apart. A verify running on another thread while the table is swapped in
+ * still races with it, which is why the key has to be prepared before it is shared.
+ */
+static void s_precompute_mult(void *user_data) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = user_data;
+
+    if (EC_KEY_precompute_mult(libcrypto_key_pair->ec_key, NULL) != 1) {
+        libcrypto_key_pair->verification_error = AWS_ERROR_OOM;
+    }
+}
+
+static int s_prepare_for_verification(struct aws_ecc_key_pair *key_pair) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
+
+    aws_thread_call_once(&libcrypto_key_pair->verification_once, s_precompute_mult, libcrypto_key_pair);
+    return libcrypto_key_pair->verification_error ? aws_raise_error(libcrypto_key_pair->verification_error)
+                                                  : AWS_OP_SUCCESS;
+}
+
+static int s_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output) {
+    struct libcrypto_ecc_key *libcrypto_key_pair = key_pair->impl;
+    struct libcrypto_ecc_key *libcrypto_peer_key = peer_key->impl;
+
+    const EC_POINT *peer_point = EC_KEY_get0_public_key(libcrypto_peer_key->ec_key);
+    if (!EC_KEY_get0_private_key(libcrypto_key_pair->ec_key) || !peer_point) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    /* the shared secret is the x coordinate of the shared point, written straight into the caller's buffer. */
+    size_t secret_len = aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name);
+    int written = ECDH_compute_key(
+        shared_secret_output->buffer + shared_secret_output->len,
+        secret_len,
+        peer_point,
+        libcrypto_key_pair->ec_key,
+        NULL);
+
+    if (written != (int)secret_len) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    shared_secret_output->len += secret_len;
+    return AWS_OP_SUCCESS;
+}
+
 static struct aws_ecc_key_pair_vtable vtable = {
     .sign_message = s_sign_payload,
     .verify_signature = s_verify_payload,
+#if !defined(OPENSSL_IS_AWSLC) && !defined(OPENSSL_IS_BORINGSSL)
+    .verify_signature_batch = s_verify_payload_batch,
+#endif
     .derive_pub_key = s_derive_public_key,
     .signature_length = s_signature_length,
+    .prepare_for_verification = s_prepare_for_verification,
+    .sign_message_raw = s_sign_payload_raw,
+    .verify_signature_raw = s_verify_payload_raw,
+    .derive_shared_secret = s_derive_shared_secret,
+    .load_key_data = s_load_key_data,
     .destroy = s_key_pair_destroy,
 };
 
+/*
+ * Allocates the key pair and its coordinate storage in one go from allocator, which may well be an arena the caller
+ * throws away in one piece. The EC_KEY itself always comes from libcrypto's allocator.
+ */
+static struct libcrypto_ecc_key *s_key_impl_new(struct aws_allocator *allocator, enum aws_ecc_curve_name curve_name) {
+    size_t coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(curve_name);
+    if (!coordinate_size || coordinate_size > MAX_COORDINATE_SIZE) {
+        aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+        return NULL;
+    }
+
+    struct libcrypto_ecc_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct libcrypto_ecc_key));
+    if (!key_impl) {
+        return NULL;
+    }
+
+    key_impl->key_pair.curve_name = curve_name;
+    key_impl->key_pair.allocator = allocator;
+    key_impl->key_pair.vtable = &vtable;
+    key_impl->key_pair.impl = key_impl;
+    aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
+
+    aws_thread_once once_init = AWS_THREAD_ONCE_STATIC_INIT;
+    key_impl->key_data_once = once_init;
+    key_impl->verification_once = once_init;
+
+    key_impl->key_pair.pub_x = aws_byte_buf_from_empty_array(key_impl->key_data, coordinate_size);
+    key_impl->key_pair.pub_y = aws_byte_buf_from_empty_array(key_impl->key_data + coordinate_size, coordinate_size);
+    key_impl->key_pair.priv_d =
+        aws_byte_buf_from_empty_array(key_impl->key_data + coordinate_size * 2, coordinate_size);
+
+    key_impl->ec_key = EC_KEY_new_by_curve_name(s_curve_name_to_nid(curve_name));
+    if (!key_impl->ec_key) {
+        aws_mem_release(allocator, key_impl);
+        aws_raise_error(AWS_ERROR_OOM);
+        return NULL;
+    }
+
+    return key_impl;
+}
+
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_private_key_impl(
     struct aws_allocator *allocator,
     enum aws_ecc_curve_name curve_name,
     const struct aws_byte_cursor *priv_key) {
 
+    if (s_is_25519_curve(curve_name)) {
+        return aws_ecc_key_pair_new_25519_from_private_key_impl(allocator, curve_name, priv_key);
+    }
+
     size_t key_length = aws_ecc_key_coordinate_byte_size_from_curve_name(curve_name);
     if (priv_key->len != key_length) {
         AWS_LOGF_ERROR(AWS_LS_CAL_ECC, "Private key length does not match curve's expected length");
@@ -168,63 +685,46 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_private_key_impl(
         return NULL;
     }
 
-    struct libcrypto_ecc_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct libcrypto_ecc_key));
+    struct libcrypto_ecc_key *key_impl = s_key_impl_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
 
-    key_impl->ec_key = EC_KEY_new_by_curve_name(s_curve_name_to_nid(curve_name));
-    key_impl->key_pair.curve_name = curve_name;
-    key_impl->key_pair.allocator = allocator;
-    key_impl->key_pair.vtable = &vtable;
-    key_impl->key_pair.impl = key_impl;
-    aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
-    aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.priv_d, allocator, *priv_key);
+    aws_byte_buf_write_from_whole_cursor(&key_impl->key_pair.priv_d, *priv_key);
 
     BIGNUM *priv_key_num = BN_bin2bn(key_impl->key_pair.priv_d.buffer, key_impl->key_pair.priv_d.len, NULL);
-    if (!EC_KEY_set_private_key(key_impl->ec_key, priv_key_num)) {
+    if (!priv_key_num || !EC_KEY_set_private_key(key_impl->ec_key, priv_key_num)) {
         AWS_LOGF_ERROR(AWS_LS_CAL_ECC, "Failed to set openssl private key");
         aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-        BN_free(priv_key_num);
+        BN_clear_free(priv_key_num);
         s_key_pair_destroy(&key_impl->key_pair);
         return NULL;
     }
-    BN_free(priv_key_num);
+    BN_clear_free(priv_key_num);
     return &key_impl->key_pair;
 }
 
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_generate_random(
     struct aws_allocator *allocator,
     enum aws_ecc_curve_name curve_name) {
-    struct libcrypto_ecc_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct libcrypto_ecc_key));
-
-    key_impl->ec_key = EC_KEY_new_by_curve_name(s_curve_name_to_nid(curve_name));
-    key_impl->key_pair.curve_name = curve_name;
-    key_impl->key_pair.allocator = allocator;
-    key_impl->key_pair.vtable = &vtable;
-    key_impl->key_pair.impl = key_impl;
-    aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
-
-    if (EC_KEY_generate_key(key_impl->ec_key) != 1) {
-        goto error;
+    if (s_is_25519_curve(curve_name)) {
+        return aws_ecc_key_pair_new_25519_generate_random_impl(allocator, curve_name);
     }
 
-    const EC_POINT *pub_key_point = EC_KEY_get0_public_key(key_impl->ec_key);
-    const EC_GROUP *group = EC_KEY_get0_group(key_impl->ec_key);
-
-    const BIGNUM *private_key_num = EC_KEY_get0_private_key(key_impl->ec_key);
-    size_t priv_key_size = BN_num_bytes(private_key_num);
-    if (aws_byte_buf_init(&key_impl->key_pair.priv_d, allocator, priv_key_size)) {
-        goto error;
+    struct libcrypto_ecc_key *key_impl = s_key_impl_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
     }
 
-    BN_bn2bin(private_key_num, key_impl->key_pair.priv_d.buffer);
-    key_impl->key_pair.priv_d.len = priv_key_size;
-
-    if (!s_fill_in_public_key_info(key_impl, group, pub_key_point)) {
-        return &key_impl->key_pair;
+    if (EC_KEY_generate_key(key_impl->ec_key) != 1) {
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        s_key_pair_destroy(&key_impl->key_pair);
+        return NULL;
     }
 
-error:
-    s_key_pair_destroy(&key_impl->key_pair);
-    return NULL;
+    /* keys that only ever sign never need their coordinates, see s_load_key_data() */
+    key_impl->key_data_pending = true;
+    return &key_impl->key_pair;
 }
 
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_public_key_impl(
@@ -232,68 +732,26 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_public_key_impl(
     enum aws_ecc_curve_name curve_name,
     const struct aws_byte_cursor *public_key_x,
     const struct aws_byte_cursor *public_key_y) {
-    struct libcrypto_ecc_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct libcrypto_ecc_key));
-    BIGNUM *pub_x_num = NULL;
-    BIGNUM *pub_y_num = NULL;
-    EC_POINT *point = NULL;
-
-    if (!key_impl) {
-        return NULL;
+    if (s_is_25519_curve(curve_name)) {
+        if (public_key_y->len) {
+            aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
+            return NULL;
+        }
+        return aws_ecc_key_pair_new_25519_from_public_key_impl(allocator, curve_name, public_key_x);
     }
 
-    key_impl->ec_key = EC_KEY_new_by_curve_name(s_curve_name_to_nid(curve_name));
-    key_impl->key_pair.curve_name = curve_name;
-    key_impl->key_pair.allocator = allocator;
-    key_impl->key_pair.vtable = &vtable;
-    key_impl->key_pair.impl = key_impl;
-    aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
-
-    if (aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.pub_x, allocator, *public_key_x)) {
-        s_key_pair_destroy(&key_impl->key_pair);
+    struct libcrypto_ecc_key *key_impl = s_key_impl_new(allocator, curve_name);
+    if (!key_impl) {
         return NULL;
     }
 
-    if (aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.pub_y, allocator, *public_key_y)) {
+    if (s_write_coordinate(&key_impl->key_pair.pub_x, public_key_x) ||
+        s_write_coordinate(&key_impl->key_pair.pub_y, public_key_y) || s_set_public_key_from_coordinates(key_impl)) {
         s_key_pair_destroy(&key_impl->key_pair);
         return NULL;
     }
 
-    pub_x_num = BN_bin2bn(public_key_x->ptr, public_key_x->len, NULL);
-    pub_y_num = BN_bin2bn(public_key_y->ptr, public_key_y->len, NULL);
-
-    const EC_GROUP *group = EC_KEY_get0_group(key_impl->ec_key);
-    point = EC_POINT_new(group);
-
-    if (EC_POINT_set_affine_coordinates_GFp(group, point, pub_x_num, pub_y_num, NULL) != 1) {
-        goto error;
-    }
-
-    if (EC_KEY_set_public_key(key_impl->ec_key, point) != 1) {
-        goto error;
-    }
-
-    EC_POINT_free(point);
-    BN_free(pub_x_num);
-    BN_free(pub_y_num);
-
     return &key_impl->key_pair;
-
-error:
-    if (point) {
-        EC_POINT_free(point);
-    }
-
-    if (pub_x_num) {
-        BN_free(pub_x_num);
-    }
-
-    if (pub_y_num) {
-        BN_free(pub_y_num);
-    }
-
-    s_key_pair_destroy(&key_impl->key_pair);
-
-    return NULL;
 }
 
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
@@ -301,60 +759,34 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
     const struct aws_byte_cursor *encoded_keys) {
 
     struct aws_ecc_key_pair *key = NULL;
-    struct aws_der_decoder *decoder = aws_der_decoder_new(allocator, *encoded_keys);
-
-    if (!decoder) {
-        return NULL;
-    }
 
     struct aws_byte_cursor pub_x;
     struct aws_byte_cursor pub_y;
     struct aws_byte_cursor priv_d;
 
     enum aws_ecc_curve_name curve_name;
-    if (aws_der_decoder_load_ecc_key_pair(decoder, &pub_x, &pub_y, &priv_d, &curve_name)) {
-        goto error;
+    if (aws_der_load_ecc_key_pair(*encoded_keys, &pub_x, &pub_y, &priv_d, &curve_name)) {
+        return NULL;
     }
 
     if (priv_d.ptr) {
-        struct libcrypto_ecc_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct libcrypto_ecc_key));
-        key_impl->key_pair.curve_name = curve_name;
-        /* as awkward as it seems, there's not a great way to manually set the public key, so let openssl just parse
-         * the der document manually now that we know what parts are what. */
-        if (!d2i_ECPrivateKey(&key_impl->ec_key, (const unsigned char **)&encoded_keys->ptr, encoded_keys->len)) {
-            aws_mem_release(allocator, key_impl);
-            aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+        struct libcrypto_ecc_key *key_impl = s_key_impl_new(allocator, curve_name);
+        if (!key_impl) {
             goto error;
         }
-
-        key_impl->key_pair.allocator = allocator;
-        key_impl->key_pair.vtable = &vtable;
-        key_impl->key_pair.impl = key_impl;
-        aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
         key = &key_impl->key_pair;
 
-        struct aws_byte_buf temp_buf;
-        AWS_ZERO_STRUCT(temp_buf);
-
-        if (pub_x.ptr) {
-            temp_buf = aws_byte_buf_from_array(pub_x.ptr, pub_x.len);
-            if (aws_byte_buf_init_copy(&key->pub_x, allocator, &temp_buf)) {
-                goto error;
-            }
-        }
-
-        if (pub_y.ptr) {
-            temp_buf = aws_byte_buf_from_array(pub_y.ptr, pub_y.len);
-            if (aws_byte_buf_init_copy(&key->pub_y, allocator, &temp_buf)) {
-                goto error;
-            }
+        /* as awkward as it seems, there's not a great way to manually set the public key, so let openssl just parse
+         * the der document manually now that we know what parts are what. */
+        const unsigned char *der_ptr = encoded_keys->ptr;
+        if (!d2i_ECPrivateKey(&key_impl->ec_key, &der_ptr, (long)encoded_keys->len)) {
+            aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+            goto error;
         }
 
-        if (priv_d.ptr) {
-            temp_buf = aws_byte_buf_from_array(priv_d.ptr, priv_d.len);
-            if (aws_byte_buf_init_copy(&key->priv_d, allocator, &temp_buf)) {
-                goto error;
-            }
+        if ((pub_x.ptr && s_write_coordinate(&key->pub_x, &pub_x)) ||
+            (pub_y.ptr && s_write_coordinate(&key->pub_y, &pub_y)) || s_write_coordinate(&key->priv_d, &priv_d)) {
+            goto error;
         }
 
     } else {
@@ -365,11 +797,9 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
         }
     }
 
-    aws_der_decoder_destroy(decoder);
     return key;
 
 error:
-    aws_der_decoder_destroy(decoder);
     s_key_pair_destroy(key);
 
     return NULL;
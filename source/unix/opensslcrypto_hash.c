@@ -2,20 +2,50 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/cal/cal.h>
 #include <aws/cal/hash.h>
 #include <aws/cal/private/opensslcrypto_common.h>
 
 #include <openssl/evp.h>
 #include <openssl/sha.h>
 
+/* SHA-512/256 arrived in OpenSSL 1.1.1, AWS-LC has always had it. */
+#if defined(OPENSSL_IS_AWSLC) || (!defined(OPENSSL_IS_BORINGSSL) && OPENSSL_VERSION_NUMBER >= 0x10101000L)
+#    define AWS_OPENSSL_HAS_SHA512_256
+#endif
+
+/* AWS-LC has public functions to read and restore the state of SHA-1 and SHA-256, no other libcrypto does. */
+#if defined(OPENSSL_IS_AWSLC) && defined(SHA1_CHAINING_LENGTH) && defined(SHA256_CHAINING_LENGTH)
+#    define AWS_OPENSSL_HAS_SHA_STATE
+#endif
+
 static void s_destroy(struct aws_hash *hash);
 static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
+static int s_update_vectored(struct aws_hash *hash, const struct aws_byte_cursor *segments, size_t segment_count);
 static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_md5_reset(struct aws_hash *hash);
+static int s_sha256_reset(struct aws_hash *hash);
+static int s_sha1_reset(struct aws_hash *hash);
+static int s_sha384_reset(struct aws_hash *hash);
+static int s_sha512_reset(struct aws_hash *hash);
+#if defined(AWS_OPENSSL_HAS_SHA512_256)
+static int s_sha512_256_reset(struct aws_hash *hash);
+#endif
+#if defined(AWS_OPENSSL_HAS_SHA_STATE)
+static int s_sha1_export_state(const struct aws_hash *hash, struct aws_hash_md_state *state);
+static int s_sha1_import_state(struct aws_hash *hash, const struct aws_hash_md_state *state);
+static int s_sha256_export_state(const struct aws_hash *hash, struct aws_hash_md_state *state);
+static int s_sha256_import_state(struct aws_hash *hash, const struct aws_hash_md_state *state);
+#endif
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
 
 static struct aws_hash_vtable s_md5_vtable = {
     .destroy = s_destroy,
     .update = s_update,
+    .update_vectored = s_update_vectored,
     .finalize = s_finalize,
+    .reset = s_md5_reset,
+    .duplicate = s_duplicate,
     .alg_name = "MD5",
     .provider = "OpenSSL Compatible libcrypto",
 };
@@ -23,7 +53,14 @@ static struct aws_hash_vtable s_md5_vtable = {
 static struct aws_hash_vtable s_sha256_vtable = {
     .destroy = s_destroy,
     .update = s_update,
+    .update_vectored = s_update_vectored,
     .finalize = s_finalize,
+    .reset = s_sha256_reset,
+    .duplicate = s_duplicate,
+#if defined(AWS_OPENSSL_HAS_SHA_STATE)
+    .export_state = s_sha256_export_state,
+    .import_state = s_sha256_import_state,
+#endif
     .alg_name = "SHA256",
     .provider = "OpenSSL Compatible libcrypto",
 };
@@ -31,11 +68,53 @@ static struct aws_hash_vtable s_sha256_vtable = {
 static struct aws_hash_vtable s_sha1_vtable = {
     .destroy = s_destroy,
     .update = s_update,
+    .update_vectored = s_update_vectored,
     .finalize = s_finalize,
+    .reset = s_sha1_reset,
+    .duplicate = s_duplicate,
+#if defined(AWS_OPENSSL_HAS_SHA_STATE)
+    .export_state = s_sha1_export_state,
+    .import_state = s_sha1_import_state,
+#endif
     .alg_name = "SHA1",
     .provider = "OpenSSL Compatible libcrypto",
 };
 
+static struct aws_hash_vtable s_sha384_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .update_vectored = s_update_vectored,
+    .finalize = s_finalize,
+    .reset = s_sha384_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA384",
+    .provider = "OpenSSL Compatible libcrypto",
+};
+
+static struct aws_hash_vtable s_sha512_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .update_vectored = s_update_vectored,
+    .finalize = s_finalize,
+    .reset = s_sha512_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA512",
+    .provider = "OpenSSL Compatible libcrypto",
+};
+
+#if defined(AWS_OPENSSL_HAS_SHA512_256)
+static struct aws_hash_vtable s_sha512_256_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .update_vectored = s_update_vectored,
+    .finalize = s_finalize,
+    .reset = s_sha512_256_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA512/256",
+    .provider = "OpenSSL Compatible libcrypto",
+};
+#endif
+
 static void s_destroy(struct aws_hash *hash) {
     if (hash == NULL) {
         return;
@@ -43,13 +122,19 @@ static void s_destroy(struct aws_hash *hash) {
 
     EVP_MD_CTX *ctx = hash->impl;
     if (ctx != NULL) {
-        g_aws_openssl_evp_md_ctx_table->free_fn(ctx);
+        aws_openssl_evp_md_ctx_free(ctx);
     }
 
     aws_mem_release(hash->allocator, hash);
 }
 
-struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator) {
+static struct aws_hash *s_hash_new(
+    struct aws_allocator *allocator,
+    struct aws_hash_vtable *vtable,
+    size_t digest_size,
+    const EVP_MD *md) {
+    aws_openssl_ensure_libcrypto_resolved();
+
     struct aws_hash *hash = aws_mem_acquire(allocator, sizeof(struct aws_hash));
 
     if (!hash) {
@@ -57,9 +142,9 @@ struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator) {
     }
 
     hash->allocator = allocator;
-    hash->vtable = &s_md5_vtable;
-    hash->digest_size = AWS_MD5_LEN;
-    EVP_MD_CTX *ctx = g_aws_openssl_evp_md_ctx_table->new_fn();
+    hash->vtable = vtable;
+    hash->digest_size = digest_size;
+    EVP_MD_CTX *ctx = aws_openssl_evp_md_ctx_new();
     hash->impl = ctx;
     hash->good = true;
 
@@ -69,7 +154,7 @@ struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator) {
         return NULL;
     }
 
-    if (!g_aws_openssl_evp_md_ctx_table->init_ex_fn(ctx, EVP_md5(), NULL)) {
+    if (!aws_openssl_evp_digest_init_ex(ctx, md, NULL)) {
         s_destroy(hash);
         aws_raise_error(AWS_ERROR_UNKNOWN);
         return NULL;
@@ -78,62 +163,106 @@ struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator) {
     return hash;
 }
 
-struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator) {
-    struct aws_hash *hash = aws_mem_acquire(allocator, sizeof(struct aws_hash));
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    struct aws_hash *copy = aws_mem_acquire(allocator, sizeof(struct aws_hash));
 
-    if (!hash) {
+    if (!copy) {
         return NULL;
     }
 
-    hash->allocator = allocator;
-    hash->vtable = &s_sha256_vtable;
-    hash->digest_size = AWS_SHA256_LEN;
-    EVP_MD_CTX *ctx = g_aws_openssl_evp_md_ctx_table->new_fn();
-    hash->impl = ctx;
-    hash->good = true;
+    *copy = *hash;
+    copy->allocator = allocator;
+    EVP_MD_CTX *ctx = aws_openssl_evp_md_ctx_new();
+    copy->impl = ctx;
 
-    if (!hash->impl) {
-        s_destroy(hash);
+    if (!ctx) {
+        s_destroy(copy);
         aws_raise_error(AWS_ERROR_OOM);
         return NULL;
     }
 
-    if (!g_aws_openssl_evp_md_ctx_table->init_ex_fn(ctx, EVP_sha256(), NULL)) {
-        s_destroy(hash);
+    if (!aws_openssl_evp_md_ctx_copy_ex(ctx, hash->impl)) {
+        s_destroy(copy);
         aws_raise_error(AWS_ERROR_UNKNOWN);
         return NULL;
     }
 
-    return hash;
+    return copy;
+}
+
+struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator) {
+    return s_hash_new(allocator, &s_md5_vtable, AWS_MD5_LEN, EVP_md5());
+}
+
+struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator) {
+    return s_hash_new(allocator, &s_sha256_vtable, AWS_SHA256_LEN, EVP_sha256());
 }
 
 struct aws_hash *aws_sha1_default_new(struct aws_allocator *allocator) {
-    struct aws_hash *hash = aws_mem_acquire(allocator, sizeof(struct aws_hash));
+    return s_hash_new(allocator, &s_sha1_vtable, AWS_SHA1_LEN, EVP_sha1());
+}
 
-    if (!hash) {
-        return NULL;
-    }
+struct aws_hash *aws_sha384_default_new(struct aws_allocator *allocator) {
+    return s_hash_new(allocator, &s_sha384_vtable, AWS_SHA384_LEN, EVP_sha384());
+}
 
-    hash->allocator = allocator;
-    hash->vtable = &s_sha1_vtable;
-    hash->digest_size = AWS_SHA1_LEN;
-    EVP_MD_CTX *ctx = g_aws_openssl_evp_md_ctx_table->new_fn();
-    hash->impl = ctx;
-    hash->good = true;
+struct aws_hash *aws_sha512_default_new(struct aws_allocator *allocator) {
+    return s_hash_new(allocator, &s_sha512_vtable, AWS_SHA512_LEN, EVP_sha512());
+}
 
-    if (!hash->impl) {
-        s_destroy(hash);
-        aws_raise_error(AWS_ERROR_OOM);
-        return NULL;
-    }
+struct aws_hash *aws_sha512_256_default_new(struct aws_allocator *allocator) {
+#if defined(AWS_OPENSSL_HAS_SHA512_256)
+    return s_hash_new(allocator, &s_sha512_256_vtable, AWS_SHA512_256_LEN, EVP_sha512_256());
+#else
+    (void)allocator;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+#endif
+}
 
-    if (!g_aws_openssl_evp_md_ctx_table->init_ex_fn(ctx, EVP_sha1(), NULL)) {
-        s_destroy(hash);
-        aws_raise_error(AWS_ERROR_UNKNOWN);
-        return NULL;
-    }
+/*
+ * AWS-LC and BoringSSL run EVP_Digest() on a context on the stack. OpenSSL allocates a fresh context on every call,
+ * which loses to the cached instances the one-shot functions fall back to, so it doesn't get a single call path.
+ */
+static bool s_digest(const EVP_MD *md, const struct aws_byte_cursor *input, uint8_t *out) {
+#if defined(OPENSSL_IS_AWSLC) || defined(OPENSSL_IS_BORINGSSL)
+    return EVP_Digest(input->ptr, input->len, out, NULL, md, NULL) == 1;
+#else
+    (void)md;
+    (void)input;
+    (void)out;
+    return false;
+#endif
+}
 
-    return hash;
+bool aws_md5_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(EVP_md5(), input, out);
+}
+
+bool aws_sha256_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(EVP_sha256(), input, out);
+}
+
+bool aws_sha1_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(EVP_sha1(), input, out);
+}
+
+bool aws_sha384_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(EVP_sha384(), input, out);
+}
+
+bool aws_sha512_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(EVP_sha512(), input, out);
+}
+
+bool aws_sha512_256_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+#if defined(AWS_OPENSSL_HAS_SHA512_256)
+    return s_digest(EVP_sha512_256(), input, out);
+#else
+    (void)input;
+    (void)out;
+    return false;
+#endif
 }
 
 static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash) {
@@ -143,7 +272,7 @@ static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash
 
     EVP_MD_CTX *ctx = hash->impl;
 
-    if (AWS_LIKELY(g_aws_openssl_evp_md_ctx_table->update_fn(ctx, to_hash->ptr, to_hash->len))) {
+    if (AWS_LIKELY(aws_openssl_evp_digest_update(ctx, to_hash->ptr, to_hash->len))) {
         return AWS_OP_SUCCESS;
     }
 
@@ -151,6 +280,23 @@ static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash
     return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
 }
 
+static int s_update_vectored(struct aws_hash *hash, const struct aws_byte_cursor *segments, size_t segment_count) {
+    if (!hash->good) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    EVP_MD_CTX *ctx = hash->impl;
+
+    for (size_t i = 0; i < segment_count; ++i) {
+        if (AWS_UNLIKELY(!aws_openssl_evp_digest_update(ctx, segments[i].ptr, segments[i].len))) {
+            hash->good = false;
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
     if (!hash->good) {
         return aws_raise_error(AWS_ERROR_INVALID_STATE);
@@ -164,8 +310,7 @@ static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
-    if (AWS_LIKELY(g_aws_openssl_evp_md_ctx_table->final_ex_fn(
-            ctx, output->buffer + output->len, (unsigned int *)&buffer_len))) {
+    if (AWS_LIKELY(aws_openssl_evp_digest_final_ex(ctx, output->buffer + output->len, (unsigned int *)&buffer_len))) {
         output->len += hash->digest_size;
         hash->good = false;
         return AWS_OP_SUCCESS;
@@ -174,3 +319,147 @@ static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
     hash->good = false;
     return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
 }
+
+/* Re-running init_ex on a context that already holds the same digest reuses its state
+ * buffer, so no allocation or provider lookup happens here. */
+static int s_reset(struct aws_hash *hash, const EVP_MD *md) {
+    EVP_MD_CTX *ctx = hash->impl;
+
+    if (AWS_UNLIKELY(!aws_openssl_evp_digest_init_ex(ctx, md, NULL))) {
+        hash->good = false;
+        return aws_raise_error(AWS_ERROR_UNKNOWN);
+    }
+
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_md5_reset(struct aws_hash *hash) {
+    return s_reset(hash, EVP_md5());
+}
+
+static int s_sha256_reset(struct aws_hash *hash) {
+    return s_reset(hash, EVP_sha256());
+}
+
+static int s_sha1_reset(struct aws_hash *hash) {
+    return s_reset(hash, EVP_sha1());
+}
+
+static int s_sha384_reset(struct aws_hash *hash) {
+    return s_reset(hash, EVP_sha384());
+}
+
+static int s_sha512_reset(struct aws_hash *hash) {
+    return s_reset(hash, EVP_sha512());
+}
+
+#if defined(AWS_OPENSSL_HAS_SHA512_256)
+static int s_sha512_256_reset(struct aws_hash *hash) {
+    return s_reset(hash, EVP_sha512_256());
+}
+#endif
+
+#if defined(AWS_OPENSSL_HAS_SHA_STATE)
+/*
+ * SHA1_get_state() and SHA256_get_state() only report a context that holds no partial block, so a state can be
+ * exported on 64 byte boundaries. Importing restores the last whole block and then hashes what was buffered.
+ */
+static void s_load_chaining_values(const uint8_t *be_values, size_t word_count, uint32_t *values) {
+    for (size_t i = 0; i < word_count; ++i) {
+        const uint8_t *word = be_values + i * sizeof(uint32_t);
+        values[i] = ((uint32_t)word[0] << 24) | ((uint32_t)word[1] << 16) | ((uint32_t)word[2] << 8) | word[3];
+    }
+}
+
+static void s_store_chaining_values(const uint32_t *values, size_t word_count, uint8_t *be_values) {
+    for (size_t i = 0; i < word_count; ++i) {
+        uint8_t *word = be_values + i * sizeof(uint32_t);
+        word[0] = (uint8_t)(values[i] >> 24);
+        word[1] = (uint8_t)(values[i] >> 16);
+        word[2] = (uint8_t)(values[i] >> 8);
+        word[3] = (uint8_t)values[i];
+    }
+}
+
+/* the number of bits in the whole blocks of state, which is what the *_Init_from_state() functions take. SHA-1 and
+ * SHA-256 both use 64 byte blocks. */
+static uint64_t s_block_aligned_bits(const struct aws_hash_md_state *state) {
+    return (state->message_len - state->message_len % SHA256_CBLOCK) * 8;
+}
+
+static int s_sha1_export_state(const struct aws_hash *hash, struct aws_hash_md_state *state) {
+    SHA_CTX *sha_ctx = aws_openssl_evp_md_ctx_md_data(hash->impl);
+    uint8_t chaining_values[SHA1_CHAINING_LENGTH];
+    uint64_t bits = 0;
+    if (sha_ctx == NULL || !SHA1_get_state(sha_ctx, chaining_values, &bits)) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    s_load_chaining_values(chaining_values, SHA1_CHAINING_LENGTH / sizeof(uint32_t), state->chaining_values);
+    state->message_len = bits / 8;
+    aws_secure_zero(chaining_values, sizeof(chaining_values));
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha1_import_state(struct aws_hash *hash, const struct aws_hash_md_state *state) {
+    /* start from a freshly initialized context, in case this one was finalized */
+    if (hash->vtable->reset(hash)) {
+        return AWS_OP_ERR;
+    }
+
+    SHA_CTX *sha_ctx = aws_openssl_evp_md_ctx_md_data(hash->impl);
+    if (sha_ctx == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    uint8_t chaining_values[SHA1_CHAINING_LENGTH];
+    s_store_chaining_values(state->chaining_values, SHA1_CHAINING_LENGTH / sizeof(uint32_t), chaining_values);
+    int restored = SHA1_Init_from_state(sha_ctx, chaining_values, s_block_aligned_bits(state)) &&
+                   SHA1_Update(sha_ctx, state->buffered, (size_t)(state->message_len % SHA_CBLOCK));
+    aws_secure_zero(chaining_values, sizeof(chaining_values));
+
+    if (!restored) {
+        hash->good = false;
+        return aws_raise_error(AWS_ERROR_UNKNOWN);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha256_export_state(const struct aws_hash *hash, struct aws_hash_md_state *state) {
+    SHA256_CTX *sha_ctx = aws_openssl_evp_md_ctx_md_data(hash->impl);
+    uint8_t chaining_values[SHA256_CHAINING_LENGTH];
+    uint64_t bits = 0;
+    if (sha_ctx == NULL || !SHA256_get_state(sha_ctx, chaining_values, &bits)) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    s_load_chaining_values(chaining_values, SHA256_CHAINING_LENGTH / sizeof(uint32_t), state->chaining_values);
+    state->message_len = bits / 8;
+    aws_secure_zero(chaining_values, sizeof(chaining_values));
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha256_import_state(struct aws_hash *hash, const struct aws_hash_md_state *state) {
+    if (hash->vtable->reset(hash)) {
+        return AWS_OP_ERR;
+    }
+
+    SHA256_CTX *sha_ctx = aws_openssl_evp_md_ctx_md_data(hash->impl);
+    if (sha_ctx == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    uint8_t chaining_values[SHA256_CHAINING_LENGTH];
+    s_store_chaining_values(state->chaining_values, SHA256_CHAINING_LENGTH / sizeof(uint32_t), chaining_values);
+    int restored = SHA256_Init_from_state(sha_ctx, chaining_values, s_block_aligned_bits(state)) &&
+                   SHA256_Update(sha_ctx, state->buffered, (size_t)(state->message_len % SHA256_CBLOCK));
+    aws_secure_zero(chaining_values, sizeof(chaining_values));
+
+    if (!restored) {
+        hash->good = false;
+        return aws_raise_error(AWS_ERROR_UNKNOWN);
+    }
+    return AWS_OP_SUCCESS;
+}
+#endif /* AWS_OPENSSL_HAS_SHA_STATE */
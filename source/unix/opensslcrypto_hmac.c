@@ -11,15 +11,43 @@
 static void s_destroy(struct aws_hmac *hmac);
 static int s_update(struct aws_hmac *hmac, const struct aws_byte_cursor *to_hmac);
 static int s_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output);
+static int s_reset(struct aws_hmac *hmac);
+static struct aws_hmac *s_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac);
+static int s_rekey(struct aws_hmac *hmac, const struct aws_byte_cursor *secret);
 
 static struct aws_hmac_vtable s_sha256_hmac_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
     .alg_name = "SHA256 HMAC",
     .provider = "OpenSSL Compatible libcrypto",
 };
 
+static struct aws_hmac_vtable s_sha384_hmac_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
+    .alg_name = "SHA384 HMAC",
+    .provider = "OpenSSL Compatible libcrypto",
+};
+
+static struct aws_hmac_vtable s_sha512_hmac_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
+    .alg_name = "SHA512 HMAC",
+    .provider = "OpenSSL Compatible libcrypto",
+};
+
 static void s_destroy(struct aws_hmac *hmac) {
     if (hmac == NULL) {
         return;
@@ -27,7 +55,7 @@ static void s_destroy(struct aws_hmac *hmac) {
 
     HMAC_CTX *ctx = hmac->impl;
     if (ctx != NULL) {
-        g_aws_openssl_hmac_ctx_table->free_fn(ctx);
+        aws_openssl_hmac_ctx_free(ctx);
     }
 
     aws_mem_release(hmac->allocator, hmac);
@@ -47,9 +75,16 @@ typedef struct hmac_ctx_st {
 
 #define SIZEOF_OPENSSL_HMAC_CTX 300 /* <= 288 on 64 bit systems with openssl 1.0.* */
 
-struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+static struct aws_hmac *s_hmac_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    struct aws_hmac_vtable *vtable,
+    size_t digest_size,
+    const EVP_MD *md) {
     AWS_ASSERT(secret->ptr);
 
+    aws_openssl_ensure_libcrypto_resolved();
+
     struct aws_hmac *hmac = aws_mem_acquire(allocator, sizeof(struct aws_hmac));
 
     if (!hmac) {
@@ -57,10 +92,10 @@ struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, co
     }
 
     hmac->allocator = allocator;
-    hmac->vtable = &s_sha256_hmac_vtable;
-    hmac->digest_size = AWS_SHA256_HMAC_LEN;
+    hmac->vtable = vtable;
+    hmac->digest_size = digest_size;
     HMAC_CTX *ctx = NULL;
-    ctx = g_aws_openssl_hmac_ctx_table->new_fn();
+    ctx = aws_openssl_hmac_ctx_new();
 
     if (!ctx) {
         aws_raise_error(AWS_ERROR_OOM);
@@ -68,12 +103,12 @@ struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, co
         return NULL;
     }
 
-    g_aws_openssl_hmac_ctx_table->init_fn(ctx);
+    aws_openssl_hmac_ctx_init(ctx);
 
     hmac->impl = ctx;
     hmac->good = true;
 
-    if (!g_aws_openssl_hmac_ctx_table->init_ex_fn(ctx, secret->ptr, secret->len, EVP_sha256(), NULL)) {
+    if (!aws_openssl_hmac_init_ex(ctx, secret->ptr, secret->len, md, NULL)) {
         s_destroy(hmac);
         aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
         return NULL;
@@ -82,6 +117,18 @@ struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, co
     return hmac;
 }
 
+struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_new(allocator, secret, &s_sha256_hmac_vtable, AWS_SHA256_HMAC_LEN, EVP_sha256());
+}
+
+struct aws_hmac *aws_sha384_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_new(allocator, secret, &s_sha384_hmac_vtable, AWS_SHA384_HMAC_LEN, EVP_sha384());
+}
+
+struct aws_hmac *aws_sha512_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    return s_hmac_new(allocator, secret, &s_sha512_hmac_vtable, AWS_SHA512_HMAC_LEN, EVP_sha512());
+}
+
 static int s_update(struct aws_hmac *hmac, const struct aws_byte_cursor *to_hmac) {
     if (!hmac->good) {
         return aws_raise_error(AWS_ERROR_INVALID_STATE);
@@ -89,7 +136,7 @@ static int s_update(struct aws_hmac *hmac, const struct aws_byte_cursor *to_hmac
 
     HMAC_CTX *ctx = hmac->impl;
 
-    if (AWS_LIKELY(g_aws_openssl_hmac_ctx_table->update_fn(ctx, to_hmac->ptr, to_hmac->len))) {
+    if (AWS_LIKELY(aws_openssl_hmac_update(ctx, to_hmac->ptr, to_hmac->len))) {
         return AWS_OP_SUCCESS;
     }
 
@@ -110,8 +157,7 @@ static int s_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
-    if (AWS_LIKELY(
-            g_aws_openssl_hmac_ctx_table->final_fn(ctx, output->buffer + output->len, (unsigned int *)&buffer_len))) {
+    if (AWS_LIKELY(aws_openssl_hmac_final(ctx, output->buffer + output->len, (unsigned int *)&buffer_len))) {
         hmac->good = false;
         output->len += hmac->digest_size;
         return AWS_OP_SUCCESS;
@@ -120,3 +166,66 @@ static int s_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output) {
     hmac->good = false;
     return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
 }
+
+static int s_reset(struct aws_hmac *hmac) {
+    HMAC_CTX *ctx = hmac->impl;
+
+    /* a NULL key and md restart from the keyed inner state kept in the ctx, the pads are not rehashed */
+    if (AWS_LIKELY(aws_openssl_hmac_init_ex(ctx, NULL, 0, NULL, NULL))) {
+        hmac->good = true;
+        return AWS_OP_SUCCESS;
+    }
+
+    hmac->good = false;
+    return aws_raise_error(AWS_ERROR_INVALID_STATE);
+}
+
+static struct aws_hmac *s_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac) {
+    if (!hmac->good) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    struct aws_hmac *copy = aws_mem_acquire(allocator, sizeof(struct aws_hmac));
+
+    if (!copy) {
+        return NULL;
+    }
+
+    *copy = *hmac;
+    copy->allocator = allocator;
+
+    HMAC_CTX *ctx = aws_openssl_hmac_ctx_new();
+
+    if (!ctx) {
+        aws_raise_error(AWS_ERROR_OOM);
+        aws_mem_release(allocator, copy);
+        return NULL;
+    }
+
+    aws_openssl_hmac_ctx_init(ctx);
+    copy->impl = ctx;
+
+    if (!aws_openssl_hmac_ctx_copy(ctx, hmac->impl)) {
+        s_destroy(copy);
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    return copy;
+}
+
+static int s_rekey(struct aws_hmac *hmac, const struct aws_byte_cursor *secret) {
+    AWS_ASSERT(secret->ptr);
+
+    HMAC_CTX *ctx = hmac->impl;
+
+    /* a NULL md keeps the digest the ctx was created with */
+    if (AWS_LIKELY(aws_openssl_hmac_init_ex(ctx, secret->ptr, secret->len, NULL, NULL))) {
+        hmac->good = true;
+        return AWS_OP_SUCCESS;
+    }
+
+    hmac->good = false;
+    return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+}
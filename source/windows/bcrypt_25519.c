@@ -0,0 +1,396 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/private/ecc.h>
+
+#include <aws/cal/cal.h>
+
+#include <aws/common/thread.h>
+
+#include <windows.h>
+
+#include <bcrypt.h>
+
+/*
+ * X25519 goes through the generic ECDH provider with the curve set by name, which needs Windows 10. CNG has no
+ * Ed25519. Key blobs hold their values as big endian integers, the same as for the NIST curves, while RFC 7748 encodes
+ * keys little endian, so keys are byte reversed on the way in and out. The raw secret comes back little endian, which
+ * already is the RFC 7748 encoding.
+ */
+
+/* older SDKs don't name these */
+#ifndef BCRYPT_ECDH_ALGORITHM
+#    define BCRYPT_ECDH_ALGORITHM L"ECDH"
+#endif
+#ifndef BCRYPT_ECC_CURVE_NAME
+#    define BCRYPT_ECC_CURVE_NAME L"ECCCurveName"
+#endif
+#ifndef BCRYPT_ECC_CURVE_25519
+#    define BCRYPT_ECC_CURVE_25519 L"curve25519"
+#endif
+#ifndef BCRYPT_ECDH_PUBLIC_GENERIC_MAGIC
+#    define BCRYPT_ECDH_PUBLIC_GENERIC_MAGIC 0x504B4345
+#endif
+#ifndef BCRYPT_ECDH_PRIVATE_GENERIC_MAGIC
+#    define BCRYPT_ECDH_PRIVATE_GENERIC_MAGIC 0x564B4345
+#endif
+#ifndef BCRYPT_KDF_RAW_SECRET
+#    define BCRYPT_KDF_RAW_SECRET L"TRUNCATE"
+#endif
+
+#define KEY_25519_BYTE_LEN 32
+/* the header, x, y (always zero) and d */
+#define KEY_BLOB_25519_LEN (sizeof(BCRYPT_ECCKEY_BLOB) + KEY_25519_BYTE_LEN * 3)
+
+static BCRYPT_ALG_HANDLE s_x25519_alg = NULL;
+static aws_thread_once s_x25519_thread_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static void s_load_x25519_alg_handle(void *user_data) {
+    (void)user_data;
+    /* like the NIST curve handles in bcrypt_ecc.c, this one is left to leak */
+    BCRYPT_ALG_HANDLE alg = NULL;
+    if (BCryptOpenAlgorithmProvider(&alg, BCRYPT_ECDH_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0)) {
+        return;
+    }
+
+    /* versions without named curves fail here, and X25519 is then reported as unsupported */
+    if (BCryptSetProperty(
+            alg,
+            BCRYPT_ECC_CURVE_NAME,
+            (PUCHAR)BCRYPT_ECC_CURVE_25519,
+            (ULONG)sizeof(BCRYPT_ECC_CURVE_25519),
+            0)) {
+        BCryptCloseAlgorithmProvider(alg, 0);
+        return;
+    }
+
+    s_x25519_alg = alg;
+}
+
+static BCRYPT_ALG_HANDLE s_alg_handle_from_curve_name(enum aws_ecc_curve_name curve_name) {
+    if (curve_name == AWS_CAL_X25519) {
+        aws_thread_call_once(&s_x25519_thread_once, s_load_x25519_alg_handle, NULL);
+        if (s_x25519_alg) {
+            return s_x25519_alg;
+        }
+    }
+
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct bcrypt_25519_key {
+    struct aws_ecc_key_pair key_pair;
+    BCRYPT_KEY_HANDLE key_handle;
+};
+
+static void s_reverse_copy(uint8_t *dest, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = src[len - 1 - i];
+    }
+}
+
+static void s_key_pair_destroy(struct aws_ecc_key_pair *key_pair) {
+    if (key_pair) {
+        aws_byte_buf_clean_up(&key_pair->pub_x);
+        aws_byte_buf_clean_up(&key_pair->pub_y);
+        aws_byte_buf_clean_up_secure(&key_pair->priv_d);
+
+        struct bcrypt_25519_key *key_impl = key_pair->impl;
+
+        if (key_impl->key_handle) {
+            BCryptDestroyKey(key_impl->key_handle);
+        }
+        aws_mem_release(key_pair->allocator, key_impl);
+    }
+}
+
+/* fills in pub_x, and priv_d too when private_key is set, from the key CNG holds */
+static int s_export_key(struct bcrypt_25519_key *key_impl, bool private_key) {
+    uint8_t blob[KEY_BLOB_25519_LEN];
+    ULONG blob_len = 0;
+    NTSTATUS status = BCryptExportKey(
+        key_impl->key_handle,
+        NULL,
+        private_key ? BCRYPT_ECCPRIVATE_BLOB : BCRYPT_ECCPUBLIC_BLOB,
+        blob,
+        (ULONG)sizeof(blob),
+        &blob_len,
+        0);
+
+    int result = AWS_OP_ERR;
+    BCRYPT_ECCKEY_BLOB *header = (BCRYPT_ECCKEY_BLOB *)blob;
+    size_t expected_len = sizeof(BCRYPT_ECCKEY_BLOB) + KEY_25519_BYTE_LEN * (private_key ? 3 : 2);
+    if (status || blob_len != expected_len || header->cbKey != KEY_25519_BYTE_LEN) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        goto clean_up;
+    }
+
+    struct aws_ecc_key_pair *key_pair = &key_impl->key_pair;
+    if (aws_byte_buf_init(&key_pair->pub_x, key_pair->allocator, KEY_25519_BYTE_LEN)) {
+        goto clean_up;
+    }
+    s_reverse_copy(key_pair->pub_x.buffer, blob + sizeof(BCRYPT_ECCKEY_BLOB), KEY_25519_BYTE_LEN);
+    key_pair->pub_x.len = KEY_25519_BYTE_LEN;
+
+    if (private_key) {
+        if (aws_byte_buf_init(&key_pair->priv_d, key_pair->allocator, KEY_25519_BYTE_LEN)) {
+            goto clean_up;
+        }
+        s_reverse_copy(
+            key_pair->priv_d.buffer, blob + sizeof(BCRYPT_ECCKEY_BLOB) + KEY_25519_BYTE_LEN * 2, KEY_25519_BYTE_LEN);
+        key_pair->priv_d.len = KEY_25519_BYTE_LEN;
+    }
+
+    result = AWS_OP_SUCCESS;
+
+clean_up:
+    aws_secure_zero(blob, sizeof(blob));
+    return result;
+}
+
+static int s_derive_public_key(struct aws_ecc_key_pair *key_pair) {
+    if (!key_pair->priv_d.buffer) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    /* we already have a public key. */
+    if (key_pair->pub_x.len) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return s_export_key(key_pair->impl, false);
+}
+
+static int s_x25519_sign(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+    (void)key_pair;
+    (void)message;
+    (void)signature_output;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+static int s_x25519_verify(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    (void)key_pair;
+    (void)message;
+    (void)signature;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+static size_t s_x25519_signature_length(const struct aws_ecc_key_pair *key_pair) {
+    (void)key_pair;
+    return 0;
+}
+
+static int s_x25519_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output) {
+    struct bcrypt_25519_key *key_impl = key_pair->impl;
+    struct bcrypt_25519_key *peer_impl = peer_key->impl;
+
+    if (!key_pair->priv_d.len) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    BCRYPT_SECRET_HANDLE secret_handle = NULL;
+    if (BCryptSecretAgreement(key_impl->key_handle, peer_impl->key_handle, &secret_handle, 0)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint8_t *secret = shared_secret_output->buffer + shared_secret_output->len;
+    ULONG written = 0;
+    NTSTATUS status =
+        BCryptDeriveKey(secret_handle, BCRYPT_KDF_RAW_SECRET, NULL, secret, KEY_25519_BYTE_LEN, &written, 0);
+    BCryptDestroySecret(secret_handle);
+
+    /* reject peers of small order, whose shared secret is all zeros, the same as libcrypto does */
+    uint8_t any_set = 0;
+    for (size_t i = 0; i < KEY_25519_BYTE_LEN; ++i) {
+        any_set |= secret[i];
+    }
+
+    if (status || written != KEY_25519_BYTE_LEN || any_set == 0) {
+        aws_secure_zero(secret, KEY_25519_BYTE_LEN);
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    shared_secret_output->len += KEY_25519_BYTE_LEN;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_ecc_key_pair_vtable s_x25519_vtable = {
+    .destroy = s_key_pair_destroy,
+    .derive_pub_key = s_derive_public_key,
+    .sign_message = s_x25519_sign,
+    .verify_signature = s_x25519_verify,
+    .signature_length = s_x25519_signature_length,
+    .derive_shared_secret = s_x25519_derive_shared_secret,
+};
+
+static struct bcrypt_25519_key *s_key_new(struct aws_allocator *allocator, enum aws_ecc_curve_name curve_name) {
+    struct bcrypt_25519_key *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct bcrypt_25519_key));
+    if (!key_impl) {
+        return NULL;
+    }
+
+    key_impl->key_pair.curve_name = curve_name;
+    key_impl->key_pair.allocator = allocator;
+    key_impl->key_pair.vtable = &s_x25519_vtable;
+    key_impl->key_pair.impl = key_impl;
+    aws_atomic_init_int(&key_impl->key_pair.ref_count, 1);
+
+    return key_impl;
+}
+
+static int s_import_key(
+    BCRYPT_ALG_HANDLE alg_handle,
+    struct bcrypt_25519_key *key_impl,
+    uint8_t *blob,
+    bool private_key) {
+    NTSTATUS status = BCryptImportKeyPair(
+        alg_handle,
+        NULL,
+        private_key ? BCRYPT_ECCPRIVATE_BLOB : BCRYPT_ECCPUBLIC_BLOB,
+        &key_impl->key_handle,
+        blob,
+        (ULONG)(sizeof(BCRYPT_ECCKEY_BLOB) + KEY_25519_BYTE_LEN * (private_key ? 3 : 2)),
+        private_key ? BCRYPT_NO_KEY_VALIDATION : 0);
+    aws_secure_zero(blob, KEY_BLOB_25519_LEN);
+
+    if (status) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_private_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *priv_key) {
+
+    BCRYPT_ALG_HANDLE alg_handle = s_alg_handle_from_curve_name(curve_name);
+    if (!alg_handle) {
+        return NULL;
+    }
+
+    if (priv_key->len != KEY_25519_BYTE_LEN) {
+        aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
+        return NULL;
+    }
+
+    struct bcrypt_25519_key *key_impl = s_key_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
+
+    /* the public key is left empty for CNG to compute, see s_derive_public_key() */
+    uint8_t blob[KEY_BLOB_25519_LEN] = {0};
+    BCRYPT_ECCKEY_BLOB *header = (BCRYPT_ECCKEY_BLOB *)blob;
+    header->dwMagic = BCRYPT_ECDH_PRIVATE_GENERIC_MAGIC;
+    header->cbKey = KEY_25519_BYTE_LEN;
+
+    /* clamped as RFC 7748 decodes scalars, which leaves the result of X25519 unchanged */
+    uint8_t *d = blob + sizeof(BCRYPT_ECCKEY_BLOB) + KEY_25519_BYTE_LEN * 2;
+    s_reverse_copy(d, priv_key->ptr, KEY_25519_BYTE_LEN);
+    d[KEY_25519_BYTE_LEN - 1] &= 0xF8;
+    d[0] &= 0x7F;
+    d[0] |= 0x40;
+
+    if (s_import_key(alg_handle, key_impl, blob, true)) {
+        goto error;
+    }
+
+    if (aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.priv_d, allocator, *priv_key)) {
+        goto error;
+    }
+
+    return &key_impl->key_pair;
+
+error:
+    s_key_pair_destroy(&key_impl->key_pair);
+    return NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_public_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *public_key) {
+
+    BCRYPT_ALG_HANDLE alg_handle = s_alg_handle_from_curve_name(curve_name);
+    if (!alg_handle) {
+        return NULL;
+    }
+
+    if (public_key->len != KEY_25519_BYTE_LEN) {
+        aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
+        return NULL;
+    }
+
+    struct bcrypt_25519_key *key_impl = s_key_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
+
+    uint8_t blob[KEY_BLOB_25519_LEN] = {0};
+    BCRYPT_ECCKEY_BLOB *header = (BCRYPT_ECCKEY_BLOB *)blob;
+    header->dwMagic = BCRYPT_ECDH_PUBLIC_GENERIC_MAGIC;
+    header->cbKey = KEY_25519_BYTE_LEN;
+
+    /* RFC 7748 has the top bit of the u coordinate ignored */
+    uint8_t *x = blob + sizeof(BCRYPT_ECCKEY_BLOB);
+    s_reverse_copy(x, public_key->ptr, KEY_25519_BYTE_LEN);
+    x[0] &= 0x7F;
+
+    if (s_import_key(alg_handle, key_impl, blob, false)) {
+        goto error;
+    }
+
+    if (aws_byte_buf_init_copy_from_cursor(&key_impl->key_pair.pub_x, allocator, *public_key)) {
+        goto error;
+    }
+
+    return &key_impl->key_pair;
+
+error:
+    s_key_pair_destroy(&key_impl->key_pair);
+    return NULL;
+}
+
+struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_generate_random_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name) {
+
+    BCRYPT_ALG_HANDLE alg_handle = s_alg_handle_from_curve_name(curve_name);
+    if (!alg_handle) {
+        return NULL;
+    }
+
+    struct bcrypt_25519_key *key_impl = s_key_new(allocator, curve_name);
+    if (!key_impl) {
+        return NULL;
+    }
+
+    if (BCryptGenerateKeyPair(alg_handle, &key_impl->key_handle, 255, 0) ||
+        BCryptFinalizeKeyPair(key_impl->key_handle, 0)) {
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        goto error;
+    }
+
+    if (s_export_key(key_impl, true)) {
+        goto error;
+    }
+
+    return &key_impl->key_pair;
+
+error:
+    s_key_pair_destroy(&key_impl->key_pair);
+    return NULL;
+}
@@ -10,6 +10,10 @@
 #include <bcrypt.h>
 
 #define NT_SUCCESS(status) ((NTSTATUS)status >= 0)
+/* from ntstatus.h, which doesn't get along with windows.h */
+#ifndef STATUS_AUTH_TAG_MISMATCH
+#    define STATUS_AUTH_TAG_MISMATCH ((NTSTATUS)0xC000A002L)
+#endif
 
 /* handles for AES modes and algorithms we'll be using. These are initialized once and allowed to leak. */
 static aws_thread_once s_aes_thread_once = AWS_THREAD_ONCE_STATIC_INIT;
@@ -34,6 +38,22 @@ struct aes_bcrypt_cipher {
     struct aws_byte_buf working_iv;
     /* A buffer to keep around for the GMAC for GCM. */
     struct aws_byte_buf working_mac_buffer;
+    /* CTR only. The last ctr_keystream_len bytes of ctr_keystream are keystream that hasn't been used yet, left over
+       from a call that ended part way through a block. */
+    uint8_t ctr_keystream[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    size_t ctr_keystream_len;
+    /* Set when the cipher was made from a prepared key. cipher.key then borrows the prepared key's bytes and key_handle
+       is duplicated from the prepared key's handle instead of imported. */
+    struct aws_aes_256_prepared_key *prepared_key;
+};
+
+/* One imported key handle per algorithm handle, imported the first time a cipher of that mode is made and never
+   modified after it's published. The iv is always set on the duplicate, never on these. */
+struct aes_bcrypt_prepared_key {
+    struct aws_atomic_var cbc_key_handle;
+    struct aws_atomic_var gcm_key_handle;
+    struct aws_atomic_var ctr_key_handle;
+    struct aws_atomic_var keywrap_key_handle;
 };
 
 static void s_load_alg_handles(void *user_data) {
@@ -70,7 +90,7 @@ static void s_load_alg_handles(void *user_data) {
     AWS_FATAL_ASSERT(s_aes_ctr_algorithm_handle && "BCryptOpenAlgorithmProvider() failed");
 
     /* This is ECB because windows doesn't do CTR mode for you.
-       Instead we use ECB and XOR the encrypted IV and data to operate on for each block. */
+       Instead we use ECB to encrypt a batch of counter blocks and XOR that with the data. */
     status = BCryptSetProperty(
         s_aes_ctr_algorithm_handle,
         BCRYPT_CHAINING_MODE,
@@ -117,10 +137,96 @@ static BCRYPT_KEY_HANDLE s_import_key_blob(
     return key_handle;
 }
 
+int aws_aes_256_prepared_key_init_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    aws_thread_call_once(&s_aes_thread_once, s_load_alg_handles, NULL);
+
+    struct aes_bcrypt_prepared_key *prepared_impl =
+        aws_mem_calloc(prepared_key->allocator, 1, sizeof(struct aes_bcrypt_prepared_key));
+    aws_atomic_init_ptr(&prepared_impl->cbc_key_handle, NULL);
+    aws_atomic_init_ptr(&prepared_impl->gcm_key_handle, NULL);
+    aws_atomic_init_ptr(&prepared_impl->ctr_key_handle, NULL);
+    aws_atomic_init_ptr(&prepared_impl->keywrap_key_handle, NULL);
+
+    prepared_key->impl = prepared_impl;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_aes_256_prepared_key_clean_up_impl(struct aws_aes_256_prepared_key *prepared_key) {
+    struct aes_bcrypt_prepared_key *prepared_impl = prepared_key->impl;
+    struct aws_atomic_var *slots[] = {
+        &prepared_impl->cbc_key_handle,
+        &prepared_impl->gcm_key_handle,
+        &prepared_impl->ctr_key_handle,
+        &prepared_impl->keywrap_key_handle,
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(slots); ++i) {
+        BCRYPT_KEY_HANDLE key_handle = aws_atomic_load_ptr(slots[i]);
+        if (key_handle) {
+            BCryptDestroyKey(key_handle);
+        }
+    }
+
+    aws_mem_release(prepared_key->allocator, prepared_impl);
+}
+
+/* Duplicates the prepared key's handle for alg_handle, importing it first if no cipher of this mode has been made
+   from the key yet. The duplicate carries the expanded key, so this skips the key schedule. */
+static BCRYPT_KEY_HANDLE s_duplicate_prepared_key_handle(
+    struct aws_aes_256_prepared_key *prepared_key,
+    BCRYPT_ALG_HANDLE alg_handle) {
+    struct aes_bcrypt_prepared_key *prepared_impl = prepared_key->impl;
+
+    struct aws_atomic_var *slot = &prepared_impl->keywrap_key_handle;
+    if (alg_handle == s_aes_cbc_algorithm_handle) {
+        slot = &prepared_impl->cbc_key_handle;
+    } else if (alg_handle == s_aes_gcm_algorithm_handle) {
+        slot = &prepared_impl->gcm_key_handle;
+    } else if (alg_handle == s_aes_ctr_algorithm_handle) {
+        slot = &prepared_impl->ctr_key_handle;
+    }
+
+    BCRYPT_KEY_HANDLE shared_handle = aws_atomic_load_ptr(slot);
+    if (!shared_handle) {
+        shared_handle = s_import_key_blob(alg_handle, prepared_key->allocator, &prepared_key->key);
+        if (!shared_handle) {
+            return NULL;
+        }
+
+        void *published = NULL;
+        if (!aws_atomic_compare_exchange_ptr(slot, &published, shared_handle)) {
+            /* another thread imported it first, use theirs. */
+            BCryptDestroyKey(shared_handle);
+            shared_handle = published;
+        }
+    }
+
+    BCRYPT_KEY_HANDLE key_handle = NULL;
+    if (!NT_SUCCESS(BCryptDuplicateKey(shared_handle, &key_handle, NULL, 0, 0))) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    return key_handle;
+}
+
+/* Points the cipher at prepared_key, if there is one, before s_initialize_cipher_materials() runs. */
+static void s_use_prepared_key(struct aes_bcrypt_cipher *cipher, struct aws_aes_256_prepared_key *prepared_key) {
+    if (prepared_key) {
+        aws_aes_256_prepared_key_acquire(prepared_key);
+        cipher->prepared_key = prepared_key;
+        cipher->cipher.key = aws_byte_buf_from_array(prepared_key->key.buffer, prepared_key->key.len);
+    }
+}
+
 static void s_aes_default_destroy(struct aws_symmetric_cipher *cipher) {
     struct aes_bcrypt_cipher *cipher_impl = cipher->impl;
 
-    aws_byte_buf_clean_up_secure(&cipher->key);
+    if (cipher_impl->prepared_key) {
+        aws_aes_256_prepared_key_release(cipher_impl->prepared_key);
+    } else {
+        aws_byte_buf_clean_up_secure(&cipher->key);
+    }
     aws_byte_buf_clean_up_secure(&cipher->iv);
     aws_byte_buf_clean_up_secure(&cipher->tag);
     aws_byte_buf_clean_up_secure(&cipher->aad);
@@ -161,21 +267,22 @@ static int s_initialize_cipher_materials(
     size_t iv_size,
     bool is_ctr_mode,
     bool is_gcm) {
+    struct aws_allocator *secure_allocator = aws_cal_secure_allocator_for(cipher->cipher.allocator);
 
     if (!cipher->cipher.key.len) {
         if (key) {
-            aws_byte_buf_init_copy_from_cursor(&cipher->cipher.key, cipher->cipher.allocator, *key);
+            aws_byte_buf_init_copy_from_cursor(&cipher->cipher.key, secure_allocator, *key);
         } else {
-            aws_byte_buf_init(&cipher->cipher.key, cipher->cipher.allocator, AWS_AES_256_KEY_BYTE_LEN);
+            aws_byte_buf_init(&cipher->cipher.key, secure_allocator, AWS_AES_256_KEY_BYTE_LEN);
             aws_symmetric_cipher_generate_key(AWS_AES_256_KEY_BYTE_LEN, &cipher->cipher.key);
         }
     }
 
     if (!cipher->cipher.iv.len && iv_size) {
         if (iv) {
-            aws_byte_buf_init_copy_from_cursor(&cipher->cipher.iv, cipher->cipher.allocator, *iv);
+            aws_byte_buf_init_copy_from_cursor(&cipher->cipher.iv, secure_allocator, *iv);
         } else {
-            aws_byte_buf_init(&cipher->cipher.iv, cipher->cipher.allocator, iv_size);
+            aws_byte_buf_init(&cipher->cipher.iv, secure_allocator, iv_size);
             aws_symmetric_cipher_generate_initialization_vector(iv_size, is_ctr_mode, &cipher->cipher.iv);
         }
     }
@@ -207,7 +314,11 @@ static int s_initialize_cipher_materials(
         }
     }
 
-    cipher->key_handle = s_import_key_blob(cipher->alg_handle, cipher->cipher.allocator, &cipher->cipher.key);
+    if (cipher->prepared_key) {
+        cipher->key_handle = s_duplicate_prepared_key_handle(cipher->prepared_key, cipher->alg_handle);
+    } else {
+        cipher->key_handle = s_import_key_blob(cipher->alg_handle, cipher->cipher.allocator, &cipher->cipher.key);
+    }
 
     if (!cipher->key_handle) {
         cipher->cipher.good = false;
@@ -278,6 +389,8 @@ static void s_clear_reusable_components(struct aws_symmetric_cipher *cipher) {
 
     aws_byte_buf_secure_zero(&cipher_impl->overflow);
     aws_byte_buf_secure_zero(&cipher_impl->working_mac_buffer);
+    aws_secure_zero(cipher_impl->ctr_keystream, sizeof(cipher_impl->ctr_keystream));
+    cipher_impl->ctr_keystream_len = 0;
     /* windows handles this, just go ahead and tell the API it's got a length. */
     cipher_impl->working_mac_buffer.len = AWS_AES_256_CIPHER_BLOCK_SIZE;
 }
@@ -519,9 +632,10 @@ static struct aws_symmetric_cipher_vtable s_aes_cbc_vtable = {
     .reset = s_reset_cbc_cipher,
 };
 
-struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_cbc_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key,
     const struct aws_byte_cursor *iv) {
 
     aws_thread_call_once(&s_aes_thread_once, s_load_alg_handles, NULL);
@@ -533,6 +647,7 @@ struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
     cipher->cipher.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->alg_handle = s_aes_cbc_algorithm_handle;
     cipher->cipher.vtable = &s_aes_cbc_vtable;
+    s_use_prepared_key(cipher, prepared_key);
 
     if (s_initialize_cipher_materials(cipher, key, iv, NULL, NULL, AWS_AES_256_CIPHER_BLOCK_SIZE, false, false) !=
         AWS_OP_SUCCESS) {
@@ -549,106 +664,98 @@ struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
     return &cipher->cipher;
 
 error:
+    cipher->cipher.impl = cipher;
+    s_aes_default_destroy(&cipher->cipher);
     return NULL;
 }
 
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_cbc_256_new(allocator, key, NULL, iv);
+}
+
+struct aws_symmetric_cipher *aws_aes_cbc_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_cbc_256_new(allocator, NULL, prepared_key, iv);
+}
+
+typedef int(s_aes_bcrypt_op_fn)(
+    struct aws_symmetric_cipher *cipher,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *out);
+
 /* the buffer management for this mode is a good deal easier because we don't care about padding.
-   We do care about keeping the final buffer less than a block size til the finalize call so we can
-   turn the auth chaining flag off and compute the GMAC correctly. */
-static int s_aes_gcm_encrypt(
+   We do care about keeping the final (up to a block of) data til the finalize call so we can
+   turn the auth chaining flag off and compute the GMAC correctly. Chained calls have to be whole blocks, so
+   everything else is fed to CNG straight from the caller's cursor: at most one block is assembled from the
+   previous call's tail, and only the new sub-block tail is copied into the overflow. */
+static int s_aes_gcm_process(
     struct aws_symmetric_cipher *cipher,
-    struct aws_byte_cursor to_encrypt,
-    struct aws_byte_buf *out) {
+    struct aws_byte_cursor input,
+    struct aws_byte_buf *out,
+    s_aes_bcrypt_op_fn *op_fn) {
     struct aes_bcrypt_cipher *cipher_impl = cipher->impl;
 
-    if (to_encrypt.len == 0) {
+    if (input.len == 0) {
         return AWS_OP_SUCCESS;
     }
 
-    struct aws_byte_buf working_buffer;
-    AWS_ZERO_STRUCT(working_buffer);
-
-    /* If there's overflow, prepend it to the working buffer, then append the data to encrypt */
-    if (cipher_impl->overflow.len) {
-        struct aws_byte_cursor overflow_cur = aws_byte_cursor_from_buf(&cipher_impl->overflow);
+    size_t total_len = cipher_impl->overflow.len + input.len;
 
-        aws_byte_buf_init_copy_from_cursor(&working_buffer, cipher->allocator, overflow_cur);
-        aws_byte_buf_reset(&cipher_impl->overflow, true);
-        aws_byte_buf_append_dynamic(&working_buffer, &to_encrypt);
-    } else {
-        aws_byte_buf_init_copy_from_cursor(&working_buffer, cipher->allocator, to_encrypt);
+    if (total_len <= AWS_AES_256_CIPHER_BLOCK_SIZE) {
+        return aws_byte_buf_append_dynamic(&cipher_impl->overflow, &input);
     }
 
-    int ret_val = AWS_OP_ERR;
-
-    /* whatever is remaining in an incomplete block, copy it to the overflow. If we don't have a full block
-       wait til next time or for the finalize call. */
-    if (working_buffer.len > AWS_AES_256_CIPHER_BLOCK_SIZE) {
-        size_t offset = working_buffer.len % AWS_AES_256_CIPHER_BLOCK_SIZE;
-        size_t seek_to = working_buffer.len - (AWS_AES_256_CIPHER_BLOCK_SIZE + offset);
-        struct aws_byte_cursor working_buf_cur = aws_byte_cursor_from_buf(&working_buffer);
-        struct aws_byte_cursor working_slice = aws_byte_cursor_advance(&working_buf_cur, seek_to);
-        /* this is just here to make it obvious. The previous line advanced working_buf_cur to where the
-           new overfloew should be. */
-        struct aws_byte_cursor new_overflow_cur = working_buf_cur;
-        aws_byte_buf_append_dynamic(&cipher_impl->overflow, &new_overflow_cur);
-
-        ret_val = s_aes_default_encrypt(cipher, &working_slice, out);
-    } else {
-        struct aws_byte_cursor working_buffer_cur = aws_byte_cursor_from_buf(&working_buffer);
-        aws_byte_buf_append_dynamic(&cipher_impl->overflow, &working_buffer_cur);
-        ret_val = AWS_OP_SUCCESS;
+    /* hold back the tail, or a whole block if there is no tail, so finalize always has something to end the chain
+       with. */
+    size_t tail_len = total_len % AWS_AES_256_CIPHER_BLOCK_SIZE;
+    if (tail_len == 0) {
+        tail_len = AWS_AES_256_CIPHER_BLOCK_SIZE;
     }
-    aws_byte_buf_clean_up_secure(&working_buffer);
-    return ret_val;
-}
-
-static int s_aes_gcm_decrypt(
-    struct aws_symmetric_cipher *cipher,
-    struct aws_byte_cursor to_decrypt,
-    struct aws_byte_buf *out) {
-    struct aes_bcrypt_cipher *cipher_impl = cipher->impl;
 
-    if (to_decrypt.len == 0) {
-        return AWS_OP_SUCCESS;
+    /* check for all of it now, so a short buffer doesn't leave us with half of this call processed. */
+    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, total_len - tail_len)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
-    struct aws_byte_buf working_buffer;
-    AWS_ZERO_STRUCT(working_buffer);
-
-    /* If there's overflow, prepend it to the working buffer, then append the data to encrypt */
     if (cipher_impl->overflow.len) {
-        struct aws_byte_cursor overflow_cur = aws_byte_cursor_from_buf(&cipher_impl->overflow);
+        struct aws_byte_cursor fill =
+            aws_byte_cursor_advance(&input, AWS_AES_256_CIPHER_BLOCK_SIZE - cipher_impl->overflow.len);
+        aws_byte_buf_append_dynamic(&cipher_impl->overflow, &fill);
 
-        aws_byte_buf_init_copy_from_cursor(&working_buffer, cipher->allocator, overflow_cur);
-        aws_byte_buf_reset(&cipher_impl->overflow, true);
-        aws_byte_buf_append_dynamic(&working_buffer, &to_decrypt);
-    } else {
-        aws_byte_buf_init_copy_from_cursor(&working_buffer, cipher->allocator, to_decrypt);
-    }
+        struct aws_byte_cursor overflow_block = aws_byte_cursor_from_buf(&cipher_impl->overflow);
+        int ret_val = op_fn(cipher, &overflow_block, out);
+        aws_byte_buf_secure_zero(&cipher_impl->overflow);
 
-    int ret_val = AWS_OP_ERR;
+        if (ret_val != AWS_OP_SUCCESS) {
+            return ret_val;
+        }
+    }
 
-    /* whatever is remaining in an incomplete block, copy it to the overflow. If we don't have a full block
-       wait til next time or for the finalize call. */
-    if (working_buffer.len > AWS_AES_256_CIPHER_BLOCK_SIZE) {
-        size_t offset = working_buffer.len % AWS_AES_256_CIPHER_BLOCK_SIZE;
-        size_t seek_to = working_buffer.len - (AWS_AES_256_CIPHER_BLOCK_SIZE + offset);
-        struct aws_byte_cursor working_buf_cur = aws_byte_cursor_from_buf(&working_buffer);
-        struct aws_byte_cursor working_slice = aws_byte_cursor_advance(&working_buf_cur, seek_to);
-        /* this is just here to make it obvious. The previous line advanced working_buf_cur to where the
-           new overfloew should be. */
-        struct aws_byte_cursor new_overflow_cur = working_buf_cur;
-        aws_byte_buf_append_dynamic(&cipher_impl->overflow, &new_overflow_cur);
-
-        ret_val = s_default_aes_decrypt(cipher, &working_slice, out);
-    } else {
-        struct aws_byte_cursor working_buffer_cur = aws_byte_cursor_from_buf(&working_buffer);
-        aws_byte_buf_append_dynamic(&cipher_impl->overflow, &working_buffer_cur);
-        ret_val = AWS_OP_SUCCESS;
+    struct aws_byte_cursor blocks = aws_byte_cursor_advance(&input, input.len - tail_len);
+    if (op_fn(cipher, &blocks, out)) {
+        return AWS_OP_ERR;
     }
-    aws_byte_buf_clean_up_secure(&working_buffer);
-    return ret_val;
+
+    return aws_byte_buf_append_dynamic(&cipher_impl->overflow, &input);
+}
+
+static int s_aes_gcm_encrypt(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor to_encrypt,
+    struct aws_byte_buf *out) {
+    return s_aes_gcm_process(cipher, to_encrypt, out, s_aes_default_encrypt);
+}
+
+static int s_aes_gcm_decrypt(
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor to_decrypt,
+    struct aws_byte_buf *out) {
+    return s_aes_gcm_process(cipher, to_decrypt, out, s_default_aes_decrypt);
 }
 
 static int s_aes_gcm_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
@@ -685,9 +792,10 @@ static struct aws_symmetric_cipher_vtable s_aes_gcm_vtable = {
     .reset = s_reset_gcm_cipher,
 };
 
-struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_gcm_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key,
     const struct aws_byte_cursor *iv,
     const struct aws_byte_cursor *aad,
     const struct aws_byte_cursor *decryption_tag) {
@@ -700,6 +808,7 @@ struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
     cipher->cipher.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->alg_handle = s_aes_gcm_algorithm_handle;
     cipher->cipher.vtable = &s_aes_gcm_vtable;
+    s_use_prepared_key(cipher, prepared_key);
 
     /* GCM does the counting under the hood, so we let it handle the final 4 bytes of the IV. */
     if (s_initialize_cipher_materials(
@@ -718,40 +827,208 @@ struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
 
 error:
     if (cipher != NULL) {
+        cipher->cipher.impl = cipher;
         s_aes_default_destroy(&cipher->cipher);
     }
 
     return NULL;
 }
 
-/* Take a and b, XOR them and store it in dest. Notice the XOR is done up to the length of the smallest input.
-   If there's a bug in here, it's being hit inside the finalize call when there's an input stream that isn't an even
-   multiple of 16.
- */
-static int s_xor_cursors(const struct aws_byte_cursor *a, const struct aws_byte_cursor *b, struct aws_byte_buf *dest) {
-    size_t min_size = aws_min_size(b->len, a->len);
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    return s_aes_gcm_256_new(allocator, key, NULL, iv, aad, decryption_tag);
+}
 
-    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(dest, min_size)) {
-        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+struct aws_symmetric_cipher *aws_aes_gcm_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    return s_aes_gcm_256_new(allocator, NULL, prepared_key, iv, aad, decryption_tag);
+}
+
+/* Imports key into a key object on the stack, so the one-shot GCM paths don't need a cipher object. The blob is the
+   BCRYPT_KEY_DATA_BLOB_HEADER followed by the key bytes, same as s_import_key_blob(). */
+static int s_import_gcm_oneshot_key(
+    const struct aws_byte_cursor *key,
+    uint8_t *key_object,
+    ULONG key_object_len,
+    BCRYPT_KEY_HANDLE *key_handle) {
+
+    aws_thread_call_once(&s_aes_thread_once, s_load_alg_handles, NULL);
+
+    uint8_t key_blob[sizeof(BCRYPT_KEY_DATA_BLOB_HEADER) + AWS_AES_256_KEY_BYTE_LEN];
+    BCRYPT_KEY_DATA_BLOB_HEADER *key_data = (BCRYPT_KEY_DATA_BLOB_HEADER *)key_blob;
+    key_data->dwMagic = BCRYPT_KEY_DATA_BLOB_MAGIC;
+    key_data->dwVersion = BCRYPT_KEY_DATA_BLOB_VERSION1;
+    key_data->cbKeyData = (ULONG)key->len;
+    memcpy(key_blob + sizeof(BCRYPT_KEY_DATA_BLOB_HEADER), key->ptr, key->len);
+
+    NTSTATUS status = BCryptImportKey(
+        s_aes_gcm_algorithm_handle,
+        NULL,
+        BCRYPT_KEY_DATA_BLOB,
+        key_handle,
+        key_object,
+        key_object_len,
+        key_blob,
+        (ULONG)sizeof(key_blob),
+        0);
+
+    aws_secure_zero(key_blob, sizeof(key_blob));
+
+    if (!NT_SUCCESS(status)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
-    /* If the profiler is saying this is slow, SIMD the loop below. */
-    uint8_t *array_ref = dest->buffer + dest->len;
+    return AWS_OP_SUCCESS;
+}
+
+/* Big enough for the AES key object on every Windows version we support. If it ever isn't, BCryptImportKey fails
+   rather than overrunning it. */
+#define AWS_AES_GCM_ONESHOT_KEY_OBJECT_SIZE 1024
+
+int aws_aes_256_gcm_seal_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+    (void)allocator;
 
-    for (size_t i = 0; i < min_size; ++i) {
-        array_ref[i] = a->ptr[i] ^ b->ptr[i];
+    uint8_t key_object[AWS_AES_GCM_ONESHOT_KEY_OBJECT_SIZE];
+    BCRYPT_KEY_HANDLE key_handle = NULL;
+    if (s_import_gcm_oneshot_key(key, key_object, (ULONG)sizeof(key_object), &key_handle)) {
+        return AWS_OP_ERR;
     }
 
-    dest->len += min_size;
+    uint8_t *ciphertext = out->buffer + out->len;
+    uint8_t *tag = ciphertext + plaintext.len;
+
+    /* without the chaining flag, CNG takes the whole message and produces the tag in one call. */
+    BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO auth_info;
+    BCRYPT_INIT_AUTH_MODE_INFO(auth_info);
+    auth_info.pbNonce = (PUCHAR)nonce->ptr;
+    auth_info.cbNonce = (ULONG)nonce->len;
+    auth_info.pbTag = tag;
+    auth_info.cbTag = AWS_AES_256_GCM_TAG_LEN;
+    if (aad) {
+        auth_info.pbAuthData = (PUCHAR)aad->ptr;
+        auth_info.cbAuthData = (ULONG)aad->len;
+    }
 
+    ULONG length_written = 0;
+    NTSTATUS status = BCryptEncrypt(
+        key_handle,
+        (PUCHAR)plaintext.ptr,
+        (ULONG)plaintext.len,
+        &auth_info,
+        NULL,
+        0,
+        ciphertext,
+        (ULONG)plaintext.len,
+        &length_written,
+        0);
+
+    BCryptDestroyKey(key_handle);
+    aws_secure_zero(key_object, sizeof(key_object));
+
+    if (!NT_SUCCESS(status)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    out->len += length_written + AWS_AES_256_GCM_TAG_LEN;
     return AWS_OP_SUCCESS;
 }
 
-/* There is no CTR mode on windows. Instead, we use AES ECB to encrypt the IV a block at a time.
-   That value is then XOR'd with the to_encrypt cursor and appended to out. The counter then needs
-   to be incremented by 1 for the next call. This has to be done a block at a time, so we slice
-   to_encrypt into a cursor per block and do this process for each block. Also notice that CTR mode
-   is symmetric for encryption and decryption (encrypt and decrypt are the same thing). */
+int aws_aes_256_gcm_open_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor ciphertext,
+    struct aws_byte_cursor tag,
+    struct aws_byte_buf *out) {
+    (void)allocator;
+
+    uint8_t key_object[AWS_AES_GCM_ONESHOT_KEY_OBJECT_SIZE];
+    BCRYPT_KEY_HANDLE key_handle = NULL;
+    if (s_import_gcm_oneshot_key(key, key_object, (ULONG)sizeof(key_object), &key_handle)) {
+        return AWS_OP_ERR;
+    }
+
+    BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO auth_info;
+    BCRYPT_INIT_AUTH_MODE_INFO(auth_info);
+    auth_info.pbNonce = (PUCHAR)nonce->ptr;
+    auth_info.cbNonce = (ULONG)nonce->len;
+    auth_info.pbTag = (PUCHAR)tag.ptr;
+    auth_info.cbTag = (ULONG)tag.len;
+    if (aad) {
+        auth_info.pbAuthData = (PUCHAR)aad->ptr;
+        auth_info.cbAuthData = (ULONG)aad->len;
+    }
+
+    ULONG length_written = 0;
+    NTSTATUS status = BCryptDecrypt(
+        key_handle,
+        (PUCHAR)ciphertext.ptr,
+        (ULONG)ciphertext.len,
+        &auth_info,
+        NULL,
+        0,
+        out->buffer + out->len,
+        (ULONG)ciphertext.len,
+        &length_written,
+        0);
+
+    BCryptDestroyKey(key_handle);
+    aws_secure_zero(key_object, sizeof(key_object));
+
+    if (status == STATUS_AUTH_TAG_MISMATCH) {
+        return aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    }
+
+    if (!NT_SUCCESS(status)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    out->len += length_written;
+    return AWS_OP_SUCCESS;
+}
+
+/* XORs len bytes of input with keystream into dest. dest may be input itself, each byte is read before the same
+   byte is written. Done a word at a time so the compiler can widen it further. */
+static void s_xor_keystream(uint8_t *dest, const uint8_t *input, const uint8_t *keystream, size_t len) {
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t data_word = 0;
+        uint64_t keystream_word = 0;
+        memcpy(&data_word, input + i, sizeof(data_word));
+        memcpy(&keystream_word, keystream + i, sizeof(keystream_word));
+        data_word ^= keystream_word;
+        memcpy(dest + i, &data_word, sizeof(data_word));
+    }
+
+    for (; i < len; ++i) {
+        dest[i] = input[i] ^ keystream[i];
+    }
+}
+
+/* how many counter blocks are turned into keystream per BCryptEncrypt call. */
+#define AWS_AES_CTR_KEYSTREAM_BATCH_BLOCKS 64
+
+/* There is no CTR mode on windows. Instead, we lay out a batch of consecutive counter blocks, encrypt the whole
+   batch with a single AES ECB call to get the keystream, and XOR that with the input. When the input stops part way
+   through a block, the unused tail of that keystream block is kept so the next call picks up where this one stopped,
+   which means every call writes exactly as many bytes as it is given. Also notice that CTR mode is symmetric for
+   encryption and decryption (encrypt and decrypt are the same thing). */
 static int s_aes_ctr_encrypt(
     struct aws_symmetric_cipher *cipher,
     struct aws_byte_cursor to_encrypt,
@@ -762,126 +1039,124 @@ static int s_aes_ctr_encrypt(
         return AWS_OP_SUCCESS;
     }
 
-    struct aws_byte_buf working_buffer;
-    AWS_ZERO_STRUCT(working_buffer);
+    if (aws_symmetric_cipher_try_ensure_sufficient_buffer_space(out, to_encrypt.len)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
 
-    /* prepend overflow to the working buffer and then append to_encrypt to it. */
-    if (cipher_impl->overflow.len && to_encrypt.ptr != cipher_impl->overflow.buffer) {
-        struct aws_byte_cursor overflow_cur = aws_byte_cursor_from_buf(&cipher_impl->overflow);
-        aws_byte_buf_init_copy_from_cursor(&working_buffer, cipher->allocator, overflow_cur);
-        aws_byte_buf_reset(&cipher_impl->overflow, true);
-        aws_byte_buf_append_dynamic(&working_buffer, &to_encrypt);
-    } else {
-        aws_byte_buf_init_copy_from_cursor(&working_buffer, cipher->allocator, to_encrypt);
+    const uint8_t *input = to_encrypt.ptr;
+    uint8_t *dest = out->buffer + out->len;
+    size_t remaining = to_encrypt.len;
+
+    /* finish off the keystream block the previous call started. */
+    size_t from_previous = aws_min_size(remaining, cipher_impl->ctr_keystream_len);
+    s_xor_keystream(
+        dest,
+        input,
+        cipher_impl->ctr_keystream + AWS_AES_256_CIPHER_BLOCK_SIZE - cipher_impl->ctr_keystream_len,
+        from_previous);
+    cipher_impl->ctr_keystream_len -= from_previous;
+    input += from_previous;
+    dest += from_previous;
+    remaining -= from_previous;
+
+    size_t blocks_needed = (remaining + AWS_AES_256_CIPHER_BLOCK_SIZE - 1) / AWS_AES_256_CIPHER_BLOCK_SIZE;
+    if (blocks_needed == 0) {
+        out->len += to_encrypt.len;
+        return AWS_OP_SUCCESS;
     }
 
-    /* slice working_buffer into a slice per block. */
-    struct aws_array_list sliced_buffers;
-    aws_array_list_init_dynamic(
-        &sliced_buffers,
-        cipher->allocator,
-        (to_encrypt.len / AWS_AES_256_CIPHER_BLOCK_SIZE) + 1,
-        sizeof(struct aws_byte_cursor));
+    /* the whole IV is the counter, carried across all 128 bits the way libcrypto and CommonCrypto do it. */
+    uint8_t *counter = cipher_impl->working_iv.buffer;
+    uint8_t counter_blocks[AWS_AES_CTR_KEYSTREAM_BATCH_BLOCKS * AWS_AES_256_CIPHER_BLOCK_SIZE];
+    uint8_t keystream[AWS_AES_CTR_KEYSTREAM_BATCH_BLOCKS * AWS_AES_256_CIPHER_BLOCK_SIZE];
+    int ret_val = AWS_OP_SUCCESS;
 
-    struct aws_byte_cursor working_buf_cur = aws_byte_cursor_from_buf(&working_buffer);
-    while (working_buf_cur.len) {
-        struct aws_byte_cursor slice = working_buf_cur;
+    while (blocks_needed) {
+        size_t batch_blocks = aws_min_size(blocks_needed, AWS_AES_CTR_KEYSTREAM_BATCH_BLOCKS);
+        size_t batch_len = batch_blocks * AWS_AES_256_CIPHER_BLOCK_SIZE;
 
-        if (working_buf_cur.len >= AWS_AES_256_CIPHER_BLOCK_SIZE) {
-            slice = aws_byte_cursor_advance(&working_buf_cur, AWS_AES_256_CIPHER_BLOCK_SIZE);
-        } else {
-            aws_byte_cursor_advance(&working_buf_cur, slice.len);
+        for (size_t i = 0; i < batch_blocks; ++i) {
+            memcpy(counter_blocks + i * AWS_AES_256_CIPHER_BLOCK_SIZE, counter, AWS_AES_256_CIPHER_BLOCK_SIZE);
+            aws_aes_ctr_counter_block_add(counter, 1);
         }
 
-        aws_array_list_push_back(&sliced_buffers, &slice);
-    }
-
-    int ret_val = AWS_OP_ERR;
-
-    size_t sliced_buffers_cnt = aws_array_list_length(&sliced_buffers);
-
-    /* for each slice, if it's a full block, do ECB on the IV, xor it to the slice, and then increment the counter. */
-    for (size_t i = 0; i < sliced_buffers_cnt; ++i) {
-        struct aws_byte_cursor buffer_cur;
-        AWS_ZERO_STRUCT(buffer_cur);
-
-        aws_array_list_get_at(&sliced_buffers, &buffer_cur, i);
-        if (buffer_cur.len == AWS_AES_256_CIPHER_BLOCK_SIZE ||
-            /* this part of the branch is for handling the finalize call, which does not have to be on an even
-               block boundary. */
-            (cipher_impl->overflow.len > 0 && sliced_buffers_cnt) == 1) {
-
-            ULONG lengthWritten = (ULONG)AWS_AES_256_CIPHER_BLOCK_SIZE;
-            uint8_t temp_buffer[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
-            struct aws_byte_cursor temp_cur = aws_byte_cursor_from_array(temp_buffer, sizeof(temp_buffer));
-
-            NTSTATUS status = BCryptEncrypt(
-                cipher_impl->key_handle,
-                cipher_impl->working_iv.buffer,
-                (ULONG)cipher_impl->working_iv.len,
-                NULL,
-                NULL,
-                0,
-                temp_cur.ptr,
-                (ULONG)temp_cur.len,
-                &lengthWritten,
-                cipher_impl->cipher_flags);
-
-            if (!NT_SUCCESS(status)) {
-                cipher->good = false;
-                ret_val = aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-                goto clean_up;
-            }
-
-            /* this does the XOR, after this call the final encrypted output is added to out. */
-            if (s_xor_cursors(&buffer_cur, &temp_cur, out)) {
-                ret_val = AWS_OP_ERR;
-                goto clean_up;
-            }
+        ULONG length_written = 0;
+        NTSTATUS status = BCryptEncrypt(
+            cipher_impl->key_handle,
+            counter_blocks,
+            (ULONG)batch_len,
+            NULL,
+            NULL,
+            0,
+            keystream,
+            (ULONG)sizeof(keystream),
+            &length_written,
+            cipher_impl->cipher_flags);
 
-            /* increment the counter. Get the buffers aligned for it first though. */
-            size_t counter_offset = AWS_AES_256_CIPHER_BLOCK_SIZE - sizeof(uint32_t);
-            struct aws_byte_buf counter_buf = cipher_impl->working_iv;
-            /* roll it back 4 so the write works. */
-            counter_buf.len = counter_offset;
-            struct aws_byte_cursor counter_cur = aws_byte_cursor_from_buf(&cipher_impl->working_iv);
-            aws_byte_cursor_advance(&counter_cur, counter_offset);
-
-            /* read current counter value as a Big-endian 32-bit integer*/
-            uint32_t counter = 0;
-            aws_byte_cursor_read_be32(&counter_cur, &counter);
-
-            /* check for overflow here. */
-            if (aws_add_u32_checked(counter, 1, &counter) != AWS_OP_SUCCESS) {
-                cipher->good = false;
-                ret_val = AWS_OP_ERR;
-                goto clean_up;
-            }
-            /* put the incremented counter back. */
-            aws_byte_buf_write_be32(&counter_buf, counter);
-        } else {
-            /* otherwise dump it into the overflow and wait til the next call */
-            aws_byte_buf_append_dynamic(&cipher_impl->overflow, &buffer_cur);
+        if (!NT_SUCCESS(status) || length_written != batch_len) {
+            cipher->good = false;
+            ret_val = aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            goto clean_up;
         }
 
-        ret_val = AWS_OP_SUCCESS;
+        size_t to_xor = aws_min_size(remaining, batch_len);
+        s_xor_keystream(dest, input, keystream, to_xor);
+        input += to_xor;
+        dest += to_xor;
+        remaining -= to_xor;
+        blocks_needed -= batch_blocks;
+
+        /* the last block was only partially used, keep the rest of it for the next call. */
+        if (to_xor < batch_len) {
+            cipher_impl->ctr_keystream_len = batch_len - to_xor;
+            memcpy(
+                cipher_impl->ctr_keystream + AWS_AES_256_CIPHER_BLOCK_SIZE - cipher_impl->ctr_keystream_len,
+                keystream + to_xor,
+                cipher_impl->ctr_keystream_len);
+        }
     }
 
+    out->len += to_encrypt.len;
+
 clean_up:
-    aws_array_list_clean_up_secure(&sliced_buffers);
-    aws_byte_buf_clean_up_secure(&working_buffer);
+    aws_secure_zero(keystream, sizeof(keystream));
+    aws_secure_zero(counter_blocks, sizeof(counter_blocks));
 
     return ret_val;
 }
 
 static int s_aes_ctr_finalize_encryption(struct aws_symmetric_cipher *cipher, struct aws_byte_buf *out) {
     struct aes_bcrypt_cipher *cipher_impl = cipher->impl;
+    (void)out;
 
-    struct aws_byte_cursor remaining_cur = aws_byte_cursor_from_buf(&cipher_impl->overflow);
-    /* take the final overflow, and do the final encrypt call for it. */
-    int ret_val = s_aes_ctr_encrypt(cipher, remaining_cur, out);
-    aws_byte_buf_secure_zero(&cipher_impl->overflow);
+    /* every byte was already written by the encrypt calls, there's only the leftover keystream to get rid of. */
+    aws_secure_zero(cipher_impl->ctr_keystream, sizeof(cipher_impl->ctr_keystream));
+    cipher_impl->ctr_keystream_len = 0;
     aws_byte_buf_secure_zero(&cipher_impl->working_iv);
+    return AWS_OP_SUCCESS;
+}
+
+/* Since we maintain the counter ourselves, seeking is just a reset with working_iv moved to counter_block. Running
+   zeros through for the skipped bytes leaves the rest of that block's keystream in ctr_keystream. */
+static int s_aes_ctr_seek(struct aws_symmetric_cipher *cipher, const uint8_t *counter_block, size_t skip) {
+    struct aes_bcrypt_cipher *cipher_impl = cipher->impl;
+
+    if (s_reset_ctr_cipher(cipher)) {
+        return AWS_OP_ERR;
+    }
+
+    memcpy(cipher_impl->working_iv.buffer, counter_block, AWS_AES_256_CIPHER_BLOCK_SIZE);
+
+    if (skip == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    uint8_t zeros[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    uint8_t discard[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    struct aws_byte_buf discard_buf = aws_byte_buf_from_empty_array(discard, sizeof(discard));
+    int ret_val = s_aes_ctr_encrypt(cipher, aws_byte_cursor_from_array(zeros, skip), &discard_buf);
+    aws_secure_zero(discard, sizeof(discard));
+
     return ret_val;
 }
 
@@ -894,11 +1169,13 @@ static struct aws_symmetric_cipher_vtable s_aes_ctr_vtable = {
     .finalize_decryption = s_aes_ctr_finalize_encryption,
     .destroy = s_aes_default_destroy,
     .reset = s_reset_ctr_cipher,
+    .seek = s_aes_ctr_seek,
 };
 
-struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_ctr_256_new(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key,
     const struct aws_byte_cursor *iv) {
 
     aws_thread_call_once(&s_aes_thread_once, s_load_alg_handles, NULL);
@@ -909,13 +1186,13 @@ struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
     cipher->cipher.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->alg_handle = s_aes_ctr_algorithm_handle;
     cipher->cipher.vtable = &s_aes_ctr_vtable;
+    s_use_prepared_key(cipher, prepared_key);
 
     if (s_initialize_cipher_materials(cipher, key, iv, NULL, NULL, AWS_AES_256_CIPHER_BLOCK_SIZE, true, false) !=
         AWS_OP_SUCCESS) {
         goto error;
     }
 
-    aws_byte_buf_init(&cipher->overflow, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE * 2);
     aws_byte_buf_init_copy(&cipher->working_iv, allocator, &cipher->cipher.iv);
 
     cipher->cipher.impl = cipher;
@@ -925,12 +1202,27 @@ struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
 
 error:
     if (cipher != NULL) {
+        cipher->cipher.impl = cipher;
         s_aes_default_destroy(&cipher->cipher);
     }
 
     return NULL;
 }
 
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_ctr_256_new(allocator, key, NULL, iv);
+}
+
+struct aws_symmetric_cipher *aws_aes_ctr_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *iv) {
+    return s_aes_ctr_256_new(allocator, NULL, prepared_key, iv);
+}
+
 /* This is just an encrypted key. Append them to a buffer and on finalize export/import the key using AES keywrap. */
 static int s_key_wrap_encrypt_decrypt(
     struct aws_symmetric_cipher *cipher,
@@ -1088,9 +1380,10 @@ static struct aws_symmetric_cipher_vtable s_aes_keywrap_vtable = {
     .reset = s_reset_keywrap_cipher,
 };
 
-struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
+static struct aws_symmetric_cipher *s_aes_keywrap_256_new(
     struct aws_allocator *allocator,
-    const struct aws_byte_cursor *key) {
+    const struct aws_byte_cursor *key,
+    struct aws_aes_256_prepared_key *prepared_key) {
 
     aws_thread_call_once(&s_aes_thread_once, s_load_alg_handles, NULL);
     struct aes_bcrypt_cipher *cipher = aws_mem_calloc(allocator, 1, sizeof(struct aes_bcrypt_cipher));
@@ -1100,6 +1393,7 @@ struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
     cipher->cipher.key_length_bits = AWS_AES_256_KEY_BIT_LEN;
     cipher->alg_handle = s_aes_keywrap_algorithm_handle;
     cipher->cipher.vtable = &s_aes_keywrap_vtable;
+    s_use_prepared_key(cipher, prepared_key);
 
     if (s_initialize_cipher_materials(cipher, key, NULL, NULL, NULL, 0, false, false) != AWS_OP_SUCCESS) {
         goto error;
@@ -1114,8 +1408,75 @@ struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
 
 error:
     if (cipher != NULL) {
+        cipher->cipher.impl = cipher;
         s_aes_default_destroy(&cipher->cipher);
     }
 
     return NULL;
 }
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key) {
+    return s_aes_keywrap_256_new(allocator, key, NULL);
+}
+
+struct aws_symmetric_cipher *aws_aes_keywrap_256_new_from_prepared_key_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key) {
+    return s_aes_keywrap_256_new(allocator, NULL, prepared_key);
+}
+
+/* No batch primitive here, one keywrap cipher made from the prepared key is reset between keys instead. */
+int aws_aes_256_keywrap_batch_impl(
+    struct aws_allocator *allocator,
+    struct aws_aes_256_prepared_key *prepared_key,
+    const struct aws_byte_cursor *inputs,
+    struct aws_byte_buf *outputs,
+    size_t count,
+    bool wrap) {
+    return aws_aes_256_keywrap_batch_with_cipher(allocator, prepared_key, inputs, outputs, count, wrap);
+}
+
+/* XTS, GCM-SIV and ChaCha20-Poly1305 aren't available here, aws_set_aes_xts_256_new_fn(),
+ * aws_set_aes_gcm_siv_256_new_fn() and aws_set_chacha20_poly1305_new_fn() can plug in an implementation. */
+struct aws_symmetric_cipher *aws_aes_xts_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *tweak) {
+    (void)allocator;
+    (void)key;
+    (void)tweak;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct aws_symmetric_cipher *aws_aes_gcm_siv_256_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
+
+struct aws_symmetric_cipher *aws_chacha20_poly1305_new_impl(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *iv,
+    const struct aws_byte_cursor *aad,
+    const struct aws_byte_cursor *decryption_tag) {
+    (void)allocator;
+    (void)key;
+    (void)iv;
+    (void)aad;
+    (void)decryption_tag;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
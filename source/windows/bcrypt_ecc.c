@@ -15,12 +15,38 @@
 
 #include <winerror.h>
 
+/* see bcrypt_25519.c */
+extern struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_private_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *priv_key);
+extern struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_from_public_key_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name,
+    const struct aws_byte_cursor *public_key);
+extern struct aws_ecc_key_pair *aws_ecc_key_pair_new_25519_generate_random_impl(
+    struct aws_allocator *allocator,
+    enum aws_ecc_curve_name curve_name);
+
+static bool s_is_25519_curve(enum aws_ecc_curve_name curve_name) {
+    return curve_name == AWS_CAL_ED25519 || curve_name == AWS_CAL_X25519;
+}
+
 static BCRYPT_ALG_HANDLE s_ecdsa_p256_alg = NULL;
 static BCRYPT_ALG_HANDLE s_ecdsa_p384_alg = NULL;
+static BCRYPT_ALG_HANDLE s_ecdh_p256_alg = NULL;
+static BCRYPT_ALG_HANDLE s_ecdh_p384_alg = NULL;
+
+/* older SDKs don't name the Windows 8.1+ raw secret KDF */
+#ifndef BCRYPT_KDF_RAW_SECRET
+#    define BCRYPT_KDF_RAW_SECRET L"TRUNCATE"
+#endif
 
 /* size of the P384 curve's signatures. This is the largest we support at the moment.
    Since msvc doesn't support variable length arrays, we need to handle this with a macro. */
 #define MAX_SIGNATURE_LENGTH (48 * 2)
+/* an ECCPRIVATE blob for P384: the header, x, y and d */
+#define MAX_KEY_BLOB_LENGTH (sizeof(BCRYPT_ECCKEY_BLOB) + 48 * 3)
 
 static aws_thread_once s_ecdsa_thread_once = AWS_THREAD_ONCE_STATIC_INIT;
 
@@ -34,6 +60,12 @@ static void s_load_alg_handle(void *user_data) {
     status = BCryptOpenAlgorithmProvider(&s_ecdsa_p384_alg, BCRYPT_ECDSA_P384_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0);
     AWS_ASSERT(s_ecdsa_p384_alg && "BCryptOpenAlgorithmProvider() failed");
 
+    status = BCryptOpenAlgorithmProvider(&s_ecdh_p256_alg, BCRYPT_ECDH_P256_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0);
+    AWS_ASSERT(s_ecdh_p256_alg && "BCryptOpenAlgorithmProvider() failed");
+
+    status = BCryptOpenAlgorithmProvider(&s_ecdh_p384_alg, BCRYPT_ECDH_P384_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0);
+    AWS_ASSERT(s_ecdh_p384_alg && "BCryptOpenAlgorithmProvider() failed");
+
     (void)status;
 }
 
@@ -86,62 +118,87 @@ static bool s_trim_zeros_predicate(uint8_t value) {
     return value == 0;
 }
 
-static int s_sign_message(
+/* BCrypt signatures are already the fixed length r || s format, no conversion needed. */
+static int s_sign_message_raw(
     const struct aws_ecc_key_pair *key_pair,
     const struct aws_byte_cursor *message,
     struct aws_byte_buf *signature_output) {
     struct bcrypt_ecc_key_pair *key_impl = key_pair->impl;
 
-    size_t output_buf_space = signature_output->capacity - signature_output->len;
+    ULONG signature_length = 0;
+    NTSTATUS status = BCryptSignHash(
+        key_impl->key_handle,
+        NULL,
+        message->ptr,
+        (ULONG)message->len,
+        signature_output->buffer + signature_output->len,
+        (ULONG)(signature_output->capacity - signature_output->len),
+        &signature_length,
+        0);
 
-    if (output_buf_space < s_signature_length(key_pair)) {
-        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    if (status != 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
-    uint8_t temp_signature[MAX_SIGNATURE_LENGTH] = {0};
-    struct aws_byte_buf temp_signature_buf = aws_byte_buf_from_empty_array(temp_signature, sizeof(temp_signature));
-    size_t signature_length = temp_signature_buf.capacity;
+    signature_output->len += signature_length;
+    return AWS_OP_SUCCESS;
+}
 
-    NTSTATUS status = BCryptSignHash(
+static int s_verify_signature_raw(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    const struct aws_byte_cursor *signature) {
+    struct bcrypt_ecc_key_pair *key_impl = key_pair->impl;
+
+    NTSTATUS status = BCryptVerifySignature(
         key_impl->key_handle,
         NULL,
         message->ptr,
         (ULONG)message->len,
-        temp_signature_buf.buffer,
-        (ULONG)signature_length,
-        (ULONG *)&signature_length,
+        signature->ptr,
+        (ULONG)signature->len,
         0);
 
-    if (status != 0) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    return status == 0 ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+}
+
+static int s_sign_message(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_byte_cursor *message,
+    struct aws_byte_buf *signature_output) {
+
+    size_t output_buf_space = signature_output->capacity - signature_output->len;
+
+    if (output_buf_space < s_signature_length(key_pair)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
-    temp_signature_buf.len += signature_length;
-    size_t coordinate_len = temp_signature_buf.len / 2;
+    uint8_t temp_signature[MAX_SIGNATURE_LENGTH] = {0};
+    struct aws_byte_buf temp_signature_buf = aws_byte_buf_from_empty_array(temp_signature, sizeof(temp_signature));
 
-    /* okay. Windows doesn't DER encode this to ASN.1, so we need to do it manually. */
-    struct aws_der_encoder *encoder =
-        aws_der_encoder_new(key_pair->allocator, signature_output->capacity - signature_output->len);
-    if (!encoder) {
+    if (s_sign_message_raw(key_pair, message, &temp_signature_buf)) {
         return AWS_OP_ERR;
     }
 
-    aws_der_encoder_begin_sequence(encoder);
-    struct aws_byte_cursor integer_cur = aws_byte_cursor_from_array(temp_signature_buf.buffer, coordinate_len);
-    /* trim off the leading zero padding for DER encoding */
-    integer_cur = aws_byte_cursor_left_trim_pred(&integer_cur, s_trim_zeros_predicate);
-    aws_der_encoder_write_integer(encoder, integer_cur);
-    integer_cur = aws_byte_cursor_from_array(temp_signature_buf.buffer + coordinate_len, coordinate_len);
+    size_t coordinate_len = temp_signature_buf.len / 2;
+
+    /* okay. Windows doesn't DER encode this to ASN.1, so we need to do it manually, straight into the output. */
+    struct aws_der_inplace_encoder encoder;
+    aws_der_inplace_encoder_init(&encoder, signature_output);
+    size_t starting_len = signature_output->len;
+
+    struct aws_byte_cursor r = aws_byte_cursor_from_array(temp_signature_buf.buffer, coordinate_len);
+    struct aws_byte_cursor s = aws_byte_cursor_from_array(temp_signature_buf.buffer + coordinate_len, coordinate_len);
     /* trim off the leading zero padding for DER encoding */
-    integer_cur = aws_byte_cursor_left_trim_pred(&integer_cur, s_trim_zeros_predicate);
-    aws_der_encoder_write_integer(encoder, integer_cur);
-    aws_der_encoder_end_sequence(encoder);
+    r = aws_byte_cursor_left_trim_pred(&r, s_trim_zeros_predicate);
+    s = aws_byte_cursor_left_trim_pred(&s, s_trim_zeros_predicate);
 
-    struct aws_byte_cursor signature_out_cur;
-    AWS_ZERO_STRUCT(signature_out_cur);
-    aws_der_encoder_get_contents(encoder, &signature_out_cur);
-    aws_byte_buf_append(signature_output, &signature_out_cur);
-    aws_der_encoder_destroy(encoder);
+    if (aws_der_inplace_encoder_begin_sequence(&encoder) || aws_der_inplace_encoder_write_integer(&encoder, r) ||
+        aws_der_inplace_encoder_write_integer(&encoder, s) || aws_der_inplace_encoder_end_sequence(&encoder) ||
+        aws_der_inplace_encoder_finish(&encoder)) {
+        signature_output->len = starting_len;
+        return AWS_OP_ERR;
+    }
 
     return AWS_OP_SUCCESS;
 }
@@ -188,7 +245,6 @@ static int s_verify_signature(
     const struct aws_ecc_key_pair *key_pair,
     const struct aws_byte_cursor *message,
     const struct aws_byte_cursor *signature) {
-    struct bcrypt_ecc_key_pair *key_impl = key_pair->impl;
 
     /* OKAY Windows doesn't do the whole standard internet formats thing. So we need to manually decode
        the DER encoded ASN.1 format first.*/
@@ -197,66 +253,142 @@ static int s_verify_signature(
 
     struct aws_byte_cursor der_encoded_signature = aws_byte_cursor_from_array(signature->ptr, signature->len);
 
-    struct aws_der_decoder *decoder = aws_der_decoder_new(key_pair->allocator, der_encoded_signature);
-    if (!decoder) {
-        return AWS_OP_ERR;
+    struct aws_der_pull_decoder decoder;
+    aws_der_pull_decoder_init(&decoder, der_encoded_signature);
+
+    if (!aws_der_pull_decoder_next(&decoder) || aws_der_pull_decoder_tlv_type(&decoder) != AWS_DER_SEQUENCE ||
+        aws_der_pull_decoder_enter(&decoder)) {
+        return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
     }
 
-    if (!aws_der_decoder_next(decoder) || aws_der_decoder_tlv_type(decoder) != AWS_DER_SEQUENCE) {
-        aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
-        goto error;
+    /* there will be two coordinates. They need to be concatenated together. */
+    for (size_t i = 0; i < 2; ++i) {
+        struct aws_byte_cursor coordinate;
+        AWS_ZERO_STRUCT(coordinate);
+        if (!aws_der_pull_decoder_next(&decoder) || aws_der_pull_decoder_tlv_integer(&decoder, &coordinate)) {
+            return aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
+        }
+
+        if (s_append_coordinate(&temp_signature_buf, &coordinate, key_pair->curve_name)) {
+            return AWS_OP_ERR;
+        }
     }
 
-    if (!aws_der_decoder_next(decoder) || aws_der_decoder_tlv_type(decoder) != AWS_DER_INTEGER) {
-        aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
-        goto error;
+    /* okay, now we've got a windows compatible signature, let's verify it. */
+    struct aws_byte_cursor raw_signature = aws_byte_cursor_from_buf(&temp_signature_buf);
+    return s_verify_signature_raw(key_pair, message, &raw_signature);
+}
+
+static BCRYPT_ALG_HANDLE s_ecdh_alg_handle_from_curve_name(enum aws_ecc_curve_name curve_name) {
+    switch (curve_name) {
+        case AWS_CAL_ECDSA_P256:
+            return s_ecdh_p256_alg;
+        case AWS_CAL_ECDSA_P384:
+            return s_ecdh_p384_alg;
+        default:
+            return 0;
     }
+}
 
-    /* there will be two coordinates. They need to be concatenated together. */
-    struct aws_byte_cursor coordinate;
-    AWS_ZERO_STRUCT(coordinate);
-    if (aws_der_decoder_tlv_integer(decoder, &coordinate)) {
-        aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
-        goto error;
+static ULONG s_get_ecdh_magic_from_curve_name(enum aws_ecc_curve_name curve_name, bool private_key) {
+    switch (curve_name) {
+        case AWS_CAL_ECDSA_P256:
+            return private_key ? BCRYPT_ECDH_PRIVATE_P256_MAGIC : BCRYPT_ECDH_PUBLIC_P256_MAGIC;
+        case AWS_CAL_ECDSA_P384:
+            return private_key ? BCRYPT_ECDH_PRIVATE_P384_MAGIC : BCRYPT_ECDH_PUBLIC_P384_MAGIC;
+        default:
+            return 0;
     }
+}
 
-    if (s_append_coordinate(&temp_signature_buf, &coordinate, key_pair->curve_name)) {
-        goto error;
+/*
+ * CNG won't run ECDH with a key imported for ECDSA, so the key blob is imported a second time under the ECDH
+ * algorithm. The copy lives on the stack and is wiped before returning.
+ */
+static int s_import_ecdh_key(const struct aws_ecc_key_pair *key_pair, bool private_key, BCRYPT_KEY_HANDLE *key_handle) {
+    size_t coordinate_size = aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name);
+    size_t blob_len = sizeof(BCRYPT_ECCKEY_BLOB) + coordinate_size * (private_key ? 3 : 2);
+
+    uint8_t blob[MAX_KEY_BLOB_LENGTH];
+    if (key_pair->key_buf.len < blob_len || blob_len > sizeof(blob)) {
+        return aws_raise_error(AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT);
     }
 
-    if (!aws_der_decoder_next(decoder) || aws_der_decoder_tlv_type(decoder) != AWS_DER_INTEGER) {
-        aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
-        goto error;
+    memcpy(blob, key_pair->key_buf.buffer, blob_len);
+    BCRYPT_ECCKEY_BLOB *header = (BCRYPT_ECCKEY_BLOB *)blob;
+    header->dwMagic = s_get_ecdh_magic_from_curve_name(key_pair->curve_name, private_key);
+
+    /* our own key was validated on its first import, the peer's point has to be checked now */
+    NTSTATUS status = BCryptImportKeyPair(
+        s_ecdh_alg_handle_from_curve_name(key_pair->curve_name),
+        NULL,
+        private_key ? BCRYPT_ECCPRIVATE_BLOB : BCRYPT_ECCPUBLIC_BLOB,
+        key_handle,
+        blob,
+        (ULONG)blob_len,
+        private_key ? BCRYPT_NO_KEY_VALIDATION : 0);
+    aws_secure_zero(blob, sizeof(blob));
+
+    if (status) {
+        return aws_raise_error(private_key ? AWS_ERROR_CAL_MISSING_REQUIRED_KEY_COMPONENT : AWS_ERROR_INVALID_ARGUMENT);
     }
-    AWS_ZERO_STRUCT(coordinate);
-    if (aws_der_decoder_tlv_integer(decoder, &coordinate)) {
-        aws_raise_error(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED);
-        goto error;
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_derive_shared_secret(
+    const struct aws_ecc_key_pair *key_pair,
+    const struct aws_ecc_key_pair *peer_key,
+    struct aws_byte_buf *shared_secret_output) {
+    size_t secret_len = aws_ecc_key_coordinate_byte_size_from_curve_name(key_pair->curve_name);
+
+    BCRYPT_KEY_HANDLE private_handle = NULL;
+    BCRYPT_KEY_HANDLE peer_handle = NULL;
+    BCRYPT_SECRET_HANDLE secret_handle = NULL;
+    int result = AWS_OP_ERR;
+
+    if (s_import_ecdh_key(key_pair, true, &private_handle) || s_import_ecdh_key(peer_key, false, &peer_handle)) {
+        goto clean_up;
     }
 
-    if (s_append_coordinate(&temp_signature_buf, &coordinate, key_pair->curve_name)) {
-        goto error;
+    if (BCryptSecretAgreement(private_handle, peer_handle, &secret_handle, 0)) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        goto clean_up;
     }
 
-    aws_der_decoder_destroy(decoder);
+    uint8_t *secret = shared_secret_output->buffer + shared_secret_output->len;
+    ULONG written = 0;
+    NTSTATUS status =
+        BCryptDeriveKey(secret_handle, BCRYPT_KDF_RAW_SECRET, NULL, secret, (ULONG)secret_len, &written, 0);
 
-    /* okay, now we've got a windows compatible signature, let's verify it. */
-    NTSTATUS status = BCryptVerifySignature(
-        key_impl->key_handle,
-        NULL,
-        message->ptr,
-        (ULONG)message->len,
-        temp_signature_buf.buffer,
-        (ULONG)temp_signature_buf.len,
-        0);
+    if (status || written != secret_len) {
+        aws_secure_zero(secret, secret_len);
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        goto clean_up;
+    }
 
-    return status == 0 ? AWS_OP_SUCCESS : aws_raise_error(AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED);
+    /* the raw secret comes back little endian, everyone else uses the big endian x coordinate */
+    for (size_t i = 0; i < secret_len / 2; ++i) {
+        uint8_t tmp = secret[i];
+        secret[i] = secret[secret_len - 1 - i];
+        secret[secret_len - 1 - i] = tmp;
+    }
 
-error:
-    if (decoder) {
-        aws_der_decoder_destroy(decoder);
+    shared_secret_output->len += secret_len;
+    result = AWS_OP_SUCCESS;
+
+clean_up:
+    if (secret_handle) {
+        BCryptDestroySecret(secret_handle);
     }
-    return AWS_OP_ERR;
+    if (peer_handle) {
+        BCryptDestroyKey(peer_handle);
+    }
+    if (private_handle) {
+        BCryptDestroyKey(private_handle);
+    }
+
+    return result;
 }
 
 static struct aws_ecc_key_pair_vtable s_vtable = {
@@ -265,8 +397,21 @@ static struct aws_ecc_key_pair_vtable s_vtable = {
     .sign_message = s_sign_message,
     .verify_signature = s_verify_signature,
     .signature_length = s_signature_length,
+    .sign_message_raw = s_sign_message_raw,
+    .verify_signature_raw = s_verify_signature_raw,
+    .derive_shared_secret = s_derive_shared_secret,
 };
 
+/* NIST curves only, 25519 keys are created in bcrypt_25519.c */
+static bool s_is_supported_curve(enum aws_ecc_curve_name curve_name) {
+    if (curve_name == AWS_CAL_ECDSA_P256 || curve_name == AWS_CAL_ECDSA_P384) {
+        return true;
+    }
+
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return false;
+}
+
 static struct aws_ecc_key_pair *s_alloc_pair_and_init_buffers(
     struct aws_allocator *allocator,
     enum aws_ecc_curve_name curve_name,
@@ -274,6 +419,10 @@ static struct aws_ecc_key_pair *s_alloc_pair_and_init_buffers(
     struct aws_byte_cursor pub_y,
     struct aws_byte_cursor priv_key) {
 
+    if (!s_is_supported_curve(curve_name)) {
+        return NULL;
+    }
+
     aws_thread_call_once(&s_ecdsa_thread_once, s_load_alg_handle, NULL);
 
     struct bcrypt_ecc_key_pair *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct bcrypt_ecc_key_pair));
@@ -368,6 +517,10 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_private_key_impl(
     enum aws_ecc_curve_name curve_name,
     const struct aws_byte_cursor *priv_key) {
 
+    if (s_is_25519_curve(curve_name)) {
+        return aws_ecc_key_pair_new_25519_from_private_key_impl(allocator, curve_name, priv_key);
+    }
+
     struct aws_byte_cursor empty;
     AWS_ZERO_STRUCT(empty);
     return s_alloc_pair_and_init_buffers(allocator, curve_name, empty, empty, *priv_key);
@@ -379,6 +532,14 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_public_key_impl(
     const struct aws_byte_cursor *public_key_x,
     const struct aws_byte_cursor *public_key_y) {
 
+    if (s_is_25519_curve(curve_name)) {
+        if (public_key_y->len) {
+            aws_raise_error(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM);
+            return NULL;
+        }
+        return aws_ecc_key_pair_new_25519_from_public_key_impl(allocator, curve_name, public_key_x);
+    }
+
     struct aws_byte_cursor empty;
     AWS_ZERO_STRUCT(empty);
     return s_alloc_pair_and_init_buffers(allocator, curve_name, *public_key_x, *public_key_y, empty);
@@ -387,6 +548,14 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_public_key_impl(
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_generate_random(
     struct aws_allocator *allocator,
     enum aws_ecc_curve_name curve_name) {
+    if (s_is_25519_curve(curve_name)) {
+        return aws_ecc_key_pair_new_25519_generate_random_impl(allocator, curve_name);
+    }
+
+    if (!s_is_supported_curve(curve_name)) {
+        return NULL;
+    }
+
     aws_thread_call_once(&s_ecdsa_thread_once, s_load_alg_handle, NULL);
 
     struct bcrypt_ecc_key_pair *key_impl = aws_mem_calloc(allocator, 1, sizeof(struct bcrypt_ecc_key_pair));
@@ -456,8 +625,6 @@ error:
 struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
     struct aws_allocator *allocator,
     const struct aws_byte_cursor *encoded_keys) {
-    struct aws_der_decoder *decoder = aws_der_decoder_new(allocator, *encoded_keys);
-
     /* we could have private key or a public key, or a full pair. */
     struct aws_byte_cursor pub_x;
     AWS_ZERO_STRUCT(pub_x);
@@ -467,18 +634,10 @@ struct aws_ecc_key_pair *aws_ecc_key_pair_new_from_asn1(
     AWS_ZERO_STRUCT(priv_d);
 
     enum aws_ecc_curve_name curve_name;
-    if (aws_der_decoder_load_ecc_key_pair(decoder, &pub_x, &pub_y, &priv_d, &curve_name)) {
-        goto error;
+    if (aws_der_load_ecc_key_pair(*encoded_keys, &pub_x, &pub_y, &priv_d, &curve_name)) {
+        return NULL;
     }
 
     /* now that we have the buffers, we can just use the normal code path. */
-    struct aws_ecc_key_pair *key_pair = s_alloc_pair_and_init_buffers(allocator, curve_name, pub_x, pub_y, priv_d);
-    aws_der_decoder_destroy(decoder);
-
-    return key_pair;
-error:
-    if (decoder) {
-        aws_der_decoder_destroy(decoder);
-    }
-    return NULL;
+    return s_alloc_pair_and_init_buffers(allocator, curve_name, pub_x, pub_y, priv_d);
 }
@@ -2,18 +2,33 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/cal/cal.h>
 #include <aws/cal/hash.h>
 #include <aws/common/thread.h>
 
 #include <windows.h>
 
 #include <bcrypt.h>
+#include <versionhelpers.h>
 #include <winerror.h>
 
+/* bcrypt.h leaves it out when targeting Windows 7 */
+#ifndef BCRYPT_HASH_REUSABLE_FLAG
+#    define BCRYPT_HASH_REUSABLE_FLAG 0x00000020
+#endif
+
 static BCRYPT_ALG_HANDLE s_sha256_alg = NULL;
 static size_t s_sha256_obj_len = 0;
 static aws_thread_once s_sha256_once = AWS_THREAD_ONCE_STATIC_INIT;
 
+static BCRYPT_ALG_HANDLE s_sha384_alg = NULL;
+static size_t s_sha384_obj_len = 0;
+static aws_thread_once s_sha384_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static BCRYPT_ALG_HANDLE s_sha512_alg = NULL;
+static size_t s_sha512_obj_len = 0;
+static aws_thread_once s_sha512_once = AWS_THREAD_ONCE_STATIC_INIT;
+
 static BCRYPT_ALG_HANDLE s_sha1_alg = NULL;
 static size_t s_sha1_obj_len = 0;
 static aws_thread_once s_sha1_once = AWS_THREAD_ONCE_STATIC_INIT;
@@ -25,19 +40,45 @@ static aws_thread_once s_md5_once = AWS_THREAD_ONCE_STATIC_INIT;
 static void s_destroy(struct aws_hash *hash);
 static int s_update(struct aws_hash *hash, const struct aws_byte_cursor *to_hash);
 static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output);
+static int s_reset(struct aws_hash *hash);
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash);
 
 static struct aws_hash_vtable s_sha256_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
     .alg_name = "SHA256",
     .provider = "Windows CNG",
 };
 
+static struct aws_hash_vtable s_sha384_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA384",
+    .provider = "Windows CNG",
+};
+
+static struct aws_hash_vtable s_sha512_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .alg_name = "SHA512",
+    .provider = "Windows CNG",
+};
+
 static struct aws_hash_vtable s_sha1_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
     .alg_name = "SHA1",
     .provider = "Windows CNG",
 };
@@ -46,16 +87,38 @@ static struct aws_hash_vtable s_md5_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
     .alg_name = "MD5",
     .provider = "Windows CNG",
 };
 
 struct bcrypt_hash_handle {
     struct aws_hash hash;
+    BCRYPT_ALG_HANDLE alg_handle;
     BCRYPT_HASH_HANDLE hash_handle;
     uint8_t *hash_obj;
+    size_t hash_obj_len;
 };
 
+/*
+ * BCRYPT_HASH_REUSABLE_FLAG only exists from Windows 8 on, Windows 7 fails BCryptCreateHash() when it's passed. Without
+ * it a finished hash object is spent, so reset has to build a new one in its place.
+ */
+static ULONG s_create_hash_flags = 0;
+static aws_thread_once s_create_hash_flags_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static void s_load_create_hash_flags(void *user_data) {
+    (void)user_data;
+    s_create_hash_flags = IsWindows8OrGreater() ? BCRYPT_HASH_REUSABLE_FLAG : 0;
+}
+
+/* shared with bcrypt_hmac.c */
+ULONG aws_bcrypt_create_hash_flags(void) {
+    aws_thread_call_once(&s_create_hash_flags_once, s_load_create_hash_flags, NULL);
+    return s_create_hash_flags;
+}
+
 static void s_load_sha256_alg_handle(void *user_data) {
     (void)user_data;
     /* this function is incredibly slow, LET IT LEAK*/
@@ -66,6 +129,26 @@ static void s_load_sha256_alg_handle(void *user_data) {
         s_sha256_alg, BCRYPT_OBJECT_LENGTH, (PBYTE)&s_sha256_obj_len, sizeof(s_sha256_obj_len), &result_length, 0);
 }
 
+static void s_load_sha384_alg_handle(void *user_data) {
+    (void)user_data;
+    /* this function is incredibly slow, LET IT LEAK*/
+    (void)BCryptOpenAlgorithmProvider(&s_sha384_alg, BCRYPT_SHA384_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0);
+    AWS_ASSERT(s_sha384_alg);
+    DWORD result_length = 0;
+    (void)BCryptGetProperty(
+        s_sha384_alg, BCRYPT_OBJECT_LENGTH, (PBYTE)&s_sha384_obj_len, sizeof(s_sha384_obj_len), &result_length, 0);
+}
+
+static void s_load_sha512_alg_handle(void *user_data) {
+    (void)user_data;
+    /* this function is incredibly slow, LET IT LEAK*/
+    (void)BCryptOpenAlgorithmProvider(&s_sha512_alg, BCRYPT_SHA512_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0);
+    AWS_ASSERT(s_sha512_alg);
+    DWORD result_length = 0;
+    (void)BCryptGetProperty(
+        s_sha512_alg, BCRYPT_OBJECT_LENGTH, (PBYTE)&s_sha512_obj_len, sizeof(s_sha512_obj_len), &result_length, 0);
+}
+
 static void s_load_sha1_alg_handle(void *user_data) {
     (void)user_data;
     /* this function is incredibly slow, LET IT LEAK*/
@@ -86,12 +169,16 @@ static void s_load_md5_alg_handle(void *user_data) {
         s_md5_alg, BCRYPT_OBJECT_LENGTH, (PBYTE)&s_md5_obj_len, sizeof(s_md5_obj_len), &result_length, 0);
 }
 
-struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator) {
-    aws_thread_call_once(&s_sha256_once, s_load_sha256_alg_handle, NULL);
+static struct aws_hash *s_hash_new(
+    struct aws_allocator *allocator,
+    BCRYPT_ALG_HANDLE alg_handle,
+    size_t obj_len,
+    struct aws_hash_vtable *vtable,
+    size_t digest_size) {
 
     struct bcrypt_hash_handle *bcrypt_hash = NULL;
     uint8_t *hash_obj = NULL;
-    aws_mem_acquire_many(allocator, 2, &bcrypt_hash, sizeof(struct bcrypt_hash_handle), &hash_obj, s_sha256_obj_len);
+    aws_mem_acquire_many(allocator, 2, &bcrypt_hash, sizeof(struct bcrypt_hash_handle), &hash_obj, obj_len);
 
     if (!bcrypt_hash) {
         return NULL;
@@ -99,13 +186,21 @@ struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator) {
 
     AWS_ZERO_STRUCT(*bcrypt_hash);
     bcrypt_hash->hash.allocator = allocator;
-    bcrypt_hash->hash.vtable = &s_sha256_vtable;
+    bcrypt_hash->hash.vtable = vtable;
     bcrypt_hash->hash.impl = bcrypt_hash;
-    bcrypt_hash->hash.digest_size = AWS_SHA256_LEN;
+    bcrypt_hash->hash.digest_size = digest_size;
     bcrypt_hash->hash.good = true;
+    bcrypt_hash->alg_handle = alg_handle;
     bcrypt_hash->hash_obj = hash_obj;
+    bcrypt_hash->hash_obj_len = obj_len;
     NTSTATUS status = BCryptCreateHash(
-        s_sha256_alg, &bcrypt_hash->hash_handle, bcrypt_hash->hash_obj, (ULONG)s_sha256_obj_len, NULL, 0, 0);
+        alg_handle,
+        &bcrypt_hash->hash_handle,
+        bcrypt_hash->hash_obj,
+        (ULONG)obj_len,
+        NULL,
+        0,
+        aws_bcrypt_create_hash_flags());
 
     if (((NTSTATUS)status) < 0) {
         aws_mem_release(allocator, bcrypt_hash);
@@ -115,67 +210,43 @@ struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator) {
     return &bcrypt_hash->hash;
 }
 
-struct aws_hash *aws_sha1_default_new(struct aws_allocator *allocator) {
-    aws_thread_call_once(&s_sha1_once, s_load_sha1_alg_handle, NULL);
-
-    struct bcrypt_hash_handle *bcrypt_hash = NULL;
-    uint8_t *hash_obj = NULL;
-    aws_mem_acquire_many(allocator, 2, &bcrypt_hash, sizeof(struct bcrypt_hash_handle), &hash_obj, s_sha1_obj_len);
+struct aws_hash *aws_sha256_default_new(struct aws_allocator *allocator) {
+    aws_thread_call_once(&s_sha256_once, s_load_sha256_alg_handle, NULL);
+    return s_hash_new(allocator, s_sha256_alg, s_sha256_obj_len, &s_sha256_vtable, AWS_SHA256_LEN);
+}
 
-    if (!bcrypt_hash) {
-        return NULL;
-    }
+struct aws_hash *aws_sha384_default_new(struct aws_allocator *allocator) {
+    aws_thread_call_once(&s_sha384_once, s_load_sha384_alg_handle, NULL);
+    return s_hash_new(allocator, s_sha384_alg, s_sha384_obj_len, &s_sha384_vtable, AWS_SHA384_LEN);
+}
 
-    AWS_ZERO_STRUCT(*bcrypt_hash);
-    bcrypt_hash->hash.allocator = allocator;
-    bcrypt_hash->hash.vtable = &s_sha1_vtable;
-    bcrypt_hash->hash.impl = bcrypt_hash;
-    bcrypt_hash->hash.digest_size = AWS_SHA1_LEN;
-    bcrypt_hash->hash.good = true;
-    bcrypt_hash->hash_obj = hash_obj;
-    NTSTATUS status = BCryptCreateHash(
-        s_sha1_alg, &bcrypt_hash->hash_handle, bcrypt_hash->hash_obj, (ULONG)s_sha1_obj_len, NULL, 0, 0);
+struct aws_hash *aws_sha512_default_new(struct aws_allocator *allocator) {
+    aws_thread_call_once(&s_sha512_once, s_load_sha512_alg_handle, NULL);
+    return s_hash_new(allocator, s_sha512_alg, s_sha512_obj_len, &s_sha512_vtable, AWS_SHA512_LEN);
+}
 
-    if (((NTSTATUS)status) < 0) {
-        aws_mem_release(allocator, bcrypt_hash);
-        return NULL;
-    }
+struct aws_hash *aws_sha512_256_default_new(struct aws_allocator *allocator) {
+    /* CNG has no SHA-512/256 provider, and its SHA-512 object can't be seeded with the truncated variant's IV. */
+    (void)allocator;
+    aws_raise_error(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM);
+    return NULL;
+}
 
-    return &bcrypt_hash->hash;
+struct aws_hash *aws_sha1_default_new(struct aws_allocator *allocator) {
+    aws_thread_call_once(&s_sha1_once, s_load_sha1_alg_handle, NULL);
+    return s_hash_new(allocator, s_sha1_alg, s_sha1_obj_len, &s_sha1_vtable, AWS_SHA1_LEN);
 }
 
 struct aws_hash *aws_md5_default_new(struct aws_allocator *allocator) {
     aws_thread_call_once(&s_md5_once, s_load_md5_alg_handle, NULL);
-
-    struct bcrypt_hash_handle *bcrypt_hash = NULL;
-    uint8_t *hash_obj = NULL;
-    aws_mem_acquire_many(allocator, 2, &bcrypt_hash, sizeof(struct bcrypt_hash_handle), &hash_obj, s_md5_obj_len);
-
-    if (!bcrypt_hash) {
-        return NULL;
-    }
-
-    AWS_ZERO_STRUCT(*bcrypt_hash);
-    bcrypt_hash->hash.allocator = allocator;
-    bcrypt_hash->hash.vtable = &s_md5_vtable;
-    bcrypt_hash->hash.impl = bcrypt_hash;
-    bcrypt_hash->hash.digest_size = AWS_MD5_LEN;
-    bcrypt_hash->hash.good = true;
-    bcrypt_hash->hash_obj = hash_obj;
-    NTSTATUS status =
-        BCryptCreateHash(s_md5_alg, &bcrypt_hash->hash_handle, bcrypt_hash->hash_obj, (ULONG)s_md5_obj_len, NULL, 0, 0);
-
-    if (((NTSTATUS)status) < 0) {
-        aws_mem_release(allocator, bcrypt_hash);
-        return NULL;
-    }
-
-    return &bcrypt_hash->hash;
+    return s_hash_new(allocator, s_md5_alg, s_md5_obj_len, &s_md5_vtable, AWS_MD5_LEN);
 }
 
 static void s_destroy(struct aws_hash *hash) {
     struct bcrypt_hash_handle *ctx = hash->impl;
-    BCryptDestroyHash(ctx->hash_handle);
+    if (ctx->hash_handle) {
+        BCryptDestroyHash(ctx->hash_handle);
+    }
     aws_mem_release(hash->allocator, ctx);
 }
 
@@ -218,3 +289,135 @@ static int s_finalize(struct aws_hash *hash, struct aws_byte_buf *output) {
     output->len += hash->digest_size;
     return AWS_OP_SUCCESS;
 }
+
+static int s_reset(struct aws_hash *hash) {
+    struct bcrypt_hash_handle *ctx = hash->impl;
+
+    if (!(aws_bcrypt_create_hash_flags() & BCRYPT_HASH_REUSABLE_FLAG)) {
+        /* nothing to carry over for a plain hash, so a fresh object in the same buffer is a reset */
+        if (ctx->hash_handle) {
+            BCryptDestroyHash(ctx->hash_handle);
+        }
+
+        NTSTATUS status =
+            BCryptCreateHash(ctx->alg_handle, &ctx->hash_handle, ctx->hash_obj, (ULONG)ctx->hash_obj_len, NULL, 0, 0);
+
+        if (((NTSTATUS)status) < 0) {
+            ctx->hash_handle = NULL;
+            hash->good = false;
+            return aws_raise_error(AWS_ERROR_INVALID_STATE);
+        }
+
+        hash->good = true;
+        return AWS_OP_SUCCESS;
+    }
+
+    /* Hash objects are created with BCRYPT_HASH_REUSABLE_FLAG, so BCryptFinishHash() puts
+     * them back into their initial state. If the caller is abandoning a digest midway,
+     * finish into a scratch buffer to discard whatever has been hashed so far. */
+    if (hash->good) {
+        uint8_t scratch[128] = {0};
+        AWS_ASSERT(sizeof(scratch) >= hash->digest_size);
+
+        NTSTATUS status = BCryptFinishHash(ctx->hash_handle, scratch, (ULONG)hash->digest_size, 0);
+
+        if (((NTSTATUS)status) < 0) {
+            hash->good = false;
+            return aws_raise_error(AWS_ERROR_INVALID_STATE);
+        }
+    }
+
+    hash->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_hash *s_duplicate(struct aws_allocator *allocator, const struct aws_hash *hash) {
+    const struct bcrypt_hash_handle *ctx = hash->impl;
+
+    struct bcrypt_hash_handle *bcrypt_hash = NULL;
+    uint8_t *hash_obj = NULL;
+    aws_mem_acquire_many(allocator, 2, &bcrypt_hash, sizeof(struct bcrypt_hash_handle), &hash_obj, ctx->hash_obj_len);
+
+    if (!bcrypt_hash) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*bcrypt_hash);
+    bcrypt_hash->hash = *hash;
+    bcrypt_hash->hash.allocator = allocator;
+    bcrypt_hash->hash.impl = bcrypt_hash;
+    bcrypt_hash->alg_handle = ctx->alg_handle;
+    bcrypt_hash->hash_obj = hash_obj;
+    bcrypt_hash->hash_obj_len = ctx->hash_obj_len;
+
+    NTSTATUS status = BCryptDuplicateHash(
+        ctx->hash_handle, &bcrypt_hash->hash_handle, bcrypt_hash->hash_obj, (ULONG)bcrypt_hash->hash_obj_len, 0);
+
+    if (((NTSTATUS)status) < 0) {
+        aws_mem_release(allocator, bcrypt_hash);
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    return &bcrypt_hash->hash;
+}
+
+/* BCryptHash() only exists from Windows 10 on, so it's looked up rather than linked against. */
+typedef NTSTATUS(WINAPI *bcrypt_hash_fn)(BCRYPT_ALG_HANDLE, PUCHAR, ULONG, PUCHAR, ULONG, PUCHAR, ULONG);
+
+static bcrypt_hash_fn s_bcrypt_hash = NULL;
+static aws_thread_once s_bcrypt_hash_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static void s_load_bcrypt_hash(void *user_data) {
+    (void)user_data;
+    HMODULE bcrypt_module = GetModuleHandleW(L"bcrypt.dll");
+    if (bcrypt_module) {
+        s_bcrypt_hash = (bcrypt_hash_fn)GetProcAddress(bcrypt_module, "BCryptHash");
+    }
+}
+
+static bool s_digest(
+    aws_thread_once *alg_once,
+    void (*load_alg_handle)(void *),
+    BCRYPT_ALG_HANDLE *alg_handle,
+    size_t digest_size,
+    const struct aws_byte_cursor *input,
+    uint8_t *out) {
+
+    aws_thread_call_once(&s_bcrypt_hash_once, s_load_bcrypt_hash, NULL);
+    if (!s_bcrypt_hash || input->len > ULONG_MAX) {
+        return false;
+    }
+
+    aws_thread_call_once(alg_once, load_alg_handle, NULL);
+    NTSTATUS status =
+        s_bcrypt_hash(*alg_handle, NULL, 0, (PUCHAR)input->ptr, (ULONG)input->len, out, (ULONG)digest_size);
+
+    return ((NTSTATUS)status) >= 0;
+}
+
+bool aws_sha256_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(&s_sha256_once, s_load_sha256_alg_handle, &s_sha256_alg, AWS_SHA256_LEN, input, out);
+}
+
+bool aws_sha384_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(&s_sha384_once, s_load_sha384_alg_handle, &s_sha384_alg, AWS_SHA384_LEN, input, out);
+}
+
+bool aws_sha512_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(&s_sha512_once, s_load_sha512_alg_handle, &s_sha512_alg, AWS_SHA512_LEN, input, out);
+}
+
+bool aws_sha512_256_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    (void)input;
+    (void)out;
+    return false;
+}
+
+bool aws_sha1_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(&s_sha1_once, s_load_sha1_alg_handle, &s_sha1_alg, AWS_SHA1_LEN, input, out);
+}
+
+bool aws_md5_default_digest(const struct aws_byte_cursor *input, uint8_t *out) {
+    return s_digest(&s_md5_once, s_load_md5_alg_handle, &s_md5_alg, AWS_MD5_LEN, input, out);
+}
@@ -10,52 +10,149 @@
 #include <bcrypt.h>
 #include <winerror.h>
 
+/* bcrypt.h leaves it out when targeting Windows 7 */
+#ifndef BCRYPT_HASH_REUSABLE_FLAG
+#    define BCRYPT_HASH_REUSABLE_FLAG 0x00000020
+#endif
+
 static BCRYPT_ALG_HANDLE s_sha256_hmac_alg = NULL;
 static size_t s_sha256_hmac_obj_len = 0;
 
 static aws_thread_once s_sha256_hmac_once = AWS_THREAD_ONCE_STATIC_INIT;
 
+static BCRYPT_ALG_HANDLE s_sha384_hmac_alg = NULL;
+static size_t s_sha384_hmac_obj_len = 0;
+
+static aws_thread_once s_sha384_hmac_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+static BCRYPT_ALG_HANDLE s_sha512_hmac_alg = NULL;
+static size_t s_sha512_hmac_obj_len = 0;
+
+static aws_thread_once s_sha512_hmac_once = AWS_THREAD_ONCE_STATIC_INIT;
+
+/* see bcrypt_hash.c */
+extern ULONG aws_bcrypt_create_hash_flags(void);
+
 static void s_destroy(struct aws_hmac *hash);
 static int s_update(struct aws_hmac *hash, const struct aws_byte_cursor *to_hash);
 static int s_finalize(struct aws_hmac *hash, struct aws_byte_buf *output);
+static int s_reset(struct aws_hmac *hmac);
+static struct aws_hmac *s_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac);
+static int s_rekey(struct aws_hmac *hmac, const struct aws_byte_cursor *secret);
 
 static struct aws_hmac_vtable s_sha256_hmac_vtable = {
     .destroy = s_destroy,
     .update = s_update,
     .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
     .alg_name = "SHA256 HMAC",
     .provider = "Windows CNG",
 };
 
+static struct aws_hmac_vtable s_sha384_hmac_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
+    .alg_name = "SHA384 HMAC",
+    .provider = "Windows CNG",
+};
+
+static struct aws_hmac_vtable s_sha512_hmac_vtable = {
+    .destroy = s_destroy,
+    .update = s_update,
+    .finalize = s_finalize,
+    .reset = s_reset,
+    .duplicate = s_duplicate,
+    .rekey = s_rekey,
+    .alg_name = "SHA512 HMAC",
+    .provider = "Windows CNG",
+};
+
 struct bcrypt_hmac_handle {
     struct aws_hmac hmac;
+    BCRYPT_ALG_HANDLE alg_handle;
     BCRYPT_HASH_HANDLE hash_handle;
     uint8_t *hash_obj;
+    size_t hash_obj_len;
+    /*
+     * Without BCRYPT_HASH_REUSABLE_FLAG a finished object is spent, and rebuilding it would need the secret. So an
+     * untouched copy of the keyed object is kept here instead, and reset duplicates it back over hash_handle.
+     */
+    BCRYPT_HASH_HANDLE keyed_handle;
+    uint8_t *keyed_obj;
 };
 
-static void s_load_alg_handle(void *user_data) {
-    (void)user_data;
+static bool s_hash_objects_are_reusable(void) {
+    return (aws_bcrypt_create_hash_flags() & BCRYPT_HASH_REUSABLE_FLAG) != 0;
+}
+
+static NTSTATUS s_keep_keyed_copy(struct bcrypt_hmac_handle *ctx) {
+    if (s_hash_objects_are_reusable()) {
+        return 0;
+    }
+
+    if (ctx->keyed_handle) {
+        BCryptDestroyHash(ctx->keyed_handle);
+        ctx->keyed_handle = NULL;
+    }
+
+    NTSTATUS status =
+        BCryptDuplicateHash(ctx->hash_handle, &ctx->keyed_handle, ctx->keyed_obj, (ULONG)ctx->hash_obj_len, 0);
+    if (((NTSTATUS)status) < 0) {
+        ctx->keyed_handle = NULL;
+    }
+    return status;
+}
+
+static void s_load_alg_handle(BCRYPT_ALG_HANDLE *alg_handle, size_t *obj_len, LPCWSTR alg_id) {
     /* this function is incredibly slow, LET IT LEAK*/
-    BCryptOpenAlgorithmProvider(
-        &s_sha256_hmac_alg, BCRYPT_SHA256_ALGORITHM, MS_PRIMITIVE_PROVIDER, BCRYPT_ALG_HANDLE_HMAC_FLAG);
-    AWS_ASSERT(s_sha256_hmac_alg);
+    BCryptOpenAlgorithmProvider(alg_handle, alg_id, MS_PRIMITIVE_PROVIDER, BCRYPT_ALG_HANDLE_HMAC_FLAG);
+    AWS_ASSERT(*alg_handle);
     DWORD result_length = 0;
-    BCryptGetProperty(
-        s_sha256_hmac_alg,
-        BCRYPT_OBJECT_LENGTH,
-        (PBYTE)&s_sha256_hmac_obj_len,
-        sizeof(s_sha256_hmac_obj_len),
-        &result_length,
-        0);
+    BCryptGetProperty(*alg_handle, BCRYPT_OBJECT_LENGTH, (PBYTE)obj_len, sizeof(*obj_len), &result_length, 0);
 }
 
-struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
-    aws_thread_call_once(&s_sha256_hmac_once, s_load_alg_handle, NULL);
+static void s_load_sha256_alg_handle(void *user_data) {
+    (void)user_data;
+    s_load_alg_handle(&s_sha256_hmac_alg, &s_sha256_hmac_obj_len, BCRYPT_SHA256_ALGORITHM);
+}
+
+static void s_load_sha384_alg_handle(void *user_data) {
+    (void)user_data;
+    s_load_alg_handle(&s_sha384_hmac_alg, &s_sha384_hmac_obj_len, BCRYPT_SHA384_ALGORITHM);
+}
+
+static void s_load_sha512_alg_handle(void *user_data) {
+    (void)user_data;
+    s_load_alg_handle(&s_sha512_hmac_alg, &s_sha512_hmac_obj_len, BCRYPT_SHA512_ALGORITHM);
+}
+
+static struct aws_hmac *s_hmac_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret,
+    BCRYPT_ALG_HANDLE alg_handle,
+    size_t obj_len,
+    struct aws_hmac_vtable *vtable,
+    size_t digest_size) {
 
     struct bcrypt_hmac_handle *bcrypt_hmac;
     uint8_t *hash_obj;
+    uint8_t *keyed_obj;
+    size_t keyed_obj_len = s_hash_objects_are_reusable() ? 0 : obj_len;
     aws_mem_acquire_many(
-        allocator, 2, &bcrypt_hmac, sizeof(struct bcrypt_hmac_handle), &hash_obj, s_sha256_hmac_obj_len);
+        allocator,
+        3,
+        &bcrypt_hmac,
+        sizeof(struct bcrypt_hmac_handle),
+        &hash_obj,
+        obj_len,
+        &keyed_obj,
+        keyed_obj_len);
 
     if (!bcrypt_hmac) {
         return NULL;
@@ -63,31 +160,63 @@ struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, co
 
     AWS_ZERO_STRUCT(*bcrypt_hmac);
     bcrypt_hmac->hmac.allocator = allocator;
-    bcrypt_hmac->hmac.vtable = &s_sha256_hmac_vtable;
+    bcrypt_hmac->hmac.vtable = vtable;
     bcrypt_hmac->hmac.impl = bcrypt_hmac;
-    bcrypt_hmac->hmac.digest_size = AWS_SHA256_HMAC_LEN;
+    bcrypt_hmac->hmac.digest_size = digest_size;
     bcrypt_hmac->hmac.good = true;
+    bcrypt_hmac->alg_handle = alg_handle;
     bcrypt_hmac->hash_obj = hash_obj;
+    bcrypt_hmac->hash_obj_len = obj_len;
+    bcrypt_hmac->keyed_obj = keyed_obj;
     NTSTATUS status = BCryptCreateHash(
-        s_sha256_hmac_alg,
+        alg_handle,
         &bcrypt_hmac->hash_handle,
         bcrypt_hmac->hash_obj,
-        (ULONG)s_sha256_hmac_obj_len,
+        (ULONG)obj_len,
         secret->ptr,
         (ULONG)secret->len,
-        0);
+        aws_bcrypt_create_hash_flags());
 
     if (((NTSTATUS)status) < 0) {
         aws_mem_release(allocator, bcrypt_hmac);
         return NULL;
     }
 
+    if (((NTSTATUS)s_keep_keyed_copy(bcrypt_hmac)) < 0) {
+        BCryptDestroyHash(bcrypt_hmac->hash_handle);
+        aws_mem_release(allocator, bcrypt_hmac);
+        return NULL;
+    }
+
     return &bcrypt_hmac->hmac;
 }
 
+struct aws_hmac *aws_sha256_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    aws_thread_call_once(&s_sha256_hmac_once, s_load_sha256_alg_handle, NULL);
+    return s_hmac_new(
+        allocator, secret, s_sha256_hmac_alg, s_sha256_hmac_obj_len, &s_sha256_hmac_vtable, AWS_SHA256_HMAC_LEN);
+}
+
+struct aws_hmac *aws_sha384_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    aws_thread_call_once(&s_sha384_hmac_once, s_load_sha384_alg_handle, NULL);
+    return s_hmac_new(
+        allocator, secret, s_sha384_hmac_alg, s_sha384_hmac_obj_len, &s_sha384_hmac_vtable, AWS_SHA384_HMAC_LEN);
+}
+
+struct aws_hmac *aws_sha512_hmac_default_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    aws_thread_call_once(&s_sha512_hmac_once, s_load_sha512_alg_handle, NULL);
+    return s_hmac_new(
+        allocator, secret, s_sha512_hmac_alg, s_sha512_hmac_obj_len, &s_sha512_hmac_vtable, AWS_SHA512_HMAC_LEN);
+}
+
 static void s_destroy(struct aws_hmac *hmac) {
     struct bcrypt_hmac_handle *ctx = hmac->impl;
-    BCryptDestroyHash(ctx->hash_handle);
+    if (ctx->hash_handle) {
+        BCryptDestroyHash(ctx->hash_handle);
+    }
+    if (ctx->keyed_handle) {
+        BCryptDestroyHash(ctx->keyed_handle);
+    }
     aws_mem_release(hmac->allocator, ctx);
 }
 
@@ -130,3 +259,139 @@ static int s_finalize(struct aws_hmac *hmac, struct aws_byte_buf *output) {
     output->len += hmac->digest_size;
     return AWS_OP_SUCCESS;
 }
+
+static int s_reset(struct aws_hmac *hmac) {
+    struct bcrypt_hmac_handle *ctx = hmac->impl;
+
+    if (!s_hash_objects_are_reusable()) {
+        if (!ctx->keyed_handle) {
+            return aws_raise_error(AWS_ERROR_INVALID_STATE);
+        }
+
+        if (ctx->hash_handle) {
+            BCryptDestroyHash(ctx->hash_handle);
+        }
+
+        NTSTATUS status =
+            BCryptDuplicateHash(ctx->keyed_handle, &ctx->hash_handle, ctx->hash_obj, (ULONG)ctx->hash_obj_len, 0);
+
+        if (((NTSTATUS)status) < 0) {
+            ctx->hash_handle = NULL;
+            hmac->good = false;
+            return aws_raise_error(AWS_ERROR_INVALID_STATE);
+        }
+
+        hmac->good = true;
+        return AWS_OP_SUCCESS;
+    }
+
+    /* Hmac objects are created with BCRYPT_HASH_REUSABLE_FLAG, so BCryptFinishHash() puts them
+     * back into their keyed state. If the caller is abandoning a digest midway, finish into a
+     * scratch buffer to discard whatever has been hashed so far. */
+    if (hmac->good) {
+        uint8_t scratch[128] = {0};
+        AWS_ASSERT(sizeof(scratch) >= hmac->digest_size);
+
+        NTSTATUS status = BCryptFinishHash(ctx->hash_handle, scratch, (ULONG)hmac->digest_size, 0);
+
+        if (((NTSTATUS)status) < 0) {
+            hmac->good = false;
+            return aws_raise_error(AWS_ERROR_INVALID_STATE);
+        }
+    }
+
+    hmac->good = true;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_hmac *s_duplicate(struct aws_allocator *allocator, const struct aws_hmac *hmac) {
+    if (!hmac->good) {
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    const struct bcrypt_hmac_handle *ctx = hmac->impl;
+
+    struct bcrypt_hmac_handle *bcrypt_hmac;
+    uint8_t *hash_obj;
+    uint8_t *keyed_obj;
+    size_t keyed_obj_len = ctx->keyed_handle ? ctx->hash_obj_len : 0;
+    aws_mem_acquire_many(
+        allocator,
+        3,
+        &bcrypt_hmac,
+        sizeof(struct bcrypt_hmac_handle),
+        &hash_obj,
+        ctx->hash_obj_len,
+        &keyed_obj,
+        keyed_obj_len);
+
+    if (!bcrypt_hmac) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*bcrypt_hmac);
+    bcrypt_hmac->hmac = *hmac;
+    bcrypt_hmac->hmac.allocator = allocator;
+    bcrypt_hmac->hmac.impl = bcrypt_hmac;
+    bcrypt_hmac->alg_handle = ctx->alg_handle;
+    bcrypt_hmac->hash_obj = hash_obj;
+    bcrypt_hmac->hash_obj_len = ctx->hash_obj_len;
+    bcrypt_hmac->keyed_obj = keyed_obj;
+
+    NTSTATUS status = BCryptDuplicateHash(
+        ctx->hash_handle, &bcrypt_hmac->hash_handle, bcrypt_hmac->hash_obj, (ULONG)bcrypt_hmac->hash_obj_len, 0);
+
+    if (((NTSTATUS)status) < 0) {
+        aws_mem_release(allocator, bcrypt_hmac);
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        return NULL;
+    }
+
+    if (ctx->keyed_handle) {
+        status = BCryptDuplicateHash(
+            ctx->keyed_handle, &bcrypt_hmac->keyed_handle, bcrypt_hmac->keyed_obj, (ULONG)bcrypt_hmac->hash_obj_len, 0);
+
+        if (((NTSTATUS)status) < 0) {
+            BCryptDestroyHash(bcrypt_hmac->hash_handle);
+            aws_mem_release(allocator, bcrypt_hmac);
+            aws_raise_error(AWS_ERROR_INVALID_STATE);
+            return NULL;
+        }
+    }
+
+    return &bcrypt_hmac->hmac;
+}
+
+static int s_rekey(struct aws_hmac *hmac, const struct aws_byte_cursor *secret) {
+    struct bcrypt_hmac_handle *ctx = hmac->impl;
+
+    /* CNG can't change the key of a hash object, but a new one can be built in the existing object buffer */
+    if (ctx->hash_handle) {
+        BCryptDestroyHash(ctx->hash_handle);
+        ctx->hash_handle = NULL;
+    }
+
+    NTSTATUS status = BCryptCreateHash(
+        ctx->alg_handle,
+        &ctx->hash_handle,
+        ctx->hash_obj,
+        (ULONG)ctx->hash_obj_len,
+        secret->ptr,
+        (ULONG)secret->len,
+        aws_bcrypt_create_hash_flags());
+
+    if (((NTSTATUS)status) < 0) {
+        ctx->hash_handle = NULL;
+        hmac->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (((NTSTATUS)s_keep_keyed_copy(ctx)) < 0) {
+        hmac->good = false;
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    hmac->good = true;
+    return AWS_OP_SUCCESS;
+}
@@ -12,3 +12,15 @@ void aws_cal_platform_init(struct aws_allocator *allocator) {
 void aws_cal_platform_clean_up(void) {}
 
 void aws_cal_platform_thread_clean_up(void) {}
+
+/* there is no libcrypto on this platform, its own allocations are not ours to route */
+bool aws_cal_platform_route_libcrypto_allocations(struct aws_allocator *allocator) {
+    (void)allocator;
+    return false;
+}
+
+void aws_cal_platform_libcrypto_info(const char **version, const char **version_string, const char **library) {
+    *version = NULL;
+    *version_string = NULL;
+    *library = NULL;
+}
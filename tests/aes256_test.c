@@ -2,8 +2,13 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/cal/cal.h>
+#include <aws/cal/private/symmetric_cipher_priv.h>
+#include <aws/cal/runtime_info.h>
 #include <aws/cal/symmetric_cipher.h>
 
+#include <aws/common/file.h>
+#include <aws/common/thread.h>
 #include <aws/testing/aws_test_harness.h>
 
 static int s_check_single_block_cbc(
@@ -1453,3 +1458,1908 @@ static int s_test_input_too_large_fn(struct aws_allocator *allocator, void *ctx)
     return AWS_OP_SUCCESS;
 }
 AWS_TEST_CASE(aes_test_input_too_large, s_test_input_too_large_fn)
+
+static int s_aes_ctr_encrypt_into_in_place_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* RFC3686 Case 9, the same vector as aes_ctr_RFC3686_Case_9. */
+    uint8_t iv[] = {0x00, 0x1C, 0xC5, 0xB7, 0x51, 0xA5, 0x1D, 0x70, 0xA1, 0xC1, 0x11, 0x48, 0x00, 0x00, 0x00, 0x01};
+
+    uint8_t key[] = {
+        0xFF, 0x7A, 0x61, 0x7C, 0xE6, 0x91, 0x48, 0xE4, 0xF1, 0x72, 0x6E, 0x2F, 0x43, 0x58, 0x1D, 0xE2,
+        0xAA, 0x62, 0xD9, 0xF8, 0x05, 0x53, 0x2E, 0xDF, 0xF1, 0xEE, 0xD6, 0x87, 0xFB, 0x54, 0x15, 0x3D,
+    };
+
+    uint8_t data[] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11,
+        0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23,
+    };
+
+    uint8_t expected[] = {
+        0xEB, 0x6C, 0x52, 0x82, 0x1D, 0x0B, 0xBB, 0xF7, 0xCE, 0x75, 0x94, 0x46, 0x2A, 0xCA, 0x4F, 0xAA, 0xB4, 0x07,
+        0xDF, 0x86, 0x65, 0x69, 0xFD, 0x07, 0xF4, 0x8C, 0xC0, 0xB5, 0x83, 0xD6, 0x07, 0x1F, 0x1E, 0xC0, 0xE6, 0xB8,
+    };
+
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+
+    struct aws_symmetric_cipher *cipher = aws_aes_ctr_256_new(allocator, &key_cur, &iv_cur);
+    ASSERT_NOT_NULL(cipher);
+
+    /* the buffer is exactly the size of the message, and is both the input and the output. */
+    uint8_t storage[sizeof(data)];
+    memcpy(storage, data, sizeof(data));
+    struct aws_byte_buf span = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    struct aws_byte_cursor in_place = aws_byte_cursor_from_array(storage, sizeof(storage));
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(cipher, in_place, &span));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption_into(cipher, &span));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), span.buffer, span.len);
+    ASSERT_PTR_EQUALS(storage, span.buffer);
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+
+    aws_byte_buf_reset(&span, false);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt_into(cipher, in_place, &span));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption_into(cipher, &span));
+    ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), span.buffer, span.len);
+
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_ctr_encrypt_into_in_place, s_aes_ctr_encrypt_into_in_place_fn)
+
+static int s_aes_gcm_encrypt_into_in_place_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_symmetric_cipher *cipher = aws_aes_gcm_256_new(allocator, NULL, NULL, NULL, NULL);
+    ASSERT_NOT_NULL(cipher);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str(TEST_ENCRYPTION_STRING);
+
+    /* encrypt with the growing api first to have something to compare against. */
+    struct aws_byte_buf expected_buf;
+    aws_byte_buf_init(&expected_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, input, &expected_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &expected_buf));
+
+    struct aws_byte_buf expected_tag;
+    aws_byte_buf_init_copy_from_cursor(&expected_tag, allocator, aws_symmetric_cipher_get_tag(cipher));
+    struct aws_byte_cursor key = aws_symmetric_cipher_get_key(cipher);
+    struct aws_byte_cursor iv = aws_symmetric_cipher_get_initialization_vector(cipher);
+
+    /* a fresh cipher with the same materials, so the tag is computed again rather than checked. */
+    struct aws_symmetric_cipher *in_place_cipher = aws_aes_gcm_256_new(allocator, &key, &iv, NULL, NULL);
+    ASSERT_NOT_NULL(in_place_cipher);
+
+    struct aws_byte_buf span;
+    aws_byte_buf_init_copy_from_cursor(&span, allocator, input);
+    struct aws_byte_cursor in_place = aws_byte_cursor_from_buf(&span);
+    span.len = 0;
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(in_place_cipher, in_place, &span));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption_into(in_place_cipher, &span));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, span.buffer, span.len);
+    ASSERT_UINT_EQUALS(input.len, span.capacity);
+
+    struct aws_byte_cursor tag = aws_symmetric_cipher_get_tag(in_place_cipher);
+    ASSERT_BIN_ARRAYS_EQUALS(expected_tag.buffer, expected_tag.len, tag.ptr, tag.len);
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(in_place_cipher));
+    span.len = 0;
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt_into(in_place_cipher, in_place, &span));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption_into(in_place_cipher, &span));
+    ASSERT_BIN_ARRAYS_EQUALS(input.ptr, input.len, span.buffer, span.len);
+
+    aws_byte_buf_clean_up(&span);
+    aws_symmetric_cipher_destroy(in_place_cipher);
+    aws_byte_buf_clean_up(&expected_tag);
+    aws_byte_buf_clean_up(&expected_buf);
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_encrypt_into_in_place, s_aes_gcm_encrypt_into_in_place_fn)
+
+static int s_aes_encrypt_into_never_grows_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_symmetric_cipher *cipher = aws_aes_ctr_256_new(allocator, NULL, NULL);
+    ASSERT_NOT_NULL(cipher);
+
+    uint8_t data[AWS_AES_256_CIPHER_BLOCK_SIZE * 2] = {0};
+    struct aws_byte_cursor data_cur = aws_byte_cursor_from_array(data, sizeof(data));
+
+    /* even a dynamic buffer is left alone. */
+    struct aws_byte_buf short_buf;
+    aws_byte_buf_init(&short_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_symmetric_cipher_encrypt_into(cipher, data_cur, &short_buf));
+    ASSERT_UINT_EQUALS(AWS_AES_256_CIPHER_BLOCK_SIZE, short_buf.capacity);
+    ASSERT_UINT_EQUALS(0, short_buf.len);
+    ASSERT_TRUE(aws_symmetric_cipher_is_good(cipher));
+
+    /* overlapping, but not exactly in place. */
+    uint8_t storage[AWS_AES_256_CIPHER_BLOCK_SIZE * 3] = {0};
+    struct aws_byte_buf span = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    struct aws_byte_cursor shifted = aws_byte_cursor_from_array(storage + 1, sizeof(data));
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_symmetric_cipher_encrypt_into(cipher, shifted, &span));
+    ASSERT_UINT_EQUALS(0, span.len);
+    ASSERT_TRUE(aws_symmetric_cipher_is_good(cipher));
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(cipher, data_cur, &span));
+    ASSERT_UINT_EQUALS(sizeof(data), span.len);
+
+    aws_byte_buf_clean_up(&short_buf);
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_encrypt_into_never_grows, s_aes_encrypt_into_never_grows_fn)
+
+static int s_check_vectored_matches_contiguous(
+    struct aws_allocator *allocator,
+    struct aws_symmetric_cipher *cipher,
+    struct aws_byte_cursor input) {
+
+    struct aws_byte_buf expected_buf;
+    aws_byte_buf_init(&expected_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, input, &expected_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &expected_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+
+    /* split on boundaries that don't line up with the block size, including an empty segment. */
+    struct aws_byte_cursor remaining = input;
+    struct aws_byte_cursor segments[4];
+    segments[0] = aws_byte_cursor_advance(&remaining, 5);
+    segments[1] = aws_byte_cursor_advance(&remaining, 0);
+    segments[2] = aws_byte_cursor_advance(&remaining, 20);
+    segments[3] = remaining;
+
+    struct aws_byte_buf encrypted_buf;
+    aws_byte_buf_init(&encrypted_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_vectored(cipher, segments, AWS_ARRAY_SIZE(segments), &encrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, encrypted_buf.buffer, encrypted_buf.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+
+    remaining = aws_byte_cursor_from_buf(&encrypted_buf);
+    segments[0] = aws_byte_cursor_advance(&remaining, 17);
+    segments[1] = aws_byte_cursor_advance(&remaining, 0);
+    segments[2] = aws_byte_cursor_advance(&remaining, 3);
+    segments[3] = remaining;
+
+    struct aws_byte_buf decrypted_buf;
+    aws_byte_buf_init(&decrypted_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt_vectored(cipher, segments, AWS_ARRAY_SIZE(segments), &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(input.ptr, input.len, decrypted_buf.buffer, decrypted_buf.len);
+
+    aws_byte_buf_clean_up(&decrypted_buf);
+    aws_byte_buf_clean_up(&encrypted_buf);
+    aws_byte_buf_clean_up(&expected_buf);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aes_test_vectored_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str(TEST_ENCRYPTION_STRING);
+
+    struct aws_symmetric_cipher *cipher = aws_aes_cbc_256_new(allocator, NULL, NULL);
+    ASSERT_NOT_NULL(cipher);
+    ASSERT_SUCCESS(s_check_vectored_matches_contiguous(allocator, cipher, input));
+    aws_symmetric_cipher_destroy(cipher);
+
+    cipher = aws_aes_ctr_256_new(allocator, NULL, NULL);
+    ASSERT_NOT_NULL(cipher);
+    ASSERT_SUCCESS(s_check_vectored_matches_contiguous(allocator, cipher, input));
+    aws_symmetric_cipher_destroy(cipher);
+
+    cipher = aws_aes_gcm_256_new(allocator, NULL, NULL, NULL, NULL);
+    ASSERT_NOT_NULL(cipher);
+    ASSERT_SUCCESS(s_check_vectored_matches_contiguous(allocator, cipher, input));
+    aws_symmetric_cipher_destroy(cipher);
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_test_vectored, s_aes_test_vectored_fn)
+
+/* gcm_256_KAT_2 through the one-shot api. */
+static int s_aes_gcm_seal_open_KAT_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t iv[] = {0x6B, 0x5C, 0xD3, 0x70, 0x5A, 0x73, 0x3C, 0x1A, 0xD9, 0x43, 0xD5, 0x8A};
+
+    uint8_t key[] = {
+        0xD2, 0x11, 0xF2, 0x78, 0xA4, 0x4E, 0xAB, 0x66, 0x6B, 0x10, 0x21, 0xF4, 0xB4, 0xF6, 0x0B, 0xA6,
+        0xB7, 0x44, 0x64, 0xFA, 0x9C, 0xB7, 0xB1, 0x34, 0x93, 0x4D, 0x78, 0x91, 0xE1, 0x47, 0x91, 0x69,
+    };
+
+    uint8_t data[] = {
+        0x16, 0x7B, 0x5C, 0x22, 0x61, 0x77, 0x73, 0x3A, 0x78, 0x2D, 0x61, 0x6D, 0x7A, 0x2D, 0x63, 0x65,
+        0x6B, 0x2D, 0x61, 0x6C, 0x67, 0x5C, 0x22, 0x3A, 0x20, 0x5C, 0x22, 0x41, 0x45, 0x53, 0x2F, 0x47,
+        0x43, 0x4D, 0x2F, 0x4E, 0x6F, 0x50, 0x61, 0x64, 0x64, 0x69, 0x6E, 0x67, 0x5C, 0x22, 0x7D,
+    };
+
+    /* ciphertext followed by the tag */
+    uint8_t expected[] = {
+        0x4C, 0x25, 0xAB, 0xD6, 0x6D, 0x3A, 0x1B, 0xCC, 0xE7, 0x94, 0xAC, 0xAA, 0xF4, 0xCE, 0xFD, 0xF6,
+        0xD2, 0x55, 0x2F, 0x4A, 0x82, 0xC5, 0x0A, 0x98, 0xCB, 0x15, 0xB4, 0x81, 0x2F, 0xF5, 0x57, 0xAB,
+        0xE5, 0x64, 0xA9, 0xCE, 0xFF, 0x15, 0xF3, 0x2D, 0xCF, 0x5A, 0x5A, 0xA7, 0x89, 0x48, 0x88, 0x03,
+        0xED, 0xE7, 0x1E, 0xC9, 0x52, 0xE6, 0x5A, 0xE7, 0xB4, 0xB8, 0x5C, 0xFE, 0xC7, 0xD3, 0x04,
+    };
+
+    /* the aad and the plaintext are the same bytes in this vector. */
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+    struct aws_byte_cursor aad_cur = aws_byte_cursor_from_array(data, sizeof(data));
+    struct aws_byte_cursor data_cur = aws_byte_cursor_from_array(data, sizeof(data));
+
+    uint8_t sealed[sizeof(expected)];
+    struct aws_byte_buf sealed_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed));
+    ASSERT_SUCCESS(aws_aes_256_gcm_seal(allocator, &key_cur, &iv_cur, &aad_cur, data_cur, &sealed_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), sealed_buf.buffer, sealed_buf.len);
+
+    /* run it twice, so the second call picks up whatever the first one cached. */
+    uint8_t opened[sizeof(data)];
+    for (size_t i = 0; i < 2; ++i) {
+        struct aws_byte_buf opened_buf = aws_byte_buf_from_empty_array(opened, sizeof(opened));
+        ASSERT_SUCCESS(aws_aes_256_gcm_open(
+            allocator, &key_cur, &iv_cur, &aad_cur, aws_byte_cursor_from_buf(&sealed_buf), &opened_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), opened_buf.buffer, opened_buf.len);
+    }
+
+    /* in place, with the plaintext at the start of a span that has room for the tag. */
+    uint8_t in_place[sizeof(expected)] = {0};
+    memcpy(in_place, data, sizeof(data));
+    struct aws_byte_buf in_place_buf = aws_byte_buf_from_empty_array(in_place, sizeof(in_place));
+    ASSERT_SUCCESS(aws_aes_256_gcm_seal(
+        allocator, &key_cur, &iv_cur, &aad_cur, aws_byte_cursor_from_array(in_place, sizeof(data)), &in_place_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), in_place_buf.buffer, in_place_buf.len);
+
+    struct aws_byte_cursor in_place_sealed = aws_byte_cursor_from_buf(&in_place_buf);
+    in_place_buf.len = 0;
+    ASSERT_SUCCESS(aws_aes_256_gcm_open(allocator, &key_cur, &iv_cur, &aad_cur, in_place_sealed, &in_place_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), in_place_buf.buffer, in_place_buf.len);
+
+    aws_cal_thread_clean_up();
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_seal_open_KAT, s_aes_gcm_seal_open_KAT_fn)
+
+static int s_aes_gcm_seal_open_failures_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x42};
+    uint8_t nonce[AWS_AES_256_GCM_NONCE_LEN] = {0x24};
+    uint8_t message[] = "a data key, or anything else small enough to seal in one go";
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor nonce_cur = aws_byte_cursor_from_array(nonce, sizeof(nonce));
+    struct aws_byte_cursor input = aws_byte_cursor_from_array(message, sizeof(message) - 1);
+
+    uint8_t sealed[sizeof(message) - 1 + AWS_AES_256_GCM_TAG_LEN];
+    struct aws_byte_buf sealed_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed) - 1);
+    ASSERT_ERROR(
+        AWS_ERROR_SHORT_BUFFER, aws_aes_256_gcm_seal(allocator, &key_cur, &nonce_cur, NULL, input, &sealed_buf));
+    ASSERT_UINT_EQUALS(0, sealed_buf.len);
+
+    struct aws_byte_cursor short_nonce = aws_byte_cursor_from_array(nonce, sizeof(nonce) - 1);
+    sealed_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed));
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM,
+        aws_aes_256_gcm_seal(allocator, &key_cur, &short_nonce, NULL, input, &sealed_buf));
+
+    struct aws_byte_cursor short_key = aws_byte_cursor_from_array(key, sizeof(key) - 1);
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM,
+        aws_aes_256_gcm_seal(allocator, &short_key, &nonce_cur, NULL, input, &sealed_buf));
+
+    ASSERT_SUCCESS(aws_aes_256_gcm_seal(allocator, &key_cur, &nonce_cur, NULL, input, &sealed_buf));
+    ASSERT_UINT_EQUALS(sizeof(sealed), sealed_buf.len);
+    struct aws_byte_cursor sealed_cur = aws_byte_cursor_from_buf(&sealed_buf);
+
+    uint8_t opened[sizeof(message) - 1];
+    struct aws_byte_buf opened_buf = aws_byte_buf_from_empty_array(opened, sizeof(opened));
+
+    /* sealed with no aad, so any aad at all has to fail, and nothing it decrypted may be left behind. */
+    struct aws_byte_cursor aad = aws_byte_cursor_from_c_str("aad");
+    memset(opened, 0xFF, sizeof(opened));
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED,
+        aws_aes_256_gcm_open(allocator, &key_cur, &nonce_cur, &aad, sealed_cur, &opened_buf));
+    ASSERT_UINT_EQUALS(0, opened_buf.len);
+    for (size_t i = 0; i < sizeof(opened); ++i) {
+        ASSERT_UINT_EQUALS(0, opened[i]);
+    }
+
+    /* flip a bit in the ciphertext, then in the tag */
+    sealed[0] ^= 0x01;
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED,
+        aws_aes_256_gcm_open(allocator, &key_cur, &nonce_cur, NULL, sealed_cur, &opened_buf));
+    sealed[0] ^= 0x01;
+    sealed[sizeof(sealed) - 1] ^= 0x01;
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED,
+        aws_aes_256_gcm_open(allocator, &key_cur, &nonce_cur, NULL, sealed_cur, &opened_buf));
+    sealed[sizeof(sealed) - 1] ^= 0x01;
+
+    /* too short to even hold a tag */
+    struct aws_byte_cursor truncated = aws_byte_cursor_from_array(sealed, AWS_AES_256_GCM_TAG_LEN - 1);
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED,
+        aws_aes_256_gcm_open(allocator, &key_cur, &nonce_cur, NULL, truncated, &opened_buf));
+
+    ASSERT_SUCCESS(aws_aes_256_gcm_open(allocator, &key_cur, &nonce_cur, NULL, sealed_cur, &opened_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(input.ptr, input.len, opened_buf.buffer, opened_buf.len);
+
+    aws_cal_thread_clean_up();
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_seal_open_failures, s_aes_gcm_seal_open_failures_fn)
+
+struct aes_gcm_oneshot_thread_args {
+    struct aws_allocator *allocator;
+    int result;
+};
+
+static void s_aes_gcm_oneshot_thread_fn(void *arg) {
+    struct aes_gcm_oneshot_thread_args *args = arg;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x42};
+    uint8_t nonce[AWS_AES_256_GCM_NONCE_LEN] = {0x24};
+    uint8_t message[] = "sealed and opened on a thread that never cleans up after itself";
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor nonce_cur = aws_byte_cursor_from_array(nonce, sizeof(nonce));
+
+    uint8_t sealed[sizeof(message) + AWS_AES_256_GCM_TAG_LEN];
+    struct aws_byte_buf sealed_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed));
+    uint8_t opened[sizeof(message)];
+    struct aws_byte_buf opened_buf = aws_byte_buf_from_empty_array(opened, sizeof(opened));
+
+    args->result = AWS_OP_ERR;
+    if (aws_aes_256_gcm_seal(
+            args->allocator,
+            &key_cur,
+            &nonce_cur,
+            NULL,
+            aws_byte_cursor_from_array(message, sizeof(message)),
+            &sealed_buf) ||
+        aws_aes_256_gcm_open(
+            args->allocator, &key_cur, &nonce_cur, NULL, aws_byte_cursor_from_buf(&sealed_buf), &opened_buf)) {
+        return;
+    }
+
+    if (opened_buf.len == sizeof(message) && memcmp(opened, message, sizeof(message)) == 0) {
+        args->result = AWS_OP_SUCCESS;
+    }
+}
+
+/* a launched thread that exits without aws_cal_thread_clean_up() still releases its one-shot GCM context */
+static int s_aes_gcm_seal_open_thread_exit_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aes_gcm_oneshot_thread_args args = {.allocator = allocator, .result = AWS_OP_ERR};
+    struct aws_thread thread;
+    ASSERT_SUCCESS(aws_thread_init(&thread, allocator));
+    ASSERT_SUCCESS(aws_thread_launch(&thread, s_aes_gcm_oneshot_thread_fn, &args, aws_default_thread_options()));
+    ASSERT_SUCCESS(aws_thread_join(&thread));
+    aws_thread_clean_up(&thread);
+    ASSERT_SUCCESS(args.result);
+
+    aws_cal_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_seal_open_thread_exit, s_aes_gcm_seal_open_thread_exit_fn)
+
+/* Encrypts input with both ciphers, then decrypts the result with prepared_cipher, resetting both along the way. */
+static int s_check_prepared_key_cipher_matches(
+    struct aws_allocator *allocator,
+    struct aws_symmetric_cipher *raw_cipher,
+    struct aws_symmetric_cipher *prepared_cipher,
+    struct aws_byte_cursor input) {
+
+    struct aws_byte_buf expected_buf;
+    aws_byte_buf_init(&expected_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(raw_cipher, input, &expected_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(raw_cipher, &expected_buf));
+
+    struct aws_byte_buf encrypted_buf;
+    aws_byte_buf_init(&encrypted_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(prepared_cipher, input, &encrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(prepared_cipher, &encrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, encrypted_buf.buffer, encrypted_buf.len);
+
+    struct aws_byte_cursor expected_tag = aws_symmetric_cipher_get_tag(raw_cipher);
+    struct aws_byte_cursor tag = aws_symmetric_cipher_get_tag(prepared_cipher);
+    ASSERT_BIN_ARRAYS_EQUALS(expected_tag.ptr, expected_tag.len, tag.ptr, tag.len);
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(raw_cipher));
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(prepared_cipher));
+
+    struct aws_byte_buf decrypted_buf;
+    aws_byte_buf_init(&decrypted_buf, allocator, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    struct aws_byte_cursor encrypted_cur = aws_byte_cursor_from_buf(&encrypted_buf);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(prepared_cipher, encrypted_cur, &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(prepared_cipher, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(input.ptr, input.len, decrypted_buf.buffer, decrypted_buf.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(prepared_cipher));
+
+    aws_byte_buf_clean_up(&decrypted_buf);
+    aws_byte_buf_clean_up(&encrypted_buf);
+    aws_byte_buf_clean_up(&expected_buf);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aes_prepared_key_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    };
+    uint8_t iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0xA5};
+    uint8_t aad[] = {0x01, 0x02, 0x03};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+    struct aws_byte_cursor gcm_iv_cur = aws_byte_cursor_from_array(iv, AWS_AES_256_GCM_NONCE_LEN);
+    struct aws_byte_cursor aad_cur = aws_byte_cursor_from_array(aad, sizeof(aad));
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str(TEST_ENCRYPTION_STRING);
+
+    struct aws_aes_256_prepared_key *prepared_key = aws_aes_256_prepared_key_new(allocator, &key_cur);
+    ASSERT_NOT_NULL(prepared_key);
+
+    /* a second round per mode makes sure ciphers after the first get keyed from what the first one left behind. */
+    for (size_t round = 0; round < 2; ++round) {
+        struct aws_symmetric_cipher *raw_cipher = aws_aes_cbc_256_new(allocator, &key_cur, &iv_cur);
+        struct aws_symmetric_cipher *prepared_cipher =
+            aws_aes_cbc_256_new_from_prepared_key(allocator, prepared_key, &iv_cur);
+        ASSERT_NOT_NULL(raw_cipher);
+        ASSERT_NOT_NULL(prepared_cipher);
+        struct aws_byte_cursor cipher_key = aws_symmetric_cipher_get_key(prepared_cipher);
+        ASSERT_BIN_ARRAYS_EQUALS(key, sizeof(key), cipher_key.ptr, cipher_key.len);
+        ASSERT_SUCCESS(s_check_prepared_key_cipher_matches(allocator, raw_cipher, prepared_cipher, input));
+        aws_symmetric_cipher_destroy(prepared_cipher);
+        aws_symmetric_cipher_destroy(raw_cipher);
+
+        raw_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &iv_cur);
+        prepared_cipher = aws_aes_ctr_256_new_from_prepared_key(allocator, prepared_key, &iv_cur);
+        ASSERT_NOT_NULL(raw_cipher);
+        ASSERT_NOT_NULL(prepared_cipher);
+        ASSERT_SUCCESS(s_check_prepared_key_cipher_matches(allocator, raw_cipher, prepared_cipher, input));
+        aws_symmetric_cipher_destroy(prepared_cipher);
+        aws_symmetric_cipher_destroy(raw_cipher);
+
+        raw_cipher = aws_aes_gcm_256_new(allocator, &key_cur, &gcm_iv_cur, &aad_cur, NULL);
+        prepared_cipher = aws_aes_gcm_256_new_from_prepared_key(allocator, prepared_key, &gcm_iv_cur, &aad_cur, NULL);
+        ASSERT_NOT_NULL(raw_cipher);
+        ASSERT_NOT_NULL(prepared_cipher);
+        ASSERT_SUCCESS(s_check_prepared_key_cipher_matches(allocator, raw_cipher, prepared_cipher, input));
+        aws_symmetric_cipher_destroy(prepared_cipher);
+        aws_symmetric_cipher_destroy(raw_cipher);
+    }
+
+    /* the RFC 3394 vector from aes_keywrap_RFC3394_256BitKey256CekTestVector. The cipher's reference keeps the key
+     * alive after ours is dropped. */
+    uint8_t cek[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+                     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    uint8_t expected_wrapped[] = {0x28, 0xC9, 0xF4, 0x04, 0xC4, 0xB8, 0x10, 0xF4, 0xCB, 0xCC, 0xB3, 0x5C, 0xFB, 0x87,
+                                  0xF8, 0x26, 0x3F, 0x57, 0x86, 0xE2, 0xD8, 0x0E, 0xD3, 0x26, 0xCB, 0xC7, 0xF0, 0xE7,
+                                  0x1A, 0x99, 0xF4, 0x3B, 0xFB, 0x98, 0x8B, 0x9B, 0x7A, 0x02, 0xDD, 0x21};
+
+    aws_aes_256_prepared_key_acquire(prepared_key);
+    struct aws_symmetric_cipher *cipher = aws_aes_keywrap_256_new_from_prepared_key(allocator, prepared_key);
+    ASSERT_NOT_NULL(cipher);
+    aws_aes_256_prepared_key_release(prepared_key);
+    aws_aes_256_prepared_key_release(prepared_key);
+
+    struct aws_byte_buf wrapped_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&wrapped_buf, allocator, sizeof(expected_wrapped)));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(cek, sizeof(cek)), &wrapped_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &wrapped_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_wrapped, sizeof(expected_wrapped), wrapped_buf.buffer, wrapped_buf.len);
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+
+    struct aws_byte_buf unwrapped_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&unwrapped_buf, allocator, sizeof(cek)));
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(cipher, aws_byte_cursor_from_buf(&wrapped_buf), &unwrapped_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &unwrapped_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(cek, sizeof(cek), unwrapped_buf.buffer, unwrapped_buf.len);
+
+    aws_symmetric_cipher_destroy(cipher);
+    aws_byte_buf_clean_up(&unwrapped_buf);
+    aws_byte_buf_clean_up(&wrapped_buf);
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_prepared_key, s_aes_prepared_key_fn)
+
+static int s_aes_prepared_key_validate_materials_fails_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0};
+    uint8_t iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+
+    ASSERT_NULL(aws_aes_256_prepared_key_new(allocator, NULL));
+    ASSERT_UINT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    struct aws_byte_cursor short_key = aws_byte_cursor_from_array(key, sizeof(key) - 1);
+    ASSERT_NULL(aws_aes_256_prepared_key_new(allocator, &short_key));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM, aws_last_error());
+
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_aes_256_prepared_key *prepared_key = aws_aes_256_prepared_key_new(allocator, &key_cur);
+    ASSERT_NOT_NULL(prepared_key);
+
+    struct aws_byte_cursor short_iv = aws_byte_cursor_from_array(iv, sizeof(iv) - 1);
+    ASSERT_NULL(aws_aes_cbc_256_new_from_prepared_key(allocator, prepared_key, &short_iv));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM, aws_last_error());
+    ASSERT_NULL(aws_aes_ctr_256_new_from_prepared_key(allocator, prepared_key, &short_iv));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM, aws_last_error());
+
+    struct aws_byte_cursor long_gcm_iv = aws_byte_cursor_from_array(iv, sizeof(iv));
+    ASSERT_NULL(aws_aes_gcm_256_new_from_prepared_key(allocator, prepared_key, &long_gcm_iv, NULL, NULL));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM, aws_last_error());
+
+    /* a NULL iv is generated, same as the raw key constructors. */
+    struct aws_symmetric_cipher *cipher =
+        aws_aes_gcm_256_new_from_prepared_key(allocator, prepared_key, NULL, NULL, NULL);
+    ASSERT_NOT_NULL(cipher);
+    ASSERT_UINT_EQUALS(AWS_AES_256_GCM_NONCE_LEN, aws_symmetric_cipher_get_initialization_vector(cipher).len);
+    aws_symmetric_cipher_destroy(cipher);
+
+    aws_aes_256_prepared_key_release(prepared_key);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_prepared_key_validate_materials_fails, s_aes_prepared_key_validate_materials_fails_fn)
+
+struct aes_run_tasks_stats {
+    size_t calls;
+    size_t tasks;
+};
+
+/* runs the tasks back to front on the calling thread, which is enough to show they don't depend on each other */
+static void s_aes_run_tasks_in_reverse(void (*task_fn)(void *), void **task_args, size_t task_count, void *user_data) {
+    struct aes_run_tasks_stats *stats = user_data;
+    stats->calls += 1;
+    stats->tasks += task_count;
+
+    for (size_t i = task_count; i > 0; --i) {
+        task_fn(task_args[i - 1]);
+    }
+}
+
+/* lengths around the task and block boundaries, with task_len = 64 */
+static const size_t s_parallel_test_lengths[] = {0, 1, 15, 16, 17, 63, 64, 65, 127, 128, 129, 1000, 4099};
+
+static void s_fill_parallel_test_input(uint8_t *input, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        input[i] = (uint8_t)(i * 31 + 7);
+    }
+}
+
+static int s_aes_ctr_crypt_parallel_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x11, 0x22, 0x33};
+    /* start close enough to a carry out of the low byte that the pieces' counters cross it */
+    uint8_t iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0xA0, 0xA1, 0xA2, [12] = 0x00, 0x00, 0x00, 0xF0};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+
+    struct aws_aes_256_prepared_key *prepared_key = aws_aes_256_prepared_key_new(allocator, &key_cur);
+    ASSERT_NOT_NULL(prepared_key);
+
+    struct aes_run_tasks_stats stats = {0};
+    struct aws_aes_256_parallel_options options = {
+        .run_tasks = s_aes_run_tasks_in_reverse,
+        .user_data = &stats,
+        .task_len = 64,
+        .min_parallel_len = 128,
+    };
+
+    uint8_t input[4099];
+    uint8_t expected[sizeof(input)];
+    uint8_t output[sizeof(input)];
+    s_fill_parallel_test_input(input, sizeof(input));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(s_parallel_test_lengths); ++i) {
+        size_t len = s_parallel_test_lengths[i];
+        struct aws_byte_cursor input_cur = aws_byte_cursor_from_array(input, len);
+
+        struct aws_symmetric_cipher *cipher = aws_aes_ctr_256_new(allocator, &key_cur, &iv_cur);
+        ASSERT_NOT_NULL(cipher);
+        struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(cipher, input_cur, &expected_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption_into(cipher, &expected_buf));
+        aws_symmetric_cipher_destroy(cipher);
+
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+        ASSERT_SUCCESS(
+            aws_aes_256_ctr_crypt_parallel(allocator, prepared_key, &iv_cur, input_cur, &output_buf, &options));
+        ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, output_buf.buffer, output_buf.len);
+
+        /* and back again, in place */
+        struct aws_byte_cursor output_cur = aws_byte_cursor_from_buf(&output_buf);
+        output_buf.len = 0;
+        ASSERT_SUCCESS(
+            aws_aes_256_ctr_crypt_parallel(allocator, prepared_key, &iv_cur, output_cur, &output_buf, &options));
+        ASSERT_BIN_ARRAYS_EQUALS(input, len, output_buf.buffer, output_buf.len);
+    }
+
+    /* only the inputs of at least min_parallel_len were handed out, each in task_len pieces */
+    ASSERT_TRUE(stats.calls > 0);
+    ASSERT_UINT_EQUALS(2 * (2 + 3 + 16 + 65), stats.tasks);
+
+    /* pieces past the end of the last 4 bytes of the counter carry into the rest of it, as the cipher does */
+    uint8_t carry_iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0xA0, [11] = 0x7F, 0xFF, 0xFF, 0xFF, 0xF0};
+    struct aws_byte_cursor carry_iv_cur = aws_byte_cursor_from_array(carry_iv, sizeof(carry_iv));
+    struct aws_symmetric_cipher *carry_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &carry_iv_cur);
+    ASSERT_NOT_NULL(carry_cipher);
+    struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+        carry_cipher, aws_byte_cursor_from_array(input, sizeof(input)), &expected_buf));
+    aws_symmetric_cipher_destroy(carry_cipher);
+
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_aes_256_ctr_crypt_parallel(
+        allocator,
+        prepared_key,
+        &carry_iv_cur,
+        aws_byte_cursor_from_array(input, sizeof(input)),
+        &output_buf,
+        &options));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, output_buf.buffer, output_buf.len);
+
+    /* run_tasks is mandatory */
+    options.run_tasks = NULL;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_aes_256_ctr_crypt_parallel(
+            allocator, prepared_key, &iv_cur, aws_byte_cursor_from_array(input, 16), &output_buf, &options));
+
+    aws_aes_256_prepared_key_release(prepared_key);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_ctr_crypt_parallel, s_aes_ctr_crypt_parallel_fn)
+
+static int s_aes_gcm_seal_open_parallel_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x42, 0x43};
+    uint8_t nonce[AWS_AES_256_GCM_NONCE_LEN] = {0x24, 0x25};
+    uint8_t aad[40];
+    s_fill_parallel_test_input(aad, sizeof(aad));
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor nonce_cur = aws_byte_cursor_from_array(nonce, sizeof(nonce));
+    /* no aad, less than a block, and more than a block */
+    struct aws_byte_cursor aads[] = {
+        {0},
+        aws_byte_cursor_from_array(aad, 5),
+        aws_byte_cursor_from_array(aad, sizeof(aad)),
+    };
+
+    struct aws_aes_256_prepared_key *prepared_key = aws_aes_256_prepared_key_new(allocator, &key_cur);
+    ASSERT_NOT_NULL(prepared_key);
+
+    struct aes_run_tasks_stats stats = {0};
+    struct aws_aes_256_parallel_options options = {
+        .run_tasks = s_aes_run_tasks_in_reverse,
+        .user_data = &stats,
+        .task_len = 64,
+        .min_parallel_len = 128,
+    };
+
+    uint8_t input[4099];
+    uint8_t expected[sizeof(input) + AWS_AES_256_GCM_TAG_LEN];
+    uint8_t sealed[sizeof(expected)];
+    uint8_t opened[sizeof(input)];
+    s_fill_parallel_test_input(input, sizeof(input));
+
+    for (size_t a = 0; a < AWS_ARRAY_SIZE(aads); ++a) {
+        for (size_t i = 0; i < AWS_ARRAY_SIZE(s_parallel_test_lengths); ++i) {
+            size_t len = s_parallel_test_lengths[i];
+            struct aws_byte_cursor input_cur = aws_byte_cursor_from_array(input, len);
+
+            struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+            ASSERT_SUCCESS(aws_aes_256_gcm_seal(allocator, &key_cur, &nonce_cur, &aads[a], input_cur, &expected_buf));
+
+            struct aws_byte_buf sealed_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed));
+            ASSERT_SUCCESS(aws_aes_256_gcm_seal_parallel(
+                allocator, prepared_key, &nonce_cur, &aads[a], input_cur, &sealed_buf, &options));
+            ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, sealed_buf.buffer, sealed_buf.len);
+
+            struct aws_byte_buf opened_buf = aws_byte_buf_from_empty_array(opened, sizeof(opened));
+            ASSERT_SUCCESS(aws_aes_256_gcm_open_parallel(
+                allocator,
+                prepared_key,
+                &nonce_cur,
+                &aads[a],
+                aws_byte_cursor_from_buf(&sealed_buf),
+                &opened_buf,
+                &options));
+            ASSERT_BIN_ARRAYS_EQUALS(input, len, opened_buf.buffer, opened_buf.len);
+        }
+    }
+    ASSERT_TRUE(stats.calls > 0);
+
+    /* in place, then a flipped bit in the last piece, which must fail and leave nothing behind */
+    memcpy(sealed, input, sizeof(input));
+    struct aws_byte_buf in_place_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed));
+    ASSERT_SUCCESS(aws_aes_256_gcm_seal_parallel(
+        allocator,
+        prepared_key,
+        &nonce_cur,
+        NULL,
+        aws_byte_cursor_from_array(sealed, sizeof(input)),
+        &in_place_buf,
+        &options));
+    struct aws_byte_cursor sealed_cur = aws_byte_cursor_from_buf(&in_place_buf);
+
+    sealed[sizeof(input) - 1] ^= 0x01;
+    struct aws_byte_buf opened_buf = aws_byte_buf_from_empty_array(opened, sizeof(opened));
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED,
+        aws_aes_256_gcm_open_parallel(allocator, prepared_key, &nonce_cur, NULL, sealed_cur, &opened_buf, &options));
+    ASSERT_UINT_EQUALS(0, opened_buf.len);
+    for (size_t i = 0; i < sizeof(opened); ++i) {
+        ASSERT_UINT_EQUALS(0, opened[i]);
+    }
+    sealed[sizeof(input) - 1] ^= 0x01;
+
+    in_place_buf.len = 0;
+    ASSERT_SUCCESS(
+        aws_aes_256_gcm_open_parallel(allocator, prepared_key, &nonce_cur, NULL, sealed_cur, &in_place_buf, &options));
+    ASSERT_BIN_ARRAYS_EQUALS(input, sizeof(input), in_place_buf.buffer, in_place_buf.len);
+
+    /* run_tasks is mandatory */
+    options.run_tasks = NULL;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_aes_256_gcm_seal_parallel(
+            allocator, prepared_key, &nonce_cur, NULL, aws_byte_cursor_from_array(input, 16), &opened_buf, &options));
+
+    aws_aes_256_prepared_key_release(prepared_key);
+    aws_cal_thread_clean_up();
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_seal_open_parallel, s_aes_gcm_seal_open_parallel_fn)
+
+/* streams data through a GCM cipher, in uneven pieces, and appends the tag */
+static int s_aes_gcm_cipher_seal(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *key,
+    const struct aws_byte_cursor *nonce,
+    const struct aws_byte_cursor *aad,
+    struct aws_byte_cursor plaintext,
+    struct aws_byte_buf *out) {
+
+    struct aws_symmetric_cipher *cipher = aws_aes_gcm_256_new(allocator, key, nonce, aad, NULL);
+    ASSERT_NOT_NULL(cipher);
+
+    while (plaintext.len) {
+        struct aws_byte_cursor piece = aws_byte_cursor_advance(&plaintext, aws_min_size(plaintext.len, 100003));
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(cipher, piece, out));
+    }
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption_into(cipher, out));
+
+    struct aws_byte_cursor tag = aws_symmetric_cipher_get_tag(cipher);
+    ASSERT_UINT_EQUALS(AWS_AES_256_GCM_TAG_LEN, tag.len);
+    ASSERT_SUCCESS(aws_byte_buf_append(out, &tag));
+
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+
+/*
+ * The parallel functions combine GHASH values themselves, so check them against the backend's own GCM cipher: a
+ * known answer, aad with nothing to encrypt, and inputs big enough to be split with the default options.
+ */
+static int s_aes_gcm_parallel_matches_cipher_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* NIST GCM test case 16 */
+    uint8_t key[] = {0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+                     0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08};
+    uint8_t nonce[] = {0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88};
+    uint8_t aad[] = {0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed,
+                     0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xab, 0xad, 0xda, 0xd2};
+    uint8_t plaintext[] = {0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26,
+                           0x9a, 0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31,
+                           0x8a, 0x72, 0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49,
+                           0xa6, 0xb5, 0x25, 0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39};
+    uint8_t expected[] = {0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42,
+                          0x7d, 0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55,
+                          0xd1, 0xaa, 0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10, 0x56,
+                          0x82, 0x88, 0x38, 0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 0xbc, 0xc9, 0xf6, 0x62,
+                          0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55,
+                          0x1b};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor nonce_cur = aws_byte_cursor_from_array(nonce, sizeof(nonce));
+    struct aws_byte_cursor aad_cur = aws_byte_cursor_from_array(aad, sizeof(aad));
+
+    struct aws_aes_256_prepared_key *prepared_key = aws_aes_256_prepared_key_new(allocator, &key_cur);
+    ASSERT_NOT_NULL(prepared_key);
+
+    struct aes_run_tasks_stats stats = {0};
+    struct aws_aes_256_parallel_options options = {
+        .run_tasks = s_aes_run_tasks_in_reverse,
+        .user_data = &stats,
+    };
+
+    uint8_t sealed[sizeof(expected)];
+    struct aws_byte_buf sealed_buf = aws_byte_buf_from_empty_array(sealed, sizeof(sealed));
+    ASSERT_SUCCESS(aws_aes_256_gcm_seal_parallel(
+        allocator,
+        prepared_key,
+        &nonce_cur,
+        &aad_cur,
+        aws_byte_cursor_from_array(plaintext, sizeof(plaintext)),
+        &sealed_buf,
+        &options));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), sealed_buf.buffer, sealed_buf.len);
+
+    /* a bit more than the default 4MB min_parallel_len, in 1MB pieces with a short one at the end */
+    const size_t lengths[] = {0, 4 * 1024 * 1024 + 4099};
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, lengths[1]));
+    s_fill_parallel_test_input(input_buf.buffer, input_buf.capacity);
+    struct aws_byte_buf expected_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&expected_buf, allocator, lengths[1] + AWS_AES_256_GCM_TAG_LEN));
+    struct aws_byte_buf parallel_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&parallel_buf, allocator, lengths[1] + AWS_AES_256_GCM_TAG_LEN));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(lengths); ++i) {
+        struct aws_byte_cursor input_cur = aws_byte_cursor_from_array(input_buf.buffer, lengths[i]);
+
+        expected_buf.len = 0;
+        ASSERT_SUCCESS(s_aes_gcm_cipher_seal(allocator, &key_cur, &nonce_cur, &aad_cur, input_cur, &expected_buf));
+
+        parallel_buf.len = 0;
+        ASSERT_SUCCESS(aws_aes_256_gcm_seal_parallel(
+            allocator, prepared_key, &nonce_cur, &aad_cur, input_cur, &parallel_buf, &options));
+        ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, parallel_buf.buffer, parallel_buf.len);
+
+        struct aws_byte_cursor sealed_cur = aws_byte_cursor_from_buf(&parallel_buf);
+        struct aws_byte_buf opened_buf = aws_byte_buf_from_empty_array(expected_buf.buffer, expected_buf.capacity);
+        ASSERT_SUCCESS(aws_aes_256_gcm_open_parallel(
+            allocator, prepared_key, &nonce_cur, &aad_cur, sealed_cur, &opened_buf, &options));
+        ASSERT_BIN_ARRAYS_EQUALS(input_cur.ptr, input_cur.len, opened_buf.buffer, opened_buf.len);
+    }
+    /* only the long input was split, once to seal it and once to open it */
+    ASSERT_UINT_EQUALS(2, stats.calls);
+    ASSERT_UINT_EQUALS(10, stats.tasks);
+
+    aws_byte_buf_clean_up(&parallel_buf);
+    aws_byte_buf_clean_up(&expected_buf);
+    aws_byte_buf_clean_up(&input_buf);
+    aws_aes_256_prepared_key_release(prepared_key);
+    aws_cal_thread_clean_up();
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_parallel_matches_cipher, s_aes_gcm_parallel_matches_cipher_fn)
+
+static int s_aes_ctr_seek_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x5A, 0x5B};
+    uint8_t iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0x01, 0x02, [12] = 0x00, 0x00, 0x00, 0xFA};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+
+    uint8_t plaintext[1000];
+    s_fill_parallel_test_input(plaintext, sizeof(plaintext));
+
+    struct aws_symmetric_cipher *cipher = aws_aes_ctr_256_new(allocator, &key_cur, &iv_cur);
+    ASSERT_NOT_NULL(cipher);
+
+    uint8_t ciphertext[sizeof(plaintext)];
+    struct aws_byte_buf ciphertext_buf = aws_byte_buf_from_empty_array(ciphertext, sizeof(ciphertext));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+        cipher, aws_byte_cursor_from_array(plaintext, sizeof(plaintext)), &ciphertext_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption_into(cipher, &ciphertext_buf));
+
+    /* seeking works on a finalized cipher, and in both directions */
+    const size_t offsets[] = {0, 1, 15, 16, 17, 100, 511, 999};
+    uint8_t output[sizeof(plaintext)];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(offsets); ++i) {
+        size_t offset = offsets[i];
+
+        ASSERT_SUCCESS(aws_symmetric_cipher_seek(cipher, offset));
+        ASSERT_TRUE(aws_symmetric_cipher_is_good(cipher));
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+        /* split the read so the second part starts part way through a block */
+        ASSERT_SUCCESS(aws_symmetric_cipher_decrypt_into(
+            cipher, aws_byte_cursor_from_array(ciphertext + offset, 1), &output_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_decrypt_into(
+            cipher,
+            aws_byte_cursor_from_array(ciphertext + offset + 1, sizeof(ciphertext) - offset - 1),
+            &output_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(plaintext + offset, sizeof(plaintext) - offset, output_buf.buffer, output_buf.len);
+
+        ASSERT_SUCCESS(aws_symmetric_cipher_seek(cipher, offset));
+        output_buf.len = 0;
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+            cipher, aws_byte_cursor_from_array(plaintext + offset, sizeof(plaintext) - offset), &output_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(ciphertext + offset, sizeof(ciphertext) - offset, output_buf.buffer, output_buf.len);
+    }
+
+    /* a 1 byte read 4GB in matches a cipher whose IV already points at that block */
+    uint64_t far_offset = ((uint64_t)1 << 32) + 5;
+    uint8_t far_iv[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    memcpy(far_iv, iv, sizeof(iv));
+    far_iv[12] = 0x10;
+    struct aws_byte_cursor far_iv_cur = aws_byte_cursor_from_array(far_iv, sizeof(far_iv));
+    struct aws_symmetric_cipher *far_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &far_iv_cur);
+    ASSERT_NOT_NULL(far_cipher);
+
+    uint8_t expected[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+    ASSERT_SUCCESS(
+        aws_symmetric_cipher_encrypt_into(far_cipher, aws_byte_cursor_from_array(plaintext, 6), &expected_buf));
+    aws_symmetric_cipher_destroy(far_cipher);
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_seek(cipher, far_offset));
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(
+        aws_symmetric_cipher_encrypt_into(cipher, aws_byte_cursor_from_array(plaintext + 5, 1), &output_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected + 5, 1, output_buf.buffer, output_buf.len);
+
+    aws_symmetric_cipher_destroy(cipher);
+
+    /*
+     * The whole IV is one 128 bit counter. Streaming across the end of its last 4 bytes carries into byte 11, seeking
+     * there has to land on the same keystream, and so does a cipher started at the carried value. An IV of all ones
+     * wraps to zero.
+     */
+    uint8_t carry_iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0x01, 0x02, [11] = 0x00, 0xFF, 0xFF, 0xFF, 0xFE};
+    uint8_t carried_iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0x01, 0x02, [11] = 0x01, 0x00, 0x00, 0x00, 0x00};
+    uint8_t ones_iv[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    uint8_t zero_iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    memset(ones_iv, 0xFF, sizeof(ones_iv));
+
+    struct aws_byte_cursor carry_iv_cur = aws_byte_cursor_from_array(carry_iv, sizeof(carry_iv));
+    struct aws_symmetric_cipher *carry_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &carry_iv_cur);
+    ASSERT_NOT_NULL(carry_cipher);
+    uint8_t carry_stream[4 * AWS_AES_256_CIPHER_BLOCK_SIZE];
+    struct aws_byte_buf carry_stream_buf = aws_byte_buf_from_empty_array(carry_stream, sizeof(carry_stream));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+        carry_cipher, aws_byte_cursor_from_array(plaintext, sizeof(carry_stream)), &carry_stream_buf));
+
+    const size_t carry_offsets[] = {2 * AWS_AES_256_CIPHER_BLOCK_SIZE, 2 * AWS_AES_256_CIPHER_BLOCK_SIZE + 5, 63};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(carry_offsets); ++i) {
+        size_t offset = carry_offsets[i];
+        ASSERT_SUCCESS(aws_symmetric_cipher_seek(carry_cipher, offset));
+        output_buf.len = 0;
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+            carry_cipher, aws_byte_cursor_from_array(plaintext + offset, sizeof(carry_stream) - offset), &output_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(
+            carry_stream + offset, sizeof(carry_stream) - offset, output_buf.buffer, output_buf.len);
+    }
+    aws_symmetric_cipher_destroy(carry_cipher);
+
+    struct aws_byte_cursor carried_iv_cur = aws_byte_cursor_from_array(carried_iv, sizeof(carried_iv));
+    struct aws_symmetric_cipher *carried_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &carried_iv_cur);
+    ASSERT_NOT_NULL(carried_cipher);
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+        carried_cipher,
+        aws_byte_cursor_from_array(plaintext + 2 * AWS_AES_256_CIPHER_BLOCK_SIZE, 2 * AWS_AES_256_CIPHER_BLOCK_SIZE),
+        &output_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        carry_stream + 2 * AWS_AES_256_CIPHER_BLOCK_SIZE,
+        2 * AWS_AES_256_CIPHER_BLOCK_SIZE,
+        output_buf.buffer,
+        output_buf.len);
+    aws_symmetric_cipher_destroy(carried_cipher);
+
+    struct aws_byte_cursor ones_iv_cur = aws_byte_cursor_from_array(ones_iv, sizeof(ones_iv));
+    struct aws_symmetric_cipher *ones_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &ones_iv_cur);
+    ASSERT_NOT_NULL(ones_cipher);
+    struct aws_byte_cursor zero_iv_cur = aws_byte_cursor_from_array(zero_iv, sizeof(zero_iv));
+    struct aws_symmetric_cipher *zero_cipher = aws_aes_ctr_256_new(allocator, &key_cur, &zero_iv_cur);
+    ASSERT_NOT_NULL(zero_cipher);
+
+    expected_buf.len = 0;
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+        zero_cipher, aws_byte_cursor_from_array(plaintext, AWS_AES_256_CIPHER_BLOCK_SIZE), &expected_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_seek(ones_cipher, AWS_AES_256_CIPHER_BLOCK_SIZE));
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_into(
+        ones_cipher, aws_byte_cursor_from_array(plaintext, AWS_AES_256_CIPHER_BLOCK_SIZE), &output_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, output_buf.buffer, output_buf.len);
+    aws_symmetric_cipher_destroy(zero_cipher);
+    aws_symmetric_cipher_destroy(ones_cipher);
+
+    /* there's no seeking in the other modes */
+    struct aws_symmetric_cipher *cbc_cipher = aws_aes_cbc_256_new(allocator, &key_cur, &iv_cur);
+    ASSERT_NOT_NULL(cbc_cipher);
+    ASSERT_ERROR(AWS_ERROR_UNSUPPORTED_OPERATION, aws_symmetric_cipher_seek(cbc_cipher, 16));
+    aws_symmetric_cipher_destroy(cbc_cipher);
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_ctr_seek, s_aes_ctr_seek_fn)
+
+static int s_aes_xts_256_unsupported(struct aws_symmetric_cipher *cipher) {
+    /* platforms without XTS have to say so rather than hand back something else. */
+    ASSERT_NULL(cipher);
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM, aws_last_error());
+    return AWS_OP_SUCCESS;
+}
+
+/* IEEE 1619-2007 XTS-AES-256 vector 10. */
+static int s_aes_xts_256_ieee1619_vector_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[] = {0x27, 0x18, 0x28, 0x18, 0x28, 0x45, 0x90, 0x45, 0x23, 0x53, 0x60, 0x28, 0x74, 0x71, 0x35, 0x26,
+                     0x62, 0x49, 0x77, 0x57, 0x24, 0x70, 0x93, 0x69, 0x99, 0x59, 0x57, 0x49, 0x66, 0x96, 0x76, 0x27,
+                     0x31, 0x41, 0x59, 0x26, 0x53, 0x58, 0x97, 0x93, 0x23, 0x84, 0x62, 0x64, 0x33, 0x83, 0x27, 0x95,
+                     0x02, 0x88, 0x41, 0x97, 0x16, 0x93, 0x99, 0x37, 0x51, 0x05, 0x82, 0x09, 0x74, 0x94, 0x45, 0x92};
+    /* data unit sequence number 0xff, little-endian */
+    uint8_t tweak[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0xff};
+
+    uint8_t data[512];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)i;
+    }
+
+    uint8_t expected[] = {
+        0x1c, 0x3b, 0x3a, 0x10, 0x2f, 0x77, 0x03, 0x86, 0xe4, 0x83, 0x6c, 0x99, 0xe3, 0x70, 0xcf, 0x9b,
+        0xea, 0x00, 0x80, 0x3f, 0x5e, 0x48, 0x23, 0x57, 0xa4, 0xae, 0x12, 0xd4, 0x14, 0xa3, 0xe6, 0x3b,
+        0x5d, 0x31, 0xe2, 0x76, 0xf8, 0xfe, 0x4a, 0x8d, 0x66, 0xb3, 0x17, 0xf9, 0xac, 0x68, 0x3f, 0x44,
+        0x68, 0x0a, 0x86, 0xac, 0x35, 0xad, 0xfc, 0x33, 0x45, 0xbe, 0xfe, 0xcb, 0x4b, 0xb1, 0x88, 0xfd,
+        0x57, 0x76, 0x92, 0x6c, 0x49, 0xa3, 0x09, 0x5e, 0xb1, 0x08, 0xfd, 0x10, 0x98, 0xba, 0xec, 0x70,
+        0xaa, 0xa6, 0x69, 0x99, 0xa7, 0x2a, 0x82, 0xf2, 0x7d, 0x84, 0x8b, 0x21, 0xd4, 0xa7, 0x41, 0xb0,
+        0xc5, 0xcd, 0x4d, 0x5f, 0xff, 0x9d, 0xac, 0x89, 0xae, 0xba, 0x12, 0x29, 0x61, 0xd0, 0x3a, 0x75,
+        0x71, 0x23, 0xe9, 0x87, 0x0f, 0x8a, 0xcf, 0x10, 0x00, 0x02, 0x08, 0x87, 0x89, 0x14, 0x29, 0xca,
+        0x2a, 0x3e, 0x7a, 0x7d, 0x7d, 0xf7, 0xb1, 0x03, 0x55, 0x16, 0x5c, 0x8b, 0x9a, 0x6d, 0x0a, 0x7d,
+        0xe8, 0xb0, 0x62, 0xc4, 0x50, 0x0d, 0xc4, 0xcd, 0x12, 0x0c, 0x0f, 0x74, 0x18, 0xda, 0xe3, 0xd0,
+        0xb5, 0x78, 0x1c, 0x34, 0x80, 0x3f, 0xa7, 0x54, 0x21, 0xc7, 0x90, 0xdf, 0xe1, 0xde, 0x18, 0x34,
+        0xf2, 0x80, 0xd7, 0x66, 0x7b, 0x32, 0x7f, 0x6c, 0x8c, 0xd7, 0x55, 0x7e, 0x12, 0xac, 0x3a, 0x0f,
+        0x93, 0xec, 0x05, 0xc5, 0x2e, 0x04, 0x93, 0xef, 0x31, 0xa1, 0x2d, 0x3d, 0x92, 0x60, 0xf7, 0x9a,
+        0x28, 0x9d, 0x6a, 0x37, 0x9b, 0xc7, 0x0c, 0x50, 0x84, 0x14, 0x73, 0xd1, 0xa8, 0xcc, 0x81, 0xec,
+        0x58, 0x3e, 0x96, 0x45, 0xe0, 0x7b, 0x8d, 0x96, 0x70, 0x65, 0x5b, 0xa5, 0xbb, 0xcf, 0xec, 0xc6,
+        0xdc, 0x39, 0x66, 0x38, 0x0a, 0xd8, 0xfe, 0xcb, 0x17, 0xb6, 0xba, 0x02, 0x46, 0x9a, 0x02, 0x0a,
+        0x84, 0xe1, 0x8e, 0x8f, 0x84, 0x25, 0x20, 0x70, 0xc1, 0x3e, 0x9f, 0x1f, 0x28, 0x9b, 0xe5, 0x4f,
+        0xbc, 0x48, 0x14, 0x57, 0x77, 0x8f, 0x61, 0x60, 0x15, 0xe1, 0x32, 0x7a, 0x02, 0xb1, 0x40, 0xf1,
+        0x50, 0x5e, 0xb3, 0x09, 0x32, 0x6d, 0x68, 0x37, 0x8f, 0x83, 0x74, 0x59, 0x5c, 0x84, 0x9d, 0x84,
+        0xf4, 0xc3, 0x33, 0xec, 0x44, 0x23, 0x88, 0x51, 0x43, 0xcb, 0x47, 0xbd, 0x71, 0xc5, 0xed, 0xae,
+        0x9b, 0xe6, 0x9a, 0x2f, 0xfe, 0xce, 0xb1, 0xbe, 0xc9, 0xde, 0x24, 0x4f, 0xbe, 0x15, 0x99, 0x2b,
+        0x11, 0xb7, 0x7c, 0x04, 0x0f, 0x12, 0xbd, 0x8f, 0x6a, 0x97, 0x5a, 0x44, 0xa0, 0xf9, 0x0c, 0x29,
+        0xa9, 0xab, 0xc3, 0xd4, 0xd8, 0x93, 0x92, 0x72, 0x84, 0xc5, 0x87, 0x54, 0xcc, 0xe2, 0x94, 0x52,
+        0x9f, 0x86, 0x14, 0xdc, 0xd2, 0xab, 0xa9, 0x91, 0x92, 0x5f, 0xed, 0xc4, 0xae, 0x74, 0xff, 0xac,
+        0x6e, 0x33, 0x3b, 0x93, 0xeb, 0x4a, 0xff, 0x04, 0x79, 0xda, 0x9a, 0x41, 0x0e, 0x44, 0x50, 0xe0,
+        0xdd, 0x7a, 0xe4, 0xc6, 0xe2, 0x91, 0x09, 0x00, 0x57, 0x5d, 0xa4, 0x01, 0xfc, 0x07, 0x05, 0x9f,
+        0x64, 0x5e, 0x8b, 0x7e, 0x9b, 0xfd, 0xef, 0x33, 0x94, 0x30, 0x54, 0xff, 0x84, 0x01, 0x14, 0x93,
+        0xc2, 0x7b, 0x34, 0x29, 0xea, 0xed, 0xb4, 0xed, 0x53, 0x76, 0x44, 0x1a, 0x77, 0xed, 0x43, 0x85,
+        0x1a, 0xd7, 0x7f, 0x16, 0xf5, 0x41, 0xdf, 0xd2, 0x69, 0xd5, 0x0d, 0x6a, 0x5f, 0x14, 0xfb, 0x0a,
+        0xab, 0x1c, 0xbb, 0x4c, 0x15, 0x50, 0xbe, 0x97, 0xf7, 0xab, 0x40, 0x66, 0x19, 0x3c, 0x4c, 0xaa,
+        0x77, 0x3d, 0xad, 0x38, 0x01, 0x4b, 0xd2, 0x09, 0x2f, 0xa7, 0x55, 0xc8, 0x24, 0xbb, 0x5e, 0x54,
+        0xc4, 0xf3, 0x6f, 0xfd, 0xa9, 0xfc, 0xea, 0x70, 0xb9, 0xc6, 0xe6, 0x93, 0xe1, 0x48, 0xc1, 0x51};
+
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor tweak_cur = aws_byte_cursor_from_array(tweak, sizeof(tweak));
+    struct aws_symmetric_cipher *cipher = aws_aes_xts_256_new(allocator, &key_cur, &tweak_cur);
+    if (cipher == NULL) {
+        return s_aes_xts_256_unsupported(cipher);
+    }
+
+    /* input is held until finalize, so it can arrive in any pieces */
+    struct aws_byte_buf encrypted_buf;
+    aws_byte_buf_init(&encrypted_buf, allocator, sizeof(data));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(data, 100), &encrypted_buf));
+    ASSERT_UINT_EQUALS(0, encrypted_buf.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(
+        cipher, aws_byte_cursor_from_array(data + 100, sizeof(data) - 100), &encrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), encrypted_buf.buffer, encrypted_buf.len);
+
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+    struct aws_byte_buf decrypted_buf;
+    aws_byte_buf_init(&decrypted_buf, allocator, sizeof(data));
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(cipher, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), decrypted_buf.buffer, decrypted_buf.len);
+
+    aws_byte_buf_clean_up(&decrypted_buf);
+    aws_byte_buf_clean_up(&encrypted_buf);
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_xts_256_ieee1619_vector, s_aes_xts_256_ieee1619_vector_fn)
+
+static int s_aes_xts_256_ciphertext_stealing_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_symmetric_cipher *cipher = aws_aes_xts_256_new(allocator, NULL, NULL);
+    if (cipher == NULL) {
+        return s_aes_xts_256_unsupported(cipher);
+    }
+
+    ASSERT_UINT_EQUALS(AWS_AES_256_XTS_KEY_BYTE_LEN, aws_symmetric_cipher_get_key(cipher).len);
+    ASSERT_UINT_EQUALS(AWS_AES_256_CIPHER_BLOCK_SIZE, aws_symmetric_cipher_get_initialization_vector(cipher).len);
+
+    /* anything from one block up works, the partial last block is stolen from the one before it */
+    const size_t lengths[] = {16, 17, 31, 33, 100};
+    uint8_t data[100];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 7);
+    }
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(lengths); ++i) {
+        struct aws_byte_cursor data_cur = aws_byte_cursor_from_array(data, lengths[i]);
+
+        ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+        uint8_t encrypted[sizeof(data)];
+        struct aws_byte_buf encrypted_buf = aws_byte_buf_from_empty_array(encrypted, sizeof(encrypted));
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, data_cur, &encrypted_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+        ASSERT_UINT_EQUALS(lengths[i], encrypted_buf.len);
+        ASSERT_FALSE(aws_byte_cursor_eq_byte_buf(&data_cur, &encrypted_buf));
+
+        ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+        uint8_t decrypted[sizeof(data)];
+        struct aws_byte_buf decrypted_buf = aws_byte_buf_from_empty_array(decrypted, sizeof(decrypted));
+        ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(cipher, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &decrypted_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(data, lengths[i], decrypted_buf.buffer, decrypted_buf.len);
+    }
+
+    /* less than a block isn't a data unit */
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+    uint8_t out[AWS_AES_256_CIPHER_BLOCK_SIZE];
+    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(out, sizeof(out));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(data, 15), &out_buf));
+    ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_symmetric_cipher_finalize_encryption(cipher, &out_buf));
+
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_xts_256_ciphertext_stealing, s_aes_xts_256_ciphertext_stealing_fn)
+
+/* helper for aes_xts_256_reset_with_tweak, the whole data unit in one call */
+static int s_xts_crypt(struct aws_symmetric_cipher *cipher, struct aws_byte_cursor input, bool encrypt, uint8_t *out) {
+    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(out, input.len);
+    if (encrypt) {
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, input, &out_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &out_buf));
+    } else {
+        ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(cipher, input, &out_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &out_buf));
+    }
+    ASSERT_UINT_EQUALS(input.len, out_buf.len);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aes_xts_256_reset_with_tweak_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_symmetric_cipher *cipher = aws_aes_xts_256_new(allocator, NULL, NULL);
+    if (cipher == NULL) {
+        return s_aes_xts_256_unsupported(cipher);
+    }
+
+    uint8_t data[48];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 3);
+    }
+    struct aws_byte_cursor data_cur = aws_byte_cursor_from_array(data, sizeof(data));
+    struct aws_byte_cursor key_cur = aws_symmetric_cipher_get_key(cipher);
+
+    /* every sector of a run through one cipher matches a cipher made for just that sector's tweak */
+    for (uint8_t sector = 0; sector < 4; ++sector) {
+        uint8_t tweak[AWS_AES_256_CIPHER_BLOCK_SIZE] = {sector};
+        struct aws_byte_cursor tweak_cur = aws_byte_cursor_from_array(tweak, sizeof(tweak));
+
+        uint8_t encrypted[sizeof(data)];
+        ASSERT_SUCCESS(aws_symmetric_cipher_reset_with_tweak(cipher, tweak_cur));
+        ASSERT_SUCCESS(s_xts_crypt(cipher, data_cur, true, encrypted));
+        struct aws_byte_cursor iv_cur = aws_symmetric_cipher_get_initialization_vector(cipher);
+        ASSERT_TRUE(aws_byte_cursor_eq(&iv_cur, &tweak_cur));
+
+        struct aws_symmetric_cipher *sector_cipher = aws_aes_xts_256_new(allocator, &key_cur, &tweak_cur);
+        ASSERT_NOT_NULL(sector_cipher);
+        uint8_t expected[sizeof(data)];
+        ASSERT_SUCCESS(s_xts_crypt(sector_cipher, data_cur, true, expected));
+        aws_symmetric_cipher_destroy(sector_cipher);
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), encrypted, sizeof(encrypted));
+
+        uint8_t decrypted[sizeof(data)];
+        ASSERT_SUCCESS(aws_symmetric_cipher_reset_with_tweak(cipher, tweak_cur));
+        ASSERT_SUCCESS(s_xts_crypt(cipher, aws_byte_cursor_from_array(encrypted, sizeof(encrypted)), false, decrypted));
+        ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), decrypted, sizeof(decrypted));
+    }
+
+    /* input held back for the old tweak is dropped */
+    uint8_t tweak[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    uint8_t out[sizeof(data)];
+    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(out, sizeof(out));
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset_with_tweak(cipher, aws_byte_cursor_from_array(tweak, sizeof(tweak))));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(data, 20), &out_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset_with_tweak(cipher, aws_byte_cursor_from_array(tweak, sizeof(tweak))));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, data_cur, &out_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &out_buf));
+    ASSERT_UINT_EQUALS(sizeof(data), out_buf.len);
+
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM,
+        aws_symmetric_cipher_reset_with_tweak(cipher, aws_byte_cursor_from_array(tweak, sizeof(tweak) - 1)));
+    aws_symmetric_cipher_destroy(cipher);
+
+    /* the other modes have no tweak */
+    struct aws_symmetric_cipher *cbc_cipher = aws_aes_cbc_256_new(allocator, NULL, NULL);
+    ASSERT_NOT_NULL(cbc_cipher);
+    ASSERT_ERROR(
+        AWS_ERROR_UNSUPPORTED_OPERATION,
+        aws_symmetric_cipher_reset_with_tweak(cbc_cipher, aws_byte_cursor_from_array(tweak, sizeof(tweak))));
+    aws_symmetric_cipher_destroy(cbc_cipher);
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_xts_256_reset_with_tweak, s_aes_xts_256_reset_with_tweak_fn)
+
+static int s_aes_xts_256_validate_materials_fails_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_XTS_KEY_BYTE_LEN] = {0};
+    uint8_t tweak[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0};
+    struct aws_byte_cursor tweak_cur = aws_byte_cursor_from_array(tweak, sizeof(tweak));
+
+    struct aws_byte_cursor short_key = aws_byte_cursor_from_array(key, AWS_AES_256_KEY_BYTE_LEN);
+    ASSERT_NULL(aws_aes_xts_256_new(allocator, &short_key, &tweak_cur));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_KEY_LENGTH_FOR_ALGORITHM, aws_last_error());
+
+    /* both halves the same */
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    ASSERT_NULL(aws_aes_xts_256_new(allocator, &key_cur, &tweak_cur));
+    ASSERT_UINT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    key[AWS_AES_256_XTS_KEY_BYTE_LEN - 1] = 1;
+    struct aws_byte_cursor short_tweak = aws_byte_cursor_from_array(tweak, AWS_AES_256_GCM_NONCE_LEN);
+    ASSERT_NULL(aws_aes_xts_256_new(allocator, &key_cur, &short_tweak));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM, aws_last_error());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_xts_256_validate_materials_fails, s_aes_xts_256_validate_materials_fails_fn)
+
+static int s_aes_gcm_siv_256_unsupported(struct aws_symmetric_cipher *cipher) {
+    /* platforms without GCM-SIV have to say so rather than hand back something else. */
+    ASSERT_NULL(cipher);
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM, aws_last_error());
+    return AWS_OP_SUCCESS;
+}
+
+static int s_check_gcm_siv_vector(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor key,
+    struct aws_byte_cursor iv,
+    struct aws_byte_cursor aad,
+    struct aws_byte_cursor data,
+    struct aws_byte_cursor expected_ciphertext,
+    struct aws_byte_cursor expected_tag) {
+
+    struct aws_symmetric_cipher *cipher = aws_aes_gcm_siv_256_new(allocator, &key, &iv, &aad, NULL);
+    if (cipher == NULL) {
+        return s_aes_gcm_siv_256_unsupported(cipher);
+    }
+
+    struct aws_byte_buf encrypted_buf;
+    aws_byte_buf_init(&encrypted_buf, allocator, data.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, data, &encrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        expected_ciphertext.ptr, expected_ciphertext.len, encrypted_buf.buffer, encrypted_buf.len);
+
+    struct aws_byte_cursor tag = aws_symmetric_cipher_get_tag(cipher);
+    ASSERT_BIN_ARRAYS_EQUALS(expected_tag.ptr, expected_tag.len, tag.ptr, tag.len);
+    aws_symmetric_cipher_destroy(cipher);
+
+    cipher = aws_aes_gcm_siv_256_new(allocator, &key, &iv, &aad, &expected_tag);
+    ASSERT_NOT_NULL(cipher);
+    struct aws_byte_buf decrypted_buf;
+    aws_byte_buf_init(&decrypted_buf, allocator, data.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(cipher, expected_ciphertext, &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(data.ptr, data.len, decrypted_buf.buffer, decrypted_buf.len);
+
+    aws_byte_buf_clean_up(&decrypted_buf);
+    aws_byte_buf_clean_up(&encrypted_buf);
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+
+/* RFC 8452 appendix C.2, AEAD_AES_256_GCM_SIV. */
+static int s_aes_gcm_siv_256_rfc8452_vectors_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x01};
+    uint8_t iv[AWS_AES_256_GCM_NONCE_LEN] = {0x03};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+
+    uint8_t empty_tag[] = {
+        0x07, 0xf5, 0xf4, 0x16, 0x9b, 0xbf, 0x55, 0xa8, 0x40, 0x0c, 0xd4, 0x7e, 0xa6, 0xfd, 0x40, 0x0f};
+    ASSERT_SUCCESS(s_check_gcm_siv_vector(
+        allocator,
+        key_cur,
+        iv_cur,
+        aws_byte_cursor_from_array(NULL, 0),
+        aws_byte_cursor_from_array(NULL, 0),
+        aws_byte_cursor_from_array(NULL, 0),
+        aws_byte_cursor_from_array(empty_tag, sizeof(empty_tag))));
+
+    uint8_t short_data[] = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t short_ciphertext[] = {0xc2, 0xef, 0x32, 0x8e, 0x5c, 0x71, 0xc8, 0x3b};
+    uint8_t short_tag[] = {
+        0x84, 0x31, 0x22, 0x13, 0x0f, 0x73, 0x64, 0xb7, 0x61, 0xe0, 0xb9, 0x74, 0x27, 0xe3, 0xdf, 0x28};
+    ASSERT_SUCCESS(s_check_gcm_siv_vector(
+        allocator,
+        key_cur,
+        iv_cur,
+        aws_byte_cursor_from_array(NULL, 0),
+        aws_byte_cursor_from_array(short_data, sizeof(short_data)),
+        aws_byte_cursor_from_array(short_ciphertext, sizeof(short_ciphertext)),
+        aws_byte_cursor_from_array(short_tag, sizeof(short_tag))));
+
+    uint8_t aad[] = {0x01};
+    uint8_t data[64] = {[0] = 0x02, [16] = 0x03, [32] = 0x04, [48] = 0x05};
+    uint8_t ciphertext[] = {
+        0x67, 0xfd, 0x45, 0xe1, 0x26, 0xbf, 0xb9, 0xa7, 0x99, 0x30, 0xc4, 0x3a, 0xad, 0x2d, 0x36, 0x96,
+        0x7d, 0x3f, 0x0e, 0x4d, 0x21, 0x7c, 0x1e, 0x55, 0x1f, 0x59, 0x72, 0x78, 0x70, 0xbe, 0xef, 0xc9,
+        0x8c, 0xb9, 0x33, 0xa8, 0xfc, 0xe9, 0xde, 0x88, 0x7b, 0x1e, 0x40, 0x79, 0x99, 0x88, 0xdb, 0x1f,
+        0xc3, 0xf9, 0x18, 0x80, 0xed, 0x40, 0x5b, 0x2d, 0xd2, 0x98, 0x31, 0x88, 0x58, 0x46, 0x7c, 0x89};
+    uint8_t tag[] = {0x5b, 0xde, 0x02, 0x85, 0x03, 0x7c, 0x5d, 0xe8, 0x1e, 0x5b, 0x57, 0x0a, 0x04, 0x9b, 0x62, 0xa0};
+    ASSERT_SUCCESS(s_check_gcm_siv_vector(
+        allocator,
+        key_cur,
+        iv_cur,
+        aws_byte_cursor_from_array(aad, sizeof(aad)),
+        aws_byte_cursor_from_array(data, sizeof(data)),
+        aws_byte_cursor_from_array(ciphertext, sizeof(ciphertext)),
+        aws_byte_cursor_from_array(tag, sizeof(tag))));
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_siv_256_rfc8452_vectors, s_aes_gcm_siv_256_rfc8452_vectors_fn)
+
+static int s_aes_gcm_siv_256_tamper_fails_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t aad[] = {0xa0, 0xa1, 0xa2};
+    struct aws_byte_cursor aad_cur = aws_byte_cursor_from_array(aad, sizeof(aad));
+    struct aws_symmetric_cipher *cipher = aws_aes_gcm_siv_256_new(allocator, NULL, NULL, &aad_cur, NULL);
+    if (cipher == NULL) {
+        return s_aes_gcm_siv_256_unsupported(cipher);
+    }
+
+    uint8_t data[50];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i + 1);
+    }
+
+    uint8_t encrypted[sizeof(data)];
+    struct aws_byte_buf encrypted_buf = aws_byte_buf_from_empty_array(encrypted, sizeof(encrypted));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(data, 20), &encrypted_buf));
+    ASSERT_SUCCESS(
+        aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(data + 20, sizeof(data) - 20), &encrypted_buf));
+    ASSERT_UINT_EQUALS(0, encrypted_buf.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+    ASSERT_UINT_EQUALS(sizeof(data), encrypted_buf.len);
+
+    struct aws_byte_cursor key = aws_symmetric_cipher_get_key(cipher);
+    struct aws_byte_cursor iv = aws_symmetric_cipher_get_initialization_vector(cipher);
+    uint8_t tag[AWS_AES_256_GCM_TAG_LEN];
+    memcpy(tag, aws_symmetric_cipher_get_tag(cipher).ptr, sizeof(tag));
+    struct aws_byte_cursor tag_cur = aws_byte_cursor_from_array(tag, sizeof(tag));
+
+    /* a flipped bit anywhere fails the whole message, and none of it is written */
+    encrypted[sizeof(encrypted) - 1] ^= 0x80;
+    struct aws_symmetric_cipher *decryptor = aws_aes_gcm_siv_256_new(allocator, &key, &iv, &aad_cur, &tag_cur);
+    ASSERT_NOT_NULL(decryptor);
+    uint8_t decrypted[sizeof(data)];
+    struct aws_byte_buf decrypted_buf = aws_byte_buf_from_empty_array(decrypted, sizeof(decrypted));
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(decryptor, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED, aws_symmetric_cipher_finalize_decryption(decryptor, &decrypted_buf));
+    ASSERT_UINT_EQUALS(0, decrypted_buf.len);
+    aws_symmetric_cipher_destroy(decryptor);
+
+    /* as does decrypting without a tag */
+    encrypted[sizeof(encrypted) - 1] ^= 0x80;
+    decryptor = aws_aes_gcm_siv_256_new(allocator, &key, &iv, &aad_cur, NULL);
+    ASSERT_NOT_NULL(decryptor);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(decryptor, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED, aws_symmetric_cipher_finalize_decryption(decryptor, &decrypted_buf));
+    aws_symmetric_cipher_destroy(decryptor);
+
+    decryptor = aws_aes_gcm_siv_256_new(allocator, &key, &iv, &aad_cur, &tag_cur);
+    ASSERT_NOT_NULL(decryptor);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(decryptor, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(decryptor, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), decrypted_buf.buffer, decrypted_buf.len);
+    aws_symmetric_cipher_destroy(decryptor);
+
+    aws_symmetric_cipher_destroy(cipher);
+
+    /* materials are checked before the platform is asked */
+    uint8_t short_tag[AWS_AES_256_GCM_TAG_LEN - 4] = {0};
+    struct aws_byte_cursor short_tag_cur = aws_byte_cursor_from_array(short_tag, sizeof(short_tag));
+    ASSERT_NULL(aws_aes_gcm_siv_256_new(allocator, NULL, NULL, NULL, &short_tag_cur));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM, aws_last_error());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_gcm_siv_256_tamper_fails, s_aes_gcm_siv_256_tamper_fails_fn)
+
+static int s_chacha20_poly1305_unsupported(struct aws_symmetric_cipher *cipher) {
+    ASSERT_NULL(cipher);
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_UNSUPPORTED_ALGORITHM, aws_last_error());
+    return AWS_OP_SUCCESS;
+}
+
+/* RFC 8439 section 2.8.2, fed through the cipher in uneven pieces. */
+static int s_chacha20_poly1305_rfc8439_vector_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_CHACHA20_POLY1305_KEY_BYTE_LEN];
+    for (size_t i = 0; i < sizeof(key); ++i) {
+        key[i] = (uint8_t)(0x80 + i);
+    }
+    uint8_t iv[AWS_CHACHA20_POLY1305_NONCE_LEN] = {
+        0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    uint8_t aad[] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    struct aws_byte_cursor data = aws_byte_cursor_from_c_str(
+        "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would "
+        "be it.");
+    uint8_t expected_ciphertext[] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16};
+    uint8_t expected_tag[AWS_CHACHA20_POLY1305_TAG_LEN] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91};
+
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+    struct aws_byte_cursor aad_cur = aws_byte_cursor_from_array(aad, sizeof(aad));
+    struct aws_symmetric_cipher *cipher = aws_chacha20_poly1305_new(allocator, &key_cur, &iv_cur, &aad_cur, NULL);
+    if (cipher == NULL) {
+        return s_chacha20_poly1305_unsupported(cipher);
+    }
+
+    struct aws_byte_buf encrypted_buf;
+    aws_byte_buf_init(&encrypted_buf, allocator, data.len);
+    struct aws_byte_cursor remaining = data;
+    size_t piece_len = 1;
+    while (remaining.len) {
+        struct aws_byte_cursor piece = aws_byte_cursor_advance(&remaining, aws_min_size(piece_len, remaining.len));
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, piece, &encrypted_buf));
+        piece_len += 13;
+    }
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_ciphertext, sizeof(expected_ciphertext), encrypted_buf.buffer, encrypted_buf.len);
+
+    struct aws_byte_cursor tag = aws_symmetric_cipher_get_tag(cipher);
+    ASSERT_BIN_ARRAYS_EQUALS(expected_tag, sizeof(expected_tag), tag.ptr, tag.len);
+    aws_symmetric_cipher_destroy(cipher);
+
+    struct aws_byte_cursor tag_cur = aws_byte_cursor_from_array(expected_tag, sizeof(expected_tag));
+    cipher = aws_chacha20_poly1305_new(allocator, &key_cur, &iv_cur, &aad_cur, &tag_cur);
+    ASSERT_NOT_NULL(cipher);
+    struct aws_byte_buf decrypted_buf;
+    aws_byte_buf_init(&decrypted_buf, allocator, data.len);
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(
+        cipher, aws_byte_cursor_from_array(expected_ciphertext, sizeof(expected_ciphertext)), &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(data.ptr, data.len, decrypted_buf.buffer, decrypted_buf.len);
+
+    aws_byte_buf_clean_up(&decrypted_buf);
+    aws_byte_buf_clean_up(&encrypted_buf);
+    aws_symmetric_cipher_destroy(cipher);
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(chacha20_poly1305_rfc8439_vector, s_chacha20_poly1305_rfc8439_vector_fn)
+
+static int s_chacha20_poly1305_tamper_fails_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t aad[] = {0xa0, 0xa1, 0xa2};
+    struct aws_byte_cursor aad_cur = aws_byte_cursor_from_array(aad, sizeof(aad));
+    struct aws_symmetric_cipher *cipher = aws_chacha20_poly1305_new(allocator, NULL, NULL, &aad_cur, NULL);
+    if (cipher == NULL) {
+        return s_chacha20_poly1305_unsupported(cipher);
+    }
+
+    uint8_t data[70];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i + 1);
+    }
+
+    uint8_t encrypted[sizeof(data)];
+    struct aws_byte_buf encrypted_buf = aws_byte_buf_from_empty_array(encrypted, sizeof(encrypted));
+    ASSERT_SUCCESS(
+        aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_array(data, sizeof(data)), &encrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted_buf));
+    ASSERT_UINT_EQUALS(sizeof(data), encrypted_buf.len);
+
+    struct aws_byte_cursor key = aws_symmetric_cipher_get_key(cipher);
+    struct aws_byte_cursor iv = aws_symmetric_cipher_get_initialization_vector(cipher);
+    ASSERT_UINT_EQUALS(AWS_CHACHA20_POLY1305_KEY_BYTE_LEN, key.len);
+    ASSERT_UINT_EQUALS(AWS_CHACHA20_POLY1305_NONCE_LEN, iv.len);
+    uint8_t tag[AWS_CHACHA20_POLY1305_TAG_LEN];
+    memcpy(tag, aws_symmetric_cipher_get_tag(cipher).ptr, sizeof(tag));
+    struct aws_byte_cursor tag_cur = aws_byte_cursor_from_array(tag, sizeof(tag));
+
+    encrypted[0] ^= 0x01;
+    struct aws_symmetric_cipher *decryptor = aws_chacha20_poly1305_new(allocator, &key, &iv, &aad_cur, &tag_cur);
+    ASSERT_NOT_NULL(decryptor);
+    uint8_t decrypted[sizeof(data)];
+    struct aws_byte_buf decrypted_buf = aws_byte_buf_from_empty_array(decrypted, sizeof(decrypted));
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(decryptor, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+    ASSERT_FAILS(aws_symmetric_cipher_finalize_decryption(decryptor, &decrypted_buf));
+    ASSERT_FALSE(aws_symmetric_cipher_is_good(decryptor));
+    aws_symmetric_cipher_destroy(decryptor);
+
+    encrypted[0] ^= 0x01;
+    decryptor = aws_chacha20_poly1305_new(allocator, &key, &iv, &aad_cur, &tag_cur);
+    ASSERT_NOT_NULL(decryptor);
+    decrypted_buf.len = 0;
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt(decryptor, aws_byte_cursor_from_buf(&encrypted_buf), &decrypted_buf));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(decryptor, &decrypted_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(data), decrypted_buf.buffer, decrypted_buf.len);
+    aws_symmetric_cipher_destroy(decryptor);
+
+    aws_symmetric_cipher_destroy(cipher);
+
+    /* materials are checked before the platform is asked */
+    uint8_t short_tag[AWS_CHACHA20_POLY1305_TAG_LEN - 4] = {0};
+    struct aws_byte_cursor short_tag_cur = aws_byte_cursor_from_array(short_tag, sizeof(short_tag));
+    ASSERT_NULL(aws_chacha20_poly1305_new(allocator, NULL, NULL, NULL, &short_tag_cur));
+    ASSERT_UINT_EQUALS(AWS_ERROR_CAL_INVALID_CIPHER_MATERIAL_SIZE_FOR_ALGORITHM, aws_last_error());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(chacha20_poly1305_tamper_fails, s_chacha20_poly1305_tamper_fails_fn)
+
+#define KEYWRAP_BATCH_TEST_KEYS 43
+
+static size_t s_keywrap_batch_test_key_len(size_t i) {
+    /* a run longer than one batch of lanes, then short runs of mixed lengths */
+    if (i < 37) {
+        return 32;
+    }
+    return (i % 2) ? 16 : 24 + 8 * (i % 3);
+}
+
+static int s_aes_keywrap_batch_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t kek[AWS_AES_256_KEY_BYTE_LEN];
+    for (size_t i = 0; i < sizeof(kek); ++i) {
+        kek[i] = (uint8_t)i;
+    }
+    struct aws_byte_cursor kek_cur = aws_byte_cursor_from_array(kek, sizeof(kek));
+    struct aws_aes_256_prepared_key *prepared_key = aws_aes_256_prepared_key_new(allocator, &kek_cur);
+    ASSERT_NOT_NULL(prepared_key);
+
+    /* key 0 is the RFC 3394 vector from aes_keywrap_RFC3394_256BitKey256CekTestVector */
+    uint8_t cek[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+                     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    uint8_t expected_wrapped[] = {0x28, 0xC9, 0xF4, 0x04, 0xC4, 0xB8, 0x10, 0xF4, 0xCB, 0xCC, 0xB3, 0x5C, 0xFB, 0x87,
+                                  0xF8, 0x26, 0x3F, 0x57, 0x86, 0xE2, 0xD8, 0x0E, 0xD3, 0x26, 0xCB, 0xC7, 0xF0, 0xE7,
+                                  0x1A, 0x99, 0xF4, 0x3B, 0xFB, 0x98, 0x8B, 0x9B, 0x7A, 0x02, 0xDD, 0x21};
+
+    uint8_t key_material[KEYWRAP_BATCH_TEST_KEYS][40];
+    struct aws_byte_cursor keys[KEYWRAP_BATCH_TEST_KEYS];
+    struct aws_byte_buf wrapped[KEYWRAP_BATCH_TEST_KEYS];
+    struct aws_byte_cursor wrapped_keys[KEYWRAP_BATCH_TEST_KEYS];
+    struct aws_byte_buf unwrapped[KEYWRAP_BATCH_TEST_KEYS];
+    for (size_t i = 0; i < KEYWRAP_BATCH_TEST_KEYS; ++i) {
+        for (size_t j = 0; j < sizeof(key_material[i]); ++j) {
+            key_material[i][j] = (uint8_t)(i * 7 + j);
+        }
+        keys[i] = aws_byte_cursor_from_array(key_material[i], s_keywrap_batch_test_key_len(i));
+        ASSERT_SUCCESS(aws_byte_buf_init(&wrapped[i], allocator, 1));
+        ASSERT_SUCCESS(aws_byte_buf_init(&unwrapped[i], allocator, 1));
+    }
+    keys[0] = aws_byte_cursor_from_array(cek, sizeof(cek));
+
+    ASSERT_SUCCESS(aws_aes_256_wrap_keys(allocator, prepared_key, keys, wrapped, KEYWRAP_BATCH_TEST_KEYS));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_wrapped, sizeof(expected_wrapped), wrapped[0].buffer, wrapped[0].len);
+
+    /* every key matches wrapping it on its own */
+    struct aws_symmetric_cipher *cipher = aws_aes_keywrap_256_new(allocator, &kek_cur);
+    ASSERT_NOT_NULL(cipher);
+    for (size_t i = 0; i < KEYWRAP_BATCH_TEST_KEYS; ++i) {
+        uint8_t single[48];
+        struct aws_byte_buf single_buf = aws_byte_buf_from_empty_array(single, sizeof(single));
+        ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+        ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, keys[i], &single_buf));
+        ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &single_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(single_buf.buffer, single_buf.len, wrapped[i].buffer, wrapped[i].len);
+        wrapped_keys[i] = aws_byte_cursor_from_buf(&wrapped[i]);
+    }
+    aws_symmetric_cipher_destroy(cipher);
+
+    ASSERT_SUCCESS(aws_aes_256_unwrap_keys(allocator, prepared_key, wrapped_keys, unwrapped, KEYWRAP_BATCH_TEST_KEYS));
+    for (size_t i = 0; i < KEYWRAP_BATCH_TEST_KEYS; ++i) {
+        ASSERT_BIN_ARRAYS_EQUALS(keys[i].ptr, keys[i].len, unwrapped[i].buffer, unwrapped[i].len);
+    }
+
+    /* one bad key fails the whole batch, and no unverified key material is left behind */
+    wrapped[40].buffer[3] ^= 0x01;
+    uint8_t fixed[KEYWRAP_BATCH_TEST_KEYS][40];
+    struct aws_byte_buf fixed_bufs[KEYWRAP_BATCH_TEST_KEYS];
+    for (size_t i = 0; i < KEYWRAP_BATCH_TEST_KEYS; ++i) {
+        fixed_bufs[i] = aws_byte_buf_from_empty_array(fixed[i], sizeof(fixed[i]));
+    }
+    ASSERT_ERROR(
+        AWS_ERROR_CAL_SIGNATURE_VALIDATION_FAILED,
+        aws_aes_256_unwrap_keys(allocator, prepared_key, wrapped_keys, fixed_bufs, KEYWRAP_BATCH_TEST_KEYS));
+    for (size_t i = 0; i < KEYWRAP_BATCH_TEST_KEYS; ++i) {
+        ASSERT_UINT_EQUALS(0, fixed_bufs[i].len);
+        for (size_t j = 0; j < wrapped_keys[i].len - 8; ++j) {
+            ASSERT_UINT_EQUALS(0, fixed[i][j]);
+        }
+    }
+
+    /* fixed spans aren't grown, and lengths are checked before anything is wrapped */
+    struct aws_byte_buf short_buf = aws_byte_buf_from_empty_array(fixed[0], sizeof(cek));
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_aes_256_wrap_keys(allocator, prepared_key, keys, &short_buf, 1));
+    struct aws_byte_cursor odd_key = aws_byte_cursor_from_array(cek, 20);
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_aes_256_wrap_keys(allocator, prepared_key, &odd_key, wrapped, 1));
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_aes_256_unwrap_keys(allocator, prepared_key, keys + 37, wrapped, 1));
+    ASSERT_SUCCESS(aws_aes_256_wrap_keys(allocator, prepared_key, NULL, NULL, 0));
+
+    for (size_t i = 0; i < KEYWRAP_BATCH_TEST_KEYS; ++i) {
+        aws_byte_buf_clean_up(&wrapped[i]);
+        aws_byte_buf_clean_up(&unwrapped[i]);
+    }
+    aws_aes_256_prepared_key_release(prepared_key);
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_keywrap_batch, s_aes_keywrap_batch_fn)
+
+static int s_write_test_file(const char *path, struct aws_byte_cursor contents) {
+    FILE *file = aws_fopen(path, "wb");
+    ASSERT_NOT_NULL(file);
+    ASSERT_UINT_EQUALS(contents.len, fwrite(contents.ptr, 1, contents.len, file));
+    fclose(file);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aes_ctr_crypt_file_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x11, 0x22, 0x33};
+    uint8_t iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0xA0, 0xA1, 0xA2};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+    const char *path = "aes_ctr_crypt_file.tmp";
+
+    struct aws_byte_buf plaintext;
+    ASSERT_SUCCESS(aws_byte_buf_init(&plaintext, allocator, 70001));
+    s_fill_parallel_test_input(plaintext.buffer, plaintext.capacity);
+    plaintext.len = plaintext.capacity;
+    ASSERT_SUCCESS(s_write_test_file(path, aws_byte_cursor_from_buf(&plaintext)));
+
+    struct aws_symmetric_cipher *cipher = aws_aes_ctr_256_new(allocator, &key_cur, &iv_cur);
+    ASSERT_NOT_NULL(cipher);
+
+    struct aws_byte_buf expected;
+    ASSERT_SUCCESS(aws_byte_buf_init(&expected, allocator, plaintext.len));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt(cipher, aws_byte_cursor_from_buf(&plaintext), &expected));
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+
+    /* out starts empty and is grown as the file goes through */
+    struct aws_byte_buf encrypted;
+    ASSERT_SUCCESS(aws_byte_buf_init(&encrypted, allocator, 0));
+    ASSERT_SUCCESS(aws_symmetric_cipher_encrypt_file(cipher, path, &encrypted));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_encryption(cipher, &encrypted));
+    ASSERT_BIN_ARRAYS_EQUALS(expected.buffer, expected.len, encrypted.buffer, encrypted.len);
+
+    ASSERT_SUCCESS(s_write_test_file(path, aws_byte_cursor_from_buf(&encrypted)));
+    ASSERT_SUCCESS(aws_symmetric_cipher_reset(cipher));
+    struct aws_byte_buf decrypted;
+    ASSERT_SUCCESS(aws_byte_buf_init(&decrypted, allocator, 0));
+    ASSERT_SUCCESS(aws_symmetric_cipher_decrypt_file(cipher, path, &decrypted));
+    ASSERT_SUCCESS(aws_symmetric_cipher_finalize_decryption(cipher, &decrypted));
+    ASSERT_BIN_ARRAYS_EQUALS(plaintext.buffer, plaintext.len, decrypted.buffer, decrypted.len);
+
+    ASSERT_SUCCESS(remove(path));
+    ASSERT_FAILS(aws_symmetric_cipher_encrypt_file(cipher, path, &encrypted));
+
+    aws_byte_buf_clean_up(&decrypted);
+    aws_byte_buf_clean_up(&encrypted);
+    aws_byte_buf_clean_up(&expected);
+    aws_byte_buf_clean_up(&plaintext);
+    aws_symmetric_cipher_destroy(cipher);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_ctr_crypt_file, s_aes_ctr_crypt_file_fn)
+
+static int s_aes_secure_allocator_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* charged to the test's allocator, so anything leaked here fails the test */
+    struct aws_allocator *secure = aws_cal_secure_allocator_for(allocator);
+    ASSERT_PTR_EQUALS(secure, aws_cal_secure_allocator_for(allocator));
+    ASSERT_PTR_EQUALS(aws_cal_secure_allocator(), aws_cal_secure_allocator_for(aws_default_allocator()));
+
+    /* every size class, the largest, and past it */
+    size_t sizes[] = {1, 12, 16, 32, 64, 200, 256, 257, 4096};
+    uint8_t *blocks[AWS_ARRAY_SIZE(sizes)];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sizes); ++i) {
+        blocks[i] = aws_mem_calloc(secure, 1, sizes[i]);
+        ASSERT_NOT_NULL(blocks[i]);
+        for (size_t j = 0; j < sizes[i]; ++j) {
+            ASSERT_UINT_EQUALS(0, blocks[i][j]);
+        }
+        memset(blocks[i], (int)i + 1, sizes[i]);
+    }
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sizes); ++i) {
+        for (size_t j = 0; j < sizes[i]; ++j) {
+            ASSERT_UINT_EQUALS(i + 1, blocks[i][j]);
+        }
+        aws_mem_release(secure, blocks[i]);
+    }
+
+    /* enough to need more than one chunk, and what's handed back out again is zeroed */
+    enum { KEY_COUNT = 4000 };
+    uint8_t **keys = aws_mem_calloc(allocator, KEY_COUNT, sizeof(uint8_t *));
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        keys[i] = aws_mem_acquire(secure, AWS_AES_256_KEY_BYTE_LEN);
+        ASSERT_NOT_NULL(keys[i]);
+        memset(keys[i], (int)(i & 0xFF), AWS_AES_256_KEY_BYTE_LEN);
+    }
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        ASSERT_UINT_EQUALS(i & 0xFF, keys[i][AWS_AES_256_KEY_BYTE_LEN - 1]);
+        aws_mem_release(secure, keys[i]);
+    }
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        keys[i] = aws_mem_calloc(secure, 1, AWS_AES_256_KEY_BYTE_LEN);
+        ASSERT_NOT_NULL(keys[i]);
+        for (size_t j = 0; j < AWS_AES_256_KEY_BYTE_LEN; ++j) {
+            ASSERT_UINT_EQUALS(0, keys[i][j]);
+        }
+    }
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        aws_mem_release(secure, keys[i]);
+    }
+    aws_mem_release(allocator, keys);
+
+    /* growing keeps the contents, within a class, into a bigger one and out of the classes altogether */
+    void *grown = aws_mem_acquire(secure, 10);
+    memset(grown, 0x5A, 10);
+    size_t new_sizes[] = {16, 100, 1000};
+    size_t old_size = 10;
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(new_sizes); ++i) {
+        ASSERT_SUCCESS(aws_mem_realloc(secure, &grown, old_size, new_sizes[i]));
+        for (size_t j = 0; j < 10; ++j) {
+            ASSERT_UINT_EQUALS(0x5A, ((uint8_t *)grown)[j]);
+        }
+        old_size = new_sizes[i];
+    }
+    aws_mem_release(secure, grown);
+
+    /* cipher keys and IVs live here, and still come back out right */
+    uint8_t key[AWS_AES_256_KEY_BYTE_LEN] = {0x42};
+    uint8_t iv[AWS_AES_256_CIPHER_BLOCK_SIZE] = {0x24};
+    struct aws_byte_cursor key_cur = aws_byte_cursor_from_array(key, sizeof(key));
+    struct aws_byte_cursor iv_cur = aws_byte_cursor_from_array(iv, sizeof(iv));
+    struct aws_symmetric_cipher *cipher = aws_aes_cbc_256_new(allocator, &key_cur, &iv_cur);
+    ASSERT_NOT_NULL(cipher);
+    struct aws_byte_cursor cipher_key = aws_symmetric_cipher_get_key(cipher);
+    struct aws_byte_cursor cipher_iv = aws_symmetric_cipher_get_initialization_vector(cipher);
+    ASSERT_BIN_ARRAYS_EQUALS(key, sizeof(key), cipher_key.ptr, cipher_key.len);
+    ASSERT_BIN_ARRAYS_EQUALS(iv, sizeof(iv), cipher_iv.ptr, cipher_iv.len);
+    aws_symmetric_cipher_destroy(cipher);
+
+    /*
+     * a pool for any other parent keeps one empty chunk per class while anything is allocated from it, so keys
+     * coming and going don't cost a chunk each, and hands everything back once nothing is
+     */
+    struct aws_allocator *parent = aws_mem_tracer_new(allocator, NULL, AWS_MEMTRACE_BYTES, 0);
+    struct aws_allocator *parent_secure = aws_cal_secure_allocator_for(parent);
+    void *held = aws_mem_acquire(parent_secure, AWS_AES_256_KEY_BYTE_LEN);
+    ASSERT_NOT_NULL(held);
+    size_t held_bytes = aws_mem_tracer_bytes(parent);
+
+    void *churned = aws_mem_acquire(parent_secure, AWS_AES_256_CIPHER_BLOCK_SIZE);
+    ASSERT_NOT_NULL(churned);
+    size_t churned_bytes = aws_mem_tracer_bytes(parent);
+    ASSERT_TRUE(churned_bytes > held_bytes);
+    for (size_t i = 0; i < 10; ++i) {
+        aws_mem_release(parent_secure, churned);
+        ASSERT_UINT_EQUALS(churned_bytes, aws_mem_tracer_bytes(parent));
+        churned = aws_mem_acquire(parent_secure, AWS_AES_256_CIPHER_BLOCK_SIZE);
+        ASSERT_NOT_NULL(churned);
+        ASSERT_UINT_EQUALS(churned_bytes, aws_mem_tracer_bytes(parent));
+    }
+
+    /* a second empty chunk in the class isn't kept */
+    aws_mem_release(parent_secure, churned);
+    enum { CHUNK_FILL = 2000 };
+    void **filled = aws_mem_calloc(allocator, CHUNK_FILL, sizeof(void *));
+    for (size_t i = 0; i < CHUNK_FILL; ++i) {
+        filled[i] = aws_mem_acquire(parent_secure, AWS_AES_256_CIPHER_BLOCK_SIZE);
+        ASSERT_NOT_NULL(filled[i]);
+    }
+    ASSERT_TRUE(aws_mem_tracer_bytes(parent) > churned_bytes);
+    for (size_t i = 0; i < CHUNK_FILL; ++i) {
+        aws_mem_release(parent_secure, filled[i]);
+    }
+    aws_mem_release(allocator, filled);
+    ASSERT_UINT_EQUALS(churned_bytes, aws_mem_tracer_bytes(parent));
+
+    aws_mem_release(parent_secure, held);
+    ASSERT_UINT_EQUALS(0, aws_mem_tracer_bytes(parent));
+    aws_mem_tracer_destroy(parent);
+
+    /* clean up frees the pool, but not while something is still allocated from it */
+    aws_cal_library_init(allocator);
+    void *outstanding = aws_mem_acquire(secure, AWS_AES_256_KEY_BYTE_LEN);
+    ASSERT_NOT_NULL(outstanding);
+    aws_cal_library_clean_up();
+    aws_mem_release(secure, outstanding);
+
+    aws_cal_library_init(allocator);
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_secure_allocator, s_aes_secure_allocator_fn)
+
+static int s_aes_runtime_info_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_cal_runtime_info info;
+    aws_cal_get_runtime_info(allocator, &info);
+
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(BYO_CRYPTO)
+    ASSERT_NOT_NULL(info.libcrypto_version);
+    ASSERT_NOT_NULL(info.libcrypto_version_string);
+#endif
+    ASSERT_TRUE(info.libcrypto_allocations_routed == aws_cal_libcrypto_allocations_routed());
+
+    /* has_hardware_aes() is answered from the same detection */
+    const struct aws_cal_cpu_features *features = &info.cpu_features;
+    ASSERT_TRUE(
+        aws_symmetric_cipher_has_hardware_aes() == ((features->aes_ni && features->pclmulqdq) || features->armv8_aes));
+
+    /* and the providers are the ones instances get */
+    ASSERT_TRUE(info.algorithm_count > 0);
+    bool found_gcm = false;
+    for (size_t i = 0; i < info.algorithm_count; ++i) {
+        ASSERT_NOT_NULL(info.algorithms[i].alg_name);
+        if (strcmp(info.algorithms[i].alg_name, "AES-GCM 256") == 0) {
+            struct aws_symmetric_cipher *cipher = aws_aes_gcm_256_new(allocator, NULL, NULL, NULL, NULL);
+            ASSERT_NOT_NULL(cipher);
+            ASSERT_NOT_NULL(info.algorithms[i].provider);
+            ASSERT_STR_EQUALS(cipher->vtable->provider, info.algorithms[i].provider);
+            ASSERT_STR_EQUALS(cipher->vtable->alg_name, info.algorithms[i].alg_name);
+            aws_symmetric_cipher_destroy(cipher);
+            found_gcm = true;
+        }
+    }
+    ASSERT_TRUE(found_gcm);
+
+    aws_cal_log_runtime_info(allocator);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(aes_runtime_info, s_aes_runtime_info_fn)
@@ -0,0 +1,272 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/hash.h>
+#include <aws/common/byte_buf.h>
+#include <aws/testing/aws_test_harness.h>
+
+#include <test_case_helper.h>
+
+/*
+ * Expected values come from the official BLAKE3 test vectors:
+ * https://github.com/BLAKE3-team/BLAKE3/blob/master/test_vectors/test_vectors.json
+ * whose inputs are the repeating byte sequence 0, 1, ..., 250, 0, 1, ...
+ */
+
+static void s_fill_test_vector_input(struct aws_byte_buf *buf) {
+    for (size_t i = 0; i < buf->capacity; ++i) {
+        buf->buffer[i] = (uint8_t)(i % 251);
+    }
+    buf->len = buf->capacity;
+}
+
+static int s_blake3_test_case_empty_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("");
+    uint8_t expected[] = {
+        0xaf, 0x13, 0x49, 0xb9, 0xf5, 0xf9, 0xa1, 0xa6, 0xa0, 0x40, 0x4d, 0xea, 0x36, 0xdc, 0xc9, 0x49,
+        0x9b, 0xcb, 0x25, 0xc9, 0xad, 0xc1, 0x12, 0xb7, 0xcc, 0x9a, 0x93, 0xca, 0xe4, 0x1f, 0x32, 0x62,
+    };
+    struct aws_byte_cursor expected_buf = aws_byte_cursor_from_array(expected, sizeof(expected));
+
+    return s_verify_hash_test_case(allocator, &input, &expected_buf, aws_blake3_new);
+}
+
+AWS_TEST_CASE(blake3_test_case_empty, s_blake3_test_case_empty_fn)
+
+static int s_blake3_test_case_abc_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    uint8_t expected[] = {
+        0x64, 0x37, 0xb3, 0xac, 0x38, 0x46, 0x51, 0x33, 0xff, 0xb6, 0x3b, 0x75, 0x27, 0x3a, 0x8d, 0xb5,
+        0x48, 0xc5, 0x58, 0x46, 0x5d, 0x79, 0xdb, 0x03, 0xfd, 0x35, 0x9c, 0x6c, 0xd5, 0xbd, 0x9d, 0x85,
+    };
+    struct aws_byte_cursor expected_buf = aws_byte_cursor_from_array(expected, sizeof(expected));
+
+    return s_verify_hash_test_case(allocator, &input, &expected_buf, aws_blake3_new);
+}
+
+AWS_TEST_CASE(blake3_test_case_abc, s_blake3_test_case_abc_fn)
+
+static int s_blake3_test_vector_1_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, 1));
+    s_fill_test_vector_input(&input_buf);
+    struct aws_byte_cursor input = aws_byte_cursor_from_buf(&input_buf);
+
+    uint8_t expected[] = {
+        0x2d, 0x3a, 0xde, 0xdf, 0xf1, 0x1b, 0x61, 0xf1, 0x4c, 0x88, 0x6e, 0x35, 0xaf, 0xa0, 0x36, 0x73,
+        0x6d, 0xcd, 0x87, 0xa7, 0x4d, 0x27, 0xb5, 0xc1, 0x51, 0x02, 0x25, 0xd0, 0xf5, 0x92, 0xe2, 0x13,
+    };
+    struct aws_byte_cursor expected_buf = aws_byte_cursor_from_array(expected, sizeof(expected));
+
+    int result = s_verify_hash_test_case(allocator, &input, &expected_buf, aws_blake3_new);
+    aws_byte_buf_clean_up(&input_buf);
+    return result;
+}
+
+AWS_TEST_CASE(blake3_test_vector_1, s_blake3_test_vector_1_fn)
+
+static int s_blake3_test_vector_1024_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, 1024));
+    s_fill_test_vector_input(&input_buf);
+    struct aws_byte_cursor input = aws_byte_cursor_from_buf(&input_buf);
+
+    uint8_t expected[] = {
+        0x42, 0x21, 0x47, 0x39, 0xf0, 0x95, 0xa4, 0x06, 0xf3, 0xfc, 0x83, 0xde, 0xb8, 0x89, 0x74, 0x4a,
+        0xc0, 0x0d, 0xf8, 0x31, 0xc1, 0x0d, 0xaa, 0x55, 0x18, 0x9b, 0x5d, 0x12, 0x1c, 0x85, 0x5a, 0xf7,
+    };
+    struct aws_byte_cursor expected_buf = aws_byte_cursor_from_array(expected, sizeof(expected));
+
+    int result = s_verify_hash_test_case(allocator, &input, &expected_buf, aws_blake3_new);
+    aws_byte_buf_clean_up(&input_buf);
+    return result;
+}
+
+AWS_TEST_CASE(blake3_test_vector_1024, s_blake3_test_vector_1024_fn)
+
+static int s_blake3_test_vector_1025_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, 1025));
+    s_fill_test_vector_input(&input_buf);
+    struct aws_byte_cursor input = aws_byte_cursor_from_buf(&input_buf);
+
+    uint8_t expected[] = {
+        0xd0, 0x02, 0x78, 0xae, 0x47, 0xeb, 0x27, 0xb3, 0x4f, 0xae, 0xcf, 0x67, 0xb4, 0xfe, 0x26, 0x3f,
+        0x82, 0xd5, 0x41, 0x29, 0x16, 0xc1, 0xff, 0xd9, 0x7c, 0x8c, 0xb7, 0xfb, 0x81, 0x4b, 0x84, 0x44,
+    };
+    struct aws_byte_cursor expected_buf = aws_byte_cursor_from_array(expected, sizeof(expected));
+
+    int result = s_verify_hash_test_case(allocator, &input, &expected_buf, aws_blake3_new);
+    aws_byte_buf_clean_up(&input_buf);
+    return result;
+}
+
+AWS_TEST_CASE(blake3_test_vector_1025, s_blake3_test_vector_1025_fn)
+
+static int s_blake3_test_vector_2048_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, 2048));
+    s_fill_test_vector_input(&input_buf);
+    struct aws_byte_cursor input = aws_byte_cursor_from_buf(&input_buf);
+
+    uint8_t expected[] = {
+        0xe7, 0x76, 0xb6, 0x02, 0x8c, 0x7c, 0xd2, 0x2a, 0x4d, 0x0b, 0xa1, 0x82, 0xa8, 0xbf, 0x62, 0x20,
+        0x5d, 0x2e, 0xf5, 0x76, 0x46, 0x7e, 0x83, 0x8e, 0xd6, 0xf2, 0x52, 0x9b, 0x85, 0xfb, 0xa2, 0x4a,
+    };
+    struct aws_byte_cursor expected_buf = aws_byte_cursor_from_array(expected, sizeof(expected));
+
+    int result = s_verify_hash_test_case(allocator, &input, &expected_buf, aws_blake3_new);
+    aws_byte_buf_clean_up(&input_buf);
+    return result;
+}
+
+AWS_TEST_CASE(blake3_test_vector_2048, s_blake3_test_vector_2048_fn)
+
+static int s_blake3_test_large_input_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, 102400));
+    s_fill_test_vector_input(&input_buf);
+
+    uint8_t expected[] = {
+        0xbc, 0x3e, 0x3d, 0x41, 0xa1, 0x14, 0x6b, 0x06, 0x9a, 0xbf, 0xfa, 0xd3, 0xc0, 0xd4, 0x48, 0x60,
+        0xcf, 0x66, 0x43, 0x90, 0xaf, 0xce, 0x4d, 0x96, 0x61, 0xf7, 0x90, 0x2e, 0x79, 0x43, 0xe0, 0x85,
+    };
+
+    /* the whole input in one update goes through the subtree path, odd sized updates through the chunk state */
+    size_t update_sizes[] = {102400, 1000, 1024, 4096 + 13};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(update_sizes); ++i) {
+        struct aws_hash *hash = aws_blake3_new(allocator);
+        ASSERT_NOT_NULL(hash);
+
+        struct aws_byte_cursor input = aws_byte_cursor_from_buf(&input_buf);
+        while (input.len) {
+            struct aws_byte_cursor segment = aws_byte_cursor_advance(&input, aws_min_size(input.len, update_sizes[i]));
+            ASSERT_SUCCESS(aws_hash_update(hash, &segment));
+        }
+
+        uint8_t output[AWS_BLAKE3_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+        ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        aws_hash_destroy(hash);
+    }
+
+    aws_byte_buf_clean_up(&input_buf);
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(blake3_test_large_input, s_blake3_test_large_input_fn)
+
+struct blake3_run_tasks_stats {
+    size_t calls;
+    size_t tasks;
+};
+
+/* runs the tasks back to front on the calling thread, which is enough to show they don't depend on each other */
+static void s_run_tasks_in_reverse(void (*task_fn)(void *), void **task_args, size_t task_count, void *user_data) {
+    struct blake3_run_tasks_stats *stats = user_data;
+    stats->calls += 1;
+    stats->tasks += task_count;
+
+    for (size_t i = task_count; i > 0; --i) {
+        task_fn(task_args[i - 1]);
+    }
+}
+
+static int s_blake3_test_parallel_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_buf input_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&input_buf, allocator, 102400));
+    s_fill_test_vector_input(&input_buf);
+
+    uint8_t expected[] = {
+        0xbc, 0x3e, 0x3d, 0x41, 0xa1, 0x14, 0x6b, 0x06, 0x9a, 0xbf, 0xfa, 0xd3, 0xc0, 0xd4, 0x48, 0x60,
+        0xcf, 0x66, 0x43, 0x90, 0xaf, 0xce, 0x4d, 0x96, 0x61, 0xf7, 0x90, 0x2e, 0x79, 0x43, 0xe0, 0x85,
+    };
+
+    struct blake3_run_tasks_stats stats = {0};
+    struct aws_blake3_parallel_options options = {
+        .run_tasks = s_run_tasks_in_reverse,
+        .user_data = &stats,
+        .max_tasks = 4,
+        .min_parallel_len = 8192,
+    };
+
+    struct aws_hash *hash = aws_blake3_new_parallel(allocator, &options);
+    ASSERT_NOT_NULL(hash);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_buf(&input_buf);
+    ASSERT_SUCCESS(aws_hash_update(hash, &input));
+
+    uint8_t output[AWS_BLAKE3_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    ASSERT_TRUE(stats.calls > 0);
+    ASSERT_TRUE(stats.tasks <= stats.calls * 4);
+
+    aws_hash_destroy(hash);
+
+    /* run_tasks is mandatory */
+    options.run_tasks = NULL;
+    ASSERT_NULL(aws_blake3_new_parallel(allocator, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    aws_byte_buf_clean_up(&input_buf);
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(blake3_test_parallel, s_blake3_test_parallel_fn)
+
+static int s_blake3_test_oneshot_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    uint8_t expected[] = {
+        0x64, 0x37, 0xb3, 0xac, 0x38, 0x46, 0x51, 0x33, 0xff, 0xb6, 0x3b, 0x75, 0x27, 0x3a, 0x8d, 0xb5,
+        0x48, 0xc5, 0x58, 0x46, 0x5d, 0x79, 0xdb, 0x03, 0xfd, 0x35, 0x9c, 0x6c, 0xd5, 0xbd, 0x9d, 0x85,
+    };
+
+    /* the second pass runs on the reset, cached instance */
+    for (size_t i = 0; i < 2; ++i) {
+        uint8_t output[AWS_BLAKE3_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+
+        ASSERT_SUCCESS(aws_blake3_compute(allocator, &input, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+    }
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(blake3_test_oneshot, s_blake3_test_oneshot_fn)
@@ -0,0 +1,345 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/cal/hash.h>
+#include <aws/cal/private/builtin_sha.h>
+#include <aws/common/byte_buf.h>
+#include <aws/testing/aws_test_harness.h>
+
+#include <test_case_helper.h>
+
+/*
+ * Digests of the first len bytes of the message s_fill_message() writes, at the lengths around the points where
+ * padding spills into another block and where updates go from buffering to hashing whole blocks straight from the
+ * input. They were generated with another implementation.
+ */
+struct builtin_sha_vector {
+    size_t len;
+    uint8_t digest[AWS_SHA256_LEN];
+};
+
+static const struct builtin_sha_vector s_sha1_vectors[] = {
+    {
+        .len = 1,
+        .digest =
+            {
+                0x5d, 0x1b, 0xe7, 0xe9, 0xdd, 0xa1, 0xee, 0x88, 0x96, 0xbe,
+                0x5b, 0x7e, 0x34, 0xa8, 0x5e, 0xe1, 0x64, 0x52, 0xa7, 0xb4,
+            },
+    },
+    {
+        .len = 55,
+        .digest =
+            {
+                0x74, 0x9b, 0xbe, 0xfb, 0x28, 0xed, 0xc4, 0x63, 0x8b, 0x28,
+                0xb2, 0xb9, 0xa9, 0xe0, 0x3a, 0xb9, 0xa4, 0x03, 0x2b, 0x90,
+            },
+    },
+    {
+        .len = 56,
+        .digest =
+            {
+                0xa5, 0xb6, 0xe9, 0xc2, 0x9d, 0x20, 0x1c, 0x77, 0x47, 0x53,
+                0xff, 0x8e, 0x7f, 0xb6, 0x49, 0x31, 0x65, 0x6f, 0x5e, 0x63,
+            },
+    },
+    {
+        .len = 63,
+        .digest =
+            {
+                0xd1, 0xa4, 0x54, 0x40, 0x93, 0x59, 0xfc, 0x37, 0x2b, 0x4d,
+                0x22, 0xb3, 0xce, 0xa6, 0x48, 0x8d, 0x6b, 0xa1, 0xbe, 0x00,
+            },
+    },
+    {
+        .len = 64,
+        .digest =
+            {
+                0x39, 0xa0, 0xd8, 0xb6, 0x45, 0xad, 0x85, 0xf1, 0xf9, 0x76,
+                0x73, 0x1e, 0xd1, 0x12, 0xac, 0x94, 0x55, 0xe2, 0x8b, 0x78,
+            },
+    },
+    {
+        .len = 65,
+        .digest =
+            {
+                0xd0, 0xc9, 0x6e, 0x18, 0x89, 0x01, 0x14, 0xa1, 0x47, 0x16,
+                0xe9, 0x68, 0x65, 0x28, 0xd2, 0xe3, 0xfd, 0xba, 0x8d, 0x9e,
+            },
+    },
+    {
+        .len = 119,
+        .digest =
+            {
+                0x56, 0x2e, 0xcf, 0x8a, 0x43, 0x0f, 0x8e, 0x10, 0x56, 0xe3,
+                0x61, 0x9b, 0xae, 0x33, 0x62, 0x8e, 0x9a, 0x1d, 0x0a, 0x4e,
+            },
+    },
+    {
+        .len = 120,
+        .digest =
+            {
+                0x35, 0x3f, 0x6d, 0x2b, 0xf0, 0xe9, 0x1a, 0xa9, 0x1b, 0x74,
+                0xa2, 0xe0, 0xb3, 0xf2, 0x97, 0x51, 0x0f, 0x7d, 0x82, 0x5f,
+            },
+    },
+    {
+        .len = 128,
+        .digest =
+            {
+                0x00, 0x60, 0xf2, 0xa7, 0xe3, 0x4b, 0x6e, 0x4d, 0x45, 0x9f,
+                0x56, 0x01, 0x97, 0xef, 0x93, 0x24, 0x37, 0x32, 0xa4, 0x00,
+            },
+    },
+    {
+        .len = 200,
+        .digest =
+            {
+                0x91, 0x94, 0xd8, 0x14, 0x5e, 0x55, 0x65, 0x94, 0x76, 0x6d,
+                0xf1, 0xe7, 0x69, 0x9e, 0x2d, 0xfd, 0xa4, 0x24, 0xd1, 0xee,
+            },
+    },
+    {
+        .len = 1000,
+        .digest =
+            {
+                0x41, 0x44, 0x75, 0x34, 0x10, 0x17, 0xec, 0x91, 0x70, 0x34,
+                0x35, 0xa6, 0xf2, 0x90, 0x32, 0x48, 0x18, 0xf9, 0x83, 0xe9,
+            },
+    },
+};
+
+static const struct builtin_sha_vector s_sha256_vectors[] = {
+    {
+        .len = 1,
+        .digest =
+            {
+                0xca, 0x35, 0x87, 0x58, 0xf6, 0xd2, 0x7e, 0x6c, 0xf4, 0x52, 0x72, 0x93, 0x79, 0x77, 0xa7, 0x48,
+                0xfd, 0x88, 0x39, 0x1d, 0xb6, 0x79, 0xce, 0xda, 0x7d, 0xc7, 0xbf, 0x1f, 0x00, 0x5e, 0xe8, 0x79,
+            },
+    },
+    {
+        .len = 55,
+        .digest =
+            {
+                0x8a, 0xa9, 0x94, 0x58, 0x41, 0x39, 0xd1, 0x28, 0x84, 0x8e, 0xee, 0xbc, 0x4e, 0x81, 0x56, 0x39,
+                0xba, 0x5a, 0xb6, 0xe6, 0xe3, 0x95, 0x74, 0x19, 0x5a, 0x63, 0xac, 0x4f, 0x14, 0xf7, 0xc4, 0x3b,
+            },
+    },
+    {
+        .len = 56,
+        .digest =
+            {
+                0xad, 0x57, 0x47, 0x08, 0xf7, 0x5c, 0x04, 0x4c, 0x9b, 0x85, 0xde, 0x64, 0xcb, 0x56, 0x8e, 0xe7,
+                0x71, 0x1f, 0xf4, 0xf3, 0x64, 0x48, 0xc6, 0x24, 0x2f, 0x05, 0x3b, 0xa8, 0xf6, 0xcc, 0x2b, 0x63,
+            },
+    },
+    {
+        .len = 63,
+        .digest =
+            {
+                0x28, 0x0e, 0xd3, 0xe8, 0xff, 0x1d, 0xf8, 0x45, 0xb2, 0xe7, 0xdf, 0xe6, 0xac, 0x6c, 0xee, 0x81,
+                0x7b, 0xef, 0x20, 0xe7, 0x83, 0xcc, 0x65, 0xab, 0xc4, 0x1b, 0x81, 0x8b, 0x4d, 0x2f, 0xe0, 0x76,
+            },
+    },
+    {
+        .len = 64,
+        .digest =
+            {
+                0xc6, 0xab, 0x97, 0x24, 0xad, 0xe5, 0xb6, 0xa7, 0xa1, 0xed, 0xff, 0xfb, 0x12, 0xf3, 0xaa, 0x91,
+                0x81, 0x35, 0x13, 0x55, 0xaf, 0x8f, 0xd0, 0x8c, 0x91, 0x99, 0x52, 0xad, 0x21, 0x13, 0x39, 0xdd,
+            },
+    },
+    {
+        .len = 65,
+        .digest =
+            {
+                0x78, 0x83, 0x67, 0xc7, 0x3c, 0x7d, 0xdf, 0x4c, 0x53, 0xf6, 0x5e, 0x68, 0xcc, 0x0d, 0x94, 0x3e,
+                0x62, 0x27, 0xab, 0x55, 0xb0, 0xe7, 0x8b, 0xa6, 0x3a, 0xce, 0x82, 0x2b, 0x1c, 0x63, 0x01, 0xc0,
+            },
+    },
+    {
+        .len = 119,
+        .digest =
+            {
+                0x3d, 0x61, 0x05, 0x47, 0xd6, 0x82, 0x16, 0xde, 0xdf, 0x74, 0x35, 0xa4, 0xfb, 0x62, 0x60, 0x35,
+                0x39, 0x11, 0xf6, 0xb3, 0xfd, 0x3f, 0x18, 0x80, 0x5d, 0xdb, 0x8b, 0xe2, 0x85, 0xd7, 0x26, 0xfe,
+            },
+    },
+    {
+        .len = 120,
+        .digest =
+            {
+                0x1f, 0x80, 0x15, 0x6a, 0x80, 0x4c, 0xb7, 0x86, 0x2a, 0xd1, 0x13, 0xe8, 0x20, 0x0e, 0x9d, 0x74,
+                0x49, 0x97, 0x23, 0xe7, 0xc7, 0x85, 0x4d, 0x5f, 0x48, 0x77, 0x6d, 0x31, 0x48, 0xe0, 0x96, 0x56,
+            },
+    },
+    {
+        .len = 128,
+        .digest =
+            {
+                0xcc, 0x54, 0x8c, 0xa2, 0xde, 0xc1, 0xf6, 0xfe, 0x4f, 0x58, 0xb2, 0xe2, 0x7a, 0xa9, 0xc7, 0x52,
+                0x16, 0x07, 0xdf, 0x11, 0x30, 0xd1, 0x40, 0xb5, 0x5a, 0x4d, 0xad, 0x06, 0x65, 0x30, 0x23, 0x56,
+            },
+    },
+    {
+        .len = 200,
+        .digest =
+            {
+                0x44, 0xca, 0xe5, 0x22, 0x3d, 0x43, 0x1c, 0xae, 0xd4, 0xa9, 0xe3, 0x22, 0x71, 0xd6, 0xab, 0xf1,
+                0x7c, 0x3f, 0x2f, 0x4a, 0xba, 0xc4, 0x5f, 0xcd, 0xb4, 0x8a, 0x99, 0xfc, 0xc6, 0x07, 0x2a, 0x09,
+            },
+    },
+    {
+        .len = 1000,
+        .digest =
+            {
+                0x50, 0x97, 0xe7, 0xd5, 0x87, 0x35, 0x2f, 0x50, 0x97, 0x06, 0x2a, 0xe6, 0x79, 0xf3, 0x7b, 0xda,
+                0x58, 0x02, 0xd9, 0xf8, 0x75, 0xab, 0xa1, 0x4c, 0x8c, 0xb4, 0xd1, 0xa1, 0x88, 0xad, 0xa1, 0x79,
+            },
+    },
+};
+
+static void s_fill_message(uint8_t *message, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        message[i] = (uint8_t)(i * 31 + 7);
+    }
+}
+
+static int s_check_vectors(
+    struct aws_allocator *allocator,
+    enum aws_sha_builtin_impl impl,
+    aws_hash_new_fn *new_fn,
+    const struct builtin_sha_vector *vectors,
+    size_t vector_count,
+    size_t digest_len) {
+
+    if (aws_sha_builtin_force_impl(impl)) {
+        /* nothing to cover on a cpu without the instructions */
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+        return AWS_OP_SUCCESS;
+    }
+
+    uint8_t message[1000];
+    s_fill_message(message, sizeof(message));
+
+    int result = AWS_OP_SUCCESS;
+    for (size_t i = 0; i < vector_count && result == AWS_OP_SUCCESS; ++i) {
+        struct aws_byte_cursor input = aws_byte_cursor_from_array(message, vectors[i].len);
+        struct aws_byte_cursor expected = aws_byte_cursor_from_array(vectors[i].digest, digest_len);
+        result = s_verify_hash_test_case(allocator, &input, &expected, new_fn);
+    }
+
+    aws_sha_builtin_force_impl(AWS_SHA_BUILTIN_IMPL_DETECT);
+    return result;
+}
+
+static int s_builtin_sha1_portable_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    return s_check_vectors(
+        allocator,
+        AWS_SHA_BUILTIN_IMPL_PORTABLE,
+        aws_sha1_new,
+        s_sha1_vectors,
+        AWS_ARRAY_SIZE(s_sha1_vectors),
+        AWS_SHA1_LEN);
+}
+
+AWS_TEST_CASE(builtin_sha1_portable, s_builtin_sha1_portable_fn)
+
+static int s_builtin_sha1_accelerated_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    return s_check_vectors(
+        allocator,
+        AWS_SHA_BUILTIN_IMPL_ACCELERATED,
+        aws_sha1_new,
+        s_sha1_vectors,
+        AWS_ARRAY_SIZE(s_sha1_vectors),
+        AWS_SHA1_LEN);
+}
+
+AWS_TEST_CASE(builtin_sha1_accelerated, s_builtin_sha1_accelerated_fn)
+
+static int s_builtin_sha256_portable_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    return s_check_vectors(
+        allocator,
+        AWS_SHA_BUILTIN_IMPL_PORTABLE,
+        aws_sha256_new,
+        s_sha256_vectors,
+        AWS_ARRAY_SIZE(s_sha256_vectors),
+        AWS_SHA256_LEN);
+}
+
+AWS_TEST_CASE(builtin_sha256_portable, s_builtin_sha256_portable_fn)
+
+static int s_builtin_sha256_accelerated_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    return s_check_vectors(
+        allocator,
+        AWS_SHA_BUILTIN_IMPL_ACCELERATED,
+        aws_sha256_new,
+        s_sha256_vectors,
+        AWS_ARRAY_SIZE(s_sha256_vectors),
+        AWS_SHA256_LEN);
+}
+
+AWS_TEST_CASE(builtin_sha256_accelerated, s_builtin_sha256_accelerated_fn)
+
+/* every vector length in one batch, so the pairs are uneven and the last message is hashed on its own */
+static int s_check_batch(struct aws_allocator *allocator, enum aws_sha_builtin_impl impl, size_t truncate_to) {
+    if (aws_sha_builtin_force_impl(impl)) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+        return AWS_OP_SUCCESS;
+    }
+
+    uint8_t message[1000];
+    s_fill_message(message, sizeof(message));
+
+    size_t count = AWS_ARRAY_SIZE(s_sha256_vectors);
+    struct aws_byte_cursor inputs[AWS_ARRAY_SIZE(s_sha256_vectors)];
+    struct aws_byte_buf outputs[AWS_ARRAY_SIZE(s_sha256_vectors)];
+    uint8_t digests[AWS_ARRAY_SIZE(s_sha256_vectors)][AWS_SHA256_LEN];
+    for (size_t i = 0; i < count; ++i) {
+        inputs[i] = aws_byte_cursor_from_array(message, s_sha256_vectors[i].len);
+        outputs[i] = aws_byte_buf_from_empty_array(digests[i], sizeof(digests[i]));
+        memset(digests[i], 0xAA, sizeof(digests[i]));
+    }
+
+    ASSERT_SUCCESS(aws_sha256_compute_batch(allocator, inputs, outputs, count, truncate_to));
+
+    size_t digest_len = truncate_to ? truncate_to : AWS_SHA256_LEN;
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_BIN_ARRAYS_EQUALS(s_sha256_vectors[i].digest, digest_len, outputs[i].buffer, outputs[i].len);
+        /* and nothing past the truncated digest */
+        for (size_t j = digest_len; j < AWS_SHA256_LEN; ++j) {
+            ASSERT_UINT_EQUALS(0xAA, digests[i][j]);
+        }
+    }
+
+    aws_sha_builtin_force_impl(AWS_SHA_BUILTIN_IMPL_DETECT);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_builtin_sha256_batch_portable_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    ASSERT_SUCCESS(s_check_batch(allocator, AWS_SHA_BUILTIN_IMPL_PORTABLE, 0));
+    return s_check_batch(allocator, AWS_SHA_BUILTIN_IMPL_PORTABLE, 20);
+}
+
+AWS_TEST_CASE(builtin_sha256_batch_portable, s_builtin_sha256_batch_portable_fn)
+
+static int s_builtin_sha256_batch_accelerated_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    ASSERT_SUCCESS(s_check_batch(allocator, AWS_SHA_BUILTIN_IMPL_ACCELERATED, 0));
+    return s_check_batch(allocator, AWS_SHA_BUILTIN_IMPL_ACCELERATED, 20);
+}
+
+AWS_TEST_CASE(builtin_sha256_batch_accelerated, s_builtin_sha256_batch_accelerated_fn)
@@ -5,6 +5,8 @@
 
 #include <aws/cal/private/der.h>
 
+#include <aws/cal/cal.h>
+
 #include <aws/testing/aws_test_harness.h>
 
 /* clang-format off */
@@ -266,6 +268,78 @@ static int s_der_encode_set(struct aws_allocator *allocator, void *ctx) {
 
 AWS_TEST_CASE(der_encode_set, s_der_encode_set)
 
+static int s_der_inplace_encode_matches_encoder(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct aws_byte_cursor bigint_cur = aws_byte_cursor_from_array(s_bigint, AWS_ARRAY_SIZE(s_bigint));
+    struct aws_byte_cursor octet_string = aws_byte_cursor_from_array(s_octet_string, AWS_ARRAY_SIZE(s_octet_string));
+    struct aws_byte_cursor bit_string = aws_byte_cursor_from_array(s_bit_string, AWS_ARRAY_SIZE(s_bit_string));
+
+    /* big enough that the outer SEQUENCE needs a 2 byte length and the inner one a 1 byte long form length */
+    struct aws_der_encoder *encoder = aws_der_encoder_new(allocator, 1024);
+    ASSERT_NOT_NULL(encoder);
+    ASSERT_SUCCESS(aws_der_encoder_begin_sequence(encoder));
+    ASSERT_SUCCESS(aws_der_encoder_write_integer(encoder, bigint_cur));
+    ASSERT_SUCCESS(aws_der_encoder_begin_set(encoder));
+    ASSERT_SUCCESS(aws_der_encoder_write_boolean(encoder, true));
+    ASSERT_SUCCESS(aws_der_encoder_write_null(encoder));
+    ASSERT_SUCCESS(aws_der_encoder_end_set(encoder));
+    ASSERT_SUCCESS(aws_der_encoder_begin_sequence(encoder));
+    ASSERT_SUCCESS(aws_der_encoder_write_octet_string(encoder, octet_string));
+    ASSERT_SUCCESS(aws_der_encoder_write_bit_string(encoder, bit_string));
+    ASSERT_SUCCESS(aws_der_encoder_end_sequence(encoder));
+    ASSERT_SUCCESS(aws_der_encoder_end_sequence(encoder));
+    struct aws_byte_cursor expected;
+    ASSERT_SUCCESS(aws_der_encoder_get_contents(encoder, &expected));
+
+    uint8_t storage[1024];
+    struct aws_byte_buf output = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    struct aws_der_inplace_encoder inplace_encoder;
+    aws_der_inplace_encoder_init(&inplace_encoder, &output);
+    ASSERT_SUCCESS(aws_der_inplace_encoder_begin_sequence(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_write_integer(&inplace_encoder, bigint_cur));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_begin_set(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_write_boolean(&inplace_encoder, true));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_write_null(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_end_set(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_begin_sequence(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_write_octet_string(&inplace_encoder, octet_string));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_write_bit_string(&inplace_encoder, bit_string));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_end_sequence(&inplace_encoder));
+    ASSERT_FAILS(aws_der_inplace_encoder_finish(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_end_sequence(&inplace_encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_finish(&inplace_encoder));
+
+    ASSERT_BIN_ARRAYS_EQUALS(expected.ptr, expected.len, output.buffer, output.len);
+    aws_der_encoder_destroy(encoder);
+    return 0;
+}
+
+AWS_TEST_CASE(der_inplace_encode_matches_encoder, s_der_inplace_encode_matches_encoder)
+
+static int s_der_inplace_encode_short_buffer(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+    struct aws_byte_cursor bigint_cur = aws_byte_cursor_from_array(s_bigint, AWS_ARRAY_SIZE(s_bigint));
+
+    /* exactly enough for the INTEGER under a short form SEQUENCE header, but the length needs the long form */
+    uint8_t storage[2 + AWS_ARRAY_SIZE(s_encoded_bigint)];
+    struct aws_byte_buf output = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    struct aws_der_inplace_encoder encoder;
+    aws_der_inplace_encoder_init(&encoder, &output);
+    ASSERT_FAILS(aws_der_inplace_encoder_end_sequence(&encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_begin_sequence(&encoder));
+    ASSERT_SUCCESS(aws_der_inplace_encoder_write_integer(&encoder, bigint_cur));
+    ASSERT_FAILS(aws_der_inplace_encoder_end_sequence(&encoder));
+
+    /* a failed write leaves the output where it was */
+    size_t len = output.len;
+    ASSERT_FAILS(aws_der_inplace_encoder_write_boolean(&encoder, true));
+    ASSERT_UINT_EQUALS(len, output.len);
+    return 0;
+}
+
+AWS_TEST_CASE(der_inplace_encode_short_buffer, s_der_inplace_encode_short_buffer)
+
 static int s_der_decode_integer(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
     const size_t encoded_size = AWS_ARRAY_SIZE(s_encoded_bigint);
@@ -505,3 +579,116 @@ static int s_der_decode_key_pair(struct aws_allocator *allocator, void *ctx) {
 }
 
 AWS_TEST_CASE(der_decode_key_pair, s_der_decode_key_pair)
+
+static int s_der_pull_decode_key_pair(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+    struct aws_byte_cursor input = aws_byte_cursor_from_array(s_encoded_key_pair, AWS_ARRAY_SIZE(s_encoded_key_pair));
+    struct aws_der_pull_decoder decoder;
+    aws_der_pull_decoder_init(&decoder, input);
+
+    /* SEQUENCE */
+    ASSERT_TRUE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_INT_EQUALS(AWS_DER_SEQUENCE, aws_der_pull_decoder_tlv_type(&decoder));
+    ASSERT_INT_EQUALS(116, aws_der_pull_decoder_tlv_length(&decoder));
+    ASSERT_SUCCESS(aws_der_pull_decoder_enter(&decoder));
+
+    /* INTEGER 1 */
+    struct aws_byte_cursor integer;
+    ASSERT_TRUE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_SUCCESS(aws_der_pull_decoder_tlv_integer(&decoder, &integer));
+    ASSERT_BIN_ARRAYS_EQUALS("\x01", 1, integer.ptr, integer.len);
+
+    /* 32 byte private key */
+    struct aws_byte_cursor private_key;
+    ASSERT_TRUE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_FAILS(aws_der_pull_decoder_tlv_integer(&decoder, &integer));
+    ASSERT_SUCCESS(aws_der_pull_decoder_tlv_string(&decoder, &private_key));
+    ASSERT_INT_EQUALS(32, private_key.len);
+
+    /* container holding the OID, only strings are inside containers */
+    ASSERT_TRUE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_INT_EQUALS(7, aws_der_pull_decoder_tlv_length(&decoder));
+    ASSERT_SUCCESS(aws_der_pull_decoder_enter(&decoder));
+
+    struct aws_byte_cursor oid;
+    ASSERT_TRUE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_INT_EQUALS(AWS_DER_OBJECT_IDENTIFIER, aws_der_pull_decoder_tlv_type(&decoder));
+    ASSERT_FAILS(aws_der_pull_decoder_enter(&decoder));
+    ASSERT_SUCCESS(aws_der_pull_decoder_tlv_blob(&decoder, &oid));
+    ASSERT_BIN_ARRAYS_EQUALS("\x2b\x81\x04\x00\x0a", 5, oid.ptr, oid.len);
+    ASSERT_FALSE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_SUCCESS(aws_der_pull_decoder_exit(&decoder));
+
+    /* the public key container is skipped without looking inside */
+    ASSERT_TRUE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_INT_EQUALS(68, aws_der_pull_decoder_tlv_length(&decoder));
+    ASSERT_FALSE(aws_der_pull_decoder_next(&decoder));
+
+    /* the trailing newline doesn't count as another TLV */
+    ASSERT_SUCCESS(aws_der_pull_decoder_exit(&decoder));
+    ASSERT_FALSE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_INT_EQUALS(0, decoder.error_code);
+    ASSERT_FAILS(aws_der_pull_decoder_exit(&decoder));
+    return 0;
+}
+
+AWS_TEST_CASE(der_pull_decode_key_pair, s_der_pull_decode_key_pair)
+
+static int s_check_pull_decoder_matches(struct aws_allocator *allocator, struct aws_byte_cursor input) {
+    struct aws_der_decoder *decoder = aws_der_decoder_new(allocator, input);
+    ASSERT_NOT_NULL(decoder);
+    struct aws_der_pull_decoder pull_decoder;
+    aws_der_pull_decoder_init(&pull_decoder, input);
+
+    while (aws_der_decoder_next(decoder)) {
+        ASSERT_TRUE(aws_der_pull_decoder_next_in_order(&pull_decoder));
+        ASSERT_INT_EQUALS(aws_der_decoder_tlv_type(decoder), aws_der_pull_decoder_tlv_type(&pull_decoder));
+        ASSERT_INT_EQUALS(aws_der_decoder_tlv_length(decoder), aws_der_pull_decoder_tlv_length(&pull_decoder));
+    }
+
+    ASSERT_FALSE(aws_der_pull_decoder_next_in_order(&pull_decoder));
+    ASSERT_INT_EQUALS(0, pull_decoder.error_code);
+    aws_der_decoder_destroy(decoder);
+    return 0;
+}
+
+static int s_der_pull_decode_in_order(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    ASSERT_SUCCESS(s_check_pull_decoder_matches(
+        allocator, aws_byte_cursor_from_array(s_encoded_key_pair, AWS_ARRAY_SIZE(s_encoded_key_pair))));
+    ASSERT_SUCCESS(s_check_pull_decoder_matches(
+        allocator, aws_byte_cursor_from_array(s_encoded_set, AWS_ARRAY_SIZE(s_encoded_set))));
+    ASSERT_SUCCESS(s_check_pull_decoder_matches(
+        allocator, aws_byte_cursor_from_array(s_encoded_bigint, AWS_ARRAY_SIZE(s_encoded_bigint))));
+    return 0;
+}
+
+AWS_TEST_CASE(der_pull_decode_in_order, s_der_pull_decode_in_order)
+
+static int s_der_pull_decode_malformed(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    /* SEQUENCE claiming more bytes than there are */
+    uint8_t truncated[] = {0x30, 0x06, 0x01, 0x01, 0xff};
+    struct aws_der_pull_decoder decoder;
+    aws_der_pull_decoder_init(&decoder, aws_byte_cursor_from_array(truncated, sizeof(truncated)));
+    ASSERT_FALSE(aws_der_pull_decoder_next(&decoder));
+    ASSERT_INT_EQUALS(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED, decoder.error_code);
+    ASSERT_FALSE(aws_der_pull_decoder_next(&decoder));
+
+    /* a tower of empty-ish SEQUENCEs, nested deeper than either decoder allows */
+    uint8_t nested[2 * (AWS_DER_DECODER_MAX_DEPTH + 1)];
+    for (size_t i = 0; i <= AWS_DER_DECODER_MAX_DEPTH; ++i) {
+        nested[2 * i] = AWS_DER_SEQUENCE;
+        nested[2 * i + 1] = (uint8_t)(sizeof(nested) - 2 * (i + 1));
+    }
+    aws_der_pull_decoder_init(&decoder, aws_byte_cursor_from_array(nested, sizeof(nested)));
+    while (aws_der_pull_decoder_next_in_order(&decoder)) {
+    }
+    ASSERT_INT_EQUALS(AWS_ERROR_CAL_MALFORMED_ASN1_ENCOUNTERED, decoder.error_code);
+    return 0;
+}
+
+AWS_TEST_CASE(der_pull_decode_malformed, s_der_pull_decode_malformed)
@@ -386,3 +386,43 @@ static int s_md5_test_extra_buffer_space_fn(struct aws_allocator *allocator, voi
     return AWS_OP_SUCCESS;
 }
 AWS_TEST_CASE(md5_test_extra_buffer_space, s_md5_test_extra_buffer_space_fn)
+
+static int s_md5_test_reset_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    struct aws_byte_cursor discarded = aws_byte_cursor_from_c_str("this data gets thrown away by reset");
+    uint8_t expected[] = {
+        0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0, 0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72,
+    };
+
+    struct aws_hash *hash = aws_md5_new(allocator);
+    ASSERT_NOT_NULL(hash);
+
+    /* reset midway through a digest discards the data hashed so far */
+    ASSERT_SUCCESS(aws_hash_update(hash, &discarded));
+    ASSERT_SUCCESS(aws_hash_reset(hash));
+
+    for (size_t i = 0; i < 3; ++i) {
+        uint8_t output[AWS_MD5_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+
+        ASSERT_SUCCESS(aws_hash_update(hash, &input));
+        ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        /* finalized hashes are unusable until reset */
+        ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_hash_update(hash, &input));
+        ASSERT_SUCCESS(aws_hash_reset(hash));
+    }
+
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(md5_test_reset, s_md5_test_reset_fn)
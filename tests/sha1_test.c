@@ -282,3 +282,44 @@ static int s_sha1_test_extra_buffer_space_fn(struct aws_allocator *allocator, vo
     return AWS_OP_SUCCESS;
 }
 AWS_TEST_CASE(sha1_test_extra_buffer_space, s_sha1_test_extra_buffer_space_fn)
+
+static int s_sha1_test_reset_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    struct aws_byte_cursor discarded = aws_byte_cursor_from_c_str("this data gets thrown away by reset");
+    uint8_t expected[] = {
+        0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+        0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d,
+    };
+
+    struct aws_hash *hash = aws_sha1_new(allocator);
+    ASSERT_NOT_NULL(hash);
+
+    /* reset midway through a digest discards the data hashed so far */
+    ASSERT_SUCCESS(aws_hash_update(hash, &discarded));
+    ASSERT_SUCCESS(aws_hash_reset(hash));
+
+    for (size_t i = 0; i < 3; ++i) {
+        uint8_t output[AWS_SHA1_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+
+        ASSERT_SUCCESS(aws_hash_update(hash, &input));
+        ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        /* finalized hashes are unusable until reset */
+        ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_hash_update(hash, &input));
+        ASSERT_SUCCESS(aws_hash_reset(hash));
+    }
+
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha1_test_reset, s_sha1_test_reset_fn)
@@ -361,3 +361,342 @@ static int s_sha256_hmac_test_extra_buffer_space_fn(struct aws_allocator *alloca
     return AWS_OP_SUCCESS;
 }
 AWS_TEST_CASE(sha256_hmac_test_extra_buffer_space, s_sha256_hmac_test_extra_buffer_space_fn)
+
+static int s_sha256_hmac_test_reset_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor secret_buf = aws_byte_cursor_from_c_str("Jefe");
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("what do ya want for nothing?");
+    struct aws_byte_cursor garbage = aws_byte_cursor_from_c_str("this should not end up in the digest");
+
+    uint8_t expected[] = {
+        0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+        0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43,
+    };
+
+    struct aws_hmac *hmac = aws_sha256_hmac_new(allocator, &secret_buf);
+    ASSERT_NOT_NULL(hmac);
+
+    /* discard a partial digest */
+    ASSERT_SUCCESS(aws_hmac_update(hmac, &garbage));
+    ASSERT_SUCCESS(aws_hmac_reset(hmac));
+
+    for (size_t i = 0; i < 3; ++i) {
+        uint8_t output[AWS_SHA256_HMAC_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_array(output, sizeof(output));
+        output_buf.len = 0;
+
+        ASSERT_SUCCESS(aws_hmac_update(hmac, &input));
+        ASSERT_SUCCESS(aws_hmac_finalize(hmac, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        /* reusing after finalize */
+        ASSERT_SUCCESS(aws_hmac_reset(hmac));
+    }
+
+    aws_hmac_destroy(hmac);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_hmac_test_reset, s_sha256_hmac_test_reset_fn)
+
+static int s_sha256_hmac_test_key_template_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor secret_buf = aws_byte_cursor_from_c_str("Jefe");
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("what do ya want for nothing?");
+    struct aws_byte_cursor input_head = aws_byte_cursor_from_array(input.ptr, 10);
+    struct aws_byte_cursor input_tail = aws_byte_cursor_from_array(input.ptr + 10, input.len - 10);
+
+    uint8_t expected[] = {
+        0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+        0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43,
+    };
+
+    struct aws_hmac_key_template *key_template = aws_sha256_hmac_key_template_new(allocator, &secret_buf);
+    ASSERT_NOT_NULL(key_template);
+
+    struct aws_hmac *hmacs[3];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(hmacs); ++i) {
+        hmacs[i] = aws_hmac_new_from_key_template(allocator, key_template);
+        ASSERT_NOT_NULL(hmacs[i]);
+    }
+
+    /* the instances must be independent of each other and of the template */
+    ASSERT_SUCCESS(aws_hmac_update(hmacs[0], &input_head));
+    ASSERT_SUCCESS(aws_hmac_update(hmacs[1], &input));
+    aws_hmac_key_template_destroy(key_template);
+    ASSERT_SUCCESS(aws_hmac_update(hmacs[0], &input_tail));
+    ASSERT_SUCCESS(aws_hmac_update(hmacs[2], &input));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(hmacs); ++i) {
+        uint8_t output[AWS_SHA256_HMAC_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_array(output, sizeof(output));
+        output_buf.len = 0;
+
+        ASSERT_SUCCESS(aws_hmac_finalize(hmacs[i], &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        aws_hmac_destroy(hmacs[i]);
+    }
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_hmac_test_key_template, s_sha256_hmac_test_key_template_fn)
+
+static int s_sha256_hmac_test_duplicate_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor secret_buf = aws_byte_cursor_from_c_str("Jefe");
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("what do ya want for nothing?");
+    struct aws_byte_cursor input_head = aws_byte_cursor_from_array(input.ptr, 10);
+    struct aws_byte_cursor input_tail = aws_byte_cursor_from_array(input.ptr + 10, input.len - 10);
+
+    uint8_t expected[] = {
+        0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+        0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43,
+    };
+
+    struct aws_hmac *hmac = aws_sha256_hmac_new(allocator, &secret_buf);
+    ASSERT_NOT_NULL(hmac);
+    ASSERT_SUCCESS(aws_hmac_update(hmac, &input_head));
+
+    /* the copy carries the hashed prefix along with the key */
+    struct aws_hmac *copy = aws_hmac_duplicate(allocator, hmac);
+    ASSERT_NOT_NULL(copy);
+
+    uint8_t output[AWS_SHA256_HMAC_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_hmac_update(hmac, &input_tail));
+    ASSERT_SUCCESS(aws_hmac_finalize(hmac, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    aws_byte_buf_reset(&output_buf, true);
+    ASSERT_SUCCESS(aws_hmac_update(copy, &input_tail));
+    ASSERT_SUCCESS(aws_hmac_finalize(copy, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    ASSERT_NULL(aws_hmac_duplicate(allocator, hmac));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_STATE, aws_last_error());
+
+    aws_hmac_destroy(copy);
+    aws_hmac_destroy(hmac);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_hmac_test_duplicate, s_sha256_hmac_test_duplicate_fn)
+
+static int s_sha256_hmac_test_chain_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    /* the SigV4 signing key derivation example from the AWS General Reference */
+    struct aws_byte_cursor seed_secret = aws_byte_cursor_from_c_str("AWS4wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY");
+    struct aws_byte_cursor messages[] = {
+        aws_byte_cursor_from_c_str("20150830"),
+        aws_byte_cursor_from_c_str("us-east-1"),
+        aws_byte_cursor_from_c_str("iam"),
+        aws_byte_cursor_from_c_str("aws4_request"),
+    };
+
+    uint8_t expected[] = {
+        0xc4, 0xaf, 0xb1, 0xcc, 0x57, 0x71, 0xd8, 0x71, 0x76, 0x3a, 0x39, 0x3e, 0x44, 0xb7, 0x03, 0x57,
+        0x1b, 0x55, 0xcc, 0x28, 0x42, 0x4d, 0x1a, 0x5e, 0x86, 0xda, 0x6e, 0xd3, 0xc1, 0x54, 0xa4, 0xb9,
+    };
+
+    uint8_t output[AWS_SHA256_HMAC_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_array(output, sizeof(output));
+    output_buf.len = 0;
+
+    ASSERT_SUCCESS(aws_sha256_hmac_chain_compute(
+        allocator, &seed_secret, messages, AWS_ARRAY_SIZE(messages), &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    /* a single step is a plain hmac */
+    uint8_t single_expected[AWS_SHA256_HMAC_LEN] = {0};
+    struct aws_byte_buf single_expected_buf = aws_byte_buf_from_array(single_expected, sizeof(single_expected));
+    single_expected_buf.len = 0;
+    ASSERT_SUCCESS(aws_sha256_hmac_compute(allocator, &seed_secret, &messages[0], &single_expected_buf, 0));
+
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_sha256_hmac_chain_compute(allocator, &seed_secret, messages, 1, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(single_expected_buf.buffer, single_expected_buf.len, output_buf.buffer, output_buf.len);
+
+    output_buf.len = 0;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_sha256_hmac_chain_compute(allocator, &seed_secret, messages, 0, &output_buf, 0));
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_hmac_test_chain, s_sha256_hmac_test_chain_fn)
+
+static int s_sha256_hkdf_rfc5869_test_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    uint8_t ikm[22];
+    memset(ikm, 0x0b, sizeof(ikm));
+    struct aws_byte_cursor secret = aws_byte_cursor_from_array(ikm, sizeof(ikm));
+
+    /* RFC 5869 A.1 */
+    uint8_t salt[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c};
+    uint8_t info[] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9};
+    uint8_t expected[] = {
+        0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36,
+        0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56,
+        0xec, 0xc4, 0xc5, 0xbf, 0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65,
+    };
+
+    struct aws_byte_cursor salt_cur = aws_byte_cursor_from_array(salt, sizeof(salt));
+    struct aws_byte_cursor info_cur = aws_byte_cursor_from_array(info, sizeof(info));
+
+    uint8_t output[64] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_sha256_hkdf_compute(allocator, &secret, &salt_cur, &info_cur, &output_buf, sizeof(expected)));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    /* RFC 5869 A.3, no salt and no info */
+    uint8_t expected_no_salt[] = {
+        0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80, 0x2a, 0x06, 0x3c,
+        0x5a, 0x31, 0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1, 0x87, 0x9e, 0xc3, 0x45, 0x4e, 0x5f,
+        0x3c, 0x73, 0x8d, 0x2d, 0x9d, 0x20, 0x13, 0x95, 0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8,
+    };
+
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_sha256_hkdf_compute(allocator, &secret, NULL, NULL, &output_buf, sizeof(expected_no_salt)));
+    ASSERT_BIN_ARRAYS_EQUALS(expected_no_salt, sizeof(expected_no_salt), output_buf.buffer, output_buf.len);
+
+    output_buf.len = 0;
+    ASSERT_ERROR(
+        AWS_ERROR_SHORT_BUFFER,
+        aws_sha256_hkdf_compute(allocator, &secret, NULL, NULL, &output_buf, sizeof(output) + 1));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_sha256_hkdf_compute(allocator, &secret, NULL, NULL, &output_buf, 255 * AWS_SHA256_HMAC_LEN + 1));
+    ASSERT_UINT_EQUALS(0, output_buf.len);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_hkdf_rfc5869_test, s_sha256_hkdf_rfc5869_test_fn)
+
+/* see the platform's hmac implementation, put back once the test is done with its own */
+extern struct aws_hmac *aws_sha256_hmac_default_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *secret);
+
+/* hmac that produces a fixed digest and fails the finalize numbered s_failing_hmac_fail_at */
+static size_t s_failing_hmac_finalize_count;
+static size_t s_failing_hmac_fail_at;
+
+static void s_failing_hmac_destroy(struct aws_hmac *hmac) {
+    aws_mem_release(hmac->allocator, hmac);
+}
+
+static int s_failing_hmac_update(struct aws_hmac *hmac, const struct aws_byte_cursor *buf) {
+    (void)hmac;
+    (void)buf;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_failing_hmac_finalize(struct aws_hmac *hmac, struct aws_byte_buf *out) {
+    if (++s_failing_hmac_finalize_count == s_failing_hmac_fail_at) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    if (out->capacity - out->len < hmac->digest_size) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    memset(out->buffer + out->len, 0xA5, hmac->digest_size);
+    out->len += hmac->digest_size;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_failing_hmac_reset(struct aws_hmac *hmac) {
+    (void)hmac;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_hmac_vtable s_failing_hmac_vtable = {
+    .alg_name = "SHA256 HMAC",
+    .provider = "failing",
+    .destroy = s_failing_hmac_destroy,
+    .update = s_failing_hmac_update,
+    .finalize = s_failing_hmac_finalize,
+    .reset = s_failing_hmac_reset,
+};
+
+static struct aws_hmac *s_failing_hmac_new(struct aws_allocator *allocator, const struct aws_byte_cursor *secret) {
+    (void)secret;
+
+    struct aws_hmac *hmac = aws_mem_calloc(allocator, 1, sizeof(struct aws_hmac));
+    hmac->allocator = allocator;
+    hmac->vtable = &s_failing_hmac_vtable;
+    hmac->digest_size = AWS_SHA256_HMAC_LEN;
+    hmac->good = true;
+    return hmac;
+}
+
+/* a failure part way through the expansion leaves output as it was, with nothing derived left in it */
+static int s_sha256_hkdf_failure_test_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+    aws_set_sha256_hmac_new_fn(s_failing_hmac_new);
+
+    struct aws_byte_cursor secret = aws_byte_cursor_from_c_str("secret");
+    uint8_t output[4 * AWS_SHA256_HMAC_LEN];
+    memset(output, 0x5A, sizeof(output));
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    output_buf.len = 3;
+
+    /* the first finalize is the extract, so the third fails once a whole block has been written */
+    s_failing_hmac_finalize_count = 0;
+    s_failing_hmac_fail_at = 3;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_STATE,
+        aws_sha256_hkdf_compute(allocator, &secret, NULL, NULL, &output_buf, 2 * AWS_SHA256_HMAC_LEN));
+    ASSERT_UINT_EQUALS(3, output_buf.len);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_UINT_EQUALS(0x5A, output[i]);
+    }
+    for (size_t i = 3; i < 3 + AWS_SHA256_HMAC_LEN; ++i) {
+        ASSERT_UINT_EQUALS(0, output[i]);
+    }
+
+    s_failing_hmac_finalize_count = 0;
+    s_failing_hmac_fail_at = 0;
+    ASSERT_SUCCESS(aws_sha256_hkdf_compute(allocator, &secret, NULL, NULL, &output_buf, 2 * AWS_SHA256_HMAC_LEN));
+    ASSERT_UINT_EQUALS(3 + 2 * AWS_SHA256_HMAC_LEN, output_buf.len);
+
+    aws_set_sha256_hmac_new_fn(aws_sha256_hmac_default_new);
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_hkdf_failure_test, s_sha256_hkdf_failure_test_fn)
@@ -2,8 +2,16 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/cal/async.h>
+#include <aws/cal/cal.h>
 #include <aws/cal/hash.h>
+#include <aws/cal/stats.h>
+#include <aws/common/atomics.h>
 #include <aws/common/byte_buf.h>
+#include <aws/common/environment.h>
+#include <aws/common/file.h>
+#include <aws/common/string.h>
+#include <aws/common/thread.h>
 #include <aws/testing/aws_test_harness.h>
 
 #include <test_case_helper.h>
@@ -299,3 +307,965 @@ static int s_sha256_test_extra_buffer_space_fn(struct aws_allocator *allocator,
     return AWS_OP_SUCCESS;
 }
 AWS_TEST_CASE(sha256_test_extra_buffer_space, s_sha256_test_extra_buffer_space_fn)
+
+static int s_sha256_test_reset_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    struct aws_byte_cursor discarded = aws_byte_cursor_from_c_str("this data gets thrown away by reset");
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+
+    /* reset midway through a digest discards the data hashed so far */
+    ASSERT_SUCCESS(aws_hash_update(hash, &discarded));
+    ASSERT_SUCCESS(aws_hash_reset(hash));
+
+    for (size_t i = 0; i < 3; ++i) {
+        uint8_t output[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+
+        ASSERT_SUCCESS(aws_hash_update(hash, &input));
+        ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        /* finalized hashes are unusable until reset */
+        ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_hash_update(hash, &input));
+        ASSERT_SUCCESS(aws_hash_reset(hash));
+    }
+
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_reset, s_sha256_test_reset_fn)
+
+static int s_sha256_test_oneshot_reuse_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    struct aws_byte_cursor other_input = aws_byte_cursor_from_c_str("this should not leak into the next digest");
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+
+    /* alternate allocators and inputs so the per-thread cached hash gets reused, swapped and rebuilt */
+    struct aws_allocator *allocators[] = {allocator, allocator, aws_default_allocator(), allocator};
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(allocators); ++i) {
+        uint8_t output[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+
+        ASSERT_SUCCESS(aws_sha256_compute(allocators[i], &input, &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        aws_byte_buf_reset(&output_buf, true);
+        ASSERT_SUCCESS(aws_sha256_compute(allocators[i], &other_input, &output_buf, 0));
+    }
+
+    aws_cal_thread_clean_up();
+
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_oneshot_reuse, s_sha256_test_oneshot_reuse_fn)
+
+struct sha256_oneshot_thread_args {
+    struct aws_allocator *allocator;
+    int result;
+};
+
+static void s_sha256_oneshot_thread_fn(void *arg) {
+    struct sha256_oneshot_thread_args *args = arg;
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    args->result = aws_sha256_compute(args->allocator, &input, &output_buf, 0);
+}
+
+/* a launched thread that exits without aws_cal_thread_clean_up() still releases its cached hash */
+static int s_sha256_test_oneshot_thread_exit_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct sha256_oneshot_thread_args args = {.allocator = allocator, .result = AWS_OP_ERR};
+    struct aws_thread thread;
+    ASSERT_SUCCESS(aws_thread_init(&thread, allocator));
+    ASSERT_SUCCESS(aws_thread_launch(&thread, s_sha256_oneshot_thread_fn, &args, aws_default_thread_options()));
+    ASSERT_SUCCESS(aws_thread_join(&thread));
+    aws_thread_clean_up(&thread);
+    ASSERT_SUCCESS(args.result);
+
+    /* the test allocator reports a leak if the thread's instance wasn't freed on exit */
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_oneshot_thread_exit, s_sha256_test_oneshot_thread_exit_fn)
+
+static int s_sha256_test_compute_batch_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor inputs[] = {
+        aws_byte_cursor_from_c_str("abc"),
+        aws_byte_cursor_from_c_str(""),
+        aws_byte_cursor_from_c_str("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+    };
+
+    uint8_t outputs_storage[AWS_ARRAY_SIZE(inputs)][AWS_SHA256_LEN];
+    struct aws_byte_buf outputs[AWS_ARRAY_SIZE(inputs)];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(inputs); ++i) {
+        outputs[i] = aws_byte_buf_from_empty_array(outputs_storage[i], sizeof(outputs_storage[i]));
+    }
+
+    ASSERT_SUCCESS(aws_sha256_compute_batch(allocator, inputs, outputs, AWS_ARRAY_SIZE(inputs), 0));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(inputs); ++i) {
+        uint8_t expected[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+        ASSERT_SUCCESS(aws_sha256_compute(allocator, &inputs[i], &expected_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, outputs[i].buffer, outputs[i].len);
+    }
+
+    /* one short output buffer fails the whole batch before anything is written */
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(inputs); ++i) {
+        aws_byte_buf_reset(&outputs[i], true);
+    }
+    outputs[2].len = 1;
+
+    ASSERT_ERROR(
+        AWS_ERROR_SHORT_BUFFER, aws_sha256_compute_batch(allocator, inputs, outputs, AWS_ARRAY_SIZE(inputs), 0));
+    ASSERT_UINT_EQUALS(0, outputs[0].len);
+    ASSERT_UINT_EQUALS(0, outputs[1].len);
+
+    /* truncated digests only need truncate_to bytes of space */
+    ASSERT_SUCCESS(aws_sha256_compute_batch(allocator, inputs, outputs, AWS_ARRAY_SIZE(inputs), 16));
+    ASSERT_UINT_EQUALS(16, outputs[0].len);
+    ASSERT_UINT_EQUALS(17, outputs[2].len);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_compute_batch, s_sha256_test_compute_batch_fn)
+
+static int s_sha256_test_update_vectored_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    /* NIST test case 3, split across segments that don't line up with the block size, plus an empty one. */
+    struct aws_byte_cursor segments[] = {
+        aws_byte_cursor_from_c_str("abcdbcdecdef"),
+        aws_byte_cursor_from_c_str(""),
+        aws_byte_cursor_from_c_str("defgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+    };
+    uint8_t expected[] = {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1,
+    };
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+
+    ASSERT_SUCCESS(aws_hash_update_vectored(hash, segments, AWS_ARRAY_SIZE(segments)));
+    /* nothing to add is fine */
+    ASSERT_SUCCESS(aws_hash_update_vectored(hash, NULL, 0));
+
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_update_vectored, s_sha256_test_update_vectored_fn)
+
+AWS_STATIC_STRING_FROM_LITERAL(s_libcrypto_resolve_env, "AWS_CAL_LIBCRYPTO_RESOLVE");
+AWS_STATIC_STRING_FROM_LITERAL(s_libcrypto_resolve_lazy, "lazy");
+
+static int s_sha256_test_lazy_libcrypto_resolve_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* only libcrypto builds look at this, everywhere else it must simply not get in the way */
+    ASSERT_SUCCESS(aws_set_environment_value(s_libcrypto_resolve_env, s_libcrypto_resolve_lazy));
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    aws_cal_library_clean_up();
+
+    ASSERT_SUCCESS(aws_unset_environment_value(s_libcrypto_resolve_env));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_lazy_libcrypto_resolve, s_sha256_test_lazy_libcrypto_resolve_fn)
+
+static int s_sha256_test_oneshot_truncated_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+
+    /* exactly truncate_to bytes of space, so the digest can't be written in place */
+    uint8_t exact[16] = {0};
+    struct aws_byte_buf exact_buf = aws_byte_buf_from_empty_array(exact, sizeof(exact));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &exact_buf, sizeof(exact)));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(exact), exact_buf.buffer, exact_buf.len);
+
+    /* room for the whole digest after existing contents, only truncate_to bytes of which may be written */
+    uint8_t roomy[4 + AWS_SHA256_LEN];
+    memset(roomy, 0xee, sizeof(roomy));
+    struct aws_byte_buf roomy_buf = aws_byte_buf_from_empty_array(roomy, sizeof(roomy));
+    ASSERT_TRUE(aws_byte_buf_write_u8(&roomy_buf, 0x2a));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &roomy_buf, 8));
+    ASSERT_UINT_EQUALS(9, roomy_buf.len);
+    ASSERT_UINT_EQUALS(0x2a, roomy[0]);
+    ASSERT_BIN_ARRAYS_EQUALS(expected, 8, roomy + 1, 8);
+    for (size_t i = roomy_buf.len; i < sizeof(roomy); ++i) {
+        ASSERT_UINT_EQUALS(0xee, roomy[i]);
+    }
+
+    /* the same goes for finalizing an instance */
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    ASSERT_SUCCESS(aws_hash_update(hash, &input));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &roomy_buf, 8));
+    aws_hash_destroy(hash);
+    ASSERT_UINT_EQUALS(17, roomy_buf.len);
+    ASSERT_BIN_ARRAYS_EQUALS(expected, 8, roomy + 9, 8);
+    for (size_t i = roomy_buf.len; i < sizeof(roomy); ++i) {
+        ASSERT_UINT_EQUALS(0xee, roomy[i]);
+    }
+
+    /* a truncate_to larger than the digest writes the whole digest */
+    uint8_t full[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf full_buf = aws_byte_buf_from_empty_array(full, sizeof(full));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &full_buf, 64));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), full_buf.buffer, full_buf.len);
+
+    uint8_t small[15] = {0};
+    struct aws_byte_buf small_buf = aws_byte_buf_from_empty_array(small, sizeof(small));
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_sha256_compute(allocator, &input, &small_buf, 16));
+    ASSERT_UINT_EQUALS(0, small_buf.len);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_oneshot_truncated, s_sha256_test_oneshot_truncated_fn)
+
+/* exports after the first split_len bytes of the message and checks that resuming from there gives its digest */
+static int s_check_export_import_state(struct aws_allocator *allocator, size_t split_len) {
+    uint8_t message[200];
+    for (size_t i = 0; i < sizeof(message); ++i) {
+        message[i] = (uint8_t)(i * 31 + 7);
+    }
+    struct aws_byte_cursor message_cur = aws_byte_cursor_from_array(message, sizeof(message));
+    struct aws_byte_cursor head = aws_byte_cursor_advance(&message_cur, split_len);
+
+    uint8_t expected[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+    struct aws_byte_cursor whole = aws_byte_cursor_from_array(message, sizeof(message));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &whole, &expected_buf, 0));
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    ASSERT_SUCCESS(aws_hash_update(hash, &head));
+
+    uint8_t state[AWS_HASH_STATE_MAX_SIZE] = {0};
+    struct aws_byte_buf state_buf = aws_byte_buf_from_empty_array(state, sizeof(state));
+    if (aws_hash_export_state(hash, &state_buf)) {
+        /* not every provider exposes its state, and some only on a block boundary */
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+        aws_hash_destroy(hash);
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_byte_cursor state_cur = aws_byte_cursor_from_buf(&state_buf);
+
+    /* resume in a fresh instance, and in the original one after it has been finalized */
+    struct aws_hash *resumed = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(resumed);
+    struct aws_hash *hashes[] = {resumed, hash};
+
+    uint8_t scratch[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf scratch_buf = aws_byte_buf_from_empty_array(scratch, sizeof(scratch));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &scratch_buf, 0));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(hashes); ++i) {
+        ASSERT_SUCCESS(aws_hash_import_state(hashes[i], state_cur));
+        ASSERT_SUCCESS(aws_hash_update(hashes[i], &message_cur));
+
+        uint8_t output[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+        ASSERT_SUCCESS(aws_hash_finalize(hashes[i], &output_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+    }
+
+    /* truncated, padded and other algorithms' states are rejected */
+    struct aws_byte_cursor truncated = aws_byte_cursor_from_array(state, state_buf.len - 1);
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_hash_import_state(resumed, truncated));
+    struct aws_byte_cursor padded = aws_byte_cursor_from_array(state, state_buf.len + 1);
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_hash_import_state(resumed, padded));
+
+    struct aws_hash *sha1 = aws_sha1_new(allocator);
+    ASSERT_NOT_NULL(sha1);
+    int sha1_result = aws_hash_import_state(sha1, state_cur);
+    ASSERT_INT_EQUALS(AWS_OP_ERR, sha1_result);
+    ASSERT_TRUE(
+        aws_last_error() == AWS_ERROR_INVALID_ARGUMENT || aws_last_error() == AWS_ERROR_UNSUPPORTED_OPERATION);
+
+    aws_hash_destroy(sha1);
+    aws_hash_destroy(resumed);
+    aws_hash_destroy(hash);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sha256_test_export_import_state_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    /* on a block boundary, and with part of a block buffered */
+    ASSERT_SUCCESS(s_check_export_import_state(allocator, 128));
+    ASSERT_SUCCESS(s_check_export_import_state(allocator, 100));
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_export_import_state, s_sha256_test_export_import_state_fn)
+
+static int s_sha256_test_duplicate_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_byte_cursor prefix = aws_byte_cursor_from_c_str("a");
+    struct aws_byte_cursor suffix = aws_byte_cursor_from_c_str("bc");
+    struct aws_byte_cursor other_suffix = aws_byte_cursor_from_c_str("nother message entirely");
+    struct aws_byte_cursor other_message = aws_byte_cursor_from_c_str("another message entirely");
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+
+    uint8_t other_expected[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf other_expected_buf = aws_byte_buf_from_empty_array(other_expected, sizeof(other_expected));
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &other_message, &other_expected_buf, 0));
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    ASSERT_SUCCESS(aws_hash_update(hash, &prefix));
+
+    struct aws_hash *same = aws_hash_duplicate(allocator, hash);
+    ASSERT_NOT_NULL(same);
+    struct aws_hash *other = aws_hash_duplicate(allocator, hash);
+    ASSERT_NOT_NULL(other);
+
+    /* the copies and the original must not share any state */
+    ASSERT_SUCCESS(aws_hash_update(same, &suffix));
+    ASSERT_SUCCESS(aws_hash_update(other, &other_suffix));
+    ASSERT_SUCCESS(aws_hash_update(hash, &suffix));
+
+    struct aws_hash *hashes[] = {hash, same, other};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(hashes); ++i) {
+        uint8_t output[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+        ASSERT_SUCCESS(aws_hash_finalize(hashes[i], &output_buf, 0));
+
+        if (hashes[i] == other) {
+            ASSERT_BIN_ARRAYS_EQUALS(other_expected, sizeof(other_expected), output_buf.buffer, output_buf.len);
+        } else {
+            ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+        }
+    }
+
+    /* a finalized hash has nothing left to copy */
+    ASSERT_NULL(aws_hash_duplicate(allocator, hash));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_STATE, aws_last_error());
+
+    aws_hash_destroy(other);
+    aws_hash_destroy(same);
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_duplicate, s_sha256_test_duplicate_fn)
+
+/* runs the tasks back to front on the calling thread, which is enough to show they don't depend on each other */
+static void s_sha256_run_tasks_in_reverse(
+    void (*task_fn)(void *),
+    void **task_args,
+    size_t task_count,
+    void *user_data) {
+    size_t *tasks_run = user_data;
+    *tasks_run += task_count;
+
+    for (size_t i = task_count; i > 0; --i) {
+        task_fn(task_args[i - 1]);
+    }
+}
+
+static int s_sha256_test_composite_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    uint8_t input[1000];
+    for (size_t i = 0; i < sizeof(input); ++i) {
+        input[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    size_t tasks_run = 0;
+    struct aws_sha256_composite_options options = {
+        .part_size = 64,
+        .run_tasks = s_sha256_run_tasks_in_reverse,
+        .user_data = &tasks_run,
+        .max_tasks = 3,
+    };
+
+    /* lengths around the part boundaries, the empty input is a single empty part */
+    const size_t lengths[] = {0, 1, 63, 64, 65, 128, 1000};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(lengths); ++i) {
+        struct aws_byte_cursor input_cur = aws_byte_cursor_from_array(input, lengths[i]);
+        size_t part_count = aws_sha256_composite_part_count(lengths[i], options.part_size);
+
+        struct aws_byte_buf expected_parts;
+        ASSERT_SUCCESS(aws_byte_buf_init(&expected_parts, allocator, part_count * AWS_SHA256_LEN));
+        struct aws_byte_cursor remaining = input_cur;
+        for (size_t part = 0; part < part_count; ++part) {
+            struct aws_byte_cursor part_cur =
+                aws_byte_cursor_advance(&remaining, aws_min_size(options.part_size, remaining.len));
+            ASSERT_SUCCESS(aws_sha256_compute(allocator, &part_cur, &expected_parts, 0));
+        }
+        ASSERT_UINT_EQUALS(0, remaining.len);
+
+        uint8_t expected[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+        struct aws_byte_cursor expected_parts_cur = aws_byte_cursor_from_buf(&expected_parts);
+        ASSERT_SUCCESS(aws_sha256_compute(allocator, &expected_parts_cur, &expected_buf, 0));
+
+        struct aws_byte_buf part_digests;
+        ASSERT_SUCCESS(aws_byte_buf_init(&part_digests, allocator, part_count * AWS_SHA256_LEN));
+        uint8_t output[AWS_SHA256_LEN] = {0};
+        struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+        ASSERT_SUCCESS(aws_sha256_composite_compute(allocator, input_cur, &options, &part_digests, &output_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+        ASSERT_BIN_ARRAYS_EQUALS(expected_parts.buffer, expected_parts.len, part_digests.buffer, part_digests.len);
+
+        /* without run_tasks or part digests the combined digest comes out the same */
+        struct aws_sha256_composite_options inline_options = {.part_size = options.part_size};
+        output_buf.len = 0;
+        ASSERT_SUCCESS(aws_sha256_composite_compute(allocator, input_cur, &inline_options, NULL, &output_buf));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+        /* a part digest buffer one digest short is rejected before anything is written */
+        part_digests.len = AWS_SHA256_LEN;
+        output_buf.len = 0;
+        ASSERT_ERROR(
+            AWS_ERROR_SHORT_BUFFER,
+            aws_sha256_composite_compute(allocator, input_cur, &options, &part_digests, &output_buf));
+        ASSERT_UINT_EQUALS(AWS_SHA256_LEN, part_digests.len);
+        ASSERT_UINT_EQUALS(0, output_buf.len);
+
+        aws_byte_buf_clean_up(&part_digests);
+        aws_byte_buf_clean_up(&expected_parts);
+    }
+
+    /* a single part is hashed inline, 65 and 128 bytes are one task per part, and 1000 bytes is 16 parts, which go
+     * out as 3 runs of at most 6 */
+    ASSERT_UINT_EQUALS(2 + 2 + 3, tasks_run);
+
+    options.part_size = 0;
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_sha256_composite_compute(
+            allocator, aws_byte_cursor_from_array(input, sizeof(input)), &options, NULL, &output_buf));
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_composite, s_sha256_test_composite_fn)
+
+static int s_sha256_test_compute_file_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    const char *path = "sha256_test_compute_file.tmp";
+    struct aws_byte_buf contents;
+    ASSERT_SUCCESS(aws_byte_buf_init(&contents, allocator, 100000));
+    for (size_t i = 0; i < contents.capacity; ++i) {
+        contents.buffer[i] = (uint8_t)(i * 31 + 7);
+    }
+    contents.len = contents.capacity;
+
+    FILE *file = aws_fopen(path, "wb");
+    ASSERT_NOT_NULL(file);
+    ASSERT_UINT_EQUALS(contents.len, fwrite(contents.buffer, 1, contents.len, file));
+    fclose(file);
+
+    uint8_t expected[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+    struct aws_byte_cursor contents_cur = aws_byte_cursor_from_buf(&contents);
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &contents_cur, &expected_buf, 0));
+
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_sha256_compute_file(allocator, path, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    /* the file is just more input to a running hash */
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    struct aws_byte_cursor prefix = aws_byte_cursor_advance(&contents_cur, 1000);
+    ASSERT_SUCCESS(aws_hash_update(hash, &prefix));
+    ASSERT_SUCCESS(aws_hash_update_file(hash, path));
+    expected_buf.len = 0;
+    output_buf.len = 0;
+    struct aws_byte_cursor prefix_and_file[] = {prefix, aws_byte_cursor_from_buf(&contents)};
+    struct aws_hash *reference = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(reference);
+    ASSERT_SUCCESS(aws_hash_update_vectored(reference, prefix_and_file, AWS_ARRAY_SIZE(prefix_and_file)));
+    ASSERT_SUCCESS(aws_hash_finalize(reference, &expected_buf, 0));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+    aws_hash_destroy(reference);
+    aws_hash_destroy(hash);
+
+    /* an empty file hashes like empty input */
+    file = aws_fopen(path, "wb");
+    ASSERT_NOT_NULL(file);
+    fclose(file);
+    struct aws_byte_cursor empty = {0};
+    expected_buf.len = 0;
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &empty, &expected_buf, 0));
+    ASSERT_SUCCESS(aws_sha256_compute_file(allocator, path, &output_buf, 0));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    ASSERT_SUCCESS(remove(path));
+    output_buf.len = 0;
+    ASSERT_FAILS(aws_sha256_compute_file(allocator, path, &output_buf, 0));
+    ASSERT_UINT_EQUALS(0, output_buf.len);
+
+    aws_byte_buf_clean_up(&contents);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_compute_file, s_sha256_test_compute_file_fn)
+
+struct sha256_stats_tally {
+    size_t events;
+    size_t failures;
+    uint64_t bytes;
+};
+
+static void s_on_stats_event(const struct aws_cal_stats_event *event, void *user_data) {
+    struct sha256_stats_tally *tally = user_data;
+    tally->events++;
+    tally->failures += event->error_code != 0;
+    tally->bytes += event->bytes;
+}
+
+static const struct aws_cal_stats_entry *s_find_stats_entry(
+    const struct aws_cal_stats_entry *entries,
+    size_t entry_count,
+    const struct aws_hash *hash) {
+
+    for (size_t i = 0; i < entry_count; ++i) {
+        if (strcmp(entries[i].alg_name, hash->vtable->alg_name) == 0 &&
+            strcmp(entries[i].provider, hash->vtable->provider) == 0) {
+            return &entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+static int s_sha256_test_stats_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct sha256_stats_tally tally = {0};
+    struct aws_cal_stats_options options = {.on_event = s_on_stats_event, .user_data = &tally};
+    if (aws_cal_stats_enable(&options)) {
+        /* counting isn't compiled in */
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+        struct aws_cal_stats_entry entry;
+        ASSERT_UINT_EQUALS(0, aws_cal_stats_snapshot(&entry, 1));
+        aws_cal_library_clean_up();
+        return AWS_OP_SUCCESS;
+    }
+    aws_cal_stats_reset();
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    ASSERT_SUCCESS(aws_hash_update(hash, &input));
+    ASSERT_SUCCESS(aws_hash_update(hash, &input));
+
+    /* a vectored update is one operation over all of its segments */
+    struct aws_byte_cursor segments[] = {input, input};
+    ASSERT_SUCCESS(aws_hash_update_vectored(hash, segments, AWS_ARRAY_SIZE(segments)));
+
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+
+    /* the one-shot goes through an instance while counting, so it's attributed the same way */
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &output_buf, 0));
+
+    /* a failure is still counted, and its error survives the callback */
+    output_buf.len = 0;
+    ASSERT_FAILS(aws_hash_finalize(hash, &output_buf, 0));
+    int finalize_error = aws_last_error();
+
+    struct aws_cal_stats_entry entries[AWS_CAL_STATS_MAX_ENTRIES];
+    size_t entry_count = aws_cal_stats_snapshot(entries, AWS_ARRAY_SIZE(entries));
+    const struct aws_cal_stats_entry *entry = s_find_stats_entry(entries, entry_count, hash);
+    ASSERT_NOT_NULL(entry);
+    ASSERT_UINT_EQUALS(7, entry->operations);
+    ASSERT_UINT_EQUALS(5 * input.len, entry->bytes);
+    ASSERT_TRUE(entry->allocations >= 1);
+
+    ASSERT_UINT_EQUALS(7 + entry->allocations, tally.events);
+    ASSERT_UINT_EQUALS(1, tally.failures);
+    ASSERT_UINT_EQUALS(5 * input.len, tally.bytes);
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_STATE, finalize_error);
+
+    /* totals are kept once disabled, but nothing more is counted */
+    aws_cal_stats_disable();
+    output_buf.len = 0;
+    ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &output_buf, 0));
+    size_t events = tally.events;
+    entry_count = aws_cal_stats_snapshot(entries, AWS_ARRAY_SIZE(entries));
+    entry = s_find_stats_entry(entries, entry_count, hash);
+    ASSERT_NOT_NULL(entry);
+    ASSERT_UINT_EQUALS(7, entry->operations);
+    ASSERT_UINT_EQUALS(events, tally.events);
+
+    aws_cal_stats_reset();
+    entry_count = aws_cal_stats_snapshot(entries, AWS_ARRAY_SIZE(entries));
+    entry = s_find_stats_entry(entries, entry_count, hash);
+    ASSERT_NOT_NULL(entry);
+    ASSERT_UINT_EQUALS(0, entry->operations);
+    ASSERT_UINT_EQUALS(0, entry->bytes);
+
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_stats, s_sha256_test_stats_fn)
+
+static size_t s_routed_acquire_count = 0;
+
+static void *s_routed_acquire(struct aws_allocator *allocator, size_t size) {
+    (void)allocator;
+    ++s_routed_acquire_count;
+    return aws_mem_acquire(aws_default_allocator(), size);
+}
+
+static void s_routed_release(struct aws_allocator *allocator, void *ptr) {
+    (void)allocator;
+    aws_mem_release(aws_default_allocator(), ptr);
+}
+
+static void *s_routed_realloc(struct aws_allocator *allocator, void *ptr, size_t old_size, size_t new_size) {
+    (void)allocator;
+    ++s_routed_acquire_count;
+    if (aws_mem_realloc(aws_default_allocator(), &ptr, old_size, new_size)) {
+        return NULL;
+    }
+    return ptr;
+}
+
+static void *s_routed_calloc(struct aws_allocator *allocator, size_t num, size_t size) {
+    (void)allocator;
+    ++s_routed_acquire_count;
+    return aws_mem_calloc(aws_default_allocator(), num, size);
+}
+
+/* libcrypto keeps using it after the test, so it can't be the test's tracing allocator */
+static struct aws_allocator s_routed_allocator = {
+    .mem_acquire = s_routed_acquire,
+    .mem_release = s_routed_release,
+    .mem_realloc = s_routed_realloc,
+    .mem_calloc = s_routed_calloc,
+};
+
+static int s_sha256_test_route_libcrypto_allocations_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_cal_library_options options = {.libcrypto_allocator = &s_routed_allocator};
+    aws_cal_library_init_ex(allocator, &options);
+
+    if (!aws_cal_libcrypto_allocations_routed()) {
+        /* no libcrypto, one that can't route, or one that was used before the library was initialized */
+        aws_cal_library_clean_up();
+        return AWS_OP_SUCCESS;
+    }
+
+    size_t acquire_count = s_routed_acquire_count;
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    ASSERT_TRUE(s_routed_acquire_count > acquire_count);
+
+    struct aws_byte_cursor input = aws_byte_cursor_from_c_str("abc");
+    uint8_t output[AWS_SHA256_LEN] = {0};
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+    ASSERT_SUCCESS(aws_hash_update(hash, &input));
+    ASSERT_SUCCESS(aws_hash_finalize(hash, &output_buf, 0));
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    /* still routed, libcrypto holds on to the memory functions */
+    ASSERT_TRUE(aws_cal_libcrypto_allocations_routed());
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_route_libcrypto_allocations, s_sha256_test_route_libcrypto_allocations_fn)
+
+#define ASYNC_HASH_COUNT 4
+#define ASYNC_UPDATE_COUNT 200
+
+struct async_hash_test {
+    struct aws_atomic_var completed;
+    struct aws_atomic_var failed;
+};
+
+static void s_on_async_complete(int error_code, void *user_data) {
+    struct async_hash_test *test = user_data;
+    if (error_code) {
+        aws_atomic_fetch_add(&test->failed, 1);
+    }
+    aws_atomic_fetch_add(&test->completed, 1);
+}
+
+static int s_sha256_test_async_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct aws_cal_worker_pool_options options = {.thread_count = 3};
+    struct aws_cal_worker_pool *pool = aws_cal_worker_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    uint8_t data[ASYNC_UPDATE_COUNT * 4];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 31);
+    }
+
+    struct async_hash_test test;
+    aws_atomic_init_int(&test.completed, 0);
+    aws_atomic_init_int(&test.failed, 0);
+
+    struct aws_hash *hashes[ASYNC_HASH_COUNT];
+    uint8_t outputs[ASYNC_HASH_COUNT][AWS_SHA256_LEN];
+    struct aws_byte_buf output_bufs[ASYNC_HASH_COUNT];
+    for (size_t i = 0; i < ASYNC_HASH_COUNT; ++i) {
+        hashes[i] = aws_sha256_new(allocator);
+        ASSERT_NOT_NULL(hashes[i]);
+        output_bufs[i] = aws_byte_buf_from_empty_array(outputs[i], sizeof(outputs[i]));
+    }
+
+    /* interleaved, so every hash has updates queued while others are running. Hash i is fed i + 1 bytes at a time. */
+    for (size_t update = 0; update < ASYNC_UPDATE_COUNT; ++update) {
+        for (size_t i = 0; i < ASYNC_HASH_COUNT; ++i) {
+            struct aws_byte_cursor chunk = aws_byte_cursor_from_array(data + update * (i + 1), i + 1);
+            ASSERT_SUCCESS(aws_hash_update_async(pool, hashes[i], chunk, s_on_async_complete, &test));
+        }
+    }
+    for (size_t i = 0; i < ASYNC_HASH_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_hash_finalize_async(pool, hashes[i], &output_bufs[i], 0, s_on_async_complete, &test));
+    }
+
+    aws_cal_worker_pool_destroy(pool);
+
+    ASSERT_UINT_EQUALS(ASYNC_HASH_COUNT * (ASYNC_UPDATE_COUNT + 1), aws_atomic_load_int(&test.completed));
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&test.failed));
+
+    for (size_t i = 0; i < ASYNC_HASH_COUNT; ++i) {
+        uint8_t expected[AWS_SHA256_LEN];
+        struct aws_byte_buf expected_buf = aws_byte_buf_from_empty_array(expected, sizeof(expected));
+        struct aws_byte_cursor input = aws_byte_cursor_from_array(data, ASYNC_UPDATE_COUNT * (i + 1));
+        ASSERT_SUCCESS(aws_sha256_compute(allocator, &input, &expected_buf, 0));
+        ASSERT_BIN_ARRAYS_EQUALS(expected_buf.buffer, expected_buf.len, output_bufs[i].buffer, output_bufs[i].len);
+        aws_hash_destroy(hashes[i]);
+    }
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_async, s_sha256_test_async_fn)
+
+struct async_submitted_run {
+    aws_cal_async_run_fn *run;
+    void *arg;
+};
+
+struct async_submit_test {
+    struct async_submitted_run runs[8];
+    size_t run_count;
+    int order[8];
+    size_t completed;
+};
+
+static void s_submit_run(aws_cal_async_run_fn *run, void *arg, void *user_data) {
+    struct async_submit_test *test = user_data;
+    AWS_FATAL_ASSERT(test->run_count < AWS_ARRAY_SIZE(test->runs));
+    test->runs[test->run_count].run = run;
+    test->runs[test->run_count].arg = arg;
+    ++test->run_count;
+}
+
+struct async_submit_op {
+    struct async_submit_test *test;
+    int id;
+    int error_code;
+};
+
+static void s_on_submit_op_complete(int error_code, void *user_data) {
+    struct async_submit_op *op = user_data;
+    op->error_code = error_code;
+    op->test->order[op->test->completed++] = op->id;
+}
+
+static int s_sha256_test_async_submit_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_cal_library_init(allocator);
+
+    struct async_submit_test test;
+    AWS_ZERO_STRUCT(test);
+    struct aws_cal_worker_pool_options options = {.submit = s_submit_run, .user_data = &test};
+    struct aws_cal_worker_pool *pool = aws_cal_worker_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    struct aws_hash *hash = aws_sha256_new(allocator);
+    ASSERT_NOT_NULL(hash);
+    uint8_t output[AWS_SHA256_LEN];
+    struct aws_byte_buf output_buf = aws_byte_buf_from_empty_array(output, sizeof(output));
+
+    struct async_submit_op ops[4];
+    for (int i = 0; i < 4; ++i) {
+        ops[i].test = &test;
+        ops[i].id = i;
+        ops[i].error_code = -1;
+    }
+
+    /* the hash is handed to the submit function once, however much is queued on it before it runs */
+    ASSERT_SUCCESS(aws_hash_update_async(
+        pool, hash, aws_byte_cursor_from_c_str("a"), s_on_submit_op_complete, &ops[0]));
+    ASSERT_SUCCESS(aws_hash_update_async(
+        pool, hash, aws_byte_cursor_from_c_str("b"), s_on_submit_op_complete, &ops[1]));
+    ASSERT_SUCCESS(aws_hash_update_async(
+        pool, hash, aws_byte_cursor_from_c_str("c"), s_on_submit_op_complete, &ops[2]));
+    ASSERT_SUCCESS(aws_hash_finalize_async(pool, hash, &output_buf, 0, s_on_submit_op_complete, &ops[3]));
+    ASSERT_UINT_EQUALS(1, test.run_count);
+    ASSERT_UINT_EQUALS(0, test.completed);
+
+    test.runs[0].run(test.runs[0].arg);
+    ASSERT_UINT_EQUALS(4, test.completed);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_INT_EQUALS(i, test.order[i]);
+        ASSERT_INT_EQUALS(0, ops[i].error_code);
+    }
+
+    uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output_buf.buffer, output_buf.len);
+
+    /* a finalized hash fails the next update, through the completion rather than the submission */
+    ASSERT_SUCCESS(
+        aws_hash_update_async(pool, hash, aws_byte_cursor_from_c_str("d"), s_on_submit_op_complete, &ops[0]));
+    ASSERT_UINT_EQUALS(2, test.run_count);
+    test.runs[1].run(test.runs[1].arg);
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_STATE, ops[0].error_code);
+
+    aws_cal_worker_pool_destroy(pool);
+    aws_hash_destroy(hash);
+
+    aws_cal_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(sha256_test_async_submit, s_sha256_test_async_submit_fn)